@@ -1421,6 +1421,7 @@ class VIEW3D_PT_tools_imagepaint_options(View3DPaintPanel, Panel):
         col = layout.column()
         col.prop(ipaint, "use_occlude")
         col.prop(ipaint, "use_backface_culling", text="Backface Culling")
+        col.prop(ipaint, "use_coverage_cache")
 
 
 class VIEW3D_PT_tools_imagepaint_options_cavity(Panel):
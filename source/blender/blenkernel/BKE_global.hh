@@ -181,6 +181,12 @@ struct Global {
   char gpu_debug_scope_name[200];
 
   bool profile_gpu;
+
+  /**
+   * Record the execution of geometry nodes and write it to a trace file on exit.
+   * Set using `--profile-geometry-nodes`.
+   */
+  bool profile_geometry_nodes;
 };
 
 /* **************** GLOBAL ********************* */
@@ -105,6 +105,12 @@ void BKE_image_format_to_imbuf(ImBuf *ibuf, const ImageFormatData *imf);
 
 bool BKE_image_format_is_byte(const ImageFormatData *imf);
 
+/**
+ * Get the OpenEXR codec (an `R_IMF_EXR_CODEC_*` value) of passes that don't store colors, or -1 if
+ * they use the codec of the file like color passes, which is the default.
+ */
+int BKE_image_format_exr_data_codec(const ImageFormatData *imf);
+
 /* Color Management */
 
 void BKE_image_format_color_management_copy(ImageFormatData *imf, const ImageFormatData *imf_src);
@@ -76,6 +76,7 @@ class InverseEvalParams;
 namespace compositor {
 class Context;
 class NodeOperation;
+class RegionOfInterestParams;
 }  // namespace compositor
 }  // namespace blender
 
@@ -131,6 +132,8 @@ using NodeGatherAddOperationsFunction =
 using NodeGetCompositorOperationFunction =
     blender::compositor::NodeOperation *(*)(blender::compositor::Context &context,
                                             blender::nodes::DNode node);
+using NodeGetCompositorInputRegionOfInterestFunction =
+    void (*)(blender::compositor::RegionOfInterestParams &params);
 using NodeExtraInfoFunction = void (*)(blender::nodes::NodeExtraInfoParams &params);
 using NodeInverseElemEvalFunction =
     void (*)(blender::nodes::value_elem::InverseElemEvalParams &params);
@@ -329,6 +332,11 @@ struct bNodeType {
    * responsibility of the caller. */
   NodeGetCompositorOperationFunction get_compositor_operation = nullptr;
 
+  /* Compute the regions needed from the inputs of the node given the region needed from its
+   * outputs, see COM_region_of_interest.hh. If not set, pixel nodes need the same region from
+   * their inputs and other nodes need their inputs in full. */
+  NodeGetCompositorInputRegionOfInterestFunction get_compositor_input_region_of_interest = nullptr;
+
   /* A message to display in the node header for unsupported compositor nodes. The message
    * is assumed to be static and thus require no memory handling. This field is to be removed when
    * all nodes are supported. */
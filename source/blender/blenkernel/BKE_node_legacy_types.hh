@@ -513,6 +513,7 @@
 #define GEO_NODE_MERGE_LAYERS 2150
 #define GEO_NODE_INPUT_COLLECTION 2151
 #define GEO_NODE_INPUT_OBJECT 2152
+#define GEO_NODE_DECIMATE_MESH 2153
 
 /** \} */
 
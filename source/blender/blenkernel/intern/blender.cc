@@ -209,6 +209,7 @@ void BKE_blender_globals_init()
   G.log.level = 1;
 
   G.profile_gpu = false;
+  G.profile_geometry_nodes = false;
 }
 
 void BKE_blender_globals_clear()
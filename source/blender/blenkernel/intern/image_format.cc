@@ -951,6 +951,38 @@ bool BKE_image_format_is_byte(const ImageFormatData *imf)
   return (imf->depth == R_IMF_CHAN_DEPTH_8) && (BKE_imtype_valid_depths(imf->imtype) & imf->depth);
 }
 
+int BKE_image_format_exr_data_codec(const ImageFormatData *imf)
+{
+  switch (imf->exr_data_codec) {
+    case R_IMF_EXR_DATA_CODEC_SAME:
+      return -1;
+    case R_IMF_EXR_DATA_CODEC_NONE:
+      return R_IMF_EXR_CODEC_NONE;
+    case R_IMF_EXR_DATA_CODEC_ZIP:
+      return R_IMF_EXR_CODEC_ZIP;
+    case R_IMF_EXR_DATA_CODEC_PIZ:
+      return R_IMF_EXR_CODEC_PIZ;
+    case R_IMF_EXR_DATA_CODEC_RLE:
+      return R_IMF_EXR_CODEC_RLE;
+    case R_IMF_EXR_DATA_CODEC_ZIPS:
+      return R_IMF_EXR_CODEC_ZIPS;
+  }
+
+  /* Lossy codecs are only meant for colors, they would corrupt data like depth, normals or
+   * Cryptomatte IDs. */
+  const int codec = imf->exr_codec & OPENEXR_CODEC_MASK;
+  if (ELEM(codec,
+           R_IMF_EXR_CODEC_NONE,
+           R_IMF_EXR_CODEC_ZIP,
+           R_IMF_EXR_CODEC_PIZ,
+           R_IMF_EXR_CODEC_RLE,
+           R_IMF_EXR_CODEC_ZIPS))
+  {
+    return codec;
+  }
+  return R_IMF_EXR_CODEC_ZIP;
+}
+
 /* Color Management */
 
 void BKE_image_format_color_management_copy(ImageFormatData *imf, const ImageFormatData *imf_src)
@@ -874,6 +874,10 @@ bool BKE_image_render_write_exr(ReportList *reports,
   Vector<float *> tmp_output_rects;
   add_exr_compositing_result(exrhandle, rr, imf, save_as_render, view, layer, tmp_output_rects);
 
+  /* Passes that don't store colors can use a lossless codec, which might be different from the
+   * codec of the file, in which case each pass is written to its own part. */
+  const int data_compress = (imf ? BKE_image_format_exr_data_codec(imf) : -1);
+
   /* Other render layers. */
   int nr = (rr->have_combined) ? 1 : 0;
   const bool has_multiple_layers = BLI_listbase_count_at_most(&rr->layers, 2) > 1;
@@ -944,7 +948,8 @@ bool BKE_image_render_write_exr(ReportList *reports,
                               render_pass->channels,
                               render_pass->channels * rr->rectx,
                               output_rect + i,
-                              pass_half_float);
+                              pass_half_float,
+                              pass_RGBA ? -1 : data_compress);
         }
         continue;
       }
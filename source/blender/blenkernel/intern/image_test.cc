@@ -11,6 +11,7 @@
 #include "BKE_global.hh"
 #include "BKE_idtype.hh"
 #include "BKE_image.hh"
+#include "BKE_image_format.hh"
 #include "BKE_main.hh"
 
 #include "MEM_guardedalloc.h"
@@ -21,6 +22,7 @@
 #include "IMB_moviecache.hh"
 
 #include "DNA_image_types.h"
+#include "DNA_scene_types.h"
 
 #include "RE_pipeline.h"
 
@@ -31,6 +33,24 @@ namespace blender::bke::tests {
 using testing::Eq;
 using testing::Pointwise;
 
+TEST(image_format, exr_data_codec)
+{
+  ImageFormatData imf = {};
+  imf.exr_codec = R_IMF_EXR_CODEC_DWAA;
+
+  /* Data passes use the codec of the file by default, even if it is lossy. */
+  EXPECT_EQ(BKE_image_format_exr_data_codec(&imf), -1);
+
+  /* The lossless option falls back to ZIP for lossy codecs. */
+  imf.exr_data_codec = R_IMF_EXR_DATA_CODEC_AUTO;
+  EXPECT_EQ(BKE_image_format_exr_data_codec(&imf), R_IMF_EXR_CODEC_ZIP);
+  imf.exr_codec = R_IMF_EXR_CODEC_PIZ;
+  EXPECT_EQ(BKE_image_format_exr_data_codec(&imf), R_IMF_EXR_CODEC_PIZ);
+
+  imf.exr_data_codec = R_IMF_EXR_DATA_CODEC_RLE;
+  EXPECT_EQ(BKE_image_format_exr_data_codec(&imf), R_IMF_EXR_CODEC_RLE);
+}
+
 TEST(udim, image_ensure_tile_token)
 {
   auto verify = [](const char *original, const char *expected) {
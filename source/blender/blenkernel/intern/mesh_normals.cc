@@ -10,6 +10,7 @@
  * \see `bmesh_mesh_normals.cc` for the equivalent #BMesh functionality.
  */
 
+#include <atomic>
 #include <climits>
 
 #include "MEM_guardedalloc.h"
@@ -19,10 +20,12 @@
 
 #include "BLI_array_utils.hh"
 #include "BLI_bit_vector.hh"
+#include "BLI_index_mask.hh"
 #include "BLI_linklist.h"
 #include "BLI_math_base.hh"
 #include "BLI_math_vector.hh"
 #include "BLI_memarena.h"
+#include "BLI_simd.hh"
 #include "BLI_span.hh"
 #include "BLI_task.hh"
 #include "BLI_utildefines.h"
@@ -141,15 +144,177 @@ float3 face_normal_calc(const Span<float3> vert_positions, const Span<int> face_
  * meshes can slow down high-poly meshes. For details on performance, see D11993.
  * \{ */
 
+/**
+ * The number of corners of every face if it is the same for all faces, which is common for
+ * triangulated meshes and subdivided quad meshes.
+ */
+static std::optional<int> uniform_face_size(const OffsetIndices<int> faces)
+{
+  if (faces.is_empty()) {
+    return std::nullopt;
+  }
+  const int size = faces.total_size() / faces.size();
+  if (int64_t(size) * faces.size() != faces.total_size()) {
+    return std::nullopt;
+  }
+  if (size == 3) {
+    /* Faces have at least three corners, so all faces must be triangles. */
+    return size;
+  }
+  const Span<int> offsets = faces.data();
+  const bool uniform = threading::parallel_reduce(
+      faces.index_range(),
+      4096,
+      true,
+      [&](const IndexRange range, const bool uniform) {
+        return uniform && std::all_of(range.begin(), range.end(), [&](const int face) {
+                 return offsets[face + 1] - offsets[face] == size;
+               });
+      },
+      std::logical_and<bool>());
+  return uniform ? std::optional<int>(size) : std::nullopt;
+}
+
+/** Same result as #normal_calc_ngon, with the cross product of the triangle's edges. */
+static float3 normal_calc_tri(const Span<float3> positions, const int *face_verts)
+{
+  const float3 &v0 = positions[face_verts[0]];
+  const float3 n = math::cross(positions[face_verts[1]] - v0, positions[face_verts[2]] - v0);
+  float3 normal;
+  if (UNLIKELY(normalize_v3_v3(normal, n) == 0.0f)) {
+    normal.z = 1.0f;
+  }
+  return normal;
+}
+
+/** Same result as #normal_calc_ngon, with the cross product of the quad's diagonals. */
+static float3 normal_calc_quad(const Span<float3> positions, const int *face_verts)
+{
+  const float3 n = math::cross(positions[face_verts[0]] - positions[face_verts[2]],
+                               positions[face_verts[1]] - positions[face_verts[3]]);
+  float3 normal;
+  if (UNLIKELY(normalize_v3_v3(normal, n) == 0.0f)) {
+    normal.z = 1.0f;
+  }
+  return normal;
+}
+
+#if BLI_HAVE_SSE2
+
+/** Coordinates of the same face vertex of four faces, one register per axis. */
+struct float3x4 {
+  __m128 x, y, z;
+};
+
+static float3x4 load_face_verts(const Span<float3> positions,
+                                const int *face_verts,
+                                const int face_size,
+                                const int vert)
+{
+  const float3 &a = positions[face_verts[vert]];
+  const float3 &b = positions[face_verts[face_size + vert]];
+  const float3 &c = positions[face_verts[face_size * 2 + vert]];
+  const float3 &d = positions[face_verts[face_size * 3 + vert]];
+  return {_mm_setr_ps(a.x, b.x, c.x, d.x),
+          _mm_setr_ps(a.y, b.y, c.y, d.y),
+          _mm_setr_ps(a.z, b.z, c.z, d.z)};
+}
+
+static float3x4 sub(const float3x4 &a, const float3x4 &b)
+{
+  return {_mm_sub_ps(a.x, b.x), _mm_sub_ps(a.y, b.y), _mm_sub_ps(a.z, b.z)};
+}
+
+static float3x4 cross(const float3x4 &a, const float3x4 &b)
+{
+  return {_mm_sub_ps(_mm_mul_ps(a.y, b.z), _mm_mul_ps(a.z, b.y)),
+          _mm_sub_ps(_mm_mul_ps(a.z, b.x), _mm_mul_ps(a.x, b.z)),
+          _mm_sub_ps(_mm_mul_ps(a.x, b.y), _mm_mul_ps(a.y, b.x))};
+}
+
+/** Normalize the vectors and write them, using the Z axis for degenerate faces. */
+static void store_face_normals(const float3x4 &n, float3 *r_normals)
+{
+  const __m128 length_squared = _mm_add_ps(
+      _mm_add_ps(_mm_mul_ps(n.x, n.x), _mm_mul_ps(n.y, n.y)), _mm_mul_ps(n.z, n.z));
+  /* Same threshold as #normalize_v3, NaN values fail the comparison as well. */
+  const __m128 valid = _mm_cmpgt_ps(length_squared, _mm_set1_ps(1.0e-35f));
+  const __m128 factor = _mm_and_ps(valid,
+                                   _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(length_squared)));
+  alignas(16) float x[4];
+  alignas(16) float y[4];
+  alignas(16) float z[4];
+  _mm_store_ps(x, _mm_mul_ps(n.x, factor));
+  _mm_store_ps(y, _mm_mul_ps(n.y, factor));
+  _mm_store_ps(z,
+               _mm_or_ps(_mm_and_ps(valid, _mm_mul_ps(n.z, factor)),
+                         _mm_andnot_ps(valid, _mm_set1_ps(1.0f))));
+  for (const int i : IndexRange(4)) {
+    r_normals[i] = float3(x[i], y[i], z[i]);
+  }
+}
+
+#endif
+
+/**
+ * Calculate the normals of faces that all have \a face_size corners, four faces at a time when
+ * SIMD instructions are available.
+ */
+template<int face_size>
+static void normals_calc_uniform_faces(const Span<float3> positions,
+                                       const Span<int> corner_verts,
+                                       MutableSpan<float3> face_normals)
+{
+  static_assert(ELEM(face_size, 3, 4));
+  BLI_assert(corner_verts.size() == face_normals.size() * face_size);
+  const IndexRange range = face_normals.index_range();
+  const int *face_verts = corner_verts.data();
+  float3 *normals = face_normals.data();
+  int64_t i = 0;
+#if BLI_HAVE_SSE2
+  for (; i + 4 <= range.size(); i += 4, face_verts += face_size * 4, normals += 4) {
+    const float3x4 v0 = load_face_verts(positions, face_verts, face_size, 0);
+    const float3x4 v1 = load_face_verts(positions, face_verts, face_size, 1);
+    const float3x4 v2 = load_face_verts(positions, face_verts, face_size, 2);
+    if constexpr (face_size == 3) {
+      store_face_normals(cross(sub(v1, v0), sub(v2, v0)), normals);
+    }
+    else {
+      const float3x4 v3 = load_face_verts(positions, face_verts, face_size, 3);
+      store_face_normals(cross(sub(v0, v2), sub(v1, v3)), normals);
+    }
+  }
+#endif
+  for (; i < range.size(); i++, face_verts += face_size, normals++) {
+    if constexpr (face_size == 3) {
+      *normals = normal_calc_tri(positions, face_verts);
+    }
+    else {
+      *normals = normal_calc_quad(positions, face_verts);
+    }
+  }
+}
+
 void normals_calc_faces(const Span<float3> positions,
                         const OffsetIndices<int> faces,
                         const Span<int> corner_verts,
                         MutableSpan<float3> face_normals)
 {
   BLI_assert(faces.size() == face_normals.size());
+  const std::optional<int> face_size = uniform_face_size(faces);
   threading::parallel_for(faces.index_range(), 1024, [&](const IndexRange range) {
-    for (const int i : range) {
-      face_normals[i] = normal_calc_ngon(positions, corner_verts.slice(faces[i]));
+    if (face_size == 3) {
+      normals_calc_uniform_faces<3>(
+          positions, corner_verts.slice(faces[range]), face_normals.slice(range));
+    }
+    else if (face_size == 4) {
+      normals_calc_uniform_faces<4>(
+          positions, corner_verts.slice(faces[range]), face_normals.slice(range));
+    }
+    else {
+      for (const int i : range) {
+        face_normals[i] = normal_calc_ngon(positions, corner_verts.slice(faces[i]));
+      }
     }
   });
 }
@@ -656,8 +821,65 @@ struct CornerSplitTaskDataCommon {
 /* See comment about edge_to_corners below. */
 #define IS_EDGE_SHARP(_e2l) ELEM((_e2l)[1], INDEX_UNSET, INDEX_INVALID)
 
-static void mesh_edges_sharp_tag(const OffsetIndices<int> faces,
-                                 const Span<int> corner_verts,
+/** The corners using an edge, gathered in parallel. */
+struct EdgeCorners {
+  /** The lowest corner index using the edge, or `INT_MAX` for loose edges. */
+  std::atomic<int> first;
+  /** The second lowest corner index using the edge, or `INT_MAX` for boundary edges. */
+  std::atomic<int> second;
+  /** True when more than two corners use the edge. */
+  std::atomic<bool> non_manifold;
+};
+
+/**
+ * Set the value to the minimum of the current and the new value.
+ * \return The previous value.
+ */
+static int atomic_min(std::atomic<int> &value, const int new_value)
+{
+  int old_value = value.load(std::memory_order_relaxed);
+  while (new_value < old_value &&
+         !value.compare_exchange_weak(old_value, new_value, std::memory_order_relaxed))
+  {
+  }
+  return old_value;
+}
+
+/**
+ * Find the two lowest corner indices using every edge. These are the first two corners found when
+ * iterating over faces in order, so the result is the same as the previous single threaded loop
+ * over all corners.
+ */
+static void gather_edge_corners(const Span<int> corner_edges,
+                                MutableSpan<EdgeCorners> edge_corners)
+{
+  threading::parallel_for(edge_corners.index_range(), 4096, [&](const IndexRange range) {
+    for (EdgeCorners &corners : edge_corners.slice(range)) {
+      corners.first.store(INT_MAX, std::memory_order_relaxed);
+      corners.second.store(INT_MAX, std::memory_order_relaxed);
+      corners.non_manifold.store(false, std::memory_order_relaxed);
+    }
+  });
+  threading::parallel_for(corner_edges.index_range(), 4096, [&](const IndexRange range) {
+    for (const int corner : range) {
+      atomic_min(edge_corners[corner_edges[corner]].first, corner);
+    }
+  });
+  threading::parallel_for(corner_edges.index_range(), 4096, [&](const IndexRange range) {
+    for (const int corner : range) {
+      EdgeCorners &corners = edge_corners[corner_edges[corner]];
+      if (corners.first.load(std::memory_order_relaxed) == corner) {
+        continue;
+      }
+      /* Whichever of two corners comes second finds the other one, so a third corner exists. */
+      if (atomic_min(corners.second, corner) != INT_MAX) {
+        corners.non_manifold.store(true, std::memory_order_relaxed);
+      }
+    }
+  });
+}
+
+static void mesh_edges_sharp_tag(const Span<int> corner_verts,
                                  const Span<int> corner_edges,
                                  const Span<int> corner_to_face_map,
                                  const Span<float3> face_normals,
@@ -672,64 +894,71 @@ static void mesh_edges_sharp_tag(const OffsetIndices<int> faces,
     return sharp_faces.is_empty() || !sharp_faces[face_i];
   };
 
-  for (const int face_i : faces.index_range()) {
-    for (const int corner : faces[face_i]) {
-      const int vert = corner_verts[corner];
-      const int edge = corner_edges[corner];
-
+  Array<EdgeCorners> edge_corners(edge_to_corners.size(), NoInitialization());
+  gather_edge_corners(corner_edges, edge_corners);
+  threading::parallel_for(edge_to_corners.index_range(), 4096, [&](const IndexRange range) {
+    for (const int edge : range) {
+      const int corner_1 = edge_corners[edge].first.load(std::memory_order_relaxed);
+      const int corner_2 = edge_corners[edge].second.load(std::memory_order_relaxed);
+      const bool non_manifold = edge_corners[edge].non_manifold.load(std::memory_order_relaxed);
       int2 &e2l = edge_to_corners[edge];
 
-      /* Check whether current edge might be smooth or sharp */
-      if ((e2l[0] | e2l[1]) == 0) {
-        /* 'Empty' edge until now, set e2l[0] (and e2l[1] to INDEX_UNSET to tag it as unset). */
-        e2l[0] = corner;
+      if (corner_1 == INT_MAX) {
+        /* Loose edge. */
+        e2l = int2(0);
+        continue;
+      }
+      if (!face_is_smooth(corner_to_face_map[corner_1])) {
         /* We have to check this here too, else we might miss some flat faces!!! */
-        e2l[1] = face_is_smooth(face_i) ? INDEX_UNSET : INDEX_INVALID;
+        e2l = int2(corner_1, INDEX_INVALID);
+        continue;
+      }
+      if (corner_2 == INT_MAX) {
+        e2l = int2(corner_1, INDEX_UNSET);
+        continue;
       }
-      else if (e2l[1] == INDEX_UNSET) {
-        const bool is_angle_sharp = math::dot(face_normals[corner_to_face_map[e2l[0]]],
-                                              face_normals[face_i]) < split_angle_cos;
-
-        /* Second corner using this edge, time to test its sharpness.
-         * An edge is sharp if it is tagged as such, or its face is not smooth,
-         * or both faces have opposed (flipped) normals, i.e. both corners on the same edge share
-         * the same vertex, or angle between both its faces' normals is above split_angle value. */
-        if (!face_is_smooth(face_i) || (!sharp_edges.is_empty() && sharp_edges[edge]) ||
-            vert == corner_verts[e2l[0]] || is_angle_sharp)
-        {
-          /* NOTE: we are sure that corner != 0 here ;). */
-          e2l[1] = INDEX_INVALID;
 
-          /* We want to avoid tagging edges as sharp when it is already defined as such by
-           * other causes than angle threshold. */
-          if (is_angle_sharp) {
-            r_sharp_edges[edge] = true;
-          }
-        }
-        else {
-          e2l[1] = corner;
+      const bool is_angle_sharp = math::dot(face_normals[corner_to_face_map[corner_1]],
+                                            face_normals[corner_to_face_map[corner_2]]) <
+                                  split_angle_cos;
+
+      /* An edge is sharp if it is tagged as such, or its face is not smooth,
+       * or both faces have opposed (flipped) normals, i.e. both corners on the same edge share
+       * the same vertex, or angle between both its faces' normals is above split_angle value. */
+      if (!face_is_smooth(corner_to_face_map[corner_2]) ||
+          (!sharp_edges.is_empty() && sharp_edges[edge]) ||
+          corner_verts[corner_1] == corner_verts[corner_2] || is_angle_sharp)
+      {
+        e2l = int2(corner_1, INDEX_INVALID);
+
+        /* We want to avoid tagging edges as sharp when it is already defined as such by
+         * other causes than angle threshold. */
+        if (is_angle_sharp) {
+          r_sharp_edges[edge] = true;
         }
       }
-      else if (!IS_EDGE_SHARP(e2l)) {
-        /* More than two corners using this edge, tag as sharp if not yet done. */
-        e2l[1] = INDEX_INVALID;
+      else if (non_manifold) {
+        /* More than two corners using this edge, tag as sharp. */
+        e2l = int2(corner_1, INDEX_INVALID);
 
         /* We want to avoid tagging edges as sharp when it is already defined as such by
          * other causes than angle threshold. */
         r_sharp_edges[edge] = false;
       }
-      /* Else, edge is already 'disqualified' (i.e. sharp)! */
+      else {
+        e2l = int2(corner_1, corner_2);
+      }
     }
-  }
+  });
 }
 
 /**
  * Builds a simplified map from edges to face corners, marking special values when
  * it encounters sharp edges or borders between faces with flipped winding orders.
  */
-static void build_edge_to_corner_map_with_flip_and_sharp(const OffsetIndices<int> faces,
-                                                         const Span<int> corner_verts,
+static void build_edge_to_corner_map_with_flip_and_sharp(const Span<int> corner_verts,
                                                          const Span<int> corner_edges,
+                                                         const Span<int> corner_to_face,
                                                          const Span<bool> sharp_faces,
                                                          const Span<bool> sharp_edges,
                                                          MutableSpan<int2> edge_to_corners)
@@ -738,45 +967,43 @@ static void build_edge_to_corner_map_with_flip_and_sharp(const OffsetIndices<int
     return sharp_faces.is_empty() || !sharp_faces[face_i];
   };
 
-  for (const int face_i : faces.index_range()) {
-    for (const int corner : faces[face_i]) {
-      const int vert = corner_verts[corner];
-      const int edge = corner_edges[corner];
-
+  Array<EdgeCorners> edge_corners(edge_to_corners.size(), NoInitialization());
+  gather_edge_corners(corner_edges, edge_corners);
+  threading::parallel_for(edge_to_corners.index_range(), 4096, [&](const IndexRange range) {
+    for (const int edge : range) {
+      const int corner_1 = edge_corners[edge].first.load(std::memory_order_relaxed);
+      const int corner_2 = edge_corners[edge].second.load(std::memory_order_relaxed);
+      const bool non_manifold = edge_corners[edge].non_manifold.load(std::memory_order_relaxed);
       int2 &e2l = edge_to_corners[edge];
 
-      /* Check whether current edge might be smooth or sharp */
-      if ((e2l[0] | e2l[1]) == 0) {
-        /* 'Empty' edge until now, set e2l[0] (and e2l[1] to INDEX_UNSET to tag it as unset). */
-        e2l[0] = corner;
+      if (corner_1 == INT_MAX) {
+        /* Loose edge. */
+        e2l = int2(0);
+      }
+      else if (!face_is_smooth(corner_to_face[corner_1])) {
         /* We have to check this here too, else we might miss some flat faces!!! */
-        e2l[1] = !face_is_smooth(face_i) ? INDEX_INVALID : INDEX_UNSET;
+        e2l = int2(corner_1, INDEX_INVALID);
       }
-      else if (e2l[1] == INDEX_UNSET) {
-        /* Second corner using this edge, time to test its sharpness.
-         * An edge is sharp if it is tagged as such, or its face is not smooth,
-         * or both face have opposed (flipped) normals, i.e. both corners on the same edge share
-         * the same vertex. */
-        if (!face_is_smooth(face_i) || (!sharp_edges.is_empty() && sharp_edges[edge]) ||
-            vert == corner_verts[e2l[0]])
-        {
-          /* NOTE: we are sure that corner != 0 here ;). */
-          e2l[1] = INDEX_INVALID;
-        }
-        else {
-          e2l[1] = corner;
-        }
+      else if (corner_2 == INT_MAX) {
+        e2l = int2(corner_1, INDEX_UNSET);
       }
-      else if (!IS_EDGE_SHARP(e2l)) {
-        /* More than two corners using this edge, tag as sharp if not yet done. */
-        e2l[1] = INDEX_INVALID;
+      else if (non_manifold || !face_is_smooth(corner_to_face[corner_2]) ||
+               (!sharp_edges.is_empty() && sharp_edges[edge]) ||
+               corner_verts[corner_1] == corner_verts[corner_2])
+      {
+        /* An edge is sharp if it is tagged as such, or its face is not smooth, or it is used by
+         * more than two corners, or both face have opposed (flipped) normals, i.e. both corners
+         * on the same edge share the same vertex. */
+        e2l = int2(corner_1, INDEX_INVALID);
+      }
+      else {
+        e2l = int2(corner_1, corner_2);
       }
-      /* Else, edge is already 'disqualified' (i.e. sharp)! */
     }
-  }
+  });
 }
 
-void edges_sharp_from_angle_set(const OffsetIndices<int> faces,
+void edges_sharp_from_angle_set(const OffsetIndices<int> /*faces*/,
                                 const Span<int> corner_verts,
                                 const Span<int> corner_edges,
                                 const Span<float3> face_normals,
@@ -791,10 +1018,9 @@ void edges_sharp_from_angle_set(const OffsetIndices<int> faces,
   }
 
   /* Mapping edge -> corners. See #bke::mesh::normals_calc_corners for details. */
-  Array<int2> edge_to_corners(sharp_edges.size(), int2(0));
+  Array<int2> edge_to_corners(sharp_edges.size(), NoInitialization());
 
-  mesh_edges_sharp_tag(faces,
-                       corner_verts,
+  mesh_edges_sharp_tag(corner_verts,
                        corner_edges,
                        corner_to_face,
                        face_normals,
@@ -1029,72 +1255,124 @@ static void split_corner_normal_fan_do(CornerSplitTaskDataCommon *common_data,
   }
 }
 
+/** Value of #corner_split_generator's fan first corners for corners that weren't walked yet. */
+#define FAN_UNKNOWN -1
+/** Value of #corner_split_generator's fan first corners for corners of non-cyclic smooth fans. */
+#define FAN_NOT_CYCLIC -2
+
 /**
- * Check whether given corner is part of an unknown-so-far cyclic smooth fan, or not.
+ * Check whether given corner is the entry point of a cyclic smooth fan, or not.
  * Needed because cyclic smooth fans have no obvious 'entry point',
- * and yet we need to walk them once, and only once.
+ * and yet we need to walk them once, and only once. The corner with the lowest index is used,
+ * which only depends on the fan itself, so all corners can be checked in parallel.
+ *
+ * The result is stored for every walked corner in \a fan_first_corners, and walks stop at corners
+ * with a known result, so every corner of a fan is walked over about once. That keeps the cost
+ * linear in the size of the fan, rather than quadratic, around vertices with many faces. Corners
+ * checked at the same time may walk over the same corners, which gives the same result.
  */
-static bool corner_split_generator_check_cyclic_smooth_fan(const Span<int> corner_verts,
-                                                           const Span<int> corner_edges,
-                                                           const OffsetIndices<int> faces,
-                                                           const Span<int2> edge_to_corners,
-                                                           const Span<int> corner_to_face,
-                                                           const int2 e2l_prev,
-                                                           MutableBitSpan skip_corners,
-                                                           const int corner,
-                                                           const int corner_prev)
+static bool corner_split_generator_check_cyclic_smooth_fan(
+    const Span<int> corner_verts,
+    const Span<int> corner_edges,
+    const OffsetIndices<int> faces,
+    const Span<int2> edge_to_corners,
+    const Span<int> corner_to_face,
+    const int2 e2l_prev,
+    const int corner,
+    const int corner_prev,
+    MutableSpan<std::atomic<int>> fan_first_corners)
 {
-  /* The vertex we are "fanning" around. */
-  const int vert_pivot = corner_verts[corner];
+  const int known_first_corner = fan_first_corners[corner].load(std::memory_order_relaxed);
+  if (known_first_corner != FAN_UNKNOWN) {
+    return known_first_corner == corner;
+  }
 
-  int2 e2lfan_curr = e2l_prev;
-  if (IS_EDGE_SHARP(e2lfan_curr)) {
+  if (IS_EDGE_SHARP(e2l_prev)) {
     /* Sharp corner, so not a cyclic smooth fan. */
     return false;
   }
 
+  /* The vertex we are "fanning" around. */
+  const int vert_pivot = corner_verts[corner];
+
   /* `vert_corner` the corner of our current edge might not be the corner of our current
    * vertex!
    */
+  int2 e2lfan_curr = e2l_prev;
   int fan_corner = corner_prev;
   int vert_corner = corner;
 
   BLI_assert(fan_corner >= 0);
   BLI_assert(vert_corner >= 0);
 
-  BLI_assert(!skip_corners[vert_corner]);
-  skip_corners[vert_corner].set();
-
-  while (true) {
+  int first_corner = corner;
+  bool fan_end_found = false;
+  bool is_cyclic = false;
+  int known_result = FAN_UNKNOWN;
+  int64_t steps_num = 0;
+  /* A fan can't have more corners than the mesh, this only protects against invalid topology. */
+  while (!fan_end_found && steps_num < corner_verts.size()) {
     /* Find next corner of the smooth fan. */
     corner_manifold_fan_around_vert_next(
         corner_verts, faces, corner_to_face, e2lfan_curr, vert_pivot, &fan_corner, &vert_corner);
+    steps_num++;
 
     e2lfan_curr = edge_to_corners[corner_edges[fan_corner]];
 
     if (IS_EDGE_SHARP(e2lfan_curr)) {
       /* Sharp corner/edge, so not a cyclic smooth fan. */
-      return false;
+      fan_end_found = true;
     }
-    /* Smooth corner/edge. */
-    if (skip_corners[vert_corner]) {
-      if (vert_corner == corner) {
-        /* We walked around a whole cyclic smooth fan without finding any already-processed corner,
-         * means we can use initial current / previous edge as start for this smooth fan. */
-        return true;
-      }
-      /* Already checked in some previous looping, we can abort. */
-      return false;
+    else if (vert_corner == corner) {
+      /* We walked around a whole cyclic smooth fan. */
+      fan_end_found = true;
+      is_cyclic = true;
+    }
+    else if ((known_result = fan_first_corners[vert_corner].load(std::memory_order_relaxed)) !=
+             FAN_UNKNOWN)
+    {
+      /* The rest of the fan was walked from another corner already. */
+      fan_end_found = true;
+      is_cyclic = known_result != FAN_NOT_CYCLIC;
+      first_corner = known_result;
+    }
+    else {
+      first_corner = std::min(first_corner, vert_corner);
     }
+  }
+  if (!fan_end_found) {
+    return false;
+  }
 
-    /* We can skip it in future, and keep checking the smooth fan. */
-    skip_corners[vert_corner].set();
+  /* Walk the fan again to store the result for the walked corners. */
+  const int result = is_cyclic ? first_corner : FAN_NOT_CYCLIC;
+  fan_first_corners[corner].store(result, std::memory_order_relaxed);
+  e2lfan_curr = e2l_prev;
+  fan_corner = corner_prev;
+  vert_corner = corner;
+  for (int64_t i = 0; i < steps_num; i++) {
+    corner_manifold_fan_around_vert_next(
+        corner_verts, faces, corner_to_face, e2lfan_curr, vert_pivot, &fan_corner, &vert_corner);
+    e2lfan_curr = edge_to_corners[corner_edges[fan_corner]];
+    fan_first_corners[vert_corner].store(result, std::memory_order_relaxed);
   }
+
+  return is_cyclic && first_corner == corner;
 }
 
+enum class CornerFanType : int8_t {
+  /** The corner is part of a fan processed from another corner. */
+  None,
+  /** Both edges around the corner's vertex are sharp, it just uses the face normal. */
+  Single,
+  /** The first corner of a smooth fan. */
+  Fan,
+};
+
 static void corner_split_generator(CornerSplitTaskDataCommon *common_data,
-                                   Vector<int, 32> &r_single_corners,
-                                   Vector<int, 32> &r_fan_corners)
+                                   IndexMaskMemory &memory,
+                                   IndexMask &r_single_corners,
+                                   IndexMask &r_fan_corners)
 {
   const Span<int> corner_verts = common_data->corner_verts;
   const Span<int> corner_edges = common_data->corner_edges;
@@ -1102,61 +1380,51 @@ static void corner_split_generator(CornerSplitTaskDataCommon *common_data,
   const Span<int> corner_to_face = common_data->corner_to_face;
   const Span<int2> edge_to_corners = common_data->edge_to_corners;
 
-  BitVector<> skip_corners(corner_verts.size(), false);
-
 #ifdef DEBUG_TIME
   SCOPED_TIMER_AVERAGED(__func__);
 #endif
 
+  Array<CornerFanType> fan_types(corner_verts.size(), NoInitialization());
+  Array<std::atomic<int>> fan_first_corners(corner_verts.size(), NoInitialization());
+  threading::parallel_for(fan_first_corners.index_range(), 4096, [&](const IndexRange range) {
+    for (std::atomic<int> &first_corner : fan_first_corners.as_mutable_span().slice(range)) {
+      first_corner.store(FAN_UNKNOWN, std::memory_order_relaxed);
+    }
+  });
+
   /* We now know edges that can be smoothed (with their vector, and their two corners),
    * and edges that will be hard! Now, time to generate the normals.
    */
-  for (const int face_index : faces.index_range()) {
-    const IndexRange face = faces[face_index];
-
-    for (const int corner : face) {
-      const int corner_prev = mesh::face_corner_prev(face, corner);
-
-#if 0
-      printf("Checking corner %d / edge %u / vert %u (sharp edge: %d, skiploop: %d)",
-             corner,
-             corner_edges[corner],
-             corner_verts[corner],
-             IS_EDGE_SHARP(edge_to_corners[corner_edges[corner]]),
-             skip_corners[corner]);
-#endif
-
-      /* A smooth edge, we have to check for cyclic smooth fan case.
-       * If we find a new, never-processed cyclic smooth fan, we can do it now using that
-       * corner/edge as 'entry point', otherwise we can skip it. */
-
-      /* NOTE: In theory, we could make #corner_split_generator_check_cyclic_smooth_fan() store
-       * vert_corner'es and edge indexes in two stacks, to avoid having to fan again around
-       * the vert during actual computation of `clnor` & `clnorspace`.
-       * However, this would complicate the code, add more memory usage, and despite its logical
-       * complexity, #corner_manifold_fan_around_vert_next() is quite cheap in term of CPU cycles,
-       * so really think it's not worth it. */
-      if (!IS_EDGE_SHARP(edge_to_corners[corner_edges[corner]]) &&
-          (skip_corners[corner] || !corner_split_generator_check_cyclic_smooth_fan(
-                                       corner_verts,
-                                       corner_edges,
-                                       faces,
-                                       edge_to_corners,
-                                       corner_to_face,
-                                       edge_to_corners[corner_edges[corner_prev]],
-                                       skip_corners,
-                                       corner,
-                                       corner_prev)))
-      {
-        // printf("SKIPPING!\n");
-      }
-      else {
-        if (IS_EDGE_SHARP(edge_to_corners[corner_edges[corner]]) &&
-            IS_EDGE_SHARP(edge_to_corners[corner_edges[corner_prev]]))
+  threading::parallel_for(faces.index_range(), 1024, [&](const IndexRange range) {
+    for (const int face_index : range) {
+      const IndexRange face = faces[face_index];
+
+      for (const int corner : face) {
+        const int corner_prev = mesh::face_corner_prev(face, corner);
+
+        /* A smooth edge, we have to check for cyclic smooth fan case.
+         * If we find a new, never-processed cyclic smooth fan, we can do it now using that
+         * corner/edge as 'entry point', otherwise we can skip it. */
+        if (!IS_EDGE_SHARP(edge_to_corners[corner_edges[corner]]) &&
+            !corner_split_generator_check_cyclic_smooth_fan(
+                corner_verts,
+                corner_edges,
+                faces,
+                edge_to_corners,
+                corner_to_face,
+                edge_to_corners[corner_edges[corner_prev]],
+                corner,
+                corner_prev,
+                fan_first_corners))
+        {
+          fan_types[corner] = CornerFanType::None;
+        }
+        else if (IS_EDGE_SHARP(edge_to_corners[corner_edges[corner]]) &&
+                 IS_EDGE_SHARP(edge_to_corners[corner_edges[corner_prev]]))
         {
           /* Simple case (both edges around that vertex are sharp in current face),
            * this corner just takes its face normal. */
-          r_single_corners.append(corner);
+          fan_types[corner] = CornerFanType::Single;
         }
         else {
           /* We do not need to check/tag corners as already computed. Due to the fact that a corner
@@ -1166,11 +1434,20 @@ static void corner_split_generator(CornerSplitTaskDataCommon *common_data,
            * current edge, smooth previous edge), and not the alternative (smooth current edge,
            * sharp previous edge). All this due/thanks to the link between normals and corner
            * ordering (i.e. winding). */
-          r_fan_corners.append(corner);
+          fan_types[corner] = CornerFanType::Fan;
         }
       }
     }
-  }
+  });
+
+  r_single_corners = IndexMask::from_predicate(
+      fan_types.index_range(), GrainSize(4096), memory, [&](const int corner) {
+        return fan_types[corner] == CornerFanType::Single;
+      });
+  r_fan_corners = IndexMask::from_predicate(
+      fan_types.index_range(), GrainSize(4096), memory, [&](const int corner) {
+        return fan_types[corner] == CornerFanType::Fan;
+      });
 }
 
 void normals_calc_corners(const Span<float3> vert_positions,
@@ -1200,7 +1477,7 @@ void normals_calc_corners(const Span<float3> vert_positions,
    * However, if needed, we can store the negated value of corner index instead of INDEX_INVALID
    * to retrieve the real value later in code).
    * Note also that loose edges always have both values set to 0! */
-  Array<int2> edge_to_corners(edges.size(), int2(0));
+  Array<int2> edge_to_corners(edges.size(), NoInitialization());
 
   CornerNormalSpaceArray _lnors_spacearr;
 
@@ -1229,11 +1506,12 @@ void normals_calc_corners(const Span<float3> vert_positions,
 
   /* This first corner check which edges are actually smooth, and compute edge vectors. */
   build_edge_to_corner_map_with_flip_and_sharp(
-      faces, corner_verts, corner_edges, sharp_faces, sharp_edges, edge_to_corners);
+      corner_verts, corner_edges, corner_to_face_map, sharp_faces, sharp_edges, edge_to_corners);
 
-  Vector<int, 32> single_corners;
-  Vector<int, 32> fan_corners;
-  corner_split_generator(&common_data, single_corners, fan_corners);
+  IndexMaskMemory memory;
+  IndexMask single_corners;
+  IndexMask fan_corners;
+  corner_split_generator(&common_data, memory, single_corners, fan_corners);
 
   if (r_lnors_spacearr) {
     r_lnors_spacearr->spaces.reinitialize(single_corners.size() + fan_corners.size());
@@ -1243,21 +1521,19 @@ void normals_calc_corners(const Span<float3> vert_positions,
     }
   }
 
-  threading::parallel_for(single_corners.index_range(), 1024, [&](const IndexRange range) {
-    for (const int i : range) {
-      const int corner = single_corners[i];
-      lnor_space_for_single_fan(&common_data, corner, i);
-    }
+  single_corners.foreach_index(GrainSize(1024), [&](const int corner, const int i) {
+    lnor_space_for_single_fan(&common_data, corner, i);
   });
 
-  threading::parallel_for(fan_corners.index_range(), 1024, [&](const IndexRange range) {
-    Vector<float3, 16> edge_vectors;
-    for (const int i : range) {
-      const int corner = fan_corners[i];
-      const int space_index = single_corners.size() + i;
-      split_corner_normal_fan_do(&common_data, corner, space_index, &edge_vectors);
-    }
-  });
+  fan_corners.foreach_segment(GrainSize(1024),
+                              [&](const IndexMaskSegment segment, const int64_t segment_pos) {
+                                Vector<float3, 16> edge_vectors;
+                                for (const int64_t i : segment.index_range()) {
+                                  const int space_index = single_corners.size() + segment_pos + i;
+                                  split_corner_normal_fan_do(
+                                      &common_data, segment[i], space_index, &edge_vectors);
+                                }
+                              });
 }
 
 #undef INDEX_UNSET
@@ -0,0 +1,342 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_map.hh"
+#include "BLI_math_constants.h"
+#include "BLI_math_vector.hh"
+#include "BLI_ordered_edge.hh"
+#include "BLI_rand.hh"
+#include "BLI_vector.hh"
+
+#include "BKE_mesh.hh"
+#include "BKE_mesh_mapping.hh"
+
+#define DO_PERF_TESTS 0
+
+#if DO_PERF_TESTS
+#  include "BLI_timeit.hh"
+#endif
+
+namespace blender::bke::mesh::tests {
+
+/** Mesh topology and positions, without the overhead of creating a #Mesh. */
+struct TestMesh {
+  Vector<float3> positions;
+  Vector<int2> edges;
+  Vector<int> face_offsets;
+  Vector<int> corner_verts;
+  Vector<int> corner_edges;
+  Map<OrderedEdge, int> edge_indices;
+
+  OffsetIndices<int> faces() const
+  {
+    return this->face_offsets.as_span();
+  }
+
+  void add_face(const Span<int> verts)
+  {
+    if (this->face_offsets.is_empty()) {
+      this->face_offsets.append(0);
+    }
+    for (const int i : verts.index_range()) {
+      const int vert = verts[i];
+      const int vert_next = verts[(i + 1) % verts.size()];
+      const int edge = this->edge_indices.lookup_or_add_cb(OrderedEdge(vert, vert_next), [&]() {
+        this->edges.append(int2(vert, vert_next));
+        return int(this->edges.size() - 1);
+      });
+      this->corner_verts.append(vert);
+      this->corner_edges.append(edge);
+    }
+    this->face_offsets.append(this->corner_verts.size());
+  }
+};
+
+enum class GridFaces {
+  Quads,
+  Triangles,
+  Mixed,
+};
+
+/**
+ * A grid of `size` by `size` faces in the XY plane, with the Z coordinate of every vertex
+ * given by \a height_fn.
+ */
+template<typename HeightFn>
+static TestMesh create_grid(const int size, const GridFaces face_type, const HeightFn &height_fn)
+{
+  TestMesh mesh;
+  for (const int y : IndexRange(size + 1)) {
+    for (const int x : IndexRange(size + 1)) {
+      mesh.positions.append(float3(x, y, height_fn(x, y)));
+    }
+  }
+  const auto vert = [&](const int x, const int y) { return y * (size + 1) + x; };
+  for (const int y : IndexRange(size)) {
+    for (const int x : IndexRange(size)) {
+      const int4 quad(vert(x, y), vert(x + 1, y), vert(x + 1, y + 1), vert(x, y + 1));
+      const bool split = face_type == GridFaces::Triangles ||
+                         (face_type == GridFaces::Mixed && (x + y) % 3 == 0);
+      if (split) {
+        mesh.add_face({quad[0], quad[1], quad[2]});
+        mesh.add_face({quad[0], quad[2], quad[3]});
+      }
+      else {
+        mesh.add_face({quad[0], quad[1], quad[2], quad[3]});
+      }
+    }
+  }
+  return mesh;
+}
+
+static TestMesh create_random_grid(const int size, const GridFaces face_type)
+{
+  RandomNumberGenerator rng(size);
+  return create_grid(size, face_type, [&](int /*x*/, int /*y*/) { return rng.get_float(); });
+}
+
+static void test_face_normals(const TestMesh &mesh)
+{
+  const OffsetIndices<int> faces = mesh.faces();
+  Array<float3> face_normals(faces.size());
+  normals_calc_faces(mesh.positions, faces, mesh.corner_verts, face_normals);
+  for (const int face : faces.index_range()) {
+    const float3 expected = face_normal_calc(mesh.positions,
+                                             mesh.corner_verts.as_span().slice(faces[face]));
+    EXPECT_V3_NEAR(face_normals[face], expected, 1e-5f);
+  }
+}
+
+TEST(mesh_normals, FaceNormalsQuads)
+{
+  /* An odd number of faces, to test the faces that don't fill a whole SIMD register. */
+  test_face_normals(create_random_grid(7, GridFaces::Quads));
+}
+
+TEST(mesh_normals, FaceNormalsTriangles)
+{
+  test_face_normals(create_random_grid(7, GridFaces::Triangles));
+}
+
+TEST(mesh_normals, FaceNormalsMixed)
+{
+  TestMesh mesh = create_random_grid(7, GridFaces::Mixed);
+  mesh.add_face({0, 1, 2, 10, 9});
+  test_face_normals(mesh);
+}
+
+TEST(mesh_normals, FaceNormalsDegenerate)
+{
+  for (const GridFaces face_type : {GridFaces::Quads, GridFaces::Triangles}) {
+    TestMesh mesh = create_grid(3, face_type, [](int /*x*/, int /*y*/) { return 0.0f; });
+    mesh.positions.fill(float3(1.0f, 2.0f, 3.0f));
+    Array<float3> face_normals(mesh.faces().size());
+    normals_calc_faces(mesh.positions, mesh.faces(), mesh.corner_verts, face_normals);
+    for (const float3 &normal : face_normals) {
+      EXPECT_EQ(normal, float3(0.0f, 0.0f, 1.0f));
+    }
+  }
+}
+
+static Array<float3> calc_corner_normals(const TestMesh &mesh, const Span<bool> sharp_edges)
+{
+  const OffsetIndices<int> faces = mesh.faces();
+  Array<float3> face_normals(faces.size());
+  normals_calc_faces(mesh.positions, faces, mesh.corner_verts, face_normals);
+  const Array<int> corner_to_face = build_corner_to_face_map(faces);
+  Array<float3> corner_normals(mesh.corner_verts.size());
+  normals_calc_corners(mesh.positions,
+                       mesh.edges,
+                       faces,
+                       mesh.corner_verts,
+                       mesh.corner_edges,
+                       corner_to_face,
+                       face_normals,
+                       sharp_edges,
+                       {},
+                       {},
+                       nullptr,
+                       corner_normals);
+  return corner_normals;
+}
+
+TEST(mesh_normals, CornerNormalsFlat)
+{
+  const TestMesh mesh = create_grid(6, GridFaces::Mixed, [](int /*x*/, int /*y*/) {
+    return 0.0f;
+  });
+  for (const float3 &normal : calc_corner_normals(mesh, {})) {
+    EXPECT_V3_NEAR(normal, float3(0.0f, 0.0f, 1.0f), 1e-6f);
+  }
+}
+
+/** A grid folded at a right angle along the line `x == 3`. */
+static TestMesh create_folded_grid()
+{
+  return create_grid(6, GridFaces::Quads, [](int x, int /*y*/) { return float(std::abs(x - 3)); });
+}
+
+static float3 folded_grid_face_normal(const float3 &position)
+{
+  return math::normalize(position.x < 3.0f ? float3(1, 0, 1) : float3(-1, 0, 1));
+}
+
+TEST(mesh_normals, CornerNormalsSharpFold)
+{
+  const TestMesh mesh = create_folded_grid();
+  Array<bool> sharp_edges(mesh.edges.size(), false);
+  for (const int edge : mesh.edges.index_range()) {
+    const int2 verts = mesh.edges[edge];
+    sharp_edges[edge] = mesh.positions[verts[0]].x == 3.0f && mesh.positions[verts[1]].x == 3.0f;
+  }
+
+  const Array<float3> corner_normals = calc_corner_normals(mesh, sharp_edges);
+  const OffsetIndices<int> faces = mesh.faces();
+  for (const int face : faces.index_range()) {
+    const float3 center = (mesh.positions[mesh.corner_verts[faces[face].first()]] +
+                           mesh.positions[mesh.corner_verts[faces[face].first() + 2]]) *
+                          0.5f;
+    for (const int corner : faces[face]) {
+      EXPECT_V3_NEAR(corner_normals[corner], folded_grid_face_normal(center), 1e-5f);
+    }
+  }
+}
+
+TEST(mesh_normals, CornerNormalsSmoothFold)
+{
+  const TestMesh mesh = create_folded_grid();
+  const Array<float3> corner_normals = calc_corner_normals(mesh, {});
+  for (const int corner : mesh.corner_verts.index_range()) {
+    const float3 &position = mesh.positions[mesh.corner_verts[corner]];
+    if (position.x == 3.0f) {
+      /* Vertices on the fold average the normals of both sides. */
+      EXPECT_V3_NEAR(corner_normals[corner], float3(0.0f, 0.0f, 1.0f), 1e-5f);
+    }
+    else {
+      EXPECT_V3_NEAR(corner_normals[corner], folded_grid_face_normal(position), 1e-5f);
+    }
+  }
+}
+
+/**
+ * A cone made of a fan of triangles around its apex, like the pole of a UV sphere. The corners
+ * around the apex are in the order of the fan, or in the reverse order.
+ */
+static TestMesh create_cone(const int triangles_num, const bool reverse_order)
+{
+  TestMesh mesh;
+  mesh.positions.append(float3(0.0f, 0.0f, 1.0f));
+  for (const int i : IndexRange(triangles_num)) {
+    const float angle = 2.0f * float(M_PI) * float(i) / float(triangles_num);
+    mesh.positions.append(float3(std::cos(angle), std::sin(angle), 0.0f));
+  }
+  for (const int i : IndexRange(triangles_num)) {
+    const int triangle = reverse_order ? triangles_num - 1 - i : i;
+    mesh.add_face({0, 1 + triangle, 1 + (triangle + 1) % triangles_num});
+  }
+  return mesh;
+}
+
+TEST(mesh_normals, CornerNormalsHighValence)
+{
+  for (const bool reverse_order : {false, true}) {
+    const TestMesh mesh = create_cone(10000, reverse_order);
+    /* A single sharp edge makes the fan around the apex non-cyclic, with the same normal. */
+    Array<bool> sharp_edges(mesh.edges.size(), false);
+    sharp_edges[mesh.edge_indices.lookup(OrderedEdge(0, 1))] = true;
+    for (const Span<bool> sharp : {Span<bool>(), sharp_edges.as_span()}) {
+      const Array<float3> corner_normals = calc_corner_normals(mesh, sharp);
+      for (const int corner : mesh.corner_verts.index_range()) {
+        if (mesh.corner_verts[corner] == 0) {
+          EXPECT_V3_NEAR(corner_normals[corner], float3(0.0f, 0.0f, 1.0f), 1e-2f);
+        }
+      }
+    }
+
+    /* Two opposite sharp edges split the apex into two fans, which lean to their side. */
+    sharp_edges[mesh.edge_indices.lookup(OrderedEdge(0, 1 + 5000))] = true;
+    const Array<float3> corner_normals = calc_corner_normals(mesh, sharp_edges);
+    for (const int corner : mesh.corner_verts.index_range()) {
+      if (mesh.corner_verts[corner] == 0) {
+        const float center_y = (mesh.positions[mesh.corner_verts[corner + 1]].y +
+                                mesh.positions[mesh.corner_verts[corner + 2]].y) *
+                               0.5f;
+        EXPECT_GT(corner_normals[corner].y * center_y, 0.0f);
+        EXPECT_NEAR(corner_normals[corner].x, 0.0f, 1e-2f);
+      }
+    }
+  }
+}
+
+TEST(mesh_normals, EdgesSharpFromAngle)
+{
+  const TestMesh mesh = create_folded_grid();
+  const OffsetIndices<int> faces = mesh.faces();
+  Array<float3> face_normals(faces.size());
+  normals_calc_faces(mesh.positions, faces, mesh.corner_verts, face_normals);
+  const Array<int> corner_to_face = build_corner_to_face_map(faces);
+
+  Array<bool> sharp_edges(mesh.edges.size(), false);
+  edges_sharp_from_angle_set(faces,
+                             mesh.corner_verts,
+                             mesh.corner_edges,
+                             face_normals,
+                             corner_to_face,
+                             {},
+                             DEG2RADF(30.0f),
+                             sharp_edges);
+  for (const int edge : mesh.edges.index_range()) {
+    const int2 verts = mesh.edges[edge];
+    const bool on_fold = mesh.positions[verts[0]].x == 3.0f &&
+                         mesh.positions[verts[1]].x == 3.0f;
+    EXPECT_EQ(sharp_edges[edge], on_fold);
+  }
+}
+
+#if DO_PERF_TESTS
+
+static void face_normals_perf(const GridFaces face_type)
+{
+  const TestMesh mesh = create_random_grid(2000, face_type);
+  Array<float3> face_normals(mesh.faces().size());
+  for ([[maybe_unused]] const int i : IndexRange(5)) {
+    SCOPED_TIMER(std::to_string(face_normals.size()) + " face normals");
+    normals_calc_faces(mesh.positions, mesh.faces(), mesh.corner_verts, face_normals);
+  }
+}
+
+TEST(mesh_normals_performance, FaceNormalsQuads)
+{
+  face_normals_perf(GridFaces::Quads);
+}
+
+TEST(mesh_normals_performance, FaceNormalsTriangles)
+{
+  face_normals_perf(GridFaces::Triangles);
+}
+
+TEST(mesh_normals_performance, FaceNormalsMixed)
+{
+  face_normals_perf(GridFaces::Mixed);
+}
+
+TEST(mesh_normals_performance, CornerNormalsSharpEdges)
+{
+  const TestMesh mesh = create_random_grid(2000, GridFaces::Quads);
+  RandomNumberGenerator rng(0);
+  Array<bool> sharp_edges(mesh.edges.size());
+  for (bool &sharp : sharp_edges) {
+    sharp = rng.get_float() < 0.05f;
+  }
+  for ([[maybe_unused]] const int i : IndexRange(5)) {
+    SCOPED_TIMER(std::to_string(mesh.corner_verts.size()) + " corner normals");
+    calc_corner_normals(mesh, sharp_edges);
+  }
+}
+
+#endif
+
+}  // namespace blender::bke::mesh::tests
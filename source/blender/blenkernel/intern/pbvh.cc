@@ -22,6 +22,7 @@
 #include "BLI_vector_set.hh"
 
 #include "DNA_object_types.h"
+#include "DNA_userdef_types.h"
 
 #include "BKE_attribute.hh"
 #include "BKE_ccg.hh"
@@ -130,6 +131,413 @@ BLI_NOINLINE static void build_mesh_leaf_nodes(const int verts_num,
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Node Hierarchy Build
+ *
+ * The faces are first sorted along a Z-order curve, then split recursively with a binned surface
+ * area heuristic. Partitioning is stable, so the faces of every node stay in Z-order and spatially
+ * close faces end up close to each other in #Tree::prim_indices_. Large subtrees are built in
+ * parallel.
+ *
+ * This is only used when the experimental "Sculpt SAH BVH Build" option is enabled, otherwise the
+ * nodes are split in the middle of their bounds by #build_nodes_recursive_mesh and
+ * #build_nodes_recursive_grids.
+ * \{ */
+
+/** The number of bins used to evaluate split candidates. */
+constexpr int sah_bins_num = 16;
+
+/**
+ * A face and its center. Storing the center next to the face index means the build streams
+ * through memory, rather than looking up centers in the original face order.
+ */
+struct FaceRef {
+  float3 center;
+  int face;
+};
+
+/** Node of the tree built by #build_nodes_recursive, before it is flattened into #Tree::nodes_. */
+struct BuildNode {
+  /** The range of the node's faces in the sorted face references. */
+  IndexRange faces;
+  std::unique_ptr<BuildNode> children[2];
+};
+
+static bool leaf_needs_material_split(const Span<FaceRef> faces, const Span<int> material_indices)
+{
+  if (material_indices.is_empty()) {
+    return false;
+  }
+  const int first = material_indices[faces.first().face];
+  return std::any_of(faces.begin(), faces.end(), [&](const FaceRef &face) {
+    return material_indices[face.face] != first;
+  });
+}
+
+/**
+ * Move the faces for which \a predicate is true to the front, keeping the order of the faces on
+ * both sides. Unlike `std::stable_partition` this doesn't allocate, the faces of the second part
+ * are stored in \a scratch temporarily.
+ *
+ * \return The number of faces in the first part.
+ */
+template<typename Fn>
+static int stable_partition_faces(MutableSpan<FaceRef> faces,
+                                  MutableSpan<FaceRef> scratch,
+                                  const Fn &predicate)
+{
+  int first_num = 0;
+  int second_num = 0;
+  for (const int i : faces.index_range()) {
+    const FaceRef face = faces[i];
+    if (predicate(face)) {
+      faces[first_num++] = face;
+    }
+    else {
+      scratch[second_num++] = face;
+    }
+  }
+  faces.drop_front(first_num).copy_from(scratch.take_front(second_num));
+  return first_num;
+}
+
+static int partition_material_indices(const Span<int> material_indices,
+                                      MutableSpan<FaceRef> faces,
+                                      MutableSpan<FaceRef> scratch)
+{
+  const int first = material_indices[faces.first().face];
+  return stable_partition_faces(faces, scratch, [&](const FaceRef &face) {
+    return material_indices[face.face] == first;
+  });
+}
+
+/** Spread the lower 10 bits of the value so that there are two zero bits between each bit. */
+static uint32_t expand_bits_10(uint32_t value)
+{
+  value = (value * 0x00010001u) & 0xFF0000FFu;
+  value = (value * 0x00000101u) & 0x0F00F00Fu;
+  value = (value * 0x00000011u) & 0xC30C30C3u;
+  value = (value * 0x00000005u) & 0x49249249u;
+  return value;
+}
+
+static uint32_t morton_code(const float3 &position, const Bounds<float3> &bounds)
+{
+  const float3 size = bounds.max - bounds.min;
+  uint32_t code = 0;
+  for (const int axis : IndexRange(3)) {
+    const float factor = size[axis] > 0.0f ? (position[axis] - bounds.min[axis]) / size[axis] :
+                                             0.0f;
+    const uint32_t quantized = uint32_t(std::clamp(factor * 1024.0f, 0.0f, 1023.0f));
+    code |= expand_bits_10(quantized) << (2 - axis);
+  }
+  return code;
+}
+
+/**
+ * Sort the keys by the Morton code in their upper bits with a least significant digit radix sort.
+ * Every pass counts and scatters chunks of the keys in parallel. The sort is stable, so faces with
+ * the same code keep their original order.
+ */
+static void sort_morton_keys(MutableSpan<uint64_t> keys)
+{
+  constexpr int digit_bits = 10;
+  constexpr int digits_num = 3;
+  constexpr int buckets_num = 1 << digit_bits;
+  constexpr uint64_t digit_mask = buckets_num - 1;
+  constexpr int64_t chunk_size = 1 << 16;
+
+  const int64_t chunks_num = divide_ceil_ul(keys.size(), chunk_size);
+  Array<int> chunk_offsets(chunks_num * buckets_num);
+  Array<uint64_t> buffer(keys.size(), NoInitialization());
+  MutableSpan<uint64_t> src = keys;
+  MutableSpan<uint64_t> dst = buffer;
+  for (const int digit : IndexRange(digits_num)) {
+    const int shift = 32 + digit * digit_bits;
+    threading::parallel_for(IndexRange(chunks_num), 1, [&](const IndexRange range) {
+      for (const int64_t chunk : range) {
+        MutableSpan<int> counts = chunk_offsets.as_mutable_span().slice(chunk * buckets_num,
+                                                                        buckets_num);
+        counts.fill(0);
+        for (const uint64_t key : src.slice_safe(chunk * chunk_size, chunk_size)) {
+          counts[(key >> shift) & digit_mask]++;
+        }
+      }
+    });
+    /* Keys of the same bucket are placed in chunk order to keep the sort stable. */
+    int offset = 0;
+    for (const int bucket : IndexRange(buckets_num)) {
+      for (const int64_t chunk : IndexRange(chunks_num)) {
+        int &chunk_offset = chunk_offsets[chunk * buckets_num + bucket];
+        const int count = chunk_offset;
+        chunk_offset = offset;
+        offset += count;
+      }
+    }
+    threading::parallel_for(IndexRange(chunks_num), 1, [&](const IndexRange range) {
+      for (const int64_t chunk : range) {
+        MutableSpan<int> offsets = chunk_offsets.as_mutable_span().slice(chunk * buckets_num,
+                                                                         buckets_num);
+        for (const uint64_t key : src.slice_safe(chunk * chunk_size, chunk_size)) {
+          dst[offsets[(key >> shift) & digit_mask]++] = key;
+        }
+      }
+    });
+    std::swap(src, dst);
+  }
+  if (src.data() != keys.data()) {
+    keys.copy_from(src);
+  }
+}
+
+static Array<FaceRef> face_refs_sorted_by_morton_code(const Span<float3> face_centers,
+                                                      const Bounds<float3> &bounds,
+                                                      const Span<int> faces)
+{
+  /* Store the face index in the lower bits to make the order deterministic. */
+  Array<uint64_t> keys(faces.size());
+  threading::parallel_for(faces.index_range(), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      const uint32_t code = morton_code(face_centers[faces[i]], bounds);
+      keys[i] = (uint64_t(code) << 32) | uint64_t(faces[i]);
+    }
+  });
+  sort_morton_keys(keys);
+
+  Array<FaceRef> face_refs(faces.size());
+  threading::parallel_for(faces.index_range(), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      const int face = int(keys[i] & 0xFFFFFFFFu);
+      face_refs[i] = {face_centers[face], face};
+    }
+  });
+  return face_refs;
+}
+
+struct SAHBin {
+  Bounds<float3> bounds = negative_bounds();
+  int faces_num = 0;
+};
+
+using SAHBins = std::array<SAHBin, sah_bins_num>;
+
+static float half_surface_area(const Bounds<float3> &bounds)
+{
+  const float3 size = math::max(bounds.max - bounds.min, float3(0.0f));
+  return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+static int sah_bin_index(const float value, const float min, const float bin_factor)
+{
+  return std::clamp(int((value - min) * bin_factor), 0, sah_bins_num - 1);
+}
+
+/**
+ * Split the faces along the longest axis of \a bounds, at the bin boundary with the lowest surface
+ * area heuristic cost. The areas of the bounds of the face centers in each bin are used as an
+ * approximation of the node bounds.
+ *
+ * \return The number of faces in the first child.
+ */
+static int partition_sah(const Bounds<float3> &bounds,
+                         MutableSpan<FaceRef> faces,
+                         MutableSpan<FaceRef> scratch,
+                         Bounds<float3> &r_bounds_a,
+                         Bounds<float3> &r_bounds_b)
+{
+  r_bounds_a = bounds;
+  r_bounds_b = bounds;
+
+  const int axis = math::dominant_axis(bounds.max - bounds.min);
+  const float min = bounds.min[axis];
+  const float size = bounds.max[axis] - min;
+  if (!(size > 0.0f)) {
+    /* All face centers are at the same position, split in the middle of the curve order. */
+    return faces.size() / 2;
+  }
+  const float bin_factor = sah_bins_num / size;
+
+  const SAHBins bins = threading::parallel_reduce(
+      faces.index_range(),
+      4096,
+      SAHBins(),
+      [&](const IndexRange range, SAHBins bins) {
+        for (const FaceRef &face : faces.slice(range)) {
+          SAHBin &bin = bins[sah_bin_index(face.center[axis], min, bin_factor)];
+          math::min_max(face.center, bin.bounds.min, bin.bounds.max);
+          bin.faces_num++;
+        }
+        return bins;
+      },
+      [](const SAHBins &a, const SAHBins &b) {
+        SAHBins result;
+        for (const int i : IndexRange(sah_bins_num)) {
+          result[i].bounds = bounds::merge(a[i].bounds, b[i].bounds);
+          result[i].faces_num = a[i].faces_num + b[i].faces_num;
+        }
+        return result;
+      });
+
+  /* Sweep from the end first to accumulate the cost of the second child for every split. */
+  std::array<float, sah_bins_num> costs_b;
+  Bounds<float3> bounds_b = negative_bounds();
+  int faces_num_b = 0;
+  for (int i = sah_bins_num - 1; i > 0; i--) {
+    bounds_b = bounds::merge(bounds_b, bins[i].bounds);
+    faces_num_b += bins[i].faces_num;
+    costs_b[i] = half_surface_area(bounds_b) * faces_num_b;
+  }
+  float best_cost = std::numeric_limits<float>::max();
+  int best_bin = -1;
+  Bounds<float3> bounds_a = negative_bounds();
+  int faces_num_a = 0;
+  for (const int i : IndexRange(1, sah_bins_num - 1)) {
+    bounds_a = bounds::merge(bounds_a, bins[i - 1].bounds);
+    faces_num_a += bins[i - 1].faces_num;
+    if (faces_num_a == 0 || faces_num_a == faces.size()) {
+      continue;
+    }
+    const float cost = half_surface_area(bounds_a) * faces_num_a + costs_b[i];
+    if (cost < best_cost) {
+      best_cost = cost;
+      best_bin = i;
+    }
+  }
+  if (best_bin == -1) {
+    return faces.size() / 2;
+  }
+
+  r_bounds_a = negative_bounds();
+  r_bounds_b = negative_bounds();
+  for (const int i : IndexRange(sah_bins_num)) {
+    Bounds<float3> &child_bounds = i < best_bin ? r_bounds_a : r_bounds_b;
+    child_bounds = bounds::merge(child_bounds, bins[i].bounds);
+  }
+
+  return stable_partition_faces(faces, scratch, [&](const FaceRef &face) {
+    return sah_bin_index(face.center[axis], min, bin_factor) < best_bin;
+  });
+}
+
+static void build_nodes_recursive(const Span<int> material_indices,
+                                  const int leaf_limit,
+                                  const Bounds<float3> &bounds,
+                                  const int depth,
+                                  MutableSpan<FaceRef> all_faces,
+                                  MutableSpan<FaceRef> all_scratch,
+                                  BuildNode &node)
+{
+  MutableSpan<FaceRef> faces = all_faces.slice(node.faces);
+  /* The scratch range of the node is only used by the node's own subtree. */
+  MutableSpan<FaceRef> scratch = all_scratch.slice(node.faces);
+
+  /* Decide whether this is a leaf or not */
+  const bool below_leaf_limit = faces.size() <= leaf_limit || depth >= STACK_FIXED_DEPTH - 1;
+  if (below_leaf_limit) {
+    if (!leaf_needs_material_split(faces, material_indices)) {
+      return;
+    }
+  }
+
+  int split;
+  Bounds<float3> bounds_a = bounds;
+  Bounds<float3> bounds_b = bounds;
+  if (!below_leaf_limit) {
+    split = partition_sah(bounds, faces, scratch, bounds_a, bounds_b);
+  }
+  else {
+    /* Partition primitives by material */
+    split = partition_material_indices(material_indices, faces, scratch);
+  }
+
+  /* Build children */
+  node.children[0] = std::make_unique<BuildNode>();
+  node.children[1] = std::make_unique<BuildNode>();
+  node.children[0]->faces = IndexRange(node.faces.start(), split);
+  node.children[1]->faces = node.faces.drop_front(split);
+  threading::parallel_invoke(
+      faces.size() > leaf_limit * 8,
+      [&]() {
+        build_nodes_recursive(material_indices,
+                              leaf_limit,
+                              bounds_a,
+                              depth + 1,
+                              all_faces,
+                              all_scratch,
+                              *node.children[0]);
+      },
+      [&]() {
+        build_nodes_recursive(material_indices,
+                              leaf_limit,
+                              bounds_b,
+                              depth + 1,
+                              all_faces,
+                              all_scratch,
+                              *node.children[1]);
+      });
+}
+
+/**
+ * Add the nodes of the build tree to the BVH, with the same layout as a depth-first recursive
+ * build: the two children of a node are added next to each other before its first child's
+ * subtree.
+ */
+template<typename NodeT>
+static void flatten_build_nodes(const BuildNode &build_node,
+                                const int node_index,
+                                const Span<int> faces,
+                                Vector<NodeT> &nodes)
+{
+  if (!build_node.children[0]) {
+    NodeT &node = nodes[node_index];
+    node.flag_ |= Node::Leaf;
+    if constexpr (std::is_same_v<NodeT, MeshNode>) {
+      node.face_indices_ = faces.slice(build_node.faces);
+    }
+    else {
+      node.prim_indices_ = faces.slice(build_node.faces);
+    }
+    return;
+  }
+  const int children_offset = nodes.size();
+  nodes[node_index].children_offset_ = children_offset;
+  nodes.resize(nodes.size() + 2);
+  flatten_build_nodes(*build_node.children[0], children_offset, faces, nodes);
+  flatten_build_nodes(*build_node.children[1], children_offset + 1, faces, nodes);
+}
+
+/**
+ * Build the node hierarchy and reorder \a faces so that the faces of every leaf node are
+ * contiguous. The leaf nodes reference ranges of \a faces.
+ */
+template<typename NodeT>
+static void build_nodes(const Span<int> material_indices,
+                        const int leaf_limit,
+                        const Bounds<float3> &bounds,
+                        const Span<float3> face_centers,
+                        MutableSpan<int> faces,
+                        Vector<NodeT> &nodes)
+{
+  Array<FaceRef> face_refs = face_refs_sorted_by_morton_code(face_centers, bounds, faces);
+  /* Temporary storage for partitioning the faces of all nodes. */
+  Array<FaceRef> scratch(face_refs.size(), NoInitialization());
+
+  BuildNode root;
+  root.faces = faces.index_range();
+  build_nodes_recursive(material_indices, leaf_limit, bounds, 0, face_refs, scratch, root);
+
+  threading::parallel_for(faces.index_range(), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      faces[i] = face_refs[i].face;
+    }
+  });
+
+  nodes.resize(1);
+  flatten_build_nodes(root, 0, faces, nodes);
+}
+
+/** \} */
+
 static bool leaf_needs_material_split(const Span<int> faces, const Span<int> material_indices)
 {
   if (material_indices.is_empty()) {
@@ -264,11 +672,17 @@ Tree Tree::from_mesh(const Mesh &mesh)
   array_utils::fill_index_range<int>(pbvh.prim_indices_);
 
   Vector<MeshNode> &nodes = std::get<Vector<MeshNode>>(pbvh.nodes_);
-  nodes.resize(1);
-  {
+  if (USER_EXPERIMENTAL_TEST(&U, use_sculpt_bvh_sah)) {
+#ifdef DEBUG_BUILD_TIME
+    SCOPED_TIMER_AVERAGED("build_nodes");
+#endif
+    build_nodes(material_index, leaf_limit, bounds, face_centers, pbvh.prim_indices_, nodes);
+  }
+  else {
 #ifdef DEBUG_BUILD_TIME
     SCOPED_TIMER_AVERAGED("build_nodes_recursive_mesh");
 #endif
+    nodes.resize(1);
     build_nodes_recursive_mesh(
         material_index, leaf_limit, 0, bounds, face_centers, 0, pbvh.prim_indices_, nodes);
   }
@@ -420,11 +834,17 @@ Tree Tree::from_grids(const Mesh &base_mesh, const SubdivCCG &subdiv_ccg)
   array_utils::fill_index_range<int>(face_indices);
 
   Vector<GridsNode> &nodes = std::get<Vector<GridsNode>>(pbvh.nodes_);
-  nodes.resize(1);
-  {
+  if (USER_EXPERIMENTAL_TEST(&U, use_sculpt_bvh_sah)) {
+#ifdef DEBUG_BUILD_TIME
+    SCOPED_TIMER_AVERAGED("build_nodes");
+#endif
+    build_nodes(material_index, leaf_limit, bounds, face_centers, face_indices, nodes);
+  }
+  else {
 #ifdef DEBUG_BUILD_TIME
     SCOPED_TIMER_AVERAGED("build_nodes_recursive_grids");
 #endif
+    nodes.resize(1);
     build_nodes_recursive_grids(
         material_index, leaf_limit, 0, bounds, face_centers, 0, face_indices, nodes);
   }
@@ -81,6 +81,7 @@
 
 #include "BLI_alloca.h"
 #include "BLI_array.hh"
+#include "BLI_index_mask.hh"
 #include "BLI_index_range.hh"
 #include "BLI_listbase.h"
 #include "BLI_math_vector.h"
@@ -92,6 +93,7 @@
 #include "BKE_attribute.hh"
 #include "BKE_customdata.hh"
 #include "BKE_mesh.hh"
+#include "BKE_mesh_mapping.hh"
 #include "BKE_mesh_runtime.hh"
 #include "BKE_multires.hh"
 
@@ -134,24 +136,6 @@ bool BM_attribute_stored_in_bmesh_builtin(const StringRef name)
               "sharp_edge");
 }
 
-static BMFace *bm_face_create_from_mpoly(BMesh &bm,
-                                         Span<int> face_verts,
-                                         Span<int> face_edges,
-                                         Span<BMVert *> vtable,
-                                         Span<BMEdge *> etable)
-{
-  const int size = face_verts.size();
-  Array<BMVert *, BM_DEFAULT_NGON_STACK_SIZE> verts(size);
-  Array<BMEdge *, BM_DEFAULT_NGON_STACK_SIZE> edges(size);
-
-  for (const int i : IndexRange(size)) {
-    verts[i] = vtable[face_verts[i]];
-    edges[i] = etable[face_edges[i]];
-  }
-
-  return BM_face_create(&bm, verts.data(), edges.data(), size, nullptr, BM_CREATE_SKIP_CD);
-}
-
 struct MeshToBMeshLayerInfo {
   eCustomDataType type;
   /** The layer's position in the BMesh element's data block. */
@@ -191,24 +175,118 @@ static Vector<MeshToBMeshLayerInfo> mesh_to_bm_copy_info_calc(const CustomData &
   return infos;
 }
 
-static void mesh_attributes_copy_to_bmesh_block(CustomData &data,
-                                                const Span<MeshToBMeshLayerInfo> copy_info,
+static void mesh_attributes_copy_to_bmesh_block(const Span<MeshToBMeshLayerInfo> copy_info,
                                                 const int mesh_index,
-                                                BMHeader &header)
+                                                void *block)
 {
-  CustomData_bmesh_alloc_block(&data, &header.data);
   for (const MeshToBMeshLayerInfo &info : copy_info) {
     if (info.mesh_data) {
       CustomData_data_copy_value(info.type,
                                  POINTER_OFFSET(info.mesh_data, info.elem_size * mesh_index),
-                                 POINTER_OFFSET(header.data, info.bmesh_offset));
+                                 POINTER_OFFSET(block, info.bmesh_offset));
     }
     else {
-      CustomData_data_set_default_value(info.type, POINTER_OFFSET(header.data, info.bmesh_offset));
+      CustomData_data_set_default_value(info.type, POINTER_OFFSET(block, info.bmesh_offset));
+    }
+  }
+}
+
+namespace blender {
+
+/**
+ * Allocate the elements for the given mesh indices and their custom data blocks, in the order of
+ * the mesh indices so that iterating over the pool matches the mesh order. Allocating from the
+ * pools isn't thread-safe, but it's cheap compared to filling in the elements, which is done in
+ * parallel afterwards. The custom data blocks are allocated but not initialized.
+ */
+template<typename T, typename OFlagT = void>
+static void bm_elems_alloc(BLI_mempool *pool,
+                           CustomData &data,
+                           BLI_mempool *toolflag_pool,
+                           const bool use_toolflags,
+                           const IndexMask &mask,
+                           MutableSpan<T *> r_elems)
+{
+  mask.foreach_index([&](const int i) {
+    T *elem = static_cast<T *>(BLI_mempool_alloc(pool));
+    elem->head.data = nullptr;
+    CustomData_bmesh_alloc_block(&data, &elem->head.data);
+    if constexpr (!std::is_void_v<OFlagT>) {
+      if (use_toolflags) {
+        reinterpret_cast<OFlagT *>(elem)->oflags = static_cast<BMFlagLayer *>(
+            toolflag_pool ? BLI_mempool_calloc(toolflag_pool) : nullptr);
+      }
     }
+    r_elems[i] = elem;
+  });
+}
+
+/**
+ * Link the edges around a vertex into its disk cycle, in the same order as appending them one by
+ * one in the order of their indices with #bmesh_disk_edge_append.
+ */
+static void bm_vert_disk_cycle_build(BMVert &vert,
+                                     const int vert_i,
+                                     const Span<int> vert_edges,
+                                     const Span<int2> edges,
+                                     const Span<BMEdge *> etable)
+{
+  if (vert_edges.is_empty()) {
+    vert.e = nullptr;
+    return;
+  }
+  const int edges_num = vert_edges.size();
+  for (const int i : vert_edges.index_range()) {
+    const int edge_i = vert_edges[i];
+    BMEdge &edge = *etable[edge_i];
+    BMDiskLink &link = edges[edge_i][0] == vert_i ? edge.v1_disk_link : edge.v2_disk_link;
+    link.prev = etable[vert_edges[(i + edges_num - 1) % edges_num]];
+    link.next = etable[vert_edges[(i + 1) % edges_num]];
+  }
+  vert.e = etable[vert_edges.first()];
+}
+
+/**
+ * Link the loops using an edge into its radial cycle, in the same order as appending them one by
+ * one in the order of their indices with #bmesh_radial_loop_append.
+ */
+static void bm_edge_radial_cycle_build(BMEdge &edge,
+                                       const Span<int> edge_corners,
+                                       const Span<BMLoop *> ltable)
+{
+  if (edge_corners.is_empty()) {
+    edge.l = nullptr;
+    return;
+  }
+  const int corners_num = edge_corners.size();
+  for (const int i : edge_corners.index_range()) {
+    BMLoop &loop = *ltable[edge_corners[i]];
+    loop.radial_prev = ltable[edge_corners[(i + corners_num - 1) % corners_num]];
+    loop.radial_next = ltable[edge_corners[(i + 1) % corners_num]];
   }
+  /* The last appended loop is the edge's loop. */
+  edge.l = ltable[edge_corners.last()];
 }
 
+template<typename T> static int bm_elems_count_selected(const Span<T *> elems)
+{
+  return threading::parallel_reduce(
+      elems.index_range(),
+      4096,
+      0,
+      [&](const IndexRange range, int count) {
+        for (const int i : range) {
+          if (elems[i] && BM_elem_flag_test(elems[i], BM_ELEM_SELECT)) {
+            count++;
+          }
+        }
+        return count;
+      },
+      std::plus<>());
+}
+
+}  // namespace blender
+
 void BM_mesh_bm_from_me(BMesh *bm, const Mesh *mesh, const BMeshFromMeshParams *params)
 {
   using namespace blender;
@@ -433,101 +511,189 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *mesh, const BMeshFromMeshParams *
   const VArraySpan uv_seams = *attributes.lookup<bool>("uv_seam", AttrDomain::Edge);
 
   const Span<float3> positions = mesh->vert_positions();
+  const Span<int2> edges = mesh->edges();
+  const OffsetIndices faces = mesh->faces();
+  const Span<int> corner_verts = mesh->corner_verts();
+  const Span<int> corner_edges = mesh->corner_edges();
+
+  /* Faces without corners can't be represented in a #BMesh. */
+  IndexMaskMemory memory;
+  const IndexMask valid_faces = IndexMask::from_predicate(
+      faces.index_range(), GrainSize(4096), memory, [&](const int i) {
+        return !faces[i].is_empty();
+      });
+  if (valid_faces.size() != faces.size()) {
+    valid_faces.complement(faces.index_range(), memory).foreach_index([&](const int i) {
+      printf(
+          "%s: Warning! Bad face in mesh"
+          " \"%s\" at index %d!, skipping\n",
+          __func__,
+          mesh->id.name + 2,
+          i);
+    });
+  }
+
+  /* Allocate all elements up front (the pools are usually reserved for the size of the mesh, see
+   * #BMALLOC_TEMPLATE_FROM_ME), while building the topology maps that are used to link them.
+   * Every pool is only accessed by a single thread. */
   Array<BMVert *> vtable(mesh->verts_num);
-  for (const int i : positions.index_range()) {
-    BMVert *v = vtable[i] = BM_vert_create(
-        bm, keyco ? keyco[i] : positions[i], nullptr, BM_CREATE_SKIP_CD);
-    BM_elem_index_set(v, i); /* set_ok */
+  Array<BMEdge *> etable(mesh->edges_num);
+  Array<BMFace *> ftable(mesh->faces_num, nullptr);
+  Array<BMLoop *> ltable(mesh->corners_num);
+  Array<int> vert_to_edge_offsets;
+  Array<int> vert_to_edge_indices;
+  GroupedSpan<int> vert_to_edge_map;
+  Array<int> edge_to_corner_offsets;
+  Array<int> edge_to_corner_indices;
+  GroupedSpan<int> edge_to_corner_map;
+  threading::parallel_invoke(
+      (mesh->faces_num + mesh->edges_num) > 1024,
+      [&]() {
+        bm_elems_alloc<BMVert, BMVert_OFlag>(bm->vpool,
+                                             bm->vdata,
+                                             bm->vtoolflagpool,
+                                             bm->use_toolflags,
+                                             vtable.index_range(),
+                                             vtable);
+      },
+      [&]() {
+        bm_elems_alloc<BMEdge, BMEdge_OFlag>(bm->epool,
+                                             bm->edata,
+                                             bm->etoolflagpool,
+                                             bm->use_toolflags,
+                                             etable.index_range(),
+                                             etable);
+      },
+      [&]() {
+        bm_elems_alloc<BMFace, BMFace_OFlag>(
+            bm->fpool, bm->pdata, bm->ftoolflagpool, bm->use_toolflags, valid_faces, ftable);
+      },
+      [&]() {
+        bm_elems_alloc<BMLoop>(
+            bm->lpool, bm->ldata, nullptr, false, ltable.index_range(), ltable);
+      },
+      [&]() {
+        vert_to_edge_map = bke::mesh::build_vert_to_edge_map(
+            edges, mesh->verts_num, vert_to_edge_offsets, vert_to_edge_indices);
+      },
+      [&]() {
+        edge_to_corner_map = bke::mesh::build_edge_to_corner_map(
+            corner_edges, mesh->edges_num, edge_to_corner_offsets, edge_to_corner_indices);
+      });
 
-    if (!hide_vert.is_empty() && hide_vert[i]) {
-      BM_elem_flag_enable(v, BM_ELEM_HIDDEN);
-    }
-    if (!select_vert.is_empty() && select_vert[i]) {
-      BM_vert_select_set(bm, v, true);
-    }
+  const int face_index_start = bm->totface;
+  bm->totvert += mesh->verts_num;
+  bm->totedge += mesh->edges_num;
+  bm->totface += valid_faces.size();
+  bm->totloop += mesh->corners_num;
+  bm->elem_index_dirty |= BM_VERT | BM_EDGE | BM_FACE | BM_LOOP;
+  bm->elem_table_dirty |= BM_VERT | BM_EDGE | BM_FACE;
+  bm->spacearr_dirty |= BM_SPACEARR_DIRTY_ALL;
+
+  /* The elements are filled in with the same result as creating them one by one, but every
+   * element is only written by a single thread: vertices build their disk cycles and edges build
+   * their radial cycles. */
+  threading::parallel_for(vtable.index_range(), 1024, [&](const IndexRange range) {
+    for (const int i : range) {
+      BMVert *v = vtable[i];
+      v->head.htype = BM_VERT;
+      v->head.hflag = 0;
+      v->head.api_flag = 0;
+      BM_elem_index_set(v, i); /* set_ok */
+
+      copy_v3_v3(v->co, keyco ? keyco[i] : positions[i]);
+      if (!vert_normals.is_empty()) {
+        copy_v3_v3(v->no, vert_normals[i]);
+      }
+      else {
+        zero_v3(v->no);
+      }
 
-    if (!vert_normals.is_empty()) {
-      copy_v3_v3(v->no, vert_normals[i]);
-    }
+      if (!hide_vert.is_empty() && hide_vert[i]) {
+        BM_elem_flag_enable(v, BM_ELEM_HIDDEN);
+      }
+      else if (!select_vert.is_empty() && select_vert[i]) {
+        BM_elem_flag_enable(v, BM_ELEM_SELECT);
+      }
 
-    mesh_attributes_copy_to_bmesh_block(bm->vdata, vert_info, i, v->head);
+      bm_vert_disk_cycle_build(*v, i, vert_to_edge_map[i], edges, etable);
 
-    /* Set shape key original index. */
-    if (cd_shape_keyindex_offset != -1) {
-      BM_ELEM_CD_SET_INT(v, cd_shape_keyindex_offset, i);
-    }
+      mesh_attributes_copy_to_bmesh_block(vert_info, i, v->head.data);
 
-    /* Set shape-key data. */
-    if (tot_shape_keys) {
-      float(*co_dst)[3] = (float(*)[3])BM_ELEM_CD_GET_VOID_P(v, cd_shape_key_offset);
-      for (int j = 0; j < tot_shape_keys; j++, co_dst++) {
-        copy_v3_v3(*co_dst, shape_key_table[j][i]);
+      /* Set shape key original index. */
+      if (cd_shape_keyindex_offset != -1) {
+        BM_ELEM_CD_SET_INT(v, cd_shape_keyindex_offset, i);
       }
-    }
-  }
-  if (is_new) {
-    bm->elem_index_dirty &= ~BM_VERT; /* Added in order, clear dirty flag. */
-  }
 
-  const Span<blender::int2> edges = mesh->edges();
-  Array<BMEdge *> etable(mesh->edges_num);
-  for (const int i : edges.index_range()) {
-    BMEdge *e = etable[i] = BM_edge_create(
-        bm, vtable[edges[i][0]], vtable[edges[i][1]], nullptr, BM_CREATE_SKIP_CD);
-    BM_elem_index_set(e, i); /* set_ok */
-
-    e->head.hflag = 0;
-    if (!uv_seams.is_empty() && uv_seams[i]) {
-      BM_elem_flag_enable(e, BM_ELEM_SEAM);
-    }
-    if (!hide_edge.is_empty() && hide_edge[i]) {
-      BM_elem_flag_enable(e, BM_ELEM_HIDDEN);
-    }
-    if (!select_edge.is_empty() && select_edge[i]) {
-      BM_edge_select_set(bm, e, true);
-    }
-    if (!(!sharp_edges.is_empty() && sharp_edges[i])) {
-      BM_elem_flag_enable(e, BM_ELEM_SMOOTH);
+      /* Set shape-key data. */
+      if (tot_shape_keys) {
+        float(*co_dst)[3] = (float(*)[3])BM_ELEM_CD_GET_VOID_P(v, cd_shape_key_offset);
+        for (int j = 0; j < tot_shape_keys; j++, co_dst++) {
+          copy_v3_v3(*co_dst, shape_key_table[j][i]);
+        }
+      }
     }
+  });
 
-    mesh_attributes_copy_to_bmesh_block(bm->edata, edge_info, i, e->head);
-  }
-  if (is_new) {
-    bm->elem_index_dirty &= ~BM_EDGE; /* Added in order, clear dirty flag. */
-  }
+  threading::parallel_for(etable.index_range(), 1024, [&](const IndexRange range) {
+    for (const int i : range) {
+      BMEdge *e = etable[i];
+      e->head.htype = BM_EDGE;
+      e->head.hflag = 0;
+      e->head.api_flag = 0;
+      BM_elem_index_set(e, i); /* set_ok */
 
-  const blender::OffsetIndices faces = mesh->faces();
-  const Span<int> corner_verts = mesh->corner_verts();
-  const Span<int> corner_edges = mesh->corner_edges();
+      e->v1 = vtable[edges[i][0]];
+      e->v2 = vtable[edges[i][1]];
 
-  /* Only needed for selection. */
+      if (!uv_seams.is_empty() && uv_seams[i]) {
+        BM_elem_flag_enable(e, BM_ELEM_SEAM);
+      }
+      if (!hide_edge.is_empty() && hide_edge[i]) {
+        BM_elem_flag_enable(e, BM_ELEM_HIDDEN);
+      }
+      else if (!select_edge.is_empty() && select_edge[i]) {
+        BM_elem_flag_enable(e, BM_ELEM_SELECT);
+      }
+      if (!(!sharp_edges.is_empty() && sharp_edges[i])) {
+        BM_elem_flag_enable(e, BM_ELEM_SMOOTH);
+      }
 
-  Array<BMFace *> ftable;
-  if (mesh->mselect && mesh->totselect != 0) {
-    ftable.reinitialize(mesh->faces_num);
-  }
+      bm_edge_radial_cycle_build(*e, edge_to_corner_map[i], ltable);
 
-  int totloops = 0;
-  for (const int i : faces.index_range()) {
-    const IndexRange face = faces[i];
-    BMFace *f = bm_face_create_from_mpoly(
-        *bm, corner_verts.slice(face), corner_edges.slice(face), vtable, etable);
-    if (!ftable.is_empty()) {
-      ftable[i] = f;
+      mesh_attributes_copy_to_bmesh_block(edge_info, i, e->head.data);
     }
+  });
 
-    if (UNLIKELY(f == nullptr)) {
-      printf(
-          "%s: Warning! Bad face in mesh"
-          " \"%s\" at index %d!, skipping\n",
-          __func__,
-          mesh->id.name + 2,
-          i);
-      continue;
-    }
+  valid_faces.foreach_index(GrainSize(1024), [&](const int i, const int pos) {
+    const IndexRange face = faces[i];
+    BMFace *f = ftable[i];
+    f->head.htype = BM_FACE;
+    f->head.hflag = 0;
+    f->head.api_flag = 0;
+    /* Don't use 'i' since we may have skipped some faces. */
+    BM_elem_index_set(f, face_index_start + pos); /* set_ok */
+
+    f->l_first = ltable[face.first()];
+    f->len = face.size();
+    f->mat_nr = material_indices.is_empty() ? 0 : material_indices[i];
+
+    for (const int corner : face) {
+      BMLoop *l = ltable[corner];
+      l->head.htype = BM_LOOP;
+      l->head.hflag = 0;
+      l->head.api_flag = 0;
+      /* Skipped faces don't have any corners, so the corner index can be used. */
+      BM_elem_index_set(l, corner); /* set_ok */
 
-    /* Don't use 'i' since we may have skipped the face. */
-    BM_elem_index_set(f, bm->totface - 1); /* set_ok */
+      l->v = vtable[corner_verts[corner]];
+      l->e = etable[corner_edges[corner]];
+      l->f = f;
+      l->prev = ltable[corner == face.first() ? face.last() : corner - 1];
+      l->next = ltable[corner == face.last() ? face.first() : corner + 1];
+
+      mesh_attributes_copy_to_bmesh_block(loop_info, corner, l->head.data);
+    }
 
     /* Transfer flag. */
     if (!(!sharp_faces.is_empty() && sharp_faces[i])) {
@@ -536,34 +702,84 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *mesh, const BMeshFromMeshParams *
     if (!hide_poly.is_empty() && hide_poly[i]) {
       BM_elem_flag_enable(f, BM_ELEM_HIDDEN);
     }
-    if (!select_poly.is_empty() && select_poly[i]) {
-      BM_face_select_set(bm, f, true);
-    }
-
-    f->mat_nr = material_indices.is_empty() ? 0 : material_indices[i];
-    if (i == mesh->act_face) {
-      bm->act_face = f;
+    else if (!select_poly.is_empty() && select_poly[i]) {
+      BM_elem_flag_enable(f, BM_ELEM_SELECT);
     }
 
-    int j = face.start();
-    BMLoop *l_first = BM_FACE_FIRST_LOOP(f);
-    BMLoop *l_iter = l_first;
-    do {
-      /* Don't use 'j' since we may have skipped some faces, hence some loops. */
-      BM_elem_index_set(l_iter, totloops++); /* set_ok */
-
-      mesh_attributes_copy_to_bmesh_block(bm->ldata, loop_info, j, l_iter->head);
-      j++;
-    } while ((l_iter = l_iter->next) != l_first);
-
-    mesh_attributes_copy_to_bmesh_block(bm->pdata, poly_info, i, f->head);
+    mesh_attributes_copy_to_bmesh_block(poly_info, i, f->head.data);
 
     if (params->calc_face_normal) {
       BM_face_normal_update(f);
     }
+    else {
+      zero_v3(f->no);
+    }
+  });
+
+  if (IndexRange(mesh->faces_num).contains(mesh->act_face) && ftable[mesh->act_face]) {
+    bm->act_face = ftable[mesh->act_face];
   }
+
+  /* Flush the selection from faces to their edges and vertices and from edges to their vertices,
+   * like #BM_face_select_set and #BM_edge_select_set, skipping hidden elements. */
+  if (!select_poly.is_empty()) {
+    threading::parallel_for(etable.index_range(), 1024, [&](const IndexRange range) {
+      for (const int i : range) {
+        BMEdge *e = etable[i];
+        if (BM_elem_flag_test(e, BM_ELEM_HIDDEN | BM_ELEM_SELECT)) {
+          continue;
+        }
+        for (const int corner : edge_to_corner_map[i]) {
+          if (BM_elem_flag_test(ltable[corner]->f, BM_ELEM_SELECT)) {
+            BM_elem_flag_enable(e, BM_ELEM_SELECT);
+            break;
+          }
+        }
+      }
+    });
+  }
+  if (!select_edge.is_empty() || !select_poly.is_empty()) {
+    threading::parallel_for(vtable.index_range(), 1024, [&](const IndexRange range) {
+      for (const int i : range) {
+        BMVert *v = vtable[i];
+        if (BM_elem_flag_test(v, BM_ELEM_HIDDEN | BM_ELEM_SELECT)) {
+          continue;
+        }
+        const bool select = std::any_of(
+            vert_to_edge_map[i].begin(), vert_to_edge_map[i].end(), [&](const int edge_i) {
+              if (BM_elem_flag_test(etable[edge_i], BM_ELEM_SELECT)) {
+                return true;
+              }
+              if (select_poly.is_empty()) {
+                return false;
+              }
+              /* Selected faces select their vertices even when their edges are hidden. Every
+               * face using the vertex also uses one of its edges. */
+              return std::any_of(edge_to_corner_map[edge_i].begin(),
+                                 edge_to_corner_map[edge_i].end(),
+                                 [&](const int corner) {
+                                   return BM_elem_flag_test(ltable[corner]->f, BM_ELEM_SELECT);
+                                 });
+            });
+        if (select) {
+          BM_elem_flag_enable(v, BM_ELEM_SELECT);
+        }
+      }
+    });
+  }
+  if (!select_vert.is_empty() || !select_edge.is_empty() || !select_poly.is_empty()) {
+    bm->totvertsel += bm_elems_count_selected(vtable.as_span());
+  }
+  if (!select_edge.is_empty() || !select_poly.is_empty()) {
+    bm->totedgesel += bm_elems_count_selected(etable.as_span());
+  }
+  if (!select_poly.is_empty()) {
+    bm->totfacesel += bm_elems_count_selected(ftable.as_span());
+  }
+
   if (is_new) {
-    bm->elem_index_dirty &= ~(BM_FACE | BM_LOOP); /* Added in order, clear dirty flag. */
+    /* Added in order, clear dirty flag. */
+    bm->elem_index_dirty &= ~(BM_VERT | BM_EDGE | BM_FACE | BM_LOOP);
   }
 
   /* -------------------------------------------------------------------- */
@@ -0,0 +1,429 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_map.hh"
+#include "BLI_math_vector.h"
+#include "BLI_math_vector_types.hh"
+
+#include "BKE_attribute.hh"
+#include "BKE_idtype.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_mesh.hh"
+
+#include "DNA_mesh_types.h"
+
+#include "bmesh.hh"
+
+namespace blender::bmesh::tests {
+
+class bmesh_mesh_convert : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+};
+
+/**
+ * A grid of 2x2 quads with a triangle on the middle edge of the bottom row, which makes that edge
+ * non-manifold, a loose edge from the tip of the triangle, a loose vertex and a face without
+ * corners as the third face.
+ */
+static Mesh *create_test_mesh()
+{
+  const Array<int> face_sizes = {4, 4, 0, 4, 4, 3};
+  const Array<int> corner_verts = {0, 1, 4, 3, 1, 2, 5, 4, 3, 4, 7, 6, 4, 5, 8, 7, 1, 4, 10};
+  Mesh *mesh = BKE_mesh_new_nomain(12, 1, 6, 19);
+
+  MutableSpan<float3> positions = mesh->vert_positions_for_write();
+  for (const int i : IndexRange(9)) {
+    positions[i] = float3(i % 3, i / 3, 0.0f);
+  }
+  positions[9] = float3(3.0f, 3.0f, 0.0f);
+  positions[10] = float3(1.0f, 0.5f, 1.0f);
+  positions[11] = float3(5.0f, 5.0f, 5.0f);
+
+  MutableSpan<int> face_offsets = mesh->face_offsets_for_write();
+  face_offsets[0] = 0;
+  for (const int i : IndexRange(6)) {
+    face_offsets[i + 1] = face_offsets[i] + face_sizes[i];
+  }
+  mesh->corner_verts_for_write().copy_from(corner_verts);
+
+  /* The loose edge, the other edges are created from the faces. */
+  mesh->edges_for_write()[0] = int2(9, 10);
+  bke::mesh_calc_edges(*mesh, true, false);
+  return mesh;
+}
+
+static int find_edge(const Mesh *mesh, const int v1, const int v2)
+{
+  const Span<int2> edges = mesh->edges();
+  for (const int i : edges.index_range()) {
+    if ((edges[i][0] == v1 && edges[i][1] == v2) || (edges[i][0] == v2 && edges[i][1] == v1)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static void set_bool_attribute(Mesh *mesh,
+                               const StringRef name,
+                               const bke::AttrDomain domain,
+                               const Span<int> indices)
+{
+  bke::MutableAttributeAccessor attributes = mesh->attributes_for_write();
+  bke::SpanAttributeWriter attribute = attributes.lookup_or_add_for_write_span<bool>(name,
+                                                                                     domain);
+  for (const int i : indices) {
+    attribute.span[i] = true;
+  }
+  attribute.finish();
+}
+
+/**
+ * Converts the mesh into the BMesh like #BM_mesh_bm_from_me did before it filled in the elements
+ * in parallel, by creating and selecting the elements one by one with the BMesh API. Custom data
+ * isn't copied.
+ */
+static void bm_from_me_reference(BMesh *bm, const Mesh *mesh)
+{
+  const bke::AttributeAccessor attributes = mesh->attributes();
+  const VArraySpan select_vert = *attributes.lookup<bool>(".select_vert", bke::AttrDomain::Point);
+  const VArraySpan select_edge = *attributes.lookup<bool>(".select_edge", bke::AttrDomain::Edge);
+  const VArraySpan select_poly = *attributes.lookup<bool>(".select_poly", bke::AttrDomain::Face);
+  const VArraySpan hide_vert = *attributes.lookup<bool>(".hide_vert", bke::AttrDomain::Point);
+  const VArraySpan hide_edge = *attributes.lookup<bool>(".hide_edge", bke::AttrDomain::Edge);
+  const VArraySpan hide_poly = *attributes.lookup<bool>(".hide_poly", bke::AttrDomain::Face);
+  const Span<float3> positions = mesh->vert_positions();
+  const Span<float3> vert_normals = mesh->vert_normals();
+  const Span<int2> edges = mesh->edges();
+  const OffsetIndices faces = mesh->faces();
+  const Span<int> corner_verts = mesh->corner_verts();
+  const Span<int> corner_edges = mesh->corner_edges();
+
+  Array<BMVert *> vtable(mesh->verts_num);
+  for (const int i : positions.index_range()) {
+    BMVert *v = vtable[i] = BM_vert_create(bm, positions[i], nullptr, BM_CREATE_NOP);
+    BM_elem_index_set(v, i); /* set_ok */
+    copy_v3_v3(v->no, vert_normals[i]);
+    if (!hide_vert.is_empty() && hide_vert[i]) {
+      BM_elem_flag_enable(v, BM_ELEM_HIDDEN);
+    }
+    if (!select_vert.is_empty() && select_vert[i]) {
+      BM_vert_select_set(bm, v, true);
+    }
+  }
+
+  Array<BMEdge *> etable(mesh->edges_num);
+  for (const int i : edges.index_range()) {
+    BMEdge *e = etable[i] = BM_edge_create(
+        bm, vtable[edges[i][0]], vtable[edges[i][1]], nullptr, BM_CREATE_NOP);
+    BM_elem_index_set(e, i); /* set_ok */
+    e->head.hflag = BM_ELEM_SMOOTH;
+    if (!hide_edge.is_empty() && hide_edge[i]) {
+      BM_elem_flag_enable(e, BM_ELEM_HIDDEN);
+    }
+    if (!select_edge.is_empty() && select_edge[i]) {
+      BM_edge_select_set(bm, e, true);
+    }
+  }
+
+  for (const int i : faces.index_range()) {
+    const IndexRange face = faces[i];
+    Array<BMVert *> verts(face.size());
+    Array<BMEdge *> face_edges(face.size());
+    for (const int j : face.index_range()) {
+      verts[j] = vtable[corner_verts[face[j]]];
+      face_edges[j] = etable[corner_edges[face[j]]];
+    }
+    BMFace *f = BM_face_create(
+        bm, verts.data(), face_edges.data(), face.size(), nullptr, BM_CREATE_NOP);
+    if (f == nullptr) {
+      continue;
+    }
+    BM_elem_index_set(f, bm->totface - 1); /* set_ok */
+    BM_elem_flag_enable(f, BM_ELEM_SMOOTH);
+    if (!hide_poly.is_empty() && hide_poly[i]) {
+      BM_elem_flag_enable(f, BM_ELEM_HIDDEN);
+    }
+    if (!select_poly.is_empty() && select_poly[i]) {
+      BM_face_select_set(bm, f, true);
+    }
+    BMLoop *l_iter = BM_FACE_FIRST_LOOP(f);
+    for (const int corner : face) {
+      BM_elem_index_set(l_iter, corner); /* set_ok */
+      l_iter = l_iter->next;
+    }
+    BM_face_normal_update(f);
+  }
+}
+
+static BMesh *bm_create(const Mesh *mesh)
+{
+  const BMAllocTemplate allocsize = BMALLOC_TEMPLATE_FROM_ME(mesh);
+  BMeshCreateParams create_params{};
+  create_params.use_toolflags = true;
+  return BM_mesh_create(&allocsize, &create_params);
+}
+
+static void bm_from_me(BMesh *bm, const Mesh *mesh)
+{
+  BMeshFromMeshParams params{};
+  params.calc_face_normal = true;
+  params.calc_vert_normal = true;
+  BM_mesh_bm_from_me(bm, mesh, &params);
+}
+
+/* Positions of the elements in the iteration order of the BMesh, which is the order in which they
+ * were added, to compare the links between elements of two meshes. */
+struct BMeshElemPositions {
+  Map<const void *, int> positions;
+
+  int operator()(const void *elem) const
+  {
+    return elem ? positions.lookup(elem) : -1;
+  }
+};
+
+static BMeshElemPositions bm_elem_positions_get(BMesh *bm)
+{
+  BMeshElemPositions result;
+  BMIter iter;
+  BMVert *v;
+  BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
+    result.positions.add_new(v, result.positions.size());
+  }
+  BMEdge *e;
+  BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
+    result.positions.add_new(e, result.positions.size());
+  }
+  BMFace *f;
+  BM_ITER_MESH (f, &iter, bm, BM_FACES_OF_MESH) {
+    result.positions.add_new(f, result.positions.size());
+    BMLoop *l_iter = BM_FACE_FIRST_LOOP(f);
+    do {
+      result.positions.add_new(l_iter, result.positions.size());
+    } while ((l_iter = l_iter->next) != BM_FACE_FIRST_LOOP(f));
+  }
+  return result;
+}
+
+template<typename T> static Vector<T *> bm_elems_get(BMesh *bm, const char itype)
+{
+  Vector<T *> elems;
+  BMIter iter;
+  void *elem;
+  BM_ITER_MESH (elem, &iter, bm, itype) {
+    elems.append(static_cast<T *>(elem));
+  }
+  return elems;
+}
+
+/**
+ * Compares the elements of the meshes in their iteration order: their flags, indices and values,
+ * and the order of their disk and radial cycles.
+ */
+static void expect_bmesh_eq(BMesh *bm, BMesh *bm_ref)
+{
+  EXPECT_EQ(bm->totvert, bm_ref->totvert);
+  EXPECT_EQ(bm->totedge, bm_ref->totedge);
+  EXPECT_EQ(bm->totface, bm_ref->totface);
+  EXPECT_EQ(bm->totloop, bm_ref->totloop);
+  EXPECT_EQ(bm->totvertsel, bm_ref->totvertsel);
+  EXPECT_EQ(bm->totedgesel, bm_ref->totedgesel);
+  EXPECT_EQ(bm->totfacesel, bm_ref->totfacesel);
+
+  const BMeshElemPositions pos = bm_elem_positions_get(bm);
+  const BMeshElemPositions pos_ref = bm_elem_positions_get(bm_ref);
+
+  const Vector<BMVert *> verts = bm_elems_get<BMVert>(bm, BM_VERTS_OF_MESH);
+  const Vector<BMVert *> verts_ref = bm_elems_get<BMVert>(bm_ref, BM_VERTS_OF_MESH);
+  ASSERT_EQ(verts.size(), verts_ref.size());
+  for (const int i : verts.index_range()) {
+    SCOPED_TRACE("vertex " + std::to_string(i));
+    const BMVert *v = verts[i];
+    const BMVert *v_ref = verts_ref[i];
+    EXPECT_EQ(v->head.hflag, v_ref->head.hflag);
+    EXPECT_EQ(BM_elem_index_get(v), BM_elem_index_get(v_ref));
+    EXPECT_EQ(float3(v->co), float3(v_ref->co));
+    EXPECT_EQ(float3(v->no), float3(v_ref->no));
+    EXPECT_EQ(pos(v->e), pos_ref(v_ref->e));
+  }
+
+  const Vector<BMEdge *> edges = bm_elems_get<BMEdge>(bm, BM_EDGES_OF_MESH);
+  const Vector<BMEdge *> edges_ref = bm_elems_get<BMEdge>(bm_ref, BM_EDGES_OF_MESH);
+  ASSERT_EQ(edges.size(), edges_ref.size());
+  for (const int i : edges.index_range()) {
+    SCOPED_TRACE("edge " + std::to_string(i));
+    const BMEdge *e = edges[i];
+    const BMEdge *e_ref = edges_ref[i];
+    EXPECT_EQ(e->head.hflag, e_ref->head.hflag);
+    EXPECT_EQ(BM_elem_index_get(e), BM_elem_index_get(e_ref));
+    EXPECT_EQ(pos(e->v1), pos_ref(e_ref->v1));
+    EXPECT_EQ(pos(e->v2), pos_ref(e_ref->v2));
+    EXPECT_EQ(pos(e->v1_disk_link.prev), pos_ref(e_ref->v1_disk_link.prev));
+    EXPECT_EQ(pos(e->v1_disk_link.next), pos_ref(e_ref->v1_disk_link.next));
+    EXPECT_EQ(pos(e->v2_disk_link.prev), pos_ref(e_ref->v2_disk_link.prev));
+    EXPECT_EQ(pos(e->v2_disk_link.next), pos_ref(e_ref->v2_disk_link.next));
+    EXPECT_EQ(pos(e->l), pos_ref(e_ref->l));
+  }
+
+  const Vector<BMFace *> faces = bm_elems_get<BMFace>(bm, BM_FACES_OF_MESH);
+  const Vector<BMFace *> faces_ref = bm_elems_get<BMFace>(bm_ref, BM_FACES_OF_MESH);
+  ASSERT_EQ(faces.size(), faces_ref.size());
+  for (const int i : faces.index_range()) {
+    SCOPED_TRACE("face " + std::to_string(i));
+    const BMFace *f = faces[i];
+    const BMFace *f_ref = faces_ref[i];
+    EXPECT_EQ(f->head.hflag, f_ref->head.hflag);
+    EXPECT_EQ(BM_elem_index_get(f), BM_elem_index_get(f_ref));
+    EXPECT_EQ(f->len, f_ref->len);
+    EXPECT_EQ(f->mat_nr, f_ref->mat_nr);
+    EXPECT_EQ(float3(f->no), float3(f_ref->no));
+    ASSERT_EQ(pos(f->l_first), pos_ref(f_ref->l_first));
+
+    const BMLoop *l = f->l_first;
+    const BMLoop *l_ref = f_ref->l_first;
+    for (int j = 0; j < f->len; j++, l = l->next, l_ref = l_ref->next) {
+      SCOPED_TRACE("loop " + std::to_string(j));
+      EXPECT_EQ(l->head.hflag, l_ref->head.hflag);
+      EXPECT_EQ(BM_elem_index_get(l), BM_elem_index_get(l_ref));
+      EXPECT_EQ(pos(l->v), pos_ref(l_ref->v));
+      EXPECT_EQ(pos(l->e), pos_ref(l_ref->e));
+      EXPECT_EQ(pos(l->f), pos_ref(l_ref->f));
+      EXPECT_EQ(pos(l->next), pos_ref(l_ref->next));
+      EXPECT_EQ(pos(l->prev), pos_ref(l_ref->prev));
+      EXPECT_EQ(pos(l->radial_next), pos_ref(l_ref->radial_next));
+      EXPECT_EQ(pos(l->radial_prev), pos_ref(l_ref->radial_prev));
+    }
+  }
+}
+
+/* Disk and radial cycles, including those of the non-manifold edge, the loose edge and the loose
+ * vertex, have the same order as creating the elements one by one. */
+TEST_F(bmesh_mesh_convert, bm_from_me_matches_reference)
+{
+  Mesh *mesh = create_test_mesh();
+  BMesh *bm = bm_create(mesh);
+  BMesh *bm_ref = bm_create(mesh);
+  bm_from_me(bm, mesh);
+  bm_from_me_reference(bm_ref, mesh);
+
+  expect_bmesh_eq(bm, bm_ref);
+
+  /* The non-manifold edge is used by three faces. */
+  const int edge_i = find_edge(mesh, 1, 4);
+  BMEdge *e = BM_edge_exists(BM_vert_at_index_find(bm, 1), BM_vert_at_index_find(bm, 4));
+  ASSERT_NE(e, nullptr);
+  EXPECT_EQ(BM_elem_index_get(e), edge_i);
+  EXPECT_EQ(BM_edge_face_count(e), 3);
+#ifndef NDEBUG
+  /* Only available in debug builds. */
+#ifndef NDEBUG
+  EXPECT_TRUE(BM_mesh_validate(bm));
+#endif
+#endif
+
+  BM_mesh_free(bm);
+  BM_mesh_free(bm_ref);
+  BKE_id_free(nullptr, mesh);
+}
+
+/* Faces without corners are skipped, and the indices of the following faces are shifted. */
+TEST_F(bmesh_mesh_convert, bm_from_me_skips_empty_faces)
+{
+  Mesh *mesh = create_test_mesh();
+  BMesh *bm = bm_create(mesh);
+  bm_from_me(bm, mesh);
+
+  EXPECT_EQ(bm->totvert, 12);
+  EXPECT_EQ(bm->totface, 5);
+  EXPECT_EQ(bm->totloop, 19);
+  const Vector<BMFace *> faces = bm_elems_get<BMFace>(bm, BM_FACES_OF_MESH);
+  ASSERT_EQ(faces.size(), 5);
+  const int face_sizes[] = {4, 4, 4, 4, 3};
+  for (const int i : faces.index_range()) {
+    EXPECT_EQ(BM_elem_index_get(faces[i]), i);
+    EXPECT_EQ(faces[i]->len, face_sizes[i]);
+  }
+#ifndef NDEBUG
+  EXPECT_TRUE(BM_mesh_validate(bm));
+#endif
+
+  BM_mesh_free(bm);
+  BKE_id_free(nullptr, mesh);
+}
+
+/* Selected faces select their edges and vertices, and selected edges their vertices, unless they
+ * are hidden. Vertices of a selected face are selected even when its edges are hidden. */
+TEST_F(bmesh_mesh_convert, bm_from_me_selection_flush)
+{
+  Mesh *mesh = create_test_mesh();
+  const int hidden_edge = find_edge(mesh, 0, 1);
+  const int loose_edge = find_edge(mesh, 9, 10);
+  set_bool_attribute(mesh, ".select_poly", bke::AttrDomain::Face, {0, 3});
+  set_bool_attribute(mesh, ".hide_poly", bke::AttrDomain::Face, {3});
+  set_bool_attribute(mesh, ".hide_edge", bke::AttrDomain::Edge, {hidden_edge});
+  set_bool_attribute(mesh, ".select_edge", bke::AttrDomain::Edge, {loose_edge});
+  set_bool_attribute(mesh, ".select_vert", bke::AttrDomain::Point, {8, 11});
+  set_bool_attribute(mesh, ".hide_vert", bke::AttrDomain::Point, {11});
+
+  BMesh *bm = bm_create(mesh);
+  BMesh *bm_ref = bm_create(mesh);
+  bm_from_me(bm, mesh);
+  bm_from_me_reference(bm_ref, mesh);
+  expect_bmesh_eq(bm, bm_ref);
+
+  /* The first face, its three visible edges and the loose edge, and the vertices of the first
+   * face, the loose edge and vertex 8. */
+  EXPECT_EQ(bm->totfacesel, 1);
+  EXPECT_EQ(bm->totedgesel, 4);
+  EXPECT_EQ(bm->totvertsel, 7);
+  BM_mesh_elem_table_ensure(bm, BM_VERT | BM_EDGE);
+  EXPECT_FALSE(BM_elem_flag_test(BM_edge_at_index(bm, hidden_edge), BM_ELEM_SELECT));
+  EXPECT_TRUE(BM_elem_flag_test(BM_vert_at_index(bm, 0), BM_ELEM_SELECT));
+  EXPECT_TRUE(BM_elem_flag_test(BM_vert_at_index(bm, 1), BM_ELEM_SELECT));
+  EXPECT_FALSE(BM_elem_flag_test(BM_vert_at_index(bm, 7), BM_ELEM_SELECT));
+  EXPECT_FALSE(BM_elem_flag_test(BM_vert_at_index(bm, 11), BM_ELEM_SELECT));
+
+  BM_mesh_free(bm);
+  BM_mesh_free(bm_ref);
+  BKE_id_free(nullptr, mesh);
+}
+
+/* Converting a mesh into a BMesh that has elements already appends the new elements, and adds to
+ * the selection counts. */
+TEST_F(bmesh_mesh_convert, bm_from_me_append)
+{
+  Mesh *mesh = create_test_mesh();
+  Mesh *mesh_selected = create_test_mesh();
+  set_bool_attribute(mesh_selected, ".select_poly", bke::AttrDomain::Face, {1, 5});
+
+  BMesh *bm = bm_create(mesh);
+  BMesh *bm_ref = bm_create(mesh);
+  bm_from_me(bm, mesh_selected);
+  bm_from_me(bm, mesh);
+  bm_from_me(bm, mesh_selected);
+  bm_from_me_reference(bm_ref, mesh_selected);
+  bm_from_me_reference(bm_ref, mesh);
+  bm_from_me_reference(bm_ref, mesh_selected);
+
+  EXPECT_EQ(bm->totvert, 3 * 12);
+  EXPECT_EQ(bm->totface, 3 * 5);
+  EXPECT_EQ(bm->totfacesel, 2 * 2);
+  expect_bmesh_eq(bm, bm_ref);
+#ifndef NDEBUG
+  EXPECT_TRUE(BM_mesh_validate(bm));
+#endif
+
+  BM_mesh_free(bm);
+  BM_mesh_free(bm_ref);
+  BKE_id_free(nullptr, mesh);
+  BKE_id_free(nullptr, mesh_selected);
+}
+
+}  // namespace blender::bmesh::tests
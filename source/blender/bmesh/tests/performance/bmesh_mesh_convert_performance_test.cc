@@ -0,0 +1,82 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "BLI_timeit.hh"
+
+#include "BKE_attribute.hh"
+#include "BKE_idtype.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_mesh.hh"
+
+#include "DNA_mesh_types.h"
+
+#include "GEO_mesh_primitive_grid.hh"
+
+#include "bmesh.hh"
+
+using namespace blender;
+
+class bmesh_mesh_convert : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+};
+
+static void bm_from_me_perf(const int verts_per_side)
+{
+  Mesh *mesh = geometry::create_grid_mesh(verts_per_side, verts_per_side, 1.0f, 1.0f, "UVMap");
+
+  /* Select and hide some of the faces, to include flushing the selection. */
+  bke::MutableAttributeAccessor attributes = mesh->attributes_for_write();
+  bke::SpanAttributeWriter select_poly = attributes.lookup_or_add_for_write_span<bool>(
+      ".select_poly", bke::AttrDomain::Face);
+  bke::SpanAttributeWriter hide_poly = attributes.lookup_or_add_for_write_span<bool>(
+      ".hide_poly", bke::AttrDomain::Face);
+  for (const int i : select_poly.span.index_range()) {
+    select_poly.span[i] = i % 3 == 0;
+    hide_poly.span[i] = i % 7 == 0;
+  }
+  select_poly.finish();
+  hide_poly.finish();
+
+  BMeshCreateParams create_params{};
+  create_params.use_toolflags = true;
+  BMeshFromMeshParams convert_params{};
+  convert_params.calc_face_normal = true;
+  convert_params.calc_vert_normal = true;
+
+  for (int i = 0; i < 3; i++) {
+    BMesh *bm;
+    {
+      SCOPED_TIMER(std::to_string(mesh->faces_num) + " faces");
+      bm = BKE_mesh_to_bmesh_ex(mesh, &create_params, &convert_params);
+    }
+    EXPECT_EQ(bm->totvert, mesh->verts_num);
+    EXPECT_EQ(bm->totedge, mesh->edges_num);
+    EXPECT_EQ(bm->totface, mesh->faces_num);
+    EXPECT_EQ(bm->totloop, mesh->corners_num);
+    BM_mesh_free(bm);
+  }
+
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(bmesh_mesh_convert, bm_from_me_perf_small)
+{
+  bm_from_me_perf(128);
+}
+
+TEST_F(bmesh_mesh_convert, bm_from_me_perf_medium)
+{
+  bm_from_me_perf(1024);
+}
+
+TEST_F(bmesh_mesh_convert, bm_from_me_perf_large)
+{
+  bm_from_me_perf(3072);
+}
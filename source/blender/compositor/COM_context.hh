@@ -5,7 +5,9 @@
 #pragma once
 
 #include <cstdint>
+#include <optional>
 
+#include "BLI_bounds_types.hh"
 #include "BLI_math_vector_types.hh"
 #include "BLI_string_ref.hh"
 
@@ -131,6 +133,23 @@ class Context {
    * executing as soon as possible. */
   virtual bool is_canceled() const;
 
+  /* Get the maximum number of bytes that node results cached across evaluations can occupy, see
+   * the CachedNodeResultContainer class. Zero, the default, disables caching of node results. */
+  virtual int64_t get_node_result_cache_limit() const;
+
+  /* Get the minimum size in bytes of the CPU data of results that are allocated in scratch memory
+   * mapped from a temporary file instead of in the system memory, see COM_scratch_memory.hh. Zero,
+   * the default, disables scratch memory. */
+  virtual int64_t get_scratch_memory_threshold() const;
+
+  /* Get the tile of the compositing region that is currently being evaluated, in pixels relative
+   * to the lower left corner of the compositing region. Large renders might be evaluated in
+   * multiple tiles to limit the memory needed by the compositor, in which case, the outputs only
+   * compute and write the pixels inside the tile, and the regions of interest of the nodes are
+   * computed accordingly, see COM_region_of_interest.hh. Returns nullopt, the default, if the
+   * compositing region is evaluated in a single evaluation. */
+  virtual std::optional<Bounds<int2>> get_output_tile() const;
+
   /* Resets the context's internal structures like the cache manager. This should be called before
    * every evaluation. */
   void reset();
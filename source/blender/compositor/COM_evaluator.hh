@@ -4,16 +4,23 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 
+#include "BLI_set.hh"
+#include "BLI_span.hh"
 #include "BLI_vector.hh"
 
 #include "NOD_derived_node_tree.hh"
 
 #include "COM_compile_state.hh"
 #include "COM_context.hh"
+#include "COM_node_hash.hh"
 #include "COM_node_operation.hh"
 #include "COM_operation.hh"
+#include "COM_operation_task_pool.hh"
+#include "COM_region_of_interest.hh"
 
 namespace blender::compositor {
 
@@ -93,6 +100,15 @@ class Evaluator {
   std::unique_ptr<DerivedNodeTree> derived_node_tree_;
   /* The compiled operations stream, which contains all compiled operations so far. */
   Vector<std::unique_ptr<Operation>> operations_stream_;
+  /* The regions of interest of the nodes in the schedule, see COM_region_of_interest.hh. */
+  RegionsOfInterest regions_of_interest_;
+  /* The hashes of the nodes in the schedule, see COM_node_hash.hh. Empty if node results are not
+   * cached. */
+  NodeHashes node_hashes_;
+  /* The nodes whose results are retrieved from the cache instead of being evaluated. */
+  Set<DNode> cached_nodes_;
+  /* The task pool in which operations are evaluated, see COM_operation_task_pool.hh. */
+  std::unique_ptr<OperationTaskPool> task_pool_;
 
  public:
   /* Construct an evaluator from a context. */
@@ -109,11 +125,43 @@ class Evaluator {
    * method. */
   bool validate_node_tree();
 
+  /* Identify the nodes whose results are all cached, see the CachedNodeResultContainer class, and
+   * return a copy of the schedule without the nodes that are only needed to evaluate those nodes.
+   * The identified nodes are added to the cached_nodes_ member. */
+  Schedule prune_cached_nodes(const Schedule &schedule);
+
+  /* Returns true if the results of the given node that are used by the given kept nodes are all
+   * cached and the node need not be evaluated. */
+  bool is_node_cached(const DNode &node, const Set<DNode> &kept_nodes, bool compute_previews);
+
+  /* Returns the index of the first of the given remaining nodes that is ready to be compiled, see
+   * the is_node_ready method. Returns nullopt if no node is ready, in which case, the caller
+   * should wait for some operations to be evaluated. */
+  std::optional<int64_t> find_next_ready_node(Span<DNode> remaining_nodes,
+                                              const Set<DNode> &compiled_nodes,
+                                              CompileState &compile_state);
+
+  /* Returns true if the given node can be compiled, that is, if all the nodes it depends on were
+   * compiled, and, for pixel nodes, if the results that the compile state inspects to decide on
+   * the pixel compile unit of the node are evaluated. */
+  bool is_node_ready(const DNode &node,
+                     const Set<DNode> &compiled_nodes,
+                     CompileState &compile_state);
+
   /* Compile the given node into a node operation, map each input to the result of the output
    * linked to it, update the compile state, add the newly created operation to the operations
-   * stream, and evaluate the operation. */
+   * stream, and add it to the task pool to be evaluated and have its results cached if possible
+   * once the operations it depends on are evaluated. */
   void evaluate_node(DNode node, CompileState &compile_state);
 
+  /* Compile the given cached node into a node operation, update the compile state, add the newly
+   * created operation to the operations stream, and share the data of the cached results of the
+   * node with the results of the operation instead of evaluating it. */
+  void evaluate_cached_node(DNode node, CompileState &compile_state);
+
+  /* Add the results of the given evaluated node operation to the cached node results. */
+  void cache_node_results(DNode node, NodeOperation &operation);
+
   /* Map each input of the node operation to the result of the output linked to it. Unlinked inputs
    * are mapped to the result of a newly created Input Single Value Operation, which is added to
    * the operations stream and evaluated. Since this method might add operations to the operations
@@ -125,8 +173,8 @@ class Evaluator {
 
   /* Compile the pixel compile unit into a pixel operation, map each input of the operation to
    * the result of the output linked to it, update the compile state, add the newly created
-   * operation to the operations stream, evaluate the operation, and finally reset the pixel
-   * compile unit. */
+   * operation to the operations stream, add the operation to the task pool to be evaluated, and
+   * finally reset the pixel compile unit. */
   void evaluate_pixel_compile_unit(CompileState &compile_state);
 
   /* Map each input of the pixel operation to the result of the output linked to it. This might
@@ -134,10 +182,11 @@ class Evaluator {
   void map_pixel_operation_inputs_to_their_results(PixelOperation *operation,
                                                    CompileState &compile_state);
 
-  /* Cancels the evaluation by informing the static cache manager of the cancellation and freeing
-   * the results of the operations that were already evaluated, that's because later operations
-   * that use the already allocated results will not be evaluated, so they consequently will not
-   * release the results that they use and we need to free them manually. */
+  /* Cancels the evaluation by waiting for the operations undergoing evaluation, informing the
+   * static cache manager of the cancellation, and freeing the results of the operations that were
+   * already evaluated, that's because later operations that use the already allocated results will
+   * not be evaluated, so they consequently will not release the results that they use and we need
+   * to free them manually. */
   void cancel_evaluation();
 };
 
@@ -6,8 +6,13 @@
 
 #include <memory>
 
+#include "BLI_bounds_types.hh"
+#include "BLI_generic_array.hh"
+#include "BLI_index_range.hh"
 #include "BLI_map.hh"
+#include "BLI_math_vector_types.hh"
 #include "BLI_set.hh"
+#include "BLI_span.hh"
 #include "BLI_vector.hh"
 
 #include "FN_multi_function_procedure.hh"
@@ -72,6 +77,19 @@ class MultiFunctionProcedureOperation : public PixelOperation {
    * multi-functions and creating any necessary inputs or outputs to the operation/procedure. */
   void build_procedure();
 
+  /* Returns true if any of the inputs or outputs of the operation is an image stored using half
+   * precision on the CPU, see Result::is_half_cpu_data. Assumes the outputs are allocated. */
+  bool has_half_cpu_data_parameters();
+
+  /* Calls the multi-function procedure executor on the pixels of the given bounds of a domain of
+   * the given size, row by row and in chunks. Images stored using half precision are converted to
+   * and from temporary full precision buffers. Assumes the outputs are allocated. */
+  void execute_region(int2 size, const Bounds<int2> &bounds);
+
+  /* Calls the multi-function procedure executor on the given chunk of pixels, using the given
+   * buffers, indexed by the parameter index, for the parameters stored using half precision. */
+  void execute_chunk(IndexRange chunk, MutableSpan<GArray<>> buffers);
+
   /* Get the variables corresponding to the inputs of the given node. The variables can be those
    * that were returned by a previous call to a multi-function, those that were generated as
    * constants for unlinked inputs, or those that were added as inputs to the operation/procedure
@@ -0,0 +1,46 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include "BLI_map.hh"
+
+#include "NOD_derived_node_tree.hh"
+
+#include "COM_cached_node_result.hh"
+#include "COM_context.hh"
+#include "COM_region_of_interest.hh"
+#include "COM_scheduler.hh"
+
+namespace blender::compositor {
+
+using namespace nodes::derived_node_tree_types;
+
+/* ------------------------------------------------------------------------------------------------
+ * Node Hash
+ *
+ * The hash of a node identifies its results across evaluations, such that if the hash of a node
+ * didn't change since a previous evaluation, its results didn't change either and can be retrieved
+ * from the CachedNodeResultContainer instead of being recomputed. The hash is computed from the
+ * type and parameters of the node, the values of its unlinked inputs, the hashes of the nodes
+ * linked to its inputs, its region of interest, and the parameters of the context that all nodes
+ * might depend on, like the frame number and the precision.
+ *
+ * The hash is computed from the contents of the node tree as opposed to update tags or counters,
+ * since the compositor typically evaluates a temporary localized copy of the node tree. Nodes
+ * whose results depend on data outside of the node tree that can't be hashed, like render passes,
+ * masks, and movie clips, are said to be volatile and have no hash, and neither do all the nodes
+ * that depend on them, so their results are never cached. Images are the exception, since their
+ * update counts tell if their data changed. */
+
+/* A mapping between nodes and their hashes. Volatile nodes are not part of the map. */
+using NodeHashes = Map<DNode, NodeHash>;
+
+/* Computes the hashes of the nodes in the given schedule. See the discussion above for more
+ * information. */
+NodeHashes compute_node_hashes(const Context &context,
+                               const Schedule &schedule,
+                               const RegionsOfInterest &regions_of_interest);
+
+}  // namespace blender::compositor
@@ -5,9 +5,12 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 
+#include "BLI_bounds_types.hh"
 #include "BLI_map.hh"
+#include "BLI_math_vector_types.hh"
 #include "BLI_string_ref.hh"
 #include "BLI_vector.hh"
 
@@ -82,6 +85,9 @@ class Operation {
   /* True if the input processors were already added and can be evaluated directly. False if the
    * input processors are not yet added and needs to be added. */
   bool input_processors_added_ = false;
+  /* The region of the virtual compositing space in which the results of the operation are needed,
+   * or nullopt if they are needed in full. See COM_region_of_interest.hh for more information. */
+  std::optional<Bounds<float2>> region_of_interest_;
 
  public:
   Operation(Context &context);
@@ -98,11 +104,22 @@ class Operation {
   /* Get a reference to the output result identified by the given identifier. */
   Result &get_result(StringRef identifier);
 
+  /* Get the results of all outputs of the operation. */
+  Vector<Result *> get_results();
+
+  /* Get the results mapped to the inputs of the operation. See results_mapped_to_inputs_ for more
+   * details. */
+  Vector<Result *> get_results_mapped_to_inputs() const;
+
   /* Map the input identified by the given identifier to the result providing its data. See
    * results_mapped_to_inputs_ for more details. This should be called by the evaluator to
    * establish links between different operations. */
   void map_input_to_result(StringRef identifier, Result *result);
 
+  /* Set the region of interest of the operation. This should be called by the evaluator before
+   * evaluating the operation. See region_of_interest_ for more information. */
+  void set_region_of_interest(const std::optional<Bounds<float2>> &region);
+
   /* Free the results of the operation. Note that normally, operation results aren't freed by the
    * operation itself, but by the operations that consume those results, see the release_inputs
    * method. But this is used to force free results in cases like canceled evaluations where later
@@ -138,6 +155,18 @@ class Operation {
    * implementation and should be implemented by operations which can have previews. */
   virtual void compute_preview();
 
+  /* Returns the bounds of the pixels of the given domain that intersect the region of interest of
+   * the operation. Pixels outside of those bounds need not be computed, since they are not used by
+   * the outputs of the compositor. The bounds cover the entire domain if the results are needed in
+   * full or if the domain is rotated or scaled. The bounds might be empty. */
+  Bounds<int2> compute_region_of_interest_bounds(const Domain &domain) const;
+
+  /* Zeros the pixels of the given allocated CPU result that are outside of the given bounds, which
+   * are typically computed using compute_region_of_interest_bounds. Operations that only compute
+   * their region of interest should call this, such that their results never contain
+   * uninitialized pixels. */
+  static void clear_outside_bounds(Result &result, const Bounds<int2> &bounds);
+
   /* Get a reference to the result connected to the input identified by the given identifier. */
   Result &get_input(StringRef identifier) const;
 
@@ -0,0 +1,115 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "BLI_map.hh"
+#include "BLI_vector.hh"
+
+#include "COM_context.hh"
+#include "COM_operation.hh"
+#include "COM_result.hh"
+
+struct TaskPool;
+
+namespace blender::compositor {
+
+/* ------------------------------------------------------------------------------------------------
+ * Operation Task Pool
+ *
+ * A task pool that evaluates operations concurrently on the CPU, where each operation is evaluated
+ * as soon as all the operations that compute the results mapped to its inputs are evaluated. This
+ * allows independent branches of the node tree to be evaluated in parallel, which is important for
+ * operations that can't utilize all threads by themselves, like operations on small images, single
+ * value operations, and reductions.
+ *
+ * Operations are added in an order where the operations that compute the results mapped to their
+ * inputs are added before them, which is the order in which the evaluator compiles them. Results
+ * are released by the operations that use them as soon as they are evaluated, so the buffers
+ * needed at any point of the evaluation are still limited by the reference counts of the results.
+ *
+ * For GPU contexts, operations are evaluated immediately when they are added, since GPU commands
+ * are submitted from the thread that owns the GPU context. The same is true if only a single
+ * thread is available. */
+class OperationTaskPool {
+ private:
+  /* An operation waiting for or undergoing evaluation. */
+  struct Task {
+    /* The function that evaluates the operation. */
+    std::function<void()> evaluate_function;
+    /* The results computed by the operation. */
+    Vector<Result *> results;
+    /* The number of tasks that need to be evaluated before the operation can be evaluated. */
+    int pending_dependencies_count = 0;
+    /* The tasks that depend on the results of the operation. */
+    Vector<Task *> dependents;
+  };
+
+  /* A reference to the compositor context. */
+  Context &context_;
+  /* The task pool in which tasks are evaluated. Null if operations are evaluated immediately. */
+  TaskPool *task_pool_ = nullptr;
+  /* All tasks that were added to the pool. */
+  Vector<std::unique_ptr<Task>> tasks_;
+  /* Maps the results of operations that are not yet evaluated to their tasks. */
+  Map<const Result *, Task *> pending_results_;
+  /* The number of tasks that were evaluated so far, including skipped tasks. */
+  int64_t evaluated_tasks_count_ = 0;
+  /* True if some tasks were skipped because the evaluation was canceled. */
+  bool was_canceled_ = false;
+  /* Protects all of the above members except the context and task pool, since tasks are finished
+   * from different threads. */
+  std::mutex mutex_;
+  /* Notified every time a task is evaluated. */
+  std::condition_variable task_evaluated_condition_;
+
+ public:
+  OperationTaskPool(Context &context);
+
+  /* Waits for all tasks to be evaluated before freeing the pool. */
+  ~OperationTaskPool();
+
+  /* Evaluates the given operation by calling the given function once all operations that compute
+   * the results mapped to its inputs are evaluated. The inputs of the operation should be mapped
+   * before calling this method. Results that are not computed by operations in the pool, like the
+   * results of Input Single Value Operations, are assumed to be already computed. */
+  void add(Operation &operation, std::function<void()> evaluate_function);
+
+  /* Returns true if the given result is not computed by an operation that is waiting for or
+   * undergoing evaluation. */
+  bool is_evaluated(const Result &result);
+
+  /* Returns the number of tasks that were evaluated so far, to be passed to the
+   * wait_for_evaluated_tasks method. */
+  int64_t evaluated_tasks_count();
+
+  /* Blocks until more tasks are evaluated than the given count or until no tasks are pending. */
+  void wait_for_evaluated_tasks(int64_t count);
+
+  /* Blocks until all tasks are evaluated. */
+  void wait();
+
+  /* Returns true if some operations were not evaluated because the evaluation was canceled. This
+   * should be called after waiting for all tasks. */
+  bool was_canceled();
+
+ private:
+  /* The run function of the tasks in the task pool. */
+  static void run(TaskPool *__restrict pool, void *task_data);
+
+  /* Evaluates the given task if the evaluation was not canceled, then pushes the tasks that depend
+   * on it and became ready. */
+  void evaluate_task(Task &task);
+
+  /* Pushes the given task to the task pool. */
+  void push_task(Task &task);
+};
+
+}  // namespace blender::compositor
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <mutex>
+
 #include "BLI_map.hh"
 #include "BLI_timeit.hh"
 
@@ -25,6 +27,8 @@ class Profiler {
    * together with other pixel-wise operations in a single operation, so we can't measure the
    * evaluation time of each individual node. */
   Map<bNodeInstanceKey, timeit::Nanoseconds> nodes_evaluation_times_;
+  /* Nodes might be evaluated concurrently, so setting their evaluation times locks this mutex. */
+  std::mutex mutex_;
 
  public:
   /* Returns a reference to the nodes evaluation times. */
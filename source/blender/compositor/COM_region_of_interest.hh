@@ -0,0 +1,107 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <optional>
+
+#include "BLI_bounds_types.hh"
+#include "BLI_map.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_string_ref.hh"
+
+#include "DNA_node_types.h"
+
+#include "NOD_derived_node_tree.hh"
+
+#include "COM_context.hh"
+#include "COM_scheduler.hh"
+
+namespace blender::compositor {
+
+using namespace nodes::derived_node_tree_types;
+
+/* ------------------------------------------------------------------------------------------------
+ * Region Of Interest
+ *
+ * The region of interest of a node is the area of the virtual compositing space, see the
+ * discussion in COM_domain.hh, in which the results of the node are actually needed by the
+ * outputs of the compositor. For instance, a border render only needs the area inside the border
+ * from the Composite node, and the nodes linked to it only need the same area, unless they blur or
+ * distort their inputs, in which case, they need a bigger area or all of their inputs.
+ *
+ * The regions are computed before evaluation by going backwards over the schedule starting from
+ * the output nodes. Pixel nodes need the same region from their inputs as the one needed from
+ * their outputs, nodes that implement the get_compositor_input_region_of_interest callback of
+ * bNodeType compute the regions needed from their inputs themselves, and all other nodes need
+ * their inputs in full. Operations are then free to only compute the pixels of their results that
+ * intersect their region of interest, see Operation::compute_region_of_interest_bounds. Pixels
+ * outside of the region are cleared to zero, see Operation::clear_outside_bounds.
+ *
+ * When the compositing region is evaluated in tiles, see Context::get_output_tile, the regions of
+ * the Composite and File Output nodes are limited to the current tile. So nodes that blur their
+ * inputs compute a halo around the tile through their callbacks, while nodes that need their
+ * inputs in full are still computed in full for every tile.
+ *
+ * Since the domains of the results are only known during evaluation, regions are propagated in
+ * the virtual compositing space assuming the pixels of the domains have a unit size, and domains
+ * that are rotated or scaled are always computed in full. */
+
+/* A mapping between nodes and the region of interest of their results. Nodes whose results are
+ * needed in full are not part of the map. */
+using RegionsOfInterest = Map<DNode, Bounds<float2>>;
+
+/* The number of pixels by which the regions needed from inputs are enlarged to account for the
+ * interpolation that happens when inputs are realized on the domain of the operation. */
+constexpr float realization_region_margin = 2.0f;
+
+/* Computes the regions of interest of the nodes in the given schedule. See the discussion above
+ * for more information. Returns an empty map if the context is not evaluated on the CPU, since
+ * only CPU operations restrict their computations to their regions of interest. */
+RegionsOfInterest compute_regions_of_interest(const Context &context, const Schedule &schedule);
+
+/* Returns true if all nodes in the given schedule have a region of interest, that is, no node is
+ * needed in full. When evaluating in tiles, see Context::get_output_tile, nodes that are needed in
+ * full are evaluated in full for every tile, so tiled evaluation is only efficient if this is
+ * true. */
+bool all_nodes_have_region_of_interest(const Context &context, const Schedule &schedule);
+
+/* ------------------------------------------------------------------------------------------------
+ * Region Of Interest Parameters
+ *
+ * The parameters passed to the get_compositor_input_region_of_interest callback of bNodeType. The
+ * regions of all inputs are initialized to the region needed from the outputs of the node,
+ * enlarged by the realization margin, so the callback only needs to set the regions of inputs
+ * that are needed in a different area. */
+class RegionOfInterestParams {
+ private:
+  DNode node_;
+  Bounds<float2> output_region_;
+  /* A mapping between the identifiers of the inputs of the node and the regions needed from them,
+   * where nullopt means the input is needed in full. */
+  Map<StringRef, std::optional<Bounds<float2>>> &input_regions_;
+
+ public:
+  RegionOfInterestParams(DNode node,
+                         const Bounds<float2> &output_region,
+                         Map<StringRef, std::optional<Bounds<float2>>> &input_regions);
+
+  /* Returns a reference to the node whose input regions are computed. */
+  const bNode &node() const;
+
+  /* Returns the region of the virtual compositing space that is needed from the outputs of the
+   * node. */
+  const Bounds<float2> &output_region() const;
+
+  /* Set the region needed from the input identified by the given identifier. */
+  void set_input_region(StringRef identifier, const Bounds<float2> &region);
+
+  /* Declare that the input identified by the given identifier is needed in full. */
+  void set_input_needed_in_full(StringRef identifier);
+
+  /* Declare that all inputs of the node are needed in full. */
+  void set_all_inputs_needed_in_full();
+};
+
+}  // namespace blender::compositor
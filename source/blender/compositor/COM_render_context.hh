@@ -5,13 +5,17 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 
+#include "BLI_index_range.hh"
 #include "BLI_map.hh"
 #include "BLI_math_vector_types.hh"
 
 #include "DNA_scene_types.h"
 
+struct RenderPass;
 struct RenderResult;
 
 namespace blender::compositor {
@@ -37,29 +41,52 @@ namespace blender::compositor {
  *
  * Color management will be applied on the images if save_as_render_ is true.
  *
- * Meta data can be added using the add_meta_data function. */
+ * Meta data can be added using the add_meta_data function.
+ *
+ * If the compositor is evaluated in tiles, see Context::get_output_tile, the rows of each tile are
+ * added using the add_view_rows and add_pass_rows methods instead. For file outputs that are
+ * written progressively, only the rows of the current tile are stored and the write_added_rows
+ * method should be called after all passes of the tile were added to write them to the file as
+ * tiles of a tiled EXR image. Otherwise, the rows are accumulated until the file is saved. */
 class FileOutput {
+ public:
+  /* The size of the tiles of progressively written EXR images. Tiles of the compositor need to be
+   * aligned to this size starting from the upper edge of the image, since EXR images are stored
+   * from top to bottom. */
+  static constexpr int exr_tile_size = 64;
+
  private:
   std::string path_;
   ImageFormatData format_;
   RenderResult *render_result_;
   bool save_as_render_;
   Map<std::string, std::string> meta_data_;
+  /* See the write_progressively argument of the constructor. */
+  bool write_progressively_;
+  /* The handle of the EXR image that is being written progressively. Null if writing did not
+   * start yet. */
+  void *exr_handle_ = nullptr;
+  /* True if the EXR image that is being written progressively failed to be opened. */
+  bool has_write_failed_ = false;
+  /* The rows that were added since they were last written for progressively written images. */
+  std::optional<IndexRange> added_rows_;
 
  public:
   /* Allocate and initialize the internal render result of the file output using the give
-   * parameters. See the implementation for more information. */
+   * parameters. See the implementation for more information. If write_progressively is true, the
+   * file is written tile by tile as described above. */
   FileOutput(const std::string &path,
              const ImageFormatData &format,
              int2 size,
-             bool save_as_render);
+             bool save_as_render,
+             bool write_progressively = false);
 
-  /* Free the internal render result. */
+  /* Free the internal render result and close the progressively written image if any. */
   ~FileOutput();
 
   /* Add an empty view with the given name. An empty view is just structure and does not hold any
    * data aside from the view name. This should be called for each view referenced by passes. This
-   * should only be called for EXR images. */
+   * should only be called for EXR images. Does nothing if the view already exists. */
   void add_view(const char *view_name);
 
   /* Add a view of the given name that stores the given pixel buffer composed of the given number
@@ -73,12 +100,46 @@ class FileOutput {
    * add_view method. */
   void add_pass(const char *pass_name, const char *view_name, const char *channels, float *buffer);
 
+  /* Add the given rows of a view of the given name composed of the given number of channels,
+   * adding the view if it doesn't exist. The buffer stores the pixels of the rows only and is
+   * not owned by the file output. Rows that are never added remain zero. */
+  void add_view_rows(const char *view_name, int channels, IndexRange rows, const float *buffer);
+
+  /* Add the given rows of a pass of the given name in the given view, adding the pass if it
+   * doesn't exist. See the add_pass and add_view_rows methods for more information. */
+  void add_pass_rows(const char *pass_name,
+                     const char *view_name,
+                     const char *channels,
+                     IndexRange rows,
+                     const float *buffer);
+
+  /* Write the rows that were last added using the add_pass_rows method to the file if any,
+   * starting to write the file if this is the first call. This only does something for
+   * progressively written file outputs, which can only be multi-layer EXR images with a single
+   * view, and the rows should be aligned to the exr_tile_size as described above. */
+  void write_added_rows(Scene *scene);
+
   /* Add meta data that will eventually be saved to the file if the format supports it. */
   void add_meta_data(std::string key, std::string value);
 
   /* Save the file to the path along with its meta data, reporting any reports to the standard
-   * output. */
+   * output. For progressively written file outputs, this just finishes writing the file. */
   void save(Scene *scene);
+
+ private:
+  /* Returns the pass of the given name in the given view, or nullptr if it doesn't exist. */
+  RenderPass *find_pass(const char *pass_name, const char *view_name);
+
+  /* Add a pass like the add_pass method, but whose buffer has the given height, which is smaller
+   * than the height of the image for progressively written file outputs. */
+  RenderPass *add_pass_buffer(const char *pass_name,
+                              const char *view_name,
+                              const char *channels,
+                              float *buffer,
+                              int height);
+
+  /* Starts writing the progressively written EXR image, returning false if it failed. */
+  bool begin_progressive_write(Scene *scene);
 };
 
 /* ------------------------------------------------------------------------------------------------
@@ -95,6 +156,8 @@ class RenderContext {
    * get_file_output method and saved in the save_file_outputs method. See those methods for more
    * information. */
   Map<std::string, std::unique_ptr<FileOutput>> file_outputs_;
+  /* Protects the file outputs map, since File Output nodes might be evaluated concurrently. */
+  std::mutex file_outputs_mutex_;
 
  public:
   /* Check if there is an available file output with the given path in the context, if one exists,
@@ -111,7 +174,13 @@ class RenderContext {
   FileOutput &get_file_output(std::string path,
                               ImageFormatData format,
                               int2 size,
-                              bool save_as_render);
+                              bool save_as_render,
+                              bool write_progressively = false);
+
+  /* Write the rows that were added to the progressively written file outputs in the context. The
+   * render pipeline code should call this method after each tile was evaluated, see the
+   * FileOutput::write_added_rows method for more information. */
+  void write_file_outputs_rows(Scene *scene);
 
   /* Write the file outputs that were added to the context. The render pipeline code should call
    * this method after all views were evaluated to write the file outputs. See the get_file_output
@@ -13,6 +13,8 @@
 #include "BLI_cpp_type.hh"
 #include "BLI_generic_pointer.hh"
 #include "BLI_generic_span.hh"
+#include "BLI_index_range.hh"
+#include "BLI_math_half.hh"
 #include "BLI_math_interp.hh"
 #include "BLI_math_matrix_types.hh"
 #include "BLI_math_vector.h"
@@ -44,7 +46,8 @@ enum class ResultType : uint8_t {
   Bool,
 };
 
-/* The precision of the data. CPU data is always stored using full precision at the moment. */
+/* The precision of the data. On the CPU, only images of float types can be stored using half
+ * precision, and only if the context uses half precision, see Result::use_half_cpu_storage. */
 enum class ResultPrecision : uint8_t {
   Full,
   Half,
@@ -99,8 +102,8 @@ class Result {
   Context *context_ = nullptr;
   /* The base type of the result's image or single value. */
   ResultType type_ = ResultType::Float;
-  /* The precision of the result's data. Only relevant for GPU textures. CPU buffers and single
-   * values are always stored using full precision. */
+  /* The precision of the result's data. For CPU storage, this is only relevant for images of float
+   * types, single values and other types are always stored using full precision. */
   ResultPrecision precision_ = ResultPrecision::Half;
   /* If true, the result is a single value, otherwise, the result is an image. */
   bool is_single_value_ = false;
@@ -142,6 +145,14 @@ class Result {
    * context and should be released back into the pool instead of being freed. For CPU storage,
    * this is irrelevant. */
   bool is_from_pool_ = false;
+  /* If true, the result is an image stored on the CPU using half precision. In that case, the
+   * cpu_data_ member is a span of uint16_t half floats that stores the channels of all pixels
+   * consecutively. See the is_half_cpu_data method for more information. */
+  bool is_half_cpu_data_ = false;
+  /* If true, the CPU data of the result is stored in scratch memory that is mapped from a
+   * temporary file as opposed to the system memory, see COM_scratch_memory.hh. This is the case
+   * for large images if the context sets a scratch memory threshold. */
+  bool is_scratch_cpu_data_ = false;
   /* Stores resources that are derived from this result. Lazily allocated if needed. See the class
    * description for more information. */
   DerivedResources *derived_resources_ = nullptr;
@@ -261,7 +272,9 @@ class Result {
    * is assumed to have a lifetime that covers the evaluation of the compositor. */
   void wrap_external(GPUTexture *texture);
 
-  /* Identical to GPU variant of wrap_external but wraps a CPU buffer instead. */
+  /* Identical to GPU variant of wrap_external but wraps a CPU buffer instead. The buffer is
+   * expected to store values of the CPP type of the result, so the precision of the result is set
+   * to full precision. */
   void wrap_external(void *data, int2 size);
 
   /* Identical to GPU variant of wrap_external but wraps whatever the given result has instead. */
@@ -323,6 +336,10 @@ class Result {
   /* Returns true if the result is allocated. */
   bool is_allocated() const;
 
+  /* Returns true if the result wraps external data that it does not own. See the wrap_external
+   * method. */
+  bool is_external() const;
+
   /* Returns the reference count of the result. */
   int reference_count() const;
 
@@ -334,9 +351,30 @@ class Result {
 
   GPUTexture *gpu_texture() const;
 
+  /* Returns the CPU data of the result. For results with half precision CPU data, this is a span
+   * of uint16_t half floats and not of the CPP type of the result, see is_half_cpu_data. Prefer
+   * the pixel access methods, or read_cpu_data and write_cpu_data for bulk access, which work for
+   * both precisions. */
   GSpan cpu_data() const;
   GMutableSpan cpu_data();
 
+  /* Returns true if the result is an image whose CPU data is stored using half precision. This is
+   * the case for images of float types that were allocated on the CPU with half precision, which
+   * halves their memory usage and bandwidth at the cost of precision. */
+  bool is_half_cpu_data() const;
+
+  /* Copies the given range of pixels of the CPU data to the given span, which should have the CPP
+   * type of the result and the size of the range, converting from half precision if needed. */
+  void read_cpu_data(IndexRange pixels, GMutableSpan r_data) const;
+
+  /* Copies the given span, which should have the CPP type of the result and the size of the range,
+   * to the given range of pixels of the CPU data, converting to half precision if needed. */
+  void write_cpu_data(IndexRange pixels, GSpan data);
+
+  /* Returns a newly allocated full precision copy of the CPU data of the image, converting from
+   * half precision if needed. The buffer should be freed using MEM_freeN. */
+  float *cpu_data_to_float_buffer() const;
+
   /* It is important to call update_single_value_data after adjusting the single value. See that
    * method for more information. */
   GPointer single_value() const;
@@ -431,6 +469,34 @@ class Result {
    * context. See the allocate_texture method for information about the from_pool argument. */
   void allocate_data(int2 size, bool from_pool);
 
+  /* Returns true if the image data of the result should be stored on the CPU using half
+   * precision. Results set half precision on their own in some cases, for instance for images
+   * that were loaded in half precision, but that only picks a smaller texture format on the GPU.
+   * On the CPU, half storage is only used if the compositor is explicitly set to half precision,
+   * so results stay in full precision for the Auto and Full precision settings. */
+  bool use_half_cpu_storage() const;
+
+  /* Allocates CPU data of the given size in bytes and alignment, either in scratch memory or in
+   * the system memory depending on the scratch memory threshold of the context, see
+   * Context::get_scratch_memory_threshold. */
+  void *allocate_cpu_data(int64_t size, int64_t alignment);
+
+  /* Loads the pixel at the given index in the CPU data, converting from half precision if needed.
+   * Assumes the result stores a value of the given template type. */
+  template<typename T> T load_cpu_pixel(int64_t pixel_index) const;
+
+  /* Stores the given value in the pixel at the given index in the CPU data, converting to half
+   * precision if needed. Assumes the result stores a value of the given template type. */
+  template<typename T> void store_cpu_pixel(int64_t pixel_index, const T &pixel_value);
+
+  /* Samples half precision CPU data with the given interpolation and wrap modes. The sample
+   * methods fall back to this because the BLI interpolation functions only support float
+   * buffers. */
+  float4 sample_half_cpu_data(const float2 &coordinates,
+                              Interpolation interpolation,
+                              math::InterpWrapMode wrap_x,
+                              math::InterpWrapMode wrap_y) const;
+
   /* Same as get_pixel_index but can be used when the type of the result is not known at compile
    * time. */
   int64_t get_pixel_index(const int2 &texel) const;
@@ -482,6 +548,58 @@ BLI_INLINE_METHOD GMutableSpan Result::cpu_data()
   return cpu_data_;
 }
 
+BLI_INLINE_METHOD bool Result::is_half_cpu_data() const
+{
+  return is_half_cpu_data_;
+}
+
+/* The CPP types of results that can be stored using half precision on the CPU. */
+template<typename T>
+inline constexpr bool is_half_cpu_data_type_v = std::is_same_v<T, float> ||
+                                                std::is_same_v<T, float2> ||
+                                                std::is_same_v<T, float3> ||
+                                                std::is_same_v<T, float4>;
+
+template<typename T> BLI_INLINE_METHOD T Result::load_cpu_pixel(const int64_t pixel_index) const
+{
+  if constexpr (is_half_cpu_data_type_v<T>) {
+    if (is_half_cpu_data_) {
+      constexpr int channels_count = sizeof(T) / sizeof(float);
+      BLI_assert(channels_count == this->channels_count());
+      const uint16_t *half_pixel = static_cast<const uint16_t *>(cpu_data_.data()) +
+                                   pixel_index * channels_count;
+      T pixel_value;
+      float *pixel_channels = reinterpret_cast<float *>(&pixel_value);
+      for (int i = 0; i < channels_count; i++) {
+        pixel_channels[i] = math::half_to_float(half_pixel[i]);
+      }
+      return pixel_value;
+    }
+  }
+
+  return this->cpu_data().typed<T>()[pixel_index];
+}
+
+template<typename T>
+BLI_INLINE_METHOD void Result::store_cpu_pixel(const int64_t pixel_index, const T &pixel_value)
+{
+  if constexpr (is_half_cpu_data_type_v<T>) {
+    if (is_half_cpu_data_) {
+      constexpr int channels_count = sizeof(T) / sizeof(float);
+      BLI_assert(channels_count == this->channels_count());
+      uint16_t *half_pixel = static_cast<uint16_t *>(cpu_data_.data()) +
+                             pixel_index * channels_count;
+      const float *pixel_channels = reinterpret_cast<const float *>(&pixel_value);
+      for (int i = 0; i < channels_count; i++) {
+        half_pixel[i] = math::float_to_half(pixel_channels[i]);
+      }
+      return;
+    }
+  }
+
+  this->cpu_data().typed<T>()[pixel_index] = pixel_value;
+}
+
 template<typename T> BLI_INLINE_METHOD const T &Result::get_single_value() const
 {
   BLI_assert(this->is_single_value());
@@ -519,7 +637,7 @@ BLI_INLINE_METHOD T Result::load_pixel(const int2 &texel) const
     BLI_assert(!this->is_single_value());
   }
 
-  return this->cpu_data().typed<T>()[this->get_pixel_index(texel)];
+  return this->load_cpu_pixel<T>(this->get_pixel_index(texel));
 }
 
 template<typename T, bool CouldBeSingleValue>
@@ -535,7 +653,7 @@ BLI_INLINE_METHOD T Result::load_pixel_extended(const int2 &texel) const
   }
 
   const int2 clamped_texel = math::clamp(texel, int2(0), domain_.size - int2(1));
-  return this->cpu_data().typed<T>()[this->get_pixel_index(clamped_texel)];
+  return this->load_cpu_pixel<T>(this->get_pixel_index(clamped_texel));
 }
 
 template<typename T, bool CouldBeSingleValue>
@@ -554,7 +672,7 @@ BLI_INLINE_METHOD T Result::load_pixel_fallback(const int2 &texel, const T &fall
     return fallback;
   }
 
-  return this->cpu_data().typed<T>()[this->get_pixel_index(texel)];
+  return this->load_cpu_pixel<T>(this->get_pixel_index(texel));
 }
 
 template<typename T, bool CouldBeSingleValue>
@@ -569,6 +687,12 @@ BLI_INLINE_METHOD float4 Result::load_pixel_generic_type(const int2 &texel) cons
   if (is_single_value_) {
     this->get_cpp_type().copy_assign(this->cpu_data().data(), pixel_value);
   }
+  else if (is_half_cpu_data_) {
+    const int64_t channels_count = this->channels_count();
+    const uint16_t *half_pixel = static_cast<const uint16_t *>(cpu_data_.data()) +
+                                 this->get_pixel_index(texel) * channels_count;
+    math::half_to_float_array(half_pixel, pixel_value, channels_count);
+  }
   else {
     this->get_cpp_type().copy_assign(this->cpu_data()[this->get_pixel_index(texel)], pixel_value);
   }
@@ -578,12 +702,20 @@ BLI_INLINE_METHOD float4 Result::load_pixel_generic_type(const int2 &texel) cons
 template<typename T>
 BLI_INLINE_METHOD void Result::store_pixel(const int2 &texel, const T &pixel_value)
 {
-  this->cpu_data().typed<T>()[this->get_pixel_index(texel)] = pixel_value;
+  this->store_cpu_pixel(this->get_pixel_index(texel), pixel_value);
 }
 
 BLI_INLINE_METHOD void Result::store_pixel_generic_type(const int2 &texel,
                                                         const float4 &pixel_value)
 {
+  if (is_half_cpu_data_) {
+    const int64_t channels_count = this->channels_count();
+    uint16_t *half_pixel = static_cast<uint16_t *>(cpu_data_.data()) +
+                           this->get_pixel_index(texel) * channels_count;
+    math::float_to_half_array(pixel_value, half_pixel, channels_count);
+    return;
+  }
+
   this->get_cpp_type().copy_assign(pixel_value, this->cpu_data()[this->get_pixel_index(texel)]);
 }
 
@@ -595,6 +727,13 @@ BLI_INLINE_METHOD float4 Result::sample_nearest_zero(const float2 &coordinates)
     return pixel_value;
   }
 
+  if (is_half_cpu_data_) {
+    return this->sample_half_cpu_data(coordinates,
+                                      Interpolation::Nearest,
+                                      math::InterpWrapMode::Border,
+                                      math::InterpWrapMode::Border);
+  }
+
   const int2 size = domain_.size;
   const float2 texel_coordinates = coordinates * float2(size);
 
@@ -619,6 +758,14 @@ BLI_INLINE_METHOD float4 Result::sample_nearest_wrap(const float2 &coordinates,
     return pixel_value;
   }
 
+  if (is_half_cpu_data_) {
+    return this->sample_half_cpu_data(
+        coordinates,
+        Interpolation::Nearest,
+        wrap_x ? math::InterpWrapMode::Repeat : math::InterpWrapMode::Border,
+        wrap_y ? math::InterpWrapMode::Repeat : math::InterpWrapMode::Border);
+  }
+
   const int2 size = domain_.size;
   const float2 texel_coordinates = coordinates * float2(size);
 
@@ -646,6 +793,14 @@ BLI_INLINE_METHOD float4 Result::sample_bilinear_wrap(const float2 &coordinates,
     return pixel_value;
   }
 
+  if (is_half_cpu_data_) {
+    return this->sample_half_cpu_data(
+        coordinates,
+        Interpolation::Bilinear,
+        wrap_x ? math::InterpWrapMode::Repeat : math::InterpWrapMode::Border,
+        wrap_y ? math::InterpWrapMode::Repeat : math::InterpWrapMode::Border);
+  }
+
   const int2 size = domain_.size;
   const float2 texel_coordinates = coordinates * float2(size) - 0.5f;
 
@@ -673,6 +828,14 @@ BLI_INLINE_METHOD float4 Result::sample_cubic_wrap(const float2 &coordinates,
     return pixel_value;
   }
 
+  if (is_half_cpu_data_) {
+    return this->sample_half_cpu_data(
+        coordinates,
+        Interpolation::Bicubic,
+        wrap_x ? math::InterpWrapMode::Repeat : math::InterpWrapMode::Border,
+        wrap_y ? math::InterpWrapMode::Repeat : math::InterpWrapMode::Border);
+  }
+
   const int2 size = domain_.size;
   const float2 texel_coordinates = coordinates * float2(size) - 0.5f;
 
@@ -698,6 +861,13 @@ BLI_INLINE_METHOD float4 Result::sample_bilinear_zero(const float2 &coordinates)
     return pixel_value;
   }
 
+  if (is_half_cpu_data_) {
+    return this->sample_half_cpu_data(coordinates,
+                                      Interpolation::Bilinear,
+                                      math::InterpWrapMode::Border,
+                                      math::InterpWrapMode::Border);
+  }
+
   const int2 size = domain_.size;
   const float2 texel_coordinates = (coordinates * float2(size)) - 0.5f;
 
@@ -720,6 +890,13 @@ BLI_INLINE_METHOD float4 Result::sample_nearest_extended(const float2 &coordinat
     return pixel_value;
   }
 
+  if (is_half_cpu_data_) {
+    return this->sample_half_cpu_data(coordinates,
+                                      Interpolation::Nearest,
+                                      math::InterpWrapMode::Extend,
+                                      math::InterpWrapMode::Extend);
+  }
+
   const int2 size = domain_.size;
   const float2 texel_coordinates = coordinates * float2(size);
 
@@ -742,6 +919,13 @@ BLI_INLINE_METHOD float4 Result::sample_bilinear_extended(const float2 &coordina
     return pixel_value;
   }
 
+  if (is_half_cpu_data_) {
+    return this->sample_half_cpu_data(coordinates,
+                                      Interpolation::Bilinear,
+                                      math::InterpWrapMode::Extend,
+                                      math::InterpWrapMode::Extend);
+  }
+
   const int2 size = domain_.size;
   const float2 texel_coordinates = (coordinates * float2(size)) - 0.5f;
 
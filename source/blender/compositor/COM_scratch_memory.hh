@@ -0,0 +1,33 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <cstdint>
+
+namespace blender::compositor {
+
+/* ------------------------------------------------------------------------------------------------
+ * Scratch Memory
+ *
+ * Scratch memory is memory that is mapped from a temporary scratch file as opposed to being
+ * allocated from the system memory. Since the pages of the memory are backed by the file, the
+ * operating system can write them to the file and evict them when the system memory is exhausted,
+ * instead of failing the allocation or exhausting the swap. This is used to store the CPU data of
+ * large results, see Context::get_scratch_memory_threshold, such that images that are larger than
+ * the system memory can still be composited, albeit slower.
+ *
+ * The scratch files are created in the session temporary directory and are deleted as soon as the
+ * memory is freed or the process exits. */
+
+/* Allocates zero initialized scratch memory of the given size in bytes. Returns nullptr if the
+ * scratch file couldn't be created or mapped, in which case, the caller should fallback to
+ * allocating the memory from the system memory. */
+void *allocate_scratch_memory(int64_t size);
+
+/* Frees the given scratch memory of the given size in bytes, which should have been allocated by
+ * the allocate_scratch_memory function. */
+void free_scratch_memory(void *memory, int64_t size);
+
+}  // namespace blender::compositor
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "BLI_bounds_types.hh"
 #include "BLI_index_range.hh"
 #include "BLI_math_vector_types.hh"
 #include "BLI_task.hh"
@@ -88,4 +89,31 @@ template<typename Function> inline void parallel_for(const int2 range, const Fun
   });
 }
 
+/* Executes the given function in parallel over the texels inside the given 2D bounds, see for
+ * instance Operation::compute_region_of_interest_bounds. The given function gets the texel
+ * coordinates of the element of the bounds as an argument. */
+template<typename Function>
+inline void parallel_for(const Bounds<int2> &bounds, const Function &function)
+{
+  const IndexRange y_range = IndexRange::from_begin_end(bounds.min.y, bounds.max.y);
+  const IndexRange x_range = IndexRange::from_begin_end(bounds.min.x, bounds.max.x);
+  threading::parallel_for(y_range, 1, [&](const IndexRange sub_y_range) {
+    for (const int64_t y : sub_y_range) {
+      for (const int64_t x : x_range) {
+        function(int2(x, y));
+      }
+    }
+  });
+}
+
+/* Returns true if the given texel is inside the given 2D bounds, where the lower bound is
+ * inclusive and the upper bound is exclusive. Output nodes use this to clear the pixels outside of
+ * their region of interest, which are not computed by the operations preceding them, see
+ * Operation::compute_region_of_interest_bounds. */
+inline bool is_in_region(const Bounds<int2> &bounds, const int2 &texel)
+{
+  return texel.x >= bounds.min.x && texel.y >= bounds.min.y && texel.x < bounds.max.x &&
+         texel.y < bounds.max.y;
+}
+
 }  // namespace blender::compositor
@@ -2,6 +2,8 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <mutex>
+
 #include "BLI_index_range.hh"
 #include "BLI_math_color.h"
 #include "BLI_math_vector_types.hh"
@@ -121,6 +123,11 @@ static int2 compute_preview_size(int2 size)
 
 void compute_preview(Context &context, const DNode &node, const Result &input_result)
 {
+  /* The previews of all nodes are stored in the same map, which might be reallocated when previews
+   * are added, so previews of nodes that are evaluated concurrently are computed one at a time. */
+  static std::mutex mutex;
+  std::lock_guard lock{mutex};
+
   /* Initialize node tree previews if not already initialized. */
   bNodeTree *root_tree = const_cast<bNodeTree *>(
       &node.context()->derived_tree().root_context().btree());
@@ -6,6 +6,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "BLI_map.hh"
@@ -42,7 +43,9 @@ bool operator==(const CachedImageKey &a, const CachedImageKey &b);
  * Cached Image.
  *
  * A cached resource that computes and caches a result containing the contents of the image with
- * the given image user. */
+ * the given image user. The image is loaded by the ensure_loaded method as opposed to the
+ * constructor, such that the container can create the cached image while locked but load it
+ * after releasing its lock. */
 class CachedImage : public CachedResource {
  public:
   Result result;
@@ -51,13 +54,25 @@ class CachedImage : public CachedResource {
   /* For GPU, the result wraps an external GPU texture that is generated by the IMB module and
    * stored in this member to be freed when the cached resource is deleted. */
   GPUTexture *texture_ = nullptr;
+  /* Locked while loading the image, such that operations that need the same image concurrently
+   * wait for the first one to load it. */
+  std::mutex load_mutex_;
+  /* True if the image was already loaded by the ensure_loaded method. */
+  bool is_loaded_ = false;
 
  public:
-  CachedImage(Context &context, Image *image, ImageUser *image_user, const char *pass_name);
+  CachedImage(Context &context);
 
   ~CachedImage();
 
+  /* Loads the image with the given image user and pass name into the result if it was not loaded
+   * already. Blocks if another thread is currently loading it. */
+  void ensure_loaded(Context &context, Image *image, ImageUser *image_user, const char *pass_name);
+
  private:
+  /* Loads the image into the result, see ensure_loaded. */
+  void load(Context &context, Image *image, ImageUser *image_user, const char *pass_name);
+
   /* Populates the meta data of the image. */
   void populate_meta_data(const RenderResult *render_result, const ImageUser &image_user);
 };
@@ -79,8 +94,18 @@ class CachedImageContainer : CachedResourceContainer {
    * entry. Then, check if there is an available CachedImage cached resource with the given image
    * user and pass_name in the container, if one exists, return it, otherwise, return a newly
    * created one and add it to the container. In both cases, tag the cached resource as needed to
-   * keep it cached for the next evaluation. */
+   * keep it cached for the next evaluation. The image is loaded after the container is unlocked,
+   * so different images can be loaded concurrently. */
   Result get(Context &context, Image *image, const ImageUser *image_user, const char *pass_name);
+
+ private:
+  /* Sets the frame of the given image user to the effective frame of the image, then returns the
+   * cached image with the image user and pass name, adding a cached image that is not yet loaded
+   * if none exists. This is done while the container is locked. */
+  CachedImage &get_cached_image(Context &context,
+                                Image *image,
+                                ImageUser &image_user,
+                                const char *pass_name);
 };
 
 }  // namespace blender::compositor
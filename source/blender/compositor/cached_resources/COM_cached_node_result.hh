@@ -0,0 +1,96 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "BLI_compute_context.hh"
+#include "BLI_map.hh"
+#include "BLI_string_ref.hh"
+
+#include "COM_cached_resource.hh"
+#include "COM_result.hh"
+
+namespace blender::compositor {
+
+class Context;
+
+/* A hash that identifies the results of a node, computed from the node parameters, the values of
+ * its unlinked inputs, and the hashes of the nodes linked to its inputs, see COM_node_hash.hh. A
+ * 128-bit hash is used to make collisions practically impossible. */
+using NodeHash = ComputeContextHash;
+
+/* ------------------------------------------------------------------------------------------------
+ * Cached Node Result Key.
+ */
+class CachedNodeResultKey {
+ public:
+  NodeHash node_hash;
+  std::string output_identifier;
+
+  CachedNodeResultKey(const NodeHash &node_hash, StringRef output_identifier);
+
+  uint64_t hash() const;
+};
+
+bool operator==(const CachedNodeResultKey &a, const CachedNodeResultKey &b);
+
+/* ------------------------------------------------------------------------------------------------
+ * Cached Node Result.
+ *
+ * A cached resource that shares the data of the result of an output of a node, such that it can be
+ * reused in later evaluations if the node and all the nodes it depends on didn't change. */
+class CachedNodeResult : public CachedResource {
+ public:
+  Result result;
+
+ public:
+  CachedNodeResult(Context &context, const Result &source);
+
+  ~CachedNodeResult();
+
+  /* Returns the size of the data of the result in bytes. */
+  int64_t size_in_bytes() const;
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Cached Node Result Container.
+ *
+ * Unlike other containers, the cached results are not tied to operations that request them, but
+ * are added by the evaluator after the evaluation of nodes and retrieved before evaluation to skip
+ * nodes whose results didn't change. The total size of the cached results is limited by the value
+ * of Context::get_node_result_cache_limit. */
+class CachedNodeResultContainer : CachedResourceContainer {
+ private:
+  Map<CachedNodeResultKey, std::unique_ptr<CachedNodeResult>> map_;
+
+  /* The total size in bytes of the data of all cached results in the container. */
+  int64_t size_in_bytes_ = 0;
+
+ public:
+  void reset() override;
+
+  /* Returns true if a result with the given key exists in the container. */
+  bool contains(const CachedNodeResultKey &key) const;
+
+  /* Returns the cached result with the given key and tag it as needed to keep it cached for the
+   * next evaluation. The result is expected to exist, see the contains method. */
+  const Result &get(const CachedNodeResultKey &key);
+
+  /* Adds a cached result that shares the data of the given result with the given key. Results that
+   * wrap external data are not cached since their data might be freed by their owner, and cached
+   * results that were not needed in the current evaluation are deleted to make room for the result
+   * if it doesn't fit in the cache limit, otherwise, the result is not cached. */
+  void add(Context &context, const CachedNodeResultKey &key, const Result &result);
+
+ private:
+  /* Deletes the cached results whose needed flag is false and update the size of the container
+   * accordingly. */
+  void remove_unneeded();
+};
+
+}  // namespace blender::compositor
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <mutex>
+
 namespace blender::compositor {
 
 /* -------------------------------------------------------------------------------------------------
@@ -41,6 +43,11 @@ class CachedResource {
  *
  * See the existing cached resources for reference. */
 class CachedResourceContainer {
+ protected:
+  /* Operations might be evaluated concurrently, so the getter method of the container should lock
+   * this mutex while looking up or creating cached resources. */
+  mutable std::mutex mutex_;
+
  public:
   /* Reset the container by deleting the cached resources that are no longer needed because they
    * weren't used in the last evaluation and prepare the remaining cached resources to track their
@@ -297,6 +297,8 @@ Result &BokehKernelContainer::get(Context &context,
                                   float catadioptric,
                                   float lens_shift)
 {
+  std::lock_guard lock{mutex_};
+
   const BokehKernelKey key(size, sides, rotation, roundness, catadioptric, lens_shift);
 
   auto &bokeh_kernel = *map_.lookup_or_add_cb(key, [&]() {
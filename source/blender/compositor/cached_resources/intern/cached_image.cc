@@ -10,6 +10,7 @@
 #include "BLI_listbase.h"
 #include "BLI_string.h"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
 
 #include "RE_pipeline.h"
 
@@ -252,11 +253,28 @@ static ResultType get_result_type(const RenderResult *render_result,
   return ResultType::Float;
 }
 
-CachedImage::CachedImage(Context &context,
-                         Image *image,
-                         ImageUser *image_user,
-                         const char *pass_name)
-    : result(context)
+CachedImage::CachedImage(Context &context) : result(context) {}
+
+void CachedImage::ensure_loaded(Context &context,
+                                Image *image,
+                                ImageUser *image_user,
+                                const char *pass_name)
+{
+  std::lock_guard lock{load_mutex_};
+  if (is_loaded_) {
+    return;
+  }
+
+  /* Loading is multi-threaded, so isolate it such that this thread doesn't start evaluating other
+   * operations that might need the same image while holding the lock. */
+  threading::isolate_task([&]() { this->load(context, image, image_user, pass_name); });
+  is_loaded_ = true;
+}
+
+void CachedImage::load(Context &context,
+                       Image *image,
+                       ImageUser *image_user,
+                       const char *pass_name)
 {
   /* We can't retrieve the needed image buffer yet, because we still need to assign the pass index
    * to the image user in order to acquire the image buffer corresponding to the given pass name.
@@ -406,11 +424,28 @@ Result CachedImageContainer::get(Context &context,
     return Result(context);
   }
 
-  /* Compute the effective frame number of the image if it was animated. */
   ImageUser image_user_for_frame = *image_user;
-  BKE_image_user_frame_calc(image, &image_user_for_frame, context.get_frame_number());
+  CachedImage &cached_image = this->get_cached_image(
+      context, image, image_user_for_frame, pass_name);
 
-  const CachedImageKey key(image_user_for_frame, pass_name);
+  /* Load the image outside of the container lock, since loading can take a long time and doesn't
+   * need to block operations that use other images. */
+  cached_image.ensure_loaded(context, image, &image_user_for_frame, pass_name);
+  return cached_image.result;
+}
+
+CachedImage &CachedImageContainer::get_cached_image(Context &context,
+                                                    Image *image,
+                                                    ImageUser &image_user,
+                                                    const char *pass_name)
+{
+  std::lock_guard lock{mutex_};
+
+  /* Compute the effective frame number of the image if it was animated. This is done while locked
+   * because it also updates the GPU frame of the image. */
+  BKE_image_user_frame_calc(image, &image_user, context.get_frame_number());
+
+  const CachedImageKey key(image_user, pass_name);
 
   const std::string library_key = image->id.lib ? image->id.lib->id.name : "";
   const std::string id_key = std::string(image->id.name) + library_key;
@@ -423,15 +458,14 @@ Result CachedImageContainer::get(Context &context,
     cached_images_for_id.clear();
   }
 
-  auto &cached_image = *cached_images_for_id.lookup_or_add_cb(key, [&]() {
-    return std::make_unique<CachedImage>(context, image, &image_user_for_frame, pass_name);
-  });
+  auto &cached_image = *cached_images_for_id.lookup_or_add_cb(
+      key, [&]() { return std::make_unique<CachedImage>(context); });
 
   /* Store the current update count to later compare to and check if the image changed. */
   update_counts_.add_overwrite(id_key, image->runtime.update_count);
 
   cached_image.needed = true;
-  return cached_image.result;
+  return cached_image;
 }
 
 }  // namespace blender::compositor
@@ -180,6 +180,8 @@ Result &CachedMaskContainer::get(Context &context,
                                  int motion_blur_samples,
                                  float motion_blur_shutter)
 {
+  std::lock_guard lock{mutex_};
+
   const CachedMaskKey key(
       size, aspect_ratio, use_feather, motion_blur_samples, motion_blur_shutter);
 
@@ -0,0 +1,130 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "BLI_assert.h"
+#include "BLI_hash.hh"
+#include "BLI_string_ref.hh"
+
+#include "COM_cached_node_result.hh"
+#include "COM_context.hh"
+#include "COM_result.hh"
+
+namespace blender::compositor {
+
+/* --------------------------------------------------------------------
+ * Cached Node Result Key.
+ */
+
+CachedNodeResultKey::CachedNodeResultKey(const NodeHash &node_hash, StringRef output_identifier)
+    : node_hash(node_hash), output_identifier(output_identifier)
+{
+}
+
+uint64_t CachedNodeResultKey::hash() const
+{
+  return get_default_hash(node_hash.v1, output_identifier);
+}
+
+bool operator==(const CachedNodeResultKey &a, const CachedNodeResultKey &b)
+{
+  return a.node_hash == b.node_hash && a.output_identifier == b.output_identifier;
+}
+
+/* --------------------------------------------------------------------
+ * Cached Node Result.
+ */
+
+CachedNodeResult::CachedNodeResult(Context &context, const Result &source)
+    : result(context, source.type(), source.precision())
+{
+  this->result.share_data(source);
+}
+
+CachedNodeResult::~CachedNodeResult()
+{
+  this->result.free();
+}
+
+int64_t CachedNodeResult::size_in_bytes() const
+{
+  return this->result.cpu_data().size_in_bytes();
+}
+
+/* --------------------------------------------------------------------
+ * Cached Node Result Container.
+ */
+
+void CachedNodeResultContainer::reset()
+{
+  /* First, delete all cached results that are no longer needed. */
+  this->remove_unneeded();
+
+  /* Second, reset the needed status of the remaining cached results to false to ready them to
+   * track their needed status for the next evaluation. */
+  for (auto &value : map_.values()) {
+    value->needed = false;
+  }
+}
+
+bool CachedNodeResultContainer::contains(const CachedNodeResultKey &key) const
+{
+  std::lock_guard lock{mutex_};
+
+  return map_.contains(key);
+}
+
+const Result &CachedNodeResultContainer::get(const CachedNodeResultKey &key)
+{
+  std::lock_guard lock{mutex_};
+
+  CachedNodeResult &cached_result = *map_.lookup(key);
+  cached_result.needed = true;
+  return cached_result.result;
+}
+
+void CachedNodeResultContainer::add(Context &context,
+                                    const CachedNodeResultKey &key,
+                                    const Result &result)
+{
+  std::lock_guard lock{mutex_};
+
+  /* Node results are only cached on the CPU, see Context::get_node_result_cache_limit. */
+  BLI_assert(!context.use_gpu());
+
+  if (result.is_external() || !result.is_allocated() || map_.contains(key)) {
+    return;
+  }
+
+  const int64_t limit = context.get_node_result_cache_limit();
+  std::unique_ptr<CachedNodeResult> cached_result = std::make_unique<CachedNodeResult>(context,
+                                                                                       result);
+  const int64_t size = cached_result->size_in_bytes();
+  if (size_in_bytes_ + size > limit) {
+    this->remove_unneeded();
+  }
+
+  if (size_in_bytes_ + size > limit) {
+    return;
+  }
+
+  size_in_bytes_ += size;
+  map_.add_new(key, std::move(cached_result));
+}
+
+void CachedNodeResultContainer::remove_unneeded()
+{
+  map_.remove_if([&](auto item) {
+    if (item.value->needed) {
+      return false;
+    }
+    size_in_bytes_ -= item.value->size_in_bytes();
+    return true;
+  });
+}
+
+}  // namespace blender::compositor
@@ -88,6 +88,8 @@ void CachedShaderContainer::reset()
 
 GPUShader *CachedShaderContainer::get(const char *info_name, ResultPrecision precision)
 {
+  std::lock_guard lock{mutex_};
+
   const CachedShaderKey key(info_name, precision);
 
   auto &cached_shader = *map_.lookup_or_add_cb(
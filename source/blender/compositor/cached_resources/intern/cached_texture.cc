@@ -143,6 +143,8 @@ CachedTexture &CachedTextureContainer::get(Context &context,
                                            float3 offset,
                                            float3 scale)
 {
+  std::lock_guard lock{mutex_};
+
   const CachedTextureKey key(size, offset, scale);
 
   const std::string library_key = texture->id.lib ? texture->id.lib->id.name : "";
@@ -315,6 +315,8 @@ void DericheGaussianCoefficientsContainer::reset()
 DericheGaussianCoefficients &DericheGaussianCoefficientsContainer::get(Context &context,
                                                                        float sigma)
 {
+  std::lock_guard lock{mutex_};
+
   const DericheGaussianCoefficientsKey key(sigma);
 
   auto &deriche_gaussian_coefficients = *map_.lookup_or_add_cb(
@@ -150,6 +150,8 @@ static int2 get_movie_clip_size(MovieClip *movie_clip, int frame_number)
 Result &DistortionGridContainer::get(
     Context &context, MovieClip *movie_clip, int2 size, DistortionType type, int frame_number)
 {
+  std::lock_guard lock{mutex_};
+
   const int2 calibration_size = get_movie_clip_size(movie_clip, frame_number);
 
   const DistortionGridKey key(movie_clip->tracking.camera, size, type, calibration_size);
@@ -168,6 +168,8 @@ void FogGlowKernelContainer::reset()
 
 FogGlowKernel &FogGlowKernelContainer::get(int kernel_size, int2 spatial_size)
 {
+  std::lock_guard lock{mutex_};
+
   const FogGlowKernelKey key(kernel_size, spatial_size);
 
   auto &kernel = *map_.lookup_or_add_cb(
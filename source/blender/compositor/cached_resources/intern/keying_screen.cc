@@ -261,6 +261,8 @@ Result &KeyingScreenContainer::get(Context &context,
                                    MovieTrackingObject *movie_tracking_object,
                                    float smoothness)
 {
+  std::lock_guard lock{mutex_};
+
   const KeyingScreenKey key(context.get_frame_number(), smoothness);
 
   /* We concatenate the movie clip ID name with the tracking object name to cache multiple tracking
@@ -169,6 +169,8 @@ void MorphologicalDistanceFeatherWeightsContainer::reset()
 MorphologicalDistanceFeatherWeights &MorphologicalDistanceFeatherWeightsContainer::get(
     Context &context, int type, int radius)
 {
+  std::lock_guard lock{mutex_};
+
   const MorphologicalDistanceFeatherWeightsKey key(type, radius);
 
   auto &weights = *map_.lookup_or_add_cb(key, [&]() {
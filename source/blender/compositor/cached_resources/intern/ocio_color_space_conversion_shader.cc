@@ -543,6 +543,8 @@ OCIOColorSpaceConversionShader &OCIOColorSpaceConversionShaderContainer::get(Con
                                                                              std::string source,
                                                                              std::string target)
 {
+  std::lock_guard lock{mutex_};
+
 #if defined(WITH_OCIO)
   /* Use the config cache ID in the cache key in case the configuration changed at runtime. */
   std::string config_cache_id = OCIO::GetCurrentConfig()->getCacheID();
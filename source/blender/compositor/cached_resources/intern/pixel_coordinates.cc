@@ -93,6 +93,8 @@ void PixelCoordinatesContainer::reset()
 
 Result &PixelCoordinatesContainer::get(Context &context, const int2 &size)
 {
+  std::lock_guard lock{mutex_};
+
   const PixelCoordinatesKey key(size);
 
   auto &pixel_coordinates = *map_.lookup_or_add_cb(
@@ -126,6 +126,8 @@ void SMAAPrecomputedTexturesContainer::reset()
 
 SMAAPrecomputedTextures &SMAAPrecomputedTexturesContainer::get(Context &context)
 {
+  std::lock_guard lock{mutex_};
+
   if (!textures_) {
     textures_ = std::make_unique<SMAAPrecomputedTextures>(context);
   }
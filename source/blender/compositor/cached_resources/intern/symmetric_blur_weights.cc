@@ -133,6 +133,8 @@ void SymmetricBlurWeightsContainer::reset()
 
 Result &SymmetricBlurWeightsContainer::get(Context &context, int type, float2 radius)
 {
+  std::lock_guard lock{mutex_};
+
   const SymmetricBlurWeightsKey key(type, radius);
 
   auto &weights = *map_.lookup_or_add_cb(
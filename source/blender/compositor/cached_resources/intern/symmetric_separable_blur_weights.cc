@@ -112,6 +112,8 @@ void SymmetricSeparableBlurWeightsContainer::reset()
 
 Result &SymmetricSeparableBlurWeightsContainer::get(Context &context, int type, float radius)
 {
+  std::lock_guard lock{mutex_};
+
   const SymmetricSeparableBlurWeightsKey key(type, radius);
 
   auto &weights = *map_.lookup_or_add_cb(key, [&]() {
@@ -100,6 +100,8 @@ void TextureCoordinatesContainer::reset()
 
 Result &TextureCoordinatesContainer::get(Context &context, const int2 &size)
 {
+  std::lock_guard lock{mutex_};
+
   const TextureCoordinatesKey key(size);
 
   auto &texture_coordinates = *map_.lookup_or_add_cb(
@@ -8,6 +8,7 @@
 
 #  include <cstdint>
 #  include <memory>
+#  include <mutex>
 #  include <string>
 
 #  include "BLI_map.hh"
@@ -63,6 +64,8 @@ class DenoisedAuxiliaryPass {
 class DenoisedAuxiliaryPassContainer {
  private:
   Map<DenoisedAuxiliaryPassKey, std::unique_ptr<DenoisedAuxiliaryPass>> map_;
+  /* Operations using the result that owns the container might be evaluated concurrently. */
+  std::mutex mutex_;
 
  public:
   /* Check if there is an available DenoisedAuxiliaryPass derived resource with the given
@@ -81,7 +81,7 @@ DenoisedAuxiliaryPass::DenoisedAuxiliaryPass(Context &context,
     this->denoised_buffer = static_cast<float *>(GPU_texture_read(pass, GPU_DATA_FLOAT, 0));
   }
   else {
-    this->denoised_buffer = static_cast<float *>(MEM_dupallocN(pass.cpu_data().data()));
+    this->denoised_buffer = pass.cpu_data_to_float_buffer();
   }
 
   const int width = pass.domain().size.x;
@@ -128,6 +128,8 @@ DenoisedAuxiliaryPass &DenoisedAuxiliaryPassContainer::get(Context &context,
                                                            const DenoisedAuxiliaryPassType type,
                                                            const oidn::Quality quality)
 {
+  std::lock_guard lock{mutex_};
+
   const DenoisedAuxiliaryPassKey key(type, quality);
 
   return *map_.lookup_or_add_cb(key, [&]() {
@@ -2,7 +2,12 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <cstdint>
+#include <optional>
+
+#include "BLI_bounds_types.hh"
 #include "BLI_math_vector.hh"
+#include "BLI_math_vector_types.hh"
 #include "BLI_rect.h"
 
 #include "DNA_node_types.h"
@@ -52,6 +57,21 @@ bool Context::is_canceled() const
   return this->get_node_tree().runtime->test_break(get_node_tree().runtime->tbh);
 }
 
+int64_t Context::get_node_result_cache_limit() const
+{
+  return 0;
+}
+
+int64_t Context::get_scratch_memory_threshold() const
+{
+  return 0;
+}
+
+std::optional<Bounds<int2>> Context::get_output_tile() const
+{
+  return std::nullopt;
+}
+
 void Context::reset()
 {
   cache_manager_.reset();
@@ -6,8 +6,10 @@
 
 #include "BLI_color.hh"
 #include "BLI_cpp_type.hh"
+#include "BLI_generic_array.hh"
 #include "BLI_generic_span.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 
 #include "GPU_shader.hh"
@@ -147,10 +149,37 @@ static GMutableSpan get_result_data(Result &result)
   return result.cpu_data();
 }
 
+/* Same as get_result_data but for a temporary buffer storing data of the given result type. */
+static GMutableSpan get_buffer_data(const ResultType type, GMutableSpan buffer)
+{
+  if (type == ResultType::Color) {
+    return GMutableSpan(
+        CPPType::get<ColorSceneLinear4f<eAlpha::Premultiplied>>(), buffer.data(), buffer.size());
+  }
+
+  return buffer;
+}
+
 void ConversionOperation::execute_cpu(const Result &input, Result &output)
 {
   const bke::DataTypeConversions &conversions = bke::get_implicit_type_conversions();
-  conversions.convert_to_initialized_n(get_result_data(input), get_result_data(output));
+  if (!input.is_half_cpu_data() && !output.is_half_cpu_data()) {
+    conversions.convert_to_initialized_n(get_result_data(input), get_result_data(output));
+    return;
+  }
+
+  /* Half precision data can't be converted directly, so convert chunks of pixels through
+   * temporary full precision buffers. */
+  const int64_t size = int64_t(input.domain().size.x) * input.domain().size.y;
+  threading::parallel_for(IndexRange(size), 1024, [&](const IndexRange sub_range) {
+    GArray<> input_buffer(input.get_cpp_type(), sub_range.size());
+    GArray<> output_buffer(output.get_cpp_type(), sub_range.size());
+    input.read_cpu_data(sub_range, input_buffer.as_mutable_span());
+    conversions.convert_to_initialized_n(
+        get_buffer_data(input.type(), input_buffer.as_mutable_span()),
+        get_buffer_data(output.type(), output_buffer.as_mutable_span()));
+    output.write_cpu_data(sub_range, output_buffer.as_span());
+  });
 }
 
 }  // namespace blender::compositor
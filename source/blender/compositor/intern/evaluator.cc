@@ -2,7 +2,16 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <optional>
+
+#include "BLI_bounds.hh"
+#include "BLI_bounds_types.hh"
+#include "BLI_index_range.hh"
+#include "BLI_math_vector_types.hh"
 #include "BLI_memory_utils.hh"
+#include "BLI_set.hh"
+#include "BLI_span.hh"
+#include "BLI_vector.hh"
 
 #include "DNA_node_types.h"
 
@@ -13,8 +22,11 @@
 #include "COM_evaluator.hh"
 #include "COM_input_single_value_operation.hh"
 #include "COM_multi_function_procedure_operation.hh"
+#include "COM_node_hash.hh"
 #include "COM_node_operation.hh"
 #include "COM_operation.hh"
+#include "COM_operation_task_pool.hh"
+#include "COM_region_of_interest.hh"
 #include "COM_result.hh"
 #include "COM_scheduler.hh"
 #include "COM_shader_operation.hh"
@@ -30,6 +42,8 @@ void Evaluator::evaluate()
 {
   context_.reset();
 
+  task_pool_ = std::make_unique<OperationTaskPool>(context_);
+
   BLI_SCOPED_DEFER([&]() {
     if (context_.profiler()) {
       context_.profiler()->finalize(context_.get_node_tree());
@@ -48,26 +62,237 @@ void Evaluator::evaluate()
   }
 
   const Schedule schedule = compute_schedule(context_, *derived_node_tree_);
+  regions_of_interest_ = compute_regions_of_interest(context_, schedule);
 
-  CompileState compile_state(schedule);
+  /* Node results are only cached if the context sets a cache limit. */
+  if (context_.get_node_result_cache_limit() > 0) {
+    node_hashes_ = compute_node_hashes(context_, schedule, regions_of_interest_);
+  }
 
-  for (const DNode &node : schedule) {
+  const Schedule pruned_schedule = this->prune_cached_nodes(schedule);
+  CompileState compile_state(pruned_schedule);
+
+  /* The nodes that were not compiled yet, in the order of the schedule, which is the preferred
+   * compilation order since it minimizes the number of buffers needed at any point and groups
+   * pixel nodes together. Nodes are only compiled out of order if the next node in the schedule is
+   * not ready, see the find_next_ready_node method. */
+  Vector<DNode> remaining_nodes(pruned_schedule.as_span());
+  Set<DNode> compiled_nodes;
+
+  while (!remaining_nodes.is_empty()) {
     if (context_.is_canceled()) {
       this->cancel_evaluation();
       return;
     }
 
+    /* Get the count before searching, such that tasks that get evaluated during the search are not
+     * waited for. */
+    const int64_t evaluated_tasks_count = task_pool_->evaluated_tasks_count();
+    const std::optional<int64_t> node_index = this->find_next_ready_node(
+        remaining_nodes, compiled_nodes, compile_state);
+    if (!node_index) {
+      task_pool_->wait_for_evaluated_tasks(evaluated_tasks_count);
+      continue;
+    }
+
+    const DNode node = remaining_nodes[*node_index];
+
     if (compile_state.should_compile_pixel_compile_unit(node)) {
       this->evaluate_pixel_compile_unit(compile_state);
+
+      /* The node might use the results of the compile unit that was just compiled, which are not
+       * evaluated yet, so the node is no longer ready. */
+      if (is_pixel_node(node) && !this->is_node_ready(node, compiled_nodes, compile_state)) {
+        continue;
+      }
     }
 
+    remaining_nodes.remove(*node_index);
+    compiled_nodes.add_new(node);
+
     if (is_pixel_node(node)) {
       compile_state.add_node_to_pixel_compile_unit(node);
     }
+    else if (cached_nodes_.contains(node)) {
+      this->evaluate_cached_node(node, compile_state);
+    }
     else {
       this->evaluate_node(node, compile_state);
     }
   }
+
+  task_pool_->wait();
+  if (task_pool_->was_canceled()) {
+    this->cancel_evaluation();
+  }
+}
+
+std::optional<int64_t> Evaluator::find_next_ready_node(const Span<DNode> remaining_nodes,
+                                                       const Set<DNode> &compiled_nodes,
+                                                       CompileState &compile_state)
+{
+  /* Only skip ahead in the schedule if the pixel compile unit is empty, since compiling a node out
+   * of order might otherwise complete the compile unit before nodes that could have been added to
+   * it are ready. */
+  const int64_t search_size = compile_state.get_pixel_compile_unit().is_empty() ?
+                                  remaining_nodes.size() :
+                                  1;
+  for (const int64_t i : IndexRange(search_size)) {
+    if (this->is_node_ready(remaining_nodes[i], compiled_nodes, compile_state)) {
+      return i;
+    }
+  }
+
+  return std::nullopt;
+}
+
+bool Evaluator::is_node_ready(const DNode &node,
+                              const Set<DNode> &compiled_nodes,
+                              CompileState &compile_state)
+{
+  /* Cached nodes don't use their inputs, which might not even be in the schedule. */
+  if (cached_nodes_.contains(node)) {
+    return true;
+  }
+
+  for (const bNodeSocket *input : node->input_sockets()) {
+    if (!input->is_available()) {
+      continue;
+    }
+
+    const DOutputSocket output = get_output_linked_to_input(DInputSocket(node.context(), input));
+    if (!output) {
+      continue;
+    }
+
+    if (!compiled_nodes.contains(output.node())) {
+      return false;
+    }
+
+    /* Pixel nodes are compiled based on the types and domains of the results they use, so those
+     * results need to be evaluated, unless they are computed by the pixel compile unit itself. */
+    if (!is_pixel_node(node) || compile_state.get_pixel_compile_unit().contains(output.node())) {
+      continue;
+    }
+
+    if (!task_pool_->is_evaluated(compile_state.get_result_from_output_socket(output))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+Schedule Evaluator::prune_cached_nodes(const Schedule &schedule)
+{
+  if (node_hashes_.is_empty()) {
+    return schedule;
+  }
+
+  CachedNodeResultContainer &cached_node_results = context_.cache_manager().cached_node_results;
+  const bool compute_previews = bool(context_.needed_outputs() & OutputTypes::Previews);
+
+  /* Nodes whose results are used by other nodes in the schedule, regardless of whether those nodes
+   * will be evaluated or not. Nodes that are not used by any other node are output nodes. */
+  Set<DNode> used_nodes;
+  /* Nodes whose results are used by nodes that will be evaluated. */
+  Set<DNode> needed_nodes;
+  /* Nodes that will be evaluated or retrieved from the cache. */
+  Set<DNode> kept_nodes;
+
+  /* The schedule is such that nodes are always scheduled after the nodes they depend on, so going
+   * over it in reverse guarantees that all nodes that use a node are visited before it. */
+  const Span<DNode> nodes = schedule.as_span();
+  for (int i = nodes.size() - 1; i >= 0; i--) {
+    const DNode &node = nodes[i];
+    if (used_nodes.contains(node) && !needed_nodes.contains(node)) {
+      continue;
+    }
+
+    kept_nodes.add_new(node);
+
+    const bool is_cached = this->is_node_cached(node, kept_nodes, compute_previews);
+    if (is_cached) {
+      cached_nodes_.add_new(node);
+    }
+
+    for (const bNodeSocket *input : node->input_sockets()) {
+      if (!input->is_available()) {
+        continue;
+      }
+
+      const DOutputSocket output = get_output_linked_to_input(DInputSocket(node.context(), input));
+      if (!output) {
+        continue;
+      }
+
+      used_nodes.add(output.node());
+      if (!is_cached) {
+        needed_nodes.add(output.node());
+      }
+    }
+  }
+
+  /* Tag the results of the cached nodes as needed before evaluation, since cached results that are
+   * not needed might be deleted to make room for new results during evaluation. */
+  for (const DNode &node : cached_nodes_) {
+    for (const bNodeSocket *output : node->output_sockets()) {
+      const CachedNodeResultKey key(node_hashes_.lookup(node), output->identifier);
+      if (output->is_available() && cached_node_results.contains(key)) {
+        cached_node_results.get(key);
+      }
+    }
+  }
+
+  Schedule pruned_schedule;
+  for (const DNode &node : schedule) {
+    if (kept_nodes.contains(node)) {
+      pruned_schedule.add_new(node);
+    }
+  }
+
+  return pruned_schedule;
+}
+
+bool Evaluator::is_node_cached(const DNode &node,
+                               const Set<DNode> &kept_nodes,
+                               const bool compute_previews)
+{
+  /* Pixel nodes are evaluated in compile units and their results are not cached, and nodes with
+   * previews need to be evaluated to compute their previews. */
+  if (is_pixel_node(node) || (compute_previews && is_node_preview_needed(node))) {
+    return false;
+  }
+
+  const NodeHash *node_hash = node_hashes_.lookup_ptr(node);
+  if (!node_hash) {
+    return false;
+  }
+
+  CachedNodeResultContainer &cached_node_results = context_.cache_manager().cached_node_results;
+
+  /* The node is cached if the results of all of its outputs that are used by kept nodes are
+   * cached. Output nodes, which have no used outputs, are never cached. */
+  bool has_used_outputs = false;
+  for (const bNodeSocket *output : node->output_sockets()) {
+    if (!output->is_available()) {
+      continue;
+    }
+
+    const int reference_count = number_of_inputs_linked_to_output_conditioned(
+        DOutputSocket(node.context(), output),
+        [&](DInputSocket input) { return kept_nodes.contains(input.node()); });
+    if (reference_count == 0) {
+      continue;
+    }
+
+    has_used_outputs = true;
+    if (!cached_node_results.contains(CachedNodeResultKey(*node_hash, output->identifier))) {
+      return false;
+    }
+  }
+
+  return has_used_outputs;
 }
 
 bool Evaluator::validate_node_tree()
@@ -100,7 +325,62 @@ void Evaluator::evaluate_node(DNode node, CompileState &compile_state)
 
   operation->compute_results_reference_counts(compile_state.get_schedule());
 
-  operation->evaluate();
+  const Bounds<float2> *region_of_interest = regions_of_interest_.lookup_ptr(node);
+  operation->set_region_of_interest(region_of_interest ? std::optional(*region_of_interest) :
+                                                         std::nullopt);
+
+  task_pool_->add(*operation, [this, node, operation]() {
+    operation->evaluate();
+    this->cache_node_results(node, *operation);
+  });
+}
+
+void Evaluator::evaluate_cached_node(DNode node, CompileState &compile_state)
+{
+  NodeOperation *operation = node->typeinfo->get_compositor_operation(context_, node);
+
+  compile_state.map_node_to_node_operation(node, operation);
+
+  operations_stream_.append(std::unique_ptr<Operation>(operation));
+
+  operation->compute_results_reference_counts(compile_state.get_schedule());
+
+  CachedNodeResultContainer &cached_node_results = context_.cache_manager().cached_node_results;
+  const NodeHash &node_hash = node_hashes_.lookup(node);
+  for (const bNodeSocket *output : node->output_sockets()) {
+    if (!output->is_available()) {
+      continue;
+    }
+
+    Result &result = operation->get_result(output->identifier);
+    if (!result.should_compute()) {
+      continue;
+    }
+
+    const Result &cached_result = cached_node_results.get(
+        CachedNodeResultKey(node_hash, output->identifier));
+    result.set_type(cached_result.type());
+    result.share_data(cached_result);
+  }
+}
+
+void Evaluator::cache_node_results(DNode node, NodeOperation &operation)
+{
+  const NodeHash *node_hash = node_hashes_.lookup_ptr(node);
+  if (!node_hash) {
+    return;
+  }
+
+  CachedNodeResultContainer &cached_node_results = context_.cache_manager().cached_node_results;
+  for (const bNodeSocket *output : node->output_sockets()) {
+    if (!output->is_available()) {
+      continue;
+    }
+
+    cached_node_results.add(context_,
+                            CachedNodeResultKey(*node_hash, output->identifier),
+                            operation.get_result(output->identifier));
+  }
 }
 
 void Evaluator::map_node_operation_inputs_to_their_results(DNode node,
@@ -206,7 +486,20 @@ void Evaluator::evaluate_pixel_compile_unit(CompileState &compile_state)
 
   operation->compute_results_reference_counts(compile_state.get_schedule());
 
-  operation->evaluate();
+  /* The pixel operation computes the results of all nodes in the compile unit, so its region of
+   * interest is the union of their regions. */
+  std::optional<Bounds<float2>> region_of_interest = std::nullopt;
+  for (const int i : compile_unit.index_range()) {
+    const Bounds<float2> *node_region = regions_of_interest_.lookup_ptr(compile_unit[i]);
+    if (!node_region) {
+      region_of_interest = std::nullopt;
+      break;
+    }
+    region_of_interest = i == 0 ? *node_region : bounds::merge(*region_of_interest, *node_region);
+  }
+  operation->set_region_of_interest(region_of_interest);
+
+  task_pool_->add(*operation, [operation]() { operation->evaluate(); });
 
   compile_state.reset_pixel_compile_unit();
 }
@@ -228,6 +521,9 @@ void Evaluator::map_pixel_operation_inputs_to_their_results(PixelOperation *oper
 
 void Evaluator::cancel_evaluation()
 {
+  /* Operations that are undergoing evaluation might still be using the results. */
+  task_pool_->wait();
+
   context_.cache_manager().skip_next_reset();
   for (const std::unique_ptr<Operation> &operation : operations_stream_) {
     operation->free_results();
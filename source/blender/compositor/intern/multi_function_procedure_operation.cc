@@ -5,15 +5,19 @@
 #include <memory>
 #include <string>
 
+#include "BLI_array.hh"
 #include "BLI_assert.h"
+#include "BLI_bounds_types.hh"
 #include "BLI_color.hh"
 #include "BLI_cpp_type.hh"
+#include "BLI_generic_array.hh"
 #include "BLI_generic_span.hh"
 #include "BLI_index_mask.hh"
 #include "BLI_map.hh"
 #include "BLI_math_base.hh"
 #include "BLI_math_vector_types.hh"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
 #include "BLI_vector.hh"
 
 #include "FN_multi_function.hh"
@@ -58,13 +62,41 @@ void MultiFunctionProcedureOperation::execute()
 {
   const Domain domain = compute_domain();
   const int64_t size = int64_t(domain.size.x) * domain.size.y;
+  const bool is_single_value = this->is_single_value_operation();
+
+  /* Allocate the outputs first, since their precision determines how the procedure is called. */
+  for (int i = 0; i < procedure_.params().size(); i++) {
+    if (procedure_.params()[i].type == mf::ParamType::InterfaceType::Output) {
+      Result &output = get_result(parameter_identifiers_[i]);
+      if (is_single_value) {
+        output.allocate_single_value();
+      }
+      else {
+        output.allocate_texture(domain);
+      }
+    }
+  }
+
+  /* Images stored using half precision and images that are only needed in a region are computed
+   * row by row in chunks, otherwise, the procedure is called on the entire domain at once. */
+  if (!is_single_value) {
+    const Bounds<int2> bounds = this->compute_region_of_interest_bounds(domain);
+    if (this->has_half_cpu_data_parameters() || bounds.size() != domain.size) {
+      this->execute_region(domain.size, bounds);
+      for (int i = 0; i < procedure_.params().size(); i++) {
+        if (procedure_.params()[i].type == mf::ParamType::InterfaceType::Output) {
+          clear_outside_bounds(get_result(parameter_identifiers_[i]), bounds);
+        }
+      }
+      return;
+    }
+  }
+
   const IndexMask mask = IndexMask(size);
   mf::ParamsBuilder parameter_builder{*procedure_executor_, &mask};
 
-  const bool is_single_value = this->is_single_value_operation();
-
-  /* For each of the parameters, either add an input or an output depending on its interface type,
-   * allocating the outputs when needed. */
+  /* For each of the parameters, either add an input or an output depending on its interface
+   * type. */
   for (int i = 0; i < procedure_.params().size(); i++) {
     if (procedure_.params()[i].type == mf::ParamType::InterfaceType::Input) {
       const Result &input = get_input(parameter_identifiers_[i]);
@@ -78,12 +110,10 @@ void MultiFunctionProcedureOperation::execute()
     else {
       Result &output = get_result(parameter_identifiers_[i]);
       if (is_single_value) {
-        output.allocate_single_value();
         parameter_builder.add_uninitialized_single_output(
             GMutableSpan(output.get_cpp_type(), output.single_value().get(), 1));
       }
       else {
-        output.allocate_texture(domain);
         parameter_builder.add_uninitialized_single_output(output.cpu_data());
       }
     }
@@ -103,6 +133,102 @@ void MultiFunctionProcedureOperation::execute()
   }
 }
 
+bool MultiFunctionProcedureOperation::has_half_cpu_data_parameters()
+{
+  for (int i = 0; i < procedure_.params().size(); i++) {
+    const Result &result = procedure_.params()[i].type == mf::ParamType::InterfaceType::Input ?
+                               get_input(parameter_identifiers_[i]) :
+                               get_result(parameter_identifiers_[i]);
+    if (result.is_half_cpu_data()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void MultiFunctionProcedureOperation::execute_region(const int2 size, const Bounds<int2> &bounds)
+{
+  /* The procedure is called on chunks of pixels of the rows of the region, converting images
+   * stored using half precision to and from small full precision buffers that stay in cache. */
+  if (bounds.is_empty()) {
+    return;
+  }
+
+  const int64_t chunk_size = 1024;
+  const int2 region_size = bounds.size();
+  const int64_t rows_grain_size = std::max(int64_t(1), chunk_size / region_size.x);
+  const IndexRange rows = IndexRange(bounds.min.y, region_size.y);
+  threading::parallel_for(rows, rows_grain_size, [&](const IndexRange sub_rows) {
+    /* Full precision buffers for the half precision images, indexed by the parameter index. */
+    Array<GArray<>> buffers(procedure_.params().size());
+    for (int i = 0; i < procedure_.params().size(); i++) {
+      const Result &result = procedure_.params()[i].type == mf::ParamType::InterfaceType::Input ?
+                                 get_input(parameter_identifiers_[i]) :
+                                 get_result(parameter_identifiers_[i]);
+      if (result.is_half_cpu_data()) {
+        buffers[i] = GArray<>(result.get_cpp_type(), std::min(chunk_size, int64_t(region_size.x)));
+      }
+    }
+
+    for (const int64_t y : sub_rows) {
+      const IndexRange row = IndexRange(y * size.x + bounds.min.x, region_size.x);
+      for (int64_t chunk_start = row.start(); chunk_start < row.one_after_last();
+           chunk_start += chunk_size)
+      {
+        const IndexRange chunk = IndexRange::from_begin_end(
+            chunk_start, std::min(chunk_start + chunk_size, row.one_after_last()));
+        this->execute_chunk(chunk, buffers);
+      }
+    }
+  });
+}
+
+void MultiFunctionProcedureOperation::execute_chunk(const IndexRange chunk,
+                                                    MutableSpan<GArray<>> buffers)
+{
+  const IndexMask mask = IndexMask(chunk.size());
+  mf::ParamsBuilder parameter_builder{*procedure_executor_, &mask};
+
+  for (int i = 0; i < procedure_.params().size(); i++) {
+    if (procedure_.params()[i].type == mf::ParamType::InterfaceType::Input) {
+      const Result &input = get_input(parameter_identifiers_[i]);
+      if (input.is_single_value()) {
+        parameter_builder.add_readonly_single_input(input.single_value());
+      }
+      else if (input.is_half_cpu_data()) {
+        const GMutableSpan buffer = buffers[i].as_mutable_span().take_front(chunk.size());
+        input.read_cpu_data(chunk, buffer);
+        parameter_builder.add_readonly_single_input(GSpan(buffer));
+      }
+      else {
+        parameter_builder.add_readonly_single_input(input.cpu_data().slice(chunk));
+      }
+    }
+    else {
+      Result &output = get_result(parameter_identifiers_[i]);
+      if (output.is_half_cpu_data()) {
+        parameter_builder.add_uninitialized_single_output(
+            buffers[i].as_mutable_span().take_front(chunk.size()));
+      }
+      else {
+        parameter_builder.add_uninitialized_single_output(output.cpu_data().slice(chunk));
+      }
+    }
+  }
+
+  mf::ContextBuilder context_builder;
+  procedure_executor_->call(mask, parameter_builder, context_builder);
+
+  for (int i = 0; i < procedure_.params().size(); i++) {
+    if (procedure_.params()[i].type == mf::ParamType::InterfaceType::Output) {
+      Result &output = get_result(parameter_identifiers_[i]);
+      if (output.is_half_cpu_data()) {
+        output.write_cpu_data(chunk, buffers[i].as_span().take_front(chunk.size()));
+      }
+    }
+  }
+}
+
 void MultiFunctionProcedureOperation::build_procedure()
 {
   for (DNode node : compile_unit_) {
@@ -0,0 +1,230 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <type_traits>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_bounds_types.hh"
+#include "BLI_map.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_string_ref.hh"
+
+#include "DNA_ID.h"
+#include "DNA_color_types.h"
+#include "DNA_image_types.h"
+#include "DNA_node_types.h"
+
+#include "BKE_image.hh"
+#include "BKE_node.hh"
+
+#include "NOD_derived_node_tree.hh"
+
+#include "COM_cached_node_result.hh"
+#include "COM_context.hh"
+#include "COM_node_hash.hh"
+#include "COM_region_of_interest.hh"
+#include "COM_scheduler.hh"
+#include "COM_utilities.hh"
+
+namespace blender::compositor {
+
+using namespace nodes::derived_node_tree_types;
+
+template<typename T> static void mix_in(NodeHash &hash, const T &value)
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+  hash.mix_in(&value, sizeof(T));
+}
+
+static void mix_in_string(NodeHash &hash, StringRef string)
+{
+  mix_in(hash, string.size());
+  hash.mix_in(string.data(), string.size());
+}
+
+/* Computes a hash of the parameters of the context that all nodes might depend on. */
+static NodeHash compute_context_hash(const Context &context)
+{
+  NodeHash hash;
+  mix_in(hash, context.get_frame_number());
+  mix_in(hash, context.get_time());
+  mix_in(hash, context.get_precision());
+  mix_in(hash, context.get_denoise_quality());
+  mix_in(hash, context.get_compositing_region());
+  mix_in(hash, context.get_render_size());
+  mix_in(hash, context.get_render_percentage());
+  mix_in_string(hash, context.get_view_name());
+  return hash;
+}
+
+static void mix_in_curve_mapping(NodeHash &hash, const CurveMapping &curve_mapping)
+{
+  mix_in(hash, curve_mapping.flag);
+  mix_in(hash, curve_mapping.preset);
+  mix_in(hash, curve_mapping.clipr);
+  mix_in(hash, curve_mapping.black);
+  mix_in(hash, curve_mapping.white);
+  mix_in(hash, curve_mapping.tone);
+  for (const CurveMap &curve_map : curve_mapping.cm) {
+    mix_in(hash, curve_map.totpoint);
+    mix_in(hash, curve_map.ext_in);
+    mix_in(hash, curve_map.ext_out);
+    hash.mix_in(curve_map.curve, sizeof(CurveMapPoint) * curve_map.totpoint);
+  }
+}
+
+/* Mixes in the storage of the node into the given hash. Returns false if the storage can't be
+ * hashed, in which case, the node is volatile. */
+static bool mix_in_storage(NodeHash &hash, const bNode &node)
+{
+  if (!node.storage) {
+    return true;
+  }
+
+  const StringRef storage_name = node.typeinfo->storagename;
+
+  /* The curves of curve mappings are stored in separately allocated arrays. */
+  if (storage_name == "CurveMapping") {
+    mix_in_curve_mapping(hash, *static_cast<const CurveMapping *>(node.storage));
+    return true;
+  }
+
+  /* Non-DNA storage might contain pointers to data that is reallocated when the node tree is
+   * copied, and possibly at the same address, so it can't be hashed. Cryptomatte nodes similarly
+   * store their matte entries in a list. */
+  if (storage_name.is_empty() || storage_name == "NodeCryptomatte") {
+    return false;
+  }
+
+  /* Other DNA storage is flat or only points to persistent data like the scene. */
+  hash.mix_in(node.storage, MEM_allocN_len(node.storage));
+  return true;
+}
+
+/* Mixes in the ID referenced by the node into the given hash. Returns false if the ID can't be
+ * hashed, in which case, the node is volatile. Only images can be hashed, through their update
+ * counts, since the data of other IDs like render results, masks, and movie clips might change
+ * without any change to the node tree. */
+static bool mix_in_id(NodeHash &hash, const bNode &node)
+{
+  if (!node.id) {
+    return true;
+  }
+
+  if (GS(node.id->name) != ID_IM) {
+    return false;
+  }
+
+  Image *image = reinterpret_cast<Image *>(node.id);
+  if (image->source == IMA_SRC_VIEWER || BKE_image_is_dirty(image)) {
+    return false;
+  }
+
+  mix_in_string(hash, node.id->name);
+  mix_in_string(hash, node.id->lib ? node.id->lib->id.name : "");
+  mix_in(hash, image->runtime.update_count);
+  return true;
+}
+
+/* Mixes in the default value of the given unlinked input into the given hash. Returns false if the
+ * value can't be hashed, in which case, the node is volatile. */
+static bool mix_in_input_value(NodeHash &hash, const DInputSocket &input)
+{
+  mix_in(hash, input->type);
+  switch (input->type) {
+    case SOCK_FLOAT:
+      mix_in(hash, input->default_value_typed<bNodeSocketValueFloat>()->value);
+      return true;
+    case SOCK_INT:
+      mix_in(hash, input->default_value_typed<bNodeSocketValueInt>()->value);
+      return true;
+    case SOCK_BOOLEAN:
+      mix_in(hash, input->default_value_typed<bNodeSocketValueBoolean>()->value);
+      return true;
+    case SOCK_VECTOR:
+      mix_in(hash, input->default_value_typed<bNodeSocketValueVector>()->value);
+      return true;
+    case SOCK_RGBA:
+      mix_in(hash, input->default_value_typed<bNodeSocketValueRGBA>()->value);
+      return true;
+    default:
+      return false;
+  }
+}
+
+/* Computes the hash of the given node, see the discussion in COM_node_hash.hh. Returns false if
+ * the node is volatile. */
+static bool compute_node_hash(const DNode &node,
+                              const NodeHashes &node_hashes,
+                              const RegionsOfInterest &regions_of_interest,
+                              NodeHash &hash)
+{
+  mix_in_string(hash, node->idname);
+  mix_in(hash, bool(node->flag & NODE_MUTED));
+  mix_in(hash, node->custom1);
+  mix_in(hash, node->custom2);
+  mix_in(hash, node->custom3);
+  mix_in(hash, node->custom4);
+
+  if (!mix_in_storage(hash, *node) || !mix_in_id(hash, *node)) {
+    return false;
+  }
+
+  for (const bNodeSocket *input : node->input_sockets()) {
+    if (!input->is_available()) {
+      continue;
+    }
+
+    mix_in_string(hash, input->identifier);
+    mix_in(hash, input->type);
+
+    const DSocket origin = get_input_origin_socket(DInputSocket(node.context(), input));
+    if (origin->is_input()) {
+      if (!mix_in_input_value(hash, DInputSocket(origin))) {
+        return false;
+      }
+      continue;
+    }
+
+    /* Nodes that depend on volatile nodes are volatile as well. */
+    const NodeHash *origin_hash = node_hashes.lookup_ptr(origin.node());
+    if (!origin_hash) {
+      return false;
+    }
+    mix_in(hash, *origin_hash);
+    mix_in_string(hash, origin->identifier);
+  }
+
+  /* Results are only computed inside their region of interest, so results computed for different
+   * regions are different. */
+  const Bounds<float2> *region_of_interest = regions_of_interest.lookup_ptr(node);
+  mix_in(hash, region_of_interest != nullptr);
+  if (region_of_interest) {
+    mix_in(hash, *region_of_interest);
+  }
+
+  return true;
+}
+
+NodeHashes compute_node_hashes(const Context &context,
+                               const Schedule &schedule,
+                               const RegionsOfInterest &regions_of_interest)
+{
+  const NodeHash context_hash = compute_context_hash(context);
+
+  /* The schedule is such that nodes are always scheduled after the nodes they depend on, so the
+   * hashes of the nodes linked to the inputs of a node are always computed before the node. */
+  NodeHashes node_hashes;
+  for (const DNode &node : schedule) {
+    NodeHash hash = context_hash;
+    if (compute_node_hash(node, node_hashes, regions_of_interest, hash)) {
+      node_hashes.add_new(node, hash);
+    }
+  }
+
+  return node_hashes;
+}
+
+}  // namespace blender::compositor
@@ -2,11 +2,22 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <cstring>
 #include <limits>
 #include <memory>
+#include <optional>
 
+#include "BLI_bounds_types.hh"
+#include "BLI_generic_span.hh"
+#include "BLI_index_range.hh"
 #include "BLI_map.hh"
+#include "BLI_math_base.hh"
+#include "BLI_math_matrix.hh"
+#include "BLI_math_vector.hh"
+#include "BLI_math_vector_types.hh"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
 
 #include "COM_context.hh"
 #include "COM_conversion_operation.hh"
@@ -41,11 +52,34 @@ Result &Operation::get_result(StringRef identifier)
   return results_.lookup(identifier);
 }
 
+Vector<Result *> Operation::get_results()
+{
+  Vector<Result *> results;
+  for (Result &result : results_.values()) {
+    results.append(&result);
+  }
+  return results;
+}
+
+Vector<Result *> Operation::get_results_mapped_to_inputs() const
+{
+  Vector<Result *> results;
+  for (Result *result : results_mapped_to_inputs_.values()) {
+    results.append(result);
+  }
+  return results;
+}
+
 void Operation::map_input_to_result(StringRef identifier, Result *result)
 {
   results_mapped_to_inputs_.add_new(identifier, result);
 }
 
+void Operation::set_region_of_interest(const std::optional<Bounds<float2>> &region)
+{
+  region_of_interest_ = region;
+}
+
 void Operation::free_results()
 {
   for (Result &result : results_.values()) {
@@ -135,6 +169,56 @@ void Operation::add_and_evaluate_input_processor(StringRef identifier, SimpleOpe
 
 void Operation::compute_preview(){};
 
+Bounds<int2> Operation::compute_region_of_interest_bounds(const Domain &domain) const
+{
+  const Bounds<int2> full_bounds = Bounds<int2>(int2(0), domain.size);
+  if (!region_of_interest_.has_value()) {
+    return full_bounds;
+  }
+
+  /* Regions are propagated assuming pixels of unit size, so rotated or scaled domains are computed
+   * in full. */
+  if (!math::is_equal(float2x2(domain.transformation), float2x2::identity(), 1e-5f)) {
+    return full_bounds;
+  }
+
+  /* The domain is centered around its translation in the virtual compositing space, so transform
+   * the region into the pixel space of the domain, conservatively rounding to whole pixels. */
+  const float2 offset = float2(domain.size) / 2.0f - domain.transformation.location();
+  const int2 lower_bound = int2(math::floor(region_of_interest_->min + offset));
+  const int2 upper_bound = int2(math::ceil(region_of_interest_->max + offset));
+  const int2 min = math::clamp(lower_bound, int2(0), domain.size);
+  const int2 max = math::clamp(upper_bound, min, domain.size);
+  return Bounds<int2>(min, max);
+}
+
+void Operation::clear_outside_bounds(Result &result, const Bounds<int2> &bounds)
+{
+  const int2 size = result.domain().size;
+  if (result.is_single_value() || bounds.size() == size) {
+    return;
+  }
+
+  /* All result types and half floats represent zero as all zero bits, so clear the bytes of the
+   * pixels directly, which works for both full and half precision data. */
+  GMutableSpan data = result.cpu_data();
+  const int64_t pixel_size = data.size() * data.type().size() / (int64_t(size.x) * size.y);
+  uint8_t *buffer = static_cast<uint8_t *>(data.data());
+  const int64_t row_size = size.x * pixel_size;
+
+  threading::parallel_for(IndexRange(size.y), 64, [&](const IndexRange sub_y_range) {
+    for (const int64_t y : sub_y_range) {
+      uint8_t *row = buffer + y * row_size;
+      if (y < bounds.min.y || y >= bounds.max.y) {
+        memset(row, 0, row_size);
+        continue;
+      }
+      memset(row, 0, bounds.min.x * pixel_size);
+      memset(row + bounds.max.x * pixel_size, 0, (size.x - bounds.max.x) * pixel_size);
+    }
+  });
+}
+
 Result &Operation::get_input(StringRef identifier) const
 {
   return *results_mapped_to_inputs_.lookup(identifier);
@@ -0,0 +1,156 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "BLI_task.h"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
+
+#include "COM_context.hh"
+#include "COM_operation.hh"
+#include "COM_operation_task_pool.hh"
+#include "COM_result.hh"
+
+namespace blender::compositor {
+
+OperationTaskPool::OperationTaskPool(Context &context) : context_(context)
+{
+  /* The evaluator blocks while waiting for tasks without doing any work itself, so at least one
+   * other thread is needed for the tasks to make progress. */
+  if (!context.use_gpu() && BLI_task_scheduler_num_threads() > 1) {
+    task_pool_ = BLI_task_pool_create(this, TASK_PRIORITY_HIGH);
+  }
+}
+
+OperationTaskPool::~OperationTaskPool()
+{
+  if (task_pool_) {
+    this->wait();
+    BLI_task_pool_free(task_pool_);
+  }
+}
+
+void OperationTaskPool::add(Operation &operation, std::function<void()> evaluate_function)
+{
+  if (!task_pool_) {
+    evaluate_function();
+    return;
+  }
+
+  std::unique_ptr<Task> task = std::make_unique<Task>();
+  task->evaluate_function = std::move(evaluate_function);
+  task->results = operation.get_results();
+
+  bool is_ready = false;
+  {
+    std::lock_guard lock{mutex_};
+
+    /* A task might be using multiple results of the same dependency, but should only be added to
+     * its dependents once. */
+    for (const Result *input : operation.get_results_mapped_to_inputs()) {
+      Task *dependency = pending_results_.lookup_default(input, nullptr);
+      if (dependency && !dependency->dependents.contains(task.get())) {
+        dependency->dependents.append(task.get());
+        task->pending_dependencies_count++;
+      }
+    }
+
+    for (const Result *result : task->results) {
+      pending_results_.add_new(result, task.get());
+    }
+
+    is_ready = task->pending_dependencies_count == 0;
+    tasks_.append(std::move(task));
+  }
+
+  if (is_ready) {
+    this->push_task(*tasks_.last());
+  }
+}
+
+bool OperationTaskPool::is_evaluated(const Result &result)
+{
+  std::lock_guard lock{mutex_};
+  return !pending_results_.contains(&result);
+}
+
+int64_t OperationTaskPool::evaluated_tasks_count()
+{
+  std::lock_guard lock{mutex_};
+  return evaluated_tasks_count_;
+}
+
+void OperationTaskPool::wait_for_evaluated_tasks(const int64_t count)
+{
+  std::unique_lock lock{mutex_};
+  task_evaluated_condition_.wait(lock, [&]() {
+    return evaluated_tasks_count_ > count || evaluated_tasks_count_ == tasks_.size();
+  });
+}
+
+void OperationTaskPool::wait()
+{
+  if (task_pool_) {
+    BLI_task_pool_work_and_wait(task_pool_);
+  }
+}
+
+bool OperationTaskPool::was_canceled()
+{
+  std::lock_guard lock{mutex_};
+  return was_canceled_;
+}
+
+void OperationTaskPool::run(TaskPool *__restrict pool, void *task_data)
+{
+  OperationTaskPool &self = *static_cast<OperationTaskPool *>(BLI_task_pool_user_data(pool));
+  self.evaluate_task(*static_cast<Task *>(task_data));
+}
+
+void OperationTaskPool::evaluate_task(Task &task)
+{
+  /* Skip the evaluation of the remaining operations if the evaluation was canceled. The evaluator
+   * frees the results of all operations in that case. */
+  const bool is_canceled = context_.is_canceled();
+  if (!is_canceled) {
+    /* Isolate the evaluation such that threads waiting inside the operation, for instance, for a
+     * cached resource, don't start evaluating other operations. */
+    threading::isolate_task([&]() { task.evaluate_function(); });
+  }
+
+  Vector<Task *> ready_tasks;
+  {
+    std::lock_guard lock{mutex_};
+    was_canceled_ |= is_canceled;
+    evaluated_tasks_count_++;
+
+    for (const Result *result : task.results) {
+      pending_results_.remove(result);
+    }
+
+    for (Task *dependent : task.dependents) {
+      dependent->pending_dependencies_count--;
+      if (dependent->pending_dependencies_count == 0) {
+        ready_tasks.append(dependent);
+      }
+    }
+  }
+
+  task_evaluated_condition_.notify_all();
+
+  for (Task *ready_task : ready_tasks) {
+    this->push_task(*ready_task);
+  }
+}
+
+void OperationTaskPool::push_task(Task &task)
+{
+  BLI_task_pool_push(task_pool_, run, &task, false, nullptr);
+}
+
+}  // namespace blender::compositor
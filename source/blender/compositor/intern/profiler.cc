@@ -22,6 +22,7 @@ Map<bNodeInstanceKey, timeit::Nanoseconds> &Profiler::get_nodes_evaluation_times
 void Profiler::set_node_evaluation_time(bNodeInstanceKey node_instance_key,
                                         timeit::Nanoseconds time)
 {
+  std::lock_guard lock{mutex_};
   nodes_evaluation_times_.lookup_or_add(node_instance_key, timeit::Nanoseconds::zero()) += time;
 }
 
@@ -0,0 +1,243 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <optional>
+
+#include "BLI_bounds.hh"
+#include "BLI_bounds_types.hh"
+#include "BLI_map.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_rect.h"
+#include "BLI_string_ref.hh"
+
+#include "DNA_node_types.h"
+#include "DNA_scene_types.h"
+#include "DNA_vec_types.h"
+
+#include "NOD_derived_node_tree.hh"
+
+#include "BKE_node.hh"
+
+#include "COM_context.hh"
+#include "COM_region_of_interest.hh"
+#include "COM_scheduler.hh"
+#include "COM_utilities.hh"
+
+namespace blender::compositor {
+
+using namespace nodes::derived_node_tree_types;
+
+/* Merges the given regions, where nullopt means a region that covers everything. */
+static std::optional<Bounds<float2>> merge_regions(const std::optional<Bounds<float2>> &a,
+                                                   const std::optional<Bounds<float2>> &b)
+{
+  if (!a.has_value() || !b.has_value()) {
+    return std::nullopt;
+  }
+  return bounds::merge(*a, *b);
+}
+
+/* Returns the area of the given frame that is covered by the given border, which is in normalized
+ * coordinates of the frame. Invalid borders cover the entire frame. */
+static Bounds<float2> get_border_region(const Bounds<float2> &frame, const rctf &border)
+{
+  if (BLI_rctf_is_empty(&border)) {
+    return frame;
+  }
+
+  const float2 size = frame.size();
+  return Bounds<float2>(frame.min + float2(border.xmin, border.ymin) * size,
+                        frame.min + float2(border.xmax, border.ymax) * size);
+}
+
+/* Returns the area of the given frame that is covered by the tile of the compositing region that
+ * is currently being evaluated, or the entire frame if the compositing region is not evaluated in
+ * tiles, see Context::get_output_tile. */
+static Bounds<float2> get_tile_region(const Context &context, const Bounds<float2> &frame)
+{
+  const std::optional<Bounds<int2>> tile = context.get_output_tile();
+  if (!tile.has_value()) {
+    return frame;
+  }
+
+  return Bounds<float2>(frame.min + float2(tile->min), frame.min + float2(tile->max));
+}
+
+/* Returns the region needed from the given output node, or nullopt if it is needed in full. The
+ * Composite node has a domain with the size of the compositing region and an identity
+ * transformation, so its region is known before evaluation. Viewer nodes on the other hand have
+ * the domain of their input, which is only known during evaluation, so the viewer border can't be
+ * mapped to the virtual compositing space and their inputs are needed in full, unless they are
+ * treated as composite outputs. */
+static std::optional<Bounds<float2>> get_output_node_region(const Context &context,
+                                                            const DNode &node)
+{
+  const float2 frame_size = float2(context.get_compositing_region_size());
+  const Bounds<float2> frame(-frame_size / 2.0f, frame_size / 2.0f);
+  const Bounds<float2> tile_region = get_tile_region(context, frame);
+
+  const StringRef idname = node->idname;
+  if (idname == "CompositorNodeComposite" ||
+      (idname == "CompositorNodeViewer" && context.treat_viewer_as_composite_output()))
+  {
+    /* Border renders that are not cropped only need the area inside the border. */
+    const RenderData &render_data = context.get_render_data();
+    if (context.render_context() && (render_data.mode & R_BORDER) &&
+        !(render_data.mode & R_CROP))
+    {
+      /* An empty region if the border doesn't intersect the tile. */
+      return bounds::intersect(get_border_region(frame, render_data.border), tile_region)
+          .value_or(Bounds<float2>(tile_region.min));
+    }
+    return tile_region;
+  }
+
+  /* File Output nodes write the tile of their inputs that is currently being evaluated. */
+  if (idname == "CompositorNodeOutputFile" && context.get_output_tile().has_value()) {
+    return tile_region;
+  }
+
+  /* Other File Output nodes and viewers need their inputs in full. */
+  return std::nullopt;
+}
+
+/* Computes the regions needed from the inputs of the given node given the region needed from its
+ * outputs, where nullopt means the input is needed in full. */
+static Map<StringRef, std::optional<Bounds<float2>>> compute_input_regions(
+    const DNode &node, const std::optional<Bounds<float2>> &output_region)
+{
+  Map<StringRef, std::optional<Bounds<float2>>> input_regions;
+
+  const bool propagates_region = is_pixel_node(node) ||
+                                 node->typeinfo->get_compositor_input_region_of_interest;
+  std::optional<Bounds<float2>> default_region = std::nullopt;
+  if (output_region.has_value() && propagates_region) {
+    default_region = *output_region;
+    default_region->pad(float2(realization_region_margin));
+  }
+
+  for (const bNodeSocket *input : node->input_sockets()) {
+    if (input->is_available()) {
+      input_regions.add_new(input->identifier, default_region);
+    }
+  }
+
+  if (output_region.has_value() && node->typeinfo->get_compositor_input_region_of_interest) {
+    RegionOfInterestParams params(node, *output_region, input_regions);
+    node->typeinfo->get_compositor_input_region_of_interest(params);
+  }
+
+  return input_regions;
+}
+
+RegionsOfInterest compute_regions_of_interest(const Context &context, const Schedule &schedule)
+{
+  /* Only CPU operations restrict their computations to their regions of interest. */
+  if (context.use_gpu()) {
+    return RegionsOfInterest();
+  }
+
+  const bool compute_previews = bool(context.needed_outputs() & OutputTypes::Previews);
+
+  /* The regions needed from each node, accumulated from all nodes that use its results. */
+  Map<DNode, std::optional<Bounds<float2>>> needed_regions;
+
+  /* The schedule is such that nodes are always scheduled after the nodes they depend on, so going
+   * over it in reverse guarantees that the regions needed from a node are fully accumulated by the
+   * time it is visited. */
+  const Span<DNode> nodes = schedule.as_span();
+  for (int i = nodes.size() - 1; i >= 0; i--) {
+    const DNode &node = nodes[i];
+
+    /* Nodes whose results are not used by any other node are output nodes. */
+    std::optional<Bounds<float2>> region = needed_regions.contains(node) ?
+                                               needed_regions.lookup(node) :
+                                               get_output_node_region(context, node);
+
+    /* Previews are computed from the entire result. */
+    if (compute_previews && is_node_preview_needed(node)) {
+      region = std::nullopt;
+    }
+
+    needed_regions.add_overwrite(node, region);
+
+    const Map<StringRef, std::optional<Bounds<float2>>> input_regions = compute_input_regions(
+        node, region);
+    for (const bNodeSocket *input : node->input_sockets()) {
+      if (!input->is_available()) {
+        continue;
+      }
+
+      const DOutputSocket output = get_output_linked_to_input(DInputSocket(node.context(), input));
+      if (!output) {
+        continue;
+      }
+
+      const std::optional<Bounds<float2>> input_region = input_regions.lookup(input->identifier);
+      needed_regions.add_or_modify(
+          output.node(),
+          [&](std::optional<Bounds<float2>> *value) {
+            new (value) std::optional<Bounds<float2>>(input_region);
+          },
+          [&](std::optional<Bounds<float2>> *value) {
+            *value = merge_regions(*value, input_region);
+          });
+    }
+  }
+
+  RegionsOfInterest regions_of_interest;
+  for (const auto item : needed_regions.items()) {
+    if (item.value.has_value()) {
+      regions_of_interest.add_new(item.key, *item.value);
+    }
+  }
+
+  return regions_of_interest;
+}
+
+bool all_nodes_have_region_of_interest(const Context &context, const Schedule &schedule)
+{
+  return compute_regions_of_interest(context, schedule).size() == schedule.size();
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Region Of Interest Parameters.
+ */
+
+RegionOfInterestParams::RegionOfInterestParams(
+    DNode node,
+    const Bounds<float2> &output_region,
+    Map<StringRef, std::optional<Bounds<float2>>> &input_regions)
+    : node_(node), output_region_(output_region), input_regions_(input_regions)
+{
+}
+
+const bNode &RegionOfInterestParams::node() const
+{
+  return *node_;
+}
+
+const Bounds<float2> &RegionOfInterestParams::output_region() const
+{
+  return output_region_;
+}
+
+void RegionOfInterestParams::set_input_region(StringRef identifier, const Bounds<float2> &region)
+{
+  input_regions_.lookup(identifier) = region;
+}
+
+void RegionOfInterestParams::set_input_needed_in_full(StringRef identifier)
+{
+  input_regions_.lookup(identifier) = std::nullopt;
+}
+
+void RegionOfInterestParams::set_all_inputs_needed_in_full()
+{
+  for (std::optional<Bounds<float2>> &region : input_regions_.values()) {
+    region = std::nullopt;
+  }
+}
+
+}  // namespace blender::compositor
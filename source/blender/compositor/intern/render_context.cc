@@ -2,10 +2,16 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <cstdio>
+#include <cstring>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 
 #include "BLI_assert.h"
+#include "BLI_fileops.h"
+#include "BLI_index_range.hh"
 #include "BLI_listbase.h"
 #include "BLI_map.hh"
 #include "BLI_math_vector_types.hh"
@@ -14,13 +20,16 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "IMB_colormanagement.hh"
 #include "IMB_imbuf.hh"
 #include "IMB_imbuf_types.hh"
+#include "IMB_openexr.hh"
 
 #include "DNA_scene_types.h"
 #include "DNA_windowmanager_types.h"
 
 #include "BKE_image.hh"
+#include "BKE_image_format.hh"
 #include "BKE_image_save.hh"
 #include "BKE_report.hh"
 
@@ -37,9 +46,17 @@ namespace blender::compositor {
 FileOutput::FileOutput(const std::string &path,
                        const ImageFormatData &format,
                        int2 size,
-                       bool save_as_render)
-    : path_(path), format_(format), save_as_render_(save_as_render)
+                       bool save_as_render,
+                       bool write_progressively)
+    : path_(path),
+      format_(format),
+      save_as_render_(save_as_render),
+      write_progressively_(write_progressively)
 {
+  /* Only multi-layer EXR images can be written progressively for now, since other formats need
+   * the full image to do color format conversions or don't support tiles. */
+  BLI_assert(!write_progressively || format.imtype == R_IMF_IMTYPE_MULTILAYER);
+
   render_result_ = MEM_callocN<RenderResult>("Temporary Render Result For File Output");
 
   render_result_->rectx = size.x;
@@ -60,6 +77,9 @@ FileOutput::FileOutput(const std::string &path,
 
 FileOutput::~FileOutput()
 {
+  if (exr_handle_) {
+    IMB_exr_close(exr_handle_);
+  }
   RE_FreeRenderResult(render_result_);
 }
 
@@ -68,6 +88,11 @@ void FileOutput::add_view(const char *view_name)
   /* Empty views can only be added for EXR images. */
   BLI_assert(ELEM(format_.imtype, R_IMF_IMTYPE_OPENEXR, R_IMF_IMTYPE_MULTILAYER));
 
+  /* The view might already exist if the compositor is evaluated in tiles. */
+  if (BLI_findstring(&render_result_->views, view_name, offsetof(RenderView, name))) {
+    return;
+  }
+
   RenderView *render_view = MEM_callocN<RenderView>("Render View For File Output.");
   BLI_addtail(&render_result_->views, render_view);
   STRNCPY(render_view->name, view_name);
@@ -89,6 +114,15 @@ void FileOutput::add_pass(const char *pass_name,
                           const char *view_name,
                           const char *channels,
                           float *buffer)
+{
+  this->add_pass_buffer(pass_name, view_name, channels, buffer, render_result_->recty);
+}
+
+RenderPass *FileOutput::add_pass_buffer(const char *pass_name,
+                                        const char *view_name,
+                                        const char *channels,
+                                        float *buffer,
+                                        const int height)
 {
   /* Passes can only be added for EXR images. */
   BLI_assert(ELEM(format_.imtype, R_IMF_IMTYPE_OPENEXR, R_IMF_IMTYPE_MULTILAYER));
@@ -102,13 +136,198 @@ void FileOutput::add_pass(const char *pass_name,
 
   const int channels_count = BLI_strnlen(channels, 4);
   render_pass->rectx = render_result_->rectx;
-  render_pass->recty = render_result_->recty;
+  render_pass->recty = height;
   render_pass->channels = channels_count;
 
-  render_pass->ibuf = IMB_allocImBuf(
-      render_result_->rectx, render_result_->recty, channels_count * 8, 0);
+  render_pass->ibuf = IMB_allocImBuf(render_result_->rectx, height, channels_count * 8, 0);
   render_pass->ibuf->channels = channels_count;
   IMB_assign_float_buffer(render_pass->ibuf, buffer, IB_TAKE_OWNERSHIP);
+
+  return render_pass;
+}
+
+RenderPass *FileOutput::find_pass(const char *pass_name, const char *view_name)
+{
+  RenderLayer *render_layer = static_cast<RenderLayer *>(render_result_->layers.first);
+  LISTBASE_FOREACH (RenderPass *, render_pass, &render_layer->passes) {
+    if (STREQ(render_pass->name, pass_name) && STREQ(render_pass->view, view_name)) {
+      return render_pass;
+    }
+  }
+  return nullptr;
+}
+
+/* Copies the given rows from the given buffer that only stores those rows to the given image
+ * buffer, which either stores the full image or only the rows if it is written progressively. */
+static void copy_rows(const float *rows_buffer,
+                      const IndexRange rows,
+                      const bool is_progressive,
+                      ImBuf *image_buffer)
+{
+  const int64_t row_size = int64_t(image_buffer->x) * image_buffer->channels;
+  const int64_t start_row = is_progressive ? 0 : rows.start();
+  BLI_assert(start_row + rows.size() <= image_buffer->y);
+  memcpy(image_buffer->float_buffer.data + start_row * row_size,
+         rows_buffer,
+         sizeof(float) * row_size * rows.size());
+}
+
+void FileOutput::add_view_rows(const char *view_name,
+                               const int channels,
+                               const IndexRange rows,
+                               const float *buffer)
+{
+  /* Views are only written when the file is saved. */
+  BLI_assert(!write_progressively_);
+
+  RenderView *render_view = static_cast<RenderView *>(
+      BLI_findstring(&render_result_->views, view_name, offsetof(RenderView, name)));
+  if (!render_view) {
+    this->add_view(view_name,
+                   channels,
+                   MEM_calloc_arrayN<float>(
+                       size_t(render_result_->rectx) * render_result_->recty * channels,
+                       "File Output View Buffer."));
+    render_view = static_cast<RenderView *>(render_result_->views.last);
+  }
+
+  copy_rows(buffer, rows, false, render_view->ibuf);
+}
+
+void FileOutput::add_pass_rows(const char *pass_name,
+                               const char *view_name,
+                               const char *channels,
+                               const IndexRange rows,
+                               const float *buffer)
+{
+  RenderPass *render_pass = this->find_pass(pass_name, view_name);
+  if (!render_pass) {
+    /* Progressively written file outputs only store the rows of the current tile. The first tile
+     * is the largest, since only the last tile might be clipped. */
+    const int height = write_progressively_ ? int(rows.size()) : render_result_->recty;
+    const int channels_count = BLI_strnlen(channels, 4);
+    render_pass = this->add_pass_buffer(
+        pass_name,
+        view_name,
+        channels,
+        MEM_calloc_arrayN<float>(size_t(render_result_->rectx) * height * channels_count,
+                                 "File Output Pass Buffer."),
+        height);
+  }
+
+  copy_rows(buffer, rows, write_progressively_, render_pass->ibuf);
+  added_rows_ = rows;
+}
+
+bool FileOutput::begin_progressive_write(Scene *scene)
+{
+  /* Add scene stamp data as meta data as well as the custom meta data, which are written in the
+   * header of the file, so they should all be added before writing starts. */
+  BKE_render_result_stamp_info(scene, nullptr, render_result_, false);
+  for (const auto &field : meta_data_.items()) {
+    BKE_render_result_stamp_data(render_result_, field.key.c_str(), field.value.c_str());
+  }
+
+  /* Add the channels of the passes, mirroring the structure of the multi-layer EXR images written
+   * by BKE_image_render_write_exr for a single unnamed layer, where the pass name is the layer
+   * name and the channel ID is the pass name. Only color passes are stored in half precision, and
+   * other passes can use the separate data codec of the format, since precision loss can be
+   * problematic for them. The buffers of the channels are set for each tile in the
+   * write_added_rows method. */
+  exr_handle_ = IMB_exr_get_handle();
+  const int data_compress = BKE_image_format_exr_data_codec(&format_);
+  RenderLayer *render_layer = static_cast<RenderLayer *>(render_result_->layers.first);
+  LISTBASE_FOREACH (RenderPass *, render_pass, &render_layer->passes) {
+    const bool is_color = RE_RenderPassIsColor(render_pass);
+    const bool use_half_float = format_.depth == R_IMF_CHAN_DEPTH_16 && is_color;
+    for (int i = 0; i < render_pass->channels; i++) {
+      const char channel_name[2] = {render_pass->chan_id[i], '\0'};
+      IMB_exr_add_channel(exr_handle_,
+                          render_pass->name,
+                          channel_name,
+                          render_pass->view,
+                          render_pass->channels,
+                          -render_pass->channels * render_result_->rectx,
+                          nullptr,
+                          use_half_float,
+                          is_color ? -1 : data_compress);
+    }
+  }
+
+  BLI_file_ensure_parent_dir_exists(path_.c_str());
+  return IMB_exrtile_begin_write(exr_handle_,
+                                 path_.c_str(),
+                                 0,
+                                 render_result_->rectx,
+                                 render_result_->recty,
+                                 exr_tile_size,
+                                 exr_tile_size,
+                                 format_.exr_codec,
+                                 format_.quality,
+                                 render_result_->stamp_data);
+}
+
+void FileOutput::write_added_rows(Scene *scene)
+{
+  if (!write_progressively_ || !added_rows_ || has_write_failed_) {
+    return;
+  }
+
+  const IndexRange rows = *added_rows_;
+  added_rows_.reset();
+
+  if (!exr_handle_ && !this->begin_progressive_write(scene)) {
+    fprintf(stderr, "Error writing file output %s (see console)\n", path_.c_str());
+    has_write_failed_ = true;
+    return;
+  }
+
+  const int width = render_result_->rectx;
+  const int height = render_result_->recty;
+  RenderLayer *render_layer = static_cast<RenderLayer *>(render_result_->layers.first);
+
+  /* Transform color passes from scene linear to the linear color space of the image format if
+   * needed, which is done in place since the buffers of the rows are only used for writing. */
+  const char *to_colorspace = format_.linear_colorspace_settings.name;
+  if (save_as_render_ && to_colorspace[0] != '\0' &&
+      !IMB_colormanagement_space_name_is_scene_linear(to_colorspace))
+  {
+    const char *from_colorspace = IMB_colormanagement_role_colorspace_name_get(
+        COLOR_ROLE_SCENE_LINEAR);
+    LISTBASE_FOREACH (RenderPass *, render_pass, &render_layer->passes) {
+      if (RE_RenderPassIsColor(render_pass)) {
+        IMB_colormanagement_transform_float(render_pass->ibuf->float_buffer.data,
+                                            width,
+                                            int(rows.size()),
+                                            render_pass->channels,
+                                            from_colorspace,
+                                            to_colorspace,
+                                            false);
+      }
+    }
+  }
+
+  /* EXR images are stored from top to bottom while the rows are stored from bottom to top, so the
+   * tiles are written starting from the last row and the rows are flipped using negative strides,
+   * which were set when adding the channels. */
+  const int start_row = height - int(rows.one_after_last());
+  BLI_assert(start_row % exr_tile_size == 0);
+  for (int y = start_row; y < height - rows.start(); y += exr_tile_size) {
+    for (int x = 0; x < width; x += exr_tile_size) {
+      /* The row of the first pixel of the tile in the buffers of the passes. */
+      const int64_t buffer_row = height - 1 - y - rows.start();
+      LISTBASE_FOREACH (RenderPass *, render_pass, &render_layer->passes) {
+        const int channels = render_pass->channels;
+        float *tile = render_pass->ibuf->float_buffer.data + (buffer_row * width + x) * channels;
+        for (int i = 0; i < channels; i++) {
+          const char channel_name[2] = {render_pass->chan_id[i], '\0'};
+          IMB_exr_set_channel(
+              exr_handle_, render_pass->name, channel_name, channels, -channels * width, tile + i);
+        }
+      }
+      IMB_exrtile_write_channels(exr_handle_, x, y, 0, "", false);
+    }
+  }
 }
 
 void FileOutput::add_meta_data(std::string key, std::string value)
@@ -118,6 +337,15 @@ void FileOutput::add_meta_data(std::string key, std::string value)
 
 void FileOutput::save(Scene *scene)
 {
+  /* Progressively written images are already written, so just finish writing the file. */
+  if (write_progressively_) {
+    if (exr_handle_) {
+      IMB_exr_close(exr_handle_);
+      exr_handle_ = nullptr;
+    }
+    return;
+  }
+
   ReportList reports;
   BKE_reports_init(&reports, RPT_STORE);
 
@@ -140,10 +368,21 @@ void FileOutput::save(Scene *scene)
 FileOutput &RenderContext::get_file_output(std::string path,
                                            ImageFormatData format,
                                            int2 size,
-                                           bool save_as_render)
+                                           bool save_as_render,
+                                           bool write_progressively)
 {
-  return *file_outputs_.lookup_or_add_cb(
-      path, [&]() { return std::make_unique<FileOutput>(path, format, size, save_as_render); });
+  std::lock_guard lock{file_outputs_mutex_};
+
+  return *file_outputs_.lookup_or_add_cb(path, [&]() {
+    return std::make_unique<FileOutput>(path, format, size, save_as_render, write_progressively);
+  });
+}
+
+void RenderContext::write_file_outputs_rows(Scene *scene)
+{
+  for (std::unique_ptr<FileOutput> &file_output : file_outputs_.values()) {
+    file_output->write_added_rows(scene);
+  }
 }
 
 void RenderContext::save_file_outputs(Scene *scene)
@@ -3,16 +3,26 @@
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
 #include <cstdint>
+#include <cstring>
 #include <variant>
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #include "BLI_assert.h"
 #include "BLI_cpp_type.hh"
 #include "BLI_generic_pointer.hh"
 #include "BLI_generic_span.hh"
+#include "BLI_index_range.hh"
+#include "BLI_math_base.h"
+#include "BLI_math_base.hh"
+#include "BLI_math_half.hh"
+#include "BLI_math_interp.hh"
 #include "BLI_math_matrix_types.hh"
+#include "BLI_math_vector.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 
 #include "GPU_shader.hh"
@@ -24,6 +34,7 @@
 #include "COM_derived_resources.hh"
 #include "COM_domain.hh"
 #include "COM_result.hh"
+#include "COM_scratch_memory.hh"
 
 namespace blender::compositor {
 
@@ -411,7 +422,7 @@ void Result::share_data(const Result &source)
   /* External data is intrinsically shared, and data_reference_count_ is nullptr in this case since
    * it is not needed. */
   if (!is_external_) {
-    (*data_reference_count_)++;
+    atomic_add_and_fetch_int32(data_reference_count_, 1);
   }
 }
 
@@ -464,6 +475,9 @@ void Result::wrap_external(void *data, int2 size)
   const int64_t array_size = int64_t(size.x) * int64_t(size.y);
   cpu_data_ = GMutableSpan(this->get_cpp_type(), data, array_size);
   storage_type_ = ResultStorageType::CPU;
+  precision_ = ResultPrecision::Full;
+  is_half_cpu_data_ = false;
+  is_scratch_cpu_data_ = false;
   is_external_ = true;
   domain_ = Domain(size);
 }
@@ -471,9 +485,15 @@ void Result::wrap_external(void *data, int2 size)
 void Result::wrap_external(const Result &result)
 {
   BLI_assert(type_ == result.type());
-  BLI_assert(precision_ == result.precision());
   BLI_assert(!this->is_allocated());
 
+  /* Wrapped CPU buffers are always in full precision, see the CPU variant of wrap_external, so
+   * the precision of the CPU data is adopted, since pixel access works for both precisions. */
+  if (result.storage_type_ == ResultStorageType::CPU) {
+    precision_ = result.precision();
+  }
+  BLI_assert(precision_ == result.precision());
+
   /* Steal the data of the given result and mark it as wrapping external data, but create a
    * temporary copy of the result first, since steal_data will reset it. */
   Result result_copy = result;
@@ -508,20 +528,21 @@ void Result::set_reference_count(int count)
 
 void Result::increment_reference_count(int count)
 {
-  reference_count_ += count;
+  atomic_add_and_fetch_int32(&reference_count_, count);
 }
 
 void Result::decrement_reference_count(int count)
 {
-  reference_count_ -= count;
+  atomic_sub_and_fetch_int32(&reference_count_, count);
 }
 
 void Result::release()
 {
-  /* Decrement the reference count, and if it is not yet zero, return and do not free. */
-  reference_count_--;
-  BLI_assert(reference_count_ >= 0);
-  if (reference_count_ != 0) {
+  /* Decrement the reference count, and if it is not yet zero, return and do not free. The count is
+   * decremented atomically since operations using the result might be evaluated concurrently. */
+  const int reference_count = atomic_sub_and_fetch_int32(&reference_count_, 1);
+  BLI_assert(reference_count >= 0);
+  if (reference_count != 0) {
     return;
   }
 
@@ -539,11 +560,10 @@ void Result::free()
   }
 
   /* Data is still shared with some other result, so decrement data reference count and reset data
-   * members without actually freeing the data itself. */
+   * members without actually freeing the data itself. The count is decremented atomically since
+   * results sharing the same data might be freed concurrently. */
   BLI_assert(*data_reference_count_ >= 1);
-  if (*data_reference_count_ != 1) {
-    (*data_reference_count_)--;
-
+  if (atomic_sub_and_fetch_int32(data_reference_count_, 1) != 0) {
     switch (storage_type_) {
       case ResultStorageType::GPU:
         gpu_texture_ = nullptr;
@@ -570,7 +590,12 @@ void Result::free()
       gpu_texture_ = nullptr;
       break;
     case ResultStorageType::CPU:
-      MEM_freeN(this->cpu_data().data());
+      if (is_scratch_cpu_data_) {
+        free_scratch_memory(this->cpu_data().data(), this->cpu_data().size_in_bytes());
+      }
+      else {
+        MEM_freeN(this->cpu_data().data());
+      }
       cpu_data_ = GMutableSpan();
       break;
   }
@@ -589,10 +614,24 @@ bool Result::should_compute()
 
 DerivedResources &Result::derived_resources()
 {
-  if (!derived_resources_) {
-    derived_resources_ = new DerivedResources();
+  DerivedResources *derived_resources = static_cast<DerivedResources *>(
+      atomic_load_ptr(reinterpret_cast<void **>(&derived_resources_)));
+  if (derived_resources) {
+    return *derived_resources;
+  }
+
+  /* The result might be used by multiple operations that are evaluated concurrently, so set the
+   * derived resources atomically, and if another thread set them first, use those instead. */
+  DerivedResources *new_derived_resources = new DerivedResources();
+  derived_resources = static_cast<DerivedResources *>(
+      atomic_cas_ptr(reinterpret_cast<void **>(&derived_resources_),
+                     nullptr,
+                     static_cast<void *>(new_derived_resources)));
+  if (derived_resources) {
+    delete new_derived_resources;
+    return *derived_resources;
   }
-  return *derived_resources_;
+  return *new_derived_resources;
 }
 
 ResultType Result::type() const
@@ -636,6 +675,11 @@ bool Result::is_allocated() const
   return false;
 }
 
+bool Result::is_external() const
+{
+  return is_external_;
+}
+
 int Result::reference_count() const
 {
   return reference_count_;
@@ -685,6 +729,193 @@ void Result::update_single_value_data()
   }
 }
 
+void Result::read_cpu_data(const IndexRange pixels, GMutableSpan r_data) const
+{
+  BLI_assert(r_data.type() == this->get_cpp_type());
+  BLI_assert(r_data.size() == pixels.size());
+
+  if (is_half_cpu_data_) {
+    const int64_t channels_count = this->channels_count();
+    const uint16_t *half_data = static_cast<const uint16_t *>(cpu_data_.data());
+    math::half_to_float_array(half_data + pixels.start() * channels_count,
+                              static_cast<float *>(r_data.data()),
+                              size_t(pixels.size() * channels_count));
+    return;
+  }
+
+  this->get_cpp_type().copy_assign_n(
+      this->cpu_data().slice(pixels).data(), r_data.data(), pixels.size());
+}
+
+void Result::write_cpu_data(const IndexRange pixels, GSpan data)
+{
+  BLI_assert(data.type() == this->get_cpp_type());
+  BLI_assert(data.size() == pixels.size());
+
+  if (is_half_cpu_data_) {
+    const int64_t channels_count = this->channels_count();
+    uint16_t *half_data = static_cast<uint16_t *>(cpu_data_.data());
+    math::float_to_half_array(static_cast<const float *>(data.data()),
+                              half_data + pixels.start() * channels_count,
+                              size_t(pixels.size() * channels_count));
+    return;
+  }
+
+  this->get_cpp_type().copy_assign_n(
+      data.data(), this->cpu_data().slice(pixels).data(), pixels.size());
+}
+
+float *Result::cpu_data_to_float_buffer() const
+{
+  BLI_assert(!is_single_value_);
+
+  if (!is_half_cpu_data_) {
+    /* Scratch memory is not allocated by the guarded allocator, so it can't be duplicated. */
+    if (is_scratch_cpu_data_) {
+      void *buffer = MEM_mallocN(this->cpu_data().size_in_bytes(), __func__);
+      memcpy(buffer, this->cpu_data().data(), this->cpu_data().size_in_bytes());
+      return static_cast<float *>(buffer);
+    }
+    return static_cast<float *>(MEM_dupallocN(this->cpu_data().data()));
+  }
+
+  const int64_t values_count = cpu_data_.size();
+  const uint16_t *half_data = static_cast<const uint16_t *>(cpu_data_.data());
+  float *buffer = MEM_malloc_arrayN<float>(size_t(values_count), __func__);
+  threading::parallel_for(IndexRange(values_count), 1 << 16, [&](const IndexRange sub_range) {
+    math::half_to_float_array(half_data + sub_range.start(),
+                              buffer + sub_range.start(),
+                              size_t(sub_range.size()));
+  });
+  return buffer;
+}
+
+/* Identical to the wrapping of coordinates in the BLI interpolation functions. Returns -1 if the
+ * coordinate is outside of the image for border wrapping. */
+static int wrap_coordinate(const float coordinate, const int size, math::InterpWrapMode wrap)
+{
+  switch (wrap) {
+    case math::InterpWrapMode::Extend:
+      return math::clamp(int(coordinate), 0, size - 1);
+    case math::InterpWrapMode::Repeat:
+      return int(floored_fmod(coordinate, float(size)));
+    case math::InterpWrapMode::Border: {
+      const int wrapped_coordinate = int(coordinate);
+      if (coordinate < 0.0f || wrapped_coordinate >= size) {
+        return -1;
+      }
+      return wrapped_coordinate;
+    }
+  }
+  return -1;
+}
+
+/* Cubic B-Spline filter coefficients for samples at -1, 0, +1, and +2 of the given offset from the
+ * texel center, identical to those used by the BLI interpolation functions. */
+static float4 cubic_bspline_coefficients(const float offset)
+{
+  const float offset2 = offset * offset;
+  const float offset3 = offset2 * offset;
+  const float w3 = offset3 * (1.0f / 6.0f);
+  const float w0 = -w3 + offset2 * 0.5f - offset * 0.5f + 1.0f / 6.0f;
+  const float w1 = offset3 * 0.5f - offset2 * 1.0f + 2.0f / 3.0f;
+  const float w2 = 1.0f - w0 - w1 - w3;
+  return float4(w0, w1, w2, w3);
+}
+
+float4 Result::sample_half_cpu_data(const float2 &coordinates,
+                                    const Interpolation interpolation,
+                                    const math::InterpWrapMode wrap_x,
+                                    const math::InterpWrapMode wrap_y) const
+{
+  BLI_assert(is_half_cpu_data_);
+
+  const int2 size = domain_.size;
+  const int64_t channels_count = this->channels_count();
+  const uint16_t *half_data = static_cast<const uint16_t *>(cpu_data_.data());
+
+  /* Loads the pixel at the given wrapped coordinates, or zero if it is outside of the image. */
+  const auto load_pixel = [&](const int x, const int y) {
+    float4 pixel_value = float4(0.0f);
+    if (x >= 0 && y >= 0) {
+      math::half_to_float_array(
+          half_data + (int64_t(y) * size.x + x) * channels_count, pixel_value, channels_count);
+    }
+    return pixel_value;
+  };
+
+  float4 sampled_value = float4(0.0f);
+  switch (interpolation) {
+    case Interpolation::Nearest: {
+      const float2 texel_coordinates = coordinates * float2(size);
+      sampled_value = load_pixel(wrap_coordinate(texel_coordinates.x, size.x, wrap_x),
+                                 wrap_coordinate(texel_coordinates.y, size.y, wrap_y));
+      break;
+    }
+    case Interpolation::Bilinear: {
+      const float2 texel_coordinates = coordinates * float2(size) - 0.5f;
+      const float2 lower = math::floor(texel_coordinates);
+      const float2 weights = texel_coordinates - lower;
+      const int x1 = wrap_coordinate(lower.x, size.x, wrap_x);
+      const int x2 = wrap_coordinate(lower.x + 1.0f, size.x, wrap_x);
+      const int y1 = wrap_coordinate(lower.y, size.y, wrap_y);
+      const int y2 = wrap_coordinate(lower.y + 1.0f, size.y, wrap_y);
+      sampled_value = math::interpolate(
+          math::interpolate(load_pixel(x1, y1), load_pixel(x2, y1), weights.x),
+          math::interpolate(load_pixel(x1, y2), load_pixel(x2, y2), weights.x),
+          weights.y);
+      break;
+    }
+    case Interpolation::Bicubic: {
+      const float2 texel_coordinates = coordinates * float2(size) - 0.5f;
+      const float2 lower = math::floor(texel_coordinates);
+      const float4 weights_x = cubic_bspline_coefficients(texel_coordinates.x - lower.x);
+      const float4 weights_y = cubic_bspline_coefficients(texel_coordinates.y - lower.y);
+      for (const int j : IndexRange(4)) {
+        const int y = wrap_coordinate(lower.y + float(j - 1), size.y, wrap_y);
+        for (const int i : IndexRange(4)) {
+          const int x = wrap_coordinate(lower.x + float(i - 1), size.x, wrap_x);
+          sampled_value += load_pixel(x, y) * (weights_x[i] * weights_y[j]);
+        }
+      }
+      break;
+    }
+  }
+
+  /* Only write the channels of the result, similar to the BLI interpolation functions. */
+  float4 pixel_value = float4(0.0f, 0.0f, 0.0f, 1.0f);
+  for (const int i : IndexRange(channels_count)) {
+    pixel_value[i] = sampled_value[i];
+  }
+  return pixel_value;
+}
+
+/* Returns true if the given type stores floats and can thus be stored using half precision. */
+static bool is_float_type(const ResultType type)
+{
+  switch (type) {
+    case ResultType::Float:
+    case ResultType::Float2:
+    case ResultType::Float3:
+    case ResultType::Float4:
+    case ResultType::Color:
+      return true;
+    case ResultType::Int:
+    case ResultType::Int2:
+    case ResultType::Bool:
+      return false;
+  }
+  return false;
+}
+
+bool Result::use_half_cpu_storage() const
+{
+  if (context_->get_precision() != ResultPrecision::Half) {
+    return false;
+  }
+  return precision_ == ResultPrecision::Half && !is_single_value_ && is_float_type(type_);
+}
+
 void Result::allocate_data(int2 size, bool from_pool)
 {
   BLI_assert(!this->is_allocated());
@@ -692,6 +923,7 @@ void Result::allocate_data(int2 size, bool from_pool)
   if (context_->use_gpu()) {
     storage_type_ = ResultStorageType::GPU;
     is_from_pool_ = from_pool;
+    is_half_cpu_data_ = false;
 
     const eGPUTextureFormat format = this->get_gpu_texture_format();
     const eGPUTextureUsage usage = GPU_TEXTURE_USAGE_GENERAL;
@@ -702,8 +934,17 @@ void Result::allocate_data(int2 size, bool from_pool)
       gpu_texture_ = GPU_texture_create_2d(__func__, size.x, size.y, 1, format, usage, nullptr);
     }
   }
+  else if (this->use_half_cpu_storage()) {
+    storage_type_ = ResultStorageType::CPU;
+    is_half_cpu_data_ = true;
+
+    const int64_t array_size = int64_t(size.x) * int64_t(size.y) * this->channels_count();
+    void *data = this->allocate_cpu_data(array_size * sizeof(uint16_t), alignof(uint16_t));
+    cpu_data_ = GMutableSpan(CPPType::get<uint16_t>(), data, array_size);
+  }
   else {
     storage_type_ = ResultStorageType::CPU;
+    is_half_cpu_data_ = false;
 
     const CPPType &cpp_type = this->get_cpp_type();
     const int64_t item_size = cpp_type.size();
@@ -711,7 +952,7 @@ void Result::allocate_data(int2 size, bool from_pool)
     const int64_t array_size = int64_t(size.x) * int64_t(size.y);
     const int64_t memory_size = array_size * item_size;
 
-    void *data = MEM_mallocN_aligned(memory_size, alignment, AT);
+    void *data = this->allocate_cpu_data(memory_size, alignment);
     cpp_type.default_construct_n(data, array_size);
 
     cpu_data_ = GMutableSpan(cpp_type, data, array_size);
@@ -720,4 +961,20 @@ void Result::allocate_data(int2 size, bool from_pool)
   data_reference_count_ = new int(1);
 }
 
+void *Result::allocate_cpu_data(const int64_t size, const int64_t alignment)
+{
+  const int64_t scratch_memory_threshold = context_->get_scratch_memory_threshold();
+  if (scratch_memory_threshold > 0 && size >= scratch_memory_threshold) {
+    /* Scratch memory is page aligned, so it satisfies any alignment. */
+    void *data = allocate_scratch_memory(size);
+    if (data) {
+      is_scratch_cpu_data_ = true;
+      return data;
+    }
+  }
+
+  is_scratch_cpu_data_ = false;
+  return MEM_mallocN_aligned(size, alignment, AT);
+}
+
 }  // namespace blender::compositor
@@ -0,0 +1,142 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <atomic>
+#include <cstdint>
+#include <fcntl.h>
+#include <string>
+
+#ifndef WIN32
+#  include <sys/mman.h> /* For mmap. */
+#  include <unistd.h>   /* For ftruncate, unlink, and close. */
+#else
+#  include <mutex>
+
+#  include "BLI_map.hh"
+#  include "BLI_winstuff.h"
+#  include <io.h> /* For close. */
+#endif
+
+#include "BLI_fileops.h"
+#include "BLI_path_utils.hh"
+
+#include "BKE_appdir.hh"
+
+#include "COM_scratch_memory.hh"
+
+namespace blender::compositor {
+
+/* Creates and opens a new empty scratch file for reading and writing, returning its file
+ * descriptor, or -1 if it couldn't be created. The file is deleted once it is closed and the
+ * memory mapped from it is freed. */
+static int open_scratch_file()
+{
+  /* The session temporary directory is unique to the process, so a counter is enough to make the
+   * file names unique. */
+  static std::atomic<int> files_count = 0;
+  const std::string file_name = "compositor_scratch_" + std::to_string(files_count++);
+
+  char file_path[FILE_MAX];
+  BLI_path_join(file_path, sizeof(file_path), BKE_tempdir_session(), file_name.c_str());
+
+#ifndef WIN32
+  const int file = BLI_open(file_path, O_BINARY | O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (file != -1) {
+    /* Unlink the file right away, such that it gets deleted once it is closed and unmapped, even
+     * if the process crashes. */
+    unlink(file_path);
+  }
+  return file;
+#else
+  return BLI_open(file_path, O_BINARY | O_RDWR | O_CREAT | O_EXCL | O_TEMPORARY, 0600);
+#endif
+}
+
+#ifndef WIN32
+
+void *allocate_scratch_memory(const int64_t size)
+{
+  const int file = open_scratch_file();
+  if (file == -1) {
+    return nullptr;
+  }
+
+  /* Extending the file doesn't allocate disk space, the pages are only written to the file when
+   * the operating system evicts them. */
+  if (ftruncate(file, off_t(size)) != 0) {
+    close(file);
+    return nullptr;
+  }
+
+  void *memory = mmap(nullptr, size_t(size), PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+
+  /* The mapping keeps a reference to the file, so it can be closed right away. */
+  close(file);
+
+  return memory == MAP_FAILED ? nullptr : memory;
+}
+
+void free_scratch_memory(void *memory, const int64_t size)
+{
+  munmap(memory, size_t(size));
+}
+
+#else
+
+/* The file descriptors of the scratch files and the handles of their mappings, which are kept open
+ * until the memory is freed, since temporary files are deleted when their descriptors are closed.
+ * Indexed by the mapped memory. */
+struct ScratchFile {
+  int file;
+  HANDLE mapping;
+};
+static Map<void *, ScratchFile> scratch_files;
+static std::mutex scratch_files_mutex;
+
+void *allocate_scratch_memory(const int64_t size)
+{
+  const int file = open_scratch_file();
+  if (file == -1) {
+    return nullptr;
+  }
+
+  /* Memory mapping on Windows is a two-step process, first we create a mapping, then we create a
+   * view into that mapping. Creating the mapping extends the file to the given size. */
+  HANDLE file_handle = HANDLE(_get_osfhandle(file));
+  HANDLE mapping = CreateFileMapping(file_handle,
+                                     nullptr,
+                                     PAGE_READWRITE,
+                                     DWORD(uint64_t(size) >> 32),
+                                     DWORD(uint64_t(size) & 0xFFFFFFFF),
+                                     nullptr);
+  if (mapping == nullptr) {
+    close(file);
+    return nullptr;
+  }
+
+  void *memory = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size_t(size));
+  if (memory == nullptr) {
+    CloseHandle(mapping);
+    close(file);
+    return nullptr;
+  }
+
+  std::lock_guard lock{scratch_files_mutex};
+  scratch_files.add_new(memory, ScratchFile{file, mapping});
+  return memory;
+}
+
+void free_scratch_memory(void *memory, const int64_t /*size*/)
+{
+  UnmapViewOfFile(memory);
+
+  std::lock_guard lock{scratch_files_mutex};
+  const ScratchFile scratch_file = scratch_files.pop(memory);
+  CloseHandle(scratch_file.mapping);
+  close(scratch_file.file);
+}
+
+#endif
+
+}  // namespace blender::compositor
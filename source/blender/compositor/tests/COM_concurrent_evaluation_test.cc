@@ -0,0 +1,320 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_array.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_string_ref.hh"
+#include "BLI_task.h"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
+
+#include "DNA_image_types.h"
+#include "DNA_node_types.h"
+#include "DNA_scene_types.h"
+#include "DNA_vec_types.h"
+
+#include "BKE_idtype.hh"
+#include "BKE_image.hh"
+#include "BKE_main.hh"
+
+#include "IMB_imbuf.hh"
+
+#include "COM_context.hh"
+#include "COM_derived_resources.hh"
+#include "COM_domain.hh"
+#include "COM_operation.hh"
+#include "COM_operation_task_pool.hh"
+#include "COM_result.hh"
+#include "COM_static_cache_manager.hh"
+
+namespace blender::compositor::tests {
+
+/* A CPU context that is not associated with a render or a node tree. */
+class TestContext : public Context {
+ private:
+  Scene *scene_;
+  bNodeTree *node_tree_;
+
+ public:
+  TestContext()
+  {
+    scene_ = static_cast<Scene *>(MEM_callocN(sizeof(Scene), __func__));
+    node_tree_ = static_cast<bNodeTree *>(MEM_callocN(sizeof(bNodeTree), __func__));
+  }
+
+  ~TestContext()
+  {
+    MEM_freeN(scene_);
+    MEM_freeN(node_tree_);
+  }
+
+  const Scene &get_scene() const override
+  {
+    return *scene_;
+  }
+
+  const bNodeTree &get_node_tree() const override
+  {
+    return *node_tree_;
+  }
+
+  bool use_gpu() const override
+  {
+    return false;
+  }
+
+  eCompositorDenoiseQaulity get_denoise_quality() const override
+  {
+    return SCE_COMPOSITOR_DENOISE_BALANCED;
+  }
+
+  OutputTypes needed_outputs() const override
+  {
+    return OutputTypes::Composite;
+  }
+
+  const RenderData &get_render_data() const override
+  {
+    return scene_->r;
+  }
+
+  int2 get_render_size() const override
+  {
+    return int2(64);
+  }
+
+  rcti get_compositing_region() const override
+  {
+    return rcti{0, 64, 0, 64};
+  }
+
+  Result get_output_result() override
+  {
+    return Result(*this);
+  }
+
+  Result get_viewer_output_result(Domain /*domain*/,
+                                  bool /*is_data*/,
+                                  ResultPrecision /*precision*/) override
+  {
+    return Result(*this);
+  }
+
+  Result get_pass(const Scene * /*scene*/, int /*view_layer*/, const char * /*pass_name*/) override
+  {
+    return Result(*this);
+  }
+
+  StringRef get_view_name() const override
+  {
+    return "";
+  }
+
+  ResultPrecision get_precision() const override
+  {
+    return ResultPrecision::Full;
+  }
+
+  void set_info_message(StringRef /*message*/) const override {}
+};
+
+/* An operation that only declares a result, such that it can be added to an OperationTaskPool,
+ * which evaluates it by calling the function it is added with. */
+class TestOperation : public Operation {
+ public:
+  TestOperation(Context &context) : Operation(context)
+  {
+    this->populate_result("Result", Result(context, ResultType::Float, ResultPrecision::Full));
+  }
+
+  void execute() override {}
+};
+
+class CompositorConcurrentEvaluationTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BLI_task_scheduler_init();
+    BKE_idtype_init();
+    IMB_init();
+  }
+
+  static void TearDownTestSuite()
+  {
+    IMB_exit();
+    BLI_task_scheduler_exit();
+  }
+};
+
+/* Operations form layers where each operation uses the results of two operations of the previous
+ * layer, and every operation must only be evaluated after the operations it uses. */
+TEST_F(CompositorConcurrentEvaluationTest, TaskPoolEvaluatesDependenciesFirst)
+{
+  constexpr int layers_count = 8;
+  constexpr int layer_size = 16;
+
+  TestContext context;
+  Vector<std::unique_ptr<TestOperation>> operations;
+  Array<std::atomic<bool>> is_evaluated(layers_count * layer_size);
+  for (std::atomic<bool> &value : is_evaluated) {
+    value = false;
+  }
+  std::atomic<int> evaluated_before_dependencies = 0;
+
+  {
+    OperationTaskPool task_pool(context);
+    for (const int layer : IndexRange(layers_count)) {
+      for (const int i : IndexRange(layer_size)) {
+        const int index = layer * layer_size + i;
+        operations.append(std::make_unique<TestOperation>(context));
+        TestOperation &operation = *operations.last();
+
+        Vector<int> dependencies;
+        if (layer != 0) {
+          dependencies.append((layer - 1) * layer_size + i);
+          dependencies.append((layer - 1) * layer_size + (i + 1) % layer_size);
+        }
+        for (const int j : dependencies.index_range()) {
+          operation.map_input_to_result(std::to_string(j),
+                                        &operations[dependencies[j]]->get_result("Result"));
+        }
+
+        task_pool.add(operation, [&, index, dependencies]() {
+          for (const int dependency : dependencies) {
+            if (!is_evaluated[dependency]) {
+              evaluated_before_dependencies++;
+            }
+          }
+          is_evaluated[index] = true;
+        });
+      }
+    }
+
+    task_pool.wait();
+    EXPECT_FALSE(task_pool.was_canceled());
+  }
+
+  EXPECT_EQ(evaluated_before_dependencies.load(), 0);
+  for (const std::atomic<bool> &value : is_evaluated) {
+    EXPECT_TRUE(value.load());
+  }
+}
+
+/* Two independent operations that each wait for the other to start can only finish if they are
+ * evaluated concurrently. */
+TEST_F(CompositorConcurrentEvaluationTest, TaskPoolEvaluatesIndependentOperationsConcurrently)
+{
+  if (BLI_task_scheduler_num_threads() < 3) {
+    GTEST_SKIP() << "Not enough threads";
+  }
+
+  TestContext context;
+  TestOperation first_operation(context);
+  TestOperation second_operation(context);
+  std::atomic<int> started_count = 0;
+  std::atomic<int> concurrent_count = 0;
+
+  auto evaluate = [&]() {
+    started_count++;
+    const auto time_limit = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (started_count < 2 && std::chrono::steady_clock::now() < time_limit) {
+      std::this_thread::yield();
+    }
+    if (started_count == 2) {
+      concurrent_count++;
+    }
+  };
+
+  {
+    OperationTaskPool task_pool(context);
+    task_pool.add(first_operation, evaluate);
+    task_pool.add(second_operation, evaluate);
+    task_pool.wait();
+  }
+
+  EXPECT_EQ(concurrent_count.load(), 2);
+}
+
+/* Operations evaluated concurrently that use the same result get the same derived resources. */
+TEST_F(CompositorConcurrentEvaluationTest, DerivedResourcesConcurrentAccess)
+{
+  TestContext context;
+  Result result(context, ResultType::Float4, ResultPrecision::Full);
+  result.allocate_texture(Domain(int2(4)), false);
+
+  Array<DerivedResources *> derived_resources(256, nullptr);
+  threading::parallel_for(derived_resources.index_range(), 1, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      derived_resources[i] = &result.derived_resources();
+    }
+  });
+
+  for (DerivedResources *resources : derived_resources) {
+    EXPECT_EQ(resources, derived_resources[0]);
+  }
+
+  result.free();
+}
+
+/* Operations evaluated concurrently that use the same image share a single cached image that is
+ * loaded once, while different images are loaded independently. */
+TEST_F(CompositorConcurrentEvaluationTest, CachedImageConcurrentGet)
+{
+  Main *bmain = BKE_main_new();
+  const float color[4] = {0.25f, 0.5f, 0.75f, 1.0f};
+  Image *images[2];
+  for (const int i : IndexRange(2)) {
+    images[i] = BKE_image_add_generated(bmain,
+                                        32 * (i + 1),
+                                        16 * (i + 1),
+                                        i == 0 ? "First" : "Second",
+                                        32,
+                                        true,
+                                        IMA_GENTYPE_BLANK,
+                                        color,
+                                        false,
+                                        false,
+                                        false);
+  }
+
+  ImageUser image_user;
+  BKE_imageuser_default(&image_user);
+
+  {
+    TestContext context;
+    constexpr int gets_count = 64;
+    Array<const void *> data(gets_count, nullptr);
+    Array<int2> sizes(gets_count, int2(0));
+    threading::parallel_for(IndexRange(gets_count), 1, [&](const IndexRange range) {
+      for (const int64_t i : range) {
+        Result result = context.cache_manager().cached_images.get(
+            context, images[i % 2], &image_user, "");
+        data[i] = result.is_allocated() ? result.cpu_data().data() : nullptr;
+        sizes[i] = result.domain().size;
+      }
+    });
+
+    for (const int i : IndexRange(gets_count)) {
+      const int image_index = i % 2;
+      EXPECT_NE(data[i], nullptr);
+      EXPECT_EQ(data[i], data[image_index]);
+      EXPECT_EQ(sizes[i], int2(32, 16) * (image_index + 1));
+    }
+    EXPECT_NE(data[0], data[1]);
+  }
+
+  BKE_main_free(bmain);
+}
+
+}  // namespace blender::compositor::tests
@@ -0,0 +1,292 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "CLG_log.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_math_vector_types.hh"
+#include "BLI_string.h"
+#include "BLI_string_ref.hh"
+
+#include "DNA_color_types.h"
+#include "DNA_image_types.h"
+#include "DNA_node_types.h"
+#include "DNA_scene_types.h"
+#include "DNA_vec_types.h"
+
+#include "BKE_idtype.hh"
+#include "BKE_image.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_main.hh"
+#include "BKE_node.hh"
+#include "BKE_node_runtime.hh"
+
+#include "IMB_imbuf.hh"
+
+#include "NOD_derived_node_tree.hh"
+
+#include "RNA_define.hh"
+
+#include "COM_context.hh"
+#include "COM_node_hash.hh"
+#include "COM_region_of_interest.hh"
+#include "COM_result.hh"
+#include "COM_scheduler.hh"
+
+namespace blender::compositor::tests {
+
+/* A CPU context that evaluates the given node tree into the composite output. */
+class TestContext : public Context {
+ private:
+  Scene *scene_;
+  const bNodeTree &node_tree_;
+
+ public:
+  TestContext(const bNodeTree &node_tree) : node_tree_(node_tree)
+  {
+    scene_ = static_cast<Scene *>(MEM_callocN(sizeof(Scene), __func__));
+    scene_->r.cfra = 1;
+    scene_->r.frs_sec = 24;
+    scene_->r.frs_sec_base = 1.0f;
+  }
+
+  ~TestContext()
+  {
+    MEM_freeN(scene_);
+  }
+
+  const Scene &get_scene() const override
+  {
+    return *scene_;
+  }
+
+  const bNodeTree &get_node_tree() const override
+  {
+    return node_tree_;
+  }
+
+  bool use_gpu() const override
+  {
+    return false;
+  }
+
+  eCompositorDenoiseQaulity get_denoise_quality() const override
+  {
+    return SCE_COMPOSITOR_DENOISE_BALANCED;
+  }
+
+  OutputTypes needed_outputs() const override
+  {
+    return OutputTypes::Composite;
+  }
+
+  const RenderData &get_render_data() const override
+  {
+    return scene_->r;
+  }
+
+  int2 get_render_size() const override
+  {
+    return int2(64);
+  }
+
+  rcti get_compositing_region() const override
+  {
+    return rcti{0, 64, 0, 64};
+  }
+
+  Result get_output_result() override
+  {
+    return Result(*this);
+  }
+
+  Result get_viewer_output_result(Domain /*domain*/,
+                                  bool /*is_data*/,
+                                  ResultPrecision /*precision*/) override
+  {
+    return Result(*this);
+  }
+
+  Result get_pass(const Scene * /*scene*/, int /*view_layer*/, const char * /*pass_name*/) override
+  {
+    return Result(*this);
+  }
+
+  StringRef get_view_name() const override
+  {
+    return "";
+  }
+
+  ResultPrecision get_precision() const override
+  {
+    return ResultPrecision::Full;
+  }
+
+  void set_info_message(StringRef /*message*/) const override {}
+};
+
+class CompositorNodeHashTest : public testing::Test {
+ public:
+  Main *bmain = nullptr;
+  Image *image = nullptr;
+  bNodeTree *node_tree = nullptr;
+
+  static void SetUpTestSuite()
+  {
+    CLG_init();
+    BKE_idtype_init();
+    RNA_init();
+    bke::node_system_init();
+    IMB_init();
+  }
+
+  static void TearDownTestSuite()
+  {
+    bke::node_system_exit();
+    RNA_exit();
+    IMB_exit();
+    CLG_exit();
+  }
+
+  /* Image -> Filter -> RGB Curves -> Composite. */
+  void SetUp() override
+  {
+    bmain = BKE_main_new();
+    const float color[4] = {0.25f, 0.5f, 0.75f, 1.0f};
+    image = BKE_image_add_generated(
+        bmain, 16, 16, "Image", 32, true, IMA_GENTYPE_BLANK, color, false, false, false);
+
+    node_tree = bke::node_tree_add_tree(nullptr, "Compositor", "CompositorNodeTree");
+    bNode *image_node = bke::node_add_node(nullptr, *node_tree, "CompositorNodeImage");
+    bNode *filter_node = bke::node_add_node(nullptr, *node_tree, "CompositorNodeFilter");
+    bNode *curves_node = bke::node_add_node(nullptr, *node_tree, "CompositorNodeCurveRGB");
+    bNode *composite_node = bke::node_add_node(nullptr, *node_tree, "CompositorNodeComposite");
+    STRNCPY(image_node->name, "Image");
+    STRNCPY(filter_node->name, "Filter");
+    STRNCPY(curves_node->name, "Curves");
+    STRNCPY(composite_node->name, "Composite");
+    image_node->id = &image->id;
+    composite_node->flag |= NODE_DO_OUTPUT;
+
+    link(*image_node, *filter_node);
+    link(*filter_node, *curves_node);
+    link(*curves_node, *composite_node);
+  }
+
+  void TearDown() override
+  {
+    BKE_id_free(nullptr, &node_tree->id);
+    BKE_main_free(bmain);
+  }
+
+  void link(bNode &from_node, bNode &to_node)
+  {
+    bke::node_add_link(*node_tree,
+                       from_node,
+                       *bke::node_find_socket(from_node, SOCK_OUT, "Image"),
+                       to_node,
+                       *bke::node_find_socket(to_node, SOCK_IN, "Image"));
+  }
+
+  bNode &node(const StringRefNull name)
+  {
+    return *bke::node_find_node_by_name(*node_tree, name);
+  }
+
+  /* Computes the hashes of the nodes of the given tree, identified by their names. */
+  static Map<std::string, NodeHash> compute_hashes(const bNodeTree &tree)
+  {
+    TestContext context(tree);
+    nodes::DerivedNodeTree derived_tree(tree);
+    const Schedule schedule = compute_schedule(context, derived_tree);
+    const RegionsOfInterest regions_of_interest = compute_regions_of_interest(context, schedule);
+    const NodeHashes node_hashes = compute_node_hashes(context, schedule, regions_of_interest);
+
+    Map<std::string, NodeHash> hashes;
+    for (const auto item : node_hashes.items()) {
+      hashes.add_new(item.key->name, item.value);
+    }
+    return hashes;
+  }
+};
+
+TEST_F(CompositorNodeHashTest, AllNodesAreHashed)
+{
+  const Map<std::string, NodeHash> hashes = compute_hashes(*node_tree);
+  EXPECT_EQ(hashes.size(), 4);
+  for (const StringRefNull name : {"Image", "Filter", "Curves", "Composite"}) {
+    EXPECT_TRUE(hashes.contains_as(name)) << name;
+  }
+}
+
+/* Copies of the tree, like the localized trees that the compositor evaluates, hit the cache. */
+TEST_F(CompositorNodeHashTest, IdenticalTreesHaveEqualHashes)
+{
+  const Map<std::string, NodeHash> hashes = compute_hashes(*node_tree);
+  bNodeTree *copy = bke::node_tree_copy_tree(nullptr, *node_tree);
+  const Map<std::string, NodeHash> copy_hashes = compute_hashes(*copy);
+  BKE_id_free(nullptr, &copy->id);
+
+  EXPECT_EQ(copy_hashes.size(), hashes.size());
+  for (const auto item : hashes.items()) {
+    EXPECT_EQ(copy_hashes.lookup_default(item.key, NodeHash()), item.value) << item.key;
+  }
+}
+
+/* A change to a node property misses the cache for that node and the nodes that depend on it. */
+TEST_F(CompositorNodeHashTest, NodePropertyChangeChangesHash)
+{
+  const Map<std::string, NodeHash> hashes = compute_hashes(*node_tree);
+  node("Filter").custom1 = CMP_NODE_FILTER_SHARP_BOX;
+  const Map<std::string, NodeHash> new_hashes = compute_hashes(*node_tree);
+
+  EXPECT_EQ(new_hashes.lookup("Image"), hashes.lookup("Image"));
+  EXPECT_NE(new_hashes.lookup("Filter"), hashes.lookup("Filter"));
+  EXPECT_NE(new_hashes.lookup("Curves"), hashes.lookup("Curves"));
+  EXPECT_NE(new_hashes.lookup("Composite"), hashes.lookup("Composite"));
+}
+
+/* Curve points are stored outside of the node storage, but are still part of the hash. */
+TEST_F(CompositorNodeHashTest, CurveMappingChangeChangesHash)
+{
+  const Map<std::string, NodeHash> hashes = compute_hashes(*node_tree);
+  CurveMapping *curve_mapping = static_cast<CurveMapping *>(node("Curves").storage);
+  curve_mapping->cm[3].curve[0].y = 0.5f;
+  const Map<std::string, NodeHash> new_hashes = compute_hashes(*node_tree);
+
+  EXPECT_EQ(new_hashes.lookup("Image"), hashes.lookup("Image"));
+  EXPECT_EQ(new_hashes.lookup("Filter"), hashes.lookup("Filter"));
+  EXPECT_NE(new_hashes.lookup("Curves"), hashes.lookup("Curves"));
+  EXPECT_NE(new_hashes.lookup("Composite"), hashes.lookup("Composite"));
+}
+
+/* Changes to the pixels of an image increment its update count, which misses the cache. */
+TEST_F(CompositorNodeHashTest, ImageUpdateCountChangesHash)
+{
+  const Map<std::string, NodeHash> hashes = compute_hashes(*node_tree);
+  image->runtime.update_count++;
+  const Map<std::string, NodeHash> new_hashes = compute_hashes(*node_tree);
+
+  EXPECT_NE(new_hashes.lookup("Image"), hashes.lookup("Image"));
+  EXPECT_NE(new_hashes.lookup("Filter"), hashes.lookup("Filter"));
+  EXPECT_NE(new_hashes.lookup("Curves"), hashes.lookup("Curves"));
+  EXPECT_NE(new_hashes.lookup("Composite"), hashes.lookup("Composite"));
+}
+
+/* The value of an unlinked input is part of the hash. */
+TEST_F(CompositorNodeHashTest, UnlinkedInputChangeChangesHash)
+{
+  const Map<std::string, NodeHash> hashes = compute_hashes(*node_tree);
+  bNodeSocket *factor = bke::node_find_socket(node("Filter"), SOCK_IN, "Fac");
+  factor->default_value_typed<bNodeSocketValueFloat>()->value = 0.5f;
+  const Map<std::string, NodeHash> new_hashes = compute_hashes(*node_tree);
+
+  EXPECT_EQ(new_hashes.lookup("Image"), hashes.lookup("Image"));
+  EXPECT_NE(new_hashes.lookup("Filter"), hashes.lookup("Filter"));
+}
+
+}  // namespace blender::compositor::tests
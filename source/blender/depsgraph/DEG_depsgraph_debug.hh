@@ -65,3 +65,10 @@ bool DEG_debug_graph_relations_validate(Depsgraph *graph,
 
 /** Perform consistency check on the graph. */
 bool DEG_debug_consistency_check(Depsgraph *graph);
+
+/**
+ * Write the timeline of operation evaluations to `depsgraph_eval_trace.json` in the Chrome Trace
+ * Event format and free it. The timeline is recorded when evaluation debug messages are enabled
+ * in background mode (`--background --debug-depsgraph-eval`).
+ */
+void DEG_debug_eval_trace_write_and_free();
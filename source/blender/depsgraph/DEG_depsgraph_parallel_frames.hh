@@ -0,0 +1,36 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup depsgraph
+ *
+ * Evaluation of multiple frames at the same time, using independent dependency graphs. This is
+ * useful for exporters and bakers that step through a frame range, because evaluation of a single
+ * frame often can't use all available threads.
+ */
+
+#include "BLI_function_ref.hh"
+#include "BLI_span.hh"
+
+struct Depsgraph;
+
+/**
+ * Evaluate the given frames in parallel.
+ *
+ * All dependency graphs have to be built for the same scene and must not be active, so that they
+ * don't write back to original data. Frame `i` is evaluated by
+ * `depsgraphs[i % depsgraphs.size()]`. The callback is called for every frame in the given order
+ * on the calling thread, while the next frames are evaluated in the background. Evaluation stops
+ * when the callback returns false.
+ *
+ * This is only valid for scenes whose evaluated state does not depend on the previously evaluated
+ * frame, e.g. there must be no simulation that is stepped through the frames. Frame change
+ * handlers are not executed.
+ */
+void DEG_evaluate_frames_parallel(
+    blender::Span<Depsgraph *> depsgraphs,
+    blender::Span<float> frames,
+    blender::FunctionRef<bool(Depsgraph *depsgraph, float frame)> frame_fn);
@@ -177,6 +177,7 @@ void deg_graph_build_finalize(Main *bmain, Depsgraph *graph)
 {
   deg_graph_flush_visibility_flags(graph);
   deg_graph_remove_unused_noops(graph);
+  graph->need_update_operation_priorities = true;
 
   /* Re-tag IDs for update if it was tagged before the relations
    * update tag. */
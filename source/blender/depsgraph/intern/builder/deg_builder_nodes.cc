@@ -408,6 +408,9 @@ void DepsgraphNodeBuilder::begin_build()
     if (op_node->flag & DEPSOP_FLAG_NEEDS_UPDATE) {
       needs_update_operations_.append_as(op_node);
     }
+    if (op_node->cost != 0.0f) {
+      saved_operation_costs_.append({PersistentOperationKey(op_node), op_node->cost});
+    }
   }
 
   /* Make sure graph has no nodes left from previous state. */
@@ -553,10 +556,22 @@ void DepsgraphNodeBuilder::tag_previously_tagged_nodes()
   }
 }
 
+void DepsgraphNodeBuilder::restore_operation_costs()
+{
+  for (const SavedOperationCost &saved_cost : saved_operation_costs_) {
+    OperationNode *operation_node = find_operation_node(saved_cost.key);
+    if (operation_node == nullptr) {
+      continue;
+    }
+    operation_node->cost = saved_cost.cost;
+  }
+}
+
 void DepsgraphNodeBuilder::end_build()
 {
   graph_->light_linking_cache.end_build(*graph_->scene);
   tag_previously_tagged_nodes();
+  restore_operation_costs();
   update_invalid_cow_pointers();
 }
 
@@ -307,6 +307,14 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
   Vector<PersistentOperationKey> saved_entry_tags_;
   Vector<PersistentOperationKey> needs_update_operations_;
 
+  /* Measured evaluation cost of operations, transferred to the new dependency graph so that
+   * scheduling priorities don't have to be learned again after relations update. */
+  struct SavedOperationCost {
+    PersistentOperationKey key;
+    float cost;
+  };
+  Vector<SavedOperationCost> saved_operation_costs_;
+
   struct BuilderWalkUserData {
     DepsgraphNodeBuilder *builder;
   };
@@ -320,6 +328,7 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
                               void *user_data);
 
   void tag_previously_tagged_nodes();
+  void restore_operation_costs();
   /**
    * Check for IDs that need to be flushed (copy-on-eval-updated)
    * because the depsgraph itself created or removed some of their evaluated dependencies.
@@ -7,6 +7,7 @@
  */
 
 #include "intern/debug/deg_debug.h"
+#include "intern/debug/deg_debug_eval_trace.h"
 
 #include "BLI_console.h"
 #include "BLI_hash.h"
@@ -24,9 +25,15 @@ bool DepsgraphDebug::do_time_debug() const
   return ((G.debug & G_DEBUG_DEPSGRAPH_TIME) != 0);
 }
 
+bool DepsgraphDebug::do_eval_trace() const
+{
+  /* Only in background mode, where the amount of evaluations is limited by the task at hand. */
+  return G.background && (flags & G_DEBUG_DEPSGRAPH_EVAL) != 0;
+}
+
 void DepsgraphDebug::begin_graph_evaluation()
 {
-  if (!do_time_debug()) {
+  if (!do_time_debug() && !do_eval_trace()) {
     return;
   }
 
@@ -35,13 +42,20 @@ void DepsgraphDebug::begin_graph_evaluation()
   graph_evaluation_start_time_ = current_time;
 }
 
-void DepsgraphDebug::end_graph_evaluation()
+void DepsgraphDebug::end_graph_evaluation(const Depsgraph *graph)
 {
-  if (!do_time_debug()) {
+  if (!do_time_debug() && !do_eval_trace()) {
     return;
   }
 
   const double graph_eval_end_time = BLI_time_now_seconds();
+  if (do_eval_trace()) {
+    deg_eval_trace_add_graph_evaluation(graph, graph_evaluation_start_time_, graph_eval_end_time);
+  }
+  if (!do_time_debug()) {
+    return;
+  }
+
   const double graph_eval_time = graph_eval_end_time - graph_evaluation_start_time_;
 
   if (name.empty()) {
@@ -14,14 +14,18 @@
 
 namespace blender::deg {
 
+struct Depsgraph;
+
 class DepsgraphDebug {
  public:
   DepsgraphDebug();
 
   bool do_time_debug() const;
+  /* Record a timeline of evaluated operations, see #DEG_debug_eval_trace_write_and_free. */
+  bool do_eval_trace() const;
 
   void begin_graph_evaluation();
-  void end_graph_evaluation();
+  void end_graph_evaluation(const Depsgraph *graph);
 
   /* NOTE: Corresponds to G_DEBUG_DEPSGRAPH_* flags. */
   int flags;
@@ -35,7 +39,7 @@ class DepsgraphDebug {
   static const constexpr int MAX_FPS_COUNTERS = 64;
 
   /* Point in time when last graph evaluation began.
-   * Is initialized from begin_graph_evaluation() when time debug is enabled.
+   * Is initialized from begin_graph_evaluation() when time debug or evaluation trace is enabled.
    */
   double graph_evaluation_start_time_;
 };
@@ -0,0 +1,199 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "intern/debug/deg_debug_eval_trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_enumerable_thread_specific.hh"
+#include "BLI_fileops.hh"
+#include "BLI_serialize.hh"
+#include "BLI_time.h"
+#include "BLI_vector.hh"
+
+#include "DEG_depsgraph_debug.hh"
+
+#include "intern/depsgraph.hh"
+#include "intern/node/deg_node_operation.hh"
+
+namespace blender::deg {
+
+namespace {
+
+struct TracedOperation {
+  std::string name;
+  std::string graph_name;
+  double ready_time;
+  double start_time;
+  double end_time;
+};
+
+struct TracedGraphEvaluation {
+  std::string graph_name;
+  float frame;
+  double start_time;
+  double end_time;
+};
+
+struct ThreadTrace {
+  int thread_index;
+  Vector<TracedOperation> operations;
+  Vector<TracedGraphEvaluation> graph_evaluations;
+};
+
+struct EvalTrace {
+  double start_time = BLI_time_now_seconds();
+  std::atomic<int> threads_num = 0;
+  threading::EnumerableThreadSpecific<ThreadTrace> thread_traces{[this]() {
+    ThreadTrace trace;
+    trace.thread_index = threads_num.fetch_add(1, std::memory_order_relaxed);
+    return trace;
+  }};
+};
+
+std::atomic<EvalTrace *> &eval_trace_ptr()
+{
+  static std::atomic<EvalTrace *> trace = nullptr;
+  return trace;
+}
+
+ThreadTrace &local_thread_trace()
+{
+  std::atomic<EvalTrace *> &trace_ptr = eval_trace_ptr();
+  EvalTrace *trace = trace_ptr.load(std::memory_order_acquire);
+  if (trace == nullptr) {
+    /* Created lazily on first use. Another thread might have created it at the same time. */
+    EvalTrace *new_trace = MEM_new<EvalTrace>(__func__);
+    if (trace_ptr.compare_exchange_strong(trace, new_trace)) {
+      trace = new_trace;
+    }
+    else {
+      MEM_delete(new_trace);
+    }
+  }
+  return trace->thread_traces.local();
+}
+
+std::string graph_name(const Depsgraph *graph)
+{
+  if (graph->debug.name.empty()) {
+    return "Depsgraph";
+  }
+  return graph->debug.name;
+}
+
+double to_microseconds(const double time)
+{
+  return time * 1e6;
+}
+
+}  // namespace
+
+void deg_eval_trace_add_operation(const Depsgraph *graph,
+                                  const OperationNode *operation_node,
+                                  const double ready_time,
+                                  const double start_time,
+                                  const double end_time)
+{
+  ThreadTrace &trace = local_thread_trace();
+  trace.operations.append({operation_node->full_identifier(),
+                           graph_name(graph),
+                           ready_time == 0.0 ? start_time : ready_time,
+                           start_time,
+                           end_time});
+}
+
+void deg_eval_trace_add_graph_evaluation(const Depsgraph *graph,
+                                         const double start_time,
+                                         const double end_time)
+{
+  ThreadTrace &trace = local_thread_trace();
+  trace.graph_evaluations.append({graph_name(graph), graph->frame, start_time, end_time});
+}
+
+}  // namespace blender::deg
+
+namespace deg = blender::deg;
+namespace serialize = blender::io::serialize;
+
+void DEG_debug_eval_trace_write_and_free()
+{
+  deg::EvalTrace *trace = deg::eval_trace_ptr().exchange(nullptr);
+  if (trace == nullptr) {
+    return;
+  }
+
+  blender::Vector<const deg::ThreadTrace *> thread_traces;
+  for (const deg::ThreadTrace &thread_trace : trace->thread_traces) {
+    thread_traces.append(&thread_trace);
+  }
+  std::sort(thread_traces.begin(),
+            thread_traces.end(),
+            [](const deg::ThreadTrace *a, const deg::ThreadTrace *b) {
+              return a->thread_index < b->thread_index;
+            });
+
+  serialize::DictionaryValue root;
+  serialize::ArrayValue &events = *root.append_array("traceEvents");
+  int64_t operations_num = 0;
+  double wait_time = 0.0;
+  for (const deg::ThreadTrace *thread_trace : thread_traces) {
+    std::shared_ptr<serialize::DictionaryValue> thread_name = events.append_dict();
+    thread_name->append_str("name", "thread_name");
+    thread_name->append_str("ph", "M");
+    thread_name->append_int("pid", 1);
+    thread_name->append_int("tid", thread_trace->thread_index);
+    thread_name->append_dict("args")->append_str(
+        "name", "Thread " + std::to_string(thread_trace->thread_index));
+
+    for (const deg::TracedGraphEvaluation &evaluation : thread_trace->graph_evaluations) {
+      std::shared_ptr<serialize::DictionaryValue> event = events.append_dict();
+      event->append_str("name", evaluation.graph_name);
+      event->append_str("cat", "graph");
+      event->append_str("ph", "X");
+      event->append_double("ts", deg::to_microseconds(evaluation.start_time - trace->start_time));
+      event->append_double("dur",
+                           deg::to_microseconds(evaluation.end_time - evaluation.start_time));
+      event->append_int("pid", 1);
+      event->append_int("tid", thread_trace->thread_index);
+      event->append_dict("args")->append_double("frame", evaluation.frame);
+    }
+    for (const deg::TracedOperation &operation : thread_trace->operations) {
+      std::shared_ptr<serialize::DictionaryValue> event = events.append_dict();
+      event->append_str("name", operation.name);
+      event->append_str("cat", "operation");
+      event->append_str("ph", "X");
+      event->append_double("ts", deg::to_microseconds(operation.start_time - trace->start_time));
+      event->append_double("dur", deg::to_microseconds(operation.end_time - operation.start_time));
+      event->append_int("pid", 1);
+      event->append_int("tid", thread_trace->thread_index);
+      std::shared_ptr<serialize::DictionaryValue> args = event->append_dict("args");
+      args->append_str("depsgraph", operation.graph_name);
+      args->append_double("wait_us",
+                          deg::to_microseconds(operation.start_time - operation.ready_time));
+      operations_num++;
+      wait_time += operation.start_time - operation.ready_time;
+    }
+  }
+
+  const char *filepath = "depsgraph_eval_trace.json";
+  blender::fstream file(filepath, std::ios::out);
+  serialize::JsonFormatter formatter;
+  formatter.serialize(file, root);
+  printf("Wrote %s: %lld operations on %d threads, %f seconds waiting for a thread.\n",
+         filepath,
+         (long long)operations_num,
+         int(thread_traces.size()),
+         wait_time);
+
+  MEM_delete(trace);
+}
@@ -0,0 +1,35 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ *
+ * Timeline of evaluated operations, which is recorded when evaluation debugging is enabled in
+ * background mode. See #DEG_debug_eval_trace_write_and_free.
+ */
+
+#pragma once
+
+namespace blender::deg {
+
+struct Depsgraph;
+struct OperationNode;
+
+/**
+ * Record evaluation of an operation. All times are in seconds as returned by
+ * #BLI_time_now_seconds. The ready time is when all dependencies of the operation were evaluated,
+ * zero if unknown.
+ */
+void deg_eval_trace_add_operation(const Depsgraph *graph,
+                                  const OperationNode *operation_node,
+                                  double ready_time,
+                                  double start_time,
+                                  double end_time);
+
+/** Record evaluation of the entire graph. */
+void deg_eval_trace_add_graph_evaluation(const Depsgraph *graph,
+                                         double start_time,
+                                         double end_time);
+
+}  // namespace blender::deg
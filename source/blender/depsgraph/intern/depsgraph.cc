@@ -43,6 +43,8 @@ Depsgraph::Depsgraph(Main *bmain, Scene *scene, ViewLayer *view_layer, eEvaluati
       has_animated_visibility(false),
       need_update_relations(true),
       need_update_nodes_visibility(true),
+      need_update_operation_priorities(true),
+      evaluations_until_cost_sampling(0),
       need_tag_id_on_graph_visibility_update(true),
       need_tag_id_on_graph_visibility_time_update(false),
       bmain(bmain),
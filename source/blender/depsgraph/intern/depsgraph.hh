@@ -101,6 +101,13 @@ struct Depsgraph {
   /* Indicates whether indirect effect of nodes on a directly visible ones needs to be updated. */
   bool need_update_nodes_visibility;
 
+  /* Indicates whether scheduling priorities of operations need to be updated, because relations or
+   * cost estimates of operations changed. */
+  bool need_update_operation_priorities;
+
+  /* Number of evaluations left until evaluation time of operations is measured again. */
+  int evaluations_until_cost_sampling;
+
   /* Indicated whether IDs in this graph are to be tagged as if they first appear visible, with
    * an optional tag for their animation (time) update. */
   bool need_tag_id_on_graph_visibility_update;
@@ -8,14 +8,23 @@
  * Evaluation engine entry-points for Depsgraph Engine.
  */
 
+#include "BLI_array.hh"
+#include "BLI_task.h"
+
 #include "BKE_scene.hh"
 
 #include "DNA_scene_types.h"
 
 #include "DEG_depsgraph.hh"
+#include "DEG_depsgraph_build.hh"
+#include "DEG_depsgraph_parallel_frames.hh"
 #include "DEG_depsgraph_query.hh"
 #include "DEG_depsgraph_writeback_sync.hh"
 
+#ifdef WITH_PYTHON
+#  include "BPY_extern.hh"
+#endif
+
 #include "intern/eval/deg_eval.h"
 #include "intern/eval/deg_eval_flush.h"
 
@@ -85,3 +94,79 @@ void DEG_evaluate_on_framechange(Depsgraph *graph,
   deg_graph->ctime = BKE_scene_frame_to_ctime(scene, frame);
   deg_flush_updates_and_refresh(deg_graph, sync_writeback);
 }
+
+namespace {
+
+struct FrameEvaluationTask {
+  Depsgraph *depsgraph;
+  float frame;
+};
+
+}  // namespace
+
+static void evaluate_frame_task(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  const FrameEvaluationTask *task = static_cast<const FrameEvaluationTask *>(taskdata);
+  BLI_assert(!DEG_is_active(task->depsgraph));
+  DEG_evaluate_on_framechange(task->depsgraph, task->frame);
+}
+
+void DEG_evaluate_frames_parallel(
+    const blender::Span<Depsgraph *> depsgraphs,
+    const blender::Span<float> frames,
+    const blender::FunctionRef<bool(Depsgraph *depsgraph, float frame)> frame_fn)
+{
+  using namespace blender;
+  BLI_assert(!depsgraphs.is_empty());
+  const int64_t graphs_num = depsgraphs.size();
+
+  for (Depsgraph *depsgraph : depsgraphs) {
+    DEG_graph_relations_update(depsgraph);
+  }
+
+  /* Use a separate pool for every dependency graph, so that evaluation of a specific frame can be
+   * waited for. */
+  Array<TaskPool *> task_pools(graphs_num);
+  Array<FrameEvaluationTask> tasks(graphs_num);
+  for (const int64_t i : depsgraphs.index_range()) {
+    task_pools[i] = BLI_task_pool_create(nullptr, TASK_PRIORITY_HIGH);
+  }
+
+  const auto start_frame_evaluation = [&](const int64_t frame_index) {
+    const int64_t graph_index = frame_index % graphs_num;
+    tasks[graph_index] = {depsgraphs[graph_index], frames[frame_index]};
+    BLI_task_pool_push(
+        task_pools[graph_index], evaluate_frame_task, &tasks[graph_index], false, nullptr);
+  };
+  const auto wait_for_graph = [&](const int64_t graph_index) {
+#ifdef WITH_PYTHON
+    /* Python drivers are evaluated on other threads. */
+    BPy_BEGIN_ALLOW_THREADS;
+#endif
+    BLI_task_pool_work_and_wait(task_pools[graph_index]);
+#ifdef WITH_PYTHON
+    BPy_END_ALLOW_THREADS;
+#endif
+  };
+
+  for (const int64_t frame_index : frames.index_range().take_front(graphs_num)) {
+    start_frame_evaluation(frame_index);
+  }
+  for (const int64_t frame_index : frames.index_range()) {
+    const int64_t graph_index = frame_index % graphs_num;
+    wait_for_graph(graph_index);
+    if (!frame_fn(depsgraphs[graph_index], frames[frame_index])) {
+      break;
+    }
+    /* The graph is not used anymore, so it can evaluate the next frame that it is responsible
+     * for. */
+    if (frame_index + graphs_num < frames.size()) {
+      start_frame_evaluation(frame_index + graphs_num);
+    }
+  }
+
+  for (const int64_t i : depsgraphs.index_range()) {
+    wait_for_graph(i);
+    BLI_task_pool_free(task_pools[i]);
+  }
+}
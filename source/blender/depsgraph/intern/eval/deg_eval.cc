@@ -10,9 +10,12 @@
 
 #include <atomic>
 #include <cstdint>
+#include <mutex>
+#include <queue>
 
 #include "intern/eval/deg_eval.h"
 
+#include "BLI_array.hh"
 #include "BLI_function_ref.hh"
 #include "BLI_gsqueue.h"
 #include "BLI_task.h"
@@ -32,11 +35,13 @@
 
 #include "atomic_ops.h"
 
+#include "intern/debug/deg_debug_eval_trace.h"
 #include "intern/depsgraph.hh"
 #include "intern/depsgraph_relation.hh"
 #include "intern/depsgraph_tag.hh"
 #include "intern/eval/deg_eval_copy_on_write.h"
 #include "intern/eval/deg_eval_flush.h"
+#include "intern/eval/deg_eval_priority.h"
 #include "intern/eval/deg_eval_stats.h"
 #include "intern/eval/deg_eval_visibility.h"
 #include "intern/node/deg_node.hh"
@@ -76,25 +81,119 @@ enum class EvaluationStage {
   SINGLE_THREADED_WORKAROUND,
 };
 
+struct ReadyOperation {
+  OperationNode *node;
+  /* Time at which the operation became ready, only known when tracing the evaluation. */
+  double ready_time;
+};
+
+/* Operations which are ready to be evaluated by the threaded evaluation. Tasks in the pool take
+ * the operation with the highest priority from this queue instead of evaluating the operation that
+ * caused the task to be pushed. This way operations on the critical path are not delayed by
+ * cheaper operations which happen to become ready earlier.
+ *
+ * Every thread pushes to and pops from its own queue, so that threads don't contend for a single
+ * lock. Children of an operation are mostly evaluated by the thread which evaluated it, which
+ * keeps the chains on the critical path together. A thread whose queue is empty takes the
+ * operation with the highest priority of the first other queue that is not empty. */
+class ReadyOperationQueue {
+ private:
+  struct PriorityCompare {
+    bool operator()(const ReadyOperation &a, const ReadyOperation &b) const
+    {
+      return a.node->priority < b.node->priority;
+    }
+  };
+
+  /* Aligned to avoid false sharing between threads. */
+  struct alignas(64) ThreadQueue {
+    std::mutex mutex;
+    std::priority_queue<ReadyOperation, std::vector<ReadyOperation>, PriorityCompare> queue;
+    /* Allows skipping empty queues without locking them. */
+    std::atomic<int> size = 0;
+  };
+
+  Array<ThreadQueue> queues_;
+
+  int thread_queue_index() const
+  {
+    static std::atomic<int> thread_index_source = 0;
+    static thread_local const int thread_index = thread_index_source.fetch_add(1);
+    return thread_index % queues_.size();
+  }
+
+ public:
+  ReadyOperationQueue() : queues_(std::max(BLI_task_scheduler_num_threads(), 1)) {}
+
+  void push(const ReadyOperation &operation)
+  {
+    ThreadQueue &thread_queue = queues_[this->thread_queue_index()];
+    std::lock_guard lock{thread_queue.mutex};
+    thread_queue.queue.push(operation);
+    thread_queue.size.store(thread_queue.queue.size(), std::memory_order_relaxed);
+  }
+
+  /* Every pop corresponds to an earlier push, so there always is an operation to take. It might
+   * only be pushed to a queue which was checked already though, in which case all queues are
+   * checked again. */
+  ReadyOperation pop()
+  {
+    const int start_index = this->thread_queue_index();
+    while (true) {
+      for (const int i : queues_.index_range()) {
+        ThreadQueue &thread_queue = queues_[(start_index + i) % queues_.size()];
+        if (thread_queue.size.load(std::memory_order_relaxed) == 0) {
+          continue;
+        }
+        std::lock_guard lock{thread_queue.mutex};
+        if (thread_queue.queue.empty()) {
+          continue;
+        }
+        const ReadyOperation operation = thread_queue.queue.top();
+        thread_queue.queue.pop();
+        thread_queue.size.store(thread_queue.queue.size(), std::memory_order_relaxed);
+        return operation;
+      }
+    }
+  }
+};
+
 struct DepsgraphEvalState {
   Depsgraph *graph;
   bool do_stats;
+  /* Measure evaluation time of operations to update their cost estimates. */
+  bool do_cost_sampling = false;
+  /* Record evaluated operations into the evaluation trace. */
+  bool do_trace = false;
+  ReadyOperationQueue ready_operations;
   EvaluationStage stage;
   bool need_update_pending_parents = true;
   bool need_single_thread_pass = false;
 };
 
-void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_node)
+void evaluate_node(const DepsgraphEvalState *state,
+                   OperationNode *operation_node,
+                   const double ready_time = 0.0)
 {
   ::Depsgraph *depsgraph = reinterpret_cast<::Depsgraph *>(state->graph);
 
   /* Sanity checks. */
   BLI_assert_msg(!operation_node->is_noop(), "NOOP nodes should not actually be scheduled");
   /* Perform operation. */
-  if (state->do_stats) {
+  if (state->do_stats || state->do_cost_sampling || state->do_trace) {
     const double start_time = BLI_time_now_seconds();
     operation_node->evaluate(depsgraph);
-    operation_node->stats.current_time += BLI_time_now_seconds() - start_time;
+    const double end_time = BLI_time_now_seconds();
+    const double time = end_time - start_time;
+    if (state->do_stats) {
+      operation_node->stats.current_time += time;
+    }
+    if (state->do_cost_sampling) {
+      deg_eval_priority_record_cost(operation_node, time);
+    }
+    if (state->do_trace) {
+      deg_eval_trace_add_operation(state->graph, operation_node, ready_time, start_time, end_time);
+    }
   }
   else {
     operation_node->evaluate(depsgraph);
@@ -107,18 +206,26 @@ void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_nod
   operation_node->flag &= ~DEPSOP_FLAG_CLEAR_ON_EVAL;
 }
 
-void deg_task_run_func(TaskPool *pool, void *taskdata)
+void schedule_node_to_task_pool(DepsgraphEvalState *state, TaskPool *pool, OperationNode *node)
+{
+  /* Every task evaluates exactly one operation, but not necessarily the given one. */
+  state->ready_operations.push({node, state->do_trace ? BLI_time_now_seconds() : 0.0});
+  BLI_task_pool_push(pool, deg_task_run_func, nullptr, false, nullptr);
+}
+
+void deg_task_run_func(TaskPool *pool, void * /*taskdata*/)
 {
   void *userdata_v = BLI_task_pool_user_data(pool);
   DepsgraphEvalState *state = (DepsgraphEvalState *)userdata_v;
 
-  /* Evaluate node. */
-  OperationNode *operation_node = reinterpret_cast<OperationNode *>(taskdata);
-  evaluate_node(state, operation_node);
+  /* Evaluate the ready node with the highest priority. */
+  const ReadyOperation ready_operation = state->ready_operations.pop();
+  OperationNode *operation_node = ready_operation.node;
+  evaluate_node(state, operation_node, ready_operation.ready_time);
 
   /* Schedule children. */
   schedule_children(state, operation_node, [&](OperationNode *node) {
-    BLI_task_pool_push(pool, deg_task_run_func, node, false, nullptr);
+    schedule_node_to_task_pool(state, pool, node);
   });
 }
 
@@ -316,9 +423,8 @@ void evaluate_graph_threaded_stage(DepsgraphEvalState *state,
 
   calculate_pending_parents_if_needed(state);
 
-  schedule_graph(state, [&](OperationNode *node) {
-    BLI_task_pool_push(task_pool, deg_task_run_func, node, false, nullptr);
-  });
+  schedule_graph(state,
+                 [&](OperationNode *node) { schedule_node_to_task_pool(state, task_pool, node); });
   BLI_task_pool_work_and_wait(task_pool);
 }
 
@@ -410,6 +516,21 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   DepsgraphEvalState state;
   state.graph = graph;
   state.do_stats = graph->debug.do_time_debug();
+  state.do_trace = graph->debug.do_eval_trace();
+
+  /* Prioritize operations on the critical path, based on costs measured in earlier evaluations.
+   * Measuring is only done periodically to keep the overhead low. */
+  if (graph->need_update_operation_priorities) {
+    deg_eval_priority_update(graph);
+    graph->need_update_operation_priorities = false;
+  }
+  if (graph->evaluations_until_cost_sampling <= 0) {
+    state.do_cost_sampling = true;
+    graph->evaluations_until_cost_sampling = DEG_EVAL_COST_SAMPLING_INTERVAL;
+  }
+  else {
+    graph->evaluations_until_cost_sampling--;
+  }
 
   /* Prepare all nodes for evaluation. */
   initialize_execution(&state, graph);
@@ -464,6 +585,9 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   if (state.do_stats) {
     deg_eval_stats_aggregate(graph);
   }
+  if (state.do_cost_sampling) {
+    graph->need_update_operation_priorities = true;
+  }
 
   /* Clear any uncleared tags. */
   deg_graph_clear_tags(graph);
@@ -473,7 +597,7 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   BPy_END_ALLOW_THREADS;
 #endif
 
-  graph->debug.end_graph_evaluation();
+  graph->debug.end_graph_evaluation(graph);
 }
 
 }  // namespace blender::deg
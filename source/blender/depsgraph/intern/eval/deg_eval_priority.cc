@@ -0,0 +1,93 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "intern/eval/deg_eval_priority.h"
+
+#include <algorithm>
+
+#include "BLI_stack.hh"
+
+#include "intern/depsgraph.hh"
+#include "intern/depsgraph_relation.hh"
+#include "intern/node/deg_node.hh"
+#include "intern/node/deg_node_operation.hh"
+
+namespace blender::deg {
+
+/* Cost of operations which have not been measured yet. Small, so that it mainly affects the
+ * priority of long chains of operations. */
+static constexpr float DEFAULT_OPERATION_COST = 1e-6f;
+
+/* Weight of a new measurement in the cost estimate, smooths out noise in the measurements. */
+static constexpr float COST_SMOOTHING_FACTOR = 0.25f;
+
+void deg_eval_priority_record_cost(OperationNode *operation_node, const double time)
+{
+  if (operation_node->cost == 0.0f) {
+    operation_node->cost = float(time);
+  }
+  else {
+    operation_node->cost += (float(time) - operation_node->cost) * COST_SMOOTHING_FACTOR;
+  }
+}
+
+static bool is_priority_relation(const Relation *rel)
+{
+  return rel->from->type == NodeType::OPERATION && rel->to->type == NodeType::OPERATION &&
+         (rel->flag & RELATION_FLAG_CYCLIC) == 0;
+}
+
+static float operation_cost(const OperationNode *operation_node)
+{
+  if (operation_node->is_noop()) {
+    return 0.0f;
+  }
+  if (operation_node->cost == 0.0f) {
+    return DEFAULT_OPERATION_COST;
+  }
+  return operation_node->cost;
+}
+
+void deg_eval_priority_update(Depsgraph *graph)
+{
+  /* Visit operations in reverse topological order, so that the priorities of all operations which
+   * depend on an operation are known when it is visited. The custom flags are used to count the
+   * number of dependent operations which have not been visited yet. Relations which are closing
+   * a dependency cycle are ignored. */
+  Stack<OperationNode *> ready_operations;
+  for (OperationNode *operation_node : graph->operations) {
+    operation_node->priority = 0.0f;
+    operation_node->custom_flags = 0;
+    for (const Relation *rel : operation_node->outlinks) {
+      if (is_priority_relation(rel)) {
+        operation_node->custom_flags++;
+      }
+    }
+    if (operation_node->custom_flags == 0) {
+      ready_operations.push(operation_node);
+    }
+  }
+
+  while (!ready_operations.is_empty()) {
+    OperationNode *operation_node = ready_operations.pop();
+    operation_node->priority += operation_cost(operation_node);
+    for (Relation *rel : operation_node->inlinks) {
+      if (!is_priority_relation(rel)) {
+        continue;
+      }
+      OperationNode *parent_node = static_cast<OperationNode *>(rel->from);
+      parent_node->priority = std::max(parent_node->priority, operation_node->priority);
+      parent_node->custom_flags--;
+      if (parent_node->custom_flags == 0) {
+        ready_operations.push(parent_node);
+      }
+    }
+  }
+}
+
+}  // namespace blender::deg
@@ -0,0 +1,30 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ *
+ * Critical-path based priorities for scheduling operations during threaded evaluation.
+ */
+
+#pragma once
+
+namespace blender::deg {
+
+struct Depsgraph;
+struct OperationNode;
+
+/* Number of evaluations after which the evaluation time of operations is measured again. Keeps the
+ * overhead of timing every operation low, while still adapting to changes in the scene. */
+constexpr int DEG_EVAL_COST_SAMPLING_INTERVAL = 8;
+
+/* Accumulate measured evaluation time of an operation into its cost estimate. */
+void deg_eval_priority_record_cost(OperationNode *operation_node, double time);
+
+/* Update the priority of all operations from their cost estimates. The priority of an operation
+ * is the estimated time of the longest chain of operations that starts at it, so that the
+ * operations on the critical path of the graph are evaluated as early as possible. */
+void deg_eval_priority_update(Depsgraph *graph);
+
+}  // namespace blender::deg
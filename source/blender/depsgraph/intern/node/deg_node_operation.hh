@@ -285,6 +285,13 @@ struct OperationNode : public Node {
   uint32_t num_links_pending;
   bool scheduled;
 
+  /* Estimated evaluation time in seconds, measured during previous evaluations.
+   * Zero when the operation has not been measured yet. */
+  float cost;
+  /* Estimated time of the longest chain of operations starting at this operation. Ready operations
+   * with a higher priority are evaluated first. See #deg_eval_priority_update. */
+  float priority;
+
   /* Identifier for the operation being performed. */
   OperationCode opcode;
   int name_tag;
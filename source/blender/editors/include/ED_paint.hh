@@ -61,6 +61,8 @@ bool ED_paint_proj_mesh_data_check(Scene &scene,
                                    bool *r_has_mat,
                                    bool *r_has_tex,
                                    bool *r_has_stencil);
+/** Free the pixels kept between strokes for #IMAGEPAINT_PROJECT_COVERAGE_CACHE. */
+void ED_paint_proj_coverage_cache_free();
 
 /* `image_undo.cc` */
 
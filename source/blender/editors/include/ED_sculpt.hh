@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 struct Depsgraph;
 struct Main;
 struct Mesh;
@@ -15,6 +17,7 @@ struct Object;
 struct RegionView3D;
 struct ReportList;
 struct Scene;
+struct UndoStack;
 struct UndoType;
 struct bContext;
 struct wmKeyConfig;
@@ -74,6 +77,12 @@ void geometry_end(Object &ob);
 void push_multires_mesh_begin(bContext *C, const char *str);
 void push_multires_mesh_end(bContext *C, const char *str);
 
+/**
+ * The memory used by the sculpt undo steps in the undo stack. Steps are compressed in the
+ * background after they are pushed, their compressed size is used once that is done.
+ */
+size_t memory_in_bytes(UndoStack &ustack);
+
 }  // namespace undo
 
 namespace face_set {
@@ -126,6 +126,7 @@ static wmOperatorStatus wm_alembic_export_exec(bContext *C, wmOperator *op)
   params.quad_method = RNA_enum_get(op->ptr, "quad_method");
   params.ngon_method = RNA_enum_get(op->ptr, "ngon_method");
   params.evaluation_mode = eEvaluationMode(RNA_enum_get(op->ptr, "evaluation_mode"));
+  params.parallel_frames = RNA_int_get(op->ptr, "parallel_frames");
 
   params.global_scale = RNA_float_get(op->ptr, "global_scale");
 
@@ -192,6 +193,7 @@ static void ui_alembic_export_settings(const bContext *C, uiLayout *layout, Poin
 
     col = uiLayoutColumn(panel, true);
     uiItemR(col, ptr, "evaluation_mode", UI_ITEM_NONE, std::nullopt, ICON_NONE);
+    uiItemR(col, ptr, "parallel_frames", UI_ITEM_NONE, std::nullopt, ICON_NONE);
   }
 
   /* Object Data */
@@ -471,6 +473,19 @@ void WM_OT_alembic_export(wmOperatorType *ot)
                "Determines visibility of objects, modifier settings, and other areas where there "
                "are different settings for viewport and rendering");
 
+  RNA_def_int(ot->srna,
+              "parallel_frames",
+              1,
+              1,
+              16,
+              "Parallel Frames",
+              "Number of animation frames that are evaluated at the same time. Each of them uses "
+              "its own copy of the scene data, so memory usage increases accordingly. Only use "
+              "this when the animation does not depend on previous frames, e.g. no simulations "
+              "or particles, and frame change handlers are not needed",
+              1,
+              8);
+
   /* This dummy prop is used to check whether we need to init the start and
    * end frame values to that of the scene's, otherwise they are reset at
    * every change, draw update. */
@@ -294,6 +294,7 @@ static wmOperatorStatus wm_usd_export_exec(bContext *C, wmOperator *op)
 
   const bool use_instancing = RNA_boolean_get(op->ptr, "use_instancing");
   const bool evaluation_mode = RNA_enum_get(op->ptr, "evaluation_mode");
+  const int parallel_frames = RNA_int_get(op->ptr, "parallel_frames");
 
   const bool generate_preview_surface = RNA_boolean_get(op->ptr, "generate_preview_surface");
   const bool generate_materialx_network = RNA_boolean_get(op->ptr, "generate_materialx_network");
@@ -396,6 +397,7 @@ static wmOperatorStatus wm_usd_export_exec(bContext *C, wmOperator *op)
 
   params.export_subdiv = export_subdiv;
   params.evaluation_mode = eEvaluationMode(evaluation_mode);
+  params.parallel_frames = parallel_frames;
 
   params.generate_preview_surface = generate_preview_surface;
   params.generate_materialx_network = generate_materialx_network;
@@ -475,6 +477,9 @@ static void wm_usd_export_draw(bContext *C, wmOperator *op)
 
     col = uiLayoutColumn(panel, false);
     uiItemR(col, ptr, "evaluation_mode", UI_ITEM_NONE, std::nullopt, ICON_NONE);
+    uiLayout *row = uiLayoutRow(col, false);
+    uiItemR(row, ptr, "parallel_frames", UI_ITEM_NONE, std::nullopt, ICON_NONE);
+    uiLayoutSetActive(row, RNA_boolean_get(ptr, "export_animation"));
   }
 
   if (uiLayout *panel = uiLayoutPanel(
@@ -721,6 +726,19 @@ void WM_OT_usd_export(wmOperatorType *ot)
                "Determines visibility of objects, modifier settings, and other areas where there "
                "are different settings for viewport and rendering");
 
+  RNA_def_int(ot->srna,
+              "parallel_frames",
+              1,
+              1,
+              16,
+              "Parallel Frames",
+              "Number of animation frames that are evaluated at the same time. Each of them uses "
+              "its own copy of the scene data, so memory usage increases accordingly. Only use "
+              "this when the animation does not depend on previous frames, e.g. no simulations "
+              "or particles, and frame change handlers are not needed",
+              1,
+              8);
+
   RNA_def_boolean(ot->srna,
                   "generate_preview_surface",
                   true,
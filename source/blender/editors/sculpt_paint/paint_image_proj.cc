@@ -12,6 +12,7 @@
 #include <climits>
 #include <cmath>
 #include <cstring>
+#include <memory>
 
 #include "MEM_guardedalloc.h"
 
@@ -19,20 +20,24 @@
 #  include "BLI_winstuff.h"
 #endif
 
+#include "BLI_array.hh"
 #include "BLI_linklist.h"
 #include "BLI_listbase.h"
 #include "BLI_math_base_safe.h"
 #include "BLI_math_bits.h"
 #include "BLI_math_color_blend.h"
 #include "BLI_math_geom.h"
+#include "BLI_math_matrix_types.hh"
 #include "BLI_math_vector.hh"
 #include "BLI_memarena.h"
 #include "BLI_rect.h"
 #include "BLI_string.h"
 #include "BLI_string_utf8.h"
+#include "BLI_struct_equality_utils.hh"
 #include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "atomic_ops.h"
 
@@ -74,6 +79,7 @@
 #include "BKE_node_legacy_types.hh"
 #include "BKE_node_runtime.hh"
 #include "BKE_object.hh"
+#include "BKE_object_types.hh"
 #include "BKE_paint.hh"
 #include "BKE_report.hh"
 #include "BKE_scene.hh"
@@ -254,6 +260,105 @@ struct LoopSeamData {
   float corner_dist_sq[2];
 };
 
+/**
+ * A pixel found by #project_paint_face_init, with everything needed to initialize it again
+ * without clipping, rasterizing and occlusion testing the faces of its bucket.
+ */
+struct ProjCoveragePixel {
+  int x_px, y_px;
+  int tri_index;
+  int image_index;
+  blender::float2 co;
+  blender::float3 world_co;
+  /** Barycentric weights of the pixel in its triangle. */
+  blender::float3 w;
+  /** See #project_paint_uvpixel_mask_normal. */
+  float mask_normal;
+};
+
+struct ProjBucketCoverage {
+  /** The triangles of the bucket and their image index when the pixels were found. */
+  blender::Vector<blender::int2> faces;
+  /** In the order they were added to the bucket. */
+  blender::Vector<ProjCoveragePixel> pixels;
+};
+
+struct ProjCoverageImage {
+  const Image *ima;
+  int tile;
+  const ImBuf *ibuf;
+  blender::int2 size;
+
+  BLI_STRUCT_EQUALITY_OPERATORS_4(ProjCoverageImage, ima, tile, ibuf, size)
+};
+
+/**
+ * Everything the pixels of a bucket depend on, other than the triangles of the bucket
+ * which are stored per bucket since face selection and hiding doesn't change the geometry.
+ */
+struct ProjCoverageKey {
+  const Depsgraph *depsgraph;
+  const Object *ob;
+  uint64_t last_update_geometry;
+  blender::float4x4 project_mat;
+  blender::int2 win_size;
+  blender::float2 screen_min;
+  blender::float2 screen_max;
+  blender::int2 buckets_num;
+  bool do_occlude;
+  bool do_backfacecull;
+  bool do_mask_normal;
+  bool do_3d_mapping;
+  float normal_angle;
+  float normal_angle_inner;
+  float seam_bleed_px;
+  blender::Vector<ProjCoverageImage> images;
+  /** The distinct UV layers used by the faces, in the order they are first used. */
+  blender::Vector<const float (*)[2]> uv_layers;
+  /** The index in #uv_layers of each face, empty when all faces use the same layer. */
+  blender::Array<int> face_uv_layers;
+
+  friend bool operator==(const ProjCoverageKey &a, const ProjCoverageKey &b)
+  {
+    return a.depsgraph == b.depsgraph && a.ob == b.ob &&
+           a.last_update_geometry == b.last_update_geometry && a.project_mat == b.project_mat &&
+           a.win_size == b.win_size && a.screen_min == b.screen_min &&
+           a.screen_max == b.screen_max && a.buckets_num == b.buckets_num &&
+           a.do_occlude == b.do_occlude && a.do_backfacecull == b.do_backfacecull &&
+           a.do_mask_normal == b.do_mask_normal && a.do_3d_mapping == b.do_3d_mapping &&
+           a.normal_angle == b.normal_angle && a.normal_angle_inner == b.normal_angle_inner &&
+           a.seam_bleed_px == b.seam_bleed_px && a.images == b.images &&
+           a.uv_layers == b.uv_layers && a.face_uv_layers == b.face_uv_layers;
+  }
+};
+
+/**
+ * Total number of pixels in all #ProjCoverageCache, accessed with atomic operations.
+ * See #PROJ_COVERAGE_CACHE_MEMORY_MAX.
+ */
+static int64_t coverage_caches_pixels_num = 0;
+
+/**
+ * Initializing a bucket clips, rasterizes and occlusion tests all of its faces, which is most of
+ * the time spent in the first dabs of a stroke. With #IMAGEPAINT_PROJECT_COVERAGE_CACHE the
+ * pixels found for each bucket are kept after the stroke, so later strokes from the same view
+ * only have to evaluate the masks that depend on image content (stencil layer and cavity).
+ */
+struct ProjCoverageCache {
+  ProjCoverageKey key;
+  /** Null for the buckets that weren't initialized yet. */
+  blender::Array<std::unique_ptr<ProjBucketCoverage>> buckets;
+  /** Total number of pixels in #buckets, accessed with atomic operations. */
+  int64_t pixels_num = 0;
+  /** Set when a stroke uses the cache, caches not used by the last stroke are freed. */
+  bool used = false;
+
+  ~ProjCoverageCache()
+  {
+    atomic_sub_and_fetch_int64(&coverage_caches_pixels_num, pixels_num);
+  }
+};
+
 /* Main projection painting struct passed to all projection painting functions */
 struct ProjPaintState {
   View3D *v3d;
@@ -342,6 +447,8 @@ struct ProjPaintState {
   bool do_mask_normal;
   /** mask out pixels based on cavity. */
   bool do_mask_cavity;
+  /** Keep the pixels found for each bucket between strokes, see #ProjCoverageCache. */
+  bool do_coverage_cache;
   /** what angle to mask at. */
   float normal_angle;
   /** cos(normal_angle), faster to compare. */
@@ -389,12 +496,21 @@ struct ProjPaintState {
   int thread_tot;
   int bucketMin[2];
   int bucketMax[2];
-  /** must lock threads while accessing these. */
-  int context_bucket_index;
+  /** Indices of the buckets painted by the current dab, see #project_bucket_iter_init. */
+  blender::Vector<int> dab_buckets;
+  /**
+   * The range of #dab_buckets left to each thread, packed as `(start << 32) | end`.
+   * Threads take buckets from the start of their own range, and from the end of the ranges of
+   * other threads once theirs is empty. Must be accessed with atomic operations.
+   */
+  uint64_t thread_bucket_ranges[BLENDER_MAX_THREADS];
 
   CurveMapping *cavity_curve;
   BlurKernel *blurkernel;
 
+  /** Pixels found in earlier strokes with the same view, null when not used. */
+  ProjCoverageCache *coverage_cache;
+
   /* -------------------------------------------------------------------- */
   /* Vars shared between multiple views (keep last) */
   /**
@@ -427,8 +543,6 @@ struct ProjPaintState {
   ListBase *vertSeams;
 #endif
 
-  SpinLock *tile_lock;
-
   Mesh *mesh_eval;
   int totloop_eval;
   int faces_num_eval;
@@ -511,7 +625,6 @@ struct ProjPixelClone {
 
 /* undo tile pushing */
 struct TileInfo {
-  SpinLock *lock;
   bool masked;
   ushort tile_width;
   ImBuf **tmpibuf;
@@ -1643,10 +1756,93 @@ static void project_face_pixel(
   }
 }
 
-/* run this outside project_paint_uvpixel_init since pixels with mask 0 don't need init */
+/**
+ * The part of the pixel mask that only depends on the view and the mesh,
+ * so it can be stored in #ProjCoverageCache.
+ */
+static float project_paint_uvpixel_mask_normal(const ProjPaintState *ps,
+                                               const int tri_index,
+                                               const float w[3])
+{
+  if (!ps->do_mask_normal) {
+    return 1.0f;
+  }
+
+  const int3 &tri = ps->corner_tris_eval[tri_index];
+  const int face_i = ps->corner_tri_faces_eval[tri_index];
+  const int vert_tri[3] = {PS_CORNER_TRI_AS_VERT_INDEX_3(ps, tri)};
+  float no[3], angle_cos;
+
+  if (!(ps->sharp_faces_eval && ps->sharp_faces_eval[face_i])) {
+    const float *no1, *no2, *no3;
+    no1 = ps->vert_normals[vert_tri[0]];
+    no2 = ps->vert_normals[vert_tri[1]];
+    no3 = ps->vert_normals[vert_tri[2]];
+
+    no[0] = w[0] * no1[0] + w[1] * no2[0] + w[2] * no3[0];
+    no[1] = w[0] * no1[1] + w[1] * no2[1] + w[2] * no3[1];
+    no[2] = w[0] * no1[2] + w[1] * no2[2] + w[2] * no3[2];
+    normalize_v3(no);
+  }
+  else {
+    /* In case the normalizing per pixel isn't optimal,
+     * we could cache or access from evaluated mesh. */
+    normal_tri_v3(no,
+                  ps->vert_positions_eval[vert_tri[0]],
+                  ps->vert_positions_eval[vert_tri[1]],
+                  ps->vert_positions_eval[vert_tri[2]]);
+  }
+
+  if (UNLIKELY(ps->is_flip_object)) {
+    negate_v3(no);
+  }
+
+  /* now we can use the normal as a mask */
+  if (ps->is_ortho) {
+    angle_cos = dot_v3v3(ps->viewDir, no);
+  }
+  else {
+    /* Annoying but for the perspective view we need to get the pixels location in 3D space :/ */
+    float viewDirPersp[3];
+    const float *co1, *co2, *co3;
+    co1 = ps->vert_positions_eval[vert_tri[0]];
+    co2 = ps->vert_positions_eval[vert_tri[1]];
+    co3 = ps->vert_positions_eval[vert_tri[2]];
+
+    /* Get the direction from the viewPoint to the pixel and normalize */
+    viewDirPersp[0] = (ps->viewPos[0] - (w[0] * co1[0] + w[1] * co2[0] + w[2] * co3[0]));
+    viewDirPersp[1] = (ps->viewPos[1] - (w[0] * co1[1] + w[1] * co2[1] + w[2] * co3[1]));
+    viewDirPersp[2] = (ps->viewPos[2] - (w[0] * co1[2] + w[1] * co2[2] + w[2] * co3[2]));
+    normalize_v3(viewDirPersp);
+    if (UNLIKELY(ps->is_flip_object)) {
+      negate_v3(viewDirPersp);
+    }
+
+    angle_cos = dot_v3v3(viewDirPersp, no);
+  }
+
+  /* If back-face culling is disabled, allow painting on back faces. */
+  if (!ps->do_backfacecull) {
+    angle_cos = fabsf(angle_cos);
+  }
+
+  if (angle_cos <= ps->normal_angle__cos) {
+    /* Outsize the normal limit. */
+    return 0.0f;
+  }
+  if (angle_cos < ps->normal_angle_inner__cos) {
+    return (ps->normal_angle - acosf(angle_cos)) / ps->normal_angle_range;
+  }
+  /* otherwise no mask normal is needed, we're within the limit */
+  return 1.0f;
+}
+
+/* run this outside project_paint_uvpixel_init since pixels with mask 0 don't need init,
+ * `mask_normal` is the result of #project_paint_uvpixel_mask_normal */
 static float project_paint_uvpixel_mask(const ProjPaintState *ps,
                                         const int tri_index,
-                                        const float w[3])
+                                        const float w[3],
+                                        const float mask_normal)
 {
   float mask;
 
@@ -1709,80 +1905,11 @@ static float project_paint_uvpixel_mask(const ProjPaintState *ps,
     mask *= ca_mask;
   }
 
-  /* calculate mask */
-  if (ps->do_mask_normal) {
-    const int3 &tri = ps->corner_tris_eval[tri_index];
-    const int face_i = ps->corner_tri_faces_eval[tri_index];
-    const int vert_tri[3] = {PS_CORNER_TRI_AS_VERT_INDEX_3(ps, tri)};
-    float no[3], angle_cos;
-
-    if (!(ps->sharp_faces_eval && ps->sharp_faces_eval[face_i])) {
-      const float *no1, *no2, *no3;
-      no1 = ps->vert_normals[vert_tri[0]];
-      no2 = ps->vert_normals[vert_tri[1]];
-      no3 = ps->vert_normals[vert_tri[2]];
-
-      no[0] = w[0] * no1[0] + w[1] * no2[0] + w[2] * no3[0];
-      no[1] = w[0] * no1[1] + w[1] * no2[1] + w[2] * no3[1];
-      no[2] = w[0] * no1[2] + w[1] * no2[2] + w[2] * no3[2];
-      normalize_v3(no);
-    }
-    else {
-      /* In case the normalizing per pixel isn't optimal,
-       * we could cache or access from evaluated mesh. */
-      normal_tri_v3(no,
-                    ps->vert_positions_eval[vert_tri[0]],
-                    ps->vert_positions_eval[vert_tri[1]],
-                    ps->vert_positions_eval[vert_tri[2]]);
-    }
-
-    if (UNLIKELY(ps->is_flip_object)) {
-      negate_v3(no);
-    }
-
-    /* now we can use the normal as a mask */
-    if (ps->is_ortho) {
-      angle_cos = dot_v3v3(ps->viewDir, no);
-    }
-    else {
-      /* Annoying but for the perspective view we need to get the pixels location in 3D space :/ */
-      float viewDirPersp[3];
-      const float *co1, *co2, *co3;
-      co1 = ps->vert_positions_eval[vert_tri[0]];
-      co2 = ps->vert_positions_eval[vert_tri[1]];
-      co3 = ps->vert_positions_eval[vert_tri[2]];
-
-      /* Get the direction from the viewPoint to the pixel and normalize */
-      viewDirPersp[0] = (ps->viewPos[0] - (w[0] * co1[0] + w[1] * co2[0] + w[2] * co3[0]));
-      viewDirPersp[1] = (ps->viewPos[1] - (w[0] * co1[1] + w[1] * co2[1] + w[2] * co3[1]));
-      viewDirPersp[2] = (ps->viewPos[2] - (w[0] * co1[2] + w[1] * co2[2] + w[2] * co3[2]));
-      normalize_v3(viewDirPersp);
-      if (UNLIKELY(ps->is_flip_object)) {
-        negate_v3(viewDirPersp);
-      }
-
-      angle_cos = dot_v3v3(viewDirPersp, no);
-    }
-
-    /* If back-face culling is disabled, allow painting on back faces. */
-    if (!ps->do_backfacecull) {
-      angle_cos = fabsf(angle_cos);
-    }
-
-    if (angle_cos <= ps->normal_angle__cos) {
-      /* Outsize the normal limit. */
-      return 0.0f;
-    }
-    if (angle_cos < ps->normal_angle_inner__cos) {
-      mask *= (ps->normal_angle - acosf(angle_cos)) / ps->normal_angle_range;
-    } /* otherwise no mask normal is needed, we're within the limit */
-  }
-
   /* This only works when the opacity doesn't change while painting, stylus pressure messes with
    * this so don't use it. */
   // if (ps->is_airbrush == 0) mask *= BKE_brush_alpha_get(ps->brush);
 
-  return mask;
+  return mask * mask_normal;
 }
 
 static int project_paint_pixel_sizeof(const short brush_type)
@@ -1797,23 +1924,12 @@ static int project_paint_undo_subtiles(const TileInfo *tinf, int tx, int ty)
 {
   ProjPaintImage *pjIma = tinf->pjima;
   int tile_index = tx + ty * tinf->tile_width;
-  bool generate_tile = false;
 
-  /* double check lock to avoid locking */
-  if (UNLIKELY(!pjIma->undoRect[tile_index])) {
-    if (tinf->lock) {
-      BLI_spin_lock(tinf->lock);
-    }
-    if (LIKELY(!pjIma->undoRect[tile_index])) {
-      pjIma->undoRect[tile_index] = TILE_PENDING;
-      generate_tile = true;
-    }
-    if (tinf->lock) {
-      BLI_spin_unlock(tinf->lock);
-    }
-  }
-
-  if (generate_tile) {
+  /* Only the thread that swaps the empty tile for #TILE_PENDING pushes the undo tile, other
+   * threads wait in #project_paint_uvpixel_init until the tile is published. */
+  if (UNLIKELY(!pjIma->undoRect[tile_index]) &&
+      atomic_cas_ptr((void **)&pjIma->undoRect[tile_index], nullptr, TILE_PENDING) == nullptr)
+  {
     PaintTileMap *undo_tiles = ED_image_paint_tile_map_get();
     volatile void *undorect;
     if (tinf->masked) {
@@ -1845,13 +1961,7 @@ static int project_paint_undo_subtiles(const TileInfo *tinf, int tx, int ty)
 
     BKE_image_mark_dirty(pjIma->ima, pjIma->ibuf);
     /* tile ready, publish */
-    if (tinf->lock) {
-      BLI_spin_lock(tinf->lock);
-    }
-    pjIma->undoRect[tile_index] = undorect;
-    if (tinf->lock) {
-      BLI_spin_unlock(tinf->lock);
-    }
+    atomic_cas_ptr((void **)&pjIma->undoRect[tile_index], TILE_PENDING, (void *)undorect);
   }
 
   return tile_index;
@@ -2965,7 +3075,8 @@ static bool IsectPoly2Df_twoside(const float pt[2], const float uv[][2], const i
  * since it selects the pixels to be added into each bucket.
  *
  * initialize pixels from this face where it intersects with the bucket_index,
- * optionally initialize pixels for removing seams */
+ * optionally initialize pixels for removing seams.
+ * When `coverage` isn't null, the pixels are also added to it. */
 static void project_paint_face_init(const ProjPaintState *ps,
                                     const int thread_index,
                                     const int bucket_index,
@@ -2974,7 +3085,8 @@ static void project_paint_face_init(const ProjPaintState *ps,
                                     const rctf *clip_rect,
                                     const rctf *bucket_bounds,
                                     ImBuf *ibuf,
-                                    ImBuf **tmpibuf)
+                                    ImBuf **tmpibuf,
+                                    ProjBucketCoverage *coverage)
 {
   /* Projection vars, to get the 3D locations into screen space. */
   MemArena *arena = ps->arena_mt[thread_index];
@@ -2983,7 +3095,6 @@ static void project_paint_face_init(const ProjPaintState *ps,
   bool threaded = (ps->thread_tot > 1);
 
   TileInfo tinf = {
-      ps->tile_lock,
       ps->do_masking,
       ushort(ED_IMAGE_UNDO_TILE_NUMBER(ibuf->x)),
       tmpibuf,
@@ -3008,7 +3119,7 @@ static void project_paint_face_init(const ProjPaintState *ps,
   /* Vertex screen-space coords. */
   const float *vCo[3];
 
-  float w[3], wco[3];
+  float w[3], wco[3] = {0.0f, 0.0f, 0.0f};
 
   /* for convenience only, these will be assigned to tri_uv[0],1,2 or tri_uv[0],2,3 */
   float *uv1co, *uv2co, *uv3co;
@@ -3150,14 +3261,29 @@ static void project_paint_face_init(const ProjPaintState *ps,
             if ((ps->do_occlude == false) ||
                 !project_bucket_point_occluded(ps, bucketFaceNodes, tri_index, pixelScreenCo))
             {
-              mask = project_paint_uvpixel_mask(ps, tri_index, w);
-
-              if (mask > 0.0f) {
-                BLI_linklist_prepend_arena(
-                    bucketPixelNodes,
-                    project_paint_uvpixel_init(
-                        ps, arena, &tinf, x, y, mask, tri_index, pixelScreenCo, wco, w),
-                    arena);
+              const float mask_normal = project_paint_uvpixel_mask_normal(ps, tri_index, w);
+
+              if (mask_normal > 0.0f) {
+                if (coverage) {
+                  coverage->pixels.append({x,
+                                           y,
+                                           tri_index,
+                                           image_index,
+                                           blender::float2(pixelScreenCo),
+                                           blender::float3(wco),
+                                           blender::float3(w),
+                                           mask_normal});
+                }
+
+                mask = project_paint_uvpixel_mask(ps, tri_index, w, mask_normal);
+
+                if (mask > 0.0f) {
+                  BLI_linklist_prepend_arena(
+                      bucketPixelNodes,
+                      project_paint_uvpixel_init(
+                          ps, arena, &tinf, x, y, mask, tri_index, pixelScreenCo, wco, w),
+                      arena);
+                }
               }
             }
           }
@@ -3403,14 +3529,38 @@ static void project_paint_face_init(const ProjPaintState *ps,
                         }
                       }
 
-                      mask = project_paint_uvpixel_mask(ps, tri_index, w);
+                      const float mask_normal = project_paint_uvpixel_mask_normal(
+                          ps, tri_index, w);
+
+                      if (mask_normal > 0.0f) {
+                        if (coverage) {
+                          coverage->pixels.append({x,
+                                                   y,
+                                                   tri_index,
+                                                   image_index,
+                                                   blender::float2(pixelScreenCo),
+                                                   blender::float3(wco),
+                                                   blender::float3(w),
+                                                   mask_normal});
+                        }
 
-                      if (mask > 0.0f) {
-                        BLI_linklist_prepend_arena(
-                            bucketPixelNodes,
-                            project_paint_uvpixel_init(
-                                ps, arena, &tinf, x, y, mask, tri_index, pixelScreenCo, wco, w),
-                            arena);
+                        mask = project_paint_uvpixel_mask(ps, tri_index, w, mask_normal);
+
+                        if (mask > 0.0f) {
+                          BLI_linklist_prepend_arena(
+                              bucketPixelNodes,
+                              project_paint_uvpixel_init(ps,
+                                                         arena,
+                                                         &tinf,
+                                                         x,
+                                                         y,
+                                                         mask,
+                                                         tri_index,
+                                                         pixelScreenCo,
+                                                         wco,
+                                                         w),
+                              arena);
+                        }
                       }
                     }
                   }
@@ -3493,6 +3643,96 @@ static void project_bucket_bounds(const ProjPaintState *ps,
                            ((bucket_y + 1) * (ps->screen_height / ps->buckets_y)));
 }
 
+/**
+ * Stop storing pixels in #ProjCoverageCache when the pixels of all caches use more memory than
+ * this. The caches are kept between strokes, outside of any other memory limit.
+ */
+#define PROJ_COVERAGE_CACHE_MEMORY_MAX (size_t(64) << 20)
+
+static int project_paint_face_image_index(const ProjPaintState *ps, const int tri_index)
+{
+  const int3 &tri = ps->corner_tris_eval[tri_index];
+  const int face_i = ps->corner_tri_faces_eval[tri_index];
+  const float *tri_uv[3] = {PS_CORNER_TRI_AS_UV_3(ps->poly_to_loop_uv, face_i, tri)};
+
+  Image *tpage = project_paint_face_paint_image(ps, tri_index);
+  const int tile = project_paint_face_paint_tile(tpage, tri_uv[0]);
+  for (int image_index = 0; image_index < ps->image_tot; image_index++) {
+    const ProjPaintImage *projIma = &ps->projImages[image_index];
+    if ((projIma->ima == tpage) && (projIma->iuser.tile == tile)) {
+      return image_index;
+    }
+  }
+  return -1;
+}
+
+/**
+ * Pixels stored for a bucket can only be reused when it has the same faces,
+ * painted onto the same images, as when they were found.
+ */
+static bool project_bucket_coverage_matches(const ProjPaintState *ps,
+                                            const int bucket_index,
+                                            const ProjBucketCoverage &coverage)
+{
+  int i = 0;
+  for (LinkNode *node = ps->bucketFaces[bucket_index]; node; node = node->next, i++) {
+    const int tri_index = POINTER_AS_INT(node->link);
+    if (i == coverage.faces.size() || coverage.faces[i][0] != tri_index) {
+      return false;
+    }
+    if (ps->image_tot > 1 && project_paint_face_image_index(ps, tri_index) != coverage.faces[i][1])
+    {
+      return false;
+    }
+  }
+  return i == coverage.faces.size();
+}
+
+/* Fill this bucket with the pixels stored by an earlier stroke, only the masks that depend on
+ * image content are evaluated again. */
+static void project_bucket_init_from_coverage(const ProjPaintState *ps,
+                                              const int thread_index,
+                                              const int bucket_index,
+                                              const ProjBucketCoverage &coverage)
+{
+  MemArena *arena = ps->arena_mt[thread_index];
+  LinkNode **bucketPixelNodes = ps->bucketRect + bucket_index;
+  ImBuf *tmpibuf = nullptr;
+
+  TileInfo tinf = {ps->do_masking, 0, &tmpibuf, nullptr};
+
+  for (const ProjCoveragePixel &pixel : coverage.pixels) {
+    const float mask = project_paint_uvpixel_mask(
+        ps, pixel.tri_index, pixel.w, pixel.mask_normal);
+
+    if (mask > 0.0f) {
+      ProjPaintImage *projIma = ps->projImages + pixel.image_index;
+      if (tinf.pjima != projIma) {
+        tinf.pjima = projIma;
+        tinf.tile_width = ushort(ED_IMAGE_UNDO_TILE_NUMBER(projIma->ibuf->x));
+      }
+
+      const float pixelScreenCo[4] = {pixel.co.x, pixel.co.y, 0.0f, 0.0f};
+      BLI_linklist_prepend_arena(bucketPixelNodes,
+                                 project_paint_uvpixel_init(ps,
+                                                            arena,
+                                                            &tinf,
+                                                            pixel.x_px,
+                                                            pixel.y_px,
+                                                            mask,
+                                                            pixel.tri_index,
+                                                            pixelScreenCo,
+                                                            pixel.world_co,
+                                                            pixel.w),
+                                 arena);
+    }
+  }
+
+  if (tmpibuf) {
+    IMB_freeImBuf(tmpibuf);
+  }
+}
+
 /* Fill this bucket with pixels from the faces that intersect it.
  *
  * have bucket_bounds as an argument so we don't need to give bucket_x/y the rect function needs */
@@ -3508,12 +3748,37 @@ static void project_bucket_init(const ProjPaintState *ps,
   Image *tpage_last = nullptr, *tpage;
   ImBuf *tmpibuf = nullptr;
   int tile_last = 0;
+  ProjBucketCoverage *coverage = nullptr;
+
+  if (ps->coverage_cache) {
+    /* Each bucket is initialized by a single thread, so it can write its own cache entry. */
+    std::unique_ptr<ProjBucketCoverage> &cached = ps->coverage_cache->buckets[bucket_index];
+    if (cached && project_bucket_coverage_matches(ps, bucket_index, *cached)) {
+      project_bucket_init_from_coverage(ps, thread_index, bucket_index, *cached);
+      ps->bucketFlags[bucket_index] |= PROJ_BUCKET_INIT;
+      return;
+    }
+    if (cached) {
+      atomic_sub_and_fetch_int64(&ps->coverage_cache->pixels_num, cached->pixels.size());
+      atomic_sub_and_fetch_int64(&coverage_caches_pixels_num, cached->pixels.size());
+      cached.reset();
+    }
+    if (atomic_load_int64(&coverage_caches_pixels_num) * sizeof(ProjCoveragePixel) <
+        PROJ_COVERAGE_CACHE_MEMORY_MAX)
+    {
+      cached = std::make_unique<ProjBucketCoverage>();
+      coverage = cached.get();
+    }
+  }
 
   if (ps->image_tot == 1) {
     /* Simple loop, no context switching */
     ibuf = ps->projImages[0].ibuf;
 
     for (node = ps->bucketFaces[bucket_index]; node; node = node->next) {
+      if (coverage) {
+        coverage->faces.append({POINTER_AS_INT(node->link), 0});
+      }
       project_paint_face_init(ps,
                               thread_index,
                               bucket_index,
@@ -3522,7 +3787,8 @@ static void project_bucket_init(const ProjPaintState *ps,
                               clip_rect,
                               bucket_bounds,
                               ibuf,
-                              &tmpibuf);
+                              &tmpibuf,
+                              coverage);
     }
   }
   else {
@@ -3554,6 +3820,9 @@ static void project_bucket_init(const ProjPaintState *ps,
       }
       /* context switching done */
 
+      if (coverage) {
+        coverage->faces.append({tri_index, image_index});
+      }
       project_paint_face_init(ps,
                               thread_index,
                               bucket_index,
@@ -3562,7 +3831,8 @@ static void project_bucket_init(const ProjPaintState *ps,
                               clip_rect,
                               bucket_bounds,
                               ibuf,
-                              &tmpibuf);
+                              &tmpibuf,
+                              coverage);
     }
   }
 
@@ -3570,6 +3840,11 @@ static void project_bucket_init(const ProjPaintState *ps,
     IMB_freeImBuf(tmpibuf);
   }
 
+  if (coverage) {
+    atomic_add_and_fetch_int64(&ps->coverage_cache->pixels_num, coverage->pixels.size());
+    atomic_add_and_fetch_int64(&coverage_caches_pixels_num, coverage->pixels.size());
+  }
+
   ps->bucketFlags[bucket_index] |= PROJ_BUCKET_INIT;
 }
 
@@ -3956,12 +4231,6 @@ static void proj_paint_state_thread_init(ProjPaintState *ps, const bool reset_th
   }
 
   if (ps->is_shared_user == false) {
-    if (ps->thread_tot > 1) {
-      ps->tile_lock = static_cast<SpinLock *>(
-          MEM_mallocN(sizeof(SpinLock), "projpaint_tile_lock"));
-      BLI_spin_init(ps->tile_lock);
-    }
-
     ED_image_paint_tile_lock_init();
   }
 
@@ -4489,6 +4758,99 @@ static void project_paint_prepare_all_faces(ProjPaintState *ps,
 }
 
 /* run once per stroke before projection painting */
+/* -------------------------------------------------------------------- */
+/** \name Coverage Cache
+ * \{ */
+
+/** One cache for each view of the last stroke using #IMAGEPAINT_PROJECT_COVERAGE_CACHE. */
+static blender::Vector<std::unique_ptr<ProjCoverageCache>> coverage_caches;
+
+static ProjCoverageKey project_coverage_key(const ProjPaintState *ps)
+{
+  const Object *ob_eval = DEG_get_evaluated_object(ps->depsgraph, ps->ob);
+
+  ProjCoverageKey key;
+  key.depsgraph = ps->depsgraph;
+  key.ob = ps->ob;
+  key.last_update_geometry = ob_eval->runtime->last_update_geometry;
+  key.project_mat = blender::float4x4(ps->projectMat);
+  key.win_size = blender::int2(ps->winx, ps->winy);
+  key.screen_min = blender::float2(ps->screenMin);
+  key.screen_max = blender::float2(ps->screenMax);
+  key.buckets_num = blender::int2(ps->buckets_x, ps->buckets_y);
+  key.do_occlude = ps->do_occlude;
+  key.do_backfacecull = ps->do_backfacecull;
+  key.do_mask_normal = ps->do_mask_normal;
+  key.do_3d_mapping = ps->brush->mtex.brush_map_mode == MTEX_MAP_MODE_3D;
+  key.normal_angle = ps->normal_angle;
+  key.normal_angle_inner = ps->normal_angle_inner;
+#ifndef PROJ_DEBUG_NOSEAMBLEED
+  key.seam_bleed_px = ps->seam_bleed_px;
+#else
+  key.seam_bleed_px = 0.0f;
+#endif
+  for (int a = 0; a < ps->image_tot; a++) {
+    const ProjPaintImage &projIma = ps->projImages[a];
+    key.images.append({projIma.ima,
+                       projIma.iuser.tile,
+                       projIma.ibuf,
+                       blender::int2(projIma.ibuf->x, projIma.ibuf->y)});
+  }
+  key.face_uv_layers.reinitialize(ps->faces_num_eval);
+  const float (*uv_layer_last)[2] = nullptr;
+  int uv_layer_index = -1;
+  for (const int face_i : key.face_uv_layers.index_range()) {
+    const float (*uv_layer)[2] = ps->poly_to_loop_uv[face_i];
+    if (uv_layer != uv_layer_last) {
+      uv_layer_index = key.uv_layers.first_index_of_try(uv_layer);
+      if (uv_layer_index == -1) {
+        uv_layer_index = key.uv_layers.append_and_get_index(uv_layer);
+      }
+      uv_layer_last = uv_layer;
+    }
+    key.face_uv_layers[face_i] = uv_layer_index;
+  }
+  if (key.uv_layers.size() <= 1) {
+    key.face_uv_layers.reinitialize(0);
+  }
+  return key;
+}
+
+static ProjCoverageCache *project_coverage_cache_ensure(const ProjPaintState *ps)
+{
+  ProjCoverageKey key = project_coverage_key(ps);
+  for (std::unique_ptr<ProjCoverageCache> &cache : coverage_caches) {
+    if (cache->key == key) {
+      cache->used = true;
+      return cache.get();
+    }
+  }
+
+  std::unique_ptr<ProjCoverageCache> cache = std::make_unique<ProjCoverageCache>();
+  cache->key = std::move(key);
+  cache->buckets.reinitialize(ps->buckets_x * ps->buckets_y);
+  cache->used = true;
+  coverage_caches.append(std::move(cache));
+  return coverage_caches.last().get();
+}
+
+/** Only keep the caches of the last stroke, anything else is unlikely to be used again. */
+static void project_coverage_caches_free_unused()
+{
+  coverage_caches.remove_if(
+      [](const std::unique_ptr<ProjCoverageCache> &cache) { return !cache->used; });
+  for (std::unique_ptr<ProjCoverageCache> &cache : coverage_caches) {
+    cache->used = false;
+  }
+}
+
+void ED_paint_proj_coverage_cache_free()
+{
+  coverage_caches.clear_and_shrink();
+}
+
+/** \} */
+
 static void project_paint_begin(const bContext *C,
                                 ProjPaintState *ps,
                                 const bool is_multi_view,
@@ -4594,6 +4956,13 @@ static void project_paint_begin(const bContext *C,
 
   project_paint_prepare_all_faces(
       ps, arena, &face_lookup, &layer_clone, mloopuv_base, is_multi_view);
+
+  /* Clipping isn't part of the cache key, it's rarely used while painting. */
+  if (ps->do_coverage_cache && ps->source == PROJ_SRC_VIEW &&
+      !RV3D_CLIPPING_ENABLED(ps->v3d, ps->rv3d))
+  {
+    ps->coverage_cache = project_coverage_cache_ensure(ps);
+  }
 }
 
 static void paint_proj_begin_clone(ProjPaintState *ps, const float mouse[2])
@@ -4653,11 +5022,6 @@ static void project_paint_end(ProjPaintState *ps)
     if (ps->do_layer_clone) {
       MEM_freeN((void *)ps->poly_to_loop_uv_clone);
     }
-    if (ps->thread_tot > 1) {
-      BLI_spin_end(ps->tile_lock);
-      MEM_freeN((void *)ps->tile_lock);
-    }
-
     ED_image_paint_tile_lock_end();
 
 #ifndef PROJ_DEBUG_NOSEAMBLEED
@@ -4791,41 +5155,78 @@ static bool project_bucket_iter_init(ProjPaintState *ps, const float mval_f[2])
     ps->bucketMax[1] = ps->buckets_y;
   }
 
-  ps->context_bucket_index = ps->bucketMin[0] + ps->bucketMin[1] * ps->buckets_x;
+  const int diameter = 2 * ps->brush_size;
+
+  ps->dab_buckets.clear();
+  for (int bucket_y = ps->bucketMin[1]; bucket_y < ps->bucketMax[1]; bucket_y++) {
+    for (int bucket_x = ps->bucketMin[0]; bucket_x < ps->bucketMax[0]; bucket_x++) {
+      if (ps->source == PROJ_SRC_VIEW) {
+        rctf bucket_bounds;
+        project_bucket_bounds(ps, bucket_x, bucket_y, &bucket_bounds);
+        if (!project_bucket_isect_circle(mval_f, float(diameter * diameter), &bucket_bounds)) {
+          continue;
+        }
+      }
+      ps->dab_buckets.append(bucket_x + bucket_y * ps->buckets_x);
+    }
+  }
+
+  /* Give each thread a contiguous range of buckets, so the buckets a thread paints are close to
+   * each other. Uninitialized buckets take much longer than others, threads that run out of
+   * buckets take over the remaining buckets of other threads, see #project_bucket_iter_next. */
+  const uint64_t buckets_num = uint64_t(ps->dab_buckets.size());
+  for (int a = 0; a < ps->thread_tot; a++) {
+    const uint64_t start = buckets_num * a / ps->thread_tot;
+    const uint64_t end = buckets_num * (a + 1) / ps->thread_tot;
+    ps->thread_bucket_ranges[a] = (start << 32) | end;
+  }
   return true;
 }
 
+/**
+ * Take a bucket from the start or the end of a range of #ProjPaintState::dab_buckets.
+ * \return The index in the range or -1 when the range is empty.
+ */
+static int project_bucket_range_pop(uint64_t *range, const bool from_start)
+{
+  uint64_t range_old = atomic_load_uint64(range);
+  while (true) {
+    const uint32_t start = uint32_t(range_old >> 32);
+    const uint32_t end = uint32_t(range_old);
+    if (start >= end) {
+      return -1;
+    }
+    const uint64_t range_new = from_start ? (uint64_t(start + 1) << 32) | end :
+                                            (uint64_t(start) << 32) | (end - 1);
+    const uint64_t range_prev = atomic_cas_uint64(range, range_old, range_new);
+    if (range_prev == range_old) {
+      return int(from_start ? start : end - 1);
+    }
+    range_old = range_prev;
+  }
+}
+
 static bool project_bucket_iter_next(ProjPaintState *ps,
+                                     const int thread_index,
                                      int *bucket_index,
-                                     rctf *bucket_bounds,
-                                     const float mval[2])
+                                     rctf *bucket_bounds)
 {
-  const int diameter = 2 * ps->brush_size;
-
-  const int max_bucket_idx = ps->bucketMax[0] + (ps->bucketMax[1] - 1) * ps->buckets_x;
-
-  for (int bidx = atomic_fetch_and_add_int32(&ps->context_bucket_index, 1); bidx < max_bucket_idx;
-       bidx = atomic_fetch_and_add_int32(&ps->context_bucket_index, 1))
-  {
-    const int bucket_y = bidx / ps->buckets_x;
-    const int bucket_x = bidx - (bucket_y * ps->buckets_x);
-
-    BLI_assert(bucket_y >= ps->bucketMin[1] && bucket_y < ps->bucketMax[1]);
-    if (bucket_x >= ps->bucketMin[0] && bucket_x < ps->bucketMax[0]) {
-      /* Use bucket_bounds for #project_bucket_isect_circle and #project_bucket_init. */
-      project_bucket_bounds(ps, bucket_x, bucket_y, bucket_bounds);
-
-      if ((ps->source != PROJ_SRC_VIEW) ||
-          project_bucket_isect_circle(mval, float(diameter * diameter), bucket_bounds))
-      {
-        *bucket_index = bidx;
-
-        return true;
-      }
-    }
+  int index = project_bucket_range_pop(&ps->thread_bucket_ranges[thread_index], true);
+  for (int i = 1; index == -1 && i < ps->thread_tot; i++) {
+    index = project_bucket_range_pop(
+        &ps->thread_bucket_ranges[(thread_index + i) % ps->thread_tot], false);
+  }
+  if (index == -1) {
+    return false;
   }
 
-  return false;
+  *bucket_index = ps->dab_buckets[index];
+  const int bucket_y = *bucket_index / ps->buckets_x;
+  const int bucket_x = *bucket_index - (bucket_y * ps->buckets_x);
+
+  /* Use bucket_bounds for #project_bucket_init. */
+  project_bucket_bounds(ps, bucket_x, bucket_y, bucket_bounds);
+  return true;
 }
 
 /* Each thread gets one of these, also used as an argument to pass to project_paint_op */
@@ -5246,7 +5647,7 @@ static void do_projectpaint_thread(TaskPool *__restrict /*pool*/, void *ph_v)
   // printf("brush bounds %d %d %d %d\n",
   //        bucketMin[0], bucketMin[1], bucketMax[0], bucketMax[1]);
 
-  while (project_bucket_iter_next(ps, &bucket_index, &bucket_bounds, pos)) {
+  while (project_bucket_iter_next(ps, thread_index, &bucket_index, &bucket_bounds)) {
 
     /* Check this bucket and its faces are initialized */
     if (ps->bucketFlags[bucket_index] == PROJ_BUCKET_NULL) {
@@ -5899,6 +6300,7 @@ static void project_state_init(bContext *C, Object *ob, ProjPaintState *ps, int
 
   ps->do_mask_cavity = (settings->imapaint.paint.flags & PAINT_USE_CAVITY_MASK);
   ps->cavity_curve = settings->imapaint.paint.cavity_curve;
+  ps->do_coverage_cache = (settings->imapaint.flag & IMAGEPAINT_PROJECT_COVERAGE_CACHE) != 0;
 
   /* setup projection painting data */
   if (ps->brush_type != IMAGE_PAINT_BRUSH_TYPE_FILL) {
@@ -6096,6 +6498,8 @@ void paint_proj_stroke_done(void *ps_handle_p)
     MEM_delete(ps);
   }
 
+  project_coverage_caches_free_unused();
+
   MEM_delete(ps_handle);
 }
 /* use project paint to re-apply an image */
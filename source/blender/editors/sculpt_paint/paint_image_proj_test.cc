@@ -0,0 +1,225 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup edsculpt
+ */
+
+#include "testing/testing.h"
+#include "tests/blendfile_loading_base_test.h"
+
+#include <algorithm>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_array.hh"
+#include "BLI_listbase.h"
+#include "BLI_math_matrix.hh"
+#include "BLI_utildefines.h"
+
+#include "BKE_brush.hh"
+#include "BKE_context.hh"
+#include "BKE_global.hh"
+#include "BKE_image.hh"
+#include "BKE_layer.hh"
+#include "BKE_main.hh"
+#include "BKE_mesh.hh"
+#include "BKE_object.hh"
+#include "BKE_paint.hh"
+#include "BKE_scene.hh"
+#include "BKE_undo_system.hh"
+
+#include "DNA_brush_types.h"
+#include "DNA_defaults.h"
+#include "DNA_image_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+#include "DNA_screen_types.h"
+#include "DNA_space_types.h"
+#include "DNA_view3d_types.h"
+#include "DNA_windowmanager_types.h"
+
+#include "ED_paint.hh"
+#include "ED_undo.hh"
+#include "ED_view3d.hh"
+
+#include "GEO_mesh_primitive_grid.hh"
+
+#include "IMB_imbuf.hh"
+#include "IMB_imbuf_types.hh"
+
+#include "paint_intern.hh"
+
+namespace blender::ed::sculpt_paint::tests {
+
+/* Size of the region and of the image in pixels. */
+static constexpr int test_size = 256;
+static constexpr int brush_radius = 20;
+
+class PaintImageProjTest : public BlendfileLoadingBaseTest {
+ protected:
+  Main *bmain = nullptr;
+  bContext *C = nullptr;
+  Scene *scene = nullptr;
+  Object *ob = nullptr;
+  Image *image = nullptr;
+  ScrArea area = {};
+  View3D *v3d = nullptr;
+  ARegion region = {};
+  RegionView3D rv3d = {};
+
+ public:
+  static void SetUpTestCase()
+  {
+    BlendfileLoadingBaseTest::SetUpTestCase();
+    ED_undosys_type_init();
+    /* Image undo steps reference IDs, don't write a memory file undo step of the test data. */
+    G_MAIN->is_memfile_undo_written = true;
+  }
+
+  static void TearDownTestCase()
+  {
+    BKE_undosys_type_free_all();
+    BlendfileLoadingBaseTest::TearDownTestCase();
+  }
+
+ protected:
+  void SetUp() override
+  {
+    BlendfileLoadingBaseTest::SetUp();
+    wmWindowManager *wm = static_cast<wmWindowManager *>(G_MAIN->wm.first);
+    wm->undo_stack = BKE_undosys_stack_create();
+
+    bmain = BKE_main_new();
+    scene = BKE_scene_add(bmain, "Scene");
+    ViewLayer *view_layer = BKE_view_layer_default_view(scene);
+
+    /* A plane facing the view, with UVs filling the whole image. */
+    ob = BKE_object_add(bmain, scene, view_layer, OB_MESH, "Plane");
+    Mesh *grid = geometry::create_grid_mesh(8, 8, 2.0f, 2.0f, "UVMap");
+    BKE_mesh_nomain_to_mesh(grid, static_cast<Mesh *>(ob->data), ob);
+    ob->mode = OB_MODE_TEXTURE_PAINT;
+
+    const float color[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    image = BKE_image_add_generated(bmain,
+                                    test_size,
+                                    test_size,
+                                    "Texture",
+                                    24,
+                                    false,
+                                    IMA_GENTYPE_BLANK,
+                                    color,
+                                    false,
+                                    false,
+                                    false);
+
+    ToolSettings *ts = scene->toolsettings;
+    BKE_paint_ensure_from_paintmode(scene, PaintMode::Texture3D);
+    ts->imapaint.mode = IMAGEPAINT_MODE_IMAGE;
+    ts->imapaint.canvas = image;
+    Brush *brush = BKE_brush_add(bmain, "Brush", OB_MODE_TEXTURE_PAINT);
+    brush->image_brush_type = IMAGE_PAINT_BRUSH_TYPE_DRAW;
+    BKE_paint_brush_set(&ts->imapaint.paint, brush);
+    BKE_brush_size_set(scene, brush, brush_radius);
+
+    /* An orthographic view looking down on the plane, which fills most of the region. */
+    v3d = DNA_struct_default_alloc(View3D);
+    area.spacetype = SPACE_VIEW3D;
+    BLI_addtail(&area.spacedata, v3d);
+    region.regiontype = RGN_TYPE_WINDOW;
+    region.winx = test_size;
+    region.winy = test_size;
+    region.regiondata = &rv3d;
+    rv3d.persp = RV3D_ORTHO;
+    rv3d.dist = 5.0f;
+
+    C = CTX_create();
+    CTX_data_main_set(C, bmain);
+    CTX_data_scene_set(C, scene);
+    CTX_wm_area_set(C, &area);
+    CTX_wm_region_set(C, &region);
+
+    const float4x4 viewmat = math::from_location<float4x4>(float3(0.0f, 0.0f, -5.0f));
+    const float4x4 winmat = math::projection::orthographic(
+        -1.25f, 1.25f, -1.25f, 1.25f, -10.0f, 10.0f);
+    ED_view3d_update_viewmat(CTX_data_ensure_evaluated_depsgraph(C),
+                             scene,
+                             v3d,
+                             &region,
+                             viewmat.ptr(),
+                             winmat.ptr(),
+                             nullptr,
+                             false);
+  }
+
+  void TearDown() override
+  {
+    ED_paint_proj_coverage_cache_free();
+    wmWindowManager *wm = static_cast<wmWindowManager *>(G_MAIN->wm.first);
+    BKE_undosys_stack_destroy(wm->undo_stack);
+    wm->undo_stack = nullptr;
+    CTX_free(C);
+    MEM_freeN(v3d);
+    BKE_main_free(bmain);
+    BlendfileLoadingBaseTest::TearDown();
+  }
+
+  void set_coverage_cache(const bool enable)
+  {
+    SET_FLAG_FROM_TEST(
+        scene->toolsettings->imapaint.flag, enable, IMAGEPAINT_PROJECT_COVERAGE_CACHE);
+  }
+
+  /* Paints a stroke through the region positions onto a black image, and returns its pixels. */
+  Array<uchar4> paint_stroke(const Span<float2> positions)
+  {
+    ImBuf *ibuf = BKE_image_acquire_ibuf(image, nullptr, nullptr);
+    const float color[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    IMB_rectfill(ibuf, color);
+
+    ED_image_undo_push_begin("Texture Paint", PaintMode::Texture3D);
+    void *stroke = paint_proj_new_stroke(C, ob, positions.first(), BRUSH_STROKE_NORMAL);
+    EXPECT_NE(stroke, nullptr);
+    for (const int i : positions.index_range()) {
+      const float2 &prev_position = positions[std::max(i - 1, 0)];
+      paint_proj_stroke(C, stroke, prev_position, positions[i], false, 1.0f, 0.0f, brush_radius);
+    }
+    paint_proj_stroke_done(stroke);
+    ED_image_undo_push_end();
+
+    Array<uchar4> pixels(Span(reinterpret_cast<const uchar4 *>(ibuf->byte_buffer.data),
+                              int64_t(ibuf->x) * ibuf->y));
+    BKE_image_release_ibuf(image, ibuf, nullptr);
+    return pixels;
+  }
+};
+
+/* Strokes using the pixels of the buckets found by an earlier stroke paint the same pixels as
+ * strokes finding them again. */
+TEST_F(PaintImageProjTest, coverage_cache)
+{
+  const Array<float2> stroke_a = {{40.0f, 60.0f}, {90.0f, 80.0f}, {140.0f, 100.0f}};
+  /* Partially overlaps the buckets of the first stroke. */
+  const Array<float2> stroke_b = {{120.0f, 110.0f}, {170.0f, 150.0f}, {210.0f, 200.0f}};
+
+  set_coverage_cache(false);
+  const Array<uchar4> fresh_a = paint_stroke(stroke_a);
+  const Array<uchar4> fresh_b = paint_stroke(stroke_b);
+  /* The strokes paint white onto the black image. */
+  EXPECT_TRUE(std::any_of(
+      fresh_a.begin(), fresh_a.end(), [](const uchar4 &pixel) { return pixel.x != 0; }));
+
+  set_coverage_cache(true);
+  /* Fills the cache. */
+  const Array<uchar4> cached_a = paint_stroke(stroke_a);
+  EXPECT_EQ_ARRAY(fresh_a.data(), cached_a.data(), fresh_a.size());
+  /* Uses the cache for the buckets of the first stroke, and adds the others. */
+  const Array<uchar4> cached_b = paint_stroke(stroke_b);
+  EXPECT_EQ_ARRAY(fresh_b.data(), cached_b.data(), fresh_b.size());
+  /* Uses the cache for all buckets. */
+  const Array<uchar4> cached_b_again = paint_stroke(stroke_b);
+  EXPECT_EQ_ARRAY(fresh_b.data(), cached_b_again.data(), fresh_b.size());
+}
+
+}  // namespace blender::ed::sculpt_paint::tests
@@ -26,11 +26,19 @@
  * We use BKE_undosys_step_push_init_with_type to build a tentative undo step with is appended
  * later when the operator ends. Operators must have the OPTYPE_UNDO flag set for this to work
  * properly.
+ *
+ * Once an undo step is pushed, the per-node arrays of positions, masks, colors and face sets are
+ * compressed on a background thread to reduce the memory usage of the undo stack. They are
+ * decompressed again when the step is undone or redone.
  */
 #include "sculpt_undo.hh"
 
+#include <array>
+#include <atomic>
 #include <mutex>
 
+#include <zstd.h>
+
 #include "CLG_log.h"
 
 #include "BLI_array.hh"
@@ -38,6 +46,8 @@
 #include "BLI_listbase.h"
 #include "BLI_map.hh"
 #include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 #include "BLI_vector.hh"
 
@@ -156,6 +166,14 @@ struct Node {
   Array<int, 0> face_sets;
 
   Vector<int> face_indices;
+
+  /**
+   * The arrays visited by #foreach_compressed_array, compressed after the undo step is pushed.
+   * While this is not empty, those arrays are empty and their sizes are stored in
+   * #compressed_array_sizes.
+   */
+  Array<std::byte, 0> compressed_data;
+  std::array<int, 6> compressed_array_sizes;
 };
 
 struct SculptAttrRef {
@@ -260,6 +278,14 @@ struct StepData {
   Vector<std::unique_ptr<Node>> nodes;
 
   size_t undo_size;
+
+  /**
+   * Compresses the data of #nodes in the background after the step is pushed or restored. Must
+   * be waited for before accessing #nodes, see #wait_for_compression.
+   */
+  TaskPool *compress_pool = nullptr;
+  /** Set when the task in #compress_pool is done, and #undo_size contains the compressed size. */
+  std::atomic<bool> compress_finished = false;
 };
 
 struct SculptUndoStep {
@@ -1113,8 +1139,274 @@ static void restore_list(bContext *C, Depsgraph *depsgraph, StepData &step_data)
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Undo Data Compression
+ *
+ * The arrays are stored as 32 bit values, XOR-ed with the same component of the previous element
+ * and split into byte planes before they are compressed with ZSTD. The vertices of a BVH node are
+ * spatially coherent, so the sign, exponent and high mantissa bytes of neighboring values are
+ * mostly the same and become long runs of zeros.
+ * \{ */
+
+template<typename Fn> static void foreach_compressed_array(Node &node, const Fn &fn)
+{
+  fn(node.position);
+  fn(node.orig_position);
+  fn(node.col);
+  fn(node.mask);
+  fn(node.loop_col);
+  fn(node.face_sets);
+}
+
+template<typename T> static MutableSpan<uint32_t> values_of_array(Array<T, 0> &array)
+{
+  static_assert(sizeof(T) % sizeof(uint32_t) == 0);
+  return {reinterpret_cast<uint32_t *>(array.data()),
+          array.size() * int64_t(sizeof(T) / sizeof(uint32_t))};
+}
+
+void encode_values(const Span<uint32_t> values, const int stride, MutableSpan<std::byte> r_planes)
+{
+  const int64_t num = values.size();
+  for (const int64_t i : values.index_range()) {
+    const uint32_t value = i < stride ? values[i] : values[i] ^ values[i - stride];
+    for (const int byte : IndexRange(sizeof(uint32_t))) {
+      r_planes[byte * num + i] = std::byte(value >> (byte * 8));
+    }
+  }
+}
+
+void decode_values(const Span<std::byte> planes, const int stride, MutableSpan<uint32_t> r_values)
+{
+  const int64_t num = r_values.size();
+  for (const int64_t i : r_values.index_range()) {
+    uint32_t value = 0;
+    for (const int byte : IndexRange(sizeof(uint32_t))) {
+      value |= uint32_t(planes[byte * num + i]) << (byte * 8);
+    }
+    r_values[i] = i < stride ? value : value ^ r_values[i - stride];
+  }
+}
+
+Array<std::byte, 0> compress_planes(const Span<std::byte> planes)
+{
+  Array<std::byte> buffer(ZSTD_compressBound(planes.size()), NoInitialization());
+  const size_t compressed_size = ZSTD_compress(
+      buffer.data(), buffer.size(), planes.data(), planes.size(), 1);
+  if (ZSTD_isError(compressed_size) || compressed_size >= size_t(planes.size())) {
+    return {};
+  }
+  return Array<std::byte, 0>(buffer.as_span().take_front(compressed_size));
+}
+
+bool decompress_planes(const Span<std::byte> compressed_data, MutableSpan<std::byte> r_planes)
+{
+  const size_t decompressed_size = ZSTD_decompress(
+      r_planes.data(), r_planes.size(), compressed_data.data(), compressed_data.size());
+  return !ZSTD_isError(decompressed_size) && decompressed_size == size_t(r_planes.size());
+}
+
+static void compress_node(Node &node)
+{
+  int64_t size = 0;
+  foreach_compressed_array(node, [&](auto &array) { size += values_of_array(array).size(); });
+  if (size == 0) {
+    return;
+  }
+  size *= sizeof(uint32_t);
+
+  Array<std::byte> planes(size, NoInitialization());
+  int64_t offset = 0;
+  foreach_compressed_array(node, [&](auto &array) {
+    using T = typename std::decay_t<decltype(array)>::value_type;
+    const Span<uint32_t> values = values_of_array(array);
+    encode_values(values,
+                  sizeof(T) / sizeof(uint32_t),
+                  planes.as_mutable_span().slice(offset, values.size_in_bytes()));
+    offset += values.size_in_bytes();
+  });
+
+  Array<std::byte, 0> compressed_data = compress_planes(planes);
+  if (compressed_data.is_empty()) {
+    /* Keep the uncompressed data. */
+    return;
+  }
+
+  node.compressed_data = std::move(compressed_data);
+  int array_index = 0;
+  foreach_compressed_array(node, [&](auto &array) {
+    node.compressed_array_sizes[array_index++] = array.size();
+    array = {};
+  });
+}
+
+/**
+ * \return False when the data of the node can't be decompressed, its compressed arrays are
+ * invalid in that case.
+ */
+static bool decompress_node(Node &node)
+{
+  if (node.compressed_data.is_empty()) {
+    return true;
+  }
+
+  int array_index = 0;
+  foreach_compressed_array(node, [&](auto &array) {
+    array.reinitialize(node.compressed_array_sizes[array_index++]);
+  });
+
+  int64_t size = 0;
+  foreach_compressed_array(node, [&](auto &array) { size += values_of_array(array).size(); });
+  size *= sizeof(uint32_t);
+
+  Array<std::byte> planes(size, NoInitialization());
+  if (!decompress_planes(node.compressed_data, planes)) {
+    return false;
+  }
+
+  int64_t offset = 0;
+  foreach_compressed_array(node, [&](auto &array) {
+    using T = typename std::decay_t<decltype(array)>::value_type;
+    const MutableSpan<uint32_t> values = values_of_array(array);
+    decode_values(planes.as_span().slice(offset, values.size_in_bytes()),
+                  sizeof(T) / sizeof(uint32_t),
+                  values);
+    offset += values.size_in_bytes();
+  });
+  node.compressed_data = {};
+  return true;
+}
+
+static size_t node_size_in_bytes(const Node &node)
+{
+  size_t size = sizeof(Node);
+  size += node.position.as_span().size_in_bytes();
+  size += node.orig_position.as_span().size_in_bytes();
+  size += node.normal.as_span().size_in_bytes();
+  size += node.col.as_span().size_in_bytes();
+  size += node.mask.as_span().size_in_bytes();
+  size += node.loop_col.as_span().size_in_bytes();
+  size += node.vert_indices.as_span().size_in_bytes();
+  size += node.corner_indices.as_span().size_in_bytes();
+  size += node.vert_hidden.size() / 8;
+  size += node.face_hidden.size() / 8;
+  size += node.grids.as_span().size_in_bytes();
+  size += node.grid_hidden.all_bits().size() / 8;
+  size += node.face_sets.as_span().size_in_bytes();
+  size += node.face_indices.as_span().size_in_bytes();
+  size += node.compressed_data.as_span().size_in_bytes();
+  return size;
+}
+
+static size_t nodes_size_in_bytes(const Span<std::unique_ptr<Node>> nodes)
+{
+  return threading::parallel_reduce(
+      nodes.index_range(),
+      16,
+      size_t(0),
+      [&](const IndexRange range, size_t size) {
+        for (const int i : range) {
+          size += node_size_in_bytes(*nodes[i]);
+        }
+        return size;
+      },
+      std::plus<size_t>());
+}
+
+static void compress_nodes_task(TaskPool *__restrict pool, void * /*task_data*/)
+{
+  StepData &step_data = *static_cast<StepData *>(BLI_task_pool_user_data(pool));
+  threading::parallel_for(step_data.nodes.index_range(), 1, [&](const IndexRange range) {
+    for (const int i : range) {
+      compress_node(*step_data.nodes[i]);
+    }
+  });
+  step_data.undo_size = nodes_size_in_bytes(step_data.nodes);
+  step_data.compress_finished.store(true, std::memory_order_release);
+}
+
+static void compress_nodes_in_background(StepData &step_data)
+{
+  BLI_assert(step_data.compress_pool == nullptr);
+  if (!ELEM(step_data.type, Type::Position, Type::Mask, Type::Color, Type::FaceSet)) {
+    return;
+  }
+  step_data.compress_finished = false;
+  step_data.compress_pool = BLI_task_pool_create_background(&step_data, TASK_PRIORITY_LOW);
+  BLI_task_pool_push(step_data.compress_pool, compress_nodes_task, nullptr, false, nullptr);
+}
+
+static void wait_for_compression(StepData &step_data)
+{
+  if (!step_data.compress_pool) {
+    return;
+  }
+  BLI_task_pool_work_and_wait(step_data.compress_pool);
+  BLI_task_pool_free(step_data.compress_pool);
+  step_data.compress_pool = nullptr;
+}
+
+static void decompress_nodes(StepData &step_data)
+{
+  wait_for_compression(step_data);
+  Array<bool> failed(step_data.nodes.size(), false);
+  threading::parallel_for(step_data.nodes.index_range(), 1, [&](const IndexRange range) {
+    for (const int i : range) {
+      failed[i] = !decompress_node(*step_data.nodes[i]);
+    }
+  });
+  if (!failed.as_span().contains(true)) {
+    return;
+  }
+  /* Remove the nodes that can't be restored, so the current data of their elements is kept. */
+  Vector<std::unique_ptr<Node>> nodes;
+  for (const int i : step_data.nodes.index_range()) {
+    if (!failed[i]) {
+      nodes.append(std::move(step_data.nodes[i]));
+    }
+  }
+  CLOG_ERROR(&LOG,
+             "Unable to decompress %d undo nodes of \"%s\", keeping their current data",
+             int(step_data.nodes.size() - nodes.size()),
+             step_data.object_name.c_str());
+  step_data.nodes = std::move(nodes);
+}
+
+/**
+ * Use the compressed size as the memory usage of the steps whose compression is done, without
+ * waiting for the others.
+ */
+static void update_compressed_step_sizes(UndoStack &ustack)
+{
+  LISTBASE_FOREACH (UndoStep *, us_iter, &ustack.steps) {
+    if (us_iter->type != BKE_UNDOSYS_TYPE_SCULPT) {
+      continue;
+    }
+    StepData &step_data = reinterpret_cast<SculptUndoStep *>(us_iter)->data;
+    if (step_data.compress_pool && step_data.compress_finished.load(std::memory_order_acquire)) {
+      wait_for_compression(step_data);
+      us_iter->data_size = step_data.undo_size;
+    }
+  }
+}
+
+size_t memory_in_bytes(UndoStack &ustack)
+{
+  update_compressed_step_sizes(ustack);
+  size_t size = 0;
+  LISTBASE_FOREACH (const UndoStep *, us_iter, &ustack.steps) {
+    if (us_iter->type == BKE_UNDOSYS_TYPE_SCULPT) {
+      size += us_iter->data_size;
+    }
+  }
+  return size;
+}
+
+/** \} */
+
 static void free_step_data(StepData &step_data)
 {
+  wait_for_compression(step_data);
   geometry_free_data(&step_data.geometry_original);
   geometry_free_data(&step_data.geometry_modified);
   geometry_free_data(&step_data.bmesh.geometry_enter);
@@ -1763,26 +2055,6 @@ void push_enter_sculpt_mode(const Scene & /*scene*/, Object &ob, const wmOperato
   save_common_data(ob, us);
 }
 
-static size_t node_size_in_bytes(const Node &node)
-{
-  size_t size = sizeof(Node);
-  size += node.position.as_span().size_in_bytes();
-  size += node.orig_position.as_span().size_in_bytes();
-  size += node.normal.as_span().size_in_bytes();
-  size += node.col.as_span().size_in_bytes();
-  size += node.mask.as_span().size_in_bytes();
-  size += node.loop_col.as_span().size_in_bytes();
-  size += node.vert_indices.as_span().size_in_bytes();
-  size += node.corner_indices.as_span().size_in_bytes();
-  size += node.vert_hidden.size() / 8;
-  size += node.face_hidden.size() / 8;
-  size += node.grids.as_span().size_in_bytes();
-  size += node.grid_hidden.all_bits().size() / 8;
-  size += node.face_sets.as_span().size_in_bytes();
-  size += node.face_indices.as_span().size_in_bytes();
-  return size;
-}
-
 void push_end_ex(Object &ob, const bool use_nested_undo)
 {
   StepData *step_data = get_step_data();
@@ -1803,17 +2075,7 @@ void push_end_ex(Object &ob, const bool use_nested_undo)
    * just one positions array that has a different semantic meaning depending on whether there are
    * deform modifiers. */
 
-  step_data->undo_size = threading::parallel_reduce(
-      step_data->nodes.index_range(),
-      16,
-      0,
-      [&](const IndexRange range, size_t size) {
-        for (const int i : range) {
-          size += node_size_in_bytes(*step_data->nodes[i]);
-        }
-        return size;
-      },
-      std::plus<size_t>());
+  step_data->undo_size = nodes_size_in_bytes(step_data->nodes);
 
   /* We could remove this and enforce all callers run in an operator using 'OPTYPE_UNDO'. */
   wmWindowManager *wm = static_cast<wmWindowManager *>(G_MAIN->wm.first);
@@ -1821,6 +2083,7 @@ void push_end_ex(Object &ob, const bool use_nested_undo)
     UndoStack *ustack = ED_undo_stack_get();
     BKE_undosys_step_push(ustack, nullptr, nullptr);
     if (wm->op_undo_depth == 0) {
+      update_compressed_step_sizes(*ustack);
       BKE_undosys_stack_limit_steps_and_memory_defaults(ustack);
     }
     WM_file_tag_modified();
@@ -1905,6 +2168,7 @@ static bool step_encode(bContext * /*C*/, Main *bmain, UndoStep *us_p)
    * to the current 'SculptUndoStep' added by encode_init. */
   SculptUndoStep *us = reinterpret_cast<SculptUndoStep *>(us_p);
   us->step.data_size = us->data.undo_size;
+  compress_nodes_in_background(us->data);
 
   Node *unode = us->data.nodes.is_empty() ? nullptr : us->data.nodes.last().get();
   if (unode && us->data.type == Type::DyntopoEnd) {
@@ -1923,7 +2187,9 @@ static void step_decode_undo_impl(bContext *C, Depsgraph *depsgraph, SculptUndoS
 {
   BLI_assert(us->step.is_applied == true);
 
+  decompress_nodes(us->data);
   restore_list(C, depsgraph, us->data);
+  compress_nodes_in_background(us->data);
   us->step.is_applied = false;
 }
 
@@ -1931,7 +2197,9 @@ static void step_decode_redo_impl(bContext *C, Depsgraph *depsgraph, SculptUndoS
 {
   BLI_assert(us->step.is_applied == false);
 
+  decompress_nodes(us->data);
   restore_list(C, depsgraph, us->data);
+  compress_nodes_in_background(us->data);
   us->step.is_applied = true;
 }
 
@@ -8,9 +8,12 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
+#include "BLI_array.hh"
 #include "BLI_index_mask_fwd.hh"
+#include "BLI_span.hh"
 
 struct Depsgraph;
 struct Mesh;
@@ -79,4 +82,26 @@ void restore_from_bmesh_enter_geometry(const StepData &step_data, Mesh &mesh);
 bool has_bmesh_log_entry();
 
 void restore_position_from_undo_step(const Depsgraph &depsgraph, Object &object);
+
+/**
+ * Split 32 bit values into byte planes of the deltas to the value \a stride elements before,
+ * which compress better than the values themselves. The stride is the number of components of the
+ * type of the values, e.g. 3 for `float3` positions.
+ */
+void encode_values(Span<uint32_t> values, int stride, MutableSpan<std::byte> r_planes);
+/** The inverse of #encode_values. */
+void decode_values(Span<std::byte> planes, int stride, MutableSpan<uint32_t> r_values);
+
+/**
+ * Compress byte planes created by #encode_values.
+ * \return An empty array when compression does not make the planes smaller.
+ */
+Array<std::byte, 0> compress_planes(Span<std::byte> planes);
+/**
+ * Decompress planes compressed with #compress_planes into \a r_planes.
+ * \return False when the data can't be decompressed or its size doesn't match \a r_planes,
+ * which is undefined in that case.
+ */
+bool decompress_planes(Span<std::byte> compressed_data, MutableSpan<std::byte> r_planes);
+
 }  // namespace blender::ed::sculpt_paint::undo
@@ -0,0 +1,141 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup edsculpt
+ */
+
+#include "sculpt_undo.hh"
+
+#include "BLI_math_vector_types.hh"
+#include "BLI_rand.hh"
+
+#include "testing/testing.h"
+
+namespace blender::ed::sculpt_paint::undo::tests {
+
+/* Values like those of a BVH node, neighbors are close to each other. */
+template<typename T> static Array<T> create_values(const int num)
+{
+  RandomNumberGenerator rng(num);
+  Array<T> values(num);
+  for (const int i : values.index_range()) {
+    if constexpr (std::is_same_v<T, int>) {
+      values[i] = i / 16 + rng.get_int32(2);
+    }
+    else if constexpr (std::is_same_v<T, float>) {
+      values[i] = 0.5f + 0.01f * rng.get_float();
+    }
+    else {
+      for (int j = 0; j < T::type_length; j++) {
+        values[i][j] = 1.0f + 0.01f * i + 0.001f * rng.get_float();
+      }
+    }
+  }
+  return values;
+}
+
+template<typename T> static MutableSpan<uint32_t> values_as_uint(MutableSpan<T> values)
+{
+  return {reinterpret_cast<uint32_t *>(values.data()),
+          values.size() * int64_t(sizeof(T) / sizeof(uint32_t))};
+}
+
+/* Encodes, compresses, decompresses and decodes the values, and checks that the result is the same
+ * as the values. */
+template<typename T> static void test_round_trip(const int num)
+{
+  constexpr int stride = sizeof(T) / sizeof(uint32_t);
+  Array<T> values = create_values<T>(num);
+  const Span<uint32_t> values_uint = values_as_uint(values.as_mutable_span());
+
+  Array<std::byte> planes(values_uint.size_in_bytes());
+  encode_values(values_uint, stride, planes);
+
+  Array<T> decoded(num);
+  decode_values(planes, stride, values_as_uint(decoded.as_mutable_span()));
+  EXPECT_EQ_ARRAY(values.data(), decoded.data(), values.size());
+
+  const Array<std::byte, 0> compressed_data = compress_planes(planes);
+  if (num < 100) {
+    /* The overhead of the compressed format is larger than the values. */
+    EXPECT_TRUE(compressed_data.is_empty());
+    return;
+  }
+  ASSERT_FALSE(compressed_data.is_empty());
+  EXPECT_LT(compressed_data.size(), planes.size());
+
+  Array<std::byte> decompressed_planes(planes.size());
+  EXPECT_TRUE(decompress_planes(compressed_data, decompressed_planes));
+  EXPECT_EQ_ARRAY(planes.data(), decompressed_planes.data(), planes.size());
+
+  Array<T> decompressed(num);
+  decode_values(decompressed_planes, stride, values_as_uint(decompressed.as_mutable_span()));
+  EXPECT_EQ_ARRAY(values.data(), decompressed.data(), values.size());
+}
+
+TEST(sculpt_undo, compress_float3)
+{
+  test_round_trip<float3>(0);
+  test_round_trip<float3>(1);
+  test_round_trip<float3>(1000);
+}
+
+TEST(sculpt_undo, compress_float4)
+{
+  test_round_trip<float4>(0);
+  test_round_trip<float4>(1);
+  test_round_trip<float4>(1000);
+}
+
+TEST(sculpt_undo, compress_float)
+{
+  test_round_trip<float>(0);
+  test_round_trip<float>(1);
+  test_round_trip<float>(1000);
+}
+
+TEST(sculpt_undo, compress_int)
+{
+  test_round_trip<int>(0);
+  test_round_trip<int>(1);
+  test_round_trip<int>(1000);
+}
+
+/* Values that don't compress are kept uncompressed. */
+TEST(sculpt_undo, compress_random)
+{
+  RandomNumberGenerator rng(0);
+  Array<std::byte> planes(1024);
+  for (std::byte &value : planes) {
+    value = std::byte(rng.get_uint32());
+  }
+  EXPECT_TRUE(compress_planes(planes).is_empty());
+}
+
+/* Corrupt data and data of the wrong size is not decompressed. */
+TEST(sculpt_undo, decompress_invalid)
+{
+  const Array<float3> values = create_values<float3>(1000);
+  const Span<uint32_t> values_uint(reinterpret_cast<const uint32_t *>(values.data()),
+                                   values.size() * 3);
+  Array<std::byte> planes(values_uint.size_in_bytes());
+  encode_values(values_uint, 3, planes);
+  const Array<std::byte, 0> compressed_data = compress_planes(planes);
+  ASSERT_FALSE(compressed_data.is_empty());
+
+  Array<std::byte> decompressed_planes(planes.size());
+  EXPECT_FALSE(decompress_planes(compressed_data.as_span().drop_back(1), decompressed_planes));
+
+  Array<std::byte, 0> corrupt_data = compressed_data;
+  corrupt_data.as_mutable_span().take_front(4).fill(std::byte(0));
+  EXPECT_FALSE(decompress_planes(corrupt_data, decompressed_planes));
+
+  Array<std::byte> small_planes(planes.size() - 1);
+  EXPECT_FALSE(decompress_planes(compressed_data, small_planes));
+  Array<std::byte> large_planes(planes.size() + 1);
+  EXPECT_FALSE(decompress_planes(compressed_data, large_planes));
+}
+
+}  // namespace blender::ed::sculpt_paint::undo::tests
@@ -8,6 +8,12 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
+#include "BLI_array.hh"
+#include "BLI_span.hh"
+
 /* internal exports only */
 struct ARegion;
 struct ARegionType;
@@ -100,3 +106,30 @@ void IMAGE_OT_tile_fill(wmOperatorType *ot);
  */
 ImageUser *ntree_get_active_iuser(bNodeTree *ntree);
 void image_buttons_register(ARegionType *art);
+
+/* `image_undo.cc` */
+
+/**
+ * Split the 4 channels of \a pixels_num pixels into byte planes of channel deltas, which
+ * compress better than the pixels themselves. \a T is `uint8_t` for byte pixels and `uint32_t`
+ * for the bits of float pixels.
+ */
+template<typename T>
+void image_undo_tile_pixels_encode(const T *channels, int64_t pixels_num, std::byte *r_planes);
+/** The inverse of #image_undo_tile_pixels_encode. */
+template<typename T>
+void image_undo_tile_pixels_decode(const std::byte *planes, int64_t pixels_num, T *r_channels);
+
+/**
+ * Compress the pixels of an undo tile, `ED_IMAGE_UNDO_TILE_SIZE` squared byte or float RGBA
+ * pixels.
+ * \return An empty array when compression does not make the pixels smaller.
+ */
+blender::Array<std::byte, 0> image_undo_tile_pixels_compress(const void *rect, bool has_float);
+/**
+ * Decompress pixels compressed with #image_undo_tile_pixels_compress into \a r_rect.
+ * \return False when the data can't be decompressed, \a r_rect is undefined in that case.
+ */
+bool image_undo_tile_pixels_decompress(blender::Span<std::byte> compressed_data,
+                                       bool has_float,
+                                       void *r_rect);
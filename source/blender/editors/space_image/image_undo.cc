@@ -14,20 +14,27 @@
  *     (this is the undo systems equivalent of an #ImBuf).
  *     - Each #UndoImageBuf stores an array of #UndoImageTile
  *       The tiles are shared between #UndoImageBuf's to avoid duplication.
+ *       Once a step is encoded its tiles are stored compressed.
  *
  * When the undo system manages an image, there will always be a full copy (as a #UndoImageBuf)
  * each new undo step only stores modified tiles.
  */
 
+#include <zstd.h>
+
 #include "CLG_log.h"
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_listbase.h"
 #include "BLI_map.hh"
 #include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
+#include "BLI_vector_set.hh"
 
 #include "DNA_image_types.h"
 #include "DNA_object_types.h"
@@ -53,6 +60,8 @@
 
 #include "WM_api.hh"
 
+#include "image_intern.hh"
+
 static CLG_LogRef LOG = {"ed.image.undo"};
 
 /* -------------------------------------------------------------------- */
@@ -219,25 +228,27 @@ void *ED_image_paint_tile_push(PaintTileMap *paint_tile_map,
                                bool use_thread_lock,
                                bool find_prev)
 {
-  if (use_thread_lock) {
-    BLI_spin_lock(&paint_tiles_lock);
-  }
   const bool has_float = (ibuf->float_buffer.data != nullptr);
 
   /* check if tile is already pushed */
 
   /* in projective painting we keep accounting of tiles, so if we need one pushed, just push! */
   if (find_prev) {
+    if (use_thread_lock) {
+      BLI_spin_lock(&paint_tiles_lock);
+    }
     void *data = ED_image_paint_tile_find(
         paint_tile_map, image, ibuf, iuser, x_tile, y_tile, r_mask, true);
+    if (use_thread_lock) {
+      BLI_spin_unlock(&paint_tiles_lock);
+    }
     if (data) {
-      if (use_thread_lock) {
-        BLI_spin_unlock(&paint_tiles_lock);
-      }
       return data;
     }
   }
 
+  /* Copy the pixels without holding the lock, so that multiple threads can push tiles at the same
+   * time. Only adding the tile to the map has to be locked. */
   if (*tmpibuf == nullptr) {
     *tmpibuf = imbuf_alloc_temp_tile();
   }
@@ -254,7 +265,7 @@ void *ED_image_paint_tile_push(PaintTileMap *paint_tile_map,
 
   /* add mask explicitly here */
   if (r_mask) {
-    *r_mask = ptile->mask = static_cast<uint16_t *>(
+    ptile->mask = static_cast<uint16_t *>(
         MEM_callocN(sizeof(uint16_t) * square_i(ED_IMAGE_UNDO_TILE_SIZE), "PaintTile.mask"));
   }
 
@@ -265,10 +276,6 @@ void *ED_image_paint_tile_push(PaintTileMap *paint_tile_map,
   ptile->use_float = has_float;
   ptile->valid = true;
 
-  if (r_valid) {
-    *r_valid = &ptile->valid;
-  }
-
   IMB_rectcpy(*tmpibuf,
               ibuf,
               0,
@@ -292,15 +299,29 @@ void *ED_image_paint_tile_push(PaintTileMap *paint_tile_map,
   key.x_tile = x_tile;
   key.y_tile = y_tile;
   PaintTile *existing_tile = nullptr;
+
+  if (use_thread_lock) {
+    BLI_spin_lock(&paint_tiles_lock);
+  }
   paint_tile_map->map.add_or_modify(
       key,
       [&](PaintTile **pptile) { *pptile = ptile; },
       [&](PaintTile **pptile) { existing_tile = *pptile; });
   if (existing_tile) {
+    /* Another thread pushed the same tile in the meantime. */
     ptile_free(ptile);
     ptile = existing_tile;
+    if (r_mask && !ptile->mask) {
+      ptile->mask = static_cast<uint16_t *>(
+          MEM_callocN(sizeof(uint16_t) * square_i(ED_IMAGE_UNDO_TILE_SIZE), "PaintTile.mask"));
+    }
+  }
+  if (r_mask) {
+    *r_mask = ptile->mask;
+  }
+  if (r_valid) {
+    *r_valid = &ptile->valid;
   }
-
   if (use_thread_lock) {
     BLI_spin_unlock(&paint_tiles_lock);
   }
@@ -373,26 +394,26 @@ static uint32_t index_from_xy(uint32_t tile_x, uint32_t tile_y, const uint32_t t
 }
 
 struct UndoImageTile {
+  /** The uncompressed pixels, null once the tile is compressed. */
   union {
     float *fp;
     uint8_t *byte_ptr;
     void *pt;
-  } rect;
-  int users;
+  } rect = {nullptr};
+  /** The pixels compressed with #utile_compress. */
+  blender::Array<std::byte, 0> compressed_data;
+  int users = 0;
 };
 
+static size_t utile_size_in_bytes(const bool has_float)
+{
+  return (has_float ? sizeof(float[4]) : sizeof(uint32_t)) * square_i(ED_IMAGE_UNDO_TILE_SIZE);
+}
+
 static UndoImageTile *utile_alloc(bool has_float)
 {
-  UndoImageTile *utile = static_cast<UndoImageTile *>(
-      MEM_callocN(sizeof(*utile), "ImageUndoTile"));
-  if (has_float) {
-    utile->rect.fp = static_cast<float *>(
-        MEM_mallocN(sizeof(float[4]) * square_i(ED_IMAGE_UNDO_TILE_SIZE), __func__));
-  }
-  else {
-    utile->rect.byte_ptr = static_cast<uint8_t *>(
-        MEM_mallocN(sizeof(uint32_t) * square_i(ED_IMAGE_UNDO_TILE_SIZE), __func__));
-  }
+  UndoImageTile *utile = MEM_new<UndoImageTile>("ImageUndoTile");
+  utile->rect.pt = MEM_mallocN(utile_size_in_bytes(has_float), __func__);
   return utile;
 }
 
@@ -401,6 +422,12 @@ static void utile_init_from_imbuf(
 {
   const bool has_float = ibuf->float_buffer.data;
 
+  if (utile->rect.pt == nullptr) {
+    /* The tile is overwritten, so its compressed pixels aren't needed anymore. */
+    utile->rect.pt = MEM_mallocN(utile_size_in_bytes(has_float), __func__);
+    utile->compressed_data = {};
+  }
+
   if (has_float) {
     utile->rect.fp = image_undo_steal_and_assign_float_buffer(tmpibuf, utile->rect.fp);
   }
@@ -420,10 +447,132 @@ static void utile_init_from_imbuf(
   }
 }
 
+/**
+ * Before compression every channel is replaced by its difference to the same channel of the
+ * previous pixel, and the bytes are split into planes per channel and byte. Neighboring pixels of
+ * painted textures are usually similar, so the planes are mostly small values and zeros. Float
+ * channels are handled as integers, which works well because the bits of similar positive floats
+ * are close as integers too.
+ */
+template<typename T>
+void image_undo_tile_pixels_encode(const T *channels,
+                                   const int64_t pixels_num,
+                                   std::byte *r_planes)
+{
+  for (int64_t pixel = 0; pixel < pixels_num; pixel++) {
+    for (int channel = 0; channel < 4; channel++) {
+      const int64_t i = pixel * 4 + channel;
+      const T delta = pixel == 0 ? channels[i] : T(channels[i] - channels[i - 4]);
+      for (int byte = 0; byte < int(sizeof(T)); byte++) {
+        const int plane = channel * sizeof(T) + byte;
+        r_planes[plane * pixels_num + pixel] = std::byte(delta >> (byte * 8));
+      }
+    }
+  }
+}
+
+template<typename T>
+void image_undo_tile_pixels_decode(const std::byte *planes,
+                                   const int64_t pixels_num,
+                                   T *r_channels)
+{
+  for (int64_t pixel = 0; pixel < pixels_num; pixel++) {
+    for (int channel = 0; channel < 4; channel++) {
+      const int64_t i = pixel * 4 + channel;
+      T delta = 0;
+      for (int byte = 0; byte < int(sizeof(T)); byte++) {
+        const int plane = channel * sizeof(T) + byte;
+        delta |= T(planes[plane * pixels_num + pixel]) << (byte * 8);
+      }
+      r_channels[i] = pixel == 0 ? delta : T(delta + r_channels[i - 4]);
+    }
+  }
+}
+
+template void image_undo_tile_pixels_encode(const uint8_t *, int64_t, std::byte *);
+template void image_undo_tile_pixels_encode(const uint32_t *, int64_t, std::byte *);
+template void image_undo_tile_pixels_decode(const std::byte *, int64_t, uint8_t *);
+template void image_undo_tile_pixels_decode(const std::byte *, int64_t, uint32_t *);
+
+blender::Array<std::byte, 0> image_undo_tile_pixels_compress(const void *rect,
+                                                             const bool has_float)
+{
+  const size_t size = utile_size_in_bytes(has_float);
+  const int64_t pixels_num = square_i(ED_IMAGE_UNDO_TILE_SIZE);
+
+  blender::Array<std::byte> planes(size, blender::NoInitialization());
+  if (has_float) {
+    image_undo_tile_pixels_encode(static_cast<const uint32_t *>(rect), pixels_num, planes.data());
+  }
+  else {
+    image_undo_tile_pixels_encode(static_cast<const uint8_t *>(rect), pixels_num, planes.data());
+  }
+
+  blender::Array<std::byte> buffer(ZSTD_compressBound(size), blender::NoInitialization());
+  const size_t compressed_size = ZSTD_compress(
+      buffer.data(), buffer.size(), planes.data(), planes.size(), 1);
+  if (ZSTD_isError(compressed_size) || compressed_size >= size) {
+    return {};
+  }
+  return blender::Array<std::byte, 0>(buffer.as_span().take_front(compressed_size));
+}
+
+bool image_undo_tile_pixels_decompress(const blender::Span<std::byte> compressed_data,
+                                       const bool has_float,
+                                       void *r_rect)
+{
+  const size_t size = utile_size_in_bytes(has_float);
+  blender::Array<std::byte> planes(size, blender::NoInitialization());
+  const size_t decompressed_size = ZSTD_decompress(
+      planes.data(), planes.size(), compressed_data.data(), compressed_data.size());
+  if (ZSTD_isError(decompressed_size) || decompressed_size != size) {
+    return false;
+  }
+  const int64_t pixels_num = square_i(ED_IMAGE_UNDO_TILE_SIZE);
+  if (has_float) {
+    image_undo_tile_pixels_decode(planes.data(), pixels_num, static_cast<uint32_t *>(r_rect));
+  }
+  else {
+    image_undo_tile_pixels_decode(planes.data(), pixels_num, static_cast<uint8_t *>(r_rect));
+  }
+  return true;
+}
+
+static void utile_compress(UndoImageTile *utile, const bool has_float)
+{
+  BLI_assert(utile->rect.pt != nullptr);
+  blender::Array<std::byte, 0> compressed_data = image_undo_tile_pixels_compress(utile->rect.pt,
+                                                                                 has_float);
+  if (compressed_data.is_empty()) {
+    /* Keep the uncompressed pixels. */
+    return;
+  }
+
+  utile->compressed_data = std::move(compressed_data);
+  MEM_freeN(utile->rect.pt);
+  utile->rect.pt = nullptr;
+}
+
 static void utile_restore(
     const UndoImageTile *utile, const uint x, const uint y, ImBuf *ibuf, ImBuf *tmpibuf)
 {
   const bool has_float = ibuf->float_buffer.data;
+
+  if (utile->rect.pt == nullptr) {
+    /* The temporary tile has both buffers, so the pixels can be decompressed into it. */
+    if (!image_undo_tile_pixels_decompress(
+            utile->compressed_data,
+            has_float,
+            has_float ? static_cast<void *>(tmpibuf->float_buffer.data) :
+                        static_cast<void *>(tmpibuf->byte_buffer.data)))
+    {
+      CLOG_ERROR(&LOG, "Unable to decompress undo tile at %u, %u, keeping current pixels", x, y);
+      return;
+    }
+    IMB_rectcpy(ibuf, tmpibuf, x, y, 0, 0, ED_IMAGE_UNDO_TILE_SIZE, ED_IMAGE_UNDO_TILE_SIZE);
+    return;
+  }
+
   float *prev_rect_float = tmpibuf->float_buffer.data;
   uint8_t *prev_rect = tmpibuf->byte_buffer.data;
 
@@ -447,7 +596,9 @@ static void utile_decref(UndoImageTile *utile)
   utile->users -= 1;
   BLI_assert(utile->users >= 0);
   if (utile->users == 0) {
-    MEM_freeN(utile->rect.pt);
+    if (utile->rect.pt) {
+      MEM_freeN(utile->rect.pt);
+    }
     MEM_delete(utile);
   }
 }
@@ -814,6 +965,72 @@ static void image_undosys_step_encode_init(bContext * /*C*/, UndoStep *us_p)
   us->paint_tile_map = MEM_new<PaintTileMap>(__func__);
 }
 
+/** The tiles added by an encoded step, compressed in the background. */
+struct ImageUndoCompression {
+  blender::VectorSet<UndoImageTile *> tiles;
+  blender::Vector<bool> tiles_use_float;
+};
+
+/**
+ * Compresses the tiles of the last encoded step. Tiles are shared between steps, so this must be
+ * waited for before any step is encoded, restored or freed, see #image_undo_wait_for_compression.
+ */
+static TaskPool *compress_pool = nullptr;
+
+static void image_undo_compress_tiles_task(TaskPool *__restrict pool, void * /*task_data*/)
+{
+  ImageUndoCompression &compression = *static_cast<ImageUndoCompression *>(
+      BLI_task_pool_user_data(pool));
+  blender::threading::parallel_for(
+      compression.tiles.index_range(), 16, [&](const blender::IndexRange range) {
+        for (const int64_t i : range) {
+          utile_compress(compression.tiles[i], compression.tiles_use_float[i]);
+        }
+      });
+}
+
+/**
+ * Start compressing the tiles that were added by this step, the tiles shared with previous steps
+ * are compressed already.
+ */
+static void image_undosys_step_compress_tiles_in_background(ImageUndoStep *us)
+{
+  BLI_assert(compress_pool == nullptr);
+  ImageUndoCompression *compression = MEM_new<ImageUndoCompression>(__func__);
+  LISTBASE_FOREACH (UndoImageHandle *, uh, &us->handles) {
+    LISTBASE_FOREACH (UndoImageBuf *, ubuf_pre, &uh->buffers) {
+      for (const UndoImageBuf *ubuf : {ubuf_pre, ubuf_pre->post}) {
+        for (uint i = 0; i < ubuf->tiles_len; i++) {
+          UndoImageTile *utile = ubuf->tiles[i];
+          if (utile->rect.pt && compression->tiles.add(utile)) {
+            compression->tiles_use_float.append(ubuf->image_state.use_float);
+          }
+        }
+      }
+    }
+  }
+
+  if (compression->tiles.is_empty()) {
+    MEM_delete(compression);
+    return;
+  }
+  compress_pool = BLI_task_pool_create_background(compression, TASK_PRIORITY_LOW);
+  BLI_task_pool_push(compress_pool, image_undo_compress_tiles_task, nullptr, false, nullptr);
+}
+
+static void image_undo_wait_for_compression()
+{
+  if (!compress_pool) {
+    return;
+  }
+  ImageUndoCompression *compression = static_cast<ImageUndoCompression *>(
+      BLI_task_pool_user_data(compress_pool));
+  BLI_task_pool_work_and_wait(compress_pool);
+  BLI_task_pool_free(compress_pool);
+  compress_pool = nullptr;
+  MEM_delete(compression);
+}
+
 static bool image_undosys_step_encode(bContext *C, Main * /*bmain*/, UndoStep *us_p)
 {
   /* Encoding is done along the way by adding tiles
@@ -826,6 +1043,8 @@ static bool image_undosys_step_encode(bContext *C, Main * /*bmain*/, UndoStep *u
   BLI_assert(us->step.data_size == 0);
 
   if (us->is_encode_init) {
+    /* The tiles of the reference step may still be compressed. */
+    image_undo_wait_for_compression();
 
     ImBuf *tmpibuf = imbuf_alloc_temp_tile();
 
@@ -841,8 +1060,7 @@ static bool image_undosys_step_encode(bContext *C, Main * /*bmain*/, UndoStep *u
         UndoImageHandle *uh = uhandle_ensure(&us->handles, ptile->image, &ptile->iuser);
         UndoImageBuf *ubuf_pre = uhandle_ensure_ubuf(uh, ptile->image, ptile->ibuf);
 
-        UndoImageTile *utile = static_cast<UndoImageTile *>(
-            MEM_callocN(sizeof(*utile), "UndoImageTile"));
+        UndoImageTile *utile = MEM_new<UndoImageTile>("UndoImageTile");
         utile->users = 1;
         utile->rect.pt = ptile->rect.pt;
         ptile->rect.pt = nullptr;
@@ -937,8 +1155,11 @@ static bool image_undosys_step_encode(bContext *C, Main * /*bmain*/, UndoStep *u
 
     IMB_freeImBuf(tmpibuf);
 
+    image_undosys_step_compress_tiles_in_background(us);
+
     /* Useful to debug tiles are stored correctly. */
     if (false) {
+      image_undo_wait_for_compression();
       uhandle_restore_list(&us->handles, false);
     }
   }
@@ -1015,6 +1236,7 @@ static void image_undosys_step_decode(
   BLI_assert(dir != STEP_INVALID);
 
   ImageUndoStep *us = reinterpret_cast<ImageUndoStep *>(us_p);
+  image_undo_wait_for_compression();
   if (dir == STEP_UNDO) {
     image_undosys_step_decode_undo(us, is_final);
   }
@@ -1033,6 +1255,7 @@ static void image_undosys_step_decode(
 static void image_undosys_step_free(UndoStep *us_p)
 {
   ImageUndoStep *us = (ImageUndoStep *)us_p;
+  image_undo_wait_for_compression();
   uhandle_free_list(&us->handles);
 
   /* Typically this map will have been cleared. */
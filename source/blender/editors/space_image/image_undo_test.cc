@@ -0,0 +1,152 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <cstring>
+#include <random>
+
+#include "BLI_array.hh"
+
+#include "ED_paint.hh"
+
+#include "image_intern.hh"
+
+#include "testing/testing.h"
+
+namespace blender::ed::image::tests {
+
+static constexpr int64_t TILE_PIXELS_NUM = ED_IMAGE_UNDO_TILE_SIZE * ED_IMAGE_UNDO_TILE_SIZE;
+
+TEST(image_undo, pixels_encode_byte)
+{
+  const uint8_t channels[8] = {10, 20, 30, 40, 12, 18, 30, 41};
+  std::byte planes[8];
+  image_undo_tile_pixels_encode(channels, 2, planes);
+  /* One plane per channel, with the first value and the difference to it. */
+  const uint8_t expected[8] = {10, 2, 20, 254, 30, 0, 40, 1};
+  for (const int i : IndexRange(8)) {
+    EXPECT_EQ(uint8_t(planes[i]), expected[i]) << "byte " << i;
+  }
+
+  uint8_t decoded[8];
+  image_undo_tile_pixels_decode(planes, 2, decoded);
+  EXPECT_EQ(memcmp(decoded, channels, sizeof(channels)), 0);
+}
+
+TEST(image_undo, pixels_encode_uint32)
+{
+  const uint32_t channels[8] = {0x01020304, 0, 0, 0xFFFFFFFF, 0x01020305, 0x00000100, 0, 0};
+  std::byte planes[32];
+  image_undo_tile_pixels_encode(channels, 2, planes);
+  /* Four planes per channel, from the least to the most significant byte. */
+  const uint8_t expected[32] = {0x04, 0x01, 0x03, 0x00, 0x02, 0x00, 0x01, 0x00,
+                                0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+                                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                0xFF, 0x01, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00};
+  for (const int i : IndexRange(32)) {
+    EXPECT_EQ(uint8_t(planes[i]), expected[i]) << "byte " << i;
+  }
+
+  uint32_t decoded[8];
+  image_undo_tile_pixels_decode(planes, 2, decoded);
+  EXPECT_EQ(memcmp(decoded, channels, sizeof(channels)), 0);
+}
+
+TEST(image_undo, pixels_encode_decode_random)
+{
+  std::mt19937 rng(0);
+  for (const int64_t pixels_num : {1, 3, 5, 64}) {
+    Array<uint8_t> bytes(pixels_num * 4);
+    Array<uint32_t> words(pixels_num * 4);
+    for (const int64_t i : bytes.index_range()) {
+      bytes[i] = uint8_t(rng());
+      words[i] = uint32_t(rng());
+    }
+
+    Array<std::byte> planes(pixels_num * 4 * sizeof(uint32_t));
+    Array<uint8_t> bytes_decoded(bytes.size());
+    image_undo_tile_pixels_encode(bytes.data(), pixels_num, planes.data());
+    image_undo_tile_pixels_decode(planes.data(), pixels_num, bytes_decoded.data());
+    EXPECT_EQ(bytes_decoded, bytes);
+
+    Array<uint32_t> words_decoded(words.size());
+    image_undo_tile_pixels_encode(words.data(), pixels_num, planes.data());
+    image_undo_tile_pixels_decode(planes.data(), pixels_num, words_decoded.data());
+    EXPECT_EQ(words_decoded, words);
+  }
+}
+
+TEST(image_undo, compress_byte)
+{
+  /* A smooth gradient like most painted textures, which should compress well. */
+  Array<uint8_t> rect(TILE_PIXELS_NUM * 4);
+  for (const int64_t pixel : IndexRange(TILE_PIXELS_NUM)) {
+    const int x = pixel % ED_IMAGE_UNDO_TILE_SIZE;
+    const int y = pixel / ED_IMAGE_UNDO_TILE_SIZE;
+    rect[pixel * 4 + 0] = uint8_t(x * 2);
+    rect[pixel * 4 + 1] = uint8_t(y * 3);
+    rect[pixel * 4 + 2] = uint8_t(x + y);
+    rect[pixel * 4 + 3] = 255;
+  }
+
+  const Array<std::byte, 0> compressed = image_undo_tile_pixels_compress(rect.data(), false);
+  EXPECT_FALSE(compressed.is_empty());
+  EXPECT_LT(compressed.size(), rect.as_span().size_in_bytes() / 4);
+
+  Array<uint8_t> decompressed(rect.size(), 0);
+  EXPECT_TRUE(image_undo_tile_pixels_decompress(compressed, false, decompressed.data()));
+  EXPECT_EQ(decompressed, rect);
+}
+
+TEST(image_undo, compress_float)
+{
+  Array<float> rect(TILE_PIXELS_NUM * 4);
+  for (const int64_t pixel : IndexRange(TILE_PIXELS_NUM)) {
+    const int x = pixel % ED_IMAGE_UNDO_TILE_SIZE;
+    const int y = pixel / ED_IMAGE_UNDO_TILE_SIZE;
+    rect[pixel * 4 + 0] = x / float(ED_IMAGE_UNDO_TILE_SIZE);
+    rect[pixel * 4 + 1] = 0.5f;
+    rect[pixel * 4 + 2] = y * 0.01f - 0.25f;
+    rect[pixel * 4 + 3] = 1.0f;
+  }
+
+  const Array<std::byte, 0> compressed = image_undo_tile_pixels_compress(rect.data(), true);
+  EXPECT_FALSE(compressed.is_empty());
+  EXPECT_LT(compressed.size(), rect.as_span().size_in_bytes());
+
+  /* Compare the bits, the floats have to be restored exactly. */
+  Array<float> decompressed(rect.size(), 0.0f);
+  EXPECT_TRUE(image_undo_tile_pixels_decompress(compressed, true, decompressed.data()));
+  EXPECT_EQ(memcmp(decompressed.data(), rect.data(), rect.as_span().size_in_bytes()), 0);
+}
+
+TEST(image_undo, compress_noise)
+{
+  /* Random pixels don't get smaller, the tile is kept uncompressed. */
+  std::mt19937 rng(0);
+  Array<uint8_t> rect(TILE_PIXELS_NUM * 4);
+  for (uint8_t &value : rect) {
+    value = uint8_t(rng());
+  }
+  EXPECT_TRUE(image_undo_tile_pixels_compress(rect.data(), false).is_empty());
+}
+
+TEST(image_undo, decompress_invalid)
+{
+  Array<uint8_t> rect(TILE_PIXELS_NUM * 4, 0);
+  const Array<std::byte, 0> compressed = image_undo_tile_pixels_compress(rect.data(), false);
+  ASSERT_FALSE(compressed.is_empty());
+
+  Array<uint8_t> decompressed(rect.size());
+  /* Garbage data. */
+  Array<std::byte> garbage(16, std::byte(0xAB));
+  EXPECT_FALSE(image_undo_tile_pixels_decompress(garbage, false, decompressed.data()));
+  /* Truncated data. */
+  EXPECT_FALSE(image_undo_tile_pixels_decompress(
+      compressed.as_span().drop_back(1), false, decompressed.data()));
+  /* Byte pixels decompressed as float pixels have the wrong size. */
+  Array<float> decompressed_float(rect.size());
+  EXPECT_FALSE(image_undo_tile_pixels_decompress(compressed, true, decompressed_float.data()));
+}
+
+}  // namespace blender::ed::image::tests
@@ -56,6 +56,8 @@
 #include "DEG_depsgraph_query.hh"
 
 #include "ED_info.hh"
+#include "ED_sculpt.hh"
+#include "ED_undo.hh"
 
 #include "WM_api.hh"
 
@@ -89,6 +91,8 @@ struct SceneStatsFmt {
       totgpframe[BLI_STR_FORMAT_UINT64_GROUPED_SIZE];
   char totgpstroke[BLI_STR_FORMAT_UINT64_GROUPED_SIZE],
       totgppoint[BLI_STR_FORMAT_UINT64_GROUPED_SIZE];
+  /* Not cached in #SceneStats, the size changes when undo steps are compressed. */
+  char sculptundomem[BLI_STR_FORMAT_INT64_BYTE_UNIT_SIZE];
 };
 
 static bool stats_mesheval(const Mesh *mesh_eval, bool is_selected, SceneStats *stats)
@@ -512,6 +516,16 @@ static bool format_stats(
   SCENE_STATS_FMT_INT(totgppoint);
 
 #undef SCENE_STATS_FMT_INT
+
+  stats_fmt->sculptundomem[0] = '\0';
+  BKE_view_layer_synced_ensure(scene, view_layer);
+  const Object *ob = BKE_view_layer_active_object_get(view_layer);
+  UndoStack *ustack = ED_undo_stack_get();
+  if (ob && (ob->mode & OB_MODE_SCULPT) && ustack) {
+    BLI_str_format_byte_unit(stats_fmt->sculptundomem,
+                             blender::ed::sculpt_paint::undo::memory_in_bytes(*ustack),
+                             false);
+  }
   return true;
 }
 
@@ -605,6 +619,10 @@ static void get_stats_string(char *info,
                                 stats_fmt->totvertsculpt,
                                 stats_fmt->totfacesculpt);
     }
+    if (stats_fmt->sculptundomem[0]) {
+      *ofs += BLI_snprintf_rlen(
+          info + *ofs, len - *ofs, IFACE_(" | Undo:%s"), stats_fmt->sculptundomem);
+    }
   }
   else {
     *ofs += BLI_snprintf_rlen(info + *ofs,
@@ -768,6 +786,7 @@ void ED_info_draw_stats(
     STROKES,
     POINTS,
     LIGHTS,
+    UNDO_MEMORY,
     MAX_LABELS_COUNT
   };
   char labels[MAX_LABELS_COUNT][64];
@@ -784,6 +803,7 @@ void ED_info_draw_stats(
   STRNCPY_UTF8(labels[STROKES], IFACE_("Strokes"));
   STRNCPY_UTF8(labels[POINTS], IFACE_("Points"));
   STRNCPY_UTF8(labels[LIGHTS], IFACE_("Lights"));
+  STRNCPY_UTF8(labels[UNDO_MEMORY], IFACE_("Undo Memory"));
 
   int longest_label = 0;
   for (int i = 0; i < MAX_LABELS_COUNT; ++i) {
@@ -847,6 +867,9 @@ void ED_info_draw_stats(
       stats_row(col1, labels[VERTS], col2, stats_fmt.totvertsculpt, nullptr, y, height);
       stats_row(col1, labels[FACES], col2, stats_fmt.totfacesculpt, nullptr, y, height);
     }
+    if (stats_fmt.sculptundomem[0]) {
+      stats_row(col1, labels[UNDO_MEMORY], col2, stats_fmt.sculptundomem, nullptr, y, height);
+    }
   }
   else if (ob && (object_mode & OB_MODE_POSE)) {
     stats_row(col1, labels[BONES], col2, stats_fmt.totbonesel, stats_fmt.totbone, y, height);
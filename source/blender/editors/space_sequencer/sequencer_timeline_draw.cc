@@ -1845,6 +1845,42 @@ static void draw_cache_view(const bContext *C)
   GPU_blend(GPU_BLEND_NONE);
 }
 
+/* Draw the usage statistics of the cache below the final cache stripe. Like the cache stripes of
+ * strips, this is only shown with developer extras enabled. */
+static void draw_cache_statistics(const bContext *C, const ARegion *region)
+{
+  Scene *scene = CTX_data_scene(C);
+  const SpaceSeq *sseq = CTX_wm_space_seq(C);
+
+  if ((sseq->flag & SEQ_SHOW_OVERLAY) == 0 || (sseq->cache_overlay.flag & SEQ_CACHE_SHOW) == 0 ||
+      (U.flag & USER_DEVELOPER_UI) == 0)
+  {
+    return;
+  }
+
+  const seq::CacheStatistics statistics = seq::cache_statistics_get(scene);
+  const int64_t lookups = statistics.hits + statistics.misses;
+  const float hit_rate = lookups > 0 ? float(statistics.hits) / float(lookups) : 0.0f;
+
+  char memory_str[BLI_STR_FORMAT_INT64_BYTE_UNIT_SIZE];
+  BLI_str_format_byte_unit(memory_str, statistics.memory_in_use, false);
+
+  char text[256];
+  const size_t text_len = SNPRINTF_RLEN(text,
+                                        "Cache: %lld images, %s, %.1f%% hits, %lld evictions",
+                                        (long long int)statistics.items_num,
+                                        memory_str,
+                                        hit_rate * 100.0f,
+                                        (long long int)statistics.evictions);
+
+  const int font_id = BLF_set_default();
+  UI_FontThemeColor(font_id, TH_TEXT);
+  const float x = 10.0f * UI_SCALE_FAC;
+  const float y = region->winy - UI_TIME_SCRUB_MARGIN_Y - UI_TIME_CACHE_MARGIN_Y -
+                  20.0f * UI_SCALE_FAC;
+  BLF_draw_default(x, y, 0.0f, text, text_len);
+}
+
 /* Draw sequencer timeline. */
 static void draw_overlap_frame_indicator(const Scene *scene, const View2D *v2d)
 {
@@ -1972,6 +2008,7 @@ void draw_timeline_seq_display(const bContext *C, ARegion *region)
       draw_overlap_frame_indicator(scene, v2d);
     }
     UI_view2d_view_restore(C);
+    draw_cache_statistics(C, region);
   }
 
   ED_time_scrub_draw_current_frame(region, scene, !(sseq->flag & SEQ_DRAWFRAMES));
@@ -249,6 +249,7 @@ void ED_editors_exit(Main *bmain, bool do_undo_system)
   /* global in meshtools... */
   ED_mesh_mirror_spatial_table_end(nullptr);
   ED_mesh_mirror_topo_table_end(nullptr);
+  ED_paint_proj_coverage_cache_free();
 }
 
 bool ED_editors_flush_edits_for_object_ex(Main *bmain,
@@ -37,6 +37,20 @@ class GraphExecutorLogger {
                                       const Params &params,
                                       const Context &context) const;
 
+  /**
+   * Called after a node has been executed with the number of bytes the executor allocated from its
+   * #LinearAllocator for the outputs of that node during this execution.
+   */
+  virtual void log_node_allocated_bytes(const FunctionNode &node,
+                                        int64_t allocated_bytes,
+                                        const Context &context) const;
+
+  /**
+   * Called when scheduled nodes that have been pushed to the task pool by one thread are picked up
+   * by another thread.
+   */
+  virtual void log_scheduled_nodes_stolen(int64_t nodes_num, const Context &context) const;
+
   virtual void dump_when_outputs_are_missing(const FunctionNode &node,
                                              Span<const OutputSocket *> missing_sockets,
                                              const Context &context) const;
@@ -0,0 +1,119 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup fn
+ *
+ * A #GraphExecutorLogger that records when and on which thread every node is executed. The
+ * recorded data can be summarized per node or exported in the Chrome Trace Event format
+ * (`chrome://tracing`, Perfetto) and the speedscope format to be viewed as flame-graph.
+ *
+ * The profiler is thread-safe and can be shared by many graph executors, which makes it possible
+ * to gather timings over e.g. an entire frame range.
+ */
+
+#include <atomic>
+#include <iosfwd>
+
+#include "BLI_enumerable_thread_specific.hh"
+#include "BLI_map.hh"
+#include "BLI_timeit.hh"
+#include "BLI_vector.hh"
+
+#include "FN_lazy_function_graph_executor.hh"
+
+namespace blender::fn::lazy_function {
+
+/** Accumulated timings of all executions of nodes with the same name. */
+struct NodeProfileSummary {
+  std::string name;
+  int64_t executions_num = 0;
+  /** Wall time including the time spent in nested graph executions. */
+  timeit::Nanoseconds total_time{0};
+  /** Wall time excluding the time spent in nodes that ran nested on the same thread. */
+  timeit::Nanoseconds self_time{0};
+  int64_t allocated_bytes = 0;
+};
+
+class GraphExecutorProfiler : public GraphExecutorLogger {
+ private:
+  /** Index into #ThreadProfile::names. Using indices avoids storing a string per event. */
+  using NameIndex = int;
+
+  struct NodeExecution {
+    NameIndex name;
+    timeit::TimePoint start;
+    timeit::TimePoint end;
+    /** Time spent in nodes that were executed nested inside of this node on the same thread. */
+    timeit::Nanoseconds children_time{0};
+    int64_t allocated_bytes = 0;
+  };
+
+  struct TaskSteal {
+    timeit::TimePoint time;
+    int64_t nodes_num;
+  };
+
+  struct ThreadProfile {
+    int thread_index;
+    Vector<std::string> names;
+    Map<std::string, NameIndex> name_indices;
+    Vector<NodeExecution> executions;
+    Vector<TaskSteal> steals;
+    /** Indices into #executions of nodes that are currently running on this thread. */
+    Vector<int64_t> running;
+    /** Index of the execution that finished last, allocations are reported after it ended. */
+    int64_t last_finished = -1;
+  };
+
+  timeit::TimePoint start_time_;
+  std::atomic<int> threads_num_ = 0;
+  mutable threading::EnumerableThreadSpecific<ThreadProfile> thread_profiles_;
+
+ public:
+  GraphExecutorProfiler();
+
+  void log_before_node_execute(const FunctionNode &node,
+                               const Params &params,
+                               const Context &context) const override;
+  void log_after_node_execute(const FunctionNode &node,
+                              const Params &params,
+                              const Context &context) const override;
+  void log_node_allocated_bytes(const FunctionNode &node,
+                                int64_t allocated_bytes,
+                                const Context &context) const override;
+  void log_scheduled_nodes_stolen(int64_t nodes_num, const Context &context) const override;
+
+  /** Total number of node executions recorded so far. */
+  int64_t executions_num() const;
+  /** Number of times scheduled nodes were taken over by another thread. */
+  int64_t steals_num() const;
+
+  /**
+   * Accumulate the timings per node name, sorted by descending self time.
+   * Must not be called while the profiler is recording.
+   */
+  Vector<NodeProfileSummary> summary() const;
+
+  /**
+   * Write all recorded events in the Trace Event Format, which can be opened with
+   * `chrome://tracing` or Perfetto. Must not be called while the profiler is recording.
+   */
+  void write_chrome_trace(std::ostream &stream) const;
+
+  /**
+   * Write all recorded events as evented speedscope profile with one profile per thread.
+   * Must not be called while the profiler is recording.
+   */
+  void write_speedscope(std::ostream &stream) const;
+
+ private:
+  ThreadProfile &thread_profile() const;
+  /** Sorted by thread index, so that exported files are deterministic. */
+  Vector<const ThreadProfile *> sorted_thread_profiles() const;
+};
+
+}  // namespace blender::fn::lazy_function
@@ -2,6 +2,8 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <cstring>
+
 #include "BLI_array_utils.hh"
 #include "BLI_map.hh"
 #include "BLI_multi_value_map.hh"
@@ -140,6 +142,94 @@ static Set<GFieldRef> find_varying_fields(const FieldTreeInfo &field_tree_info,
   return found_fields;
 }
 
+/** Identifies a function call in the procedure by the function and its input variables. */
+struct ProcedureCallKey {
+  const mf::MultiFunction *fn;
+  Vector<mf::Variable *> inputs;
+
+  uint64_t hash() const
+  {
+    uint64_t hash = get_default_hash(fn);
+    for (const mf::Variable *variable : inputs) {
+      hash = get_default_hash(hash, variable);
+    }
+    return hash;
+  }
+
+  friend bool operator==(const ProcedureCallKey &a, const ProcedureCallKey &b)
+  {
+    return a.fn == b.fn && a.inputs == b.inputs;
+  }
+};
+
+/**
+ * Used to find constants with the same value, even if they come from different field nodes.
+ * Trivial types are compared bitwise, so that e.g. `0.0f` and `-0.0f` stay separate constants.
+ */
+struct ConstantValueKey {
+  GPointer value;
+
+  uint64_t hash() const
+  {
+    return value.type()->hash_or_fallback(value.get(), get_default_hash(value.get()));
+  }
+
+  friend bool operator==(const ConstantValueKey &a, const ConstantValueKey &b)
+  {
+    if (a.value.type() != b.value.type()) {
+      return false;
+    }
+    if (a.value.get() == b.value.get()) {
+      return true;
+    }
+    const CPPType &type = *a.value.type();
+    if (type.is_trivial()) {
+      return memcmp(a.value.get(), b.value.get(), type.size()) == 0;
+    }
+    return type.is_equal_or_false(a.value.get(), b.value.get());
+  }
+};
+
+/**
+ * Evaluate a function whose inputs are all constant once while the procedure is built, instead of
+ * evaluating it for every segment when the procedure is executed. The computed outputs are owned
+ * by the scope.
+ */
+static Vector<GPointer> evaluate_operation_on_constants(ResourceScope &scope,
+                                                        const mf::MultiFunction &fn,
+                                                        Span<GPointer> inputs)
+{
+  const IndexMask mask(1);
+  mf::ParamsBuilder params{fn, &mask};
+  mf::ContextBuilder context;
+
+  Vector<GPointer> outputs;
+  int input_index = 0;
+  for (const int param_index : fn.param_indices()) {
+    const mf::ParamType param_type = fn.param_type(param_index);
+    const CPPType &type = param_type.data_type().single_type();
+    if (param_type.interface_type() == mf::ParamType::Input) {
+      params.add_readonly_single_input(inputs[input_index]);
+      input_index++;
+    }
+    else {
+      void *buffer = scope.linear_allocator().allocate(type.size(), type.alignment());
+      params.add_uninitialized_single_output({type, buffer, 1});
+      outputs.append({type, buffer});
+    }
+  }
+  fn.call(mask, params, context);
+
+  for (const GPointer output : outputs) {
+    const CPPType &type = *output.type();
+    if (!type.is_trivially_destructible()) {
+      void *buffer = const_cast<void *>(output.get());
+      scope.add_destruct_call([buffer, &type]() { type.destruct(buffer); });
+    }
+  }
+  return outputs;
+}
+
 /**
  * Builds the #procedure so that it computes the fields.
  */
@@ -149,8 +239,25 @@ static void build_multi_function_procedure_for_fields(mf::Procedure &procedure,
                                                       Span<GFieldRef> output_fields)
 {
   mf::ProcedureBuilder builder{procedure};
-  /* Every input, intermediate and output field corresponds to a variable in the procedure. */
+  /* Every input, intermediate and output field corresponds to a variable in the procedure. The
+   * same variable may be used by multiple fields that compute the same value. */
   Map<GFieldRef, mf::Variable *> variable_by_field;
+  /* Output variables of calls that have been added already. Used to reuse the outputs when the
+   * same function is called with the same inputs again (common subexpression elimination). */
+  Map<ProcedureCallKey, Vector<mf::Variable *>> outputs_by_call;
+  /* Variables whose value is known while building the procedure. */
+  Map<const mf::Variable *, GPointer> constant_by_variable;
+  Map<ConstantValueKey, mf::Variable *> variable_by_constant;
+
+  const auto add_constant_variable = [&](const GPointer value) -> mf::Variable & {
+    return *variable_by_constant.lookup_or_add_cb({value}, [&]() {
+      const mf::MultiFunction &fn = procedure.construct_function<mf::CustomMF_GenericConstant>(
+          *value.type(), value.get(), false);
+      mf::Variable *variable = builder.add_call<1>(fn)[0];
+      constant_by_variable.add_new(variable, value);
+      return variable;
+    });
+  };
 
   /* Start by adding the field inputs as parameters to the procedure. */
   for (const FieldInput &field_input : field_tree_info.deduplicated_field_inputs) {
@@ -198,49 +305,110 @@ static void build_multi_function_procedure_for_fields(mf::Procedure &procedure,
             /* All inputs variables are ready, now gather all variables that are used by the
              * function and call it. */
             const mf::MultiFunction &multi_function = operation_node.multi_function();
-            Vector<mf::Variable *> variables(multi_function.param_amount());
+            ProcedureCallKey call_key{&multi_function};
+            for (const GField &input_field : operation_inputs) {
+              call_key.inputs.append(variable_by_field.lookup(input_field));
+            }
 
-            int param_input_index = 0;
-            int param_output_index = 0;
+            /* Find the outputs that are used by other fields or by the caller. */
+            Vector<GFieldRef> used_output_fields;
+            Vector<int> used_output_indices;
+            int outputs_num = 0;
             for (const int param_index : multi_function.param_indices()) {
-              const mf::ParamType param_type = multi_function.param_type(param_index);
-              const mf::ParamType::InterfaceType interface_type = param_type.interface_type();
-              if (interface_type == mf::ParamType::Input) {
-                const GField &input_field = operation_inputs[param_input_index];
-                variables[param_index] = variable_by_field.lookup(input_field);
-                param_input_index++;
-              }
-              else if (interface_type == mf::ParamType::Output) {
-                const GFieldRef output_field{operation_node, param_output_index};
+              if (multi_function.param_type(param_index).interface_type() ==
+                  mf::ParamType::Output)
+              {
+                const GFieldRef output_field{operation_node, outputs_num};
                 const bool output_is_ignored =
                     field_tree_info.field_users.lookup(output_field).is_empty() &&
                     !output_fields.contains(output_field);
-                if (output_is_ignored) {
-                  /* Ignored outputs don't need a variable. */
-                  variables[param_index] = nullptr;
+                if (!output_is_ignored) {
+                  used_output_fields.append(output_field);
+                  used_output_indices.append(outputs_num);
                 }
-                else {
-                  /* Create a new variable for used outputs. */
-                  mf::Variable &new_variable = procedure.new_variable(param_type.data_type());
-                  variables[param_index] = &new_variable;
-                  variable_by_field.add_new(output_field, &new_variable);
+                outputs_num++;
+              }
+            }
+
+            if (const Vector<mf::Variable *> *previous_outputs = outputs_by_call.lookup_ptr(
+                    call_key))
+            {
+              const bool all_outputs_available = std::all_of(
+                  used_output_indices.begin(), used_output_indices.end(), [&](const int index) {
+                    return (*previous_outputs)[index] != nullptr;
+                  });
+              if (all_outputs_available) {
+                /* The same function has been called with the same inputs already. */
+                for (const int i : used_output_fields.index_range()) {
+                  variable_by_field.add_new(used_output_fields[i],
+                                            (*previous_outputs)[used_output_indices[i]]);
                 }
-                param_output_index++;
+                break;
               }
-              else {
-                BLI_assert_unreachable();
+            }
+
+            const bool all_inputs_constant = !call_key.inputs.is_empty() &&
+                                             std::all_of(call_key.inputs.begin(),
+                                                         call_key.inputs.end(),
+                                                         [&](const mf::Variable *variable) {
+                                                           return constant_by_variable.contains(
+                                                               variable);
+                                                         });
+            Vector<mf::Variable *> output_variables(outputs_num, nullptr);
+            if (all_inputs_constant) {
+              /* Constant folding. */
+              Vector<GPointer> input_values;
+              for (const mf::Variable *variable : call_key.inputs) {
+                input_values.append(constant_by_variable.lookup(variable));
+              }
+              const Vector<GPointer> output_values = evaluate_operation_on_constants(
+                  scope, multi_function, input_values);
+              for (const int output_index : used_output_indices) {
+                output_variables[output_index] = &add_constant_variable(
+                    output_values[output_index]);
+              }
+            }
+            else {
+              Vector<mf::Variable *> variables(multi_function.param_amount());
+              int param_input_index = 0;
+              int param_output_index = 0;
+              for (const int param_index : multi_function.param_indices()) {
+                const mf::ParamType param_type = multi_function.param_type(param_index);
+                const mf::ParamType::InterfaceType interface_type = param_type.interface_type();
+                if (interface_type == mf::ParamType::Input) {
+                  variables[param_index] = call_key.inputs[param_input_index];
+                  param_input_index++;
+                }
+                else if (interface_type == mf::ParamType::Output) {
+                  if (used_output_indices.contains(param_output_index)) {
+                    /* Create a new variable for used outputs. */
+                    mf::Variable &new_variable = procedure.new_variable(param_type.data_type());
+                    variables[param_index] = &new_variable;
+                    output_variables[param_output_index] = &new_variable;
+                  }
+                  else {
+                    /* Ignored outputs don't need a variable. */
+                    variables[param_index] = nullptr;
+                  }
+                  param_output_index++;
+                }
+                else {
+                  BLI_assert_unreachable();
+                }
               }
+              builder.add_call_with_all_variables(multi_function, variables);
+            }
+            for (const int i : used_output_fields.index_range()) {
+              variable_by_field.add_new(used_output_fields[i],
+                                        output_variables[used_output_indices[i]]);
             }
-            builder.add_call_with_all_variables(multi_function, variables);
+            outputs_by_call.add_overwrite(std::move(call_key), std::move(output_variables));
           }
           break;
         }
         case FieldNodeType::Constant: {
           const FieldConstant &constant_node = static_cast<const FieldConstant &>(field_node);
-          const mf::MultiFunction &fn = procedure.construct_function<mf::CustomMF_GenericConstant>(
-              constant_node.type(), constant_node.value().get(), false);
-          mf::Variable &new_variable = *builder.add_call<1>(fn)[0];
-          variable_by_field.add_new(field, &new_variable);
+          variable_by_field.add_new(field, &add_constant_variable(constant_node.value()));
           break;
         }
       }
@@ -261,12 +429,15 @@ static void build_multi_function_procedure_for_fields(mf::Procedure &procedure,
     builder.add_output_parameter(*variable);
   }
 
-  /* Remove the variables that should not be destructed from the map. */
+  /* Every variable has to be destructed once, except for the outputs of the procedure. */
+  Set<mf::Variable *> variables_to_destruct;
+  for (mf::Variable *variable : variable_by_field.values()) {
+    variables_to_destruct.add(variable);
+  }
   for (const GFieldRef &field : output_fields) {
-    variable_by_field.remove(field);
+    variables_to_destruct.remove(variable_by_field.lookup(field));
   }
-  /* Add destructor calls for the remaining variables. */
-  for (mf::Variable *variable : variable_by_field.values()) {
+  for (mf::Variable *variable : variables_to_destruct) {
     builder.add_destruct(*variable);
   }
 
@@ -43,6 +43,7 @@
 
 #include <atomic>
 #include <mutex>
+#include <thread>
 
 #include "BLI_enumerable_thread_specific.hh"
 #include "BLI_function_ref.hh"
@@ -1272,24 +1273,60 @@ class Executor {
     this->push_to_task_pool(std::move(scheduled_nodes));
   }
 
+  /**
+   * Nodes that are pushed to the task pool as a single task when a logger is used. The thread that
+   * pushed them is remembered so that the logger can be informed when another thread steals the
+   * work.
+   */
+  struct PushedScheduledNodes {
+    ScheduledNodes scheduled_nodes;
+    std::thread::id source_thread;
+  };
+
   void push_to_task_pool(std::unique_ptr<ScheduledNodes> scheduled_nodes)
   {
     /* All nodes are pushed as a single task in the pool. This avoids unnecessary threading
      * overhead when the nodes are fast to compute. */
+    if (self_.logger_ == nullptr) {
+      BLI_task_pool_push(
+          task_pool_.load(),
+          [](TaskPool *pool, void *data) {
+            Executor &executor = *static_cast<Executor *>(BLI_task_pool_user_data(pool));
+            ScheduledNodes &scheduled_nodes = *static_cast<ScheduledNodes *>(data);
+            executor.run_pushed_scheduled_nodes(scheduled_nodes);
+          },
+          scheduled_nodes.release(),
+          true,
+          [](TaskPool * /*pool*/, void *data) { delete static_cast<ScheduledNodes *>(data); });
+      return;
+    }
+
+    PushedScheduledNodes *pushed_nodes = new PushedScheduledNodes();
+    pushed_nodes->scheduled_nodes = std::move(*scheduled_nodes);
+    pushed_nodes->source_thread = std::this_thread::get_id();
     BLI_task_pool_push(
         task_pool_.load(),
         [](TaskPool *pool, void *data) {
           Executor &executor = *static_cast<Executor *>(BLI_task_pool_user_data(pool));
-          ScheduledNodes &scheduled_nodes = *static_cast<ScheduledNodes *>(data);
-          CurrentTask new_current_task;
-          new_current_task.scheduled_nodes = std::move(scheduled_nodes);
-          new_current_task.has_scheduled_nodes.store(true, std::memory_order_relaxed);
-          const LocalData local_data = executor.get_local_data();
-          executor.run_task(new_current_task, local_data);
+          PushedScheduledNodes &pushed_nodes = *static_cast<PushedScheduledNodes *>(data);
+          if (pushed_nodes.source_thread != std::this_thread::get_id()) {
+            executor.self_.logger_->log_scheduled_nodes_stolen(
+                pushed_nodes.scheduled_nodes.nodes_num(), *executor.context_);
+          }
+          executor.run_pushed_scheduled_nodes(pushed_nodes.scheduled_nodes);
         },
-        scheduled_nodes.release(),
+        pushed_nodes,
         true,
-        [](TaskPool * /*pool*/, void *data) { delete static_cast<ScheduledNodes *>(data); });
+        [](TaskPool * /*pool*/, void *data) { delete static_cast<PushedScheduledNodes *>(data); });
+  }
+
+  void run_pushed_scheduled_nodes(ScheduledNodes &scheduled_nodes)
+  {
+    CurrentTask new_current_task;
+    new_current_task.scheduled_nodes = std::move(scheduled_nodes);
+    new_current_task.has_scheduled_nodes.store(true, std::memory_order_relaxed);
+    const LocalData local_data = this->get_local_data();
+    this->run_task(new_current_task, local_data);
   }
 
   LocalData get_local_data()
@@ -1313,6 +1350,11 @@ class GraphExecutorLFParams final : public Params {
   CurrentTask &current_task_;
   /** Local data of the thread that calls the lazy-function. */
   const Executor::LocalData &caller_local_data_;
+  /**
+   * Number of bytes allocated for outputs of the node. This is only used for logging. It is atomic
+   * because outputs may be allocated from multiple threads when the node uses multi-threading.
+   */
+  std::atomic<int64_t> allocated_bytes_ = 0;
 
  public:
   GraphExecutorLFParams(const LazyFunction &fn,
@@ -1330,6 +1372,11 @@ class GraphExecutorLFParams final : public Params {
   {
   }
 
+  int64_t allocated_bytes() const
+  {
+    return allocated_bytes_.load(std::memory_order_relaxed);
+  }
+
  private:
   Executor::LocalData get_local_data()
   {
@@ -1368,6 +1415,7 @@ class GraphExecutorLFParams final : public Params {
       LinearAllocator<> &allocator = *this->get_local_data().allocator;
       const CPPType &type = node_.output(index).type();
       output_state.value = allocator.allocate(type.size(), type.alignment());
+      allocated_bytes_.fetch_add(type.size(), std::memory_order_relaxed);
     }
     return output_state.value;
   }
@@ -1456,6 +1504,7 @@ inline void Executor::execute_node(const FunctionNode &node,
 
   if (self_.logger_ != nullptr) {
     self_.logger_->log_after_node_execute(node, node_params, fn_context);
+    self_.logger_->log_node_allocated_bytes(node, node_params.allocated_bytes(), fn_context);
   }
 }
 
@@ -1568,6 +1617,19 @@ void GraphExecutorLogger::log_after_node_execute(const FunctionNode &node,
   UNUSED_VARS(node, params, context);
 }
 
+void GraphExecutorLogger::log_node_allocated_bytes(const FunctionNode &node,
+                                                   const int64_t allocated_bytes,
+                                                   const Context &context) const
+{
+  UNUSED_VARS(node, allocated_bytes, context);
+}
+
+void GraphExecutorLogger::log_scheduled_nodes_stolen(const int64_t nodes_num,
+                                                     const Context &context) const
+{
+  UNUSED_VARS(nodes_num, context);
+}
+
 Vector<const FunctionNode *> GraphExecutorSideEffectProvider::get_nodes_with_side_effects(
     const Context &context) const
 {
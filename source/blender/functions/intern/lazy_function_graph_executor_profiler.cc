@@ -0,0 +1,262 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <algorithm>
+#include <ostream>
+
+#include "BLI_serialize.hh"
+#include "BLI_stack.hh"
+
+#include "FN_lazy_function_graph_executor_profiler.hh"
+
+namespace blender::fn::lazy_function {
+
+namespace serialize = io::serialize;
+
+GraphExecutorProfiler::GraphExecutorProfiler()
+    : start_time_(timeit::Clock::now()), thread_profiles_([this]() {
+        ThreadProfile profile;
+        profile.thread_index = threads_num_.fetch_add(1, std::memory_order_relaxed);
+        return profile;
+      })
+{
+}
+
+GraphExecutorProfiler::ThreadProfile &GraphExecutorProfiler::thread_profile() const
+{
+  return thread_profiles_.local();
+}
+
+void GraphExecutorProfiler::log_before_node_execute(const FunctionNode &node,
+                                                    const Params & /*params*/,
+                                                    const Context & /*context*/) const
+{
+  ThreadProfile &profile = this->thread_profile();
+  std::string node_name = node.name();
+  const NameIndex name = profile.name_indices.lookup_or_add_cb(node_name, [&]() {
+    profile.names.append(node_name);
+    return NameIndex(profile.names.size() - 1);
+  });
+  NodeExecution execution;
+  execution.name = name;
+  profile.running.append(profile.executions.append_and_get_index(execution));
+  /* Take the time last, so that the profiling overhead is not attributed to the node. */
+  profile.executions[profile.running.last()].start = timeit::Clock::now();
+}
+
+void GraphExecutorProfiler::log_after_node_execute(const FunctionNode & /*node*/,
+                                                   const Params & /*params*/,
+                                                   const Context & /*context*/) const
+{
+  const timeit::TimePoint end = timeit::Clock::now();
+  ThreadProfile &profile = this->thread_profile();
+  const int64_t execution_i = profile.running.pop_last();
+  NodeExecution &execution = profile.executions[execution_i];
+  execution.end = end;
+  if (!profile.running.is_empty()) {
+    profile.executions[profile.running.last()].children_time += execution.end - execution.start;
+  }
+  profile.last_finished = execution_i;
+}
+
+void GraphExecutorProfiler::log_node_allocated_bytes(const FunctionNode & /*node*/,
+                                                     const int64_t allocated_bytes,
+                                                     const Context & /*context*/) const
+{
+  ThreadProfile &profile = this->thread_profile();
+  if (profile.last_finished >= 0) {
+    profile.executions[profile.last_finished].allocated_bytes += allocated_bytes;
+  }
+}
+
+void GraphExecutorProfiler::log_scheduled_nodes_stolen(const int64_t nodes_num,
+                                                       const Context & /*context*/) const
+{
+  ThreadProfile &profile = this->thread_profile();
+  profile.steals.append({timeit::Clock::now(), nodes_num});
+}
+
+int64_t GraphExecutorProfiler::executions_num() const
+{
+  int64_t num = 0;
+  for (const ThreadProfile &profile : thread_profiles_) {
+    num += profile.executions.size();
+  }
+  return num;
+}
+
+int64_t GraphExecutorProfiler::steals_num() const
+{
+  int64_t num = 0;
+  for (const ThreadProfile &profile : thread_profiles_) {
+    num += profile.steals.size();
+  }
+  return num;
+}
+
+Vector<const GraphExecutorProfiler::ThreadProfile *> GraphExecutorProfiler::
+    sorted_thread_profiles() const
+{
+  Vector<const ThreadProfile *> profiles;
+  for (const ThreadProfile &profile : thread_profiles_) {
+    profiles.append(&profile);
+  }
+  std::sort(profiles.begin(), profiles.end(), [](const ThreadProfile *a, const ThreadProfile *b) {
+    return a->thread_index < b->thread_index;
+  });
+  return profiles;
+}
+
+Vector<NodeProfileSummary> GraphExecutorProfiler::summary() const
+{
+  Map<std::string, NodeProfileSummary> summary_by_name;
+  for (const ThreadProfile *profile : this->sorted_thread_profiles()) {
+    for (const NodeExecution &execution : profile->executions) {
+      if (execution.end < execution.start) {
+        /* Still running. */
+        continue;
+      }
+      const std::string &name = profile->names[execution.name];
+      NodeProfileSummary &summary = summary_by_name.lookup_or_add_cb(name, [&]() {
+        NodeProfileSummary new_summary;
+        new_summary.name = name;
+        return new_summary;
+      });
+      const timeit::Nanoseconds duration = execution.end - execution.start;
+      summary.executions_num++;
+      summary.total_time += duration;
+      summary.self_time += duration - execution.children_time;
+      summary.allocated_bytes += execution.allocated_bytes;
+    }
+  }
+  Vector<NodeProfileSummary> result;
+  for (NodeProfileSummary &summary : summary_by_name.values()) {
+    result.append(std::move(summary));
+  }
+  std::sort(result.begin(), result.end(), [](const auto &a, const auto &b) {
+    return a.self_time > b.self_time;
+  });
+  return result;
+}
+
+static double to_microseconds(const timeit::Nanoseconds duration)
+{
+  return double(duration.count()) / 1000.0;
+}
+
+void GraphExecutorProfiler::write_chrome_trace(std::ostream &stream) const
+{
+  serialize::DictionaryValue root;
+  serialize::ArrayValue &events = *root.append_array("traceEvents");
+
+  for (const ThreadProfile *profile : this->sorted_thread_profiles()) {
+    std::shared_ptr<serialize::DictionaryValue> thread_name = events.append_dict();
+    thread_name->append_str("name", "thread_name");
+    thread_name->append_str("ph", "M");
+    thread_name->append_int("pid", 1);
+    thread_name->append_int("tid", profile->thread_index);
+    thread_name->append_dict("args")->append_str(
+        "name", "Thread " + std::to_string(profile->thread_index));
+
+    for (const NodeExecution &execution : profile->executions) {
+      if (execution.end < execution.start) {
+        continue;
+      }
+      std::shared_ptr<serialize::DictionaryValue> event = events.append_dict();
+      event->append_str("name", profile->names[execution.name]);
+      event->append_str("cat", "node");
+      event->append_str("ph", "X");
+      event->append_double("ts", to_microseconds(execution.start - start_time_));
+      event->append_double("dur", to_microseconds(execution.end - execution.start));
+      event->append_int("pid", 1);
+      event->append_int("tid", profile->thread_index);
+      std::shared_ptr<serialize::DictionaryValue> args = event->append_dict("args");
+      args->append_int("allocated_bytes", execution.allocated_bytes);
+      args->append_double("self_us",
+                          to_microseconds(execution.end - execution.start -
+                                          execution.children_time));
+    }
+    for (const TaskSteal &steal : profile->steals) {
+      std::shared_ptr<serialize::DictionaryValue> event = events.append_dict();
+      event->append_str("name", "Steal Scheduled Nodes");
+      event->append_str("cat", "scheduler");
+      event->append_str("ph", "i");
+      event->append_str("s", "t");
+      event->append_double("ts", to_microseconds(steal.time - start_time_));
+      event->append_int("pid", 1);
+      event->append_int("tid", profile->thread_index);
+      event->append_dict("args")->append_int("nodes_num", steal.nodes_num);
+    }
+  }
+
+  serialize::JsonFormatter formatter;
+  formatter.serialize(stream, root);
+}
+
+void GraphExecutorProfiler::write_speedscope(std::ostream &stream) const
+{
+  serialize::DictionaryValue root;
+  root.append_str("$schema", "https://www.speedscope.app/file-format-schema.json");
+  root.append_str("name", "Lazy-Function Graph Execution");
+  root.append_str("exporter", "Blender");
+  serialize::ArrayValue &frames = *root.append_dict("shared")->append_array("frames");
+  serialize::ArrayValue &profiles = *root.append_array("profiles");
+
+  /* Frames are shared between all threads. */
+  Map<StringRef, int> frame_indices;
+  const Vector<const ThreadProfile *> thread_profiles = this->sorted_thread_profiles();
+  for (const ThreadProfile *profile : thread_profiles) {
+    for (const std::string &name : profile->names) {
+      if (frame_indices.contains(name)) {
+        continue;
+      }
+      frame_indices.add_new(name, frame_indices.size());
+      frames.append_dict()->append_str("name", name);
+    }
+  }
+
+  for (const ThreadProfile *profile : thread_profiles) {
+    std::shared_ptr<serialize::DictionaryValue> thread_profile = profiles.append_dict();
+    thread_profile->append_str("type", "evented");
+    thread_profile->append_str("name", "Thread " + std::to_string(profile->thread_index));
+    thread_profile->append_str("unit", "microseconds");
+    serialize::ArrayValue &events = *thread_profile->append_array("events");
+
+    /* Executions are stored in the order in which they started, nested executions always end
+     * before their parent, so a stack is enough to generate the close events in order. */
+    Stack<const NodeExecution *> open_executions;
+    double end_value = 0.0;
+    const auto close_event = [&](const NodeExecution &execution) {
+      const double at = to_microseconds(execution.end - start_time_);
+      std::shared_ptr<serialize::DictionaryValue> event = events.append_dict();
+      event->append_str("type", "C");
+      event->append_int("frame", frame_indices.lookup(profile->names[execution.name]));
+      event->append_double("at", at);
+      end_value = std::max(end_value, at);
+    };
+    for (const NodeExecution &execution : profile->executions) {
+      if (execution.end < execution.start) {
+        continue;
+      }
+      while (!open_executions.is_empty() && open_executions.peek()->end <= execution.start) {
+        close_event(*open_executions.pop());
+      }
+      std::shared_ptr<serialize::DictionaryValue> event = events.append_dict();
+      event->append_str("type", "O");
+      event->append_int("frame", frame_indices.lookup(profile->names[execution.name]));
+      event->append_double("at", to_microseconds(execution.start - start_time_));
+      open_executions.push(&execution);
+    }
+    while (!open_executions.is_empty()) {
+      close_event(*open_executions.pop());
+    }
+    thread_profile->append_double("startValue", 0.0);
+    thread_profile->append_double("endValue", end_value);
+  }
+
+  serialize::JsonFormatter formatter;
+  formatter.serialize(stream, root);
+}
+
+}  // namespace blender::fn::lazy_function
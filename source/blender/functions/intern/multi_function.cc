@@ -133,30 +133,47 @@ void MultiFunction::call_auto(const IndexMask &mask, Params params, Context cont
   }
 
   const int64_t alignment = compute_alignment(grain_size);
+  const auto call_for_sub_range = [&](const IndexRange sub_range) {
+    const IndexMask sliced_mask = mask.slice(sub_range);
+    if (!hints.allocates_array) {
+      /* There is no benefit to changing indices in this case. */
+      this->call(sliced_mask, params, context);
+      return;
+    }
+    if (sliced_mask[0] < grain_size) {
+      /* The indices are low, no need to offset them. */
+      this->call(sliced_mask, params, context);
+      return;
+    }
+    const int64_t input_slice_start = sliced_mask[0];
+    const int64_t input_slice_size = sliced_mask.last() - input_slice_start + 1;
+    const IndexRange input_slice_range{input_slice_start, input_slice_size};
+
+    IndexMaskMemory memory;
+    const int64_t offset = -input_slice_start;
+    const IndexMask shifted_mask = mask.slice_and_shift(sub_range, offset, memory);
+
+    ParamsBuilder sliced_params{*this, &shifted_mask};
+    add_sliced_parameters(*signature_ref_, params, input_slice_range, sliced_params);
+    this->call(shifted_mask, sliced_params, context);
+  };
+
   threading::parallel_for_aligned(
       mask.index_range(), grain_size, alignment, [&](const IndexRange sub_range) {
-        const IndexMask sliced_mask = mask.slice(sub_range);
         if (!hints.allocates_array) {
-          /* There is no benefit to changing indices in this case. */
-          this->call(sliced_mask, params, context);
+          call_for_sub_range(sub_range);
           return;
         }
-        if (sliced_mask[0] < grain_size) {
-          /* The indices are low, no need to offset them. */
-          this->call(sliced_mask, params, context);
-          return;
+        /* The range passed in here can be larger than the grain size, e.g. when only a single
+         * thread is used. Process it in segments so that the intermediate arrays stay small enough
+         * to remain in the CPU cache while all the work for one segment is done. */
+        for (int64_t segment_start = sub_range.start(); segment_start < sub_range.one_after_last();
+             segment_start += grain_size)
+        {
+          const int64_t segment_size = std::min(grain_size,
+                                                sub_range.one_after_last() - segment_start);
+          call_for_sub_range(IndexRange(segment_start, segment_size));
         }
-        const int64_t input_slice_start = sliced_mask[0];
-        const int64_t input_slice_size = sliced_mask.last() - input_slice_start + 1;
-        const IndexRange input_slice_range{input_slice_start, input_slice_size};
-
-        IndexMaskMemory memory;
-        const int64_t offset = -input_slice_start;
-        const IndexMask shifted_mask = mask.slice_and_shift(sub_range, offset, memory);
-
-        ParamsBuilder sliced_params{*this, &shifted_mask};
-        add_sliced_parameters(*signature_ref_, params, input_slice_range, sliced_params);
-        this->call(shifted_mask, sliced_params, context);
       });
 }
 
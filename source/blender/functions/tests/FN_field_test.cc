@@ -4,7 +4,11 @@
 
 #include "testing/testing.h"
 
+#include <atomic>
+#include <limits>
+
 #include "BLI_cpp_type.hh"
+#include "BLI_timeit.hh"
 #include "FN_field.hh"
 #include "FN_multi_function_builder.hh"
 #include "FN_multi_function_test_common.hh"
@@ -281,4 +285,126 @@ TEST(field, IgnoredOutput)
   EXPECT_EQ(results.get(3), 5);
 }
 
+TEST(field, CommonSubexpression)
+{
+  static auto add_fn = mf::build::SI2_SO<int, int, int>("add", [](int a, int b) { return a + b; });
+  static auto mul_fn = mf::build::SI2_SO<int, int, int>("mul", [](int a, int b) { return a * b; });
+  GField index_field{std::make_shared<IndexFieldInput>()};
+
+  /* Both operations compute the same value, but only the second one is used by another field. */
+  GField add_field_1{FieldOperation::Create(add_fn, {index_field, index_field}), 0};
+  GField add_field_2{FieldOperation::Create(add_fn, {index_field, index_field}), 0};
+  GField mul_field{FieldOperation::Create(mul_fn, {add_field_2, index_field}), 0};
+
+  Array<int> result_1(10);
+  Array<int> result_2(10);
+  Array<int> result_3(10);
+
+  FieldContext context;
+  FieldEvaluator evaluator{context, 10};
+  evaluator.add_with_destination(add_field_1, result_1.as_mutable_span());
+  evaluator.add_with_destination(mul_field, result_2.as_mutable_span());
+  evaluator.add_with_destination(add_field_2, result_3.as_mutable_span());
+  evaluator.evaluate();
+  for (const int i : IndexRange(10)) {
+    EXPECT_EQ(result_1[i], i + i);
+    EXPECT_EQ(result_2[i], (i + i) * i);
+    EXPECT_EQ(result_3[i], i + i);
+  }
+}
+
+TEST(field, ConstantFolding)
+{
+  static std::atomic<int> constant_calls = 0;
+  static auto constant_fn = mf::build::SI2_SO<std::string, std::string, std::string>(
+      "append", [](const std::string &a, const std::string &b) {
+        constant_calls++;
+        return a + b;
+      });
+  static auto length_fn = mf::build::SI2_SO<std::string, int, int>(
+      "length plus", [](const std::string &a, int b) { return int(a.size()) + b; });
+
+  GField a_field = make_constant_field<std::string>("abc");
+  GField b_field = make_constant_field<std::string>("de");
+  GField append_field{FieldOperation::Create(constant_fn, {a_field, b_field}), 0};
+  GField index_field{std::make_shared<IndexFieldInput>()};
+  GField length_field{FieldOperation::Create(length_fn, {append_field, index_field}), 0};
+
+  const int size = 100'000;
+  Array<int> result(size);
+  FieldContext context;
+  FieldEvaluator evaluator{context, size};
+  evaluator.add_with_destination(length_field, result.as_mutable_span());
+  evaluator.evaluate();
+
+  /* The constant part is only computed once, even though the varying part is processed in many
+   * segments. */
+  EXPECT_EQ(constant_calls, 1);
+  EXPECT_EQ(result[0], 5);
+  EXPECT_EQ(result[size - 1], size - 1 + 5);
+}
+
+TEST(field, ConstantSignedZero)
+{
+  static auto div_fn = mf::build::SI2_SO<int, float, float>(
+      "div", [](int a, float b) { return float(a + 1) / b; });
+  GField index_field{std::make_shared<IndexFieldInput>()};
+  /* Zero and negative zero compare equal, but must not be merged into the same constant. */
+  GField positive_field{
+      FieldOperation::Create(div_fn, {index_field, make_constant_field<float>(0.0f)}), 0};
+  GField negative_field{
+      FieldOperation::Create(div_fn, {index_field, make_constant_field<float>(-0.0f)}), 0};
+
+  Array<float> positive_result(4);
+  Array<float> negative_result(4);
+  FieldContext context;
+  FieldEvaluator evaluator{context, 4};
+  evaluator.add_with_destination(positive_field, positive_result.as_mutable_span());
+  evaluator.add_with_destination(negative_field, negative_result.as_mutable_span());
+  evaluator.evaluate();
+  for (const int i : IndexRange(4)) {
+    EXPECT_EQ(positive_result[i], std::numeric_limits<float>::infinity());
+    EXPECT_EQ(negative_result[i], -std::numeric_limits<float>::infinity());
+  }
+}
+
+/* Disable benchmark by default. */
+#if 0
+TEST(field, BenchmarkFusedEvaluation)
+{
+  static auto add_fn = mf::build::SI2_SO<float, float, float>(
+      "add", [](float a, float b) { return a + b; }, mf::build::exec_presets::AllSpanOrSingle());
+  static auto mul_fn = mf::build::SI2_SO<float, float, float>(
+      "mul", [](float a, float b) { return a * b; }, mf::build::exec_presets::AllSpanOrSingle());
+
+  static auto to_float_fn = mf::build::SI1_SO<int, float>("to float",
+                                                           [](int a) { return float(a); });
+
+  GField index_field{
+      FieldOperation::Create(to_float_fn, {GField{std::make_shared<IndexFieldInput>()}}), 0};
+  /* A chain of operations where every step appears twice and contains constant sub-expressions,
+   * similar to what node trees with many math nodes generate. */
+  GField field = index_field;
+  for ([[maybe_unused]] const int i : IndexRange(20)) {
+    GField constant{
+        FieldOperation::Create(
+            add_fn, {make_constant_field<float>(1.0f), make_constant_field<float>(2.0f)}),
+        0};
+    GField a{FieldOperation::Create(mul_fn, {field, constant}), 0};
+    GField b{FieldOperation::Create(mul_fn, {field, constant}), 0};
+    field = GField{FieldOperation::Create(add_fn, {a, b}), 0};
+  }
+
+  const int size = 10'000'000;
+  Array<float> result(size);
+  FieldContext context;
+  for ([[maybe_unused]] const int i : IndexRange(5)) {
+    SCOPED_TIMER("evaluate");
+    FieldEvaluator evaluator{context, size};
+    evaluator.add_with_destination(field, result.as_mutable_span());
+    evaluator.evaluate();
+  }
+}
+#endif
+
 }  // namespace blender::fn::tests
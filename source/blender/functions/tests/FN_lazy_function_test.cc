@@ -7,9 +7,12 @@
 #include "FN_lazy_function_execute.hh"
 #include "FN_lazy_function_graph.hh"
 #include "FN_lazy_function_graph_executor.hh"
+#include "FN_lazy_function_graph_executor_profiler.hh"
 
 #include "BLI_task.h"
 
+#include <sstream>
+
 namespace blender::fn::lazy_function::tests {
 
 class AddLazyFunction : public LazyFunction {
@@ -178,4 +181,49 @@ TEST(lazy_function, GraphWithCycle)
   EXPECT_EQ(result, 10 * 2 * 5);
 }
 
+TEST(lazy_function, Profiler)
+{
+  const AddLazyFunction add_fn;
+
+  Graph graph;
+  FunctionNode &add_node_1 = graph.add_function(add_fn);
+  FunctionNode &add_node_2 = graph.add_function(add_fn);
+  GraphInputSocket &input_socket = graph.add_input(CPPType::get<int>());
+  GraphOutputSocket &output_socket = graph.add_output(CPPType::get<int>());
+
+  graph.add_link(input_socket, add_node_1.input(0));
+  graph.add_link(input_socket, add_node_1.input(1));
+  graph.add_link(add_node_1.output(0), add_node_2.input(0));
+  graph.add_link(input_socket, add_node_2.input(1));
+  graph.add_link(add_node_2.output(0), output_socket);
+
+  graph.update_node_indices();
+
+  GraphExecutorProfiler profiler;
+  GraphExecutor executor_fn{
+      graph, {&input_socket}, {&output_socket}, &profiler, nullptr, nullptr};
+  for (const int i : IndexRange(3)) {
+    int result = 0;
+    execute_lazy_function_eagerly(
+        executor_fn, nullptr, nullptr, std::make_tuple(i), std::make_tuple(&result));
+    EXPECT_EQ(result, i * 3);
+  }
+
+  EXPECT_EQ(profiler.executions_num(), 6);
+  const Vector<NodeProfileSummary> summary = profiler.summary();
+  ASSERT_EQ(summary.size(), 1);
+  EXPECT_EQ(summary[0].name, "Add");
+  EXPECT_EQ(summary[0].executions_num, 6);
+  EXPECT_EQ(summary[0].allocated_bytes, 6 * int64_t(sizeof(int)));
+  EXPECT_LE(summary[0].self_time, summary[0].total_time);
+
+  std::stringstream chrome_trace;
+  profiler.write_chrome_trace(chrome_trace);
+  EXPECT_NE(chrome_trace.str().find("traceEvents"), std::string::npos);
+
+  std::stringstream speedscope;
+  profiler.write_speedscope(speedscope);
+  EXPECT_NE(speedscope.str().find("evented"), std::string::npos);
+}
+
 }  // namespace blender::fn::lazy_function::tests
@@ -0,0 +1,40 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <optional>
+
+#include "BLI_span.hh"
+
+#include "BKE_attribute_filter.hh"
+
+struct Mesh;
+
+/** \file
+ * \ingroup geo
+ */
+
+namespace blender::geometry {
+
+/**
+ * Reduce the number of faces by collapsing the edges that change the shape the least, measured
+ * with quadric error metrics, like the collapse mode of the decimate modifier. Unlike the BMesh
+ * implementation this works on the mesh arrays directly, and large meshes are decimated in
+ * parallel in independent spatial regions. The mesh is triangulated first.
+ *
+ * \param face_ratio: The fraction of the triangles of the triangulated mesh to keep.
+ * \param vert_weights: Optional weight for every vertex. Edges around vertices with a lower weight
+ * are collapsed later, edges of vertices with a zero weight are never collapsed.
+ * \param vert_weight_factor: How much the vertex weights influence the collapse order.
+ *
+ * \returns #std::nullopt if the mesh is not changed.
+ */
+std::optional<Mesh *> mesh_decimate_collapse(const Mesh &src_mesh,
+                                             float face_ratio,
+                                             Span<float> vert_weights,
+                                             float vert_weight_factor,
+                                             const bke::AttributeFilter &attribute_filter);
+
+}  // namespace blender::geometry
@@ -0,0 +1,992 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup geo
+ *
+ * Quadric edge collapse decimation, following the BMesh implementation in
+ * `bmesh_decimate_collapse.cc` but working on mesh arrays.
+ *
+ * Large meshes are decimated in rounds. Every round assigns the vertices to the cells of a
+ * regular grid, and only collapses edges whose vertices are surrounded by vertices of the same
+ * cell. Collapsing such an edge only changes triangles within the cell, so all cells can be
+ * processed in parallel. The grid is shifted in every round, so that edges on cell borders are
+ * collapsed in later rounds. Finally the remaining collapses are done in a single cell.
+ */
+
+#include <algorithm>
+#include <numeric>
+#include <queue>
+
+#include "BLI_array_utils.hh"
+#include "BLI_bounds.hh"
+#include "BLI_generic_array.hh"
+#include "BLI_math_geom.h"
+#include "BLI_math_vector.hh"
+#include "BLI_ordered_edge.hh"
+#include "BLI_quadric.h"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
+
+#include "BKE_attribute.hh"
+#include "BKE_attribute_math.hh"
+#include "BKE_customdata.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_mesh.hh"
+#include "BKE_mesh_mapping.hh"
+
+#include "GEO_mesh_decimate.hh"
+#include "GEO_mesh_triangulate.hh"
+
+namespace blender::geometry {
+
+namespace decimate {
+
+/** Scale of the quadrics of boundary edges, which keeps the boundary in place. */
+constexpr double boundary_preserve_weight = 100.0;
+/** Uses double precision, impacts behavior on near-flat surfaces, see #48154. */
+constexpr double optimize_eps = 1e-8;
+/** If the cost from #BLI_quadric_evaluate is noise, fall back to the topology. */
+constexpr float topology_fallback_eps = 1e-12f;
+
+/** Meshes with fewer vertices per cell than this aren't decimated in parallel. */
+constexpr int verts_per_cell = 4096;
+/** Once the number of triangles to remove is below this, the rest is done in a single cell. */
+constexpr int parallel_min_tris_to_remove = 8192;
+
+struct MixedAttribute {
+  StringRef name;
+  GArray<> values;
+};
+
+/** The mesh being decimated. Every face is a triangle, removed triangles are only tagged. */
+struct DecimateMesh {
+  Array<float3> positions;
+  Array<float3> vert_normals;
+  Array<Quadric> quadrics;
+  /** Empty if there are no weights. Interpolated when vertices are merged. */
+  Array<float> vert_weights;
+  float vert_weight_factor;
+
+  Array<int> corner_verts;
+  Array<bool> tri_removed;
+  /** The corners of the remaining triangles that use each vertex. */
+  Array<Vector<int>> vert_corners;
+  /** Incremented when a vertex changes, to skip outdated collapse candidates. */
+  Array<int> vert_versions;
+  /** For every removed vertex, the vertex it was merged into, otherwise -1. */
+  Array<int> vert_merge_targets;
+
+  /** Attributes that are interpolated when merging vertices. */
+  Vector<MixedAttribute> point_attributes;
+  Vector<MixedAttribute> corner_attributes;
+};
+
+struct CollapseEdge {
+  float cost;
+  int v1;
+  int v2;
+  int v1_version;
+  int v2_version;
+
+  /* Compare all members, so that the collapse order doesn't depend on the insertion order. */
+  friend bool operator<(const CollapseEdge &a, const CollapseEdge &b)
+  {
+    return std::tie(a.cost, a.v1, a.v2, a.v1_version, a.v2_version) <
+           std::tie(b.cost, b.v1, b.v2, b.v1_version, b.v2_version);
+  }
+  friend bool operator>(const CollapseEdge &a, const CollapseEdge &b)
+  {
+    return b < a;
+  }
+};
+
+using CollapseHeap = std::priority_queue<CollapseEdge,
+                                         std::vector<CollapseEdge>,
+                                         std::greater<CollapseEdge>>;
+
+BLI_INLINE int tri_corner_next(const int corner)
+{
+  return corner - corner % 3 + (corner + 1) % 3;
+}
+
+BLI_INLINE int tri_corner_prev(const int corner)
+{
+  return corner - corner % 3 + (corner + 2) % 3;
+}
+
+/** The number of remaining triangles that use the edge between the two vertices. */
+static int edge_tris_num(const DecimateMesh &mesh, const int v1, const int v2)
+{
+  int count = 0;
+  for (const int corner : mesh.vert_corners[v1]) {
+    if (ELEM(v2,
+             mesh.corner_verts[tri_corner_next(corner)],
+             mesh.corner_verts[tri_corner_prev(corner)]))
+    {
+      count++;
+    }
+  }
+  return count;
+}
+
+static bool vert_is_boundary(const DecimateMesh &mesh, const int vert)
+{
+  for (const int corner : mesh.vert_corners[vert]) {
+    if (edge_tris_num(mesh, vert, mesh.corner_verts[tri_corner_next(corner)]) == 1 ||
+        edge_tris_num(mesh, vert, mesh.corner_verts[tri_corner_prev(corner)]) == 1)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void gather_vert_neighbors(const DecimateMesh &mesh,
+                                  const int vert,
+                                  Vector<int, 16> &r_neighbors)
+{
+  r_neighbors.clear();
+  for (const int corner : mesh.vert_corners[vert]) {
+    r_neighbors.append_non_duplicates(mesh.corner_verts[tri_corner_next(corner)]);
+    r_neighbors.append_non_duplicates(mesh.corner_verts[tri_corner_prev(corner)]);
+  }
+}
+
+static bool type_is_mixable(const CPPType &type)
+{
+  bool mixable = false;
+  bke::attribute_math::convert_to_static_type(type, [&](auto dummy) {
+    using T = decltype(dummy);
+    mixable = !std::is_void_v<bke::attribute_math::DefaultMixer<T>>;
+  });
+  return mixable;
+}
+
+static Vector<MixedAttribute> gather_mixed_attributes(const bke::AttributeAccessor attributes,
+                                                      const bke::AttrDomain domain,
+                                                      const bke::AttributeFilter &filter)
+{
+  Vector<MixedAttribute> mixed_attributes;
+  attributes.foreach_attribute([&](const bke::AttributeIter &iter) {
+    if (iter.domain != domain || filter.allow_skip(iter.name)) {
+      return;
+    }
+    if (ELEM(iter.name, "position", ".corner_vert", ".corner_edge")) {
+      return;
+    }
+    const GVArray src = *iter.get();
+    if (!type_is_mixable(src.type())) {
+      return;
+    }
+    GArray<> values(src.type(), src.size());
+    src.materialize(values.data());
+    mixed_attributes.append({iter.name, std::move(values)});
+  });
+  return mixed_attributes;
+}
+
+/**
+ * Accumulate a quadric for every vertex from the planes of its triangles, and from planes
+ * perpendicular to the triangles along boundary edges.
+ */
+static void calc_vert_quadrics(const Span<float3> tri_normals, DecimateMesh &mesh)
+{
+  const Span<float3> positions = mesh.positions;
+  const Span<int> corner_verts = mesh.corner_verts;
+
+  Array<Quadric> tri_quadrics(tri_normals.size());
+  threading::parallel_for(tri_normals.index_range(), 2048, [&](const IndexRange range) {
+    for (const int tri : range) {
+      const float3 center = (positions[corner_verts[tri * 3 + 0]] +
+                             positions[corner_verts[tri * 3 + 1]] +
+                             positions[corner_verts[tri * 3 + 2]]) /
+                            3.0f;
+      const double3 normal(tri_normals[tri]);
+      const double4 plane(normal, -math::dot(normal, double3(center)));
+      BLI_quadric_from_plane(&tri_quadrics[tri], plane);
+    }
+  });
+
+  threading::parallel_for(positions.index_range(), 1024, [&](const IndexRange range) {
+    for (const int vert : range) {
+      Quadric &quadric = mesh.quadrics[vert];
+      BLI_quadric_clear(&quadric);
+      for (const int corner : mesh.vert_corners[vert]) {
+        const int tri = corner / 3;
+        BLI_quadric_add_qu_qu(&quadric, &tri_quadrics[tri]);
+
+        /* Both vertices of a boundary edge calculate its plane from the same triangle. */
+        for (const int edge_corner : {corner, tri_corner_prev(corner)}) {
+          const int edge_v1 = corner_verts[edge_corner];
+          const int edge_v2 = corner_verts[tri_corner_next(edge_corner)];
+          if (edge_tris_num(mesh, edge_v1, edge_v2) != 1) {
+            continue;
+          }
+          const float3 edge_vector = positions[edge_v2] - positions[edge_v1];
+          double3 edge_plane(math::cross(edge_vector, tri_normals[tri]));
+          double length;
+          edge_plane = math::normalize_and_get_length(edge_plane, length);
+          if (length <= double(FLT_EPSILON)) {
+            continue;
+          }
+          const float3 center = math::midpoint(positions[edge_v1], positions[edge_v2]);
+          const double4 plane(edge_plane, -math::dot(edge_plane, double3(center)));
+          Quadric edge_quadric;
+          BLI_quadric_from_plane(&edge_quadric, plane);
+          BLI_quadric_mul(&edge_quadric, boundary_preserve_weight);
+          BLI_quadric_add_qu_qu(&quadric, &edge_quadric);
+        }
+      }
+    }
+  });
+}
+
+static DecimateMesh create_decimate_mesh(const Mesh &mesh,
+                                         const Span<float> vert_weights,
+                                         const float vert_weight_factor,
+                                         const bke::AttributeFilter &attribute_filter)
+{
+  DecimateMesh result;
+  result.positions = mesh.vert_positions();
+  result.vert_normals = mesh.vert_normals();
+  result.quadrics.reinitialize(mesh.verts_num);
+  result.vert_weights = vert_weights;
+  result.vert_weight_factor = vert_weight_factor;
+  result.corner_verts = mesh.corner_verts();
+  result.tri_removed = Array<bool>(mesh.faces_num, false);
+  result.vert_versions = Array<int>(mesh.verts_num, 0);
+  result.vert_merge_targets = Array<int>(mesh.verts_num, -1);
+
+  Array<int> offsets;
+  Array<int> indices;
+  const GroupedSpan<int> vert_to_corner = bke::mesh::build_vert_to_corner_map(
+      mesh.corner_verts(), mesh.verts_num, offsets, indices);
+  result.vert_corners.reinitialize(mesh.verts_num);
+  threading::parallel_for(vert_to_corner.index_range(), 2048, [&](const IndexRange range) {
+    for (const int vert : range) {
+      result.vert_corners[vert].extend(vert_to_corner[vert]);
+    }
+  });
+
+  calc_vert_quadrics(mesh.face_normals(), result);
+
+  const bke::AttributeAccessor attributes = mesh.attributes();
+  result.point_attributes = gather_mixed_attributes(
+      attributes, bke::AttrDomain::Point, attribute_filter);
+  result.corner_attributes = gather_mixed_attributes(
+      attributes, bke::AttrDomain::Corner, attribute_filter);
+  return result;
+}
+
+static double3 calc_collapse_position(const DecimateMesh &mesh, const int v1, const int v2)
+{
+  Quadric quadric;
+  BLI_quadric_add_qu_ququ(&quadric, &mesh.quadrics[v1], &mesh.quadrics[v2]);
+  double3 position;
+  if (BLI_quadric_optimize(&quadric, position, optimize_eps)) {
+    return position;
+  }
+  return math::midpoint(double3(mesh.positions[v1]), double3(mesh.positions[v2]));
+}
+
+/** \return #std::nullopt if the edge can't be collapsed. */
+static std::optional<float> calc_collapse_cost(const DecimateMesh &mesh,
+                                               const int v1,
+                                               const int v2)
+{
+  const Span<float> weights = mesh.vert_weights;
+  if (!weights.is_empty() && (weights[v1] == 0.0f || weights[v2] == 0.0f)) {
+    return std::nullopt;
+  }
+  /* Only collapse manifold or boundary edges. */
+  if (!ELEM(edge_tris_num(mesh, v1, v2), 1, 2)) {
+    return std::nullopt;
+  }
+
+  const double3 position = calc_collapse_position(mesh, v1, v2);
+  /* The cost shouldn't be negative but can be with small values, see #37121. */
+  float cost = std::abs(float(BLI_quadric_evaluate(&mesh.quadrics[v1], position) +
+                              BLI_quadric_evaluate(&mesh.quadrics[v2], position)));
+
+  const float3 &co1 = mesh.positions[v1];
+  const float3 &co2 = mesh.positions[v2];
+  if (UNLIKELY(cost < topology_fallback_eps)) {
+    /* Keep the topology cost below zero so it doesn't interfere with the quadric cost. */
+    const float normal_dot = std::abs(math::dot(mesh.vert_normals[v1], mesh.vert_normals[v2]));
+    if (weights.is_empty()) {
+      cost = normal_dot / std::min(-math::distance_squared(co1, co2), -FLT_EPSILON) - cost;
+    }
+    else {
+      const float weight = weights[v1] + weights[v2];
+      cost = normal_dot / std::min(-math::distance(co1, co2), -FLT_EPSILON) - cost;
+      if (weight != 0.0f) {
+        cost *= 1.0f + weight * mesh.vert_weight_factor;
+      }
+    }
+  }
+  else if (!weights.is_empty()) {
+    const float weight = 2.0f - (weights[v1] + weights[v2]);
+    if (weight != 0.0f) {
+      cost += math::distance(co1, co2) * weight * mesh.vert_weight_factor;
+    }
+  }
+  return cost;
+}
+
+static void add_collapse_candidate(const DecimateMesh &mesh,
+                                   const Span<bool> collapsible_verts,
+                                   int v1,
+                                   int v2,
+                                   FunctionRef<void(const CollapseEdge &)> fn)
+{
+  if (!collapsible_verts[v1] || !collapsible_verts[v2]) {
+    return;
+  }
+  if (v1 > v2) {
+    std::swap(v1, v2);
+  }
+  if (const std::optional<float> cost = calc_collapse_cost(mesh, v1, v2)) {
+    fn({*cost, v1, v2, mesh.vert_versions[v1], mesh.vert_versions[v2]});
+  }
+}
+
+static std::vector<CollapseEdge> gather_collapse_candidates(const DecimateMesh &mesh,
+                                                            const Span<bool> collapsible_verts,
+                                                            const Span<int> verts)
+{
+  std::vector<CollapseEdge> candidates;
+  Vector<int, 16> neighbors;
+  for (const int vert : verts) {
+    if (!collapsible_verts[vert]) {
+      continue;
+    }
+    gather_vert_neighbors(mesh, vert, neighbors);
+    for (const int neighbor : neighbors) {
+      if (vert < neighbor) {
+        add_collapse_candidate(mesh,
+                               collapsible_verts,
+                               vert,
+                               neighbor,
+                               [&](const CollapseEdge &edge) { candidates.push_back(edge); });
+      }
+    }
+  }
+  return candidates;
+}
+
+/**
+ * Check that the collapse doesn't create duplicate edges or faces, which is the case if the
+ * only neighbors shared by both vertices are the opposite vertices of the removed triangles.
+ */
+static bool collapse_is_degenerate_topology(const DecimateMesh &mesh, const int v1, const int v2)
+{
+  Vector<int, 16> neighbors_1;
+  Vector<int, 16> neighbors_2;
+  gather_vert_neighbors(mesh, v1, neighbors_1);
+  gather_vert_neighbors(mesh, v2, neighbors_2);
+
+  /* Every edge around both vertices should be manifold or a boundary. */
+  for (const int neighbor : neighbors_1) {
+    if (edge_tris_num(mesh, v1, neighbor) > 2) {
+      return true;
+    }
+  }
+  for (const int neighbor : neighbors_2) {
+    if (edge_tris_num(mesh, v2, neighbor) > 2) {
+      return true;
+    }
+  }
+
+  const int tris_num = edge_tris_num(mesh, v1, v2);
+  int shared_neighbors_num = 0;
+  for (const int neighbor : neighbors_1) {
+    if (neighbor != v2 && neighbors_2.contains(neighbor)) {
+      shared_neighbors_num++;
+    }
+  }
+  if (shared_neighbors_num != tris_num) {
+    return true;
+  }
+  /* Collapsing a tetrahedron would leave two triangles using the same vertices. */
+  if (neighbors_1.size() == 3 && neighbors_2.size() == 3 && tris_num == 2) {
+    return true;
+  }
+  /* Collapsing an inner edge between two boundaries would join the boundaries. */
+  if (tris_num == 2 && vert_is_boundary(mesh, v1) && vert_is_boundary(mesh, v2)) {
+    return true;
+  }
+  return false;
+}
+
+/** Check if moving the vertices of the edge to the new position would flip a triangle. */
+static bool collapse_is_degenerate_flip(const DecimateMesh &mesh,
+                                        const int v1,
+                                        const int v2,
+                                        const float3 &position)
+{
+  for (const int vert : {v1, v2}) {
+    const int other_vert = vert == v1 ? v2 : v1;
+    for (const int corner : mesh.vert_corners[vert]) {
+      const int vert_next = mesh.corner_verts[tri_corner_next(corner)];
+      const int vert_prev = mesh.corner_verts[tri_corner_prev(corner)];
+      if (ELEM(other_vert, vert_next, vert_prev)) {
+        /* The triangle is removed by the collapse. */
+        continue;
+      }
+      const float3 &co_prev = mesh.positions[vert_prev];
+      const float3 &co_next = mesh.positions[vert_next];
+      /* The line between the two outer vertices, used for both cross products. */
+      const float3 vec_other = co_prev - co_next;
+      const float3 cross_exist = math::cross(vec_other, co_prev - mesh.positions[vert]);
+      const float3 cross_optim = math::cross(vec_other, co_prev - position);
+      /* Avoid normalizing. */
+      if (math::dot(cross_exist, cross_optim) <=
+          (math::length_squared(cross_exist) + math::length_squared(cross_optim)) * 0.01f)
+      {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/**
+ * Interpolate the corners of a removed triangle, and use the result for the corners around
+ * both vertices that had the same values, so that seams are kept.
+ */
+template<typename T>
+static void mix_corner_values(const DecimateMesh &mesh,
+                              MutableSpan<T> values,
+                              const int corner_keep,
+                              const int corner_remove,
+                              const float factor)
+{
+  const T value_keep = values[corner_keep];
+  const T value_remove = values[corner_remove];
+  const T mixed = bke::attribute_math::mix2(factor, value_keep, value_remove);
+  for (const int corner : mesh.vert_corners[mesh.corner_verts[corner_keep]]) {
+    if (values[corner] == value_keep) {
+      values[corner] = mixed;
+    }
+  }
+  for (const int corner : mesh.vert_corners[mesh.corner_verts[corner_remove]]) {
+    if (values[corner] == value_remove) {
+      values[corner] = mixed;
+    }
+  }
+}
+
+/**
+ * Merge the second vertex into the first one at the given position, removing the triangles that
+ * use the edge between them.
+ * \return The number of removed triangles.
+ */
+static int collapse_edge(DecimateMesh &mesh,
+                         const int v_keep,
+                         const int v_remove,
+                         const float3 &position)
+{
+  const float factor = std::clamp(
+      line_point_factor_v3(position, mesh.positions[v_keep], mesh.positions[v_remove]),
+      0.0f,
+      1.0f);
+
+  Vector<int, 2> removed_tris;
+  for (const int corner : mesh.vert_corners[v_keep]) {
+    if (ELEM(v_remove,
+             mesh.corner_verts[tri_corner_next(corner)],
+             mesh.corner_verts[tri_corner_prev(corner)]))
+    {
+      removed_tris.append(corner / 3);
+    }
+  }
+
+  for (const int tri : removed_tris) {
+    int corner_keep = -1;
+    int corner_remove = -1;
+    for (const int corner : IndexRange(tri * 3, 3)) {
+      if (mesh.corner_verts[corner] == v_keep) {
+        corner_keep = corner;
+      }
+      else if (mesh.corner_verts[corner] == v_remove) {
+        corner_remove = corner;
+      }
+    }
+    for (MixedAttribute &attribute : mesh.corner_attributes) {
+      bke::attribute_math::convert_to_static_type(attribute.values.type(), [&](auto dummy) {
+        using T = decltype(dummy);
+        if constexpr (!std::is_void_v<bke::attribute_math::DefaultMixer<T>>) {
+          mix_corner_values(mesh,
+                            attribute.values.as_mutable_span().typed<T>(),
+                            corner_keep,
+                            corner_remove,
+                            factor);
+        }
+      });
+    }
+  }
+
+  for (MixedAttribute &attribute : mesh.point_attributes) {
+    bke::attribute_math::convert_to_static_type(attribute.values.type(), [&](auto dummy) {
+      using T = decltype(dummy);
+      if constexpr (!std::is_void_v<bke::attribute_math::DefaultMixer<T>>) {
+        MutableSpan<T> values = attribute.values.as_mutable_span().typed<T>();
+        values[v_keep] = bke::attribute_math::mix2(factor, values[v_keep], values[v_remove]);
+      }
+    });
+  }
+  if (!mesh.vert_weights.is_empty()) {
+    mesh.vert_weights[v_keep] = math::interpolate(
+        mesh.vert_weights[v_keep], mesh.vert_weights[v_remove], factor);
+  }
+  mesh.vert_normals[v_keep] = math::normalize(
+      math::interpolate(mesh.vert_normals[v_keep], mesh.vert_normals[v_remove], factor));
+  BLI_quadric_add_qu_qu(&mesh.quadrics[v_keep], &mesh.quadrics[v_remove]);
+  mesh.positions[v_keep] = position;
+
+  for (const int tri : removed_tris) {
+    mesh.tri_removed[tri] = true;
+    for (const int corner : IndexRange(tri * 3, 3)) {
+      mesh.vert_corners[mesh.corner_verts[corner]].remove_first_occurrence_and_reorder(corner);
+    }
+  }
+  for (const int corner : mesh.vert_corners[v_remove]) {
+    mesh.corner_verts[corner] = v_keep;
+    mesh.vert_corners[v_keep].append(corner);
+  }
+  mesh.vert_corners[v_remove].clear_and_shrink();
+  mesh.vert_merge_targets[v_remove] = v_keep;
+  mesh.vert_versions[v_keep]++;
+  mesh.vert_versions[v_remove]++;
+
+  return removed_tris.size();
+}
+
+/**
+ * Collapse the candidate edges in order of their cost, until the cost is above the given
+ * maximum or enough triangles have been removed. Edges around collapsed edges are added as new
+ * candidates. Only vertices tagged as collapsible are changed.
+ * \return The number of removed triangles.
+ */
+static int collapse_edges(DecimateMesh &mesh,
+                          const Span<bool> collapsible_verts,
+                          std::vector<CollapseEdge> candidates,
+                          const float max_cost,
+                          const int tris_to_remove)
+{
+  CollapseHeap heap(std::greater<CollapseEdge>(), std::move(candidates));
+  const auto add_candidate = [&](const CollapseEdge &edge) { heap.push(edge); };
+
+  int removed_tris = 0;
+  Vector<int, 16> neighbors;
+  while (!heap.empty() && removed_tris < tris_to_remove) {
+    const CollapseEdge edge = heap.top();
+    heap.pop();
+    if (edge.cost > max_cost) {
+      break;
+    }
+    if (edge.v1_version != mesh.vert_versions[edge.v1] ||
+        edge.v2_version != mesh.vert_versions[edge.v2])
+    {
+      continue;
+    }
+    if (collapse_is_degenerate_topology(mesh, edge.v1, edge.v2)) {
+      continue;
+    }
+    const float3 position(calc_collapse_position(mesh, edge.v1, edge.v2));
+    if (collapse_is_degenerate_flip(mesh, edge.v1, edge.v2, position)) {
+      continue;
+    }
+
+    removed_tris += collapse_edge(mesh, edge.v1, edge.v2, position);
+
+    /* Update the edges around the remaining vertex, and add the outer edges of its triangles
+     * again, since they may not be degenerate anymore. */
+    gather_vert_neighbors(mesh, edge.v1, neighbors);
+    for (const int neighbor : neighbors) {
+      add_collapse_candidate(mesh, collapsible_verts, edge.v1, neighbor, add_candidate);
+    }
+    for (const int corner : mesh.vert_corners[edge.v1]) {
+      add_collapse_candidate(mesh,
+                             collapsible_verts,
+                             mesh.corner_verts[tri_corner_next(corner)],
+                             mesh.corner_verts[tri_corner_prev(corner)],
+                             add_candidate);
+    }
+  }
+  return removed_tris;
+}
+
+static int calc_cells_per_axis(const int verts_num)
+{
+  return std::max(int(std::cbrt(double(verts_num) / verts_per_cell)), 1);
+}
+
+/**
+ * Collapse edges in all cells of a grid in parallel. The number of collapses is chosen so that
+ * at most half of the remaining triangles are removed, and is distributed to the cells based on
+ * the cost of their candidate edges. This makes the result independent of the scheduling.
+ * \return The number of removed triangles.
+ */
+static int collapse_edges_in_cells(DecimateMesh &mesh,
+                                   const Bounds<float3> &bounds,
+                                   const int cells_per_axis,
+                                   const int round,
+                                   const int tris_to_remove)
+{
+  const int verts_num = mesh.positions.size();
+  const float3 cell_size = math::max((bounds.max - bounds.min) / float(cells_per_axis),
+                                     float3(FLT_EPSILON));
+  /* Shift the grid by a different fraction of a cell in every round. */
+  const float3 offset = cell_size *
+                        math::fract(float(round) * float3(0.618034f, 0.414214f, 0.732051f));
+  /* The shifted grid needs one more cell along each axis. */
+  const int grid_size = cells_per_axis + 1;
+  const int cells_num = grid_size * grid_size * grid_size;
+
+  Array<int> vert_cells(verts_num);
+  threading::parallel_for(IndexRange(verts_num), 4096, [&](const IndexRange range) {
+    for (const int vert : range) {
+      const int3 cell = math::clamp(int3((mesh.positions[vert] - bounds.min + offset) / cell_size),
+                                    int3(0),
+                                    int3(cells_per_axis));
+      vert_cells[vert] = (cell.z * grid_size + cell.y) * grid_size + cell.x;
+    }
+  });
+
+  /* Vertices whose triangles are all in the same cell. */
+  Array<bool> collapsible_verts(verts_num);
+  threading::parallel_for(IndexRange(verts_num), 2048, [&](const IndexRange range) {
+    for (const int vert : range) {
+      const Span<int> corners = mesh.vert_corners[vert];
+      collapsible_verts[vert] = !corners.is_empty() &&
+                                std::all_of(corners.begin(), corners.end(), [&](const int corner) {
+                                  const int cell = vert_cells[vert];
+                                  return vert_cells[mesh.corner_verts[tri_corner_next(corner)]] ==
+                                             cell &&
+                                         vert_cells[mesh.corner_verts[tri_corner_prev(corner)]] ==
+                                             cell;
+                                });
+    }
+  });
+
+  Array<int> offsets;
+  Array<int> indices;
+  const GroupedSpan<int> cell_verts = bke::mesh::build_vert_to_corner_map(
+      vert_cells, cells_num, offsets, indices);
+
+  Array<std::vector<CollapseEdge>> cell_candidates(cells_num);
+  threading::parallel_for(IndexRange(cells_num), 1, [&](const IndexRange range) {
+    for (const int cell : range) {
+      cell_candidates[cell] = gather_collapse_candidates(
+          mesh, collapsible_verts, cell_verts[cell]);
+    }
+  });
+
+  /* Find the candidate edge that limits the number of collapses in this round. */
+  std::vector<CollapseEdge> all_candidates;
+  for (const std::vector<CollapseEdge> &candidates : cell_candidates) {
+    all_candidates.insert(all_candidates.end(), candidates.begin(), candidates.end());
+  }
+  if (all_candidates.empty()) {
+    return 0;
+  }
+  const int64_t collapses_num = std::clamp<int64_t>(
+      tris_to_remove / 4, 1, int64_t(all_candidates.size()));
+  std::nth_element(all_candidates.begin(),
+                   all_candidates.begin() + (collapses_num - 1),
+                   all_candidates.end());
+  const CollapseEdge last_collapse = all_candidates[collapses_num - 1];
+  all_candidates = {};
+
+  Array<int> cell_removed_tris(cells_num, 0);
+  threading::parallel_for(IndexRange(cells_num), 1, [&](const IndexRange range) {
+    for (const int cell : range) {
+      std::vector<CollapseEdge> &candidates = cell_candidates[cell];
+      const int cell_collapses_num = std::count_if(
+          candidates.begin(), candidates.end(), [&](const CollapseEdge &edge) {
+            return !(last_collapse < edge);
+          });
+      if (cell_collapses_num == 0) {
+        continue;
+      }
+      cell_removed_tris[cell] = collapse_edges(mesh,
+                                               collapsible_verts,
+                                               std::move(candidates),
+                                               last_collapse.cost,
+                                               cell_collapses_num * 2);
+    }
+  });
+  return std::accumulate(cell_removed_tris.begin(), cell_removed_tris.end(), 0);
+}
+
+/**
+ * Collapse edges until the given number of triangles is removed, or no more edges can be
+ * collapsed.
+ * \return The number of removed triangles.
+ */
+static int collapse_edges_until_target(DecimateMesh &mesh, int tris_to_remove)
+{
+  const int verts_num = mesh.positions.size();
+  int removed_tris = 0;
+  const int cells_per_axis = calc_cells_per_axis(verts_num);
+  if (cells_per_axis > 1) {
+    const Bounds<float3> bounds = *bounds::min_max(mesh.positions.as_span());
+    for (int round = 0; tris_to_remove > parallel_min_tris_to_remove; round++) {
+      const int round_removed_tris = collapse_edges_in_cells(
+          mesh, bounds, cells_per_axis, round, tris_to_remove);
+      removed_tris += round_removed_tris;
+      tris_to_remove -= round_removed_tris;
+      /* Finish in a single cell when cell borders prevent most collapses. */
+      if (round_removed_tris < tris_to_remove / 8) {
+        break;
+      }
+    }
+  }
+  if (tris_to_remove > 0) {
+    const Array<bool> collapsible_verts(verts_num, true);
+    Array<int> verts(verts_num);
+    array_utils::fill_index_range<int>(verts);
+    std::vector<CollapseEdge> candidates = gather_collapse_candidates(
+        mesh, collapsible_verts, verts);
+    removed_tris += collapse_edges(mesh,
+                                   collapsible_verts,
+                                   std::move(candidates),
+                                   std::numeric_limits<float>::max(),
+                                   tris_to_remove);
+  }
+  return removed_tris;
+}
+
+/** Find the vertex that each vertex was merged into, or its own index in the result mesh. */
+static Array<int> calc_vert_map(const DecimateMesh &mesh, const IndexMask &verts)
+{
+  Array<int> vert_map(mesh.positions.size());
+  index_mask::build_reverse_map<int>(verts, vert_map);
+  threading::parallel_for(vert_map.index_range(), 4096, [&](const IndexRange range) {
+    for (const int vert : range) {
+      int target = vert;
+      while (mesh.vert_merge_targets[target] != -1) {
+        target = mesh.vert_merge_targets[target];
+      }
+      if (target != vert) {
+        vert_map[vert] = vert_map[target];
+      }
+    }
+  });
+  return vert_map;
+}
+
+static void gather_origindex(const CustomData &src_data,
+                             const int src_size,
+                             const Span<int> indices,
+                             CustomData &dst_data)
+{
+  const int *src = static_cast<const int *>(CustomData_get_layer(&src_data, CD_ORIGINDEX));
+  if (!src) {
+    return;
+  }
+  int *dst = static_cast<int *>(
+      CustomData_add_layer(&dst_data, CD_ORIGINDEX, CD_CONSTRUCT, indices.size()));
+  array_utils::gather(Span(src, src_size), indices, MutableSpan(dst, indices.size()));
+}
+
+static void gather_origindex(const CustomData &src_data,
+                             const int src_size,
+                             const IndexMask &mask,
+                             CustomData &dst_data)
+{
+  const int *src = static_cast<const int *>(CustomData_get_layer(&src_data, CD_ORIGINDEX));
+  if (!src) {
+    return;
+  }
+  int *dst = static_cast<int *>(
+      CustomData_add_layer(&dst_data, CD_ORIGINDEX, CD_CONSTRUCT, mask.size()));
+  array_utils::gather(Span(src, src_size), mask, MutableSpan(dst, mask.size()));
+}
+
+static Mesh *create_result_mesh(const Mesh &src_mesh,
+                                const DecimateMesh &mesh,
+                                const bke::AttributeFilter &attribute_filter)
+{
+  const bke::AttributeAccessor src_attributes = src_mesh.attributes();
+  const Span<int2> src_edges = src_mesh.edges();
+
+  IndexMaskMemory memory;
+  const IndexMask tris = IndexMask::from_bools_inverse(VArray<bool>::ForSpan(mesh.tri_removed),
+                                                       memory);
+  const IndexMask corners = IndexMask::from_predicate(
+      IndexRange(src_mesh.corners_num), GrainSize(4096), memory, [&](const int corner) {
+        return !mesh.tri_removed[corner / 3];
+      });
+  const IndexMask verts = IndexMask::from_predicate(
+      IndexRange(src_mesh.verts_num), GrainSize(4096), memory, [&](const int vert) {
+        return mesh.vert_merge_targets[vert] == -1;
+      });
+  const Array<int> vert_map = calc_vert_map(mesh, verts);
+
+  /* Loose edges aren't collapsed, but their vertices may have been merged. */
+  Vector<int2> loose_edges;
+  Vector<int> loose_edge_src;
+  const bke::LooseEdgeCache &loose_edges_cache = src_mesh.loose_edges();
+  if (loose_edges_cache.count > 0) {
+    const IndexMask src_loose_edges = IndexMask::from_bits(loose_edges_cache.is_loose_bits,
+                                                           memory);
+    src_loose_edges.foreach_index([&](const int src_edge) {
+      const int2 edge(vert_map[src_edges[src_edge][0]], vert_map[src_edges[src_edge][1]]);
+      if (edge[0] != edge[1]) {
+        loose_edges.append(edge);
+        loose_edge_src.append(src_edge);
+      }
+    });
+  }
+
+  Mesh *result = bke::mesh_new_no_attributes(
+      verts.size(), loose_edges.size(), tris.size(), tris.size() * 3);
+  BKE_mesh_copy_parameters_for_eval(result, &src_mesh);
+  offset_indices::fill_constant_group_size(3, 0, result->face_offsets_for_write());
+
+  bke::MutableAttributeAccessor attributes = result->attributes_for_write();
+  attributes.add<float3>("position", bke::AttrDomain::Point, bke::AttributeInitConstruct());
+  attributes.add<int2>(".edge_verts", bke::AttrDomain::Edge, bke::AttributeInitConstruct());
+  attributes.add<int>(".corner_vert", bke::AttrDomain::Corner, bke::AttributeInitConstruct());
+
+  array_utils::gather(mesh.positions.as_span(), verts, result->vert_positions_for_write());
+  result->edges_for_write().copy_from(loose_edges);
+  MutableSpan<int> corner_verts = result->corner_verts_for_write();
+  corners.foreach_index(GrainSize(4096), [&](const int src_corner, const int dst_corner) {
+    corner_verts[dst_corner] = vert_map[mesh.corner_verts[src_corner]];
+  });
+
+  bke::mesh_calc_edges(*result, true, false);
+
+  /* Find an original edge for every edge of the result. Where several edges were merged, the one
+   * used by the first remaining triangle is used. */
+  const Span<int> src_corner_edges = src_mesh.corner_edges();
+  const Span<int> corner_edges = result->corner_edges();
+  Array<int> edge_src(result->edges_num, -1);
+  corners.foreach_index([&](const int src_corner, const int dst_corner) {
+    int &src_edge = edge_src[corner_edges[dst_corner]];
+    if (src_edge == -1) {
+      src_edge = src_corner_edges[src_corner];
+    }
+  });
+  if (!loose_edges.is_empty()) {
+    Map<OrderedEdge, int> loose_edge_map;
+    for (const int i : loose_edges.index_range()) {
+      loose_edge_map.add(loose_edges[i], loose_edge_src[i]);
+    }
+    const Span<int2> edges = result->edges();
+    for (const int edge : edge_src.index_range()) {
+      if (edge_src[edge] == -1) {
+        edge_src[edge] = loose_edge_map.lookup(edges[edge]);
+      }
+    }
+  }
+
+  Vector<StringRef> mixed_point_names;
+  for (const MixedAttribute &attribute : mesh.point_attributes) {
+    bke::GSpanAttributeWriter dst = attributes.lookup_or_add_for_write_only_span(
+        attribute.name,
+        bke::AttrDomain::Point,
+        bke::cpp_type_to_custom_data_type(attribute.values.type()));
+    array_utils::gather(attribute.values.as_span(), verts, dst.span);
+    dst.finish();
+    mixed_point_names.append(attribute.name);
+  }
+  mixed_point_names.append("position");
+  bke::gather_attributes(src_attributes,
+                         bke::AttrDomain::Point,
+                         bke::AttrDomain::Point,
+                         bke::attribute_filter_with_skip_ref(attribute_filter, mixed_point_names),
+                         verts,
+                         attributes);
+  gather_origindex(src_mesh.vert_data, src_mesh.verts_num, verts, result->vert_data);
+
+  for (bke::AttributeTransferData &attribute : bke::retrieve_attributes_for_transfer(
+           src_attributes,
+           attributes,
+           ATTR_DOMAIN_MASK_EDGE,
+           bke::attribute_filter_with_skip_ref(attribute_filter, {".edge_verts"})))
+  {
+    bke::attribute_math::gather(attribute.src, edge_src.as_span(), attribute.dst.span);
+    attribute.dst.finish();
+  }
+  gather_origindex(src_mesh.edge_data, src_mesh.edges_num, edge_src.as_span(), result->edge_data);
+
+  bke::gather_attributes(src_attributes,
+                         bke::AttrDomain::Face,
+                         bke::AttrDomain::Face,
+                         attribute_filter,
+                         tris,
+                         attributes);
+  gather_origindex(src_mesh.face_data, src_mesh.faces_num, tris, result->face_data);
+
+  Vector<StringRef> mixed_corner_names;
+  for (const MixedAttribute &attribute : mesh.corner_attributes) {
+    bke::GSpanAttributeWriter dst = attributes.lookup_or_add_for_write_only_span(
+        attribute.name,
+        bke::AttrDomain::Corner,
+        bke::cpp_type_to_custom_data_type(attribute.values.type()));
+    array_utils::gather(attribute.values.as_span(), corners, dst.span);
+    dst.finish();
+    mixed_corner_names.append(attribute.name);
+  }
+  mixed_corner_names.extend({".corner_vert", ".corner_edge"});
+  bke::gather_attributes(src_attributes,
+                         bke::AttrDomain::Corner,
+                         bke::AttrDomain::Corner,
+                         bke::attribute_filter_with_skip_ref(attribute_filter, mixed_corner_names),
+                         corners,
+                         attributes);
+
+  BLI_assert(BKE_mesh_is_valid(result));
+  return result;
+}
+
+}  // namespace decimate
+
+std::optional<Mesh *> mesh_decimate_collapse(const Mesh &src_mesh,
+                                             const float face_ratio,
+                                             const Span<float> vert_weights,
+                                             const float vert_weight_factor,
+                                             const bke::AttributeFilter &attribute_filter)
+{
+  using namespace decimate;
+  if (face_ratio >= 1.0f || src_mesh.faces_num == 0) {
+    return std::nullopt;
+  }
+
+  Mesh *tri_mesh = mesh_triangulate(src_mesh,
+                                    IndexMask(src_mesh.faces_num),
+                                    TriangulateNGonMode::Beauty,
+                                    TriangulateQuadMode::Beauty,
+                                    attribute_filter)
+                       .value_or(nullptr);
+  BLI_SCOPED_DEFER([&]() {
+    if (tri_mesh) {
+      BKE_id_free(nullptr, tri_mesh);
+    }
+  });
+  const Mesh &mesh = tri_mesh ? *tri_mesh : src_mesh;
+
+  const int tris_num = mesh.faces_num;
+  const int tris_to_remove = tris_num - std::max(int(tris_num * face_ratio), 0);
+
+  DecimateMesh decimate_mesh = create_decimate_mesh(
+      mesh, vert_weights, vert_weight_factor, attribute_filter);
+
+  const int removed_tris = collapse_edges_until_target(decimate_mesh, tris_to_remove);
+
+  if (removed_tris == 0) {
+    if (tri_mesh) {
+      return std::exchange(tri_mesh, nullptr);
+    }
+    return std::nullopt;
+  }
+  return create_result_mesh(mesh, decimate_mesh, attribute_filter);
+}
+
+}  // namespace blender::geometry
@@ -0,0 +1,139 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "BLI_math_vector.hh"
+
+#include "BKE_attribute.hh"
+#include "BKE_idtype.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_mesh.h"
+#include "BKE_mesh.hh"
+#include "BKE_mesh_mapping.hh"
+
+#include "DNA_mesh_types.h"
+
+#include "GEO_mesh_decimate.hh"
+#include "GEO_mesh_primitive_grid.hh"
+#include "GEO_mesh_primitive_uv_sphere.hh"
+
+#include "testing/testing.h"
+
+namespace blender::geometry::tests {
+
+class mesh_decimate : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+};
+
+TEST_F(mesh_decimate, Grid)
+{
+  Mesh *mesh = create_grid_mesh(64, 64, 1.0f, 1.0f, "UVMap");
+  const int tris_num = mesh->faces_num * 2;
+
+  Mesh *result = *mesh_decimate_collapse(*mesh, 0.25f, {}, 0.0f, {});
+  EXPECT_NEAR(result->faces_num, tris_num / 4, 1);
+  EXPECT_EQ(result->corners_num, result->faces_num * 3);
+  EXPECT_TRUE(BKE_mesh_is_valid(result));
+  EXPECT_TRUE(result->attributes().contains("UVMap"));
+
+  /* The grid is flat, and the boundary is kept. */
+  const Bounds<float3> bounds = *result->bounds_min_max();
+  EXPECT_NEAR(bounds.min.x, -0.5f, 1e-5f);
+  EXPECT_NEAR(bounds.max.x, 0.5f, 1e-5f);
+  for (const float3 &position : result->vert_positions()) {
+    EXPECT_NEAR(position.z, 0.0f, 1e-5f);
+  }
+
+  BKE_id_free(nullptr, result);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(mesh_decimate, SphereStaysClosed)
+{
+  Mesh *mesh = create_uv_sphere_mesh(1.0f, 64, 32, std::nullopt);
+
+  Mesh *result = *mesh_decimate_collapse(*mesh, 0.3f, {}, 0.0f, {});
+  EXPECT_LT(result->faces_num, mesh->faces_num);
+  EXPECT_TRUE(BKE_mesh_is_valid(result));
+
+  Array<int> offsets;
+  Array<int> indices;
+  const GroupedSpan<int> edge_to_face = bke::mesh::build_edge_to_face_map(
+      result->faces(), result->corner_edges(), result->edges_num, offsets, indices);
+  for (const int edge : edge_to_face.index_range()) {
+    EXPECT_EQ(edge_to_face[edge].size(), 2);
+  }
+
+  BKE_id_free(nullptr, result);
+  BKE_id_free(nullptr, mesh);
+}
+
+/* A mesh large enough to be decimated in parallel in more than one cell along each axis. */
+TEST_F(mesh_decimate, LargeSphereInCells)
+{
+  Mesh *mesh = create_uv_sphere_mesh(1.0f, 384, 192, std::nullopt);
+  ASSERT_GE(mesh->verts_num, 2 * 2 * 2 * 4096);
+  int tris_num = 0;
+  for (const int face : mesh->faces().index_range()) {
+    tris_num += mesh->faces()[face].size() - 2;
+  }
+
+  Mesh *result = *mesh_decimate_collapse(*mesh, 0.1f, {}, 0.0f, {});
+  EXPECT_NEAR(result->faces_num, tris_num / 10, tris_num / 100);
+  EXPECT_EQ(result->corners_num, result->faces_num * 3);
+  EXPECT_TRUE(BKE_mesh_is_valid(result));
+
+  /* Collapses in neighboring cells must not break the surface apart. */
+  Array<int> offsets;
+  Array<int> indices;
+  const GroupedSpan<int> edge_to_face = bke::mesh::build_edge_to_face_map(
+      result->faces(), result->corner_edges(), result->edges_num, offsets, indices);
+  for (const int edge : edge_to_face.index_range()) {
+    EXPECT_EQ(edge_to_face[edge].size(), 2);
+  }
+  for (const float3 &position : result->vert_positions()) {
+    EXPECT_NEAR(math::length(position), 1.0f, 0.05f);
+  }
+
+  BKE_id_free(nullptr, result);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(mesh_decimate, ZeroWeightsKeepVertices)
+{
+  Mesh *mesh = create_grid_mesh(32, 32, 1.0f, 1.0f, std::nullopt);
+  const Span<float3> positions = mesh->vert_positions();
+
+  /* Only vertices on the right half of the grid can be collapsed. */
+  Array<float> weights(mesh->verts_num);
+  int kept_verts_num = 0;
+  for (const int vert : positions.index_range()) {
+    weights[vert] = positions[vert].x > 0.0f ? 1.0f : 0.0f;
+    kept_verts_num += positions[vert].x <= 0.0f;
+  }
+
+  Mesh *result = *mesh_decimate_collapse(*mesh, 0.1f, weights, 1.0f, {});
+  EXPECT_TRUE(BKE_mesh_is_valid(result));
+  int result_kept_verts_num = 0;
+  for (const float3 &position : result->vert_positions()) {
+    result_kept_verts_num += position.x <= 0.0f;
+  }
+  EXPECT_EQ(result_kept_verts_num, kept_verts_num);
+  EXPECT_LT(result->verts_num, mesh->verts_num);
+
+  BKE_id_free(nullptr, result);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(mesh_decimate, FullRatioUnchanged)
+{
+  Mesh *mesh = create_grid_mesh(4, 4, 1.0f, 1.0f, std::nullopt);
+  EXPECT_FALSE(mesh_decimate_collapse(*mesh, 1.0f, {}, 0.0f, {}).has_value());
+  BKE_id_free(nullptr, mesh);
+}
+
+}  // namespace blender::geometry::tests
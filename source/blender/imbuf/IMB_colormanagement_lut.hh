@@ -0,0 +1,82 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup imbuf
+ *
+ * 3D lookup tables that approximate color transforms.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "BLI_array.hh"
+#include "BLI_function_ref.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
+
+namespace blender::imbuf {
+
+/**
+ * A 3D lookup table that approximates an RGB color transform, like an OCIO display transform,
+ * using tetrahedral interpolation between the transformed colors of a regular lattice.
+ *
+ * The input is first mapped to the lattice using a per channel shaper function. The linear shaper
+ * maps the [0, 1] range linearly and is meant for display referred inputs like byte images. The
+ * logarithmic shaper covers the [0, #ColorLUT3D::log_shaper_max] range and is meant for scene
+ * linear inputs, allocating more lattice points to darker colors. Inputs outside of the range of
+ * the shaper are clamped, so the table is only accurate for transforms whose outputs don't depend
+ * on values outside of that range, which is the case for display transforms when the result is
+ * quantized to bytes.
+ */
+class ColorLUT3D {
+ public:
+  enum class Shaper {
+    Linear,
+    Log,
+  };
+
+  /* The largest input value covered by the logarithmic shaper and the value around which it
+   * switches from being mostly linear to mostly logarithmic. */
+  static constexpr float log_shaper_max = 1024.0f;
+  static constexpr float log_shaper_knee = 1.0f / 1024.0f;
+
+  /* The default number of lattice points along each axis. */
+  static constexpr int default_resolution = 65;
+
+ private:
+  int resolution_;
+  Shaper shaper_;
+  /* The transformed colors of the lattice points, where the red axis varies fastest. Colors are
+   * stored in 4 components to allow aligned vector loads, the last component is unused. */
+  Array<float4> table_;
+
+ public:
+  /**
+   * Bake the given transform into a table with the given number of lattice points along each
+   * axis. The transform is called once with the RGBA colors of all lattice points, whose alpha is
+   * one, and should transform them in place.
+   */
+  ColorLUT3D(int resolution, Shaper shaper, FunctionRef<void(MutableSpan<float4>)> transform);
+
+  /** Transform a single color. */
+  float3 evaluate(const float3 &color) const;
+
+  /**
+   * Transform the RGB channels of the given pixels in place, where pixels have the given number of
+   * channels, which should be 3 or 4. If predivide is true, the colors are divided by the alpha
+   * before the transform and multiplied by it after it.
+   */
+  void apply(float *buffer, int64_t pixels_count, int channels, bool predivide) const;
+
+  /** Returns the size of the table in bytes. */
+  int64_t size_in_bytes() const;
+
+ private:
+  float shape(float value) const;
+  float unshape(float value) const;
+};
+
+}  // namespace blender::imbuf
@@ -522,6 +522,16 @@ void *imb_alloc_pixels(unsigned int x,
                        bool initialize_pixels,
                        const char *alloc_name);
 
+/**
+ * Allocate uninitialized pixel storage of the given size in bytes and alignment, reusing the
+ * storage of a recently freed image buffer of the same size if possible. The storage should be
+ * assigned to an image buffer using #IB_TAKE_POOLED_OWNERSHIP, which returns it to the pool when
+ * the buffer is freed. This avoids allocating and page faulting large buffers for every image when
+ * images of the same size are allocated and freed at a high rate, like frames during movie
+ * playback.
+ */
+void *IMB_alloc_pooled_pixels(size_t size, size_t alignment);
+
 /**
  * Allocate storage for byte type pixels.
  * If the image already contains byte data storage, it is freed first.
@@ -121,6 +121,12 @@ enum ImBufOwnership {
   /* The ImBuf takes ownership of the buffer data, and will use MEM_freeN() to free this memory
    * when the ImBuf needs to free the data. */
   IB_TAKE_OWNERSHIP = 1,
+
+  /* The ImBuf takes ownership of the buffer data, which was allocated by
+   * IMB_alloc_pooled_pixels(), and returns it to the pool when the ImBuf frees the buffer, such
+   * that later allocations of the same size can reuse it. The data can still be freed with
+   * MEM_freeN(). */
+  IB_TAKE_POOLED_OWNERSHIP = 2,
 };
 
 struct DDSData {
@@ -8,7 +8,11 @@
  * \ingroup imbuf
  */
 
+#include <cstdint>
+#include <string>
+
 #include "BLI_ghash.h"
+#include "BLI_map.hh"
 
 /* Cache system for movie data - now supports storing ImBufs only
  * Supposed to provide unified cache system for movie clips, sequencer and
@@ -56,6 +60,33 @@ void IMB_moviecache_cleanup(MovieCache *cache,
 void IMB_moviecache_get_cache_segments(
     MovieCache *cache, int proxy, int render_flags, int *r_totseg, int **r_points);
 
+/**
+ * Usage statistics of movie caches, used to tune the memory cache limit.
+ */
+struct MovieCacheStatistics {
+  /** Number of lookups that found a cached frame, including frames that were cached empty. */
+  int64_t hits = 0;
+  /** Number of lookups that didn't find a cached frame. */
+  int64_t misses = 0;
+  /** Number of frames that were destroyed to keep the memory below the cache limit. */
+  int64_t evictions = 0;
+  /** Number of frames that currently count towards the cache limit. */
+  int64_t items_num = 0;
+  /** Memory in bytes used by the frames that currently count towards the cache limit. */
+  int64_t memory_in_use = 0;
+};
+
+/**
+ * Get the statistics of all existing caches, summed over caches with the same name. Hits, misses
+ * and evictions are counted since the caches were created.
+ */
+blender::Map<std::string, MovieCacheStatistics> IMB_moviecache_get_statistics();
+
+/**
+ * Get the memory in bytes used by the frames of all caches that count towards the cache limit.
+ */
+int64_t IMB_moviecache_get_memory_in_use();
+
 struct MovieCacheIter;
 MovieCacheIter *IMB_moviecacheIter_new(MovieCache *cache);
 void IMB_moviecacheIter_free(MovieCacheIter *iter);
@@ -27,6 +27,8 @@ void *IMB_exr_get_handle_name(const char *name);
  * Adds flattened #ExrChannel's
  * `xstride`, `ystride` and `rect` can be done in set_channel too, for tile writing.
  * \param passname: Does not include view.
+ * \param compress: The compression used when writing the channel, or -1 to use the compression
+ * of the file. Files whose passes use different compressions are written with a part per pass.
  */
 void IMB_exr_add_channel(void *handle,
                          const char *layname,
@@ -35,7 +37,8 @@ void IMB_exr_add_channel(void *handle,
                          int xstride,
                          int ystride,
                          float *rect,
-                         bool use_half_float);
+                         bool use_half_float,
+                         int compress = -1);
 
 /**
  * Read from file.
@@ -53,11 +56,20 @@ bool IMB_exr_begin_write(void *handle,
                          int quality,
                          const StampData *stamp);
 /**
- * Only used for writing temp. render results (not image files)
- * (FSA and Save Buffers).
+ * Used for output files that are written progressively tile by tile, for instance, by the
+ * compositor when it is evaluated in tiles. Each view is stored in its own part if there are
+ * multiple views. Tiles are then written using #IMB_exrtile_write_channels.
  */
-void IMB_exrtile_begin_write(
-    void *handle, const char *filepath, int mipmap, int width, int height, int tilex, int tiley);
+bool IMB_exrtile_begin_write(void *handle,
+                             const char *filepath,
+                             int mipmap,
+                             int width,
+                             int height,
+                             int tilex,
+                             int tiley,
+                             int compress,
+                             int quality,
+                             const StampData *stamp);
 
 /**
  * Still clumsy name handling, layers/channels can be ordered as list in list later.
@@ -78,8 +90,9 @@ float *IMB_exr_channel_rect(void *handle,
 void IMB_exr_read_channels(void *handle);
 void IMB_exr_write_channels(void *handle);
 /**
- * Temporary function, used for FSA and Save Buffers.
- * called once per `tile * view`.
+ * Write the tile whose lower corner is at the given pixel coordinates in the given view, where
+ * the rects of the channels point to the first pixel of the tile, see #IMB_exr_set_channel.
+ * Called once per `tile * view`.
  */
 void IMB_exrtile_write_channels(
     void *handle, int partx, int party, int level, const char *viewname, bool empty);
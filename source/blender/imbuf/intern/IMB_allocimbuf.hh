@@ -24,5 +24,10 @@ void imb_mmap_unlock();
 #  define imb_mmap_unlock()
 #endif
 
+/** Return pixels allocated by #IMB_alloc_pooled_pixels to the pool. */
+void imb_free_pooled_pixels(void *data);
+/** Free all pixels that are held by the pool. */
+void imb_free_pixel_pool();
+
 bool imb_addencodedbufferImBuf(ImBuf *ibuf);
 bool imb_enlargeencodedbufferImBuf(ImBuf *ibuf);
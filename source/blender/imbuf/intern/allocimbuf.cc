@@ -11,6 +11,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <mutex>
 
 #include "IMB_imbuf.hh"
 #include "IMB_imbuf_types.hh"
@@ -25,6 +26,7 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_threads.h"
+#include "BLI_vector.hh"
 
 #include "GPU_texture.hh"
 
@@ -76,6 +78,10 @@ template<class BufferType> static void imb_free_buffer(BufferType &buffer)
       case IB_TAKE_OWNERSHIP:
         MEM_freeN(buffer.data);
         break;
+
+      case IB_TAKE_POOLED_OWNERSHIP:
+        imb_free_pooled_pixels(buffer.data);
+        break;
     }
   }
 
@@ -97,6 +103,10 @@ static void imb_free_dds_buffer(DDSData &dds_data)
         /* dds_data.data is allocated by DirectDrawSurface::readData(), so don't use MEM_freeN! */
         free(dds_data.data);
         break;
+
+      case IB_TAKE_POOLED_OWNERSHIP:
+        BLI_assert_unreachable();
+        break;
     }
   }
 
@@ -140,6 +150,7 @@ template<class BufferType> void imb_make_writeable_buffer(BufferType &buffer)
       buffer.ownership = IB_TAKE_OWNERSHIP;
 
     case IB_TAKE_OWNERSHIP:
+    case IB_TAKE_POOLED_OWNERSHIP:
       break;
   }
 }
@@ -156,7 +167,9 @@ auto imb_steal_buffer_data(BufferType &buffer) -> decltype(BufferType::data)
       BLI_assert_msg(false, "Unexpected behavior: stealing non-owned data pointer");
       return nullptr;
 
-    case IB_TAKE_OWNERSHIP: {
+    case IB_TAKE_OWNERSHIP:
+    case IB_TAKE_POOLED_OWNERSHIP: {
+      /* Pooled data is allocated by the guarded allocator as well, so the caller can free it. */
       decltype(BufferType::data) data = buffer.data;
 
       buffer.data = nullptr;
@@ -377,6 +390,89 @@ void *imb_alloc_pixels(
   return initialize_pixels ? MEM_callocN(size, alloc_name) : MEM_mallocN(size, alloc_name);
 }
 
+/* Pixel buffers that were freed and can be reused by allocations of the same size, ordered from
+ * the least to the most recently freed. Playback only keeps a few frames alive at any time, so a
+ * small pool is enough for most allocations to reuse memory. The pool is not accounted for by the
+ * memory cache limit, so the memory it holds is bounded, which fits a single DCI 4K float frame of
+ * 4096x2160 RGBA pixels (135 MiB) or a few 4K byte frames. */
+struct PooledPixels {
+  void *data;
+  size_t size;
+};
+static constexpr int pixel_pool_size_max = 4;
+static constexpr size_t pixel_pool_memory_max = size_t(256) << 20;
+
+struct PixelPool {
+  std::mutex mutex;
+  blender::Vector<PooledPixels, pixel_pool_size_max> buffers;
+  size_t memory_in_use = 0;
+};
+
+static PixelPool &pixel_pool()
+{
+  static PixelPool pool;
+  return pool;
+}
+
+void *IMB_alloc_pooled_pixels(const size_t size, const size_t alignment)
+{
+  PixelPool &pool = pixel_pool();
+  {
+    std::lock_guard lock(pool.mutex);
+    for (int64_t i = pool.buffers.size() - 1; i >= 0; i--) {
+      const PooledPixels &buffer = pool.buffers[i];
+      if (buffer.size == size && uintptr_t(buffer.data) % alignment == 0) {
+        void *data = buffer.data;
+        pool.memory_in_use -= buffer.size;
+        pool.buffers.remove(i);
+        return data;
+      }
+    }
+  }
+
+  return MEM_mallocN_aligned(size, alignment, __func__);
+}
+
+void imb_free_pooled_pixels(void *data)
+{
+  const size_t size = MEM_allocN_len(data);
+  if (size > pixel_pool_memory_max) {
+    MEM_freeN(data);
+    return;
+  }
+
+  blender::Vector<void *, pixel_pool_size_max> data_to_free;
+  {
+    PixelPool &pool = pixel_pool();
+    std::lock_guard lock(pool.mutex);
+    while (pool.buffers.size() == pixel_pool_size_max ||
+           pool.memory_in_use + size > pixel_pool_memory_max)
+    {
+      const PooledPixels &buffer = pool.buffers.first();
+      data_to_free.append(buffer.data);
+      pool.memory_in_use -= buffer.size;
+      pool.buffers.remove(0);
+    }
+    pool.buffers.append({data, size});
+    pool.memory_in_use += size;
+  }
+
+  for (void *buffer_data : data_to_free) {
+    MEM_freeN(buffer_data);
+  }
+}
+
+void imb_free_pixel_pool()
+{
+  PixelPool &pool = pixel_pool();
+  std::lock_guard lock(pool.mutex);
+  for (const PooledPixels &buffer : pool.buffers) {
+    MEM_freeN(buffer.data);
+  }
+  pool.buffers.clear();
+  pool.memory_in_use = 0;
+}
+
 bool IMB_alloc_float_pixels(ImBuf *ibuf, const unsigned int channels, bool initialize_pixels)
 {
   if (ibuf == nullptr) {
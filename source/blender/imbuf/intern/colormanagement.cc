@@ -8,9 +8,14 @@
 
 #include "IMB_colormanagement.hh"
 #include "IMB_colormanagement_intern.hh"
+#include "IMB_colormanagement_lut.hh"
 
 #include <cmath>
 #include <cstring>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
 
 #include "DNA_color_types.h"
 #include "DNA_image_types.h"
@@ -18,6 +23,7 @@
 #include "DNA_scene_types.h"
 #include "DNA_sequence_types.h"
 #include "DNA_space_types.h"
+#include "DNA_userdef_types.h"
 
 #include "IMB_filetype.hh"
 #include "IMB_filter.hh"
@@ -29,6 +35,7 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_listbase.h"
+#include "BLI_map.hh"
 #include "BLI_math_color.h"
 #include "BLI_math_color.hh"
 #include "BLI_path_utils.hh"
@@ -97,11 +104,33 @@ float imbuf_aces_to_scene_linear[3][3] = {{0.0f}};
 static pthread_mutex_t processor_lock = BLI_MUTEX_INITIALIZER;
 
 struct ColormanageProcessor {
-  OCIO_ConstCPUProcessorRcPtr *cpu_processor;
-  CurveMapping *curve_mapping;
-  bool is_data_result;
+  OCIO_ConstCPUProcessorRcPtr *cpu_processor = nullptr;
+  CurveMapping *curve_mapping = nullptr;
+  bool is_data_result = false;
+
+  /* Identifies the transform of the CPU processor in the cache of 3D lookup tables. Empty if the
+   * transform is unknown, in which case a lookup table is never used. */
+  std::string lut_key;
+  /* A lookup table that approximates the CPU processor, which is applied instead of it if set.
+   * See colormanage_processor_use_lut. */
+  std::shared_ptr<const blender::imbuf::ColorLUT3D> lut;
 };
 
+/* Lookup tables baked from CPU processors, indexed by the keys of the processors. Baking a table
+ * costs about as much as transforming an image with as many pixels as the table has lattice
+ * points, so tables are cached to be reused by the processors of subsequent images, like the
+ * frames of a movie or the redraws of an image with the same view settings. */
+static blender::Map<std::string, std::shared_ptr<const blender::imbuf::ColorLUT3D>> &lut_cache()
+{
+  static blender::Map<std::string, std::shared_ptr<const blender::imbuf::ColorLUT3D>> cache;
+  return cache;
+}
+static std::mutex lut_cache_mutex;
+
+/* The maximum number of cached lookup tables, where the cache is cleared once it is exceeded,
+ * which is enough for the few views and displays used at any one time. */
+static constexpr int lut_cache_max_size = 16;
+
 static struct global_gpu_state {
   /* GPU shader currently bound. */
   bool gpu_shader_bound;
@@ -613,6 +642,12 @@ static void colormanage_free_config()
   ColorSpace *colorspace;
   ColorManagedDisplay *display;
 
+  /* Free lookup tables baked from processors of the configuration. */
+  {
+    std::lock_guard lock{lut_cache_mutex};
+    lut_cache().clear();
+  }
+
   /* free color spaces */
   colorspace = static_cast<ColorSpace *>(global_colorspaces.first);
   while (colorspace) {
@@ -936,6 +971,77 @@ static OCIO_ConstProcessorRcPtr *create_colorspace_transform_processor(const cha
   return processor;
 }
 
+/* Transforms the given colors in place using the given CPU processor. */
+static void cpu_processor_apply_colors(OCIO_ConstCPUProcessorRcPtr *cpu_processor,
+                                       blender::MutableSpan<blender::float4> colors)
+{
+  using namespace blender;
+  threading::parallel_for(colors.index_range(), 16 * 1024, [&](const IndexRange range) {
+    OCIO_PackedImageDesc *img = OCIO_createOCIO_PackedImageDesc(
+        &colors[range.first()].x,
+        range.size(),
+        1,
+        4,
+        sizeof(float),
+        4 * sizeof(float),
+        range.size() * 4 * sizeof(float));
+    OCIO_cpuProcessorApply(cpu_processor, img);
+    OCIO_PackedImageDescRelease(img);
+  });
+}
+
+/* Makes the given processor apply a 3D lookup table that approximates its CPU processor instead of
+ * the CPU processor itself, which is much faster for complex transforms like view transforms with
+ * looks. The approximation error is below the quantization error of bytes, see ColorLUT3D, so this
+ * should only be used if the result will be stored in bytes. The table is taken from the cache if
+ * it exists, otherwise, it is only baked if the given number of pixels to be transformed amortizes
+ * its cost. Since the result still differs slightly from the exact transform, tables are only used
+ * if enabled in the experimental preferences. */
+static void colormanage_processor_use_lut(ColormanageProcessor *cm_processor,
+                                          const int64_t pixels_count)
+{
+  using namespace blender;
+  using namespace blender::imbuf;
+  if (!USER_EXPERIMENTAL_TEST(&U, use_display_transform_lut)) {
+    return;
+  }
+
+  if (!cm_processor->cpu_processor || cm_processor->lut_key.empty() ||
+      OCIO_cpuProcessorIsNoOp(cm_processor->cpu_processor))
+  {
+    return;
+  }
+
+  const int resolution = ColorLUT3D::default_resolution;
+  const int64_t lattice_points_count = int64_t(resolution) * resolution * resolution;
+
+  std::lock_guard lock{lut_cache_mutex};
+  if (const std::shared_ptr<const ColorLUT3D> *lut = lut_cache().lookup_ptr(cm_processor->lut_key))
+  {
+    cm_processor->lut = *lut;
+    return;
+  }
+
+  if (pixels_count < lattice_points_count) {
+    return;
+  }
+
+  if (lut_cache().size() >= lut_cache_max_size) {
+    lut_cache().clear();
+  }
+
+  /* The table is baked while the lock is held such that it is only baked once, so isolate the
+   * multi-threaded baking to avoid picking up other tasks that might wait for the lock. */
+  OCIO_ConstCPUProcessorRcPtr *cpu_processor = cm_processor->cpu_processor;
+  threading::isolate_task([&]() {
+    cm_processor->lut = std::make_shared<const ColorLUT3D>(
+        resolution, ColorLUT3D::Shaper::Log, [&](MutableSpan<float4> colors) {
+          cpu_processor_apply_colors(cpu_processor, colors);
+        });
+  });
+  lut_cache().add_new(cm_processor->lut_key, cm_processor->lut);
+}
+
 static OCIO_ConstCPUProcessorRcPtr *colorspace_to_scene_linear_cpu_processor(
     ColorSpace *colorspace)
 {
@@ -1919,6 +2025,12 @@ static void colormanage_display_buffer_process_ex(
 
   if (skip_transform == false) {
     cm_processor = IMB_colormanagement_display_processor_new(view_settings, display_settings);
+
+    /* The approximation error of the lookup table is below the quantization error of bytes, so it
+     * is only used when no float display buffer is requested. */
+    if (display_buffer == nullptr) {
+      colormanage_processor_use_lut(cm_processor, int64_t(ibuf->x) * ibuf->y);
+    }
   }
 
   display_buffer_apply_threaded(ibuf,
@@ -2102,6 +2214,12 @@ static void colormanagement_transform_ex(uchar *byte_buffer,
     return;
   }
 
+  /* Byte buffers are transformed one pixel at a time, which is much faster using a lookup table,
+   * and their quantization error is above the approximation error of the table. */
+  if (float_buffer == nullptr) {
+    colormanage_processor_use_lut(cm_processor, int64_t(width) * height);
+  }
+
   processor_transform_apply_threaded(
       byte_buffer, float_buffer, width, height, channels, cm_processor, predivide, false);
   IMB_colormanagement_processor_free(cm_processor);
@@ -3882,7 +4000,7 @@ ColormanageProcessor *IMB_colormanagement_display_processor_new(
   const ColorManagedViewSettings *applied_view_settings;
   ColorSpace *display_space;
 
-  cm_processor = MEM_callocN<ColormanageProcessor>("colormanagement processor");
+  cm_processor = MEM_new<ColormanageProcessor>("colormanagement processor");
 
   if (view_settings) {
     applied_view_settings = view_settings;
@@ -3909,6 +4027,18 @@ ColormanageProcessor *IMB_colormanagement_display_processor_new(
       use_white_balance,
       global_role_scene_linear);
 
+  /* Floats are written in hexadecimal such that the key is exact. */
+  std::ostringstream lut_key;
+  lut_key << std::hexfloat << "display\n"
+          << applied_view_settings->look << '\n'
+          << applied_view_settings->view_transform << '\n'
+          << display_settings->display_device << '\n'
+          << global_role_scene_linear << '\n'
+          << applied_view_settings->exposure << ' ' << applied_view_settings->gamma << ' '
+          << applied_view_settings->temperature << ' ' << applied_view_settings->tint << ' '
+          << use_white_balance;
+  cm_processor->lut_key = lut_key.str();
+
   if (applied_view_settings->flag & COLORMANAGE_VIEW_USE_CURVES) {
     cm_processor->curve_mapping = BKE_curvemapping_copy(applied_view_settings->curve_mapping);
     BKE_curvemapping_premultiply(cm_processor->curve_mapping, false);
@@ -3922,8 +4052,9 @@ ColormanageProcessor *IMB_colormanagement_colorspace_processor_new(const char *f
 {
   ColormanageProcessor *cm_processor;
 
-  cm_processor = MEM_callocN<ColormanageProcessor>("colormanagement processor");
+  cm_processor = MEM_new<ColormanageProcessor>("colormanagement processor");
   cm_processor->is_data_result = IMB_colormanagement_space_name_is_data(to_colorspace);
+  cm_processor->lut_key = std::string("colorspace\n") + from_colorspace + '\n' + to_colorspace;
 
   OCIO_ConstProcessorRcPtr *processor = create_colorspace_transform_processor(from_colorspace,
                                                                               to_colorspace);
@@ -3966,7 +4097,10 @@ void IMB_colormanagement_processor_apply_v4(ColormanageProcessor *cm_processor,
     BKE_curvemapping_evaluate_premulRGBF(cm_processor->curve_mapping, pixel, pixel);
   }
 
-  if (cm_processor->cpu_processor) {
+  if (cm_processor->lut) {
+    cm_processor->lut->apply(pixel, 1, 4, false);
+  }
+  else if (cm_processor->cpu_processor) {
     OCIO_cpuProcessorApplyRGBA(cm_processor->cpu_processor, pixel);
   }
 }
@@ -3978,7 +4112,10 @@ void IMB_colormanagement_processor_apply_v4_predivide(ColormanageProcessor *cm_p
     BKE_curvemapping_evaluate_premulRGBF(cm_processor->curve_mapping, pixel, pixel);
   }
 
-  if (cm_processor->cpu_processor) {
+  if (cm_processor->lut) {
+    cm_processor->lut->apply(pixel, 1, 4, true);
+  }
+  else if (cm_processor->cpu_processor) {
     OCIO_cpuProcessorApplyRGBA_predivide(cm_processor->cpu_processor, pixel);
   }
 }
@@ -3989,7 +4126,10 @@ void IMB_colormanagement_processor_apply_v3(ColormanageProcessor *cm_processor,
     BKE_curvemapping_evaluate_premulRGBF(cm_processor->curve_mapping, pixel, pixel);
   }
 
-  if (cm_processor->cpu_processor) {
+  if (cm_processor->lut) {
+    cm_processor->lut->apply(pixel, 1, 3, false);
+  }
+  else if (cm_processor->cpu_processor) {
     OCIO_cpuProcessorApplyRGB(cm_processor->cpu_processor, pixel);
   }
 }
@@ -4035,7 +4175,10 @@ void IMB_colormanagement_processor_apply(ColormanageProcessor *cm_processor,
     }
   }
 
-  if (cm_processor->cpu_processor && channels >= 3) {
+  if (cm_processor->lut && channels >= 3) {
+    cm_processor->lut->apply(buffer, int64_t(width) * height, channels, predivide);
+  }
+  else if (cm_processor->cpu_processor && channels >= 3) {
     OCIO_PackedImageDesc *img;
 
     /* apply OCIO processor */
@@ -4085,7 +4228,7 @@ void IMB_colormanagement_processor_free(ColormanageProcessor *cm_processor)
     OCIO_cpuProcessorRelease(cm_processor->cpu_processor);
   }
 
-  MEM_freeN(cm_processor);
+  MEM_delete(cm_processor);
 }
 
 /* **** OpenGL drawing routines using GLSL for color space transform ***** */
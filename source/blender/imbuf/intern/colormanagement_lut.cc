@@ -0,0 +1,291 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup imbuf
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "BLI_assert.h"
+#include "BLI_math_bits.h"
+#include "BLI_math_base.h"
+#include "BLI_math_base.hh"
+#include "BLI_math_vector.h"
+#include "BLI_math_vector.hh"
+#include "BLI_simd.hh"
+#include "BLI_task.hh"
+
+#include "IMB_colormanagement_lut.hh"
+
+namespace blender::imbuf {
+
+ColorLUT3D::ColorLUT3D(const int resolution,
+                       const Shaper shaper,
+                       const FunctionRef<void(MutableSpan<float4>)> transform)
+    : resolution_(resolution),
+      shaper_(shaper),
+      table_(int64_t(resolution) * resolution * resolution)
+{
+  BLI_assert(resolution >= 2);
+
+  const float step = 1.0f / float(resolution - 1);
+  threading::parallel_for(IndexRange(resolution), 4, [&](const IndexRange b_range) {
+    for (const int b : b_range) {
+      for (int g = 0; g < resolution; g++) {
+        for (int r = 0; r < resolution; r++) {
+          const int64_t index = (int64_t(b) * resolution + g) * resolution + r;
+          table_[index] = float4(this->unshape(r * step),
+                                 this->unshape(g * step),
+                                 this->unshape(b * step),
+                                 1.0f);
+        }
+      }
+    }
+  });
+
+  transform(table_);
+}
+
+/* The logarithmic shaper uses a fast approximation of the base two logarithm, where the exponent
+ * of the float is used as is and the logarithm of the mantissa is approximated by a cubic
+ * polynomial. The polynomial matches the value and derivative of the logarithm at both ends of the
+ * mantissa range, so the approximation is smooth across powers of two, which is important for the
+ * accuracy of the interpolation. The input is offset by one such that zero maps to zero and the
+ * shaper is mostly linear below the knee. */
+static constexpr float log_coefficient_1 = float(M_LOG2E);
+static constexpr float log_coefficient_3 = 1.5f * float(M_LOG2E) - 2.0f;
+static constexpr float log_coefficient_2 = 1.0f - log_coefficient_1 - log_coefficient_3;
+
+static float fast_log2_mantissa(const float mantissa)
+{
+  return mantissa *
+         (log_coefficient_1 + mantissa * (log_coefficient_2 + mantissa * log_coefficient_3));
+}
+
+/* Approximates the base two logarithm of the given value, which should be at least one. */
+static float fast_log2(const float value)
+{
+  const int bits = float_as_int(value);
+  const float exponent = float((bits >> 23) - 127);
+  const float mantissa = int_as_float((bits & 0x7FFFFF) | 0x3F800000) - 1.0f;
+  return exponent + fast_log2_mantissa(mantissa);
+}
+
+/* The inverse of fast_log2. */
+static float fast_exp2(const float value)
+{
+  const float exponent = std::floor(value);
+  const float target = value - exponent;
+
+  /* The polynomial is monotonic, so solve for the mantissa using Newton's method starting from the
+   * linear approximation. */
+  float mantissa = target;
+  for (int i = 0; i < 8; i++) {
+    const float derivative = log_coefficient_1 + mantissa * (2.0f * log_coefficient_2 +
+                                                             3.0f * log_coefficient_3 * mantissa);
+    mantissa = math::clamp(mantissa - (fast_log2_mantissa(mantissa) - target) / derivative,
+                           0.0f,
+                           1.0f);
+  }
+
+  return std::ldexp(1.0f + mantissa, int(exponent));
+}
+
+static float log_shaper_scale()
+{
+  static const float scale = 1.0f / fast_log2(ColorLUT3D::log_shaper_max /
+                                                  ColorLUT3D::log_shaper_knee +
+                                              1.0f);
+  return scale;
+}
+
+float ColorLUT3D::shape(const float value) const
+{
+  /* Also maps NaN to zero. */
+  if (!(value > 0.0f)) {
+    return 0.0f;
+  }
+
+  switch (shaper_) {
+    case Shaper::Linear:
+      return math::min(value, 1.0f);
+    case Shaper::Log:
+      return fast_log2(math::min(value, log_shaper_max) / log_shaper_knee + 1.0f) *
+             log_shaper_scale();
+  }
+
+  BLI_assert_unreachable();
+  return 0.0f;
+}
+
+float ColorLUT3D::unshape(const float value) const
+{
+  switch (shaper_) {
+    case Shaper::Linear:
+      return value;
+    case Shaper::Log:
+      return (fast_exp2(value / log_shaper_scale()) - 1.0f) * log_shaper_knee;
+  }
+
+  BLI_assert_unreachable();
+  return value;
+}
+
+#if BLI_HAVE_SSE2
+/* Vectorized version of ColorLUT3D::shape for the logarithmic shaper. */
+static __m128 log_shape(const __m128 value, const __m128 scale)
+{
+  /* The maximum also maps NaN to zero, since the second operand is returned for NaN. */
+  const __m128 clamped = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()),
+                                    _mm_set1_ps(ColorLUT3D::log_shaper_max));
+  const __m128 offset_value = _mm_add_ps(
+      _mm_mul_ps(clamped, _mm_set1_ps(1.0f / ColorLUT3D::log_shaper_knee)), _mm_set1_ps(1.0f));
+
+  const __m128i bits = _mm_castps_si128(offset_value);
+  const __m128 exponent = _mm_cvtepi32_ps(
+      _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+  const __m128 mantissa = _mm_sub_ps(
+      _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x7FFFFF)),
+                                    _mm_set1_epi32(0x3F800000))),
+      _mm_set1_ps(1.0f));
+
+  __m128 polynomial = _mm_add_ps(_mm_set1_ps(log_coefficient_2),
+                                 _mm_mul_ps(mantissa, _mm_set1_ps(log_coefficient_3)));
+  polynomial = _mm_add_ps(_mm_set1_ps(log_coefficient_1), _mm_mul_ps(mantissa, polynomial));
+  polynomial = _mm_mul_ps(mantissa, polynomial);
+
+  return _mm_mul_ps(_mm_add_ps(exponent, polynomial), scale);
+}
+#endif
+
+float3 ColorLUT3D::evaluate(const float3 &color) const
+{
+  const int last_cell = resolution_ - 2;
+  const float scale = float(resolution_ - 1);
+
+  /* Find the lattice cell of the color and the position of the color inside of it. */
+  float3 position;
+#if BLI_HAVE_SSE2
+  if (shaper_ == Shaper::Log) {
+    float4 shaped;
+    _mm_storeu_ps(&shaped.x,
+                  log_shape(_mm_setr_ps(color.x, color.y, color.z, 0.0f),
+                            _mm_set1_ps(log_shaper_scale() * scale)));
+    position = shaped.xyz();
+  }
+  else
+#endif
+  {
+    for (int i = 0; i < 3; i++) {
+      position[i] = this->shape(color[i]) * scale;
+    }
+  }
+
+  int3 cell;
+  float3 fraction;
+  for (int i = 0; i < 3; i++) {
+    cell[i] = std::min(int(position[i]), last_cell);
+    fraction[i] = position[i] - float(cell[i]);
+  }
+
+  /* Tetrahedral interpolation splits the cell into six tetrahedra along its main diagonal, and the
+   * tetrahedron that contains the color is identified by the order of its fractions. The color is
+   * then a weighted sum of the corner at the origin of the cell, the opposite corner, and two
+   * corners that are reached by stepping along the axes in the order of decreasing fractions. */
+  const int64_t stride_r = 1;
+  const int64_t stride_g = resolution_;
+  const int64_t stride_b = int64_t(resolution_) * resolution_;
+  const int64_t origin = cell.x * stride_r + cell.y * stride_g + cell.z * stride_b;
+  const int64_t opposite = origin + stride_r + stride_g + stride_b;
+
+  float weights[3];
+  int64_t first_corner;
+  int64_t second_corner;
+  const auto set_tetrahedron = [&](const float3 &sorted_fractions,
+                                   const int64_t first_stride,
+                                   const int64_t second_stride) {
+    weights[0] = sorted_fractions.x;
+    weights[1] = sorted_fractions.y;
+    weights[2] = sorted_fractions.z;
+    first_corner = origin + first_stride;
+    second_corner = first_corner + second_stride;
+  };
+
+  const float3 &f = fraction;
+  if (f.x >= f.y) {
+    if (f.y >= f.z) {
+      set_tetrahedron(float3(f.x, f.y, f.z), stride_r, stride_g);
+    }
+    else if (f.x >= f.z) {
+      set_tetrahedron(float3(f.x, f.z, f.y), stride_r, stride_b);
+    }
+    else {
+      set_tetrahedron(float3(f.z, f.x, f.y), stride_b, stride_r);
+    }
+  }
+  else {
+    if (f.x >= f.z) {
+      set_tetrahedron(float3(f.y, f.x, f.z), stride_g, stride_r);
+    }
+    else if (f.y >= f.z) {
+      set_tetrahedron(float3(f.y, f.z, f.x), stride_g, stride_b);
+    }
+    else {
+      set_tetrahedron(float3(f.z, f.y, f.x), stride_b, stride_g);
+    }
+  }
+
+  const float4 *table = table_.data();
+#if BLI_HAVE_SSE2
+  __m128 result = _mm_mul_ps(_mm_loadu_ps(&table[origin].x), _mm_set1_ps(1.0f - weights[0]));
+  result = _mm_add_ps(result,
+                      _mm_mul_ps(_mm_loadu_ps(&table[first_corner].x),
+                                 _mm_set1_ps(weights[0] - weights[1])));
+  result = _mm_add_ps(result,
+                      _mm_mul_ps(_mm_loadu_ps(&table[second_corner].x),
+                                 _mm_set1_ps(weights[1] - weights[2])));
+  result = _mm_add_ps(result,
+                      _mm_mul_ps(_mm_loadu_ps(&table[opposite].x), _mm_set1_ps(weights[2])));
+
+  float4 color_result;
+  _mm_storeu_ps(&color_result.x, result);
+  return color_result.xyz();
+#else
+  const float4 result = table[origin] * (1.0f - weights[0]) +
+                        table[first_corner] * (weights[0] - weights[1]) +
+                        table[second_corner] * (weights[1] - weights[2]) +
+                        table[opposite] * weights[2];
+  return result.xyz();
+#endif
+}
+
+void ColorLUT3D::apply(float *buffer,
+                       const int64_t pixels_count,
+                       const int channels,
+                       const bool predivide) const
+{
+  BLI_assert(ELEM(channels, 3, 4));
+
+  for (int64_t i = 0; i < pixels_count; i++) {
+    float *pixel = buffer + i * channels;
+
+    if (predivide && channels == 4 && !ELEM(pixel[3], 0.0f, 1.0f)) {
+      const float alpha = pixel[3];
+      const float3 color = this->evaluate(float3(pixel) / alpha) * alpha;
+      copy_v3_v3(pixel, color);
+      continue;
+    }
+
+    copy_v3_v3(pixel, this->evaluate(float3(pixel)));
+  }
+}
+
+int64_t ColorLUT3D::size_in_bytes() const
+{
+  return table_.as_span().size_in_bytes();
+}
+
+}  // namespace blender::imbuf
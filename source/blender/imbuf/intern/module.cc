@@ -25,6 +25,7 @@ void IMB_exit()
 {
   imb_filetypes_exit();
   colormanagement_exit();
+  imb_free_pixel_pool();
   imb_mmap_lock_exit();
   imb_refcounter_lock_exit();
 }
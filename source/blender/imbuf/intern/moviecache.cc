@@ -8,15 +8,18 @@
 
 #undef DEBUG_MESSAGES
 
+#include <atomic>
 #include <cstdlib> /* for qsort */
 #include <memory.h>
 #include <mutex>
+#include <optional>
 
 #include "MEM_CacheLimiterC-Api.h"
 #include "MEM_guardedalloc.h"
 
 #include "BLI_ghash.h"
 #include "BLI_mempool.h"
+#include "BLI_set.hh"
 #include "BLI_string.h"
 
 #include "IMB_moviecache.hh"
@@ -34,36 +37,39 @@
 #  define PRINT(format, ...)
 #endif
 
-static MEM_CacheLimiterC *limitor = nullptr;
+struct MovieCache {
+  char name[64] = "";
 
-/* Image buffers managed by a moviecache might be using their own movie caches (used by color
- * management). In practice this means that, for example, freeing MovieCache used by MovieClip
- * will request freeing MovieCache owned by ImBuf. Freeing MovieCache needs to be thread-safe,
- * so regular mutex will not work here, hence the recursive lock. */
-static std::recursive_mutex limitor_lock;
+  GHash *hash = nullptr;
+  GHashHashFP hashfp = nullptr;
+  GHashCmpFP cmpfp = nullptr;
+  MovieCacheGetKeyDataFP getdatafp = nullptr;
 
-struct MovieCache {
-  char name[64];
+  MovieCacheGetPriorityDataFP getprioritydatafp = nullptr;
+  MovieCacheGetItemPriorityFP getitempriorityfp = nullptr;
+  MovieCachePriorityDeleterFP prioritydeleterfp = nullptr;
 
-  GHash *hash;
-  GHashHashFP hashfp;
-  GHashCmpFP cmpfp;
-  MovieCacheGetKeyDataFP getdatafp;
+  BLI_mempool *keys_pool = nullptr;
+  BLI_mempool *items_pool = nullptr;
+  BLI_mempool *userkeys_pool = nullptr;
 
-  MovieCacheGetPriorityDataFP getprioritydatafp;
-  MovieCacheGetItemPriorityFP getitempriorityfp;
-  MovieCachePriorityDeleterFP prioritydeleterfp;
+  int keysize = 0;
 
-  BLI_mempool *keys_pool;
-  BLI_mempool *items_pool;
-  BLI_mempool *userkeys_pool;
+  void *last_userkey = nullptr;
 
-  int keysize;
+  /* for visual statistics optimization */
+  int totseg = 0, *points = nullptr, proxy = -1, render_flags = 0;
 
-  void *last_userkey;
+  /* Usage statistics, see #MovieCacheStatistics. */
+  std::atomic<int64_t> hits = 0;
+  std::atomic<int64_t> misses = 0;
+  std::atomic<int64_t> evictions = 0;
+  std::atomic<int64_t> items_num = 0;
+  std::atomic<int64_t> memory_in_use = 0;
 
-  int totseg, *points, proxy, render_flags; /* for visual statistics optimization */
-  int pad;
+  /* The number of items whose image buffers were destroyed by the limiter since unused keys were
+   * last checked, such that the keys are only checked if needed. */
+  std::atomic<int64_t> destroyed_items_num = 0;
 };
 
 struct MovieCacheKey {
@@ -74,12 +80,367 @@ struct MovieCacheKey {
 struct MovieCacheItem {
   MovieCache *cache_owner;
   ImBuf *ibuf;
-  MEM_CacheLimiterHandleC *c_handle;
   void *priority_data;
   /* Indicates that #ibuf is null, because there was an error during load. */
   bool added_empty;
+
+  /* The members below are protected by the mutex of the limiter shard of the item. */
+
+  /* True if the item is in the least recently used list of its shard, that is, if it counts
+   * towards the memory limit and can be destroyed when enforcing it. */
+  bool is_managed;
+  int shard_index;
+  /* The size of the item the last time it was computed, which is when the item is put in the
+   * cache, used, or when enforcing the limit, since image buffers might grow or shrink after they
+   * were put in the cache, for instance by allocating their float or display buffers. */
+  size_t size;
+  /* True if the cache of the item had a priority callback when it was put in the cache. */
+  bool has_priority;
+  /* The value of the limiter clock when the item was last used. */
+  uint64_t last_used;
+  /* The neighbors of the item in the least recently used list of its shard. */
+  MovieCacheItem *lru_prev;
+  MovieCacheItem *lru_next;
+};
+
+/* The items of all caches are limited by the memory cache limit, where the least recently used or
+ * the least priority items are destroyed once the limit is exceeded. To avoid contention between
+ * threads that use different caches or different frames, like image sequences, movie clips and
+ * their color managed display buffers, items are distributed between shards based on their key,
+ * where each shard has its own lock and its own least recently used list. Only the memory in use
+ * and the clock that orders uses are shared between shards, which are atomic, so lookups only lock
+ * the shard of the item and inserts only lock other shards if the limit is exceeded.
+ *
+ * Image buffers managed by a moviecache might be using their own movie caches (used by color
+ * management), so freeing an image buffer might remove items from other shards. Hence, image
+ * buffers are only ever freed after the lock of the shard is released. */
+struct MovieCacheLimiterShard {
+  std::mutex mutex;
+  /* The items of the shard from the most to the least recently used. */
+  MovieCacheItem *lru_first = nullptr;
+  MovieCacheItem *lru_last = nullptr;
+  int64_t items_num = 0;
+  /* The number of items whose caches have a priority callback. If zero, eviction can simply pick
+   * the least recently used item instead of computing the priorities of all items. */
+  int64_t priority_items_num = 0;
+};
+
+static constexpr int MOVIECACHE_SHARDS_NUM = 16;
+static MovieCacheLimiterShard limiter_shards[MOVIECACHE_SHARDS_NUM];
+static std::atomic<int64_t> limiter_memory_in_use = 0;
+/* Incremented every time an item is used, to compare how recently items of different shards were
+ * used. */
+static std::atomic<uint64_t> limiter_clock = 0;
+
+/* All existing caches, used to gather statistics. */
+static std::mutex all_caches_mutex;
+static blender::Set<MovieCache *> &all_caches()
+{
+  static blender::Set<MovieCache *> caches;
+  return caches;
+}
+
+static size_t get_size_in_memory(ImBuf *ibuf)
+{
+  /* Keep textures in the memory to avoid constant file reload on viewport update. */
+  if (ibuf->userflags & IB_PERSISTENT) {
+    return 0;
+  }
+
+  return IMB_get_size_in_memory(ibuf);
+}
+static size_t get_item_size(MovieCacheItem *item)
+{
+  size_t size = sizeof(MovieCacheItem);
+
+  if (item->ibuf) {
+    size += get_size_in_memory(item->ibuf);
+  }
+
+  return size;
+}
+
+static bool get_item_destroyable(MovieCacheItem *item)
+{
+  if (item->ibuf == nullptr) {
+    return true;
+  }
+  /* IB_BITMAPDIRTY means image was modified from inside blender and
+   * changes are not saved to disk.
+   *
+   * Such buffers are never to be freed.
+   */
+  if ((item->ibuf->userflags & IB_BITMAPDIRTY) || (item->ibuf->userflags & IB_PERSISTENT)) {
+    return false;
+  }
+  return true;
+}
+
+/* Adds the item to the front of the least recently used list of the shard. The shard should be
+ * locked. */
+static void limiter_lru_link(MovieCacheLimiterShard &shard, MovieCacheItem *item)
+{
+  item->lru_prev = nullptr;
+  item->lru_next = shard.lru_first;
+  if (shard.lru_first) {
+    shard.lru_first->lru_prev = item;
+  }
+  else {
+    shard.lru_last = item;
+  }
+  shard.lru_first = item;
+}
+
+/* Removes the item from the least recently used list of the shard. The shard should be locked. */
+static void limiter_lru_unlink(MovieCacheLimiterShard &shard, MovieCacheItem *item)
+{
+  if (item->lru_prev) {
+    item->lru_prev->lru_next = item->lru_next;
+  }
+  else {
+    shard.lru_first = item->lru_next;
+  }
+  if (item->lru_next) {
+    item->lru_next->lru_prev = item->lru_prev;
+  }
+  else {
+    shard.lru_last = item->lru_prev;
+  }
+  item->lru_prev = nullptr;
+  item->lru_next = nullptr;
+}
+
+/* Starts limiting the memory of the item. The shard should be locked. */
+static void limiter_manage(MovieCacheLimiterShard &shard, MovieCacheItem *item)
+{
+  MovieCache *cache = item->cache_owner;
+
+  item->size = get_item_size(item);
+  item->is_managed = true;
+  item->last_used = limiter_clock++;
+  limiter_lru_link(shard, item);
+
+  shard.items_num++;
+  item->has_priority = cache->getitempriorityfp != nullptr;
+  if (item->has_priority) {
+    shard.priority_items_num++;
+  }
+
+  cache->items_num++;
+  cache->memory_in_use += int64_t(item->size);
+  limiter_memory_in_use += int64_t(item->size);
+}
+
+/* Recomputes the size of a managed item and updates the memory in use accordingly. The shard
+ * should be locked. */
+static void limiter_update_item_size(MovieCacheItem *item)
+{
+  if (!item->is_managed) {
+    return;
+  }
+
+  const size_t size = get_item_size(item);
+  if (size == item->size) {
+    return;
+  }
+
+  const int64_t delta = int64_t(size) - int64_t(item->size);
+  item->size = size;
+  item->cache_owner->memory_in_use += delta;
+  limiter_memory_in_use += delta;
+}
+
+/* Recomputes the sizes of all managed items, such that the limit is enforced based on the current
+ * memory usage of the items. This locks and visits every item, so it is only done when the memory
+ * in use is close to the limit, see #limiter_enforce_limits. Far below the limit, sizes are still
+ * kept up to date as items are used, which covers buffers that are allocated on access. */
+static void limiter_update_item_sizes()
+{
+  for (MovieCacheLimiterShard &shard : limiter_shards) {
+    std::lock_guard lock{shard.mutex};
+    for (MovieCacheItem *item = shard.lru_first; item; item = item->lru_next) {
+      limiter_update_item_size(item);
+    }
+  }
+}
+
+/* Stops limiting the memory of the item if it is managed. The shard should be locked. */
+static void limiter_unmanage(MovieCacheLimiterShard &shard, MovieCacheItem *item)
+{
+  if (!item->is_managed) {
+    return;
+  }
+
+  MovieCache *cache = item->cache_owner;
+
+  item->is_managed = false;
+  limiter_lru_unlink(shard, item);
+
+  shard.items_num--;
+  if (item->has_priority) {
+    shard.priority_items_num--;
+  }
+
+  cache->items_num--;
+  cache->memory_in_use -= int64_t(item->size);
+  limiter_memory_in_use -= int64_t(item->size);
+}
+
+/* The priority of an item when enforcing the limit, where items with lower priorities are
+ * destroyed first. Items are ordered by the priority returned by the priority callback of their
+ * cache, which is zero for caches without a callback, then by how recently they were used. */
+struct MovieCacheItemPriority {
+  int priority = 0;
+  uint64_t last_used = 0;
+
+  bool operator<(const MovieCacheItemPriority &other) const
+  {
+    return priority < other.priority ||
+           (priority == other.priority && last_used < other.last_used);
+  }
 };
 
+static MovieCacheItemPriority get_item_priority(MovieCacheItem *item)
+{
+  MovieCache *cache = item->cache_owner;
+  int priority = 0;
+  if (item->has_priority) {
+    priority = cache->getitempriorityfp(cache->last_userkey, item->priority_data);
+  }
+
+  PRINT("%s: cache '%s' item %p priority %d\n", __func__, cache->name, item, priority);
+
+  return {priority, item->last_used};
+}
+
+/* Returns the item of the shard that should be destroyed first when enforcing the limit, or null
+ * if no item can be destroyed, in which case r_priority is not set. The given item is never
+ * returned. The shard should be locked. */
+static MovieCacheItem *limiter_get_least_priority_item(MovieCacheLimiterShard &shard,
+                                                       const MovieCacheItem *protected_item,
+                                                       MovieCacheItemPriority &r_priority)
+{
+  /* Without priority callbacks, the least recently used item has the least priority. */
+  if (shard.priority_items_num == 0) {
+    for (MovieCacheItem *item = shard.lru_last; item; item = item->lru_prev) {
+      if (item != protected_item && get_item_destroyable(item)) {
+        r_priority = get_item_priority(item);
+        return item;
+      }
+    }
+    return nullptr;
+  }
+
+  MovieCacheItem *best_match_item = nullptr;
+  for (MovieCacheItem *item = shard.lru_first; item; item = item->lru_next) {
+    if (item == protected_item || !get_item_destroyable(item)) {
+      continue;
+    }
+
+    const MovieCacheItemPriority priority = get_item_priority(item);
+    if (best_match_item == nullptr || priority < r_priority) {
+      r_priority = priority;
+      best_match_item = item;
+    }
+  }
+
+  return best_match_item;
+}
+
+/* The fraction of the memory cache limit above which the sizes of all items are recomputed before
+ * enforcing the limit. Items mostly grow after they are put in the cache by allocating display or
+ * float buffers, so a margin of a quarter of the limit avoids walking all items on every put while
+ * still catching such growth before the limit is exceeded by much. */
+static constexpr int64_t LIMITER_UPDATE_SIZES_THRESHOLD_DIVISOR = 4;
+
+/* Destroys items until the memory in use is below the memory cache limit, except for the given
+ * item, which was just added. */
+static void limiter_enforce_limits(const MovieCacheItem *protected_item)
+{
+  if (MEM_CacheLimiter_is_disabled()) {
+    return;
+  }
+
+  const int64_t max = int64_t(MEM_CacheLimiter_get_maximum());
+  if (max == 0) {
+    return;
+  }
+
+  if (limiter_memory_in_use > max - max / LIMITER_UPDATE_SIZES_THRESHOLD_DIVISOR) {
+    limiter_update_item_sizes();
+  }
+
+  if (limiter_memory_in_use <= max) {
+    return;
+  }
+
+  /* The least priority item of every shard, which is computed once for all shards and then only
+   * recomputed for the shard that an item was destroyed from, such that destroying many items does
+   * not scan all shards for every item. Shards are only locked one at a time, so the candidate of
+   * a shard might be used or removed by the time its shard is locked again, in which case the
+   * least priority item of that shard is destroyed instead. This is fine, since the limit would
+   * just as well be enforced by any other order. */
+  std::optional<MovieCacheItemPriority> shard_candidates[MOVIECACHE_SHARDS_NUM];
+  for (int i = 0; i < MOVIECACHE_SHARDS_NUM; i++) {
+    MovieCacheLimiterShard &shard = limiter_shards[i];
+    std::lock_guard lock{shard.mutex};
+    MovieCacheItemPriority priority;
+    if (limiter_get_least_priority_item(shard, protected_item, priority)) {
+      shard_candidates[i] = priority;
+    }
+  }
+
+  while (limiter_memory_in_use > max) {
+    int best_match_shard = -1;
+    for (int i = 0; i < MOVIECACHE_SHARDS_NUM; i++) {
+      if (shard_candidates[i] &&
+          (best_match_shard == -1 || *shard_candidates[i] < *shard_candidates[best_match_shard]))
+      {
+        best_match_shard = i;
+      }
+    }
+
+    if (best_match_shard == -1) {
+      break;
+    }
+
+    ImBuf *ibuf;
+    {
+      MovieCacheLimiterShard &shard = limiter_shards[best_match_shard];
+      std::lock_guard lock{shard.mutex};
+      MovieCacheItemPriority priority;
+      MovieCacheItem *item = limiter_get_least_priority_item(shard, protected_item, priority);
+      if (!item) {
+        shard_candidates[best_match_shard].reset();
+        continue;
+      }
+
+      MovieCache *cache = item->cache_owner;
+      PRINT("%s: cache '%s' destroy item %p buffer %p\n", __func__, cache->name, item, item->ibuf);
+
+      limiter_unmanage(shard, item);
+      ibuf = item->ibuf;
+      item->ibuf = nullptr;
+      cache->evictions++;
+      cache->destroyed_items_num++;
+
+      /* force cached segments to be updated */
+      MEM_SAFE_FREE(cache->points);
+
+      if (limiter_get_least_priority_item(shard, protected_item, priority)) {
+        shard_candidates[best_match_shard] = priority;
+      }
+      else {
+        shard_candidates[best_match_shard].reset();
+      }
+    }
+
+    if (ibuf) {
+      IMB_freeImBuf(ibuf);
+    }
+  }
+}
+
 static uint moviecache_hashhash(const void *keyv)
 {
   const MovieCacheKey *key = (const MovieCacheKey *)keyv;
@@ -111,14 +472,18 @@ static void moviecache_valfree(void *val)
 
   PRINT("%s: cache '%s' free item %p buffer %p\n", __func__, cache->name, item, item->ibuf);
 
-  if (item->c_handle) {
-    limitor_lock.lock();
-    MEM_CacheLimiter_unmanage(item->c_handle);
-    limitor_lock.unlock();
+  /* The image buffer might be destroyed concurrently by the limiter, so take it under the lock. */
+  ImBuf *ibuf;
+  {
+    MovieCacheLimiterShard &shard = limiter_shards[item->shard_index];
+    std::lock_guard lock{shard.mutex};
+    limiter_unmanage(shard, item);
+    ibuf = item->ibuf;
+    item->ibuf = nullptr;
   }
 
-  if (item->ibuf) {
-    IMB_freeImBuf(item->ibuf);
+  if (ibuf) {
+    IMB_freeImBuf(ibuf);
   }
 
   if (item->priority_data && cache->prioritydeleterfp) {
@@ -132,6 +497,10 @@ static void check_unused_keys(MovieCache *cache)
 {
   GHashIterator gh_iter;
 
+  if (cache->destroyed_items_num.exchange(0) == 0) {
+    return;
+  }
+
   BLI_ghashIterator_init(&gh_iter, cache->hash);
 
   while (!BLI_ghashIterator_done(&gh_iter)) {
@@ -146,7 +515,11 @@ static void check_unused_keys(MovieCache *cache)
       continue;
     }
 
-    bool remove = !item->ibuf;
+    bool remove;
+    {
+      std::lock_guard lock{limiter_shards[item->shard_index].mutex};
+      remove = !item->ibuf;
+    }
 
     if (remove) {
       PRINT("%s: cache '%s' remove item %p without buffer\n", __func__, cache->name, item);
@@ -165,100 +538,15 @@ static int compare_int(const void *av, const void *bv)
   return *a - *b;
 }
 
-static void moviecache_destructor(void *p)
-{
-  MovieCacheItem *item = (MovieCacheItem *)p;
-
-  if (item && item->ibuf) {
-    MovieCache *cache = item->cache_owner;
-
-    PRINT("%s: cache '%s' destroy item %p buffer %p\n", __func__, cache->name, item, item->ibuf);
-
-    IMB_freeImBuf(item->ibuf);
-
-    item->ibuf = nullptr;
-    item->c_handle = nullptr;
-
-    /* force cached segments to be updated */
-    MEM_SAFE_FREE(cache->points);
-  }
-}
-
-static size_t get_size_in_memory(ImBuf *ibuf)
-{
-  /* Keep textures in the memory to avoid constant file reload on viewport update. */
-  if (ibuf->userflags & IB_PERSISTENT) {
-    return 0;
-  }
-
-  return IMB_get_size_in_memory(ibuf);
-}
-static size_t get_item_size(void *p)
-{
-  size_t size = sizeof(MovieCacheItem);
-  MovieCacheItem *item = (MovieCacheItem *)p;
-
-  if (item->ibuf) {
-    size += get_size_in_memory(item->ibuf);
-  }
-
-  return size;
-}
-
-static int get_item_priority(void *item_v, int default_priority)
-{
-  MovieCacheItem *item = (MovieCacheItem *)item_v;
-  MovieCache *cache = item->cache_owner;
-  int priority;
-
-  if (!cache->getitempriorityfp) {
-    PRINT("%s: cache '%s' item %p use default priority %d\n",
-          __func__,
-          cache->name,
-          item,
-          default_priority);
-
-    return default_priority;
-  }
-
-  priority = cache->getitempriorityfp(cache->last_userkey, item->priority_data);
-
-  PRINT("%s: cache '%s' item %p priority %d\n", __func__, cache->name, item, priority);
-
-  return priority;
-}
-
-static bool get_item_destroyable(void *item_v)
-{
-  MovieCacheItem *item = (MovieCacheItem *)item_v;
-  if (item->ibuf == nullptr) {
-    return true;
-  }
-  /* IB_BITMAPDIRTY means image was modified from inside blender and
-   * changes are not saved to disk.
-   *
-   * Such buffers are never to be freed.
-   */
-  if ((item->ibuf->userflags & IB_BITMAPDIRTY) || (item->ibuf->userflags & IB_PERSISTENT)) {
-    return false;
-  }
-  return true;
-}
-
 void IMB_moviecache_init()
 {
-  limitor = new_MEM_CacheLimiter(moviecache_destructor, get_item_size);
-
-  MEM_CacheLimiter_ItemPriority_Func_set(limitor, get_item_priority);
-  MEM_CacheLimiter_ItemDestroyable_Func_set(limitor, get_item_destroyable);
+  /* The limiter is statically allocated, so there is nothing to initialize here. */
 }
 
 void IMB_moviecache_destruct()
 {
-  if (limitor) {
-    delete_MEM_CacheLimiter(limitor);
-    limitor = nullptr;
-  }
+  /* The limiter is statically allocated and items are removed from it when their caches are
+   * freed, so there is nothing to free here. */
 }
 
 MovieCache *IMB_moviecache_create(const char *name,
@@ -270,7 +558,7 @@ MovieCache *IMB_moviecache_create(const char *name,
 
   PRINT("%s: cache '%s' create\n", __func__, name);
 
-  cache = MEM_callocN<MovieCache>("MovieCache");
+  cache = MEM_new<MovieCache>("MovieCache");
 
   STRNCPY(cache->name, name);
 
@@ -283,7 +571,11 @@ MovieCache *IMB_moviecache_create(const char *name,
   cache->keysize = keysize;
   cache->hashfp = hashfp;
   cache->cmpfp = cmpfp;
-  cache->proxy = -1;
+
+  {
+    std::lock_guard lock{all_caches_mutex};
+    all_caches().add_new(cache);
+  }
 
   return cache;
 }
@@ -305,15 +597,11 @@ void IMB_moviecache_set_priority_callback(MovieCache *cache,
   cache->prioritydeleterfp = prioritydeleterfp;
 }
 
-static void do_moviecache_put(MovieCache *cache, void *userkey, ImBuf *ibuf, bool need_lock)
+static void do_moviecache_put(MovieCache *cache, void *userkey, ImBuf *ibuf)
 {
   MovieCacheKey *key;
   MovieCacheItem *item;
 
-  if (!limitor) {
-    IMB_moviecache_init();
-  }
-
   if (ibuf != nullptr) {
     IMB_refImBuf(ibuf);
   }
@@ -329,9 +617,15 @@ static void do_moviecache_put(MovieCache *cache, void *userkey, ImBuf *ibuf, boo
 
   item->ibuf = ibuf;
   item->cache_owner = cache;
-  item->c_handle = nullptr;
   item->priority_data = nullptr;
   item->added_empty = ibuf == nullptr;
+  item->is_managed = false;
+  item->shard_index = moviecache_hashhash(key) % MOVIECACHE_SHARDS_NUM;
+  item->size = 0;
+  item->has_priority = false;
+  item->last_used = 0;
+  item->lru_prev = nullptr;
+  item->lru_next = nullptr;
 
   if (cache->getprioritydatafp) {
     item->priority_data = cache->getprioritydatafp(userkey);
@@ -343,19 +637,13 @@ static void do_moviecache_put(MovieCache *cache, void *userkey, ImBuf *ibuf, boo
     memcpy(cache->last_userkey, userkey, cache->keysize);
   }
 
-  if (need_lock) {
-    limitor_lock.lock();
+  {
+    MovieCacheLimiterShard &shard = limiter_shards[item->shard_index];
+    std::lock_guard lock{shard.mutex};
+    limiter_manage(shard, item);
   }
 
-  item->c_handle = MEM_CacheLimiter_insert(limitor, item);
-
-  MEM_CacheLimiter_ref(item->c_handle);
-  MEM_CacheLimiter_enforce_limits(limitor);
-  MEM_CacheLimiter_unref(item->c_handle);
-
-  if (need_lock) {
-    limitor_lock.unlock();
-  }
+  limiter_enforce_limits(item);
 
   /* cache limiter can't remove unused keys which points to destroyed values */
   check_unused_keys(cache);
@@ -365,28 +653,22 @@ static void do_moviecache_put(MovieCache *cache, void *userkey, ImBuf *ibuf, boo
 
 void IMB_moviecache_put(MovieCache *cache, void *userkey, ImBuf *ibuf)
 {
-  do_moviecache_put(cache, userkey, ibuf, true);
+  do_moviecache_put(cache, userkey, ibuf);
 }
 
 bool IMB_moviecache_put_if_possible(MovieCache *cache, void *userkey, ImBuf *ibuf)
 {
-  size_t mem_in_use, mem_limit, elem_size;
-  bool result = false;
-
-  elem_size = (ibuf == nullptr) ? 0 : get_size_in_memory(ibuf);
-  mem_limit = MEM_CacheLimiter_get_maximum();
+  const size_t elem_size = (ibuf == nullptr) ? 0 : get_size_in_memory(ibuf);
+  const size_t mem_limit = MEM_CacheLimiter_get_maximum();
 
-  limitor_lock.lock();
-  mem_in_use = MEM_CacheLimiter_get_memory_in_use(limitor);
-
-  if (mem_in_use + elem_size <= mem_limit) {
-    do_moviecache_put(cache, userkey, ibuf, false);
-    result = true;
+  /* Concurrent puts might still exceed the limit, in which case the least priority items are
+   * destroyed like for regular puts. */
+  if (size_t(limiter_memory_in_use) + elem_size > mem_limit) {
+    return false;
   }
 
-  limitor_lock.unlock();
-
-  return result;
+  do_moviecache_put(cache, userkey, ibuf);
+  return true;
 }
 
 void IMB_moviecache_remove(MovieCache *cache, void *userkey)
@@ -411,20 +693,38 @@ ImBuf *IMB_moviecache_get(MovieCache *cache, void *userkey, bool *r_is_cached_em
   }
 
   if (item) {
-    if (item->ibuf) {
-      limitor_lock.lock();
-      MEM_CacheLimiter_touch(item->c_handle);
-      limitor_lock.unlock();
-
-      IMB_refImBuf(item->ibuf);
+    /* Reference the image buffer under the lock, such that it isn't destroyed by the limiter
+     * before it is returned. */
+    ImBuf *ibuf;
+    {
+      MovieCacheLimiterShard &shard = limiter_shards[item->shard_index];
+      std::lock_guard lock{shard.mutex};
+      ibuf = item->ibuf;
+      if (ibuf) {
+        if (item->is_managed) {
+          limiter_update_item_size(item);
+          item->last_used = limiter_clock++;
+          limiter_lru_unlink(shard, item);
+          limiter_lru_link(shard, item);
+        }
+        IMB_refImBuf(ibuf);
+      }
+    }
 
-      return item->ibuf;
+    if (ibuf) {
+      cache->hits++;
+      return ibuf;
     }
-    if (r_is_cached_empty && item->added_empty) {
-      *r_is_cached_empty = true;
+    if (item->added_empty) {
+      cache->hits++;
+      if (r_is_cached_empty) {
+        *r_is_cached_empty = true;
+      }
+      return nullptr;
     }
   }
 
+  cache->misses++;
   return nullptr;
 }
 
@@ -444,6 +744,11 @@ void IMB_moviecache_free(MovieCache *cache)
 {
   PRINT("%s: cache '%s' free\n", __func__, cache->name);
 
+  {
+    std::lock_guard lock{all_caches_mutex};
+    all_caches().remove(cache);
+  }
+
   BLI_ghash_free(cache->hash, moviecache_keyfree, moviecache_valfree);
 
   BLI_mempool_destroy(cache->keys_pool);
@@ -458,7 +763,7 @@ void IMB_moviecache_free(MovieCache *cache)
     MEM_freeN(cache->last_userkey);
   }
 
-  MEM_freeN(cache);
+  MEM_delete(cache);
 }
 
 void IMB_moviecache_cleanup(MovieCache *cache,
@@ -571,6 +876,28 @@ void IMB_moviecache_get_cache_segments(
   }
 }
 
+blender::Map<std::string, MovieCacheStatistics> IMB_moviecache_get_statistics()
+{
+  blender::Map<std::string, MovieCacheStatistics> statistics;
+
+  std::lock_guard lock{all_caches_mutex};
+  for (const MovieCache *cache : all_caches()) {
+    MovieCacheStatistics &cache_statistics = statistics.lookup_or_add_default(cache->name);
+    cache_statistics.hits += cache->hits;
+    cache_statistics.misses += cache->misses;
+    cache_statistics.evictions += cache->evictions;
+    cache_statistics.items_num += cache->items_num;
+    cache_statistics.memory_in_use += cache->memory_in_use;
+  }
+
+  return statistics;
+}
+
+int64_t IMB_moviecache_get_memory_in_use()
+{
+  return limiter_memory_in_use;
+}
+
 MovieCacheIter *IMB_moviecacheIter_new(MovieCache *cache)
 {
   GHashIterator *iter;
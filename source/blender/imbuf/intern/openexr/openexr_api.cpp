@@ -15,8 +15,11 @@
 #include <fcntl.h>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 /* The OpenEXR version can reliably be found in this header file from OpenEXR,
  * for both 2.x and 3.x:
@@ -81,6 +84,7 @@
 #include "BLI_mmap.h"
 #include "BLI_path_utils.hh"
 #include "BLI_string.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
 
 #include "BKE_idprop.hh"
@@ -723,6 +727,7 @@ struct ExrChannel {
   char chan_id;                   /* quick lookup of channel char */
   int view_id;                    /* quick lookup of channel view */
   bool use_half_float;            /* when saving use half float for file storage */
+  int compress;                   /* when saving, -1 to use the compression of the file */
 };
 
 /* hierarchical; layers -> passes -> channels[] */
@@ -853,7 +858,8 @@ void IMB_exr_add_channel(void *handle,
                          int xstride,
                          int ystride,
                          float *rect,
-                         bool use_half_float)
+                         bool use_half_float,
+                         int compress)
 {
   ExrHandle *data = (ExrHandle *)handle;
   ExrChannel *echan;
@@ -893,6 +899,7 @@ void IMB_exr_add_channel(void *handle,
   echan->ystride = ystride;
   echan->rect = rect;
   echan->use_half_float = use_half_float;
+  echan->compress = compress;
 
   if (echan->use_half_float) {
     data->num_half_channels++;
@@ -902,6 +909,82 @@ void IMB_exr_add_channel(void *handle,
   BLI_addtail(&data->channels, echan);
 }
 
+/* Get the name of the pass of the given channel, which is its name without the channel ID. */
+static std::string imb_exr_channel_pass_name(const ExrChannel *echan)
+{
+  const size_t separator = echan->m->name.rfind('.');
+  if (separator == std::string::npos) {
+    return std::string();
+  }
+  return echan->m->name.substr(0, separator);
+}
+
+static int imb_exr_channel_compression(const ExrChannel *echan, const int compress)
+{
+  return echan->compress == -1 ? compress : echan->compress;
+}
+
+/* The compression is a property of the parts of a file, so channels that use different
+ * compressions need to be written to different parts. Channels without a pass can't be stored in
+ * a part of their own, so they can't use a different compression than the file. */
+static bool imb_exr_use_part_per_pass(ExrHandle *data, const int compress)
+{
+  bool has_different_compression = false;
+  LISTBASE_FOREACH (ExrChannel *, echan, &data->channels) {
+    if (imb_exr_channel_pass_name(echan).empty()) {
+      return false;
+    }
+    if (imb_exr_channel_compression(echan, compress) != compress) {
+      has_different_compression = true;
+    }
+  }
+  return has_different_compression;
+}
+
+/**
+ * Add a header derived from the given one for each pass and view, and assign the channels to
+ * them. The compression of a part is the one of the first channel of its pass. Parts are named
+ * after their pass, with the view appended in multi-view files to keep the names unique, and store
+ * the channels by their ID, such that readers get the full channel names back by prepending the
+ * name of the part, see #exr_channels_in_multi_part_file.
+ */
+static void imb_exr_headers_per_pass(ExrHandle *data,
+                                     const Header &header,
+                                     const int compress,
+                                     const int quality,
+                                     std::vector<Header> &headers)
+{
+  std::map<std::string, int> part_by_name;
+
+  LISTBASE_FOREACH (ExrChannel *, echan, &data->channels) {
+    const std::string pass_name = imb_exr_channel_pass_name(echan);
+    const std::string &view = echan->m->view;
+    const std::string part_name = view.empty() ? pass_name : pass_name + "." + view;
+
+    const auto [part, is_new_part] = part_by_name.emplace(part_name, int(headers.size()));
+    if (is_new_part) {
+      headers.push_back(header);
+      headers.back().setName(part_name);
+      if (!view.empty()) {
+        headers.back().setView(view);
+      }
+      openexr_header_compression(
+          &headers.back(), imb_exr_channel_compression(echan, compress), quality);
+    }
+
+    echan->m->part_number = part->second;
+    echan->m->internal_name = echan->m->name.substr(pass_name.size() + 1);
+    headers[part->second].channels().insert(
+        echan->m->internal_name, Channel(echan->use_half_float ? Imf::HALF : Imf::FLOAT));
+
+    exr_printf("%d %-6s %-22s \"%s\"\n",
+               echan->m->part_number,
+               echan->m->view.c_str(),
+               echan->m->name.c_str(),
+               echan->m->internal_name.c_str());
+  }
+}
+
 bool IMB_exr_begin_write(void *handle,
                          const char *filepath,
                          int width,
@@ -912,62 +995,89 @@ bool IMB_exr_begin_write(void *handle,
 {
   ExrHandle *data = (ExrHandle *)handle;
   Header header(width, height);
+  std::vector<Header> headers;
 
   data->width = width;
   data->height = height;
 
-  bool is_singlelayer, is_multilayer, is_multiview;
-
-  LISTBASE_FOREACH (ExrChannel *, echan, &data->channels) {
-    header.channels().insert(echan->name, Channel(echan->use_half_float ? Imf::HALF : Imf::FLOAT));
-  }
-
   openexr_header_compression(&header, compress, quality);
   BKE_stamp_info_callback(
       &header, const_cast<StampData *>(stamp), openexr_header_metadata_callback, false);
   /* header.lineOrder() = DECREASING_Y; this crashes in windows for file read! */
 
-  imb_exr_type_by_channels(
-      header.channels(), *data->multiView, &is_singlelayer, &is_multilayer, &is_multiview);
-
-  if (is_multilayer) {
+  if (imb_exr_use_part_per_pass(data, compress)) {
     header.insert("BlenderMultiChannel", StringAttribute("Blender V2.55.1 and newer"));
+    header.setType(SCANLINEIMAGE);
+    imb_exr_headers_per_pass(data, header, compress, quality, headers);
   }
+  else {
+    bool is_singlelayer, is_multilayer, is_multiview;
 
-  if (is_multiview) {
-    addMultiView(header, *data->multiView);
+    LISTBASE_FOREACH (ExrChannel *, echan, &data->channels) {
+      header.channels().insert(echan->name,
+                               Channel(echan->use_half_float ? Imf::HALF : Imf::FLOAT));
+    }
+
+    imb_exr_type_by_channels(
+        header.channels(), *data->multiView, &is_singlelayer, &is_multilayer, &is_multiview);
+
+    if (is_multilayer) {
+      header.insert("BlenderMultiChannel", StringAttribute("Blender V2.55.1 and newer"));
+    }
+
+    if (is_multiview) {
+      addMultiView(header, *data->multiView);
+    }
   }
 
   /* avoid crash/abort when we don't have permission to write here */
   /* manually create ofstream, so we can handle utf-8 filepaths on windows */
   try {
     data->ofile_stream = new OFileStream(filepath);
-    data->ofile = new OutputFile(*(data->ofile_stream), header);
+    if (headers.empty()) {
+      data->ofile = new OutputFile(*(data->ofile_stream), header);
+    }
+    else {
+      data->mpofile = new MultiPartOutputFile(
+          *(data->ofile_stream), headers.data(), headers.size());
+    }
   }
   catch (const std::exception &exc) {
     std::cerr << "IMB_exr_begin_write: ERROR: " << exc.what() << std::endl;
 
     delete data->ofile;
+    delete data->mpofile;
     delete data->ofile_stream;
 
     data->ofile = nullptr;
+    data->mpofile = nullptr;
     data->ofile_stream = nullptr;
   }
   catch (...) { /* Catch-all for edge cases or compiler bugs. */
     std::cerr << "IMB_exr_begin_write: UNKNOWN ERROR" << std::endl;
 
     delete data->ofile;
+    delete data->mpofile;
     delete data->ofile_stream;
 
     data->ofile = nullptr;
+    data->mpofile = nullptr;
     data->ofile_stream = nullptr;
   }
 
-  return (data->ofile != nullptr);
+  return (data->ofile != nullptr || data->mpofile != nullptr);
 }
 
-void IMB_exrtile_begin_write(
-    void *handle, const char *filepath, int mipmap, int width, int height, int tilex, int tiley)
+bool IMB_exrtile_begin_write(void *handle,
+                             const char *filepath,
+                             int mipmap,
+                             int width,
+                             int height,
+                             int tilex,
+                             int tiley,
+                             int compress,
+                             int quality,
+                             const StampData *stamp)
 {
   ExrHandle *data = (ExrHandle *)handle;
   Header header(width, height);
@@ -980,39 +1090,68 @@ void IMB_exrtile_begin_write(
   data->mipmap = mipmap;
 
   header.setTileDescription(TileDescription(tilex, tiley, (mipmap) ? MIPMAP_LEVELS : ONE_LEVEL));
-  header.compression() = RLE_COMPRESSION;
+  openexr_header_compression(&header, compress, quality);
+  BKE_stamp_info_callback(
+      &header, const_cast<StampData *>(stamp), openexr_header_metadata_callback, false);
   header.setType(TILEDIMAGE);
 
-  header.insert("BlenderMultiChannel", StringAttribute("Blender V2.43"));
+  exr_printf("\nIMB_exrtile_begin_write\n");
+  exr_printf("%s %-6s %-22s \"%s\"\n", "p", "view", "name", "internal_name");
+  exr_printf("---------------------------------------------------------------\n");
 
-  int numparts = data->multiView->size();
+  /* Files whose passes use different compressions store each pass in its own part. Otherwise,
+   * files with multiple views store each view in its own part, while files with a single view are
+   * written as a regular single part file. */
+  const bool use_part_per_pass = imb_exr_use_part_per_pass(data, compress);
+  const int numparts = std::max(int(data->multiView->size()), 1);
 
-  /* copy header from all parts of input to our header array
-   * those temporary files have one part per view */
-  for (int i = 0; i < numparts; i++) {
-    headers.push_back(header);
-    headers[headers.size() - 1].setView((*(data->multiView))[i]);
-    headers[headers.size() - 1].setName((*(data->multiView))[i]);
+  if (use_part_per_pass) {
+    header.insert("BlenderMultiChannel", StringAttribute("Blender V2.55.1 and newer"));
+    imb_exr_headers_per_pass(data, header, compress, quality, headers);
   }
+  else if (numparts == 1) {
+    LISTBASE_FOREACH (ExrChannel *, echan, &data->channels) {
+      header.channels().insert(echan->name,
+                               Channel(echan->use_half_float ? Imf::HALF : Imf::FLOAT));
+    }
 
-  exr_printf("\nIMB_exrtile_begin_write\n");
-  exr_printf("%s %-6s %-22s \"%s\"\n", "p", "view", "name", "internal_name");
-  exr_printf("---------------------------------------------------------------\n");
+    bool is_singlelayer, is_multilayer, is_multiview;
+    imb_exr_type_by_channels(
+        header.channels(), *data->multiView, &is_singlelayer, &is_multilayer, &is_multiview);
+    if (is_multilayer) {
+      header.insert("BlenderMultiChannel", StringAttribute("Blender V2.55.1 and newer"));
+    }
 
-  /* Assign channels. */
-  LISTBASE_FOREACH (ExrChannel *, echan, &data->channels) {
-    /* Tiles are expected to be saved with full float currently. */
-    BLI_assert(echan->use_half_float == 0);
+    headers.push_back(header);
+  }
+  else {
+    header.insert("BlenderMultiChannel", StringAttribute("Blender V2.43"));
 
-    echan->m->internal_name = echan->m->name;
-    echan->m->part_number = echan->view_id;
+    /* copy header from all parts of input to our header array
+     * those temporary files have one part per view */
+    for (int i = 0; i < numparts; i++) {
+      headers.push_back(header);
+      headers[headers.size() - 1].setView((*(data->multiView))[i]);
+      headers[headers.size() - 1].setName((*(data->multiView))[i]);
+    }
+  }
 
-    headers[echan->view_id].channels().insert(echan->m->internal_name, Channel(Imf::FLOAT));
-    exr_printf("%d %-6s %-22s \"%s\"\n",
-               echan->m->part_number,
-               echan->m->view.c_str(),
-               echan->m->name.c_str(),
-               echan->m->internal_name.c_str());
+  /* Assign channels, which is done while creating the headers of files with a part per pass. */
+  if (!use_part_per_pass) {
+    LISTBASE_FOREACH (ExrChannel *, echan, &data->channels) {
+      echan->m->internal_name = numparts == 1 ? std::string(echan->name) : echan->m->name;
+      echan->m->part_number = numparts == 1 ? 0 : echan->view_id;
+
+      if (numparts > 1) {
+        headers[echan->view_id].channels().insert(
+            echan->m->internal_name, Channel(echan->use_half_float ? Imf::HALF : Imf::FLOAT));
+      }
+      exr_printf("%d %-6s %-22s \"%s\"\n",
+                 echan->m->part_number,
+                 echan->m->view.c_str(),
+                 echan->m->name.c_str(),
+                 echan->m->internal_name.c_str());
+    }
   }
 
   /* avoid crash/abort when we don't have permission to write here */
@@ -1021,13 +1160,26 @@ void IMB_exrtile_begin_write(
     data->ofile_stream = new OFileStream(filepath);
     data->mpofile = new MultiPartOutputFile(*(data->ofile_stream), headers.data(), headers.size());
   }
+  catch (const std::exception &exc) {
+    std::cerr << "IMB_exrtile_begin_write: ERROR: " << exc.what() << std::endl;
+
+    delete data->mpofile;
+    delete data->ofile_stream;
+
+    data->mpofile = nullptr;
+    data->ofile_stream = nullptr;
+  }
   catch (...) { /* Catch-all for edge cases or compiler bugs. */
+    std::cerr << "IMB_exrtile_begin_write: UNKNOWN ERROR" << std::endl;
+
     delete data->mpofile;
     delete data->ofile_stream;
 
     data->mpofile = nullptr;
     data->ofile_stream = nullptr;
   }
+
+  return (data->mpofile != nullptr);
 }
 
 bool IMB_exr_begin_read(
@@ -1175,7 +1327,6 @@ void IMB_exr_clear_channels(void *handle)
 void IMB_exr_write_channels(void *handle)
 {
   ExrHandle *data = (ExrHandle *)handle;
-  FrameBuffer frameBuffer;
 
   if (data->channels.first) {
     const size_t num_pixels = size_t(data->width) * data->height;
@@ -1187,23 +1338,27 @@ void IMB_exr_write_channels(void *handle)
       current_rect_half = rect_half;
     }
 
+    /* Files with multiple parts have a frame buffer for each part. */
+    const int numparts = data->mpofile ? data->mpofile->parts() : 1;
+    std::vector<FrameBuffer> frame_buffers(numparts);
+    std::vector<std::pair<const ExrChannel *, half *>> half_channels;
+
     LISTBASE_FOREACH (ExrChannel *, echan, &data->channels) {
+      FrameBuffer &frameBuffer = frame_buffers[data->mpofile ? echan->m->part_number : 0];
+      const char *name = data->mpofile ? echan->m->internal_name.c_str() : echan->name;
+
       /* Writing starts from last scan-line, stride negative. */
       if (echan->use_half_float) {
-        const float *rect = echan->rect;
-        half *cur = current_rect_half;
-        for (size_t i = 0; i < num_pixels; i++, cur++) {
-          *cur = float_to_half_safe(rect[i * echan->xstride]);
-        }
+        half_channels.emplace_back(echan, current_rect_half);
         half *rect_to_write = current_rect_half + (data->height - 1L) * data->width;
         frameBuffer.insert(
-            echan->name,
+            name,
             Slice(Imf::HALF, (char *)rect_to_write, sizeof(half), -data->width * sizeof(half)));
         current_rect_half += num_pixels;
       }
       else {
         float *rect = echan->rect + echan->xstride * (data->height - 1L) * data->width;
-        frameBuffer.insert(echan->name,
+        frameBuffer.insert(name,
                            Slice(Imf::FLOAT,
                                  (char *)rect,
                                  echan->xstride * sizeof(float),
@@ -1211,9 +1366,33 @@ void IMB_exr_write_channels(void *handle)
       }
     }
 
-    data->ofile->setFrameBuffer(frameBuffer);
+    /* Convert the half channels, with the rows distributed over threads. */
+    blender::threading::parallel_for(
+        blender::IndexRange(data->height), 64, [&](const blender::IndexRange rows) {
+          const size_t first_pixel = rows.first() * size_t(data->width);
+          const size_t last_pixel = (rows.last() + 1) * size_t(data->width);
+          for (const auto &[echan, channel_rect_half] : half_channels) {
+            const float *rect = echan->rect;
+            for (size_t i = first_pixel; i < last_pixel; i++) {
+              channel_rect_half[i] = float_to_half_safe(rect[i * echan->xstride]);
+            }
+          }
+        });
+
+    /* The line blocks of each part are compressed in parallel by the global thread pool of
+     * OpenEXR, see #imb_initopenexr. */
     try {
-      data->ofile->writePixels(data->height);
+      if (data->mpofile) {
+        for (int part = 0; part < numparts; part++) {
+          OutputPart out(*data->mpofile, part);
+          out.setFrameBuffer(frame_buffers[part]);
+          out.writePixels(data->height);
+        }
+      }
+      else {
+        data->ofile->setFrameBuffer(frame_buffers[0]);
+        data->ofile->writePixels(data->height);
+      }
     }
     catch (const std::exception &exc) {
       std::cerr << "OpenEXR-writePixels: ERROR: " << exc.what() << std::endl;
@@ -1236,9 +1415,15 @@ void IMB_exrtile_write_channels(
 {
   /* Can write empty channels for incomplete renders. */
   ExrHandle *data = (ExrHandle *)handle;
-  FrameBuffer frameBuffer;
-  std::string view(viewname);
-  const int view_id = imb_exr_get_multiView_id(*data->multiView, view);
+  const int numparts = data->mpofile->parts();
+  std::vector<FrameBuffer> frame_buffers(numparts);
+
+  /* The size of the tile, which might be clipped by the edges of the image. */
+  const int tile_width = std::min(data->tilex, data->width - partx);
+  const int tile_height = std::min(data->tiley, data->height - party);
+
+  /* Temporary storage for the tile of half channels, which needs to be converted. */
+  std::vector<std::unique_ptr<half[]>> half_tiles;
 
   exr_printf("\nIMB_exrtile_write_channels(view: %s)\n", viewname);
   exr_printf("%s %-6s %-22s \"%s\"\n", "p", "view", "name", "internal_name");
@@ -1258,27 +1443,56 @@ void IMB_exrtile_write_channels(
                  echan->m->name.c_str(),
                  echan->m->internal_name.c_str());
 
-      float *rect = echan->rect - echan->xstride * partx - echan->ystride * party;
-      frameBuffer.insert(echan->m->internal_name,
-                         Slice(Imf::FLOAT,
-                               (char *)rect,
-                               echan->xstride * sizeof(float),
-                               echan->ystride * sizeof(float)));
+      /* The rect of the channel points to the first pixel of the tile, and the strides might be
+       * negative to flip the rows. */
+      if (echan->use_half_float) {
+        half *half_tile = new half[size_t(tile_width) * tile_height];
+        half_tiles.emplace_back(half_tile);
+        for (int y = 0; y < tile_height; y++) {
+          for (int x = 0; x < tile_width; x++) {
+            half_tile[size_t(y) * tile_width + x] = float_to_half_safe(
+                echan->rect[ptrdiff_t(x) * echan->xstride + ptrdiff_t(y) * echan->ystride]);
+          }
+        }
+
+        half *rect = half_tile - partx - ptrdiff_t(party) * tile_width;
+        frame_buffers[echan->m->part_number].insert(
+            echan->m->internal_name,
+            Slice(Imf::HALF, (char *)rect, sizeof(half), size_t(tile_width) * sizeof(half)));
+        continue;
+      }
+
+      float *rect = echan->rect - ptrdiff_t(echan->xstride) * partx -
+                    ptrdiff_t(echan->ystride) * party;
+      frame_buffers[echan->m->part_number].insert(echan->m->internal_name,
+                                                  Slice(Imf::FLOAT,
+                                                        (char *)rect,
+                                                        echan->xstride * sizeof(float),
+                                                        echan->ystride * sizeof(float)));
     }
   }
 
-  TiledOutputPart out(*data->mpofile, view_id);
-  out.setFrameBuffer(frameBuffer);
+  for (int part = 0; part < numparts; part++) {
+    /* Write the tile of every part of the view, where files with a single part store all views. */
+    const Header &header = data->mpofile->header(part);
+    const std::string part_view = header.hasView() ? header.view() : std::string();
+    if (numparts > 1 && part_view != viewname) {
+      continue;
+    }
 
-  try {
-    // printf("write tile %d %d\n", partx/data->tilex, party/data->tiley);
-    out.writeTile(partx / data->tilex, party / data->tiley, level);
-  }
-  catch (const std::exception &exc) {
-    std::cerr << "OpenEXR-writeTile: ERROR: " << exc.what() << std::endl;
-  }
-  catch (...) { /* Catch-all for edge cases or compiler bugs. */
-    std::cerr << "OpenEXR-writeTile: UNKNOWN ERROR" << std::endl;
+    TiledOutputPart out(*data->mpofile, part);
+    out.setFrameBuffer(frame_buffers[part]);
+
+    try {
+      // printf("write tile %d %d\n", partx/data->tilex, party/data->tiley);
+      out.writeTile(partx / data->tilex, party / data->tiley, level);
+    }
+    catch (const std::exception &exc) {
+      std::cerr << "OpenEXR-writeTile: ERROR: " << exc.what() << std::endl;
+    }
+    catch (...) { /* Catch-all for edge cases or compiler bugs. */
+      std::cerr << "OpenEXR-writeTile: UNKNOWN ERROR" << std::endl;
+    }
   }
 }
 
@@ -1696,9 +1910,20 @@ static std::vector<MultiViewChannelName> exr_channels_in_multi_part_file(
         m.view = part_view;
       }
 
-      /* Prepend part name as potential layer or pass name. */
+      /* Prepend part name as potential layer or pass name. Parts of multi-view files that store a
+       * pass per part have the view at the end of their name to keep it unique, which is not part
+       * of the pass name, see #imb_exr_headers_per_pass. */
       if (!part_name.empty()) {
-        m.name = part_name + "." + m.name;
+        const std::string view_suffix = "." + part_view;
+        if (!part_view.empty() && part_name.size() > view_suffix.size() &&
+            part_name.compare(
+                part_name.size() - view_suffix.size(), view_suffix.size(), view_suffix) == 0)
+        {
+          m.name = part_name.substr(0, part_name.size() - view_suffix.size()) + "." + m.name;
+        }
+        else {
+          m.name = part_name + "." + m.name;
+        }
       }
 
       m.part_number = p;
@@ -23,7 +23,8 @@ void IMB_exr_add_channel(void * /*handle*/,
                          int /*xstride*/,
                          int /*ystride*/,
                          float * /*rect*/,
-                         bool /*use_half_float*/)
+                         bool /*use_half_float*/,
+                         int /*compress*/)
 {
 }
 
@@ -45,14 +46,18 @@ bool IMB_exr_begin_write(void * /*handle*/,
 {
   return false;
 }
-void IMB_exrtile_begin_write(void * /*handle*/,
+bool IMB_exrtile_begin_write(void * /*handle*/,
                              const char * /*filepath*/,
                              int /*mipmap*/,
                              int /*width*/,
                              int /*height*/,
                              int /*tilex*/,
-                             int /*tiley*/)
+                             int /*tiley*/,
+                             int /*compress*/,
+                             int /*quality*/,
+                             const StampData * /*stamp*/)
 {
+  return false;
 }
 
 bool IMB_exr_set_channel(void * /*handle*/,
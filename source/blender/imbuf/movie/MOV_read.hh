@@ -50,7 +50,9 @@ void MOV_close(MovieReader *anim);
  *
  * Internally this will seek within the movie as/if needed. For most movie
  * files, decoding frames sequentially is much more efficient than decoding
- * random frames.
+ * random frames. When frames are fetched in order, the following frames are
+ * decoded ahead in the background, so that decoding overlaps with the
+ * processing of the current frame.
  *
  * If proxy_size is not IMB_PROXY_NONE, a proxy file of given size will
  * be attempted. If it exists, the frame will be decoded from it. If the
@@ -0,0 +1,254 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup imbuf
+ */
+
+#ifdef WITH_FFMPEG
+#  include "ffmpeg_yuv.hh"
+
+#  include <algorithm>
+#  include <cstdint>
+
+#  include "BLI_array.hh"
+#  include "BLI_simd.hh"
+#  include "BLI_task.hh"
+#  include "BLI_utildefines.h"
+
+extern "C" {
+#  include <libavutil/common.h>
+#  include <libavutil/frame.h>
+#  include <libavutil/pixdesc.h>
+#  include <libavutil/pixfmt.h>
+}
+
+bool ffmpeg_yuv_is_supported(const int av_pix_fmt)
+{
+  const AVPixFmtDescriptor *descriptor = av_pix_fmt_desc_get(AVPixelFormat(av_pix_fmt));
+  if (descriptor == nullptr) {
+    return false;
+  }
+
+  if (!(descriptor->flags & AV_PIX_FMT_FLAG_PLANAR) ||
+      (descriptor->flags & (AV_PIX_FMT_FLAG_BE | AV_PIX_FMT_FLAG_RGB | AV_PIX_FMT_FLAG_PAL |
+                            AV_PIX_FMT_FLAG_BITSTREAM | AV_PIX_FMT_FLAG_HWACCEL)))
+  {
+    return false;
+  }
+
+  if (!ELEM(descriptor->nb_components, 3, 4) || descriptor->log2_chroma_w > 1 ||
+      descriptor->log2_chroma_h > 1)
+  {
+    return false;
+  }
+
+  /* Every component should be stored in its own plane, in the low bits of two bytes. */
+  for (int i = 0; i < descriptor->nb_components; i++) {
+    const AVComponentDescriptor &component = descriptor->comp[i];
+    if (component.plane != i || component.step != 2 || component.offset != 0 ||
+        component.shift != 0 || component.depth <= 8 || component.depth > 16 ||
+        component.depth != descriptor->comp[0].depth)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/* The coefficients of the conversion from normalized YUV to RGB. */
+struct YUVToRGBCoefficients {
+  float v_to_r;
+  float u_to_g;
+  float v_to_g;
+  float u_to_b;
+};
+
+/* Follows the color spaces that sws_getCoefficients supports, falling back to BT.601. */
+static YUVToRGBCoefficients get_yuv_to_rgb_coefficients(const int av_colorspace)
+{
+  float kr, kb;
+  switch (av_colorspace) {
+    case AVCOL_SPC_BT709:
+      kr = 0.2126f;
+      kb = 0.0722f;
+      break;
+    case AVCOL_SPC_FCC:
+      kr = 0.30f;
+      kb = 0.11f;
+      break;
+    case AVCOL_SPC_SMPTE240M:
+      kr = 0.212f;
+      kb = 0.087f;
+      break;
+    case AVCOL_SPC_BT2020_NCL:
+    case AVCOL_SPC_BT2020_CL:
+      kr = 0.2627f;
+      kb = 0.0593f;
+      break;
+    default:
+      kr = 0.299f;
+      kb = 0.114f;
+      break;
+  }
+
+  const float kg = 1.0f - kr - kb;
+  YUVToRGBCoefficients coefficients;
+  coefficients.v_to_r = 2.0f * (1.0f - kr);
+  coefficients.u_to_g = -2.0f * kb * (1.0f - kb) / kg;
+  coefficients.v_to_g = -2.0f * kr * (1.0f - kr) / kg;
+  coefficients.u_to_b = 2.0f * (1.0f - kb);
+  return coefficients;
+}
+
+static const uint16_t *get_plane_row(const AVFrame *frame, const int plane, const int y)
+{
+  return reinterpret_cast<const uint16_t *>(frame->data[plane] + y * frame->linesize[plane]);
+}
+
+/* Reads the chroma samples of the given row into the given full width row, interpolating
+ * horizontally subsampled chroma linearly between samples, which are sited at even pixels. */
+static void upsample_chroma_row(const uint16_t *src,
+                                const int log2_chroma_w,
+                                const int width,
+                                blender::MutableSpan<float> dst)
+{
+  if (log2_chroma_w == 0) {
+    for (int x = 0; x < width; x++) {
+      dst[x] = float(src[x]);
+    }
+    return;
+  }
+
+  const int chroma_width = (width + 1) >> 1;
+  for (int i = 0; i < chroma_width; i++) {
+    const float sample = float(src[i]);
+    const float next_sample = float(src[std::min(i + 1, chroma_width - 1)]);
+    dst[2 * i] = sample;
+    if (2 * i + 1 < width) {
+      dst[2 * i + 1] = (sample + next_sample) * 0.5f;
+    }
+  }
+}
+
+void ffmpeg_yuv_to_rgba_float(const AVFrame *src,
+                              const int av_colorspace,
+                              const bool full_range,
+                              float *dst,
+                              const int width,
+                              const int height)
+{
+  const AVPixFmtDescriptor *descriptor = av_pix_fmt_desc_get(AVPixelFormat(src->format));
+  BLI_assert(ffmpeg_yuv_is_supported(src->format));
+  BLI_assert(src->width >= width && src->height >= height);
+
+  /* Normalize the values such that luma and alpha are in [0, 1] and chroma is in [-0.5, 0.5]. */
+  const int depth = descriptor->comp[0].depth;
+  const float max_value = float((1 << depth) - 1);
+  const float chroma_offset = float(1 << (depth - 1));
+  const float luma_offset = full_range ? 0.0f : float(16 << (depth - 8));
+  const float luma_scale = 1.0f / (full_range ? max_value : float(219 << (depth - 8)));
+  const float chroma_scale = 1.0f / (full_range ? max_value : float(224 << (depth - 8)));
+  const float alpha_scale = 1.0f / max_value;
+
+  const YUVToRGBCoefficients coefficients = get_yuv_to_rgb_coefficients(av_colorspace);
+  const bool has_alpha = descriptor->nb_components == 4;
+  const int log2_chroma_w = descriptor->log2_chroma_w;
+  const int log2_chroma_h = descriptor->log2_chroma_h;
+  const int chroma_height = AV_CEIL_RSHIFT(src->height, log2_chroma_h);
+
+  using namespace blender;
+  threading::parallel_for(IndexRange(height), 32, [&](const IndexRange rows) {
+    Array<float> u_row(width);
+    Array<float> v_row(width);
+    Array<float> u_row_other(log2_chroma_h ? width : 0);
+    Array<float> v_row_other(log2_chroma_h ? width : 0);
+
+    for (const int64_t y : rows) {
+      const int src_y = height - 1 - int(y);
+      const uint16_t *src_luma = get_plane_row(src, 0, src_y);
+      const uint16_t *src_alpha = has_alpha ? get_plane_row(src, 3, src_y) : nullptr;
+      float *dst_row = dst + int64_t(y) * width * 4;
+
+      const int chroma_y = src_y >> log2_chroma_h;
+      upsample_chroma_row(get_plane_row(src, 1, chroma_y), log2_chroma_w, width, u_row);
+      upsample_chroma_row(get_plane_row(src, 2, chroma_y), log2_chroma_w, width, v_row);
+
+      if (log2_chroma_h) {
+        /* Chroma samples are sited between two luma rows, so each luma row interpolates the
+         * nearest chroma row with the one on the other side of the luma row, with weights of
+         * three quarters and one quarter. */
+        const int other_chroma_y = std::clamp(
+            (src_y & 1) ? chroma_y + 1 : chroma_y - 1, 0, chroma_height - 1);
+        upsample_chroma_row(
+            get_plane_row(src, 1, other_chroma_y), log2_chroma_w, width, u_row_other);
+        upsample_chroma_row(
+            get_plane_row(src, 2, other_chroma_y), log2_chroma_w, width, v_row_other);
+        for (int x = 0; x < width; x++) {
+          u_row[x] = u_row[x] * 0.75f + u_row_other[x] * 0.25f;
+          v_row[x] = v_row[x] * 0.75f + v_row_other[x] * 0.25f;
+        }
+      }
+
+      int x = 0;
+#  if BLI_HAVE_SSE2
+      const __m128 zero = _mm_setzero_ps();
+      const __m128 one = _mm_set1_ps(1.0f);
+      const __m128 chroma_offset_4 = _mm_set1_ps(chroma_offset);
+      const __m128 chroma_scale_4 = _mm_set1_ps(chroma_scale);
+      for (; x + 4 <= width; x += 4) {
+        const __m128i luma_bits = _mm_loadl_epi64(
+            reinterpret_cast<const __m128i *>(src_luma + x));
+        const __m128 luma = _mm_mul_ps(
+            _mm_sub_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(luma_bits, _mm_setzero_si128())),
+                       _mm_set1_ps(luma_offset)),
+            _mm_set1_ps(luma_scale));
+        const __m128 u = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&u_row[x]), chroma_offset_4),
+                                    chroma_scale_4);
+        const __m128 v = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&v_row[x]), chroma_offset_4),
+                                    chroma_scale_4);
+
+        __m128 r = _mm_add_ps(luma, _mm_mul_ps(v, _mm_set1_ps(coefficients.v_to_r)));
+        __m128 g = _mm_add_ps(luma,
+                              _mm_add_ps(_mm_mul_ps(u, _mm_set1_ps(coefficients.u_to_g)),
+                                         _mm_mul_ps(v, _mm_set1_ps(coefficients.v_to_g))));
+        __m128 b = _mm_add_ps(luma, _mm_mul_ps(u, _mm_set1_ps(coefficients.u_to_b)));
+        r = _mm_min_ps(_mm_max_ps(r, zero), one);
+        g = _mm_min_ps(_mm_max_ps(g, zero), one);
+        b = _mm_min_ps(_mm_max_ps(b, zero), one);
+
+        __m128 a = one;
+        if (src_alpha) {
+          const __m128i alpha_bits = _mm_loadl_epi64(
+              reinterpret_cast<const __m128i *>(src_alpha + x));
+          a = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(alpha_bits, _mm_setzero_si128())),
+                         _mm_set1_ps(alpha_scale));
+        }
+
+        /* Transpose the channels of four pixels into four interleaved pixels. */
+        _MM_TRANSPOSE4_PS(r, g, b, a);
+        _mm_storeu_ps(dst_row + x * 4, r);
+        _mm_storeu_ps(dst_row + x * 4 + 4, g);
+        _mm_storeu_ps(dst_row + x * 4 + 8, b);
+        _mm_storeu_ps(dst_row + x * 4 + 12, a);
+      }
+#  endif
+
+      for (; x < width; x++) {
+        const float luma = (float(src_luma[x]) - luma_offset) * luma_scale;
+        const float u = (u_row[x] - chroma_offset) * chroma_scale;
+        const float v = (v_row[x] - chroma_offset) * chroma_scale;
+        float *pixel = dst_row + x * 4;
+        pixel[0] = std::clamp(luma + v * coefficients.v_to_r, 0.0f, 1.0f);
+        pixel[1] = std::clamp(
+            luma + u * coefficients.u_to_g + v * coefficients.v_to_g, 0.0f, 1.0f);
+        pixel[2] = std::clamp(luma + u * coefficients.u_to_b, 0.0f, 1.0f);
+        pixel[3] = src_alpha ? float(src_alpha[x]) * alpha_scale : 1.0f;
+      }
+    }
+  });
+}
+
+#endif /* WITH_FFMPEG */
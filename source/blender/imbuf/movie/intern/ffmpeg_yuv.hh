@@ -0,0 +1,36 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup imbuf
+ */
+
+#ifdef WITH_FFMPEG
+
+struct AVFrame;
+
+/**
+ * Returns true if frames of the given pixel format can be converted by
+ * #ffmpeg_yuv_to_rgba_float, which is the case for planar YUV formats with 9 to 16 bits per
+ * component, like the 10-bit 4:2:0 and 4:2:2 formats used by most high bit depth movies.
+ */
+bool ffmpeg_yuv_is_supported(int av_pix_fmt);
+
+/**
+ * Converts the given YUV frame to interleaved RGBA floats of the given size in a single
+ * multithreaded pass, flipping it vertically, such that the first row of the destination is the
+ * last row of the frame. This avoids the planar float intermediate frame that swscale needs for
+ * float outputs.
+ *
+ * The conversion matrix is chosen based on the given `AVColorSpace`, limited range inputs are
+ * expanded to full range, and the resulting colors are clamped to the [0, 1] range. Subsampled
+ * chroma is interpolated linearly, assuming left siting horizontally and center siting
+ * vertically.
+ */
+void ffmpeg_yuv_to_rgba_float(
+    const AVFrame *src, int av_colorspace, bool full_range, float *dst, int width, int height);
+
+#endif /* WITH_FFMPEG */
@@ -35,7 +35,10 @@
 #include "movie_read.hh"
 
 #ifdef WITH_FFMPEG
+#  include "BLI_task.h"
+
 #  include "ffmpeg_swscale.hh"
+#  include "ffmpeg_yuv.hh"
 #  include "movie_util.hh"
 
 extern "C" {
@@ -79,6 +82,8 @@ IDProperty *MOV_load_metadata(MovieReader *anim)
   if (anim->state == MovieReader::State::Valid) {
 #ifdef WITH_FFMPEG
     BLI_assert(anim->pFormatCtx != nullptr);
+    /* Reading packets can update the metadata. */
+    movie_decode_ahead_stop(anim);
     av_log(anim->pFormatCtx, AV_LOG_DEBUG, "METADATA FETCH\n");
 
     AVDictionaryEntry *entry = nullptr;
@@ -400,6 +405,7 @@ static int startffmpeg(MovieReader *anim)
 
   /* Decode >8bit videos into floating point image. */
   anim->is_float = calc_pix_fmt_max_component_bits(pCodecCtx->pix_fmt) > 8;
+  anim->convert_yuv_directly = anim->is_float && ffmpeg_yuv_is_supported(pCodecCtx->pix_fmt);
 
   anim->pFormatCtx = pFormatCtx;
   anim->pCodecCtx = pCodecCtx;
@@ -425,8 +431,9 @@ static int startffmpeg(MovieReader *anim)
   anim->pFrameRGB->width = anim->x;
   anim->pFrameRGB->height = anim->y;
 
+  /* The intermediate frame is not needed when converting directly into the image buffer. */
   const size_t align = ffmpeg_get_buffer_alignment();
-  if (av_frame_get_buffer(anim->pFrameRGB, align) < 0) {
+  if (!anim->convert_yuv_directly && av_frame_get_buffer(anim->pFrameRGB, align) < 0) {
     fprintf(stderr, "Could not allocate frame data.\n");
     avcodec_free_context(&anim->pCodecCtx);
     avformat_close_input(&anim->pFormatCtx);
@@ -616,7 +623,16 @@ static void ffmpeg_postprocess(MovieReader *anim, AVFrame *input, ImBuf *ibuf)
     }
   }
 
-  if (anim->is_float) {
+  if (anim->convert_yuv_directly) {
+    /* Convert and flip directly into the destination in a single pass. */
+    ffmpeg_yuv_to_rgba_float(input,
+                             anim->pCodecCtx->colorspace,
+                             anim->pCodecCtx->color_range == AVCOL_RANGE_JPEG,
+                             ibuf->float_buffer.data,
+                             ibuf->x,
+                             ibuf->y);
+  }
+  else if (anim->is_float) {
     /* Float images are converted into planar BGRA layout by swscale (since
      * it does not support direct YUV->RGBA float interleaved conversion).
      * Do vertical flip and interleave into RGBA manually. */
@@ -1139,15 +1155,14 @@ static bool ffmpeg_must_seek(MovieReader *anim, int position)
   return must_seek;
 }
 
-static ImBuf *ffmpeg_fetchibuf(MovieReader *anim, int position, IMB_Timecode_Type tc)
+/* Decodes the frame at the given position, seeking first if it doesn't directly follow the
+ * current position. Returns the PTS of the frame, to be passed to #ffmpeg_frame_to_ibuf. */
+static int64_t ffmpeg_decode_position(MovieReader *anim,
+                                      const int position,
+                                      const MovieIndex *tc_index)
 {
-  if (anim == nullptr) {
-    return nullptr;
-  }
-
   av_log(anim->pFormatCtx, AV_LOG_DEBUG, "FETCH: seek_pos=%d\n", position);
 
-  const MovieIndex *tc_index = movie_open_index(anim, tc);
   int64_t pts_to_search = ffmpeg_get_pts_to_search(anim, tc_index, position);
   AVStream *v_st = anim->pFormatCtx->streams[anim->videoStream];
   double frame_rate = av_q2d(v_st->r_frame_rate);
@@ -1180,10 +1195,12 @@ static ImBuf *ffmpeg_fetchibuf(MovieReader *anim, int position, IMB_Timecode_Typ
     }
   }
 
-  /* Update resolution as it can change per-frame with WebM. See #100741 & #100081. */
-  anim->x = anim->pCodecCtx->width;
-  anim->y = anim->pCodecCtx->height;
+  return pts_to_search;
+}
 
+/* Converts the decoded frame with the given PTS to a new image buffer of the size of the movie. */
+static ImBuf *ffmpeg_frame_to_ibuf(MovieReader *anim, const int64_t pts_to_search)
+{
   const AVPixFmtDescriptor *pix_fmt_descriptor = av_pix_fmt_desc_get(anim->pCodecCtx->pix_fmt);
 
   int planes = R_IMF_PLANES_RGBA;
@@ -1193,17 +1210,18 @@ static ImBuf *ffmpeg_fetchibuf(MovieReader *anim, int position, IMB_Timecode_Typ
 
   ImBuf *cur_frame_final = IMB_allocImBuf(anim->x, anim->y, planes, 0);
 
-  /* Allocate the storage explicitly to ensure the memory is aligned. */
+  /* Allocate the storage explicitly to ensure the memory is aligned. Frames of the same size are
+   * allocated and freed at a high rate during playback, so reuse the storage of freed frames. */
   const size_t align = ffmpeg_get_buffer_alignment();
   const size_t pixel_size = anim->is_float ? 16 : 4;
   uint8_t *buffer_data = static_cast<uint8_t *>(
-      MEM_mallocN_aligned(pixel_size * anim->x * anim->y, align, "ffmpeg ibuf"));
+      IMB_alloc_pooled_pixels(pixel_size * anim->x * anim->y, align));
   if (anim->is_float) {
-    IMB_assign_float_buffer(cur_frame_final, (float *)buffer_data, IB_TAKE_OWNERSHIP);
+    IMB_assign_float_buffer(cur_frame_final, (float *)buffer_data, IB_TAKE_POOLED_OWNERSHIP);
     cur_frame_final->float_buffer.colorspace = colormanage_colorspace_get_named(anim->colorspace);
   }
   else {
-    IMB_assign_byte_buffer(cur_frame_final, buffer_data, IB_TAKE_OWNERSHIP);
+    IMB_assign_byte_buffer(cur_frame_final, buffer_data, IB_TAKE_POOLED_OWNERSHIP);
     cur_frame_final->byte_buffer.colorspace = colormanage_colorspace_get_named(anim->colorspace);
   }
 
@@ -1220,17 +1238,186 @@ static ImBuf *ffmpeg_fetchibuf(MovieReader *anim, int position, IMB_Timecode_Typ
     ffmpeg_postprocess(anim, final_frame, cur_frame_final);
   }
 
+  return cur_frame_final;
+}
+
+static ImBuf *ffmpeg_fetchibuf(MovieReader *anim, int position, const MovieIndex *tc_index)
+{
+  if (anim == nullptr) {
+    return nullptr;
+  }
+
+  const int64_t pts_to_search = ffmpeg_decode_position(anim, position, tc_index);
+
+  /* Update resolution as it can change per-frame with WebM. See #100741 & #100081. */
+  anim->x = anim->pCodecCtx->width;
+  anim->y = anim->pCodecCtx->height;
+
+  ImBuf *cur_frame_final = ffmpeg_frame_to_ibuf(anim, pts_to_search);
+
   anim->cur_position = position;
 
   return cur_frame_final;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Decode Ahead
+ *
+ * During forward playback, the frames following the requested one are decoded in a background
+ * task while the caller processes the current frame, such that decoding overlaps with the rest of
+ * the playback pipeline instead of adding to it. At most #decode_ahead_frames_max frames are kept
+ * ahead, and the task is stopped and its frames are discarded as soon as a frame other than the
+ * next one is requested, after which the decoder state is used from the calling thread as usual.
+ *
+ * While the task is running, it owns the decoder state of the reader, which is why the decoded
+ * frames are only converted to image buffers of the size known to the caller. If the size of the
+ * movie changes, the task stops and leaves the decoded frame for the caller to convert.
+ * \{ */
+
+static constexpr int decode_ahead_frames_max = 2;
+
+static void ffmpeg_decode_ahead_run(TaskPool *__restrict pool, void * /*task_data*/)
+{
+  MovieReader *anim = static_cast<MovieReader *>(BLI_task_pool_user_data(pool));
+
+  while (true) {
+    int position;
+    {
+      std::lock_guard lock(anim->decode_ahead_mutex);
+      if (anim->decode_ahead_stop ||
+          anim->decode_ahead_frames.size() >= decode_ahead_frames_max ||
+          anim->decode_ahead_position >= anim->duration_in_frames)
+      {
+        anim->decode_ahead_running = false;
+        return;
+      }
+      position = anim->decode_ahead_position;
+    }
+
+    const int64_t pts_to_search = ffmpeg_decode_position(
+        anim, position, anim->decode_ahead_tc_index);
+    anim->cur_position = position;
+
+    ImBuf *ibuf = nullptr;
+    if (anim->pCodecCtx->width == anim->x && anim->pCodecCtx->height == anim->y) {
+      ibuf = ffmpeg_frame_to_ibuf(anim, pts_to_search);
+    }
+
+    std::lock_guard lock(anim->decode_ahead_mutex);
+    if (ibuf == nullptr) {
+      anim->decode_ahead_running = false;
+      return;
+    }
+    anim->decode_ahead_frames.append({position, ibuf});
+    anim->decode_ahead_position++;
+  }
+}
+
+void movie_decode_ahead_stop(MovieReader *anim)
+{
+  if (anim->decode_ahead_pool == nullptr) {
+    return;
+  }
+
+  {
+    std::lock_guard lock(anim->decode_ahead_mutex);
+    anim->decode_ahead_stop = true;
+  }
+  BLI_task_pool_work_and_wait(anim->decode_ahead_pool);
+
+  std::lock_guard lock(anim->decode_ahead_mutex);
+  anim->decode_ahead_stop = false;
+  for (const MovieReader::DecodedFrame &frame : anim->decode_ahead_frames) {
+    IMB_freeImBuf(frame.ibuf);
+  }
+  anim->decode_ahead_frames.clear();
+}
+
+/* Returns the frame at the given position if it was decoded ahead, waiting for it if it is
+ * currently being decoded, otherwise, returns nullptr. */
+static ImBuf *ffmpeg_decode_ahead_take(MovieReader *anim, const int position, IMB_Timecode_Type tc)
+{
+  if (anim->decode_ahead_pool == nullptr) {
+    return nullptr;
+  }
+
+  std::unique_lock lock(anim->decode_ahead_mutex);
+  if (anim->decode_ahead_tc != tc) {
+    return nullptr;
+  }
+
+  if (anim->decode_ahead_frames.is_empty() && anim->decode_ahead_running &&
+      anim->decode_ahead_position == position)
+  {
+    /* Wait for the frame to be decoded, but don't let the task decode further, since it will be
+     * restarted after the frame is taken anyway. */
+    anim->decode_ahead_stop = true;
+    lock.unlock();
+    BLI_task_pool_work_and_wait(anim->decode_ahead_pool);
+    lock.lock();
+    anim->decode_ahead_stop = false;
+  }
+
+  if (anim->decode_ahead_frames.is_empty() ||
+      anim->decode_ahead_frames.first().position != position)
+  {
+    return nullptr;
+  }
+
+  ImBuf *ibuf = anim->decode_ahead_frames.first().ibuf;
+  anim->decode_ahead_frames.remove(0);
+  return ibuf;
+}
+
+/* Starts decoding the frames following the given position in the background, if not already
+ * running. If no frames are pending, the decoder should be at the given position. */
+static void ffmpeg_decode_ahead_start(MovieReader *anim,
+                                      const int position,
+                                      IMB_Timecode_Type tc,
+                                      const MovieIndex *tc_index)
+{
+  if (anim->decode_ahead_pool == nullptr) {
+    anim->decode_ahead_pool = BLI_task_pool_create_background(anim, TASK_PRIORITY_HIGH);
+  }
+
+  {
+    std::lock_guard lock(anim->decode_ahead_mutex);
+    if (anim->decode_ahead_running) {
+      return;
+    }
+    if (anim->decode_ahead_frames.is_empty()) {
+      anim->decode_ahead_position = position + 1;
+      anim->decode_ahead_tc = tc;
+      anim->decode_ahead_tc_index = tc_index;
+    }
+    if (anim->decode_ahead_frames.size() >= decode_ahead_frames_max ||
+        anim->decode_ahead_position >= anim->duration_in_frames)
+    {
+      return;
+    }
+    anim->decode_ahead_running = true;
+  }
+
+  /* The previous task is done decoding, but wait for it to return, since background pools that
+   * run without TBB only start a new thread once the previous one is joined. */
+  BLI_task_pool_work_and_wait(anim->decode_ahead_pool);
+  BLI_task_pool_push(anim->decode_ahead_pool, ffmpeg_decode_ahead_run, nullptr, false, nullptr);
+}
+
+/** \} */
+
 static void free_anim_ffmpeg(MovieReader *anim)
 {
   if (anim == nullptr) {
     return;
   }
 
+  movie_decode_ahead_stop(anim);
+  if (anim->decode_ahead_pool) {
+    BLI_task_pool_free(anim->decode_ahead_pool);
+    anim->decode_ahead_pool = nullptr;
+  }
+
   if (anim->pCodecCtx) {
     avcodec_free_context(&anim->pCodecCtx);
     avformat_close_input(&anim->pFormatCtx);
@@ -1348,15 +1535,27 @@ ImBuf *MOV_decode_frame(MovieReader *anim,
 
 #ifdef WITH_FFMPEG
   if (anim->state == MovieReader::State::Valid) {
-    ibuf = ffmpeg_fetchibuf(anim, position, tc);
-    if (ibuf) {
-      anim->cur_position = position;
+    const MovieIndex *tc_index = movie_open_index(anim, tc);
+
+    ibuf = ffmpeg_decode_ahead_take(anim, position, tc);
+    if (ibuf == nullptr) {
+      movie_decode_ahead_stop(anim);
+      ibuf = ffmpeg_fetchibuf(anim, position, tc_index);
+    }
+
+    /* Only decode ahead once frames are requested in order, to not waste decoding time and
+     * memory on scrubbing and random access. */
+    if (ibuf && position - 1 == anim->decode_ahead_last_position &&
+        !anim->never_seek_decode_one_frame)
+    {
+      ffmpeg_decode_ahead_start(anim, position, tc, tc_index);
     }
+    anim->decode_ahead_last_position = position;
   }
 #endif
 
   if (ibuf) {
-    SNPRINTF(ibuf->filepath, "%s.%04d", anim->filepath, anim->cur_position + 1);
+    SNPRINTF(ibuf->filepath, "%s.%04d", anim->filepath, position + 1);
   }
   return ibuf;
 }
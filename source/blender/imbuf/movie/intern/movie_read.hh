@@ -9,9 +9,13 @@
 
 #pragma once
 
+#include <climits>
 #include <cstdint>
+#include <mutex>
 
+#include "BLI_vector.hh"
 #include "IMB_imbuf_enums.h"
+#include "MOV_enums.hh"
 
 #ifdef WITH_FFMPEG
 
@@ -25,9 +29,11 @@ struct AVCodec;
 struct AVFrame;
 struct AVPacket;
 struct SwsContext;
+struct TaskPool;
 #endif
 
 struct IDProperty;
+struct ImBuf;
 struct MovieIndex;
 
 struct MovieReader {
@@ -70,6 +76,8 @@ struct MovieReader {
 
   bool seek_before_decode = false;
   bool is_float = false;
+  /* Float frames are converted from YUV by #ffmpeg_yuv_to_rgba_float instead of swscale. */
+  bool convert_yuv_directly = false;
 
   /* When set, never seek within the video, and only ever decode one frame.
    * This is a workaround for some Ogg files that have full audio but only
@@ -77,6 +85,25 @@ struct MovieReader {
    * ffmpeg crashes/aborts when trying to seek within them
    * (https://trac.ffmpeg.org/ticket/10755). */
   bool never_seek_decode_one_frame = false;
+
+  /* Frames decoded in the background during forward playback, see the Decode Ahead section in
+   * `movie_read.cc`. The members below the mutex are protected by it, while the decoder state
+   * above is owned by the decode ahead task as long as it is running. */
+  struct DecodedFrame {
+    int position;
+    ImBuf *ibuf;
+  };
+  TaskPool *decode_ahead_pool = nullptr;
+  std::mutex decode_ahead_mutex;
+  blender::Vector<DecodedFrame> decode_ahead_frames;
+  /* The position of the next frame the task will decode. */
+  int decode_ahead_position = 0;
+  IMB_Timecode_Type decode_ahead_tc = IMB_TC_NONE;
+  const MovieIndex *decode_ahead_tc_index = nullptr;
+  bool decode_ahead_running = false;
+  bool decode_ahead_stop = false;
+  /* The position of the last frame that was requested, only accessed by the caller. */
+  int decode_ahead_last_position = INT_MIN;
 #endif
 
   char index_dir[768] = {};
@@ -93,3 +120,12 @@ struct MovieReader {
 
   IDProperty *metadata = nullptr;
 };
+
+#ifdef WITH_FFMPEG
+/**
+ * Stops the decode ahead task if it is running and frees the frames it decoded, after which the
+ * decoder state and the timecode indices of the reader can be used or freed from the calling
+ * thread.
+ */
+void movie_decode_ahead_stop(MovieReader *anim);
+#endif
@@ -0,0 +1,164 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <cmath>
+
+#include "BLI_array.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_utildefines.h"
+
+#include "ffmpeg_swscale.hh"
+#include "ffmpeg_yuv.hh"
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/pixdesc.h>
+#include <libswscale/swscale.h>
+}
+
+namespace blender::imbuf::tests {
+
+/* Odd sizes, such that the last chroma samples and the last pixels that don't fill SIMD registers
+ * are covered. */
+static constexpr int FRAME_WIDTH = 67;
+static constexpr int FRAME_HEIGHT = 37;
+
+/* Creates a frame of smooth gradients within the RGB gamut, which swscale and the direct
+ * conversion should convert alike, even though they upsample chroma differently. */
+static AVFrame *create_yuv_frame(const AVPixelFormat pixel_format)
+{
+  AVFrame *frame = av_frame_alloc();
+  frame->format = pixel_format;
+  frame->width = FRAME_WIDTH;
+  frame->height = FRAME_HEIGHT;
+  av_frame_get_buffer(frame, 0);
+
+  const AVPixFmtDescriptor *descriptor = av_pix_fmt_desc_get(pixel_format);
+  const int depth = descriptor->comp[0].depth;
+  for (int plane = 0; plane < descriptor->nb_components; plane++) {
+    const bool is_chroma = ELEM(plane, 1, 2);
+    const int width = is_chroma ? AV_CEIL_RSHIFT(FRAME_WIDTH, descriptor->log2_chroma_w) :
+                                  FRAME_WIDTH;
+    const int height = is_chroma ? AV_CEIL_RSHIFT(FRAME_HEIGHT, descriptor->log2_chroma_h) :
+                                   FRAME_HEIGHT;
+    for (int y = 0; y < height; y++) {
+      uint16_t *row = reinterpret_cast<uint16_t *>(frame->data[plane] +
+                                                   y * frame->linesize[plane]);
+      for (int x = 0; x < width; x++) {
+        const float value = plane == 0 ? 0.3f + 0.4f * x / width :
+                            plane == 1 ? 0.4f + 0.2f * y / height :
+                            plane == 2 ? 0.6f - 0.2f * x / width :
+                                         0.5f + 0.5f * y / height;
+        row[x] = uint16_t(std::round(value * ((1 << depth) - 1)));
+      }
+    }
+  }
+
+  return frame;
+}
+
+/* Converts the frame like the movie reader does for formats that the direct conversion doesn't
+ * support, into flipped RGBA floats. */
+static Array<float4> convert_with_swscale(const AVFrame *frame, const bool full_range)
+{
+  SwsContext *context = ffmpeg_sws_get_context(FRAME_WIDTH,
+                                               FRAME_HEIGHT,
+                                               frame->format,
+                                               FRAME_WIDTH,
+                                               FRAME_HEIGHT,
+                                               AV_PIX_FMT_GBRAPF32LE,
+                                               SWS_POINT | SWS_FULL_CHR_H_INT |
+                                                   SWS_ACCURATE_RND);
+  int src_range, dst_range, brightness, contrast, saturation;
+  int *table, *inv_table;
+  sws_getColorspaceDetails(
+      context, &inv_table, &src_range, &table, &dst_range, &brightness, &contrast, &saturation);
+  sws_setColorspaceDetails(context,
+                           sws_getCoefficients(AVCOL_SPC_BT709),
+                           full_range,
+                           table,
+                           dst_range,
+                           brightness,
+                           contrast,
+                           saturation);
+
+  AVFrame *rgb_frame = av_frame_alloc();
+  rgb_frame->format = AV_PIX_FMT_GBRAPF32LE;
+  rgb_frame->width = FRAME_WIDTH;
+  rgb_frame->height = FRAME_HEIGHT;
+  av_frame_get_buffer(rgb_frame, 0);
+  ffmpeg_sws_scale_frame(context, rgb_frame, frame);
+  ffmpeg_sws_release_context(context);
+
+  Array<float4> pixels(FRAME_WIDTH * FRAME_HEIGHT);
+  for (int y = 0; y < FRAME_HEIGHT; y++) {
+    const int src_offset = (FRAME_HEIGHT - 1 - y) * rgb_frame->linesize[0];
+    const float *src_g = reinterpret_cast<const float *>(rgb_frame->data[0] + src_offset);
+    const float *src_b = reinterpret_cast<const float *>(rgb_frame->data[1] + src_offset);
+    const float *src_r = reinterpret_cast<const float *>(rgb_frame->data[2] + src_offset);
+    const float *src_a = reinterpret_cast<const float *>(rgb_frame->data[3] + src_offset);
+    for (int x = 0; x < FRAME_WIDTH; x++) {
+      pixels[y * FRAME_WIDTH + x] = float4(src_r[x], src_g[x], src_b[x], src_a[x]);
+    }
+  }
+
+  av_frame_free(&rgb_frame);
+  return pixels;
+}
+
+static void test_yuv_to_rgba_float(const AVPixelFormat pixel_format, const bool full_range)
+{
+  ASSERT_TRUE(ffmpeg_yuv_is_supported(pixel_format));
+
+  AVFrame *frame = create_yuv_frame(pixel_format);
+  const Array<float4> expected = convert_with_swscale(frame, full_range);
+
+  Array<float4> result(FRAME_WIDTH * FRAME_HEIGHT);
+  ffmpeg_yuv_to_rgba_float(
+      frame, AVCOL_SPC_BT709, full_range, &result.first().x, FRAME_WIDTH, FRAME_HEIGHT);
+
+  const bool has_alpha = av_pix_fmt_desc_get(pixel_format)->nb_components == 4;
+  for (const int i : result.index_range()) {
+    for (const int channel : IndexRange(3)) {
+      EXPECT_NEAR(result[i][channel], expected[i][channel], 5e-3f) << "pixel " << i;
+    }
+    EXPECT_NEAR(result[i].w, has_alpha ? expected[i].w : 1.0f, 1e-3f) << "pixel " << i;
+  }
+
+  av_frame_free(&frame);
+  ffmpeg_sws_exit();
+}
+
+TEST(ffmpeg_yuv, unsupported_formats)
+{
+  EXPECT_FALSE(ffmpeg_yuv_is_supported(AV_PIX_FMT_YUV420P));
+  EXPECT_FALSE(ffmpeg_yuv_is_supported(AV_PIX_FMT_NV12));
+  EXPECT_FALSE(ffmpeg_yuv_is_supported(AV_PIX_FMT_P010LE));
+  EXPECT_FALSE(ffmpeg_yuv_is_supported(AV_PIX_FMT_YUV420P10BE));
+  EXPECT_FALSE(ffmpeg_yuv_is_supported(AV_PIX_FMT_GBRP10LE));
+}
+
+TEST(ffmpeg_yuv, yuv420p10_matches_swscale)
+{
+  test_yuv_to_rgba_float(AV_PIX_FMT_YUV420P10LE, false);
+}
+
+TEST(ffmpeg_yuv, yuv422p10_matches_swscale)
+{
+  test_yuv_to_rgba_float(AV_PIX_FMT_YUV422P10LE, false);
+}
+
+TEST(ffmpeg_yuv, yuv444p12_full_range_matches_swscale)
+{
+  test_yuv_to_rgba_float(AV_PIX_FMT_YUV444P12LE, true);
+}
+
+TEST(ffmpeg_yuv, yuva420p10_matches_swscale)
+{
+  test_yuv_to_rgba_float(AV_PIX_FMT_YUVA420P10LE, false);
+}
+
+}  // namespace blender::imbuf::tests
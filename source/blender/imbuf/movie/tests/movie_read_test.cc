@@ -0,0 +1,117 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <cstring>
+#include <string>
+
+#include "BLI_fileops.h"
+#include "BLI_vector.hh"
+
+#include "IMB_imbuf.hh"
+#include "IMB_imbuf_types.hh"
+
+#include "MOV_read.hh"
+
+#include "movie_test_clip.hh"
+
+extern "C" {
+#include <libavutil/log.h>
+}
+
+namespace blender::imbuf::tests {
+
+/* Small clips that still span more than one group of pictures, such that decoding ahead of time
+ * crosses key frames. Decoding performance is measured by the imbuf performance tests. */
+static constexpr int2 CLIP_SIZE = int2(256, 144);
+static constexpr int CLIP_FRAMES = 30;
+
+class MovieReadTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite()
+  {
+    IMB_init();
+    av_log_set_level(AV_LOG_QUIET);
+  }
+
+  static void TearDownTestSuite()
+  {
+    IMB_exit();
+  }
+};
+
+/* Checks that the frames decoded during sequential playback, which are decoded ahead of time,
+ * match frames decoded on their own. */
+static void expect_sequential_frames_match(MovieReader *anim)
+{
+  Vector<ImBuf *> sequential_frames;
+  for (int position = 0; position < CLIP_FRAMES; position++) {
+    sequential_frames.append(MOV_decode_frame(anim, position, IMB_TC_NONE, IMB_PROXY_NONE));
+  }
+
+  for (const int position : {CLIP_FRAMES - 1, CLIP_FRAMES / 2, 1, 0}) {
+    ImBuf *ibuf = MOV_decode_frame(anim, position, IMB_TC_NONE, IMB_PROXY_NONE);
+    ImBuf *sequential_ibuf = sequential_frames[position];
+    ASSERT_NE(ibuf, nullptr);
+    ASSERT_NE(sequential_ibuf, nullptr);
+    EXPECT_EQ(ibuf->x, sequential_ibuf->x);
+    EXPECT_EQ(ibuf->y, sequential_ibuf->y);
+    if (ibuf->byte_buffer.data && sequential_ibuf->byte_buffer.data) {
+      EXPECT_EQ(memcmp(ibuf->byte_buffer.data,
+                       sequential_ibuf->byte_buffer.data,
+                       size_t(ibuf->x) * ibuf->y * 4),
+                0);
+    }
+    if (ibuf->float_buffer.data && sequential_ibuf->float_buffer.data) {
+      EXPECT_EQ(memcmp(ibuf->float_buffer.data,
+                       sequential_ibuf->float_buffer.data,
+                       size_t(ibuf->x) * ibuf->y * 4 * sizeof(float)),
+                0);
+    }
+    IMB_freeImBuf(ibuf);
+  }
+
+  for (ImBuf *ibuf : sequential_frames) {
+    IMB_freeImBuf(ibuf);
+  }
+}
+
+static void test_decode(const char *name,
+                        const char *codec_name,
+                        const AVPixelFormat pixel_format,
+                        const char *profile)
+{
+  const std::string filepath = testing::TempDir() + "movie_read_test_" + name + ".mov";
+  if (!encode_test_clip(filepath, codec_name, pixel_format, profile, CLIP_SIZE, CLIP_FRAMES)) {
+    BLI_delete(filepath.c_str(), false, false);
+    GTEST_SKIP() << "Encoder " << codec_name << " is not available";
+  }
+
+  char colorspace[IM_MAX_SPACE] = "";
+  MovieReader *anim = MOV_open_file(filepath.c_str(), 0, 0, colorspace);
+  ASSERT_NE(anim, nullptr);
+
+  expect_sequential_frames_match(anim);
+
+  MOV_close(anim);
+  BLI_delete(filepath.c_str(), false, false);
+}
+
+TEST_F(MovieReadTest, decode_prores)
+{
+  test_decode("prores", "prores_ks", AV_PIX_FMT_YUV422P10LE, "hq");
+}
+
+TEST_F(MovieReadTest, decode_h264)
+{
+  test_decode("h264", "libx264", AV_PIX_FMT_YUV420P, nullptr);
+}
+
+TEST_F(MovieReadTest, decode_dnxhr)
+{
+  test_decode("dnxhr", "dnxhd", AV_PIX_FMT_YUV422P, "dnxhr_hq");
+}
+
+}  // namespace blender::imbuf::tests
@@ -0,0 +1,122 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "movie_test_clip.hh"
+
+extern "C" {
+#include "ffmpeg_compat.h"
+
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/opt.h>
+#include <libavutil/pixdesc.h>
+}
+
+namespace blender::imbuf::tests {
+
+/* Fills the planes of the given frame with gradients that move with the frame index. */
+static void fill_frame(AVFrame *frame, const int frame_index)
+{
+  const AVPixFmtDescriptor *descriptor = av_pix_fmt_desc_get(AVPixelFormat(frame->format));
+  const bool is_high_bit_depth = descriptor->comp[0].depth > 8;
+  const int max_value = (1 << descriptor->comp[0].depth) - 1;
+
+  for (int plane = 0; plane < 3; plane++) {
+    const int width = plane == 0 ? frame->width :
+                                   AV_CEIL_RSHIFT(frame->width, descriptor->log2_chroma_w);
+    const int height = plane == 0 ? frame->height :
+                                    AV_CEIL_RSHIFT(frame->height, descriptor->log2_chroma_h);
+    for (int y = 0; y < height; y++) {
+      uint8_t *row = frame->data[plane] + y * frame->linesize[plane];
+      for (int x = 0; x < width; x++) {
+        const int value = ((x + y * (plane + 1) + frame_index * 8) * 4) % (max_value + 1);
+        if (is_high_bit_depth) {
+          reinterpret_cast<uint16_t *>(row)[x] = uint16_t(value);
+        }
+        else {
+          row[x] = uint8_t(value);
+        }
+      }
+    }
+  }
+}
+
+bool encode_test_clip(const std::string &filepath,
+                      const char *codec_name,
+                      const AVPixelFormat pixel_format,
+                      const char *profile,
+                      const int2 size,
+                      const int frames_num)
+{
+  const AVCodec *codec = avcodec_find_encoder_by_name(codec_name);
+  if (codec == nullptr) {
+    return false;
+  }
+
+  AVFormatContext *format_context = nullptr;
+  avformat_alloc_output_context2(&format_context, nullptr, "mov", filepath.c_str());
+  if (format_context == nullptr) {
+    return false;
+  }
+
+  AVCodecContext *codec_context = avcodec_alloc_context3(codec);
+  codec_context->width = size.x;
+  codec_context->height = size.y;
+  codec_context->pix_fmt = pixel_format;
+  codec_context->time_base = {1, 25};
+  codec_context->framerate = {25, 1};
+  codec_context->gop_size = 12;
+  if (format_context->oformat->flags & AVFMT_GLOBALHEADER) {
+    codec_context->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+  }
+  if (profile != nullptr) {
+    av_opt_set(codec_context->priv_data, "profile", profile, 0);
+  }
+
+  bool success = false;
+  AVStream *stream = avformat_new_stream(format_context, nullptr);
+  if (avcodec_open2(codec_context, codec, nullptr) >= 0 &&
+      avcodec_parameters_from_context(stream->codecpar, codec_context) >= 0 &&
+      avio_open(&format_context->pb, filepath.c_str(), AVIO_FLAG_WRITE) >= 0)
+  {
+    stream->time_base = codec_context->time_base;
+    success = avformat_write_header(format_context, nullptr) >= 0;
+
+    AVFrame *frame = av_frame_alloc();
+    frame->format = pixel_format;
+    frame->width = size.x;
+    frame->height = size.y;
+    av_frame_get_buffer(frame, 0);
+    AVPacket *packet = av_packet_alloc();
+
+    /* Send one more null frame at the end to flush the encoder. */
+    for (int i = 0; success && i <= frames_num; i++) {
+      AVFrame *input_frame = nullptr;
+      if (i < frames_num) {
+        av_frame_make_writable(frame);
+        fill_frame(frame, i);
+        frame->pts = i;
+        input_frame = frame;
+      }
+
+      success = avcodec_send_frame(codec_context, input_frame) >= 0;
+      while (success && avcodec_receive_packet(codec_context, packet) >= 0) {
+        av_packet_rescale_ts(packet, codec_context->time_base, stream->time_base);
+        packet->stream_index = stream->index;
+        success = av_interleaved_write_frame(format_context, packet) >= 0;
+      }
+    }
+
+    av_write_trailer(format_context);
+    av_packet_free(&packet);
+    av_frame_free(&frame);
+    avio_closep(&format_context->pb);
+  }
+
+  avcodec_free_context(&codec_context);
+  avformat_free_context(format_context);
+  return success;
+}
+
+}  // namespace blender::imbuf::tests
@@ -0,0 +1,35 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup imbuf
+ *
+ * Generation of movie clips for the movie reading tests and benchmarks.
+ */
+
+#include <string>
+
+#include "BLI_math_vector_types.hh"
+
+extern "C" {
+#include <libavutil/pixfmt.h>
+}
+
+namespace blender::imbuf::tests {
+
+/**
+ * Encodes a clip of moving gradients with the given encoder into a QuickTime file, such that
+ * consecutive frames differ and the encoder can't skip them. Returns false if the encoder is not
+ * available in this FFmpeg build.
+ */
+bool encode_test_clip(const std::string &filepath,
+                      const char *codec_name,
+                      AVPixelFormat pixel_format,
+                      const char *profile,
+                      int2 size,
+                      int frames_num);
+
+}  // namespace blender::imbuf::tests
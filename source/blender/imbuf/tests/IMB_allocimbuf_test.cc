@@ -0,0 +1,122 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <cstdint>
+
+#include "BLI_vector.hh"
+
+#include "IMB_allocimbuf.hh"
+#include "IMB_imbuf.hh"
+#include "IMB_imbuf_types.hh"
+
+#include "MEM_guardedalloc.h"
+
+namespace blender::imbuf::tests {
+
+static ImBuf *create_pooled_image(const int size_x, const int size_y)
+{
+  ImBuf *ibuf = IMB_allocImBuf(size_x, size_y, 32, 0);
+  float *data = static_cast<float *>(
+      IMB_alloc_pooled_pixels(sizeof(float) * 4 * size_x * size_y, 64));
+  IMB_assign_float_buffer(ibuf, data, IB_TAKE_POOLED_OWNERSHIP);
+  return ibuf;
+}
+
+TEST(imbuf_allocimbuf, pooled_pixels_reuse)
+{
+  imb_free_pixel_pool();
+
+  ImBuf *ibuf = create_pooled_image(16, 8);
+  const float *data = ibuf->float_buffer.data;
+  EXPECT_EQ(uintptr_t(data) % 64, 0);
+  IMB_freeImBuf(ibuf);
+
+  /* A different size doesn't reuse the freed pixels. */
+  ImBuf *other_ibuf = create_pooled_image(8, 8);
+  EXPECT_NE(other_ibuf->float_buffer.data, data);
+
+  /* The same size reuses them. */
+  ibuf = create_pooled_image(16, 8);
+  EXPECT_EQ(ibuf->float_buffer.data, data);
+
+  IMB_freeImBuf(ibuf);
+  IMB_freeImBuf(other_ibuf);
+  imb_free_pixel_pool();
+}
+
+TEST(imbuf_allocimbuf, pooled_pixels_steal)
+{
+  ImBuf *ibuf = create_pooled_image(4, 4);
+
+  /* Stolen pooled pixels are owned by the caller and can be freed as usual. */
+  float *data = IMB_steal_float_buffer(ibuf);
+  EXPECT_NE(data, nullptr);
+  EXPECT_EQ(ibuf->float_buffer.data, nullptr);
+  MEM_freeN(data);
+
+  IMB_freeImBuf(ibuf);
+  imb_free_pixel_pool();
+}
+
+TEST(imbuf_allocimbuf, pooled_pixels_bounded)
+{
+  imb_free_pixel_pool();
+  const uint initial_blocks_in_use = MEM_get_memory_blocks_in_use();
+
+  Vector<ImBuf *> ibufs;
+  for (int i = 0; i < 16; i++) {
+    ibufs.append(create_pooled_image(8, 8));
+  }
+  for (ImBuf *ibuf : ibufs) {
+    IMB_freeImBuf(ibuf);
+  }
+  ibufs.clear_and_shrink();
+
+  /* Only a few of the freed pixels are kept by the pool. */
+  const uint pooled_blocks = MEM_get_memory_blocks_in_use() - initial_blocks_in_use;
+  EXPECT_GT(pooled_blocks, 0);
+  EXPECT_LT(pooled_blocks, 16);
+
+  /* Allocating them again only allocates the image buffers. */
+  for (int i = 0; i < pooled_blocks; i++) {
+    ibufs.append(create_pooled_image(8, 8));
+  }
+  EXPECT_EQ(MEM_get_memory_blocks_in_use(), initial_blocks_in_use + 2 * pooled_blocks);
+
+  for (ImBuf *ibuf : ibufs) {
+    IMB_freeImBuf(ibuf);
+  }
+  imb_free_pixel_pool();
+  EXPECT_EQ(MEM_get_memory_blocks_in_use(), initial_blocks_in_use);
+}
+
+TEST(imbuf_allocimbuf, pooled_pixels_memory_bounded)
+{
+  imb_free_pixel_pool();
+  const size_t initial_memory_in_use = MEM_get_memory_in_use();
+
+  /* A DCI 4K float frame. Large buffers are not touched, so they are cheap to allocate. */
+  const size_t size = size_t(4096) * 2160 * 4 * sizeof(float);
+  void *first = IMB_alloc_pooled_pixels(size, 64);
+  void *second = IMB_alloc_pooled_pixels(size, 64);
+  void *too_large = IMB_alloc_pooled_pixels(size * 4, 64);
+  imb_free_pooled_pixels(first);
+  imb_free_pooled_pixels(second);
+  imb_free_pooled_pixels(too_large);
+
+  /* The pool doesn't keep more memory than its limit, even if it holds few buffers. */
+  EXPECT_LT(MEM_get_memory_in_use() - initial_memory_in_use, 2 * size);
+
+  /* The most recently freed buffer is kept, so a 4K float frame fits in the pool. */
+  void *data = IMB_alloc_pooled_pixels(size, 64);
+  EXPECT_EQ(data, second);
+  MEM_freeN(data);
+
+  imb_free_pixel_pool();
+  EXPECT_EQ(MEM_get_memory_in_use(), initial_memory_in_use);
+}
+
+}  // namespace blender::imbuf::tests
@@ -0,0 +1,232 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <cmath>
+#include <string>
+
+#include "BLI_fileops.h"
+#include "BLI_math_base.hh"
+#include "BLI_math_vector.hh"
+#include "BLI_math_vector_types.hh"
+
+#include "IMB_colormanagement_lut.hh"
+#include "IMB_imbuf.hh"
+
+#include <ocio_capi.h>
+
+namespace blender::imbuf::tests {
+
+/* A view transform like function, a tone curve followed by the sRGB transfer function. */
+static float3 display_transform(const float3 &color)
+{
+  float3 result;
+  for (int i = 0; i < 3; i++) {
+    const float value = math::max(color[i], 0.0f);
+    const float tone_mapped = value / (value + 0.6f);
+    result[i] = tone_mapped <= 0.0031308f ? tone_mapped * 12.92f :
+                                            1.055f * std::pow(tone_mapped, 1.0f / 2.4f) - 0.055f;
+  }
+  return result;
+}
+
+/* A transform that mixes channels linearly. */
+static float3 matrix_transform(const float3 &color)
+{
+  return float3(0.8f * color.x + 0.15f * color.y + 0.05f * color.z,
+                0.1f * color.x + 0.85f * color.y + 0.05f * color.z,
+                0.02f * color.x + 0.08f * color.y + 0.9f * color.z);
+}
+
+static ColorLUT3D bake(const ColorLUT3D::Shaper shaper, float3 (*function)(const float3 &))
+{
+  return ColorLUT3D(ColorLUT3D::default_resolution, shaper, [&](MutableSpan<float4> colors) {
+    for (float4 &color : colors) {
+      color = float4(function(color.xyz()), color.w);
+    }
+  });
+}
+
+TEST(imbuf_colormanagement_lut, log_shaper_accuracy)
+{
+  const ColorLUT3D lut = bake(ColorLUT3D::Shaper::Log, display_transform);
+
+  /* The error should be below the quantization error of bytes for scene linear colors. */
+  float max_error = 0.0f;
+  for (int r = 0; r < 48; r++) {
+    for (int g = 0; g < 48; g++) {
+      for (int b = 0; b < 48; b++) {
+        /* Logarithmically distributed in [2^-14, 2^10] with irregular offsets. */
+        const float3 color = float3(std::exp2(r * 0.5f - 13.7f),
+                                    std::exp2(g * 0.5f - 13.9f),
+                                    std::exp2(b * 0.5f - 13.3f));
+        max_error = math::max(max_error,
+                              math::reduce_max(math::abs(lut.evaluate(color) -
+                                                         display_transform(color))));
+      }
+    }
+  }
+  EXPECT_LT(max_error, 0.5f / 255.0f);
+}
+
+TEST(imbuf_colormanagement_lut, linear_shaper_is_exact_for_linear_transforms)
+{
+  const ColorLUT3D lut = bake(ColorLUT3D::Shaper::Linear, matrix_transform);
+
+  for (const float3 color : {float3(0.0f),
+                             float3(1.0f),
+                             float3(0.3f, 0.7f, 0.1f),
+                             float3(0.99f, 0.01f, 0.5f),
+                             float3(0.123f, 0.456f, 0.789f)})
+  {
+    const float3 result = lut.evaluate(color);
+    const float3 expected = matrix_transform(color);
+    EXPECT_NEAR(result.x, expected.x, 1e-5f);
+    EXPECT_NEAR(result.y, expected.y, 1e-5f);
+    EXPECT_NEAR(result.z, expected.z, 1e-5f);
+  }
+}
+
+TEST(imbuf_colormanagement_lut, out_of_range)
+{
+  const ColorLUT3D lut = bake(ColorLUT3D::Shaper::Log, display_transform);
+  const float3 black = lut.evaluate(float3(0.0f));
+
+  /* Negative and NaN values are clamped to zero, and large values to the maximum. */
+  EXPECT_EQ(lut.evaluate(float3(-1.0f, -0.5f, -1e10f)), black);
+  EXPECT_EQ(lut.evaluate(float3(NAN, NAN, NAN)), black);
+  EXPECT_EQ(lut.evaluate(float3(1e20f)), lut.evaluate(float3(ColorLUT3D::log_shaper_max)));
+
+  const float3 mixed = lut.evaluate(float3(NAN, 0.5f, -2.0f));
+  EXPECT_EQ(mixed, lut.evaluate(float3(0.0f, 0.5f, 0.0f)));
+}
+
+/* The log shaper clamps inputs to the [0, log_shaper_max] range, so the lattice points at the
+ * ends of each axis hold the transform of exactly zero and exactly the maximum. */
+TEST(imbuf_colormanagement_lut, log_shaper_clamping)
+{
+  const ColorLUT3D lut = bake(ColorLUT3D::Shaper::Log, [](const float3 &color) { return color; });
+
+  const float max = ColorLUT3D::log_shaper_max;
+  EXPECT_V3_NEAR(lut.evaluate(float3(0.0f)), float3(0.0f), 1e-6f);
+  EXPECT_V3_NEAR(lut.evaluate(float3(max)), float3(max), max * 1e-5f);
+
+  /* Negative inputs, including tiny ones, evaluate to the transform of zero. */
+  for (const float value : {-1e-30f, -1e-6f, -0.5f, -1.0f, -max, -1e30f, -INFINITY}) {
+    EXPECT_EQ(lut.evaluate(float3(value)), lut.evaluate(float3(0.0f))) << value;
+  }
+
+  /* Inputs above the maximum evaluate to the transform of the maximum. */
+  for (const float value : {std::nextafter(max, INFINITY), 1025.0f, 2048.0f, 1e30f, INFINITY}) {
+    EXPECT_EQ(lut.evaluate(float3(value)), lut.evaluate(float3(max))) << value;
+  }
+
+  /* Channels are clamped independently, values in range are only approximately preserved since
+   * the identity is not linear in the shaped space. */
+  const float3 mixed = lut.evaluate(float3(-3.0f, 0.25f, 4096.0f));
+  EXPECT_NEAR(mixed.x, 0.0f, 1e-6f);
+  EXPECT_NEAR(mixed.y, 0.25f, 0.25f * 0.01f);
+  EXPECT_NEAR(mixed.z, max, max * 1e-5f);
+}
+
+class ColorLUT3DOCIOTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    IMB_init();
+  }
+
+  static void TearDownTestSuite()
+  {
+    IMB_exit();
+  }
+};
+
+/* Bakes view transforms of the bundled OCIO configuration and compares the table to OCIO itself
+ * over the range of scene linear values the table is meant for. */
+TEST_F(ColorLUT3DOCIOTest, view_transform_accuracy)
+{
+  const std::string config_path = blender::tests::flags_test_release_dir() +
+                                  "/datafiles/colormanagement/config.ocio";
+  if (!BLI_exists(config_path.c_str())) {
+    GTEST_SKIP() << "OCIO configuration not found at " << config_path;
+  }
+
+  OCIO_ConstConfigRcPtr *config = OCIO_configCreateFromFile(config_path.c_str());
+  if (config == nullptr) {
+    GTEST_SKIP() << "Built without OpenColorIO";
+  }
+
+  for (const char *view : {"Standard", "Filmic", "AgX"}) {
+    OCIO_ConstProcessorRcPtr *processor = OCIO_createDisplayProcessor(
+        config, "scene_linear", view, "sRGB", "", 1.0f, 1.0f, 0.0f, 0.0f, false, false);
+    ASSERT_NE(processor, nullptr) << view;
+    OCIO_ConstCPUProcessorRcPtr *cpu_processor = OCIO_processorGetCPUProcessor(processor);
+
+    const ColorLUT3D lut(
+        ColorLUT3D::default_resolution, ColorLUT3D::Shaper::Log, [&](MutableSpan<float4> colors) {
+          for (float4 &color : colors) {
+            OCIO_cpuProcessorApplyRGBA(cpu_processor, color);
+          }
+        });
+
+    /* The error should be below the quantization error of bytes. */
+    float max_error = 0.0f;
+    for (int r = 0; r < 32; r++) {
+      for (int g = 0; g < 32; g++) {
+        for (int b = 0; b < 32; b++) {
+          /* Logarithmically distributed in [2^-14, 2^10] with irregular offsets. */
+          const float3 color = float3(std::exp2(r * 0.75f - 13.7f),
+                                      std::exp2(g * 0.75f - 13.9f),
+                                      std::exp2(b * 0.75f - 13.3f));
+          float4 expected = float4(color, 1.0f);
+          OCIO_cpuProcessorApplyRGBA(cpu_processor, expected);
+          const float3 result = math::clamp(lut.evaluate(color), 0.0f, 1.0f);
+          max_error = math::max(
+              max_error,
+              math::reduce_max(math::abs(result - math::clamp(expected.xyz(), 0.0f, 1.0f))));
+        }
+      }
+    }
+    EXPECT_LT(max_error, 0.5f / 255.0f) << view;
+
+    OCIO_cpuProcessorRelease(cpu_processor);
+    OCIO_processorRelease(processor);
+  }
+
+  OCIO_configRelease(config);
+}
+
+TEST(imbuf_colormanagement_lut, apply)
+{
+  const ColorLUT3D lut = bake(ColorLUT3D::Shaper::Linear, matrix_transform);
+
+  float pixels[3][4] = {
+      {0.2f, 0.4f, 0.6f, 1.0f},
+      {0.1f, 0.2f, 0.3f, 0.5f},
+      {0.3f, 0.1f, 0.2f, 0.0f},
+  };
+  lut.apply(&pixels[0][0], 3, 4, true);
+
+  /* Opaque and transparent pixels are transformed as is, other pixels are predivided. */
+  const float3 expected_0 = matrix_transform(float3(0.2f, 0.4f, 0.6f));
+  const float3 expected_1 = matrix_transform(float3(0.2f, 0.4f, 0.6f)) * 0.5f;
+  const float3 expected_2 = matrix_transform(float3(0.3f, 0.1f, 0.2f));
+  EXPECT_V3_NEAR(pixels[0], expected_0, 1e-5f);
+  EXPECT_V3_NEAR(pixels[1], expected_1, 1e-5f);
+  EXPECT_V3_NEAR(pixels[2], expected_2, 1e-5f);
+
+  /* Alpha is not changed. */
+  EXPECT_EQ(pixels[0][3], 1.0f);
+  EXPECT_EQ(pixels[1][3], 0.5f);
+  EXPECT_EQ(pixels[2][3], 0.0f);
+
+  float rgb_pixels[2][3] = {{0.5f, 0.25f, 0.75f}, {1.0f, 0.0f, 0.5f}};
+  lut.apply(&rgb_pixels[0][0], 2, 3, false);
+  EXPECT_V3_NEAR(rgb_pixels[0], matrix_transform(float3(0.5f, 0.25f, 0.75f)), 1e-5f);
+  EXPECT_V3_NEAR(rgb_pixels[1], matrix_transform(float3(1.0f, 0.0f, 0.5f)), 1e-5f);
+}
+
+}  // namespace blender::imbuf::tests
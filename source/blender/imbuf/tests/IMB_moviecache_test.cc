@@ -0,0 +1,201 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "MEM_CacheLimiterC-Api.h"
+
+#include "BLI_task.hh"
+
+#include "IMB_imbuf.hh"
+#include "IMB_imbuf_types.hh"
+#include "IMB_moviecache.hh"
+
+namespace blender::imbuf::tests {
+
+static uint frame_hash(const void *key)
+{
+  return uint(*static_cast<const int *>(key));
+}
+
+static bool frame_cmp(const void *a, const void *b)
+{
+  return *static_cast<const int *>(a) != *static_cast<const int *>(b);
+}
+
+static void put_frame(MovieCache *cache, int frame)
+{
+  ImBuf *ibuf = IMB_allocImBuf(64, 64, 32, IB_byte_data);
+  IMB_moviecache_put(cache, &frame, ibuf);
+  IMB_freeImBuf(ibuf);
+}
+
+static bool get_frame(MovieCache *cache, int frame)
+{
+  ImBuf *ibuf = IMB_moviecache_get(cache, &frame, nullptr);
+  if (ibuf) {
+    IMB_freeImBuf(ibuf);
+    return true;
+  }
+  return false;
+}
+
+class MovieCacheTest : public testing::Test {
+ protected:
+  size_t previous_limit_;
+
+  void SetUp() override
+  {
+    previous_limit_ = MEM_CacheLimiter_get_maximum();
+    IMB_moviecache_init();
+  }
+
+  void TearDown() override
+  {
+    IMB_moviecache_destruct();
+    MEM_CacheLimiter_set_maximum(previous_limit_);
+  }
+};
+
+TEST_F(MovieCacheTest, statistics)
+{
+  MEM_CacheLimiter_set_maximum(size_t(1) << 30);
+  MovieCache *cache = IMB_moviecache_create("test statistics", sizeof(int), frame_hash, frame_cmp);
+
+  put_frame(cache, 1);
+  put_frame(cache, 2);
+  EXPECT_TRUE(get_frame(cache, 1));
+  EXPECT_TRUE(get_frame(cache, 2));
+  EXPECT_FALSE(get_frame(cache, 3));
+
+  const MovieCacheStatistics statistics = IMB_moviecache_get_statistics().lookup(
+      "test statistics");
+  EXPECT_EQ(statistics.hits, 2);
+  EXPECT_EQ(statistics.misses, 1);
+  EXPECT_EQ(statistics.evictions, 0);
+  EXPECT_EQ(statistics.items_num, 2);
+  EXPECT_GE(statistics.memory_in_use, 2 * 64 * 64 * 4);
+
+  IMB_moviecache_free(cache);
+  EXPECT_FALSE(IMB_moviecache_get_statistics().contains("test statistics"));
+}
+
+TEST_F(MovieCacheTest, eviction)
+{
+  /* Room for about eight frames. */
+  const int64_t frame_size = 64 * 64 * 4;
+  MEM_CacheLimiter_set_maximum(size_t(IMB_moviecache_get_memory_in_use() + 8 * frame_size + 1024));
+  MovieCache *cache = IMB_moviecache_create("test eviction", sizeof(int), frame_hash, frame_cmp);
+
+  for (int frame = 0; frame < 32; frame++) {
+    put_frame(cache, frame);
+    /* Keep the first frame recently used such that it is not evicted. */
+    EXPECT_TRUE(get_frame(cache, 0));
+  }
+
+  const MovieCacheStatistics statistics = IMB_moviecache_get_statistics().lookup("test eviction");
+  EXPECT_GT(statistics.evictions, 0);
+  EXPECT_LE(statistics.items_num, 9);
+  EXPECT_LE(statistics.memory_in_use, 8 * frame_size + 1024);
+
+  /* The most recently put frame is never evicted. */
+  EXPECT_TRUE(get_frame(cache, 31));
+
+  IMB_moviecache_free(cache);
+}
+
+/* Image buffers might allocate more data after they are put in the cache, which should be
+ * accounted for once they are used again. */
+TEST_F(MovieCacheTest, item_size_update)
+{
+  MEM_CacheLimiter_set_maximum(size_t(1) << 30);
+  MovieCache *cache = IMB_moviecache_create(
+      "test size update", sizeof(int), frame_hash, frame_cmp);
+
+  int frame = 1;
+  ImBuf *ibuf = IMB_allocImBuf(64, 64, 32, IB_byte_data);
+  IMB_moviecache_put(cache, &frame, ibuf);
+  const int64_t initial_size =
+      IMB_moviecache_get_statistics().lookup("test size update").memory_in_use;
+
+  IMB_alloc_float_pixels(ibuf, 4);
+  EXPECT_TRUE(get_frame(cache, frame));
+  const int64_t updated_size =
+      IMB_moviecache_get_statistics().lookup("test size update").memory_in_use;
+  EXPECT_GE(updated_size, initial_size + 64 * 64 * 4 * int64_t(sizeof(float)));
+
+  IMB_freeImBuf(ibuf);
+  IMB_moviecache_free(cache);
+}
+
+/* Items that grow without being used again are accounted for once the memory in use gets close
+ * to the limit. */
+TEST_F(MovieCacheTest, item_size_update_near_limit)
+{
+  /* Room for about sixteen frames, twelve of which are put before the first frame grows. */
+  const int64_t frame_size = 64 * 64 * 4;
+  const int64_t limit = IMB_moviecache_get_memory_in_use() + 16 * frame_size + 1024;
+  MEM_CacheLimiter_set_maximum(size_t(limit));
+  MovieCache *cache = IMB_moviecache_create(
+      "test size update near limit", sizeof(int), frame_hash, frame_cmp);
+
+  int frame = 0;
+  ImBuf *ibuf = IMB_allocImBuf(64, 64, 32, IB_byte_data);
+  IMB_moviecache_put(cache, &frame, ibuf);
+  for (frame = 1; frame < 12; frame++) {
+    put_frame(cache, frame);
+  }
+  EXPECT_EQ(IMB_moviecache_get_statistics().lookup("test size update near limit").evictions, 0);
+
+  /* Grows the first frame by the size of four byte frames, which exceeds the limit once another
+   * frame is put. */
+  IMB_alloc_float_pixels(ibuf, 4);
+  put_frame(cache, 12);
+
+  const MovieCacheStatistics statistics = IMB_moviecache_get_statistics().lookup(
+      "test size update near limit");
+  EXPECT_GT(statistics.evictions, 0);
+  EXPECT_LE(IMB_moviecache_get_memory_in_use(), limit);
+  /* The first frame is the least recently used one. */
+  EXPECT_FALSE(get_frame(cache, 0));
+
+  IMB_freeImBuf(ibuf);
+  IMB_moviecache_free(cache);
+}
+
+TEST_F(MovieCacheTest, concurrent_access)
+{
+  const int64_t frame_size = 64 * 64 * 4;
+  MEM_CacheLimiter_set_maximum(
+      size_t(IMB_moviecache_get_memory_in_use() + 64 * frame_size + 1024));
+
+  /* Each thread uses its own cache, like different images or movie clips, while all caches share
+   * the same memory limit. */
+  const int caches_num = 8;
+  MovieCache *caches[caches_num];
+  for (int i = 0; i < caches_num; i++) {
+    caches[i] = IMB_moviecache_create("test concurrent", sizeof(int), frame_hash, frame_cmp);
+  }
+
+  threading::parallel_for(IndexRange(caches_num), 1, [&](const IndexRange range) {
+    for (const int i : range) {
+      for (int frame = 0; frame < 100; frame++) {
+        put_frame(caches[i], frame);
+        get_frame(caches[i], frame / 2);
+      }
+    }
+  });
+
+  const MovieCacheStatistics statistics = IMB_moviecache_get_statistics().lookup(
+      "test concurrent");
+  EXPECT_EQ(statistics.hits + statistics.misses, caches_num * 100);
+  EXPECT_GT(statistics.evictions, 0);
+  EXPECT_LE(statistics.memory_in_use, 64 * frame_size + 1024);
+
+  for (int i = 0; i < caches_num; i++) {
+    IMB_moviecache_free(caches[i]);
+  }
+}
+
+}  // namespace blender::imbuf::tests
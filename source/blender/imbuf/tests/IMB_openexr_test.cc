@@ -0,0 +1,104 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <string>
+
+#include "BLI_array.hh"
+#include "BLI_fileops.h"
+
+#include "DNA_scene_types.h"
+
+#include "IMB_openexr.hh"
+
+namespace blender::imbuf::tests {
+
+static constexpr int width = 64;
+static constexpr int height = 48;
+
+/* Writes a multi-layer EXR file with a color pass using the given codec and a depth pass using the
+ * given data codec, then checks that the pixels of both passes are read back. */
+static void test_write_and_read(const std::string &filepath,
+                                const int codec,
+                                const int data_codec,
+                                const float color_threshold)
+{
+  Array<float> color(int64_t(width) * height * 4);
+  Array<float> depth(int64_t(width) * height);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      const int64_t i = int64_t(y) * width + x;
+      color[i * 4 + 0] = float(x) / width;
+      color[i * 4 + 1] = float(y) / height;
+      color[i * 4 + 2] = 0.5f;
+      color[i * 4 + 3] = 1.0f;
+      depth[i] = 10.0f + float(x * 7 + y * 13) * 0.0123f;
+    }
+  }
+
+  void *write_handle = IMB_exr_get_handle();
+  for (int i = 0; i < 4; i++) {
+    const char passname[] = {"RGBA"[i], '\0'};
+    IMB_exr_add_channel(write_handle,
+                        "Layer",
+                        (std::string("Combined.") + passname).c_str(),
+                        "",
+                        4,
+                        4 * width,
+                        color.data() + i,
+                        true);
+  }
+  IMB_exr_add_channel(
+      write_handle, "Layer", "Depth.Z", "", 1, width, depth.data(), false, data_codec);
+
+  ASSERT_TRUE(
+      IMB_exr_begin_write(write_handle, filepath.c_str(), width, height, codec, 90, nullptr));
+  IMB_exr_write_channels(write_handle);
+  IMB_exr_close(write_handle);
+
+  void *read_handle = IMB_exr_get_handle();
+  int read_width, read_height;
+  ASSERT_TRUE(IMB_exr_begin_read(read_handle, filepath.c_str(), &read_width, &read_height, true));
+  EXPECT_EQ(read_width, width);
+  EXPECT_EQ(read_height, height);
+  EXPECT_TRUE(IMB_exr_has_multilayer(read_handle));
+  IMB_exr_read_channels(read_handle);
+
+  const float *read_red = IMB_exr_channel_rect(read_handle, "Layer", "Combined.R", "");
+  const float *read_green = IMB_exr_channel_rect(read_handle, "Layer", "Combined.G", "");
+  const float *read_depth = IMB_exr_channel_rect(read_handle, "Layer", "Depth.Z", "");
+  ASSERT_NE(read_red, nullptr);
+  ASSERT_NE(read_green, nullptr);
+  ASSERT_NE(read_depth, nullptr);
+
+  for (int64_t i = 0; i < int64_t(width) * height; i++) {
+    EXPECT_NEAR(read_red[i * 4], color[i * 4 + 0], color_threshold);
+    EXPECT_NEAR(read_green[i * 4], color[i * 4 + 1], color_threshold);
+    /* Depth is always written with a lossless codec. */
+    EXPECT_EQ(read_depth[i], depth[i]);
+  }
+
+  IMB_exr_close(read_handle);
+  BLI_delete(filepath.c_str(), false, false);
+}
+
+TEST(imbuf_openexr, write_single_part)
+{
+  test_write_and_read(testing::TempDir() + "imbuf_openexr_single_part.exr",
+                      R_IMF_EXR_CODEC_ZIP,
+                      R_IMF_EXR_CODEC_ZIP,
+                      1e-3f);
+}
+
+TEST(imbuf_openexr, write_part_per_pass)
+{
+  /* The color pass is compressed lossy, which needs its own part. */
+  test_write_and_read(testing::TempDir() + "imbuf_openexr_part_per_pass.exr",
+                      R_IMF_EXR_CODEC_DWAA,
+                      R_IMF_EXR_CODEC_ZIP,
+                      2e-2f);
+}
+
+}  // namespace blender::imbuf::tests
@@ -0,0 +1,71 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include <cmath>
+#include <optional>
+
+#include "IMB_colormanagement_lut.hh"
+
+#include "BLI_array.hh"
+#include "BLI_math_base.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_timeit.hh"
+
+using namespace blender;
+using namespace blender::imbuf;
+
+static constexpr int SIZE_X = 3840;
+static constexpr int SIZE_Y = 2160;
+
+/* A view transform like function, a tone curve followed by the sRGB transfer function. */
+static void display_transform(float4 &color)
+{
+  for (int i = 0; i < 3; i++) {
+    const float value = math::max(color[i], 0.0f);
+    const float tone_mapped = value / (value + 0.6f);
+    color[i] = tone_mapped <= 0.0031308f ? tone_mapped * 12.92f :
+                                           1.055f * std::pow(tone_mapped, 1.0f / 2.4f) - 0.055f;
+  }
+}
+
+static Array<float4> create_src_image()
+{
+  Array<float4> pixels(int64_t(SIZE_X) * SIZE_Y);
+  for (int64_t i = 0; i < pixels.size(); i++) {
+    pixels[i] = float4(
+        math::mod(i * 0.0001f, 16.0f), math::mod(i * 0.001f, 1.0f), (i % 7919) * 0.001f, 1.0f);
+  }
+  return pixels;
+}
+
+TEST(imbuf_colormanagement_lut, lut_perf)
+{
+  Array<float4> exact_pixels = create_src_image();
+  Array<float4> lut_pixels = exact_pixels;
+
+  {
+    SCOPED_TIMER("exact");
+    for (float4 &pixel : exact_pixels) {
+      display_transform(pixel);
+    }
+  }
+
+  std::optional<ColorLUT3D> lut;
+  {
+    SCOPED_TIMER("bake");
+    lut.emplace(
+        ColorLUT3D::default_resolution, ColorLUT3D::Shaper::Log, [&](MutableSpan<float4> colors) {
+          for (float4 &color : colors) {
+            display_transform(color);
+          }
+        });
+  }
+
+  {
+    SCOPED_TIMER("lut");
+    lut->apply(&lut_pixels.first().x, lut_pixels.size(), 4, false);
+  }
+}
@@ -0,0 +1,107 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <string>
+
+#include "BLI_fileops.h"
+#include "BLI_timeit.hh"
+
+#include "IMB_imbuf.hh"
+#include "IMB_imbuf_types.hh"
+
+#include "MOV_read.hh"
+
+#include "movie_test_clip.hh"
+
+extern "C" {
+#include <libavutil/log.h>
+}
+
+using namespace blender;
+
+static constexpr int2 CLIP_SIZE = int2(1920, 1080);
+static constexpr int CLIP_FRAMES = 48;
+
+/* Decodes all frames of the movie in order, like playback does, which lets the reader decode
+ * ahead of time. Each frame is also read once, which gives decoding ahead something to overlap
+ * with. */
+static void decode_frames(MovieReader *anim)
+{
+  uint64_t checksum = 0;
+  for (int position = 0; position < CLIP_FRAMES; position++) {
+    ImBuf *ibuf = MOV_decode_frame(anim, position, IMB_TC_NONE, IMB_PROXY_NONE);
+    ASSERT_NE(ibuf, nullptr);
+    const int64_t values_num = int64_t(ibuf->x) * ibuf->y * 4;
+    if (ibuf->byte_buffer.data) {
+      for (int64_t i = 0; i < values_num; i++) {
+        checksum += ibuf->byte_buffer.data[i];
+      }
+    }
+    if (ibuf->float_buffer.data) {
+      for (int64_t i = 0; i < values_num; i++) {
+        checksum += uint64_t(ibuf->float_buffer.data[i] * 255.0f);
+      }
+    }
+    IMB_freeImBuf(ibuf);
+  }
+  EXPECT_NE(checksum, 0);
+}
+
+static void decode_perf(const char *name,
+                        const char *codec_name,
+                        const AVPixelFormat pixel_format,
+                        const char *profile)
+{
+  av_log_set_level(AV_LOG_QUIET);
+
+  const std::string filepath = testing::TempDir() + "movie_read_performance_" + name + ".mov";
+  if (!imbuf::tests::encode_test_clip(
+          filepath, codec_name, pixel_format, profile, CLIP_SIZE, CLIP_FRAMES))
+  {
+    BLI_delete(filepath.c_str(), false, false);
+    GTEST_SKIP() << "Encoder " << codec_name << " is not available";
+  }
+
+  char colorspace[IM_MAX_SPACE] = "";
+  MovieReader *anim = MOV_open_file(filepath.c_str(), 0, 0, colorspace);
+  ASSERT_NE(anim, nullptr);
+
+  {
+    SCOPED_TIMER(name);
+    decode_frames(anim);
+  }
+
+  MOV_close(anim);
+  BLI_delete(filepath.c_str(), false, false);
+}
+
+class MovieReadPerformanceTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite()
+  {
+    IMB_init();
+  }
+
+  static void TearDownTestSuite()
+  {
+    IMB_exit();
+  }
+};
+
+TEST_F(MovieReadPerformanceTest, decode_prores_perf)
+{
+  decode_perf("prores_1080p_48_frames", "prores_ks", AV_PIX_FMT_YUV422P10LE, "hq");
+}
+
+TEST_F(MovieReadPerformanceTest, decode_h264_perf)
+{
+  decode_perf("h264_1080p_48_frames", "libx264", AV_PIX_FMT_YUV420P, nullptr);
+}
+
+TEST_F(MovieReadPerformanceTest, decode_dnxhr_perf)
+{
+  decode_perf("dnxhr_1080p_48_frames", "dnxhd", AV_PIX_FMT_YUV422P, "dnxhr_hq");
+}
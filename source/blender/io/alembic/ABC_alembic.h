@@ -52,6 +52,8 @@ struct AlembicExportParams {
   bool export_custom_properties;
   bool use_instancing;
   enum eEvaluationMode evaluation_mode;
+  /* Number of frames that are evaluated in parallel, each with its own dependency graph. */
+  int parallel_frames = 1;
 
   /* See MOD_TRIANGULATE_NGON_xxx and MOD_TRIANGULATE_QUAD_xxx
    * in DNA_modifier_types.h */
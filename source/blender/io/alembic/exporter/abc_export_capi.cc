@@ -11,6 +11,7 @@
 
 #include "DEG_depsgraph.hh"
 #include "DEG_depsgraph_build.hh"
+#include "DEG_depsgraph_parallel_frames.hh"
 #include "DEG_depsgraph_query.hh"
 
 #include "DNA_scene_types.h"
@@ -25,6 +26,7 @@
 #include "BLI_path_utils.hh"
 #include "BLI_string.h"
 #include "BLI_timeit.hh"
+#include "BLI_vector.hh"
 
 #include "WM_api.hh"
 #include "WM_types.hh"
@@ -37,6 +39,8 @@ static CLG_LogRef LOG = {"io.alembic"};
 struct ExportJobData {
   Main *bmain = nullptr;
   Depsgraph *depsgraph = nullptr;
+  /* Additional dependency graphs to evaluate animation frames in parallel with #depsgraph. */
+  blender::Vector<Depsgraph *> parallel_depsgraphs;
   wmWindowManager *wm = nullptr;
 
   char filepath[FILE_MAX] = {};
@@ -50,7 +54,7 @@ struct ExportJobData {
 namespace blender::io::alembic {
 
 /* Construct the depsgraph for exporting. */
-static bool build_depsgraph(ExportJobData *job)
+static bool build_depsgraph(ExportJobData *job, Depsgraph *depsgraph)
 {
   if (job->params.collection[0]) {
     Collection *collection = reinterpret_cast<Collection *>(
@@ -61,13 +65,13 @@ static bool build_depsgraph(ExportJobData *job)
       return false;
     }
 
-    DEG_graph_build_from_collection(job->depsgraph, collection);
+    DEG_graph_build_from_collection(depsgraph, collection);
   }
   else if (job->params.visible_objects_only) {
-    DEG_graph_build_from_view_layer(job->depsgraph);
+    DEG_graph_build_from_view_layer(depsgraph);
   }
   else {
-    DEG_graph_build_for_all_objects(job->depsgraph);
+    DEG_graph_build_for_all_objects(depsgraph);
   }
 
   return true;
@@ -144,6 +148,29 @@ static void export_startjob(void *customdata, wmJobWorkerStatus *worker_status)
     ABCArchive::Frames::const_iterator frame_it = abc_archive->frames_begin();
     const ABCArchive::Frames::const_iterator frames_end = abc_archive->frames_end();
 
+    if (!data->parallel_depsgraphs.is_empty()) {
+      Vector<float> frames;
+      for (; frame_it != frames_end; frame_it++) {
+        frames.append(float(*frame_it));
+      }
+      Vector<Depsgraph *> depsgraphs = {data->depsgraph};
+      depsgraphs.extend(data->parallel_depsgraphs);
+
+      /* The scene frame is not changed, every dependency graph evaluates its own frame. */
+      DEG_evaluate_frames_parallel(depsgraphs, frames, [&](Depsgraph *depsgraph, float frame) {
+        CLOG_INFO(&LOG, 2, "Exporting frame %.2f", frame);
+        iter.set_depsgraph(depsgraph);
+        ExportSubset export_subset = abc_archive->export_subset_for_frame(frame);
+        iter.set_export_subset(export_subset);
+        iter.iterate_and_write();
+
+        worker_status->progress += progress_per_frame;
+        worker_status->do_update = true;
+        return !(G.is_break || worker_status->stop);
+      });
+      iter.set_depsgraph(data->depsgraph);
+    }
+
     for (; frame_it != frames_end; frame_it++) {
       double frame = *frame_it;
 
@@ -189,6 +216,9 @@ static void export_endjob(void *customdata)
   ExportJobData *data = static_cast<ExportJobData *>(customdata);
 
   DEG_graph_free(data->depsgraph);
+  for (Depsgraph *depsgraph : data->parallel_depsgraphs) {
+    DEG_graph_free(depsgraph);
+  }
 
   if (data->was_canceled && BLI_exists(data->filepath)) {
     BLI_delete(data->filepath, false, false);
@@ -223,9 +253,16 @@ bool ABC_export(Scene *scene,
    *
    * Has to be done from main thread currently, as it may affect Main original data (e.g. when
    * doing deferred update of the view-layers, see #112534 for details). */
-  if (!blender::io::alembic::build_depsgraph(job)) {
+  if (!blender::io::alembic::build_depsgraph(job, job->depsgraph)) {
     return false;
   }
+  if (params->frame_start != params->frame_end) {
+    for (int i = 1; i < params->parallel_frames; i++) {
+      Depsgraph *depsgraph = DEG_graph_new(job->bmain, scene, view_layer, params->evaluation_mode);
+      blender::io::alembic::build_depsgraph(job, depsgraph);
+      job->parallel_depsgraphs.append(depsgraph);
+    }
+  }
 
   bool export_ok = false;
   if (as_background_job) {
@@ -249,6 +249,12 @@ class AbstractHierarchyIterator {
   /* Release all writers. Call after all frames have been exported. */
   void release_writers();
 
+  Depsgraph *depsgraph() const;
+  /* Use a different dependency graph for the next iterations. It has to be built for the same
+   * scene and objects. This is used when frames are evaluated by multiple dependency graphs in
+   * parallel, see #DEG_evaluate_frames_parallel. */
+  void set_depsgraph(Depsgraph *depsgraph);
+
   /* Determine which subset of writers is used for exporting.
    * Set this before calling iterate_and_write().
    *
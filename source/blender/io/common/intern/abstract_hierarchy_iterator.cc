@@ -189,6 +189,16 @@ void AbstractHierarchyIterator::release_writers()
   writers_.clear();
 }
 
+Depsgraph *AbstractHierarchyIterator::depsgraph() const
+{
+  return depsgraph_;
+}
+
+void AbstractHierarchyIterator::set_depsgraph(Depsgraph *depsgraph)
+{
+  depsgraph_ = depsgraph;
+}
+
 void AbstractHierarchyIterator::set_export_subset(ExportSubset export_subset)
 {
   export_subset_ = export_subset;
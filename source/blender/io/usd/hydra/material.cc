@@ -63,8 +63,10 @@ void MaterialData::init()
   export_params.export_textures = false; /* Don't copy all textures, is slow. */
   export_params.evaluation_mode = DEG_get_mode(scene_delegate_->depsgraph);
 
+  Depsgraph *depsgraph = scene_delegate_->depsgraph;
+  auto get_depsgraph = [depsgraph]() { return depsgraph; };
   usd::USDExporterContext export_context{scene_delegate_->bmain,
-                                         scene_delegate_->depsgraph,
+                                         get_depsgraph,
                                          stage,
                                          material_library_path,
                                          get_time_code,
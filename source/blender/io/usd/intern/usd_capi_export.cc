@@ -27,6 +27,7 @@
 
 #include "DEG_depsgraph.hh"
 #include "DEG_depsgraph_build.hh"
+#include "DEG_depsgraph_parallel_frames.hh"
 #include "DEG_depsgraph_query.hh"
 
 #include "DNA_collection_types.h"
@@ -49,6 +50,7 @@
 #include "BLI_path_utils.hh"
 #include "BLI_string.h"
 #include "BLI_timeit.hh"
+#include "BLI_vector.hh"
 
 #include <IMB_imbuf.hh>
 #include <IMB_imbuf_types.hh>
@@ -64,6 +66,8 @@ namespace blender::io::usd {
 struct ExportJobData {
   Main *bmain = nullptr;
   Depsgraph *depsgraph = nullptr;
+  /* Additional dependency graphs to evaluate animation frames in parallel with #depsgraph. */
+  Vector<Depsgraph *> parallel_depsgraphs;
   wmWindowManager *wm = nullptr;
   Scene *scene = nullptr;
 
@@ -388,7 +392,8 @@ std::string cache_image_color(const float color[4])
 
 pxr::UsdStageRefPtr export_to_stage(const USDExportParams &params,
                                     Depsgraph *depsgraph,
-                                    const char *filepath)
+                                    const char *filepath,
+                                    const Span<Depsgraph *> parallel_depsgraphs)
 {
   pxr::UsdStageRefPtr usd_stage = pxr::UsdStage::CreateNew(filepath);
   if (!usd_stage) {
@@ -452,7 +457,35 @@ pxr::UsdStageRefPtr export_to_stage(const USDExportParams &params,
   worker_status->progress = 0.11f;
   worker_status->do_update = true;
 
-  if (params.export_animation) {
+  if (params.export_animation && !parallel_depsgraphs.is_empty()) {
+    float progress_per_frame = 0.75f / std::max(1, (scene->r.efra - scene->r.sfra + 1));
+
+    Vector<float> frames;
+    for (float frame = scene->r.sfra; frame <= scene->r.efra; frame++) {
+      frames.append(frame);
+    }
+    Vector<Depsgraph *> depsgraphs = {depsgraph};
+    depsgraphs.extend(parallel_depsgraphs);
+
+    /* The scene frame is not changed, every dependency graph evaluates its own frame. */
+    DEG_evaluate_frames_parallel(depsgraphs, frames, [&](Depsgraph *frame_depsgraph, float frame) {
+      iter.set_depsgraph(frame_depsgraph);
+      iter.set_export_frame(frame);
+      iter.iterate_and_write();
+
+      worker_status->progress += progress_per_frame;
+      worker_status->do_update = true;
+      return !(G.is_break || worker_status->stop);
+    });
+    iter.set_depsgraph(depsgraph);
+
+    /* Leave the dependency graph in the same state as the sequential export does, the skeleton
+     * processing and export hooks below use the last frame. */
+    scene->r.cfra = scene->r.efra;
+    scene->r.subframe = 0.0f;
+    BKE_scene_graph_update_for_newframe(depsgraph);
+  }
+  else if (params.export_animation) {
     /* Writing the animated frames is not 100% of the work, here it's assumed to be 75% of it. */
     float progress_per_frame = 0.75f / std::max(1, (scene->r.efra - scene->r.sfra + 1));
 
@@ -554,7 +587,7 @@ static void export_startjob(void *customdata, wmJobWorkerStatus *worker_status)
   data->params.worker_status = worker_status;
 
   pxr::UsdStageRefPtr usd_stage = export_to_stage(
-      data->params, data->depsgraph, data->unarchived_filepath);
+      data->params, data->depsgraph, data->unarchived_filepath, data->parallel_depsgraphs);
   if (!usd_stage) {
     /* This happens when the USD JSON files cannot be found. When that happens,
      * the USD library doesn't know it has the functionality to write USDA and
@@ -596,6 +629,9 @@ static void export_endjob(void *customdata)
   ExportJobData *data = static_cast<ExportJobData *>(customdata);
 
   DEG_graph_free(data->depsgraph);
+  for (Depsgraph *depsgraph : data->parallel_depsgraphs) {
+    DEG_graph_free(depsgraph);
+  }
 
   if (data->targets_usdz()) {
     /* NOTE: call to #perform_usdz_conversion has to be done here instead of the main threaded
@@ -644,6 +680,32 @@ static void create_temp_path_for_usdz_export(const char *filepath,
   STRNCPY(job->usdz_filepath, filepath);
 }
 
+/* Construct a depsgraph for exporting. */
+static bool build_depsgraph(blender::io::usd::ExportJobData *job, Depsgraph *depsgraph)
+{
+  if (job->params.collection[0]) {
+    Collection *collection = reinterpret_cast<Collection *>(
+        BKE_libblock_find_name(job->bmain, ID_GR, job->params.collection));
+    if (!collection) {
+      BKE_reportf(job->params.worker_status->reports,
+                  RPT_ERROR,
+                  "USD Export: Unable to find collection '%s'",
+                  job->params.collection);
+      return false;
+    }
+
+    DEG_graph_build_from_collection(depsgraph, collection);
+  }
+  else if (job->params.visible_objects_only) {
+    DEG_graph_build_from_view_layer(depsgraph);
+  }
+  else {
+    DEG_graph_build_for_all_objects(depsgraph);
+  }
+
+  return true;
+}
+
 static void set_job_filepath(blender::io::usd::ExportJobData *job, const char *filepath)
 {
   if (BLI_path_extension_check_n(filepath, ".usdz", nullptr)) {
@@ -683,24 +745,15 @@ bool USD_export(const bContext *C,
    *
    * Has to be done from main thread currently, as it may affect Main original data (e.g. when
    * doing deferred update of the view-layers, see #112534 for details). */
-  if (job->params.collection[0]) {
-    Collection *collection = reinterpret_cast<Collection *>(
-        BKE_libblock_find_name(job->bmain, ID_GR, job->params.collection));
-    if (!collection) {
-      BKE_reportf(job->params.worker_status->reports,
-                  RPT_ERROR,
-                  "USD Export: Unable to find collection '%s'",
-                  job->params.collection);
-      return false;
-    }
-
-    DEG_graph_build_from_collection(job->depsgraph, collection);
-  }
-  else if (job->params.visible_objects_only) {
-    DEG_graph_build_from_view_layer(job->depsgraph);
+  if (!build_depsgraph(job, job->depsgraph)) {
+    return false;
   }
-  else {
-    DEG_graph_build_for_all_objects(job->depsgraph);
+  if (params->export_animation) {
+    for (int i = 1; i < params->parallel_frames; i++) {
+      Depsgraph *depsgraph = DEG_graph_new(job->bmain, scene, view_layer, params->evaluation_mode);
+      build_depsgraph(job, depsgraph);
+      job->parallel_depsgraphs.append(depsgraph);
+    }
   }
 
   bool export_ok = false;
@@ -22,7 +22,12 @@ class USDHierarchyIterator;
 
 struct USDExporterContext {
   Main *bmain;
-  Depsgraph *depsgraph;
+  /**
+   * Wrap a function which returns the dependency graph that contains the evaluated data of the
+   * current frame. This is necessary since different frames of an animation may be evaluated by
+   * different dependency graphs.
+   */
+  std::function<Depsgraph *()> get_depsgraph;
   const pxr::UsdStageRefPtr stage;
   const pxr::SdfPath usd_path;
   /**
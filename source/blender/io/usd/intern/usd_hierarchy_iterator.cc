@@ -129,10 +129,11 @@ USDExporterContext USDHierarchyIterator::create_usd_export_context(const Hierarc
    * `pxr::UsdStage::CreateNew` function). */
   const pxr::SdfLayerHandle root_layer = stage_->GetRootLayer();
   const std::string export_file_path = root_layer->GetRealPath();
+  auto get_depsgraph = [this]() { return this->depsgraph_; };
   auto get_time_code = [this]() { return this->export_time_; };
 
   return USDExporterContext{
-      bmain_, depsgraph_, stage_, path, get_time_code, params_, export_file_path};
+      bmain_, get_depsgraph, stage_, path, get_time_code, params_, export_file_path};
 }
 
 AbstractHierarchyWriter *USDHierarchyIterator::create_transform_writer(
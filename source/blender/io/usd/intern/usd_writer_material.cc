@@ -1427,7 +1427,7 @@ static void create_usd_materialx_material(const USDExporterContext &usd_export_c
   };
 
   MaterialX::DocumentPtr doc = blender::nodes::materialx::export_to_materialx(
-      usd_export_context.depsgraph, material, export_params);
+      usd_export_context.get_depsgraph(), material, export_params);
 
   /* We want to merge the MaterialX graph under the same Material as the USDPreviewSurface
    * This allows for the same material assignment to have two levels of complexity so other
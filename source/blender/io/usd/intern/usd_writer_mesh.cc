@@ -174,7 +174,7 @@ void USDGenericMeshWriter::write_custom_data(const Object *obj,
     }
 
     if (usd_export_context_.export_params.export_armatures &&
-        is_armature_modifier_bone_name(*obj, iter.name, usd_export_context_.depsgraph))
+        is_armature_modifier_bone_name(*obj, iter.name, usd_export_context_.get_depsgraph()))
     {
       /* This attribute is likely a vertex group for the armature modifier,
        * and it may conflict with skinning data that will be written to
@@ -717,7 +717,8 @@ void USDMeshWriter::set_skel_export_flags(const HierarchyContext &context)
   /* We can write a skinned mesh if exporting armatures is enabled and the object has an armature
    * modifier. */
   write_skinned_mesh_ = params.export_armatures &&
-                        can_export_skinned_mesh(*context.object, usd_export_context_.depsgraph);
+                        can_export_skinned_mesh(*context.object,
+                                                usd_export_context_.get_depsgraph());
 
   /* We can write blend shapes if exporting shape keys is enabled and the object has shape keys. */
   write_blend_shapes_ = params.export_shapekeys && is_mesh_with_shape_keys(context.object);
@@ -747,7 +748,7 @@ void USDMeshWriter::init_skinned_mesh(const HierarchyContext &context)
   }
 
   const Object *arm_obj = get_armature_modifier_obj(*context.object,
-                                                    usd_export_context_.depsgraph);
+                                                    usd_export_context_.get_depsgraph());
 
   if (!arm_obj) {
     CLOG_WARN(&LOG,
@@ -156,6 +156,9 @@ struct USDExportParams {
 
   eSubdivExportMode export_subdiv = USD_SUBDIV_BEST_MATCH;
   enum eEvaluationMode evaluation_mode = DAG_EVAL_VIEWPORT;
+  /* Number of animation frames that are evaluated in parallel, each with its own dependency
+   * graph. */
+  int parallel_frames = 1;
 
   bool generate_preview_surface = true;
   bool generate_materialx_network = true;
@@ -8,15 +8,22 @@
 
 #include <string>
 
+#include "BLI_span.hh"
+
 #include "usd.hh"
 
 struct Depsgraph;
 
 namespace blender::io::usd {
 
+/**
+ * \param parallel_depsgraphs: Additional dependency graphs, built like \a depsgraph, which are
+ * used to evaluate animation frames in parallel.
+ */
 pxr::UsdStageRefPtr export_to_stage(const USDExportParams &params,
                                     Depsgraph *depsgraph,
-                                    const char *filepath);
+                                    const char *filepath,
+                                    Span<Depsgraph *> parallel_depsgraphs = {});
 
 std::string image_cache_file_path();
 std::string get_image_cache_file(const std::string &file_name, bool mkdir = true);
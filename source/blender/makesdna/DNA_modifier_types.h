@@ -728,6 +728,11 @@ enum {
   /** for dissolve only. collapse all verts between 2 faces */
   MOD_DECIM_FLAG_ALL_BOUNDARY_VERTS = (1 << 2),
   MOD_DECIM_FLAG_SYMMETRY = (1 << 3),
+  /**
+   * For collapse only. Decimate triangles directly on the mesh arrays, in parallel in independent
+   * regions, instead of with BMesh. Not used with symmetry.
+   */
+  MOD_DECIM_FLAG_COLLAPSE_PARALLEL = (1 << 4),
 };
 
 enum {
@@ -427,7 +427,9 @@ typedef struct ImageFormatData {
   /** TIFF. */
   char tiff_codec;
 
-  char _pad[4];
+  /** OpenEXR: R_IMF_EXR_DATA_CODEC_* values, used for passes that don't store colors. */
+  char exr_data_codec;
+  char _pad[3];
 
   /** Multi-view. */
   char views_format;
@@ -530,6 +532,19 @@ enum {
   R_IMF_EXR_CODEC_MAX = 10,
 };
 
+/** #ImageFormatData::exr_data_codec */
+enum {
+  /** Use #ImageFormatData::exr_codec, even if it is lossy. */
+  R_IMF_EXR_DATA_CODEC_SAME = 0,
+  R_IMF_EXR_DATA_CODEC_NONE = 1,
+  R_IMF_EXR_DATA_CODEC_ZIP = 2,
+  R_IMF_EXR_DATA_CODEC_PIZ = 3,
+  R_IMF_EXR_DATA_CODEC_RLE = 4,
+  R_IMF_EXR_DATA_CODEC_ZIPS = 5,
+  /** Use #ImageFormatData::exr_codec if it is lossless, and ZIP otherwise. */
+  R_IMF_EXR_DATA_CODEC_AUTO = 6,
+};
+
 /** #ImageFormatData::jp2_flag */
 enum {
   /** When disabled use RGB. */
@@ -863,6 +878,7 @@ typedef enum eCompositorDevice {
 typedef enum eCompositorPrecision {
   SCE_COMPOSITOR_PRECISION_AUTO = 0,
   SCE_COMPOSITOR_PRECISION_FULL = 1,
+  SCE_COMPOSITOR_PRECISION_HALF = 2,
 } eCompositorPrecision;
 
 /** #RenderData::compositor_denoise_preview_quality */
@@ -2683,6 +2699,7 @@ enum {
   IMAGEPAINT_PROJECT_LAYER_CLONE = 1 << 7,
   IMAGEPAINT_PROJECT_LAYER_STENCIL = 1 << 8,
   IMAGEPAINT_PROJECT_LAYER_STENCIL_INV = 1 << 9,
+  IMAGEPAINT_PROJECT_COVERAGE_CACHE = 1 << 10,
 };
 
 /** #ImagePaintSettings::missing_data */
@@ -766,7 +766,9 @@ typedef struct UserDef_Experimental {
   char use_sculpt_texture_paint;
   char use_new_volume_nodes;
   char use_shader_node_previews;
-  char _pad[6];
+  char use_display_transform_lut;
+  char use_sculpt_bvh_sah;
+  char _pad[4];
 } UserDef_Experimental;
 
 #define USER_EXPERIMENTAL_TEST(userdef, member) \
@@ -995,7 +997,8 @@ typedef struct UserDef {
   int prefetchframes;
   /** Control the rotation step of the view when PAD2, PAD4, PAD6&PAD8 is use. */
   float pad_rot_angle;
-  char _pad12[4];
+  /** Memory limit of compositor node results kept between evaluations, in megabytes. */
+  int compositor_cache_limit;
   /** Rotating view icon size. */
   short rvisize;
   /** Rotating view icon brightness. */
@@ -3098,6 +3098,16 @@ static void rna_def_modifier_decimate(BlenderRNA *brna)
       prop, "Triangulate", "Keep triangulated faces resulting from decimation (collapse only)");
   RNA_def_property_update(prop, 0, "rna_Modifier_update");
 
+  prop = RNA_def_property(srna, "use_collapse_parallel", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "flag", MOD_DECIM_FLAG_COLLAPSE_PARALLEL);
+  RNA_def_property_ui_text(prop,
+                           "Parallel",
+                           "Decimate triangles in parallel in independent regions of the mesh, "
+                           "which is faster on large meshes but gives different results. Only "
+                           "used without symmetry, on triangulated results or triangle meshes "
+                           "(collapse only)");
+  RNA_def_property_update(prop, 0, "rna_Modifier_update");
+
   prop = RNA_def_property(srna, "use_symmetry", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, nullptr, "flag", MOD_DECIM_FLAG_SYMMETRY);
   RNA_def_property_ui_text(prop, "Symmetry", "Maintain symmetry on an axis");
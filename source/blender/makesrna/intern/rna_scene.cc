@@ -6322,6 +6322,48 @@ static void rna_def_scene_image_format_data(BlenderRNA *brna)
   RNA_def_property_enum_funcs(prop, nullptr, nullptr, "rna_ImageFormatSettings_exr_codec_itemf");
   RNA_def_property_ui_text(prop, "Codec", "Compression codec settings for OpenEXR");
   RNA_def_property_update(prop, NC_SCENE | ND_RENDER_OPTIONS, nullptr);
+
+  static const EnumPropertyItem exr_data_codec_items[] = {
+      {R_IMF_EXR_DATA_CODEC_SAME,
+       "SAME",
+       0,
+       "Same as Codec",
+       "Use the codec of color passes, even if it is lossy"},
+      {R_IMF_EXR_DATA_CODEC_AUTO,
+       "AUTO",
+       0,
+       "Lossless",
+       "Use the codec of color passes if it is lossless, and ZIP otherwise"},
+      {R_IMF_EXR_DATA_CODEC_NONE, "NONE", 0, "None", "No compression"},
+      {R_IMF_EXR_DATA_CODEC_ZIP,
+       "ZIP",
+       0,
+       "ZIP",
+       "Lossless zip compression of 16 row image blocks"},
+      {R_IMF_EXR_DATA_CODEC_PIZ,
+       "PIZ",
+       0,
+       "PIZ",
+       "Lossless wavelet compression, effective for noisy/grainy images"},
+      {R_IMF_EXR_DATA_CODEC_ZIPS,
+       "ZIPS",
+       0,
+       "ZIPS",
+       "Lossless zip compression, each image row compressed separately"},
+      {R_IMF_EXR_DATA_CODEC_RLE, "RLE", 0, "RLE", "Lossless run length encoding compression"},
+      {0, nullptr, 0, nullptr, nullptr},
+  };
+
+  prop = RNA_def_property(srna, "exr_data_codec", PROP_ENUM, PROP_NONE);
+  RNA_def_property_enum_sdna(prop, nullptr, "exr_data_codec");
+  RNA_def_property_enum_items(prop, exr_data_codec_items);
+  RNA_def_property_ui_text(prop,
+                           "Data Codec",
+                           "Compression codec for passes that don't store colors, like depth, "
+                           "normals or Cryptomatte, in multi-layer OpenEXR files. Passes that use "
+                           "a different codec than color passes are written to separate parts of "
+                           "the file");
+  RNA_def_property_update(prop, NC_SCENE | ND_RENDER_OPTIONS, nullptr);
 #  endif
 
 #  ifdef WITH_OPENJPEG
@@ -6814,8 +6856,13 @@ static void rna_def_scene_render_data(BlenderRNA *brna)
        "AUTO",
        0,
        "Auto",
-       "Full precision for final renders, half precision otherwise"},
+       "Full precision for final renders and on the CPU, half precision otherwise"},
       {SCE_COMPOSITOR_PRECISION_FULL, "FULL", 0, "Full", "Full precision"},
+      {SCE_COMPOSITOR_PRECISION_HALF,
+       "HALF",
+       0,
+       "Half",
+       "Half precision, which halves the memory usage of images at the cost of precision"},
       {0, nullptr, 0, nullptr, nullptr},
   };
 
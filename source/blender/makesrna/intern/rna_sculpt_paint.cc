@@ -1117,6 +1117,14 @@ static void rna_def_image_paint(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Cull", "Ignore faces pointing away from the view (faster)");
   RNA_def_property_update(prop, NC_SCENE | ND_TOOLSETTINGS, nullptr);
 
+  prop = RNA_def_property(srna, "use_coverage_cache", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "flag", IMAGEPAINT_PROJECT_COVERAGE_CACHE);
+  RNA_def_property_ui_text(prop,
+                           "Cache Coverage",
+                           "Keep the pixels under the brush between strokes while the view and "
+                           "the mesh don't change, to start painting faster (uses more memory)");
+  RNA_def_property_update(prop, NC_SCENE | ND_TOOLSETTINGS, nullptr);
+
   prop = RNA_def_property(srna, "use_normal_falloff", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_negative_sdna(prop, nullptr, "flag", IMAGEPAINT_PROJECT_FLAT);
   RNA_def_property_ui_text(prop, "Normal", "Paint most on faces pointing towards the view");
@@ -308,6 +308,44 @@ static void rna_SequenceEditor_update_cache(Main * /*bmain*/, Scene *scene, Poin
   blender::seq::cache_cleanup(scene);
 }
 
+static int rna_SequenceEditor_cache_statistic_clamp(const int64_t value)
+{
+  return int(std::min<int64_t>(value, INT_MAX));
+}
+
+static int rna_SequenceEditor_cache_hits_get(PointerRNA *ptr)
+{
+  Scene *scene = (Scene *)ptr->owner_id;
+  return rna_SequenceEditor_cache_statistic_clamp(blender::seq::cache_statistics_get(scene).hits);
+}
+
+static int rna_SequenceEditor_cache_misses_get(PointerRNA *ptr)
+{
+  Scene *scene = (Scene *)ptr->owner_id;
+  return rna_SequenceEditor_cache_statistic_clamp(
+      blender::seq::cache_statistics_get(scene).misses);
+}
+
+static int rna_SequenceEditor_cache_evictions_get(PointerRNA *ptr)
+{
+  Scene *scene = (Scene *)ptr->owner_id;
+  return rna_SequenceEditor_cache_statistic_clamp(
+      blender::seq::cache_statistics_get(scene).evictions);
+}
+
+static int rna_SequenceEditor_cache_items_get(PointerRNA *ptr)
+{
+  Scene *scene = (Scene *)ptr->owner_id;
+  return rna_SequenceEditor_cache_statistic_clamp(
+      blender::seq::cache_statistics_get(scene).items_num);
+}
+
+static float rna_SequenceEditor_cache_memory_get(PointerRNA *ptr)
+{
+  Scene *scene = (Scene *)ptr->owner_id;
+  return float(blender::seq::cache_statistics_get(scene).memory_in_use) / (1024.0f * 1024.0f);
+}
+
 /* internal use */
 static int rna_Strip_elements_length(PointerRNA *ptr)
 {
@@ -2540,6 +2578,41 @@ static void rna_def_editor(BlenderRNA *brna)
       "Render frames ahead of current frame in the background for faster playback");
   RNA_def_property_update(prop, NC_SCENE | ND_SEQUENCER, nullptr);
 
+  /* cache statistics */
+
+  prop = RNA_def_property(srna, "cache_hits", PROP_INT, PROP_NONE);
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_int_funcs(prop, "rna_SequenceEditor_cache_hits_get", nullptr, nullptr);
+  RNA_def_property_ui_text(
+      prop, "Cache Hits", "Number of images that were found in the cache since it was created");
+
+  prop = RNA_def_property(srna, "cache_misses", PROP_INT, PROP_NONE);
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_int_funcs(prop, "rna_SequenceEditor_cache_misses_get", nullptr, nullptr);
+  RNA_def_property_ui_text(prop,
+                           "Cache Misses",
+                           "Number of images that were not found in the cache since it was "
+                           "created");
+
+  prop = RNA_def_property(srna, "cache_evictions", PROP_INT, PROP_NONE);
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_int_funcs(prop, "rna_SequenceEditor_cache_evictions_get", nullptr, nullptr);
+  RNA_def_property_ui_text(prop,
+                           "Cache Evictions",
+                           "Number of images that were removed from the cache to stay below "
+                           "the memory cache limit");
+
+  prop = RNA_def_property(srna, "cache_items", PROP_INT, PROP_NONE);
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_int_funcs(prop, "rna_SequenceEditor_cache_items_get", nullptr, nullptr);
+  RNA_def_property_ui_text(prop, "Cache Items", "Number of images in the cache");
+
+  prop = RNA_def_property(srna, "cache_memory", PROP_FLOAT, PROP_NONE);
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_float_funcs(prop, "rna_SequenceEditor_cache_memory_get", nullptr, nullptr);
+  RNA_def_property_ui_text(
+      prop, "Cache Memory", "Memory in megabytes used by the images in the cache");
+
   /* functions */
 
   func = RNA_def_function(srna, "display_stack", "rna_SequenceEditor_display_stack");
@@ -30,6 +30,7 @@
 
 #include "DEG_depsgraph_query.hh"
 
+#include "GEO_mesh_decimate.hh"
 #include "GEO_randomize.hh"
 
 #include "bmesh.hh"
@@ -158,6 +159,31 @@ static Mesh *modify_mesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh
     }
   }
 
+  if (dmd->mode == MOD_DECIM_MODE_COLLAPSE && (dmd->flag & MOD_DECIM_FLAG_COLLAPSE_PARALLEL) &&
+      !(dmd->flag & MOD_DECIM_FLAG_SYMMETRY) &&
+      ((dmd->flag & MOD_DECIM_FLAG_TRIANGULATE) || mesh->corners_num == mesh->faces_num * 3))
+  {
+    /* Decimate the mesh directly, without the conversion to BMesh. Only the BMesh implementation
+     * supports symmetry, and joining triangles back into quads. The results differ from the BMesh
+     * implementation, so this is only used when enabled explicitly. */
+    const std::optional<Mesh *> decimated = blender::geometry::mesh_decimate_collapse(
+        *mesh,
+        dmd->percent,
+        vweights ? blender::Span<float>(vweights, mesh->verts_num) : blender::Span<float>(),
+        dmd->defgrp_factor,
+        {});
+    if (vweights) {
+      MEM_freeN(vweights);
+    }
+    if (!decimated) {
+      return mesh;
+    }
+    result = *decimated;
+    updateFaceCount(ctx, dmd, result->faces_num);
+    blender::geometry::debug_randomize_mesh_order(result);
+    return result;
+  }
+
   BMeshCreateParams create_params{};
   BMeshFromMeshParams convert_params{};
   convert_params.calc_face_normal = calc_face_normal;
@@ -245,6 +271,9 @@ static void panel_draw(const bContext * /*C*/, Panel *panel)
     uiItemDecoratorR(row, ptr, "symmetry_axis", 0);
 
     uiItemR(layout, ptr, "use_collapse_triangulate", UI_ITEM_NONE, std::nullopt, ICON_NONE);
+    sub = uiLayoutRow(layout, true);
+    uiLayoutSetActive(sub, !RNA_boolean_get(ptr, "use_symmetry"));
+    uiItemR(sub, ptr, "use_collapse_parallel", UI_ITEM_NONE, std::nullopt, ICON_NONE);
 
     modifier_vgroup_ui(layout, ptr, &ob_ptr, "vertex_group", "invert_vertex_group", std::nullopt);
     sub = uiLayoutRow(layout, true);
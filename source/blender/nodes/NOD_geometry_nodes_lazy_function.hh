@@ -39,6 +39,10 @@ struct Object;
 struct Depsgraph;
 struct Scene;
 
+namespace blender::fn::lazy_function {
+class GraphExecutorProfiler;
+}
+
 namespace blender::nodes {
 
 using lf::LazyFunction;
@@ -476,6 +480,19 @@ std::optional<FoundNestedNodeID> find_nested_node_id(const GeoNodesLFUserData &u
 const GeometryNodesLazyFunctionGraphInfo *ensure_geometry_nodes_lazy_function_graph(
     const bNodeTree &btree);
 
+/**
+ * Profiler that records the execution of all geometry nodes lazy-function graphs when Blender was
+ * started with `--profile-geometry-nodes`. Returns null when profiling is disabled.
+ */
+lf::GraphExecutorProfiler *geometry_nodes_profiler();
+
+/**
+ * Print a summary of the recorded profile and write it to `geometry_nodes_profile.json` (Trace
+ * Event Format) and `geometry_nodes_profile.speedscope.json` in the current directory.
+ * Does nothing when no profile has been recorded.
+ */
+void geometry_nodes_profiler_write_and_free();
+
 /**
  * Utility to measure the time that is spend in a specific compute context during geometry nodes
  * evaluation.
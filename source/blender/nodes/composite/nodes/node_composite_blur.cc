@@ -7,6 +7,7 @@
  */
 
 #include "BLI_assert.h"
+#include "BLI_bounds_types.hh"
 #include "BLI_math_base.hh"
 #include "BLI_math_vector.hh"
 #include "BLI_math_vector_types.hh"
@@ -22,6 +23,7 @@
 #include "COM_algorithm_recursive_gaussian_blur.hh"
 #include "COM_algorithm_symmetric_separable_blur.hh"
 #include "COM_node_operation.hh"
+#include "COM_region_of_interest.hh"
 #include "COM_symmetric_blur_weights.hh"
 #include "COM_utilities.hh"
 
@@ -208,7 +210,8 @@ class BlurOperation : public NodeOperation {
       return this->load_input(input, weights, texel, extend_bounds);
     };
 
-    parallel_for(domain.size, [&](const int2 texel) {
+    const Bounds<int2> region = this->compute_region_of_interest_bounds(domain);
+    parallel_for(region, [&](const int2 texel) {
       float4 accumulated_color = float4(0.0f);
 
       /* First, compute the contribution of the center pixel. */
@@ -253,6 +256,8 @@ class BlurOperation : public NodeOperation {
 
       output.store_pixel(texel, accumulated_color);
     });
+
+    clear_outside_bounds(output, region);
   }
 
   void execute_variable_size(const Result &input, Result &output)
@@ -514,6 +519,24 @@ static NodeOperation *get_compositor_operation(Context &context, DNode node)
   return new BlurOperation(context, node);
 }
 
+static void get_compositor_input_region_of_interest(RegionOfInterestParams &params)
+{
+  const NodeBlurData &data = node_storage(params.node());
+
+  /* Relative sizes depend on the size of the input, which is not known before evaluation, and the
+   * recursive Gaussian filter has an infinite support. */
+  if (data.relative || data.filtertype == R_FILTER_FAST_GAUSS) {
+    params.set_input_needed_in_full("Image");
+    return;
+  }
+
+  /* The size input is clamped to the [0, 1] range, so the blur radius is at most the size of the
+   * node. */
+  Bounds<float2> region = params.output_region();
+  region.pad(float2(data.sizex, data.sizey) + realization_region_margin);
+  params.set_input_region("Image", region);
+}
+
 }  // namespace blender::nodes::node_composite_blur_cc
 
 void register_node_type_cmp_blur()
@@ -534,6 +557,7 @@ void register_node_type_cmp_blur()
   blender::bke::node_type_storage(
       ntype, "NodeBlurData", node_free_standard_storage, node_copy_standard_storage);
   ntype.get_compositor_operation = file_ns::get_compositor_operation;
+  ntype.get_compositor_input_region_of_interest = file_ns::get_compositor_input_region_of_interest;
 
   blender::bke::node_register_type(ntype);
 }
@@ -84,7 +84,10 @@ class CompositeOperation : public NodeOperation {
       GPU_texture_clear(output, GPU_DATA_FLOAT, color);
     }
     else {
-      parallel_for(domain.size, [&](const int2 texel) { output.store_pixel(texel, color); });
+      const Bounds<int2> tile = this->get_tile_bounds(domain);
+      parallel_for(tile.size(), [&](const int2 tile_texel) {
+        output.store_pixel(tile_texel + tile.min, color);
+      });
     }
   }
 
@@ -130,11 +133,18 @@ class CompositeOperation : public NodeOperation {
     Result output = context().get_output_result();
 
     const Bounds<int2> bounds = get_output_bounds();
-    parallel_for(domain.size, [&](const int2 texel) {
+    const Bounds<int2> region = this->compute_region_of_interest_bounds(domain);
+    const Bounds<int2> tile = this->get_tile_bounds(domain);
+    parallel_for(tile.size(), [&](const int2 tile_texel) {
+      const int2 texel = tile_texel + tile.min;
       const int2 output_texel = texel + bounds.min;
       if (output_texel.x > bounds.max.x || output_texel.y > bounds.max.y) {
         return;
       }
+      if (!is_in_region(region, texel)) {
+        output.store_pixel(output_texel, float4(0.0f));
+        return;
+      }
       output.store_pixel(texel + bounds.min,
                          float4(image.load_pixel<float4, true>(texel).xyz(), 1.0f));
     });
@@ -183,11 +193,18 @@ class CompositeOperation : public NodeOperation {
     Result output = context().get_output_result();
 
     const Bounds<int2> bounds = get_output_bounds();
-    parallel_for(domain.size, [&](const int2 texel) {
+    const Bounds<int2> region = this->compute_region_of_interest_bounds(domain);
+    const Bounds<int2> tile = this->get_tile_bounds(domain);
+    parallel_for(tile.size(), [&](const int2 tile_texel) {
+      const int2 texel = tile_texel + tile.min;
       const int2 output_texel = texel + bounds.min;
       if (output_texel.x > bounds.max.x || output_texel.y > bounds.max.y) {
         return;
       }
+      if (!is_in_region(region, texel)) {
+        output.store_pixel(output_texel, float4(0.0f));
+        return;
+      }
       output.store_pixel(texel + bounds.min, image.load_pixel<float4>(texel));
     });
   }
@@ -239,17 +256,32 @@ class CompositeOperation : public NodeOperation {
     Result output = context().get_output_result();
 
     const Bounds<int2> bounds = get_output_bounds();
-    parallel_for(domain.size, [&](const int2 texel) {
+    const Bounds<int2> region = this->compute_region_of_interest_bounds(domain);
+    const Bounds<int2> tile = this->get_tile_bounds(domain);
+    parallel_for(tile.size(), [&](const int2 tile_texel) {
+      const int2 texel = tile_texel + tile.min;
       const int2 output_texel = texel + bounds.min;
       if (output_texel.x > bounds.max.x || output_texel.y > bounds.max.y) {
         return;
       }
+      if (!is_in_region(region, texel)) {
+        output.store_pixel(output_texel, float4(0.0f));
+        return;
+      }
       output.store_pixel(texel + bounds.min,
                          float4(image.load_pixel<float4, true>(texel).xyz(),
                                 alpha.load_pixel<float, true>(texel)));
     });
   }
 
+  /* Returns the bounds of the tile of the compositing region that is currently being evaluated,
+   * see Context::get_output_tile. Pixels outside of the tile are written by other evaluations, so
+   * they should be left untouched. */
+  Bounds<int2> get_tile_bounds(const Domain &domain)
+  {
+    return context().get_output_tile().value_or(Bounds<int2>(int2(0), domain.size));
+  }
+
   /* Returns the bounds of the area of the compositing region. Only write into the compositing
    * region, which might be limited to a smaller region of the output result. */
   Bounds<int2> get_output_bounds()
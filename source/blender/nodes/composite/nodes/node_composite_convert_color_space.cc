@@ -6,7 +6,11 @@
  * \ingroup cmpnodes
  */
 
+#include "BLI_array.hh"
+#include "BLI_index_range.hh"
+#include "BLI_math_vector_types.hh"
 #include "BLI_string.h"
+#include "BLI_task.hh"
 
 #include "UI_interface.hh"
 #include "UI_resources.hh"
@@ -134,6 +138,24 @@ class ConvertColorSpaceOperation : public NodeOperation {
     Result &output_image = get_result("Image");
     output_image.allocate_texture(domain);
 
+    if (output_image.is_half_cpu_data()) {
+      /* Half precision data can't be processed directly, so process it row by row in a full
+       * precision buffer. */
+      threading::parallel_for(IndexRange(domain.size.y), 1, [&](const IndexRange sub_y_range) {
+        Array<float4> row(domain.size.x);
+        for (const int64_t y : sub_y_range) {
+          for (const int64_t x : row.index_range()) {
+            row[x] = input_image.load_pixel<float4>(int2(x, y));
+          }
+          IMB_colormanagement_processor_apply(
+              color_processor, *row.data(), domain.size.x, 1, 4, false);
+          output_image.write_cpu_data(IndexRange(y * domain.size.x, domain.size.x), row.as_span());
+        }
+      });
+      IMB_colormanagement_processor_free(color_processor);
+      return;
+    }
+
     parallel_for(domain.size, [&](const int2 texel) {
       output_image.store_pixel(texel, input_image.load_pixel<float4>(texel));
     });
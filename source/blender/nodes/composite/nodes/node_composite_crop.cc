@@ -7,6 +7,7 @@
  */
 
 #include "BKE_node.hh"
+#include "BLI_bounds_types.hh"
 #include "BLI_math_base.h"
 #include "BLI_math_vector_types.hh"
 
@@ -20,6 +21,7 @@
 #include "GPU_shader.hh"
 
 #include "COM_node_operation.hh"
+#include "COM_region_of_interest.hh"
 #include "COM_utilities.hh"
 
 #include "node_composite_util.hh"
@@ -142,7 +144,8 @@ class CropOperation : public NodeOperation {
     Result &output = get_result("Image");
     output.allocate_texture(domain);
 
-    parallel_for(domain.size, [&](const int2 texel) {
+    const Bounds<int2> region = this->compute_region_of_interest_bounds(domain);
+    parallel_for(region, [&](const int2 texel) {
       /* The lower bound is inclusive and upper bound is exclusive. */
       bool is_inside = texel.x >= lower_bound.x && texel.y >= lower_bound.y &&
                        texel.x < upper_bound.x && texel.y < upper_bound.y;
@@ -150,6 +153,8 @@ class CropOperation : public NodeOperation {
       float4 color = is_inside ? input.load_pixel<float4>(texel) : float4(0.0f);
       output.store_pixel(texel, color);
     });
+
+    clear_outside_bounds(output, region);
   }
 
   /* Crop the image into a new size that matches the cropping bounds. */
@@ -285,6 +290,17 @@ static NodeOperation *get_compositor_operation(Context &context, DNode node)
   return new CropOperation(context, node);
 }
 
+static void get_compositor_input_region_of_interest(RegionOfInterestParams &params)
+{
+  /* Alpha crops keep the image in place, so the input is needed in the same region as the output.
+   * Image crops on the other hand move the cropped area to the center of the output, which
+   * depends on the size of the input that is not known before evaluation. */
+  const bool is_image_crop = params.node().custom1;
+  if (is_image_crop) {
+    params.set_all_inputs_needed_in_full();
+  }
+}
+
 }  // namespace blender::nodes::node_composite_crop_cc
 
 void register_node_type_cmp_crop()
@@ -306,6 +322,7 @@ void register_node_type_cmp_crop()
   blender::bke::node_type_storage(
       ntype, "NodeTwoXYs", node_free_standard_storage, node_copy_standard_storage);
   ntype.get_compositor_operation = file_ns::get_compositor_operation;
+  ntype.get_compositor_input_region_of_interest = file_ns::get_compositor_input_region_of_interest;
 
   blender::bke::node_register_type(ntype);
 }
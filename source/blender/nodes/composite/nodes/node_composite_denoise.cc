@@ -137,6 +137,11 @@ class DenoiseOperation : public NodeOperation {
 
     Vector<float *> temporary_buffers_to_free;
 
+    /* OIDN only supports full precision buffers, so half precision images are denoised in-place in
+     * a full precision copy, similar to GPU textures. */
+    const bool is_half_cpu_data = input_image.is_half_cpu_data() ||
+                                  output_image.is_half_cpu_data();
+
     float *input_color = nullptr;
     float *output_color = nullptr;
     if (this->context().use_gpu()) {
@@ -147,6 +152,11 @@ class DenoiseOperation : public NodeOperation {
       output_color = input_color;
       temporary_buffers_to_free.append(input_color);
     }
+    else if (is_half_cpu_data) {
+      input_color = input_image.cpu_data_to_float_buffer();
+      output_color = input_color;
+      temporary_buffers_to_free.append(input_color);
+    }
     else {
       input_color = const_cast<float *>(static_cast<const float *>(input_image.cpu_data().data()));
       output_color = static_cast<float *>(output_image.cpu_data().data());
@@ -178,6 +188,10 @@ class DenoiseOperation : public NodeOperation {
           albedo = static_cast<float *>(GPU_texture_read(input_albedo, data_format, 0));
           temporary_buffers_to_free.append(albedo);
         }
+        else if (input_albedo.is_half_cpu_data()) {
+          albedo = input_albedo.cpu_data_to_float_buffer();
+          temporary_buffers_to_free.append(albedo);
+        }
         else {
           albedo = static_cast<float *>(input_albedo.cpu_data().data());
         }
@@ -206,6 +220,10 @@ class DenoiseOperation : public NodeOperation {
           normal = static_cast<float *>(GPU_texture_read(input_normal, data_format, 0));
           temporary_buffers_to_free.append(normal);
         }
+        else if (input_normal.is_half_cpu_data()) {
+          normal = input_normal.cpu_data_to_float_buffer();
+          temporary_buffers_to_free.append(normal);
+        }
         else {
           normal = static_cast<float *>(input_normal.cpu_data().data());
         }
@@ -228,6 +246,15 @@ class DenoiseOperation : public NodeOperation {
     if (this->context().use_gpu()) {
       GPU_texture_update(output_image, data_format, output_color);
     }
+    else if (is_half_cpu_data) {
+      /* Write the denoised copy to the output, restoring the alpha channel that OIDN skips. */
+      parallel_for(int2(width, height), [&](const int2 texel) {
+        const float4 denoised_color = float4(output_color +
+                                             (int64_t(texel.y) * width + texel.x) * 4);
+        const float alpha = input_image.load_pixel<float4>(texel).w;
+        output_image.store_pixel(texel, float4(denoised_color.xyz(), alpha));
+      });
+    }
     else {
       /* OIDN already wrote to the output directly, however, OIDN skips the alpha channel, so we
        * need to restore it. */
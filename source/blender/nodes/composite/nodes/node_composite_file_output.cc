@@ -9,10 +9,13 @@
 #include <cstring>
 
 #include "BLI_assert.h"
+#include "BLI_bounds_types.hh"
 #include "BLI_cpp_type.hh"
 #include "BLI_generic_pointer.hh"
+#include "BLI_generic_span.hh"
 #include "BLI_index_range.hh"
 #include "BLI_listbase.h"
+#include "BLI_math_base.hh"
 #include "BLI_math_vector.h"
 #include "BLI_path_utils.hh"
 #include "BLI_string.h"
@@ -576,7 +579,12 @@ class FileOutputOperation : public NodeOperation {
       FileOutput &file_output = context().render_context()->get_file_output(
           image_path, format, size, save_as_render);
 
-      add_view_for_result(file_output, result, context().get_view_name().data());
+      if (context().get_output_tile()) {
+        add_view_rows_for_result(file_output, result, context().get_view_name().data());
+      }
+      else {
+        add_view_for_result(file_output, result, context().get_view_name().data());
+      }
 
       add_meta_data_for_result(file_output, result, socket.layer);
     }
@@ -607,7 +615,12 @@ class FileOutputOperation : public NodeOperation {
      * add a default unnamed view. */
     const char *view_name = has_views ? context().get_view_name().data() : "";
     file_output.add_view(view_name);
-    add_pass_for_result(file_output, result, "", view_name);
+    if (context().get_output_tile()) {
+      add_pass_rows_for_result(file_output, result, "", view_name);
+    }
+    else {
+      add_pass_for_result(file_output, result, "", view_name);
+    }
 
     add_meta_data_for_result(file_output, result, layer_name);
   }
@@ -627,10 +640,16 @@ class FileOutputOperation : public NodeOperation {
     const char *write_view = store_views_in_single_file ? "" : view;
     get_multi_layer_exr_image_path(get_base_path(), write_view, image_path);
 
+    /* If the compositor is evaluated in tiles, images that store a single view are written
+     * progressively as tiles of a tiled EXR image, which requires the tiles to cover the full
+     * image. Otherwise, the tiles are accumulated until the image is saved. */
     const int2 size = compute_domain().size;
+    const bool is_tiled = context().get_output_tile().has_value();
+    const bool write_progressively = is_tiled && !store_views_in_single_file &&
+                                     size == context().get_compositing_region_size();
     const ImageFormatData format = node_storage(bnode()).format;
     FileOutput &file_output = context().render_context()->get_file_output(
-        image_path, format, size, true);
+        image_path, format, size, true, write_progressively);
 
     /* If we are saving views in separate files, we needn't store the view in the channel names, so
      * we add an unnamed view. */
@@ -644,7 +663,12 @@ class FileOutputOperation : public NodeOperation {
 
       const Result &input_result = get_input(input->identifier);
       const char *pass_name = (static_cast<NodeImageMultiFileSocket *>(input->storage))->layer;
-      add_pass_for_result(file_output, input_result, pass_name, pass_view);
+      if (is_tiled) {
+        add_pass_rows_for_result(file_output, input_result, pass_name, pass_view);
+      }
+      else {
+        add_pass_for_result(file_output, input_result, pass_name, pass_view);
+      }
 
       add_meta_data_for_result(file_output, input_result, pass_name);
     }
@@ -675,51 +699,90 @@ class FileOutputOperation : public NodeOperation {
       }
       else {
         /* Copy the result into a new buffer. */
-        buffer = static_cast<float *>(MEM_dupallocN(result.cpu_data().data()));
+        buffer = result.cpu_data_to_float_buffer();
       }
     }
 
+    /* Float3 results might be stored in 4-component textures due to hardware limitations, so we
+     * need to convert the buffer to a 3-component buffer on the host. */
+    if (result.type() == ResultType::Float3 && this->context().use_gpu() &&
+        GPU_texture_component_len(GPU_texture_format(result)))
+    {
+      buffer = float4_to_float3_image(size, buffer);
+    }
+
+    file_output.add_pass(pass_name, view_name, get_pass_channels(result), buffer);
+  }
+
+  /* Read the rows of the current output tile of the given result and add them to the pass of the
+   * given name and view. See Context::get_output_tile. */
+  void add_pass_rows_for_result(FileOutput &file_output,
+                                const Result &result,
+                                const char *pass_name,
+                                const char *view_name)
+  {
+    const int2 size = result.is_single_value() ? this->compute_domain().size :
+                                                 result.domain().size;
+    const IndexRange rows = this->get_output_tile_rows(size);
+    float *buffer = this->read_result_rows(result, size, rows);
+    file_output.add_pass_rows(pass_name, view_name, get_pass_channels(result), rows, buffer);
+    MEM_freeN(buffer);
+  }
+
+  /* Get the channel identifiers of the pass storing the given result. The pass channel
+   * identifiers follows the EXR conventions. */
+  const char *get_pass_channels(const Result &result)
+  {
     switch (result.type()) {
       case ResultType::Color:
         /* Use lowercase rgba for Cryptomatte layers because the EXR internal compression rules
          * specify that all uppercase RGBA channels will be compressed, and Cryptomatte should not
-         * be compressed. */
-        if (result.meta_data.is_cryptomatte_layer()) {
-          file_output.add_pass(pass_name, view_name, "rgba", buffer);
-        }
-        else {
-          file_output.add_pass(pass_name, view_name, "RGBA", buffer);
-        }
-        break;
+         * be compressed. This also makes them data passes, which are written with the data codec
+         * of the format, see BKE_image_format_exr_data_codec. */
+        return result.meta_data.is_cryptomatte_layer() ? "rgba" : "RGBA";
       case ResultType::Float3:
-        /* Float3 results might be stored in 4-component textures due to hardware limitations, so
-         * we need to convert the buffer to a 3-component buffer on the host. */
-        if (this->context().use_gpu() && GPU_texture_component_len(GPU_texture_format(result))) {
-          file_output.add_pass(pass_name, view_name, "XYZ", float4_to_float3_image(size, buffer));
-        }
-        else {
-          file_output.add_pass(pass_name, view_name, "XYZ", buffer);
-        }
-        break;
+        return "XYZ";
       case ResultType::Float4:
-        file_output.add_pass(pass_name, view_name, "XYZW", buffer);
-        break;
-      case ResultType::Float:
-        file_output.add_pass(pass_name, view_name, "V", buffer);
-        break;
+        return "XYZW";
       case ResultType::Float2:
-        file_output.add_pass(pass_name, view_name, "XY", buffer);
-        break;
       case ResultType::Int2:
-        file_output.add_pass(pass_name, view_name, "XY", buffer);
-        break;
+        return "XY";
+      case ResultType::Float:
       case ResultType::Int:
-        file_output.add_pass(pass_name, view_name, "V", buffer);
-        break;
       case ResultType::Bool:
-        file_output.add_pass(pass_name, view_name, "V", buffer);
-        break;
+        return "V";
+    }
+
+    BLI_assert_unreachable();
+    return "V";
+  }
+
+  /* Get the rows of the current output tile clipped to the given size. The tile is in the space of
+   * the compositing region, so it only maps to the rows of results that have the same size, which
+   * is typically the case. */
+  IndexRange get_output_tile_rows(const int2 size)
+  {
+    const Bounds<int2> tile = *context().get_output_tile();
+    return IndexRange::from_begin_end(math::clamp(tile.min.y, 0, size.y),
+                                      math::clamp(tile.max.y, 0, size.y));
+  }
+
+  /* Allocates a buffer and fills it with the given rows of the given result, whose size is the
+   * given size if it is a single value. The buffer should be freed using MEM_freeN. */
+  float *read_result_rows(const Result &result, const int2 size, const IndexRange rows)
+  {
+    BLI_assert(!context().use_gpu());
+
+    if (result.is_single_value()) {
+      return this->inflate_result(result, int2(size.x, int(rows.size())));
     }
+
+    const int64_t pixels_count = int64_t(size.x) * rows.size();
+    float *buffer = MEM_malloc_arrayN<float>(size_t(pixels_count * result.channels_count()),
+                                             "File Output Rows Buffer.");
+    result.read_cpu_data(IndexRange(rows.start() * size.x, pixels_count),
+                         GMutableSpan(result.get_cpp_type(), buffer, pixels_count));
+    return buffer;
   }
 
   /* Allocates and fills an image buffer of the specified size with the value of the given single
@@ -775,7 +838,7 @@ class FileOutputOperation : public NodeOperation {
     }
     else {
       /* Copy the result into a new buffer. */
-      buffer = static_cast<float *>(MEM_dupallocN(result.cpu_data().data()));
+      buffer = result.cpu_data_to_float_buffer();
     }
 
     const int2 size = result.domain().size;
@@ -809,6 +872,25 @@ class FileOutputOperation : public NodeOperation {
     }
   }
 
+  /* Read the rows of the current output tile of the given result and add them to the view of the
+   * given name. See Context::get_output_tile. */
+  void add_view_rows_for_result(FileOutput &file_output,
+                                const Result &result,
+                                const char *view_name)
+  {
+    BLI_assert(ELEM(result.type(),
+                    ResultType::Color,
+                    ResultType::Float4,
+                    ResultType::Float3,
+                    ResultType::Float));
+
+    const int2 size = result.domain().size;
+    const IndexRange rows = this->get_output_tile_rows(size);
+    float *buffer = this->read_result_rows(result, size, rows);
+    file_output.add_view_rows(view_name, result.channels_count(), rows, buffer);
+    MEM_freeN(buffer);
+  }
+
   /* Given a float4 image, return a newly allocated float3 image that ignores the last channel. The
    * input image is freed. */
   float *float4_to_float3_image(int2 size, float *float4_image)
@@ -6,6 +6,7 @@
  * \ingroup cmpnodes
  */
 
+#include "BLI_bounds_types.hh"
 #include "BLI_math_matrix_types.hh"
 #include "BLI_math_vector.hh"
 #include "BLI_math_vector_types.hh"
@@ -14,6 +15,7 @@
 #include "UI_resources.hh"
 
 #include "COM_node_operation.hh"
+#include "COM_region_of_interest.hh"
 #include "COM_utilities.hh"
 
 #include "node_composite_util.hh"
@@ -110,8 +112,9 @@ class FilterOperation : public NodeOperation {
     Result &output = get_result("Image");
     output.allocate_texture(domain);
 
+    const Bounds<int2> region = this->compute_region_of_interest_bounds(domain);
     if (this->is_edge_filter()) {
-      parallel_for(domain.size, [&](const int2 texel) {
+      parallel_for(region, [&](const int2 texel) {
         /* Compute the dot product between the 3x3 window around the pixel and the edge detection
          * kernel in the X direction and Y direction. The Y direction kernel is computed by
          * transposing the given X direction kernel. */
@@ -140,7 +143,7 @@ class FilterOperation : public NodeOperation {
       });
     }
     else {
-      parallel_for(domain.size, [&](const int2 texel) {
+      parallel_for(region, [&](const int2 texel) {
         /* Compute the dot product between the 3x3 window around the pixel and the kernel. */
         float4 color = float4(0.0f);
         for (int j = 0; j < 3; j++) {
@@ -157,6 +160,8 @@ class FilterOperation : public NodeOperation {
         output.store_pixel(texel, math::max(color, float4(0.0f)));
       });
     }
+
+    clear_outside_bounds(output, region);
   }
 
   bool is_edge_filter()
@@ -239,6 +244,14 @@ static NodeOperation *get_compositor_operation(Context &context, DNode node)
   return new FilterOperation(context, node);
 }
 
+static void get_compositor_input_region_of_interest(RegionOfInterestParams &params)
+{
+  /* The filter reads a 3x3 window around each pixel. */
+  Bounds<float2> region = params.output_region();
+  region.pad(float2(1.0f + realization_region_margin));
+  params.set_input_region("Image", region);
+}
+
 }  // namespace blender::nodes::node_composite_filter_cc
 
 void register_node_type_cmp_filter()
@@ -257,6 +270,7 @@ void register_node_type_cmp_filter()
   ntype.labelfunc = node_filter_label;
   ntype.flag |= NODE_PREVIEW;
   ntype.get_compositor_operation = file_ns::get_compositor_operation;
+  ntype.get_compositor_input_region_of_interest = file_ns::get_compositor_input_region_of_interest;
 
   blender::bke::node_register_type(ntype);
 }
@@ -1976,12 +1976,22 @@ class GlareOperation : public NodeOperation {
         reinterpret_cast<fftwf_complex *>(image_frequency_domain),
         FFTW_ESTIMATE);
 
+    Result fog_glow_result = context().create_result(ResultType::Color);
+    fog_glow_result.allocate_texture(highlights.domain());
+
+    /* Half precision CPU data is processed in a full precision copy, similar to GPU textures. */
+    const bool is_half_cpu_data = highlights.is_half_cpu_data() ||
+                                  fog_glow_result.is_half_cpu_data();
+
     const float *highlights_buffer = nullptr;
     if (this->context().use_gpu()) {
       GPU_memory_barrier(GPU_BARRIER_TEXTURE_UPDATE);
       highlights_buffer = static_cast<const float *>(
           GPU_texture_read(highlights, GPU_DATA_FLOAT, 0));
     }
+    else if (is_half_cpu_data) {
+      highlights_buffer = highlights.cpu_data_to_float_buffer();
+    }
     else {
       highlights_buffer = static_cast<const float *>(highlights.cpu_data().data());
     }
@@ -2056,12 +2066,9 @@ class GlareOperation : public NodeOperation {
       }
     });
 
-    Result fog_glow_result = context().create_result(ResultType::Color);
-    fog_glow_result.allocate_texture(highlights.domain());
-
-    /* For GPU, write the output to the exist highlights_buffer then upload to the result after,
-     * while for CPU, write to the result directly. */
-    float *output = this->context().use_gpu() ?
+    /* For GPU and half precision, write the output to the existing highlights_buffer then upload
+     * or store it to the result after, while for CPU, write to the result directly. */
+    float *output = this->context().use_gpu() || is_half_cpu_data ?
                         const_cast<float *>(highlights_buffer) :
                         static_cast<float *>(fog_glow_result.cpu_data().data());
 
@@ -2085,6 +2092,17 @@ class GlareOperation : public NodeOperation {
       /* CPU writes to the output directly, so no need to free it. */
       MEM_freeN(output);
     }
+    else if (is_half_cpu_data) {
+      const int64_t pixels_count = int64_t(image_size.x) * image_size.y;
+      threading::parallel_for(IndexRange(pixels_count), 4096, [&](const IndexRange sub_range) {
+        fog_glow_result.write_cpu_data(
+            sub_range,
+            GSpan(CPPType::get<float4>(),
+                  output + sub_range.start() * image_channels_count,
+                  sub_range.size()));
+      });
+      MEM_freeN(output);
+    }
 
     fftwf_destroy_plan(forward_plan);
     fftwf_destroy_plan(backward_plan);
@@ -150,11 +150,16 @@ class ViewerOperation : public NodeOperation {
         domain, image.meta_data.is_non_color_data, image.precision());
 
     const Bounds<int2> bounds = get_output_bounds();
+    const Bounds<int2> region = this->compute_region_of_interest_bounds(domain);
     parallel_for(domain.size, [&](const int2 texel) {
       const int2 output_texel = texel + bounds.min;
       if (output_texel.x > bounds.max.x || output_texel.y > bounds.max.y) {
         return;
       }
+      if (!is_in_region(region, texel)) {
+        output.store_pixel(output_texel, float4(0.0f));
+        return;
+      }
       output.store_pixel(texel + bounds.min,
                          float4(image.load_pixel<float4, true>(texel).xyz(), 1.0f));
     });
@@ -205,11 +210,16 @@ class ViewerOperation : public NodeOperation {
         domain, image.meta_data.is_non_color_data, image.precision());
 
     const Bounds<int2> bounds = get_output_bounds();
+    const Bounds<int2> region = this->compute_region_of_interest_bounds(domain);
     parallel_for(domain.size, [&](const int2 texel) {
       const int2 output_texel = texel + bounds.min;
       if (output_texel.x > bounds.max.x || output_texel.y > bounds.max.y) {
         return;
       }
+      if (!is_in_region(region, texel)) {
+        output.store_pixel(output_texel, float4(0.0f));
+        return;
+      }
       output.store_pixel(texel + bounds.min, image.load_pixel<float4>(texel));
     });
   }
@@ -263,11 +273,16 @@ class ViewerOperation : public NodeOperation {
         domain, image.meta_data.is_non_color_data, image.precision());
 
     const Bounds<int2> bounds = get_output_bounds();
+    const Bounds<int2> region = this->compute_region_of_interest_bounds(domain);
     parallel_for(domain.size, [&](const int2 texel) {
       const int2 output_texel = texel + bounds.min;
       if (output_texel.x > bounds.max.x || output_texel.y > bounds.max.y) {
         return;
       }
+      if (!is_in_region(region, texel)) {
+        output.store_pixel(output_texel, float4(0.0f));
+        return;
+      }
       output.store_pixel(texel + bounds.min,
                          float4(image.load_pixel<float4, true>(texel).xyz(),
                                 alpha.load_pixel<float, true>(texel)));
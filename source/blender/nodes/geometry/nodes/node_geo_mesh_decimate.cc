@@ -0,0 +1,90 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "DNA_mesh_types.h"
+
+#include "GEO_mesh_decimate.hh"
+#include "GEO_randomize.hh"
+
+#include "node_geometry_util.hh"
+
+namespace blender::nodes::node_geo_mesh_decimate_cc {
+
+static void node_declare(NodeDeclarationBuilder &b)
+{
+  b.add_input<decl::Geometry>("Mesh").supported_type(GeometryComponent::Type::Mesh);
+  b.add_input<decl::Bool>("Selection")
+      .default_value(true)
+      .field_on_all()
+      .hide_value()
+      .description("Only collapse edges between selected points");
+  b.add_input<decl::Float>("Ratio")
+      .default_value(0.5f)
+      .subtype(PROP_FACTOR)
+      .min(0.0f)
+      .max(1.0f)
+      .description("Fraction of the triangles of the triangulated mesh to keep");
+  b.add_output<decl::Geometry>("Mesh").propagate_all();
+}
+
+static void node_geo_exec(GeoNodeExecParams params)
+{
+  GeometrySet geometry_set = params.extract_input<GeometrySet>("Mesh");
+  const Field<bool> selection_field = params.extract_input<Field<bool>>("Selection");
+  const float ratio = std::clamp(params.extract_input<float>("Ratio"), 0.0f, 1.0f);
+  const AttributeFilter &attribute_filter = params.get_attribute_filter("Mesh");
+
+  geometry_set.modify_geometry_sets([&](GeometrySet &geometry_set) {
+    const Mesh *src_mesh = geometry_set.get_mesh();
+    if (!src_mesh) {
+      return;
+    }
+
+    const bke::MeshFieldContext context(*src_mesh, AttrDomain::Point);
+    FieldEvaluator evaluator{context, src_mesh->verts_num};
+    evaluator.add(selection_field);
+    evaluator.evaluate();
+    const IndexMask selection = evaluator.get_evaluated_as_mask(0);
+    if (selection.is_empty()) {
+      return;
+    }
+
+    /* Unselected points get a zero weight, which prevents collapsing their edges. */
+    Array<float> weights;
+    if (selection.size() < src_mesh->verts_num) {
+      weights = Array<float>(src_mesh->verts_num, 0.0f);
+      index_mask::masked_fill(weights.as_mutable_span(), 1.0f, selection);
+    }
+
+    std::optional<Mesh *> mesh = geometry::mesh_decimate_collapse(
+        *src_mesh, ratio, weights, 0.0f, attribute_filter);
+    if (!mesh) {
+      return;
+    }
+
+    geometry::debug_randomize_mesh_order(*mesh);
+
+    geometry_set.replace_mesh(*mesh);
+  });
+
+  params.set_output("Mesh", std::move(geometry_set));
+}
+
+static void node_register()
+{
+  static blender::bke::bNodeType ntype;
+
+  geo_node_type_base(&ntype, "GeometryNodeDecimateMesh", GEO_NODE_DECIMATE_MESH);
+  ntype.ui_name = "Decimate Mesh";
+  ntype.ui_description =
+      "Reduce the number of faces by collapsing the edges that change the shape the least";
+  ntype.enum_name_legacy = "DECIMATE_MESH";
+  ntype.nclass = NODE_CLASS_GEOMETRY;
+  ntype.declare = node_declare;
+  ntype.geometry_node_execute = node_geo_exec;
+  blender::bke::node_register_type(ntype);
+}
+NOD_REGISTER_NODE(node_register)
+
+}  // namespace blender::nodes::node_geo_mesh_decimate_cc
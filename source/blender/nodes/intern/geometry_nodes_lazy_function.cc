@@ -29,6 +29,7 @@
 #include "BLI_bit_group_vector.hh"
 #include "BLI_bit_span_ops.hh"
 #include "BLI_cpp_types.hh"
+#include "BLI_fileops.hh"
 #include "BLI_lazy_threading.hh"
 #include "BLI_map.hh"
 
@@ -38,6 +39,7 @@
 #include "BKE_compute_contexts.hh"
 #include "BKE_geometry_nodes_gizmos_transforms.hh"
 #include "BKE_geometry_set.hh"
+#include "BKE_global.hh"
 #include "BKE_grease_pencil.hh"
 #include "BKE_library.hh"
 #include "BKE_node_legacy_types.hh"
@@ -48,11 +50,13 @@
 #include "BKE_type_conversions.hh"
 
 #include "FN_lazy_function_graph_executor.hh"
+#include "FN_lazy_function_graph_executor_profiler.hh"
 
 #include "DEG_depsgraph_query.hh"
 
 #include <fmt/format.h>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 
 namespace blender::nodes {
@@ -1648,6 +1652,55 @@ std::string zone_wrapper_output_name(const ZoneBuildInfo &zone_info,
   return outputs[lf_socket_i].debug_name;
 }
 
+static std::unique_ptr<lf::GraphExecutorProfiler> &geometry_nodes_profiler_ptr()
+{
+  static std::unique_ptr<lf::GraphExecutorProfiler> profiler;
+  return profiler;
+}
+
+lf::GraphExecutorProfiler *geometry_nodes_profiler()
+{
+  if (!G.profile_geometry_nodes) {
+    return nullptr;
+  }
+  static std::once_flag flag;
+  std::call_once(flag, []() {
+    geometry_nodes_profiler_ptr() = std::make_unique<lf::GraphExecutorProfiler>();
+  });
+  return geometry_nodes_profiler_ptr().get();
+}
+
+void geometry_nodes_profiler_write_and_free()
+{
+  std::unique_ptr<lf::GraphExecutorProfiler> &profiler = geometry_nodes_profiler_ptr();
+  if (!profiler) {
+    return;
+  }
+  /* Stop recording before the profiler is freed. */
+  G.profile_geometry_nodes = false;
+
+  const Vector<lf::NodeProfileSummary> summary = profiler->summary();
+  std::cout << "Geometry Nodes Profile (" << profiler->executions_num() << " node executions, "
+            << profiler->steals_num() << " task steals):\n";
+  for (const lf::NodeProfileSummary &item : summary.as_span().take_front(20)) {
+    std::cout << fmt::format(
+        "  {:>10.3f} ms self {:>10.3f} ms total {:>8} runs {:>12} bytes  {}\n",
+        double(item.self_time.count()) / 1e6,
+        double(item.total_time.count()) / 1e6,
+        item.executions_num,
+        item.allocated_bytes,
+        item.name);
+  }
+
+  blender::fstream chrome_trace_file("geometry_nodes_profile.json", std::ios::out);
+  profiler->write_chrome_trace(chrome_trace_file);
+  blender::fstream speedscope_file("geometry_nodes_profile.speedscope.json", std::ios::out);
+  profiler->write_speedscope(speedscope_file);
+  std::cout << "Wrote geometry_nodes_profile.json and geometry_nodes_profile.speedscope.json\n";
+
+  profiler.reset();
+}
+
 /**
  * Logs intermediate values from the lazy-function graph evaluation into #GeoModifierLog based on
  * the mapping between the lazy-function graph and the corresponding #bNodeTree.
@@ -1729,13 +1782,42 @@ class GeometryNodesLazyFunctionLogger : public lf::GraphExecutor::Logger {
   }
 
   void log_before_node_execute(const lf::FunctionNode &node,
-                               const lf::Params & /*params*/,
+                               const lf::Params &params,
                                const lf::Context &context) const override
   {
     /* Enable this to see the threads that invoked a node. */
     if constexpr (false) {
       this->add_thread_id_debug_message(node, context);
     }
+    if (lf::GraphExecutorProfiler *profiler = geometry_nodes_profiler()) {
+      profiler->log_before_node_execute(node, params, context);
+    }
+  }
+
+  void log_after_node_execute(const lf::FunctionNode &node,
+                              const lf::Params &params,
+                              const lf::Context &context) const override
+  {
+    if (lf::GraphExecutorProfiler *profiler = geometry_nodes_profiler()) {
+      profiler->log_after_node_execute(node, params, context);
+    }
+  }
+
+  void log_node_allocated_bytes(const lf::FunctionNode &node,
+                                const int64_t allocated_bytes,
+                                const lf::Context &context) const override
+  {
+    if (lf::GraphExecutorProfiler *profiler = geometry_nodes_profiler()) {
+      profiler->log_node_allocated_bytes(node, allocated_bytes, context);
+    }
+  }
+
+  void log_scheduled_nodes_stolen(const int64_t nodes_num,
+                                  const lf::Context &context) const override
+  {
+    if (lf::GraphExecutorProfiler *profiler = geometry_nodes_profiler()) {
+      profiler->log_scheduled_nodes_stolen(nodes_num, context);
+    }
   }
 
   void add_thread_id_debug_message(const lf::FunctionNode &node, const lf::Context &context) const
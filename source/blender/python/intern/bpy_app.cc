@@ -42,6 +42,8 @@
 #include "BKE_global.hh"
 #include "BKE_main.hh"
 
+#include "IMB_moviecache.hh"
+
 #include "UI_interface_icons.hh"
 
 #include "MEM_guardedalloc.h"
@@ -598,6 +600,47 @@ static PyObject *bpy_app_is_job_running(PyObject * /*self*/, PyObject *args, PyO
   return PyBool_FromLong(WM_jobs_has_running_type(wm, job_type_enum.value));
 }
 
+PyDoc_STRVAR(
+    /* Wrap. */
+    bpy_app_moviecache_statistics_doc,
+    ".. staticmethod:: moviecache_statistics()\n"
+    "\n"
+    "   Return usage statistics of the caches of images, movie clips and their display buffers, "
+    "summed over caches of the same kind. Hits, misses and evictions are counted since the caches "
+    "were created.\n"
+    "\n"
+    "   :return: A dictionary mapping cache names to dictionaries with the number of "
+    "``hits``, ``misses`` and ``evictions``, the number of cached frames ``items`` and their "
+    "memory in bytes ``memory_in_use``.\n"
+    "   :rtype: dict[str, dict[str, int]]\n");
+static PyObject *bpy_app_moviecache_statistics(PyObject * /*self*/)
+{
+  const blender::Map<std::string, MovieCacheStatistics> statistics =
+      IMB_moviecache_get_statistics();
+
+  PyObject *result = PyDict_New();
+  for (const auto item : statistics.items()) {
+    const MovieCacheStatistics &cache_statistics = item.value;
+    PyObject *py_cache_statistics = PyDict_New();
+
+    const auto set_item = [&](const char *key, const int64_t value) {
+      PyObject *py_value = PyLong_FromLongLong(value);
+      PyDict_SetItemString(py_cache_statistics, key, py_value);
+      Py_DECREF(py_value);
+    };
+    set_item("hits", cache_statistics.hits);
+    set_item("misses", cache_statistics.misses);
+    set_item("evictions", cache_statistics.evictions);
+    set_item("items", cache_statistics.items_num);
+    set_item("memory_in_use", cache_statistics.memory_in_use);
+
+    PyDict_SetItemString(result, item.key.c_str(), py_cache_statistics);
+    Py_DECREF(py_cache_statistics);
+  }
+
+  return result;
+}
+
 char *(*BPY_python_app_help_text_fn)(bool all) = nullptr;
 
 PyDoc_STRVAR(
@@ -646,6 +689,10 @@ static PyMethodDef bpy_app_methods[] = {
      (PyCFunction)bpy_app_help_text,
      METH_VARARGS | METH_KEYWORDS | METH_STATIC,
      bpy_app_help_text_doc},
+    {"moviecache_statistics",
+     (PyCFunction)bpy_app_moviecache_statistics,
+     METH_NOARGS | METH_STATIC,
+     bpy_app_moviecache_statistics_doc},
     {nullptr, nullptr, 0, nullptr},
 };
 
@@ -2,11 +2,20 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <cstdint>
 #include <cstring>
+#include <mutex>
+#include <optional>
 #include <string>
 
+#include "BLI_bounds_types.hh"
+#include "BLI_cpp_type.hh"
+#include "BLI_generic_span.hh"
+#include "BLI_index_range.hh"
 #include "BLI_listbase.h"
+#include "BLI_math_base.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_system.h"
 #include "BLI_threads.h"
 #include "BLI_vector.hh"
 
@@ -18,6 +27,8 @@
 #include "BKE_node.hh"
 #include "BKE_scene.hh"
 
+#include "DNA_userdef_types.h"
+
 #include "DRW_engine.hh"
 #include "DRW_render.hh"
 
@@ -26,7 +37,9 @@
 #include "COM_context.hh"
 #include "COM_domain.hh"
 #include "COM_evaluator.hh"
+#include "COM_region_of_interest.hh"
 #include "COM_render_context.hh"
+#include "COM_scheduler.hh"
 
 #include "RE_compositor.hh"
 #include "RE_pipeline.h"
@@ -94,6 +107,14 @@ class Context : public compositor::Context {
   Vector<GPUTexture *> cached_gpu_passes_;
   Vector<ImBuf *> cached_cpu_passes_;
 
+  /* Protects the cached passes, since passes might be retrieved from multiple threads when
+   * operations are evaluated concurrently on the CPU. */
+  std::mutex cached_passes_mutex_;
+
+  /* The tile of the compositing region that is currently being evaluated, see
+   * get_output_tile_height. */
+  std::optional<Bounds<int2>> output_tile_;
+
  public:
   Context(const ContextInputData &input_data)
       : compositor::Context(),
@@ -272,6 +293,7 @@ class Context : public compositor::Context {
       IMB_refImBuf(render_pass->ibuf);
       pass.wrap_external(render_pass->ibuf->float_buffer.data,
                          int2(render_pass->ibuf->x, render_pass->ibuf->y));
+      std::lock_guard lock{cached_passes_mutex_};
       cached_cpu_passes_.append(render_pass->ibuf);
     }
 
@@ -312,8 +334,10 @@ class Context : public compositor::Context {
   {
     switch (input_data_.scene->r.compositor_precision) {
       case SCE_COMPOSITOR_PRECISION_AUTO:
-        /* Auto uses full precision for final renders and half procession otherwise. */
-        if (this->render_context()) {
+        /* Auto uses full precision for final renders and half procession otherwise. On the CPU
+         * half precision is only used when explicitly requested, since results are stored in half
+         * floats there. */
+        if (this->render_context() || !this->use_gpu()) {
           return compositor::ResultPrecision::Full;
         }
         else {
@@ -321,6 +345,8 @@ class Context : public compositor::Context {
         }
       case SCE_COMPOSITOR_PRECISION_FULL:
         return compositor::ResultPrecision::Full;
+      case SCE_COMPOSITOR_PRECISION_HALF:
+        return compositor::ResultPrecision::Half;
     }
 
     BLI_assert_unreachable();
@@ -428,8 +454,10 @@ class Context : public compositor::Context {
         float *data = MEM_malloc_arrayN<float>(4 * size_t(rr->rectx) * size_t(rr->recty),
                                                __func__);
         IMB_assign_float_buffer(ibuf, data, IB_TAKE_OWNERSHIP);
-        std::memcpy(
-            data, output_result_.cpu_data().data(), rr->rectx * rr->recty * 4 * sizeof(float));
+        const int64_t pixels_count = int64_t(rr->rectx) * rr->recty;
+        output_result_.read_cpu_data(
+            IndexRange(pixels_count),
+            GMutableSpan(CPPType::get<float4>(), data, pixels_count));
       }
     }
 
@@ -501,9 +529,10 @@ class Context : public compositor::Context {
       MEM_freeN(output_buffer);
     }
     else {
-      std::memcpy(image_buffer->float_buffer.data,
-                  viewer_output_result_.cpu_data().data(),
-                  size.x * size.y * 4 * sizeof(float));
+      const int64_t pixels_count = int64_t(size.x) * size.y;
+      viewer_output_result_.read_cpu_data(
+          IndexRange(pixels_count),
+          GMutableSpan(CPPType::get<float4>(), image_buffer->float_buffer.data, pixels_count));
     }
 
     BKE_image_partial_update_mark_full_update(image);
@@ -522,6 +551,77 @@ class Context : public compositor::Context {
     return input_data_.profiler;
   }
 
+  int64_t get_node_result_cache_limit() const override
+  {
+    /* Only cache node results for interactive CPU compositing, where the same frame is evaluated
+     * repeatedly while the user edits the node tree. GPU results are allocated from a texture pool
+     * that expects all textures to be released after every evaluation. */
+    if (this->use_gpu() || this->render_context()) {
+      return 0;
+    }
+
+    return int64_t(U.compositor_cache_limit) * 1024 * 1024;
+  }
+
+  int64_t get_scratch_memory_threshold() const override
+  {
+    /* Only use scratch memory for final CPU renders, whose images might not fit in the system
+     * memory. Interactive compositing would be too slow if the system memory is exhausted anyway.
+     * Results that are larger than an eighth of the system memory are stored in scratch memory.
+     *
+     * Limitation: only node trees where every node has a region of interest are additionally
+     * evaluated in tiles, see Compositor::is_tiled_evaluation_supported. If any node needs its
+     * inputs in full, like glare, defocus or distortion nodes, the frame is evaluated at once, so
+     * all results of the frame exist at the same time and the scratch files need to be as large
+     * as the results combined. */
+    if (this->use_gpu() || !this->render_context()) {
+      return 0;
+    }
+
+    return int64_t(BLI_system_memory_max_in_megabytes()) * 1024 * 1024 / 8;
+  }
+
+  std::optional<Bounds<int2>> get_output_tile() const override
+  {
+    return output_tile_;
+  }
+
+  void set_output_tile(const std::optional<Bounds<int2>> &tile)
+  {
+    output_tile_ = tile;
+  }
+
+  /* Returns the height of the horizontal tiles in which the compositing region should be
+   * evaluated, or nullopt if it should be evaluated in a single evaluation. Renders where a single
+   * color image of the size of the compositing region is stored in scratch memory are evaluated in
+   * tiles, such that each evaluation only touches a limited part of the scratch memory, which the
+   * system can then evict to the scratch files. The height is a multiple of the tile size of
+   * progressively written EXR images, see compositor::FileOutput. Viewers and previews need the
+   * entire image, so they are not supported. */
+  std::optional<int> get_output_tile_height() const
+  {
+    const int64_t threshold = this->get_scratch_memory_threshold();
+    if (threshold == 0) {
+      return std::nullopt;
+    }
+
+    if (bool(this->needed_outputs() & (compositor::OutputTypes::Viewer |
+                                       compositor::OutputTypes::Previews)))
+    {
+      return std::nullopt;
+    }
+
+    const int2 size = this->get_compositing_region_size();
+    const int64_t row_size = int64_t(size.x) * sizeof(float4);
+    if (row_size * size.y < threshold) {
+      return std::nullopt;
+    }
+
+    const int exr_tile_size = compositor::FileOutput::exr_tile_size;
+    const int rows_count = int(threshold / row_size);
+    return math::max(exr_tile_size, rows_count / exr_tile_size * exr_tile_size);
+  }
+
   void evaluate_operation_post() const override
   {
     /* If no render context exist, that means this is an interactive compositor evaluation due to
@@ -618,7 +718,11 @@ class Compositor {
       }
     }
 
-    {
+    const std::optional<int> tile_height = context_->get_output_tile_height();
+    if (tile_height.has_value() && this->is_tiled_evaluation_supported(*tile_height)) {
+      this->evaluate_in_tiles(*tile_height);
+    }
+    else {
       compositor::Evaluator evaluator(*context_);
       evaluator.evaluate();
     }
@@ -642,6 +746,50 @@ class Compositor {
     }
   }
 
+  /* Returns true if the node tree can be evaluated in tiles of the given height. That's only the
+   * case if every node only computes a region of interest around the tile, since nodes that need
+   * their inputs in full would evaluate those inputs in full for every tile. Such node trees are
+   * evaluated at once, with large results still stored in scratch memory. */
+  bool is_tiled_evaluation_supported(const int tile_height)
+  {
+    const int2 size = context_->get_compositing_region_size();
+    context_->set_output_tile(
+        Bounds<int2>(int2(0, math::max(0, size.y - tile_height)), int2(size.x, size.y)));
+
+    const nodes::DerivedNodeTree tree(context_->get_node_tree());
+    const compositor::Schedule schedule = compositor::compute_schedule(*context_, tree);
+    const bool is_supported = compositor::all_nodes_have_region_of_interest(*context_, schedule);
+
+    context_->set_output_tile(std::nullopt);
+    return is_supported;
+  }
+
+  /* Evaluates the compositing region in horizontal tiles of the given height, starting from the
+   * upper edge of the region such that the tiles are aligned to the tiles of progressively written
+   * EXR images, see compositor::FileOutput. The regions of interest are computed when compiling,
+   * so an evaluator is created for each tile. See is_tiled_evaluation_supported. */
+  void evaluate_in_tiles(const int tile_height)
+  {
+    const int2 size = context_->get_compositing_region_size();
+    for (int upper_row = size.y; upper_row > 0; upper_row -= tile_height) {
+      if (context_->is_canceled()) {
+        break;
+      }
+
+      const int lower_row = math::max(0, upper_row - tile_height);
+      context_->set_output_tile(Bounds<int2>(int2(0, lower_row), int2(size.x, upper_row)));
+
+      {
+        compositor::Evaluator evaluator(*context_);
+        evaluator.evaluate();
+      }
+
+      context_->render_context()->write_file_outputs_rows(render_.pipeline_scene_eval);
+    }
+
+    context_->set_output_tile(std::nullopt);
+  }
+
   /* Returns true if the compositor should be freed and reconstructed, which is needed when the
    * compositor execution device or precision changed, because we either need to update all cached
    * and pooled resources for the new execution device and precision, or we simply recreate the
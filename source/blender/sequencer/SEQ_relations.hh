@@ -9,6 +9,7 @@
  */
 
 #include <cstddef>
+#include <cstdint>
 
 struct ListBase;
 struct Main;
@@ -57,12 +58,33 @@ void relations_check_uids_unique_and_report(const Scene *scene);
  */
 void relations_session_uid_generate(Strip *sequence);
 
+/**
+ * Usage statistics of the image cache of a scene.
+ */
+struct CacheStatistics {
+  /** Number of lookups that found a cached image. */
+  int64_t hits = 0;
+  /** Number of lookups that didn't find a cached image in memory. */
+  int64_t misses = 0;
+  /** Number of images that were removed to keep the memory below the cache limit. */
+  int64_t evictions = 0;
+  /** Number of cached images. */
+  int64_t items_num = 0;
+  /** Memory in bytes used by the cached images, at the time they were put in the cache. */
+  int64_t memory_in_use = 0;
+};
+
 void cache_cleanup(Scene *scene);
 void cache_iterate(
     Scene *scene,
     void *userdata,
     bool callback_init(void *userdata, size_t item_count),
     bool callback_iter(void *userdata, Strip *strip, int timeline_frame, int cache_type));
+/**
+ * Get the usage statistics of the image cache of the scene. Hits, misses and evictions are counted
+ * since the cache was created.
+ */
+CacheStatistics cache_statistics_get(Scene *scene);
 /**
  * Return immediate parent meta of sequence.
  */
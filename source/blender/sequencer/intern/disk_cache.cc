@@ -6,9 +6,16 @@
  * \ingroup sequencer
  */
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstddef>
 #include <ctime>
 #include <memory.h>
+#include <mutex>
+#include <string>
+
+#include <zstd.h>
 
 #include "MEM_guardedalloc.h"
 
@@ -20,14 +27,20 @@
 #include "IMB_imbuf.hh"
 #include "IMB_imbuf_types.hh"
 
+#include "BLI_array.hh"
 #include "BLI_endian_defines.h"
 #include "BLI_endian_switch.h"
 #include "BLI_fileops.h"
 #include "BLI_fileops_types.h"
 #include "BLI_listbase.h"
+#include "BLI_map.hh"
+#include "BLI_math_base.h"
 #include "BLI_path_utils.hh"
 #include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
+#include "BLI_vector.hh"
 
 #include "BKE_main.hh"
 
@@ -45,11 +58,19 @@
  * For each cached non-temp image, image data and supplementary info are written to HDD.
  * Multiple(DCACHE_IMAGES_PER_FILE) images share the same file.
  * Each of these files contains header DiskCacheHeader followed by image data.
- * ZLIB compression with user definable level can be used to compress image data(per image)
- * Images are written in order in which they are rendered.
+ * ZSTD compression with user definable level can be used to compress image data(per image).
+ * Image data is compressed in chunks of DCACHE_COMPRESSION_CHUNK_SIZE, each stored as an
+ * independent ZSTD frame, so images are compressed and decompressed by multiple threads. The
+ * read/write mutex is only locked for file and header access, not while compressing or
+ * decompressing.
+ * Images are written in order in which they are rendered, by a background task, so rendering
+ * doesn't wait for compression and disk I/O. Images waiting to be written are read from memory.
  * Overwriting of individual entry is not possible.
  * Stored images are deleted by invalidation, or when size of all files exceeds maximum
- * size specified in user preferences.
+ * size specified in user preferences, least recently used files first.
+ * Cache files and their headers are kept in an in-memory index, the cache directory is only
+ * scanned when the disk cache is created, and looking up images which are not cached doesn't
+ * touch the disk.
  * To distinguish 2 blend files with same name, scene->ed->disk_cache_timestamp
  * is used as UID. Blend file can still be copied manually which may cause conflict.
  */
@@ -60,7 +81,12 @@ namespace blender::seq {
  * `<cache type>-<resolution X>x<resolution Y>-<rendersize>%(<view_id>)-<frame no>.dcf`. */
 #define DCACHE_FNAME_FORMAT "%d-%dx%d-%d%%(%d)-%d.dcf"
 #define DCACHE_IMAGES_PER_FILE 100
-#define DCACHE_CURRENT_VERSION 2
+#define DCACHE_CURRENT_VERSION 3
+/* Size of the image data chunks which are compressed independently. */
+#define DCACHE_COMPRESSION_CHUNK_SIZE (1 << 20)
+/* Maximum number of images waiting to be written, further writes wait for the writer to catch up,
+ * so memory usage stays bounded when the disk is slower than rendering. */
+#define DCACHE_MAX_PENDING_WRITES 8
 #define COLORSPACE_NAME_MAX 64 /* XXX: defined in IMB intern. */
 
 struct DiskCacheHeaderEntry {
@@ -76,14 +102,6 @@ struct DiskCacheHeader {
   DiskCacheHeaderEntry entry[DCACHE_IMAGES_PER_FILE];
 };
 
-struct SeqDiskCache {
-  Main *bmain;
-  int64_t timestamp;
-  ListBase files;
-  ThreadMutex read_write_mutex;
-  size_t size_total;
-};
-
 struct DiskCacheFile {
   DiskCacheFile *next, *prev;
   char filepath[FILE_MAX];
@@ -96,9 +114,39 @@ struct DiskCacheFile {
   int render_size;
   int view_id;
   int start_frame;
+  /* Header of the file, read when the file is first accessed and updated by writes. */
+  DiskCacheHeader *header;
+};
+
+/* Image waiting to be written by the background writer. */
+struct DiskCacheWrite {
+  char filepath[FILE_MAX];
+  char dir[FILE_MAXDIR];
+  int cache_type;
+  int start_frame;
+  float frame_index;
+  ImBuf *ibuf = nullptr;
+  /* Set when the image is invalidated before it is written. */
+  bool is_cancelled = false;
 };
 
-static ThreadMutex cache_create_lock = BLI_MUTEX_INITIALIZER;
+struct SeqDiskCache {
+  Main *bmain = nullptr;
+  int64_t timestamp = 0;
+  /* Files ordered from least to most recently used. */
+  ListBase files = {nullptr, nullptr};
+  /* Files of #files by their index key, see #seq_disk_cache_file_index_key. */
+  Map<std::string, DiskCacheFile *> files_by_path;
+  ThreadMutex read_write_mutex;
+  size_t size_total = 0;
+
+  /* Background task pool writing #DiskCacheWrite tasks one after the other. */
+  TaskPool *write_pool = nullptr;
+  /* Protects #pending_writes, always locked after #read_write_mutex. */
+  std::mutex pending_writes_mutex;
+  std::condition_variable pending_writes_condition;
+  Vector<DiskCacheWrite *> pending_writes;
+};
 
 static const char *seq_disk_cache_base_dir()
 {
@@ -131,6 +179,16 @@ bool seq_disk_cache_is_enabled(Main *bmain)
           bmain->filepath[0] != '\0');
 }
 
+/* Paths are normalized and compared case insensitively, as file systems may do. */
+static std::string seq_disk_cache_file_index_key(const char *filepath)
+{
+  char key[FILE_MAX];
+  STRNCPY(key, filepath);
+  BLI_path_normalize(key);
+  BLI_str_tolower_ascii(key, sizeof(key));
+  return key;
+}
+
 static DiskCacheFile *seq_disk_cache_add_file_to_list(SeqDiskCache *disk_cache,
                                                       const char *filepath)
 {
@@ -151,6 +209,7 @@ static DiskCacheFile *seq_disk_cache_add_file_to_list(SeqDiskCache *disk_cache,
          &cache_file->start_frame);
   cache_file->start_frame *= DCACHE_IMAGES_PER_FILE;
   BLI_addtail(&disk_cache->files, cache_file);
+  disk_cache->files_by_path.add_overwrite(seq_disk_cache_file_index_key(filepath), cache_file);
   return cache_file;
 }
 
@@ -158,7 +217,6 @@ static void seq_disk_cache_get_files(SeqDiskCache *disk_cache, const char *dirpa
 {
   direntry *filelist, *fl;
   uint i;
-  disk_cache->size_total = 0;
 
   const int filelist_num = BLI_filelist_dir_contents(dirpath, &filelist);
   i = filelist_num;
@@ -195,77 +253,58 @@ static void seq_disk_cache_get_files(SeqDiskCache *disk_cache, const char *dirpa
   BLI_filelist_free(filelist, filelist_num);
 }
 
-static DiskCacheFile *seq_disk_cache_get_oldest_file(SeqDiskCache *disk_cache)
+static int seq_disk_cache_file_mtime_cmp(const void *a, const void *b)
 {
-  DiskCacheFile *oldest_file = static_cast<DiskCacheFile *>(disk_cache->files.first);
-  if (oldest_file == nullptr) {
-    return nullptr;
-  }
-  for (DiskCacheFile *cache_file = oldest_file->next; cache_file; cache_file = cache_file->next) {
-    if (cache_file->fstat.st_mtime < oldest_file->fstat.st_mtime) {
-      oldest_file = cache_file;
-    }
+  const DiskCacheFile *file_a = static_cast<const DiskCacheFile *>(a);
+  const DiskCacheFile *file_b = static_cast<const DiskCacheFile *>(b);
+  if (file_a->fstat.st_mtime == file_b->fstat.st_mtime) {
+    return 0;
   }
-
-  return oldest_file;
+  return file_a->fstat.st_mtime < file_b->fstat.st_mtime ? -1 : 1;
 }
 
 static void seq_disk_cache_delete_file(SeqDiskCache *disk_cache, DiskCacheFile *file)
 {
   disk_cache->size_total -= file->fstat.st_size;
+  /* The file may have been manually deleted during runtime, which is fine. */
   BLI_delete(file->filepath, false, false);
   BLI_remlink(&disk_cache->files, file);
+  disk_cache->files_by_path.remove(seq_disk_cache_file_index_key(file->filepath));
+  MEM_SAFE_FREE(file->header);
   MEM_freeN(file);
 }
 
-bool seq_disk_cache_enforce_limits(SeqDiskCache *disk_cache)
+/* Deletes least recently used files until the size limit is met, expects the read/write mutex to
+ * be locked. */
+static void seq_disk_cache_enforce_limits(SeqDiskCache *disk_cache)
 {
-  BLI_mutex_lock(&disk_cache->read_write_mutex);
   while (disk_cache->size_total > seq_disk_cache_size_limit()) {
-    DiskCacheFile *oldest_file = seq_disk_cache_get_oldest_file(disk_cache);
-
+    DiskCacheFile *oldest_file = static_cast<DiskCacheFile *>(disk_cache->files.first);
     if (!oldest_file) {
-      /* We shouldn't enforce limits with no files, do re-scan. */
-      seq_disk_cache_get_files(disk_cache, seq_disk_cache_base_dir());
-      continue;
-    }
-
-    if (BLI_exists(oldest_file->filepath) == 0) {
-      /* File may have been manually deleted during runtime, do re-scan. */
-      BLI_freelistN(&disk_cache->files);
-      seq_disk_cache_get_files(disk_cache, seq_disk_cache_base_dir());
-      continue;
+      /* Only files of the index are accounted for, so this shouldn't happen. */
+      BLI_assert_unreachable();
+      disk_cache->size_total = 0;
+      break;
     }
 
     seq_disk_cache_delete_file(disk_cache, oldest_file);
   }
-  BLI_mutex_unlock(&disk_cache->read_write_mutex);
-
-  return true;
 }
 
 static DiskCacheFile *seq_disk_cache_get_file_entry_by_path(SeqDiskCache *disk_cache,
                                                             const char *filepath)
 {
-  DiskCacheFile *cache_file = static_cast<DiskCacheFile *>(disk_cache->files.first);
-
-  for (; cache_file; cache_file = cache_file->next) {
-    if (BLI_strcasecmp(cache_file->filepath, filepath) == 0) {
-      return cache_file;
-    }
-  }
-
-  return nullptr;
+  return disk_cache->files_by_path.lookup_default(seq_disk_cache_file_index_key(filepath),
+                                                  nullptr);
 }
 
-/* Update file size and timestamp. */
-static void seq_disk_cache_update_file(SeqDiskCache *disk_cache, const char *filepath)
+/* Update file size and timestamp, and mark the file as most recently used. */
+static void seq_disk_cache_update_file(SeqDiskCache *disk_cache, DiskCacheFile *cache_file)
 {
-  DiskCacheFile *cache_file;
+  const char *filepath = cache_file->filepath;
   int64_t size_before;
   int64_t size_after;
 
-  cache_file = seq_disk_cache_get_file_entry_by_path(disk_cache, filepath);
   size_before = cache_file->fstat.st_size;
 
   if (BLI_stat(filepath, &cache_file->fstat) == -1) {
@@ -275,6 +314,9 @@ static void seq_disk_cache_update_file(SeqDiskCache *disk_cache, const char *fil
 
   size_after = cache_file->fstat.st_size;
   disk_cache->size_total += size_after - size_before;
+
+  BLI_remlink(&disk_cache->files, cache_file);
+  BLI_addtail(&disk_cache->files, cache_file);
 }
 
 /* Path format:
@@ -369,6 +411,22 @@ static void seq_disk_cache_handle_versioning(SeqDiskCache *disk_cache)
   }
 }
 
+static bool seq_disk_cache_is_invalid(Strip *strip,
+                                      const char *cache_dir,
+                                      const char *dir,
+                                      const int cache_type,
+                                      const int start_frame,
+                                      const int invalidate_types,
+                                      const int range_start,
+                                      const int range_end)
+{
+  if ((cache_type & invalidate_types) == 0 || !STREQ(cache_dir, dir)) {
+    return false;
+  }
+  const int timeline_frame_start = seq_cache_frame_index_to_timeline_frame(strip, start_frame);
+  return timeline_frame_start > range_start && timeline_frame_start <= range_end;
+}
+
 static void seq_disk_cache_delete_invalid_files(SeqDiskCache *disk_cache,
                                                 Scene *scene,
                                                 Strip *strip,
@@ -383,17 +441,35 @@ static void seq_disk_cache_delete_invalid_files(SeqDiskCache *disk_cache,
 
   while (cache_file) {
     next_file = cache_file->next;
-    if (cache_file->cache_type & invalidate_types) {
-      if (STREQ(cache_dir, cache_file->dir)) {
-        int timeline_frame_start = seq_cache_frame_index_to_timeline_frame(
-            strip, cache_file->start_frame);
-        if (timeline_frame_start > range_start && timeline_frame_start <= range_end) {
-          seq_disk_cache_delete_file(disk_cache, cache_file);
-        }
-      }
+    if (seq_disk_cache_is_invalid(strip,
+                                  cache_dir,
+                                  cache_file->dir,
+                                  cache_file->cache_type,
+                                  cache_file->start_frame,
+                                  invalidate_types,
+                                  range_start,
+                                  range_end))
+    {
+      seq_disk_cache_delete_file(disk_cache, cache_file);
     }
     cache_file = next_file;
   }
+
+  /* Images which are not written yet would otherwise bring back invalid files. */
+  std::scoped_lock lock(disk_cache->pending_writes_mutex);
+  for (DiskCacheWrite *write : disk_cache->pending_writes) {
+    if (seq_disk_cache_is_invalid(strip,
+                                  cache_dir,
+                                  write->dir,
+                                  write->cache_type,
+                                  write->start_frame,
+                                  invalidate_types,
+                                  range_start,
+                                  range_end))
+    {
+      write->is_cancelled = true;
+    }
+  }
 }
 
 void seq_disk_cache_invalidate(SeqDiskCache *disk_cache,
@@ -415,41 +491,155 @@ void seq_disk_cache_invalidate(SeqDiskCache *disk_cache,
   BLI_mutex_unlock(&disk_cache->read_write_mutex);
 }
 
-static size_t deflate_imbuf_to_file(ImBuf *ibuf,
-                                    FILE *file,
-                                    int level,
-                                    DiskCacheHeaderEntry *header_entry)
+/* Size of the pixels of the image as they are stored in the disk cache. */
+static size_t seq_disk_cache_image_data_size(const ImBuf *ibuf)
+{
+  if (ibuf->byte_buffer.data) {
+    return size_t(ibuf->x) * ibuf->y * ibuf->channels;
+  }
+  return size_t(ibuf->x) * ibuf->y * ibuf->channels * 4;
+}
+
+static char *seq_disk_cache_image_data(const ImBuf *ibuf)
+{
+  return (ibuf->byte_buffer.data != nullptr) ? reinterpret_cast<char *>(ibuf->byte_buffer.data) :
+                                               reinterpret_cast<char *>(ibuf->float_buffer.data);
+}
+
+/* Compress the pixels of the image in chunks of #DCACHE_COMPRESSION_CHUNK_SIZE in parallel, each
+ * chunk is a complete ZSTD frame. Returns false if compression failed. */
+static bool compress_imbuf(const ImBuf *ibuf, const int level, Array<Vector<char>> &r_chunks)
+{
+  const char *data = seq_disk_cache_image_data(ibuf);
+  const int64_t size_raw = int64_t(seq_disk_cache_image_data_size(ibuf));
+  const int64_t chunks_num = divide_ceil_ul(size_raw, DCACHE_COMPRESSION_CHUNK_SIZE);
+  r_chunks.reinitialize(chunks_num);
+
+  /* Isolated, such that this thread doesn't run unrelated tasks while waiting for the chunks,
+   * which might wait for locks held by the caller. */
+  threading::isolate_task([&]() {
+    threading::parallel_for(IndexRange(chunks_num), 1, [&](const IndexRange range) {
+      for (const int64_t i : range) {
+        const int64_t chunk_start = i * DCACHE_COMPRESSION_CHUNK_SIZE;
+        const size_t chunk_size = std::min<int64_t>(DCACHE_COMPRESSION_CHUNK_SIZE,
+                                                    size_raw - chunk_start);
+        Vector<char> &chunk = r_chunks[i];
+        chunk.resize(ZSTD_compressBound(chunk_size));
+        const size_t compressed_size = ZSTD_compress(
+            chunk.data(), chunk.size(), data + chunk_start, chunk_size, level);
+        chunk.resize(ZSTD_isError(compressed_size) ? 0 : compressed_size);
+      }
+    });
+  });
+
+  for (const Vector<char> &chunk : r_chunks) {
+    if (chunk.is_empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Write the compressed chunks of the image to the file at the offset of the header entry, or the
+ * raw pixels if there are no chunks. Returns the number of written bytes, zero on failure. */
+static size_t write_imbuf_data(const ImBuf *ibuf,
+                               const Span<Vector<char>> chunks,
+                               FILE *file,
+                               const DiskCacheHeaderEntry *header_entry)
 {
-  void *data = (ibuf->byte_buffer.data != nullptr) ? (void *)ibuf->byte_buffer.data :
-                                                     (void *)ibuf->float_buffer.data;
+  BLI_fseek(file, header_entry->offset, SEEK_SET);
 
-  /* Apply compression if wanted, otherwise just write directly to the file. */
-  if (level > 0) {
-    return BLI_file_zstd_from_mem_at_pos(
-        data, header_entry->size_raw, file, header_entry->offset, level);
+  if (chunks.is_empty()) {
+    return fwrite(seq_disk_cache_image_data(ibuf), 1, header_entry->size_raw, file);
   }
 
-  fseek(file, header_entry->offset, SEEK_SET);
-  return fwrite(data, 1, header_entry->size_raw, file);
+  size_t bytes_written = 0;
+  for (const Vector<char> &chunk : chunks) {
+    if (fwrite(chunk.data(), 1, chunk.size(), file) != chunk.size()) {
+      return 0;
+    }
+    bytes_written += chunk.size();
+  }
+  return bytes_written;
 }
 
-static size_t inflate_file_to_imbuf(ImBuf *ibuf, FILE *file, DiskCacheHeaderEntry *header_entry)
+/* Read the data of the header entry from the file. Raw pixels are read directly into the image,
+ * compressed data is read into \a r_compressed, to be decompressed by #decompress_to_imbuf.
+ * Returns false on failure. */
+static bool read_imbuf_data(ImBuf *ibuf,
+                            FILE *file,
+                            const DiskCacheHeaderEntry *header_entry,
+                            Array<char, 0> &r_compressed)
 {
-  void *data = (ibuf->byte_buffer.data != nullptr) ? (void *)ibuf->byte_buffer.data :
-                                                     (void *)ibuf->float_buffer.data;
   char header[4];
-  fseek(file, header_entry->offset, SEEK_SET);
+  BLI_fseek(file, header_entry->offset, SEEK_SET);
   if (fread(header, 1, sizeof(header), file) != sizeof(header)) {
-    return 0;
+    return false;
   }
 
   /* Check if the data is compressed or raw. */
-  if (BLI_file_magic_is_zstd(header)) {
-    return BLI_file_unzstd_to_mem_at_pos(data, header_entry->size_raw, file, header_entry->offset);
+  BLI_fseek(file, header_entry->offset, SEEK_SET);
+  if (!BLI_file_magic_is_zstd(header)) {
+    return fread(seq_disk_cache_image_data(ibuf), 1, header_entry->size_raw, file) ==
+           header_entry->size_raw;
   }
 
-  fseek(file, header_entry->offset, SEEK_SET);
-  return fread(data, 1, header_entry->size_raw, file);
+  const size_t size_compressed = header_entry->size_compressed;
+  r_compressed.reinitialize(size_compressed);
+  return fread(r_compressed.data(), 1, size_compressed, file) == size_compressed;
+}
+
+/* Decompress the independently compressed chunks of the data into the image in parallel. Returns
+ * the number of decompressed bytes, zero on failure. */
+static size_t decompress_to_imbuf(ImBuf *ibuf, const Span<char> compressed, const size_t size_raw)
+{
+  char *data = seq_disk_cache_image_data(ibuf);
+
+  /* Find the chunks, so they can be decompressed in parallel. */
+  struct Chunk {
+    size_t compressed_offset;
+    size_t compressed_size;
+    size_t raw_offset;
+    size_t raw_size;
+  };
+  Vector<Chunk> chunks;
+  size_t compressed_offset = 0;
+  size_t raw_offset = 0;
+  while (compressed_offset < size_t(compressed.size())) {
+    const char *frame = compressed.data() + compressed_offset;
+    const size_t frame_size = ZSTD_findFrameCompressedSize(frame,
+                                                           compressed.size() - compressed_offset);
+    if (ZSTD_isError(frame_size)) {
+      return 0;
+    }
+    const uint64_t raw_size = ZSTD_getFrameContentSize(frame, frame_size);
+    if (ELEM(raw_size, ZSTD_CONTENTSIZE_UNKNOWN, ZSTD_CONTENTSIZE_ERROR) ||
+        raw_offset + raw_size > size_raw)
+    {
+      return 0;
+    }
+    chunks.append({compressed_offset, frame_size, raw_offset, size_t(raw_size)});
+    compressed_offset += frame_size;
+    raw_offset += raw_size;
+  }
+
+  std::atomic<bool> is_valid = true;
+  /* Isolated, see #compress_imbuf. */
+  threading::isolate_task([&]() {
+    threading::parallel_for(chunks.index_range(), 1, [&](const IndexRange range) {
+      for (const Chunk &chunk : chunks.as_span().slice(range)) {
+        const size_t size = ZSTD_decompress(data + chunk.raw_offset,
+                                            chunk.raw_size,
+                                            compressed.data() + chunk.compressed_offset,
+                                            chunk.compressed_size);
+        if (size != chunk.raw_size) {
+          is_valid = false;
+        }
+      }
+    });
+  });
+
+  return is_valid ? raw_offset : 0;
 }
 
 static bool seq_disk_cache_read_header(FILE *file, DiskCacheHeader *header)
@@ -480,7 +670,7 @@ static size_t seq_disk_cache_write_header(FILE *file, const DiskCacheHeader *hea
   return fwrite(header, sizeof(*header), 1, file);
 }
 
-static int seq_disk_cache_add_header_entry(const SeqCacheKey *key,
+static int seq_disk_cache_add_header_entry(const DiskCacheWrite *write,
                                            ImBuf *ibuf,
                                            DiskCacheHeader *header)
 {
@@ -515,16 +705,15 @@ static int seq_disk_cache_add_header_entry(const SeqCacheKey *key,
   }
 
   header->entry[i].offset = offset;
-  header->entry[i].frameno = key->frame_index;
+  header->entry[i].frameno = write->frame_index;
 
   /* Store colorspace name of ibuf. */
   const char *colorspace_name;
+  header->entry[i].size_raw = seq_disk_cache_image_data_size(ibuf);
   if (ibuf->byte_buffer.data) {
-    header->entry[i].size_raw = int64_t(ibuf->x) * ibuf->y * ibuf->channels;
     colorspace_name = IMB_colormanagement_get_rect_colorspace(ibuf);
   }
   else {
-    header->entry[i].size_raw = int64_t(ibuf->x) * ibuf->y * ibuf->channels * 4;
     colorspace_name = IMB_colormanagement_get_float_colorspace(ibuf);
   }
   STRNCPY(header->entry[i].colorspace_name, colorspace_name);
@@ -535,7 +724,7 @@ static int seq_disk_cache_add_header_entry(const SeqCacheKey *key,
 static int seq_disk_cache_get_header_entry(const SeqCacheKey *key, const DiskCacheHeader *header)
 {
   for (int i = 0; i < DCACHE_IMAGES_PER_FILE; i++) {
-    if (header->entry[i].frameno == key->frame_index) {
+    if (header->entry[i].frameno == key->frame_index && header->entry[i].size_compressed != 0) {
       return i;
     }
   }
@@ -543,89 +732,209 @@ static int seq_disk_cache_get_header_entry(const SeqCacheKey *key, const DiskCac
   return -1;
 }
 
-bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf *ibuf)
+/* Ensures the header of the file is in memory, reading it from the given file if needed. */
+static bool seq_disk_cache_ensure_header(DiskCacheFile *cache_file, FILE *file)
 {
-  BLI_mutex_lock(&disk_cache->read_write_mutex);
+  if (cache_file->header != nullptr) {
+    return true;
+  }
 
-  char filepath[FILE_MAX];
+  DiskCacheHeader *header = MEM_callocN<DiskCacheHeader>("DiskCacheHeader");
+  /* The file may be empty when just created.
+   * This is fine, don't attempt reading the header in that case. */
+  if (cache_file->fstat.st_size != 0 && !seq_disk_cache_read_header(file, header)) {
+    MEM_freeN(header);
+    return false;
+  }
+  cache_file->header = header;
+  return true;
+}
 
-  seq_disk_cache_get_file_path(disk_cache, key, filepath, sizeof(filepath));
-  BLI_file_ensure_parent_dir_exists(filepath);
+/* Write the image, with its data compressed into the given chunks if there are any. The read/write
+ * mutex is expected to be locked. */
+static bool seq_disk_cache_write_image(SeqDiskCache *disk_cache,
+                                       const DiskCacheWrite *write,
+                                       const Span<Vector<char>> chunks)
+{
+  const char *filepath = write->filepath;
 
   /* Touch the file. */
-  FILE *file = BLI_fopen(filepath, "rb+");
+  DiskCacheFile *cache_file = seq_disk_cache_get_file_entry_by_path(disk_cache, filepath);
+  FILE *file = cache_file ? BLI_fopen(filepath, "rb+") : nullptr;
+  if (cache_file && !file) {
+    /* File may have been manually deleted during runtime. */
+    seq_disk_cache_delete_file(disk_cache, cache_file);
+    cache_file = nullptr;
+  }
   if (!file) {
+    BLI_file_ensure_parent_dir_exists(filepath);
     file = BLI_fopen(filepath, "wb+");
     if (!file) {
-      BLI_mutex_unlock(&disk_cache->read_write_mutex);
       return false;
     }
-    seq_disk_cache_add_file_to_list(disk_cache, filepath);
+    cache_file = seq_disk_cache_add_file_to_list(disk_cache, filepath);
   }
 
-  DiskCacheFile *cache_file = seq_disk_cache_get_file_entry_by_path(disk_cache, filepath);
-  DiskCacheHeader header;
-  memset(&header, 0, sizeof(header));
-  /* The file may be empty when touched (above).
-   * This is fine, don't attempt reading the header in that case. */
-  if (cache_file->fstat.st_size != 0 && !seq_disk_cache_read_header(file, &header)) {
+  if (!seq_disk_cache_ensure_header(cache_file, file)) {
     fclose(file);
     seq_disk_cache_delete_file(disk_cache, cache_file);
-    BLI_mutex_unlock(&disk_cache->read_write_mutex);
     return false;
   }
-  int entry_index = seq_disk_cache_add_header_entry(key, ibuf, &header);
 
-  size_t bytes_written = deflate_imbuf_to_file(
-      ibuf, file, seq_disk_cache_compression_level(), &header.entry[entry_index]);
+  DiskCacheHeader *header = cache_file->header;
+  int entry_index = seq_disk_cache_add_header_entry(write, write->ibuf, header);
+
+  size_t bytes_written = write_imbuf_data(write->ibuf, chunks, file, &header->entry[entry_index]);
 
   if (bytes_written != 0) {
     /* Last step is writing header, as image data can be overwritten,
      * but missing data would cause problems.
      */
-    header.entry[entry_index].size_compressed = bytes_written;
-    seq_disk_cache_write_header(file, &header);
-    seq_disk_cache_update_file(disk_cache, filepath);
+    header->entry[entry_index].size_compressed = bytes_written;
+    seq_disk_cache_write_header(file, header);
     fclose(file);
-
-    BLI_mutex_unlock(&disk_cache->read_write_mutex);
+    seq_disk_cache_update_file(disk_cache, cache_file);
     return true;
   }
 
-  BLI_mutex_unlock(&disk_cache->read_write_mutex);
+  fclose(file);
+  /* Don't keep the entry of the image that failed to be written. */
+  MEM_SAFE_FREE(cache_file->header);
   return false;
 }
 
-ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *key)
+static void seq_disk_cache_write_task(TaskPool *__restrict pool, void *task_data)
 {
+  SeqDiskCache *disk_cache = static_cast<SeqDiskCache *>(BLI_task_pool_user_data(pool));
+  DiskCacheWrite *write = static_cast<DiskCacheWrite *>(task_data);
+
+  /* Skip compressing images that were cancelled while waiting, for instance because the cache is
+   * being freed. */
+  bool is_cancelled;
+  {
+    std::scoped_lock lock(disk_cache->pending_writes_mutex);
+    is_cancelled = write->is_cancelled;
+  }
+
+  /* Compress before locking, such that reading other images doesn't wait for compression. */
+  const int level = seq_disk_cache_compression_level();
+  Array<Vector<char>> chunks;
+  const bool is_compressed = !is_cancelled &&
+                             (level <= 0 || compress_imbuf(write->ibuf, level, chunks));
+
   BLI_mutex_lock(&disk_cache->read_write_mutex);
+  /* Cancellation happens with the read/write mutex locked, so this doesn't need the pending
+   * writes mutex. */
+  if (!write->is_cancelled && is_compressed &&
+      seq_disk_cache_write_image(disk_cache, write, chunks))
+  {
+    seq_disk_cache_enforce_limits(disk_cache);
+  }
+  BLI_mutex_unlock(&disk_cache->read_write_mutex);
 
-  char filepath[FILE_MAX];
-  DiskCacheHeader header;
+  {
+    std::scoped_lock lock(disk_cache->pending_writes_mutex);
+    disk_cache->pending_writes.remove_first_occurrence_and_reorder(write);
+  }
+  disk_cache->pending_writes_condition.notify_all();
+
+  IMB_freeImBuf(write->ibuf);
+  MEM_delete(write);
+}
+
+void seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf *ibuf)
+{
+  /* Everything the writer needs is copied from the key, as the strip may be freed before the
+   * image is written. */
+  DiskCacheWrite *write = MEM_new<DiskCacheWrite>(__func__);
+  seq_disk_cache_get_file_path(disk_cache, key, write->filepath, sizeof(write->filepath));
+  BLI_path_split_dir_part(write->filepath, write->dir, sizeof(write->dir));
+  write->cache_type = key->type;
+  write->start_frame = (int(key->frame_index) / DCACHE_IMAGES_PER_FILE) * DCACHE_IMAGES_PER_FILE;
+  write->frame_index = key->frame_index;
+  write->ibuf = ibuf;
+  IMB_refImBuf(ibuf);
+
+  {
+    std::unique_lock lock(disk_cache->pending_writes_mutex);
+    disk_cache->pending_writes_condition.wait(lock, [&]() {
+      return disk_cache->pending_writes.size() < DCACHE_MAX_PENDING_WRITES;
+    });
+    disk_cache->pending_writes.append(write);
+  }
 
+  BLI_task_pool_push(disk_cache->write_pool, seq_disk_cache_write_task, write, false, nullptr);
+}
+
+static ImBuf *seq_disk_cache_pending_write_get(SeqDiskCache *disk_cache,
+                                               const SeqCacheKey *key,
+                                               const char *filepath)
+{
+  std::scoped_lock lock(disk_cache->pending_writes_mutex);
+  for (DiskCacheWrite *write : disk_cache->pending_writes) {
+    if (!write->is_cancelled && write->frame_index == key->frame_index &&
+        STREQ(write->filepath, filepath))
+    {
+      IMB_refImBuf(write->ibuf);
+      return write->ibuf;
+    }
+  }
+  return nullptr;
+}
+
+ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *key)
+{
+  char filepath[FILE_MAX];
   seq_disk_cache_get_file_path(disk_cache, key, filepath, sizeof(filepath));
-  BLI_file_ensure_parent_dir_exists(filepath);
 
-  FILE *file = BLI_fopen(filepath, "rb");
-  if (!file) {
-    BLI_mutex_unlock(&disk_cache->read_write_mutex);
-    return nullptr;
+  if (ImBuf *ibuf = seq_disk_cache_pending_write_get(disk_cache, key, filepath)) {
+    return ibuf;
   }
 
-  if (!seq_disk_cache_read_header(file, &header)) {
-    fclose(file);
+  BLI_mutex_lock(&disk_cache->read_write_mutex);
+
+  /* Images of files which are not in the index are not cached, no need to touch the disk. */
+  DiskCacheFile *cache_file = seq_disk_cache_get_file_entry_by_path(disk_cache, filepath);
+  if (!cache_file) {
     BLI_mutex_unlock(&disk_cache->read_write_mutex);
     return nullptr;
   }
+
+  FILE *file = nullptr;
+  if (cache_file->header == nullptr) {
+    file = BLI_fopen(filepath, "rb");
+    if (!file || !seq_disk_cache_ensure_header(cache_file, file)) {
+      if (file) {
+        fclose(file);
+      }
+      seq_disk_cache_delete_file(disk_cache, cache_file);
+      BLI_mutex_unlock(&disk_cache->read_write_mutex);
+      return nullptr;
+    }
+  }
+
+  DiskCacheHeader &header = *cache_file->header;
   int entry_index = seq_disk_cache_get_header_entry(key, &header);
 
   /* Item not found. */
   if (entry_index < 0) {
-    fclose(file);
+    if (file) {
+      fclose(file);
+    }
     BLI_mutex_unlock(&disk_cache->read_write_mutex);
     return nullptr;
   }
 
+  if (!file) {
+    file = BLI_fopen(filepath, "rb");
+    if (!file) {
+      /* File may have been manually deleted during runtime. */
+      seq_disk_cache_delete_file(disk_cache, cache_file);
+      BLI_mutex_unlock(&disk_cache->read_write_mutex);
+      return nullptr;
+    }
+  }
+
   ImBuf *ibuf;
   uint64_t size_char = uint64_t(key->context.rectx) * key->context.recty * 4;
   uint64_t size_float = uint64_t(key->context.rectx) * key->context.recty * 16;
@@ -649,40 +958,71 @@ ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *key)
     return nullptr;
   }
 
-  size_t bytes_read = inflate_file_to_imbuf(ibuf, file, &header.entry[entry_index]);
-
-  /* Sanity check. */
-  if (bytes_read != expected_size) {
-    fclose(file);
+  /* Only read the data with the mutex locked, decompression happens after unlocking it, such
+   * that other reads and the writer don't wait for it. */
+  Array<char, 0> compressed;
+  const bool is_read = read_imbuf_data(ibuf, file, &header.entry[entry_index], compressed);
+  fclose(file);
+  if (!is_read) {
     IMB_freeImBuf(ibuf);
     BLI_mutex_unlock(&disk_cache->read_write_mutex);
     return nullptr;
   }
   BLI_file_touch(filepath);
-  seq_disk_cache_update_file(disk_cache, filepath);
-  fclose(file);
-
+  seq_disk_cache_update_file(disk_cache, cache_file);
   BLI_mutex_unlock(&disk_cache->read_write_mutex);
+
+  if (!compressed.is_empty()) {
+    /* Sanity check. */
+    if (decompress_to_imbuf(ibuf, compressed, expected_size) != expected_size) {
+      IMB_freeImBuf(ibuf);
+      return nullptr;
+    }
+  }
+
   return ibuf;
 }
 
 SeqDiskCache *seq_disk_cache_create(Main *bmain, Scene *scene)
 {
-  SeqDiskCache *disk_cache = MEM_callocN<SeqDiskCache>("SeqDiskCache");
+  SeqDiskCache *disk_cache = MEM_new<SeqDiskCache>("SeqDiskCache");
   disk_cache->bmain = bmain;
   BLI_mutex_init(&disk_cache->read_write_mutex);
   seq_disk_cache_handle_versioning(disk_cache);
   seq_disk_cache_get_files(disk_cache, seq_disk_cache_base_dir());
+  /* Files which were used least recently are deleted first. */
+  BLI_listbase_sort(&disk_cache->files, seq_disk_cache_file_mtime_cmp);
   disk_cache->timestamp = scene->ed->disk_cache_timestamp;
-  BLI_mutex_unlock(&cache_create_lock);
+  disk_cache->write_pool = BLI_task_pool_create_background_serial(disk_cache, TASK_PRIORITY_LOW);
   return disk_cache;
 }
 
+int seq_disk_cache_pending_writes_num(SeqDiskCache *disk_cache)
+{
+  std::scoped_lock lock(disk_cache->pending_writes_mutex);
+  return int(disk_cache->pending_writes.size());
+}
+
 void seq_disk_cache_free(SeqDiskCache *disk_cache)
 {
+  /* Don't wait for images which are not written yet, only for the one that is being written. */
+  BLI_mutex_lock(&disk_cache->read_write_mutex);
+  {
+    std::scoped_lock lock(disk_cache->pending_writes_mutex);
+    for (DiskCacheWrite *write : disk_cache->pending_writes) {
+      write->is_cancelled = true;
+    }
+  }
+  BLI_mutex_unlock(&disk_cache->read_write_mutex);
+
+  BLI_task_pool_work_and_wait(disk_cache->write_pool);
+  BLI_task_pool_free(disk_cache->write_pool);
+  LISTBASE_FOREACH (DiskCacheFile *, cache_file, &disk_cache->files) {
+    MEM_SAFE_FREE(cache_file->header);
+  }
   BLI_freelistN(&disk_cache->files);
   BLI_mutex_end(&disk_cache->read_write_mutex);
-  MEM_freeN(disk_cache);
+  MEM_delete(disk_cache);
 }
 
 }  // namespace blender::seq
@@ -22,11 +22,20 @@ struct SeqCacheKey;
 struct SeqDiskCache;
 
 SeqDiskCache *seq_disk_cache_create(Main *bmain, Scene *scene);
+/**
+ * Images that are waiting to be written are discarded, only the image that is being written when
+ * the cache is freed is still written.
+ */
 void seq_disk_cache_free(SeqDiskCache *disk_cache);
 bool seq_disk_cache_is_enabled(Main *bmain);
 ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *key);
-bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf *ibuf);
-bool seq_disk_cache_enforce_limits(SeqDiskCache *disk_cache);
+/**
+ * Queues the image to be compressed and written by a background task, the size limit of the disk
+ * cache is enforced after writing. Waits when too many images are waiting to be written already.
+ */
+void seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf *ibuf);
+/** Number of images that are waiting to be written or are being written. */
+int seq_disk_cache_pending_writes_num(SeqDiskCache *disk_cache);
 void seq_disk_cache_invalidate(SeqDiskCache *disk_cache,
                                Scene *scene,
                                Strip *strip,
@@ -8,9 +8,12 @@
  * \ingroup sequencer
  */
 
+#include <cstring>
+
 #include "BLI_array.hh"
 #include "BLI_math_color.h"
 #include "BLI_math_vector_types.hh"
+#include "BLI_simd.hh"
 #include "BLI_task.hh"
 #include "IMB_imbuf_types.hh"
 #include "SEQ_effects.hh"
@@ -42,6 +45,30 @@ ImBuf *prepare_effect_imbufs(const RenderData *context,
 
 blender::Array<float> make_gaussian_blur_kernel(float rad, int size);
 
+/**
+ * Render functions of the effects that have SIMD code paths, where `use_simd` chooses between the
+ * SIMD and the scalar code paths. The `execute` callbacks of the effects use the SIMD code paths
+ * where available, tests compare their results with the scalar code paths.
+ */
+ImBuf *add_effect_render(
+    const RenderData *context, Strip *strip, float fac, ImBuf *src1, ImBuf *src2, bool use_simd);
+ImBuf *sub_effect_render(
+    const RenderData *context, Strip *strip, float fac, ImBuf *src1, ImBuf *src2, bool use_simd);
+ImBuf *mul_effect_render(
+    const RenderData *context, Strip *strip, float fac, ImBuf *src1, ImBuf *src2, bool use_simd);
+ImBuf *cross_effect_render(
+    const RenderData *context, Strip *strip, float fac, ImBuf *src1, ImBuf *src2, bool use_simd);
+ImBuf *gamma_cross_effect_render(
+    const RenderData *context, Strip *strip, float fac, ImBuf *src1, ImBuf *src2, bool use_simd);
+ImBuf *alpha_over_effect_render(
+    const RenderData *context, Strip *strip, float fac, ImBuf *src1, ImBuf *src2, bool use_simd);
+ImBuf *alpha_under_effect_render(
+    const RenderData *context, Strip *strip, float fac, ImBuf *src1, ImBuf *src2, bool use_simd);
+ImBuf *gaussian_blur_effect_render(
+    const RenderData *context, Strip *strip, float fac, ImBuf *ibuf1, ImBuf *ibuf2, bool use_simd);
+ImBuf *glow_effect_render(
+    const RenderData *context, Strip *strip, float fac, ImBuf *ibuf1, ImBuf *ibuf2, bool use_simd);
+
 inline blender::float4 load_premul_pixel(const uchar *ptr)
 {
   blender::float4 res;
@@ -64,6 +91,88 @@ inline void store_premul_pixel(const blender::float4 &pix, float *dst)
   *reinterpret_cast<blender::float4 *>(dst) = pix;
 }
 
+#if BLI_HAVE_SSE2
+/* SIMD variants of the pixel functions above, one RGBA pixel fills a register. The results match
+ * the scalar functions. */
+
+inline __m128 load_pixel_simd(const uchar *ptr)
+{
+  int32_t bytes;
+  memcpy(&bytes, ptr, sizeof(bytes));
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i words = _mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero);
+  return _mm_cvtepi32_ps(_mm_unpacklo_epi16(words, zero));
+}
+
+inline __m128 load_pixel_simd(const float *ptr)
+{
+  return _mm_loadu_ps(ptr);
+}
+
+/* Stores the pixel rounded to the nearest byte values, the values are expected to be in range. */
+inline void store_pixel_simd(const __m128 pix, uchar *dst)
+{
+  const __m128i ints = _mm_cvttps_epi32(_mm_add_ps(pix, _mm_set1_ps(0.5f)));
+  const __m128i words = _mm_packs_epi32(ints, ints);
+  const int32_t bytes = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+  memcpy(dst, &bytes, sizeof(bytes));
+}
+
+inline void store_pixel_simd(const __m128 pix, float *dst)
+{
+  _mm_storeu_ps(dst, pix);
+}
+
+/* Returns a register with the alpha of the given pixel in all lanes. */
+inline __m128 alpha_simd(const __m128 pix)
+{
+  return _mm_shuffle_ps(pix, pix, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+/* Returns the color channels of `color` with the alpha channel of `alpha`. */
+inline __m128 replace_alpha_simd(const __m128 color, const __m128 alpha)
+{
+  const __m128 rgb_mask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+  return _mm_or_ps(_mm_and_ps(rgb_mask, color), _mm_andnot_ps(rgb_mask, alpha));
+}
+
+inline __m128 load_premul_pixel_simd(const uchar *ptr)
+{
+  const __m128 col = load_pixel_simd(ptr);
+  const __m128 alpha = _mm_mul_ps(alpha_simd(col), _mm_set1_ps(1.0f / 255.0f));
+  const __m128 fac = _mm_mul_ps(alpha, _mm_set1_ps(1.0f / 255.0f));
+  return replace_alpha_simd(_mm_mul_ps(col, fac), alpha);
+}
+
+inline __m128 load_premul_pixel_simd(const float *ptr)
+{
+  return _mm_loadu_ps(ptr);
+}
+
+inline void store_premul_pixel_simd(const __m128 pix, uchar *dst)
+{
+  /* Un-premultiply unless alpha is zero or one, then clamp like #unit_float_to_uchar_clamp. */
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 alpha = alpha_simd(pix);
+  const __m128 is_zero_or_one = _mm_or_ps(_mm_cmpeq_ps(alpha, _mm_setzero_ps()),
+                                          _mm_cmpeq_ps(alpha, one));
+  const __m128 alpha_inv = _mm_or_ps(_mm_and_ps(is_zero_or_one, one),
+                                     _mm_andnot_ps(is_zero_or_one, _mm_div_ps(one, alpha)));
+  const __m128 straight = replace_alpha_simd(_mm_mul_ps(pix, alpha_inv), pix);
+  const __m128 scaled = _mm_add_ps(_mm_mul_ps(straight, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f));
+  const __m128 clamped = _mm_min_ps(_mm_max_ps(scaled, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+  const __m128i ints = _mm_cvttps_epi32(clamped);
+  const __m128i words = _mm_packs_epi32(ints, ints);
+  const int32_t bytes = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+  memcpy(dst, &bytes, sizeof(bytes));
+}
+
+inline void store_premul_pixel_simd(const __m128 pix, float *dst)
+{
+  _mm_storeu_ps(dst, pix);
+}
+#endif
+
 inline void store_opaque_black_pixel(uchar *dst)
 {
   dst[0] = 0;
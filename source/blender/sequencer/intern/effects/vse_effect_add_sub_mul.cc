@@ -16,6 +16,44 @@
 
 namespace blender::seq {
 
+#if BLI_HAVE_SSE2
+/* Returns the alpha of the two pixels in the 16-bit lanes of the given bytes, in all lanes of the
+ * pixel. */
+static __m128i alpha_epi16_simd(const __m128i pixels)
+{
+  return _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)),
+                             _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+/* Returns the color channels of `color` with the alpha channel of `alpha`, for two pixels in
+ * 16-bit lanes. */
+static __m128i replace_alpha_epi16_simd(const __m128i color, const __m128i alpha)
+{
+  const __m128i rgb_mask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+  return _mm_or_si128(_mm_and_si128(rgb_mask, color), _mm_andnot_si128(rgb_mask, alpha));
+}
+
+/* Computes `min(a + ((ifac * b.a * b) >> 16), 255)` for Add or `max(a - ..., 0)` for Subtract,
+ * keeping the alpha of `a`, on four byte pixels. The factor and the products fit in 16-bit lanes
+ * when `ifac <= 256`. */
+template<bool is_add>
+static __m128i add_sub_byte_simd(const __m128i a, const __m128i b, const __m128i ifac)
+{
+  const __m128i zero = _mm_setzero_si128();
+  __m128i result[2];
+  for (int half = 0; half < 2; half++) {
+    const __m128i a16 = half ? _mm_unpackhi_epi8(a, zero) : _mm_unpacklo_epi8(a, zero);
+    const __m128i b16 = half ? _mm_unpackhi_epi8(b, zero) : _mm_unpacklo_epi8(b, zero);
+    const __m128i f = _mm_mullo_epi16(ifac, alpha_epi16_simd(b16));
+    const __m128i t = _mm_mulhi_epu16(f, b16);
+    const __m128i color = is_add ? _mm_add_epi16(a16, t) : _mm_subs_epu16(a16, t);
+    result[half] = replace_alpha_epi16_simd(color, a16);
+  }
+  /* Packing saturates the sums to 255. */
+  return _mm_packus_epi16(result[0], result[1]);
+}
+#endif
+
 /* -------------------------------------------------------------------- */
 /* Color Add Effect */
 
@@ -24,6 +62,36 @@ struct AddEffectOp {
   {
     const float fac = this->factor;
     int ifac = int(256.0f * fac);
+#if BLI_HAVE_SSE2
+    if constexpr (std::is_same_v<T, uchar>) {
+      if (this->use_simd && ifac >= 0 && ifac <= 256) {
+        const __m128i ifac_v = _mm_set1_epi16(short(ifac));
+        for (; size >= 4; size -= 4) {
+          const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src1));
+          const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src2));
+          _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                           add_sub_byte_simd<true>(a, b, ifac_v));
+          src1 += 16;
+          src2 += 16;
+          dst += 16;
+        }
+      }
+    }
+    else if (this->use_simd) {
+      const __m128 one = _mm_set1_ps(1.0f);
+      const __m128 mfac_v = _mm_set1_ps(1.0f - fac);
+      for (; size > 0; size--) {
+        const __m128 col1 = _mm_loadu_ps(src1);
+        const __m128 col2 = _mm_loadu_ps(src2);
+        const __m128 f = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(alpha_simd(col1), mfac_v)),
+                                    alpha_simd(col2));
+        _mm_storeu_ps(dst, replace_alpha_simd(_mm_add_ps(col1, _mm_mul_ps(f, col2)), col1));
+        src1 += 4;
+        src2 += 4;
+        dst += 4;
+      }
+    }
+#endif
     for (int64_t idx = 0; idx < size; idx++) {
       if constexpr (std::is_same_v<T, uchar>) {
         const int f = ifac * int(src2[3]);
@@ -44,22 +112,34 @@ struct AddEffectOp {
     }
   }
   float factor;
+  bool use_simd = true;
 };
 
-static ImBuf *do_add_effect(const RenderData *context,
-                            Strip * /*seq*/,
-                            float /*timeline_frame*/,
-                            float fac,
-                            ImBuf *src1,
-                            ImBuf *src2)
+ImBuf *add_effect_render(const RenderData *context,
+                         Strip * /*strip*/,
+                         float fac,
+                         ImBuf *src1,
+                         ImBuf *src2,
+                         bool use_simd)
 {
   ImBuf *dst = prepare_effect_imbufs(context, src1, src2);
   AddEffectOp op;
   op.factor = fac;
+  op.use_simd = use_simd;
   apply_effect_op(op, src1, src2, dst);
   return dst;
 }
 
+static ImBuf *do_add_effect(const RenderData *context,
+                            Strip *strip,
+                            float /*timeline_frame*/,
+                            float fac,
+                            ImBuf *src1,
+                            ImBuf *src2)
+{
+  return add_effect_render(context, strip, fac, src1, src2, true);
+}
+
 /* -------------------------------------------------------------------- */
 /* Color Subtract Effect */
 
@@ -68,6 +148,37 @@ struct SubEffectOp {
   {
     const float fac = this->factor;
     int ifac = int(256.0f * fac);
+#if BLI_HAVE_SSE2
+    if constexpr (std::is_same_v<T, uchar>) {
+      if (this->use_simd && ifac >= 0 && ifac <= 256) {
+        const __m128i ifac_v = _mm_set1_epi16(short(ifac));
+        for (; size >= 4; size -= 4) {
+          const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src1));
+          const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src2));
+          _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                           add_sub_byte_simd<false>(a, b, ifac_v));
+          src1 += 16;
+          src2 += 16;
+          dst += 16;
+        }
+      }
+    }
+    else if (this->use_simd) {
+      const __m128 one = _mm_set1_ps(1.0f);
+      const __m128 mfac_v = _mm_set1_ps(1.0f - fac);
+      for (; size > 0; size--) {
+        const __m128 col1 = _mm_loadu_ps(src1);
+        const __m128 col2 = _mm_loadu_ps(src2);
+        const __m128 f = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(alpha_simd(col1), mfac_v)),
+                                    alpha_simd(col2));
+        const __m128 col = _mm_max_ps(_mm_sub_ps(col1, _mm_mul_ps(f, col2)), _mm_setzero_ps());
+        _mm_storeu_ps(dst, replace_alpha_simd(col, col1));
+        src1 += 4;
+        src2 += 4;
+        dst += 4;
+      }
+    }
+#endif
     for (int64_t idx = 0; idx < size; idx++) {
       if constexpr (std::is_same_v<T, uchar>) {
         const int f = ifac * int(src2[3]);
@@ -88,22 +199,34 @@ struct SubEffectOp {
     }
   }
   float factor;
+  bool use_simd = true;
 };
 
-static ImBuf *do_sub_effect(const RenderData *context,
-                            Strip * /*seq*/,
-                            float /*timeline_frame*/,
-                            float fac,
-                            ImBuf *src1,
-                            ImBuf *src2)
+ImBuf *sub_effect_render(const RenderData *context,
+                         Strip * /*strip*/,
+                         float fac,
+                         ImBuf *src1,
+                         ImBuf *src2,
+                         bool use_simd)
 {
   ImBuf *dst = prepare_effect_imbufs(context, src1, src2);
   SubEffectOp op;
   op.factor = fac;
+  op.use_simd = use_simd;
   apply_effect_op(op, src1, src2, dst);
   return dst;
 }
 
+static ImBuf *do_sub_effect(const RenderData *context,
+                            Strip *strip,
+                            float /*timeline_frame*/,
+                            float fac,
+                            ImBuf *src1,
+                            ImBuf *src2)
+{
+  return sub_effect_render(context, strip, fac, src1, src2, true);
+}
+
 /* -------------------------------------------------------------------- */
 /* Multiply Effect */
 
@@ -112,6 +235,52 @@ struct MulEffectOp {
   {
     const float fac = this->factor;
     int ifac = int(256.0f * fac);
+#if BLI_HAVE_SSE2
+    if constexpr (std::is_same_v<T, uchar>) {
+      if (this->use_simd && ifac >= 0 && ifac <= 256) {
+        /* The product `ifac * a * (255 - b)` doesn't fit in 16 bits, so the shifted negative
+         * product is computed as the ceiling of the shifted positive one, from its high and low
+         * halves. */
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi16(1);
+        const __m128i max = _mm_set1_epi16(255);
+        const __m128i ifac_v = _mm_set1_epi16(short(ifac));
+        for (; size >= 4; size -= 4) {
+          const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src1));
+          const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src2));
+          __m128i result[2];
+          for (int half = 0; half < 2; half++) {
+            const __m128i a16 = half ? _mm_unpackhi_epi8(a, zero) : _mm_unpacklo_epi8(a, zero);
+            const __m128i b16 = half ? _mm_unpackhi_epi8(b, zero) : _mm_unpacklo_epi8(b, zero);
+            const __m128i u = _mm_mullo_epi16(ifac_v, a16);
+            const __m128i v = _mm_sub_epi16(max, b16);
+            const __m128i product_hi = _mm_mulhi_epu16(u, v);
+            const __m128i product_lo_is_zero = _mm_cmpeq_epi16(_mm_mullo_epi16(u, v), zero);
+            const __m128i ceil = _mm_add_epi16(_mm_add_epi16(product_hi, one), product_lo_is_zero);
+            result[half] = _mm_sub_epi16(a16, ceil);
+          }
+          _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                           _mm_packus_epi16(result[0], result[1]));
+          src1 += 16;
+          src2 += 16;
+          dst += 16;
+        }
+      }
+    }
+    else if (this->use_simd) {
+      const __m128 one = _mm_set1_ps(1.0f);
+      const __m128 fac_v = _mm_set1_ps(fac);
+      for (; size > 0; size--) {
+        const __m128 col1 = _mm_loadu_ps(src1);
+        const __m128 col2 = _mm_loadu_ps(src2);
+        _mm_storeu_ps(
+            dst, _mm_add_ps(col1, _mm_mul_ps(_mm_mul_ps(fac_v, col1), _mm_sub_ps(col2, one))));
+        src1 += 4;
+        src2 += 4;
+        dst += 4;
+      }
+    }
+#endif
     for (int64_t idx = 0; idx < size; idx++) {
       /* Formula: `fac * (a * b) + (1-fac) * a => fac * a * (b - 1) + a` */
       if constexpr (std::is_same_v<T, uchar>) {
@@ -132,22 +301,34 @@ struct MulEffectOp {
     }
   }
   float factor;
+  bool use_simd = true;
 };
 
-static ImBuf *do_mul_effect(const RenderData *context,
-                            Strip * /*seq*/,
-                            float /*timeline_frame*/,
-                            float fac,
-                            ImBuf *src1,
-                            ImBuf *src2)
+ImBuf *mul_effect_render(const RenderData *context,
+                         Strip * /*strip*/,
+                         float fac,
+                         ImBuf *src1,
+                         ImBuf *src2,
+                         bool use_simd)
 {
   ImBuf *dst = prepare_effect_imbufs(context, src1, src2);
   MulEffectOp op;
   op.factor = fac;
+  op.use_simd = use_simd;
   apply_effect_op(op, src1, src2, dst);
   return dst;
 }
 
+static ImBuf *do_mul_effect(const RenderData *context,
+                            Strip *strip,
+                            float /*timeline_frame*/,
+                            float fac,
+                            ImBuf *src1,
+                            ImBuf *src2)
+{
+  return mul_effect_render(context, strip, fac, src1, src2, true);
+}
+
 void add_effect_get_handle(EffectHandle &rval)
 {
   rval.execute = do_add_effect;
@@ -60,11 +60,24 @@ struct AlphaOverEffectOp {
         memcpy(dst, src1, sizeof(T) * 4);
       }
       else {
-        float4 col1 = load_premul_pixel(src1);
-        float mfac = 1.0f - fac * col1.w;
-        float4 col2 = load_premul_pixel(src2);
-        float4 col = fac * col1 + mfac * col2;
-        store_premul_pixel(col, dst);
+#if BLI_HAVE_SSE2
+        if (this->use_simd) {
+          const __m128 fac_v = _mm_set1_ps(fac);
+          const __m128 col1 = load_premul_pixel_simd(src1);
+          const __m128 mfac = _mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(fac_v, alpha_simd(col1)));
+          const __m128 col2 = load_premul_pixel_simd(src2);
+          store_premul_pixel_simd(_mm_add_ps(_mm_mul_ps(fac_v, col1), _mm_mul_ps(mfac, col2)),
+                                  dst);
+        }
+        else
+#endif
+        {
+          float4 col1 = load_premul_pixel(src1);
+          float mfac = 1.0f - fac * col1.w;
+          float4 col2 = load_premul_pixel(src2);
+          float4 col = fac * col1 + mfac * col2;
+          store_premul_pixel(col, dst);
+        }
       }
       src1 += 4;
       src2 += 4;
@@ -73,22 +86,34 @@ struct AlphaOverEffectOp {
   }
 
   float factor;
+  bool use_simd = true;
 };
 
-static ImBuf *do_alphaover_effect(const RenderData *context,
-                                  Strip * /*strip*/,
-                                  float /*timeline_frame*/,
-                                  float fac,
-                                  ImBuf *src1,
-                                  ImBuf *src2)
+ImBuf *alpha_over_effect_render(const RenderData *context,
+                                Strip * /*strip*/,
+                                float fac,
+                                ImBuf *src1,
+                                ImBuf *src2,
+                                bool use_simd)
 {
   ImBuf *dst = prepare_effect_imbufs(context, src1, src2);
   AlphaOverEffectOp op;
   op.factor = fac;
+  op.use_simd = use_simd;
   apply_effect_op(op, src1, src2, dst);
   return dst;
 }
 
+static ImBuf *do_alphaover_effect(const RenderData *context,
+                                  Strip *strip,
+                                  float /*timeline_frame*/,
+                                  float fac,
+                                  ImBuf *src1,
+                                  ImBuf *src2)
+{
+  return alpha_over_effect_render(context, strip, fac, src1, src2, true);
+}
+
 /* -------------------------------------------------------------------- */
 /* Alpha Under Effect */
 
@@ -110,11 +135,23 @@ struct AlphaUnderEffectOp {
         memcpy(dst, src2, sizeof(T) * 4);
       }
       else {
-        float4 col2 = load_premul_pixel(src2);
-        float mfac = fac * (1.0f - col2.w);
-        float4 col1 = load_premul_pixel(src1);
-        float4 col = mfac * col1 + col2;
-        store_premul_pixel(col, dst);
+#if BLI_HAVE_SSE2
+        if (this->use_simd) {
+          const __m128 col2 = load_premul_pixel_simd(src2);
+          const __m128 mfac = _mm_mul_ps(_mm_set1_ps(fac),
+                                         _mm_sub_ps(_mm_set1_ps(1.0f), alpha_simd(col2)));
+          const __m128 col1 = load_premul_pixel_simd(src1);
+          store_premul_pixel_simd(_mm_add_ps(_mm_mul_ps(mfac, col1), col2), dst);
+        }
+        else
+#endif
+        {
+          float4 col2 = load_premul_pixel(src2);
+          float mfac = fac * (1.0f - col2.w);
+          float4 col1 = load_premul_pixel(src1);
+          float4 col = mfac * col1 + col2;
+          store_premul_pixel(col, dst);
+        }
       }
       src1 += 4;
       src2 += 4;
@@ -122,22 +159,34 @@ struct AlphaUnderEffectOp {
     }
   }
   float factor;
+  bool use_simd = true;
 };
 
-static ImBuf *do_alphaunder_effect(const RenderData *context,
-                                   Strip * /*strip*/,
-                                   float /*timeline_frame*/,
-                                   float fac,
-                                   ImBuf *src1,
-                                   ImBuf *src2)
+ImBuf *alpha_under_effect_render(const RenderData *context,
+                                 Strip * /*strip*/,
+                                 float fac,
+                                 ImBuf *src1,
+                                 ImBuf *src2,
+                                 bool use_simd)
 {
   ImBuf *dst = prepare_effect_imbufs(context, src1, src2);
   AlphaUnderEffectOp op;
   op.factor = fac;
+  op.use_simd = use_simd;
   apply_effect_op(op, src1, src2, dst);
   return dst;
 }
 
+static ImBuf *do_alphaunder_effect(const RenderData *context,
+                                   Strip *strip,
+                                   float /*timeline_frame*/,
+                                   float fac,
+                                   ImBuf *src1,
+                                   ImBuf *src2)
+{
+  return alpha_under_effect_render(context, strip, fac, src1, src2, true);
+}
+
 /* -------------------------------------------------------------------- */
 /* Blend Mode Effect */
 
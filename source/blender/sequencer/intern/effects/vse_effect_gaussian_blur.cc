@@ -52,6 +52,51 @@ static StripEarlyOut early_out_gaussian_blur(const Strip *strip, float /*fac*/)
   return StripEarlyOut::DoEffect;
 }
 
+/* Stores the weighted average of `num` source pixels which are `stride` values apart, weighted by
+ * the kernel starting at `index`. */
+template<typename T>
+static void gaussian_blur_pixel(const Span<float> gaussian,
+                                const int index,
+                                const T *src,
+                                const int64_t stride,
+                                const int num,
+                                const bool use_simd,
+                                T *dst)
+{
+  float accum_weight = 0.0f;
+#if BLI_HAVE_SSE2
+  if (use_simd) {
+    __m128 accum = _mm_setzero_ps();
+    for (int i = 0; i < num; i++, src += stride) {
+      const float weight = gaussian[index + i];
+      accum = _mm_add_ps(accum, _mm_mul_ps(load_pixel_simd(src), _mm_set1_ps(weight)));
+      accum_weight += weight;
+    }
+    store_pixel_simd(_mm_mul_ps(accum, _mm_set1_ps(1.0f / accum_weight)), dst);
+    return;
+  }
+#endif
+  float4 accum(0.0f);
+  for (int i = 0; i < num; i++, src += stride) {
+    const float weight = gaussian[index + i];
+    accum += float4(src) * weight;
+    accum_weight += weight;
+  }
+  accum *= (1.0f / accum_weight);
+  if constexpr (math::is_math_float_type<T>) {
+    dst[0] = accum[0];
+    dst[1] = accum[1];
+    dst[2] = accum[2];
+    dst[3] = accum[3];
+  }
+  else {
+    dst[0] = accum[0] + 0.5f;
+    dst[1] = accum[1] + 0.5f;
+    dst[2] = accum[2] + 0.5f;
+    dst[3] = accum[3] + 0.5f;
+  }
+}
+
 template<typename T>
 static void gaussian_blur_x(const Span<float> gaussian,
                             int half_size,
@@ -59,36 +104,22 @@ static void gaussian_blur_x(const Span<float> gaussian,
                             int width,
                             int height,
                             int /*frame_height*/,
+                            const bool use_simd,
                             const T *rect,
                             T *dst)
 {
   dst += int64_t(start_line) * width * 4;
   for (int y = start_line; y < start_line + height; y++) {
     for (int x = 0; x < width; x++) {
-      float4 accum(0.0f);
-      float accum_weight = 0.0f;
-
       int xmin = math::max(x - half_size, 0);
       int xmax = math::min(x + half_size, width - 1);
-      for (int nx = xmin, index = (xmin - x) + half_size; nx <= xmax; nx++, index++) {
-        float weight = gaussian[index];
-        int offset = (y * width + nx) * 4;
-        accum += float4(rect + offset) * weight;
-        accum_weight += weight;
-      }
-      accum *= (1.0f / accum_weight);
-      if constexpr (math::is_math_float_type<T>) {
-        dst[0] = accum[0];
-        dst[1] = accum[1];
-        dst[2] = accum[2];
-        dst[3] = accum[3];
-      }
-      else {
-        dst[0] = accum[0] + 0.5f;
-        dst[1] = accum[1] + 0.5f;
-        dst[2] = accum[2] + 0.5f;
-        dst[3] = accum[3] + 0.5f;
-      }
+      gaussian_blur_pixel(gaussian,
+                          (xmin - x) + half_size,
+                          rect + (int64_t(y) * width + xmin) * 4,
+                          4,
+                          xmax - xmin + 1,
+                          use_simd,
+                          dst);
       dst += 4;
     }
   }
@@ -101,46 +132,33 @@ static void gaussian_blur_y(const Span<float> gaussian,
                             int width,
                             int height,
                             int frame_height,
+                            const bool use_simd,
                             const T *rect,
                             T *dst)
 {
   dst += int64_t(start_line) * width * 4;
   for (int y = start_line; y < start_line + height; y++) {
     for (int x = 0; x < width; x++) {
-      float4 accum(0.0f);
-      float accum_weight = 0.0f;
       int ymin = math::max(y - half_size, 0);
       int ymax = math::min(y + half_size, frame_height - 1);
-      for (int ny = ymin, index = (ymin - y) + half_size; ny <= ymax; ny++, index++) {
-        float weight = gaussian[index];
-        int offset = (ny * width + x) * 4;
-        accum += float4(rect + offset) * weight;
-        accum_weight += weight;
-      }
-      accum *= (1.0f / accum_weight);
-      if constexpr (math::is_math_float_type<T>) {
-        dst[0] = accum[0];
-        dst[1] = accum[1];
-        dst[2] = accum[2];
-        dst[3] = accum[3];
-      }
-      else {
-        dst[0] = accum[0] + 0.5f;
-        dst[1] = accum[1] + 0.5f;
-        dst[2] = accum[2] + 0.5f;
-        dst[3] = accum[3] + 0.5f;
-      }
+      gaussian_blur_pixel(gaussian,
+                          (ymin - y) + half_size,
+                          rect + (int64_t(ymin) * width + x) * 4,
+                          int64_t(width) * 4,
+                          ymax - ymin + 1,
+                          use_simd,
+                          dst);
       dst += 4;
     }
   }
 }
 
-static ImBuf *do_gaussian_blur_effect(const RenderData *context,
-                                      Strip *strip,
-                                      float /*timeline_frame*/,
-                                      float /*fac*/,
-                                      ImBuf *ibuf1,
-                                      ImBuf * /*ibuf2*/)
+ImBuf *gaussian_blur_effect_render(const RenderData *context,
+                                   Strip *strip,
+                                   float /*fac*/,
+                                   ImBuf *ibuf1,
+                                   ImBuf * /*ibuf2*/,
+                                   bool use_simd)
 {
   using namespace blender;
 
@@ -167,6 +185,7 @@ static ImBuf *do_gaussian_blur_effect(const RenderData *context,
                       width,
                       y_size,
                       height,
+                      use_simd,
                       ibuf1->float_buffer.data,
                       out->float_buffer.data);
     }
@@ -177,6 +196,7 @@ static ImBuf *do_gaussian_blur_effect(const RenderData *context,
                       width,
                       y_size,
                       height,
+                      use_simd,
                       ibuf1->byte_buffer.data,
                       out->byte_buffer.data);
     }
@@ -195,6 +215,7 @@ static ImBuf *do_gaussian_blur_effect(const RenderData *context,
                       width,
                       y_size,
                       height,
+                      use_simd,
                       ibuf1->float_buffer.data,
                       out->float_buffer.data);
     }
@@ -205,6 +226,7 @@ static ImBuf *do_gaussian_blur_effect(const RenderData *context,
                       width,
                       y_size,
                       height,
+                      use_simd,
                       ibuf1->byte_buffer.data,
                       out->byte_buffer.data);
     }
@@ -216,6 +238,16 @@ static ImBuf *do_gaussian_blur_effect(const RenderData *context,
   return out;
 }
 
+static ImBuf *do_gaussian_blur_effect(const RenderData *context,
+                                      Strip *strip,
+                                      float /*timeline_frame*/,
+                                      float fac,
+                                      ImBuf *ibuf1,
+                                      ImBuf *ibuf2)
+{
+  return gaussian_blur_effect_render(context, strip, fac, ibuf1, ibuf2, true);
+}
+
 void gaussian_blur_effect_get_handle(EffectHandle &rval)
 {
   rval.init = init_gaussian_blur_effect;
@@ -6,6 +6,8 @@
  * \ingroup sequencer
  */
 
+#include <algorithm>
+
 #include "BLI_math_vector.hh"
 #include "BLI_task.hh"
 
@@ -21,8 +23,13 @@
 
 namespace blender::seq {
 
-static void glow_blur_bitmap(
-    const float4 *src, float4 *map, int width, int height, float blur, int quality)
+static void glow_blur_bitmap(const float4 *src,
+                             float4 *map,
+                             int width,
+                             int height,
+                             float blur,
+                             int quality,
+                             const bool use_simd)
 {
   using namespace blender;
 
@@ -63,9 +70,21 @@ static void glow_blur_bitmap(
   threading::parallel_for(IndexRange(height), 32, [&](const IndexRange y_range) {
     for (const int y : y_range) {
       for (int x = 0; x < width; x++) {
-        float4 curColor = float4(0.0f);
         int xmin = math::max(x - halfWidth, 0);
         int xmax = math::min(x + halfWidth, width);
+#if BLI_HAVE_SSE2
+        if (use_simd) {
+          __m128 curColor = _mm_setzero_ps();
+          for (int nx = xmin, index = (xmin - x) + halfWidth; nx < xmax; nx++, index++) {
+            curColor = _mm_add_ps(curColor,
+                                  _mm_mul_ps(_mm_loadu_ps(map[nx + y * width]),
+                                             _mm_set1_ps(filter[index])));
+          }
+          _mm_storeu_ps(temp[x + y * width], curColor);
+          continue;
+        }
+#endif
+        float4 curColor = float4(0.0f);
         for (int nx = xmin, index = (xmin - x) + halfWidth; nx < xmax; nx++, index++) {
           curColor += map[nx + y * width] * filter[index];
         }
@@ -74,21 +93,37 @@ static void glow_blur_bitmap(
     }
   });
 
-  /* Blur the columns: read temp, write map */
-  threading::parallel_for(IndexRange(width), 32, [&](const IndexRange x_range) {
+  /* Blur the columns: read temp, write map. Whole rows of temp are accumulated into rows of map,
+   * so memory is accessed sequentially. */
+  threading::parallel_for(IndexRange(height), 32, [&](const IndexRange y_range) {
     const float4 one = float4(1.0f);
-    for (const int x : x_range) {
-      for (int y = 0; y < height; y++) {
-        float4 curColor = float4(0.0f);
-        int ymin = math::max(y - halfWidth, 0);
-        int ymax = math::min(y + halfWidth, height);
-        for (int ny = ymin, index = (ymin - y) + halfWidth; ny < ymax; ny++, index++) {
-          curColor += temp[x + ny * width] * filter[index];
+    for (const int y : y_range) {
+      float4 *dst = map + int64_t(y) * width;
+      std::fill_n(dst, width, float4(0.0f));
+      int ymin = math::max(y - halfWidth, 0);
+      int ymax = math::min(y + halfWidth, height);
+      for (int ny = ymin, index = (ymin - y) + halfWidth; ny < ymax; ny++, index++) {
+        const float4 *row = temp.data() + int64_t(ny) * width;
+#if BLI_HAVE_SSE2
+        if (use_simd) {
+          const __m128 weight = _mm_set1_ps(filter[index]);
+          for (int x = 0; x < width; x++) {
+            const __m128 value = _mm_mul_ps(_mm_loadu_ps(row[x]), weight);
+            _mm_storeu_ps(dst[x], _mm_add_ps(_mm_loadu_ps(dst[x]), value));
+          }
+          continue;
+        }
+#endif
+        const float weight = filter[index];
+        for (int x = 0; x < width; x++) {
+          dst[x] += row[x] * weight;
         }
-        if (src != nullptr) {
-          curColor = math::min(one, src[x + y * width] + curColor);
+      }
+      if (src != nullptr) {
+        const float4 *src_row = src + int64_t(y) * width;
+        for (int x = 0; x < width; x++) {
+          dst[x] = math::min(one, src_row[x] + dst[x]);
         }
-        map[x + y * width] = curColor;
       }
     }
   });
@@ -163,7 +198,8 @@ static void do_glow_effect_byte(Strip *strip,
                                 int y,
                                 uchar *rect1,
                                 uchar * /*rect2*/,
-                                uchar *out)
+                                uchar *out,
+                                const bool use_simd)
 {
   using namespace blender;
   GlowVars *glow = (GlowVars *)strip->effectdata;
@@ -181,7 +217,8 @@ static void do_glow_effect_byte(Strip *strip,
                    x,
                    y,
                    glow->dDist * (render_size / 100.0f),
-                   glow->dQuality);
+                   glow->dQuality,
+                   use_simd);
 
   threading::parallel_for(IndexRange(y), 64, [&](const IndexRange y_range) {
     size_t offset = y_range.first() * x;
@@ -206,7 +243,8 @@ static void do_glow_effect_float(Strip *strip,
                                  int y,
                                  float *rect1,
                                  float * /*rect2*/,
-                                 float *out)
+                                 float *out,
+                                 const bool use_simd)
 {
   using namespace blender;
   float4 *outbuf = reinterpret_cast<float4 *>(out);
@@ -220,15 +258,16 @@ static void do_glow_effect_float(Strip *strip,
                    x,
                    y,
                    glow->dDist * (render_size / 100.0f),
-                   glow->dQuality);
+                   glow->dQuality,
+                   use_simd);
 }
 
-static ImBuf *do_glow_effect(const RenderData *context,
-                             Strip *strip,
-                             float /*timeline_frame*/,
-                             float fac,
-                             ImBuf *ibuf1,
-                             ImBuf *ibuf2)
+ImBuf *glow_effect_render(const RenderData *context,
+                          Strip *strip,
+                          float fac,
+                          ImBuf *ibuf1,
+                          ImBuf *ibuf2,
+                          bool use_simd)
 {
   ImBuf *out = prepare_effect_imbufs(context, ibuf1, ibuf2);
 
@@ -242,7 +281,8 @@ static ImBuf *do_glow_effect(const RenderData *context,
                          context->recty,
                          ibuf1->float_buffer.data,
                          nullptr,
-                         out->float_buffer.data);
+                         out->float_buffer.data,
+                         use_simd);
   }
   else {
     do_glow_effect_byte(strip,
@@ -252,12 +292,23 @@ static ImBuf *do_glow_effect(const RenderData *context,
                         context->recty,
                         ibuf1->byte_buffer.data,
                         nullptr,
-                        out->byte_buffer.data);
+                        out->byte_buffer.data,
+                        use_simd);
   }
 
   return out;
 }
 
+static ImBuf *do_glow_effect(const RenderData *context,
+                             Strip *strip,
+                             float /*timeline_frame*/,
+                             float fac,
+                             ImBuf *ibuf1,
+                             ImBuf *ibuf2)
+{
+  return glow_effect_render(context, strip, fac, ibuf1, ibuf2, true);
+}
+
 void glow_effect_get_handle(EffectHandle &rval)
 {
   rval.init = init_glow_effect;
@@ -6,9 +6,11 @@
  * \ingroup bke
  */
 
+#include <atomic>
 #include <cstddef>
 #include <ctime>
 #include <memory.h>
+#include <mutex>
 
 #include "MEM_guardedalloc.h"
 
@@ -19,10 +21,12 @@
 #include "IMB_imbuf.hh"
 #include "IMB_imbuf_types.hh"
 
+#include "BLI_function_ref.hh"
 #include "BLI_ghash.h"
 #include "BLI_math_base.h"
 #include "BLI_mempool.h"
 #include "BLI_threads.h"
+#include "BLI_vector.hh"
 
 #include "BKE_main.hh"
 
@@ -58,24 +62,76 @@
  * Once again, this is to reduce number of iterations, but also more controllable than removing
  * entries one by one in reverse order to their creation.
  *
+ * Recycling: The base keys of completely rendered frames are kept in a least recently used list,
+ * where a frame is used when its final image is put in or read from the cache. When the cache is
+ * full, the least recently used frame is recycled, except for frames in the range of a running
+ * prefetch job.
+ *
+ * Locking: Entries are distributed between shards based on the hash of their key, where each
+ * shard has its own mutex, hash and memory pools, so looking up images of different strips and
+ * frames from the prefetch job and from the UI doesn't contend on a single lock. Lookups only lock
+ * the shard of the entry, and lookups of final images additionally lock the least recently used
+ * list to move their frame to its front, which is a constant time operation.
+ *
+ * Linking and recycling are protected by the link mutex of the cache, which is always locked
+ * before the mutex of a shard. Putting images in the cache still locks it, since the entries of
+ * the frame that is being rendered are linked through #SeqCache::last_key, which is shared with
+ * invalidation and recycling that unlink and free entries. The lock is only held for the insertion
+ * into the shard and a few pointer updates, while images are only put once they are rendered, so
+ * unlike lookups during playback, puts don't contend on it in practice. Recycling is skipped
+ * without locking while the cache is not full.
+ *
+ * The least recently used list has its own mutex, which is locked after the mutex of a shard or
+ * the link mutex, and never while locking another mutex.
+ *
+ * Memory: The cache is full once the memory in use by the process exceeds the memory cache limit,
+ * since images can grow after they are put in the cache, for instance by allocating their display
+ * buffers. The sizes of the images when they are put in the cache are only counted for
+ * statistics.
+ *
  * User can exclude caching of some images. Such entries will have is_temp_cache set.
  */
 
 namespace blender::seq {
 
+static constexpr int SEQ_CACHE_SHARDS_NUM = 16;
+
+struct SeqCacheShard {
+  std::mutex mutex;
+  GHash *hash = nullptr;
+  BLI_mempool *keys_pool = nullptr;
+  BLI_mempool *items_pool = nullptr;
+};
+
 struct SeqCache {
-  Main *bmain;
-  GHash *hash;
-  ThreadMutex iterator_mutex;
-  BLI_mempool *keys_pool;
-  BLI_mempool *items_pool;
-  SeqCacheKey *last_key;
-  SeqDiskCache *disk_cache;
+  Main *bmain = nullptr;
+  SeqCacheShard shards[SEQ_CACHE_SHARDS_NUM];
+  /* Protects linking of keys, #last_key and #disk_cache. Keys are only freed while it is
+   * locked. */
+  std::mutex link_mutex;
+  SeqCacheKey *last_key = nullptr;
+  /* Protects the least recently used list, that is, the members below and the #is_in_lru,
+   * #lru_prev and #lru_next members of keys. */
+  std::mutex lru_mutex;
+  /* Base keys of completely rendered frames, from the most to the least recently used. */
+  SeqCacheKey *lru_first = nullptr;
+  SeqCacheKey *lru_last = nullptr;
+  SeqDiskCache *disk_cache = nullptr;
+
+  /* Usage statistics, see #CacheStatistics. */
+  std::atomic<int64_t> hits = 0;
+  std::atomic<int64_t> misses = 0;
+  std::atomic<int64_t> evictions = 0;
+  std::atomic<int64_t> items_num = 0;
+  std::atomic<int64_t> memory_in_use = 0;
 };
 
 struct SeqCacheItem {
   SeqCache *cache_owner;
+  SeqCacheKey *key;
   ImBuf *ibuf;
+  /* The size of the image at the time it was put in the cache, for statistics. */
+  size_t size;
 };
 
 static ThreadMutex cache_create_lock = BLI_MUTEX_INITIALIZER;
@@ -154,22 +210,9 @@ static SeqCache *seq_cache_get_from_scene(Scene *scene)
   return nullptr;
 }
 
-static void seq_cache_lock(Scene *scene)
-{
-  SeqCache *cache = seq_cache_get_from_scene(scene);
-
-  if (cache) {
-    BLI_mutex_lock(&cache->iterator_mutex);
-  }
-}
-
-static void seq_cache_unlock(Scene *scene)
+static SeqCacheShard &seq_cache_shard_get(SeqCache *cache, const SeqCacheKey *key)
 {
-  SeqCache *cache = seq_cache_get_from_scene(scene);
-
-  if (cache) {
-    BLI_mutex_unlock(&cache->iterator_mutex);
-  }
+  return cache->shards[seq_cache_hashhash(key) % SEQ_CACHE_SHARDS_NUM];
 }
 
 static size_t seq_cache_get_mem_total()
@@ -177,46 +220,118 @@ static size_t seq_cache_get_mem_total()
   return size_t(U.memcachelimit) * 1024 * 1024;
 }
 
-static void seq_cache_keyfree(void *val)
+static int get_stored_types_flag(Scene *scene, SeqCacheKey *key)
 {
-  SeqCacheKey *key = static_cast<SeqCacheKey *>(val);
-  BLI_mempool_free(key->cache_owner->keys_pool, key);
+  int flag;
+  if (key->strip->cache_flag & SEQ_CACHE_OVERRIDE) {
+    flag = key->strip->cache_flag;
+  }
+  else {
+    flag = scene->ed->cache_flag;
+  }
+
+  /* SEQ_CACHE_STORE_FINAL_OUT can not be overridden by strip cache */
+  flag |= (scene->ed->cache_flag & SEQ_CACHE_STORE_FINAL_OUT);
+
+  return flag;
 }
 
-static void seq_cache_valfree(void *val)
+/* The LRU mutex is expected to be locked. */
+static void seq_cache_lru_unlink(SeqCache *cache, SeqCacheKey *key)
 {
-  SeqCacheItem *item = (SeqCacheItem *)val;
+  if (!key->is_in_lru) {
+    return;
+  }
 
-  if (item->ibuf) {
-    IMB_freeImBuf(item->ibuf);
+  if (key->lru_prev) {
+    key->lru_prev->lru_next = key->lru_next;
+  }
+  else {
+    cache->lru_first = key->lru_next;
+  }
+  if (key->lru_next) {
+    key->lru_next->lru_prev = key->lru_prev;
+  }
+  else {
+    cache->lru_last = key->lru_prev;
   }
 
-  BLI_mempool_free(item->cache_owner->items_pool, item);
+  key->lru_prev = nullptr;
+  key->lru_next = nullptr;
+  key->is_in_lru = false;
 }
 
-static int get_stored_types_flag(Scene *scene, SeqCacheKey *key)
+/* Add the key to the front of the least recently used list. The LRU mutex is expected to be
+ * locked. */
+static void seq_cache_lru_link_first(SeqCache *cache, SeqCacheKey *key)
 {
-  int flag;
-  if (key->strip->cache_flag & SEQ_CACHE_OVERRIDE) {
-    flag = key->strip->cache_flag;
+  seq_cache_lru_unlink(cache, key);
+
+  key->lru_next = cache->lru_first;
+  if (cache->lru_first) {
+    cache->lru_first->lru_prev = key;
   }
   else {
-    flag = scene->ed->cache_flag;
+    cache->lru_last = key;
   }
+  cache->lru_first = key;
+  key->is_in_lru = true;
+}
 
-  /* SEQ_CACHE_STORE_FINAL_OUT can not be overridden by strip cache */
-  flag |= (scene->ed->cache_flag & SEQ_CACHE_STORE_FINAL_OUT);
+static void seq_cache_lru_remove(SeqCache *cache, SeqCacheKey *key)
+{
+  std::scoped_lock lock(cache->lru_mutex);
+  seq_cache_lru_unlink(cache, key);
+}
 
-  return flag;
+/* Add the base key of a frame to the front of the least recently used list, or move it there if
+ * it is already in the list. Temporary keys are never recycled, so they are ignored. */
+static void seq_cache_lru_use(SeqCache *cache, SeqCacheKey *key)
+{
+  if (key == nullptr || key->is_temp_cache) {
+    return;
+  }
+
+  std::scoped_lock lock(cache->lru_mutex);
+  seq_cache_lru_link_first(cache, key);
 }
 
-static void seq_cache_put_ex(Scene *scene, SeqCacheKey *key, ImBuf *ibuf)
+/* Stop linking new entries to the chain of the last key, which makes the chain recyclable. */
+static void seq_cache_end_chain(SeqCache *cache)
+{
+  seq_cache_lru_use(cache, cache->last_key);
+  cache->last_key = nullptr;
+}
+
+/* Put the image in the cache under a copy of the given key and link it to the previous entries.
+ * The link mutex is expected to be locked. Returns nullptr if the key is already in the cache,
+ * reinserting it would break cache key linking. */
+static SeqCacheKey *seq_cache_put_ex(Scene *scene, const SeqCacheKey &key_data, ImBuf *ibuf)
 {
   SeqCache *cache = seq_cache_get_from_scene(scene);
-  SeqCacheItem *item;
-  item = static_cast<SeqCacheItem *>(BLI_mempool_alloc(cache->items_pool));
-  item->cache_owner = cache;
-  item->ibuf = ibuf;
+  SeqCacheShard &shard = seq_cache_shard_get(cache, &key_data);
+  SeqCacheKey *key;
+  {
+    std::scoped_lock lock(shard.mutex);
+    if (BLI_ghash_haskey(shard.hash, &key_data)) {
+      return nullptr;
+    }
+
+    key = static_cast<SeqCacheKey *>(BLI_mempool_alloc(shard.keys_pool));
+    *key = key_data;
+
+    SeqCacheItem *item = static_cast<SeqCacheItem *>(BLI_mempool_alloc(shard.items_pool));
+    item->cache_owner = cache;
+    item->key = key;
+    item->ibuf = ibuf;
+    item->size = IMB_get_size_in_memory(ibuf);
+
+    BLI_ghash_insert(shard.hash, key, item);
+    IMB_refImBuf(ibuf);
+
+    cache->items_num++;
+    cache->memory_in_use += int64_t(item->size);
+  }
 
   const int stored_types_flag = get_stored_types_flag(scene, key);
 
@@ -226,10 +341,6 @@ static void seq_cache_put_ex(Scene *scene, SeqCacheKey *key, ImBuf *ibuf)
     key->link_prev = cache->last_key;
   }
 
-  BLI_assert(!BLI_ghash_haskey(cache->hash, key));
-  BLI_ghash_insert(cache->hash, key, item);
-  IMB_refImBuf(ibuf);
-
   /* Store pointer to last cached key. */
   SeqCacheKey *temp_last_key = cache->last_key;
   cache->last_key = key;
@@ -241,18 +352,34 @@ static void seq_cache_put_ex(Scene *scene, SeqCacheKey *key, ImBuf *ibuf)
     temp_last_key->link_next = cache->last_key;
   }
 
-  /* Reset linking. */
+  /* Reset linking. The frame is complete, so its chain can be recycled from its last permanent
+   * key. */
   if (key->type == SEQ_CACHE_STORE_FINAL_OUT) {
+    seq_cache_lru_use(cache, key->is_temp_cache ? temp_last_key : key);
     cache->last_key = nullptr;
   }
+
+  return key;
 }
 
-static ImBuf *seq_cache_get_ex(SeqCache *cache, SeqCacheKey *key)
+/* Look up the image of the given key, which is referenced for the caller. If \a use_frame is true
+ * and the stored key is the base key of a frame, the frame is moved to the front of the least
+ * recently used list. This is done while the shard is locked, since the key can only be freed
+ * after it was removed from the shard. */
+static ImBuf *seq_cache_get_ex(SeqCache *cache, const SeqCacheKey *key, const bool use_frame)
 {
-  SeqCacheItem *item = static_cast<SeqCacheItem *>(BLI_ghash_lookup(cache->hash, key));
+  SeqCacheShard &shard = seq_cache_shard_get(cache, key);
+  std::scoped_lock lock(shard.mutex);
+  SeqCacheItem *item = static_cast<SeqCacheItem *>(BLI_ghash_lookup(shard.hash, key));
 
   if (item && item->ibuf) {
     IMB_refImBuf(item->ibuf);
+    if (use_frame) {
+      std::scoped_lock lru_lock(cache->lru_mutex);
+      if (item->key->is_in_lru) {
+        seq_cache_lru_link_first(cache, item->key);
+      }
+    }
 
     return item->ibuf;
   }
@@ -260,6 +387,13 @@ static ImBuf *seq_cache_get_ex(SeqCache *cache, SeqCacheKey *key)
   return nullptr;
 }
 
+static bool seq_cache_has_key(SeqCache *cache, const SeqCacheKey *key)
+{
+  SeqCacheShard &shard = seq_cache_shard_get(cache, key);
+  std::scoped_lock lock(shard.mutex);
+  return BLI_ghash_haskey(shard.hash, key);
+}
+
 static void seq_cache_key_unlink(SeqCacheKey *key)
 {
   if (key->link_next) {
@@ -272,67 +406,76 @@ static void seq_cache_key_unlink(SeqCacheKey *key)
   }
 }
 
-/* Choose a key out of 2 candidates(leftmost and rightmost items)
- * to recycle based on currently used strategy */
-static SeqCacheKey *seq_cache_choose_key(Scene *scene, SeqCacheKey *lkey, SeqCacheKey *rkey)
+/* Remove the entry of the given key from the cache and free the key. The link mutex is expected
+ * to be locked. */
+static void seq_cache_remove(SeqCache *cache, SeqCacheKey *key)
 {
-  SeqCacheKey *finalkey = nullptr;
+  seq_cache_key_unlink(key);
+  seq_cache_lru_remove(cache, key);
+  if (key == cache->last_key) {
+    cache->last_key = nullptr;
+  }
 
-  /* Ideally, cache would not need to check the state of prefetching task
-   * that is tricky to do however, because prefetch would need to know,
-   * if a key, that is about to be created would be removed by itself.
-   *
-   * This can happen because only FINAL_OUT item insertion will trigger recycling
-   * but that is also the point, where prefetch can be suspended.
-   *
-   * We could use temp cache as a shield and later make it a non-temporary entry,
-   * but it is not worth of increasing system complexity.
-   */
-  if (scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE && seq_prefetch_job_is_running(scene)) {
-    int pfjob_start, pfjob_end;
-    seq_prefetch_get_time_range(scene, &pfjob_start, &pfjob_end);
+  SeqCacheShard &shard = seq_cache_shard_get(cache, key);
+  ImBuf *ibuf;
+  {
+    std::scoped_lock lock(shard.mutex);
+    SeqCacheItem *item = static_cast<SeqCacheItem *>(BLI_ghash_popkey(shard.hash, key, nullptr));
+    BLI_assert(item != nullptr);
+    ibuf = item->ibuf;
 
-    if (lkey) {
-      if (lkey->timeline_frame < pfjob_start || lkey->timeline_frame > pfjob_end) {
-        return lkey;
-      }
-    }
+    cache->items_num--;
+    cache->memory_in_use -= int64_t(item->size);
 
-    if (rkey) {
-      if (rkey->timeline_frame < pfjob_start || rkey->timeline_frame > pfjob_end) {
-        return rkey;
-      }
-    }
+    BLI_mempool_free(shard.items_pool, item);
+    BLI_mempool_free(shard.keys_pool, key);
+  }
 
-    return nullptr;
+  /* Free the image outside of the shard lock, freeing it can free its own display caches. */
+  if (ibuf) {
+    IMB_freeImBuf(ibuf);
   }
+}
 
-  if (rkey && lkey) {
-    if (lkey->timeline_frame > rkey->timeline_frame) {
-      SeqCacheKey *swapkey = lkey;
-      lkey = rkey;
-      rkey = swapkey;
-    }
+/* Remove all entries of the shard, the mutex of the shard is expected to be locked. */
+static void seq_cache_shard_clear(SeqCache *cache, SeqCacheShard &shard)
+{
+  GHashIterator gh_iter;
+  GHASH_ITER (gh_iter, shard.hash) {
+    SeqCacheItem *item = static_cast<SeqCacheItem *>(BLI_ghashIterator_getValue(&gh_iter));
+    BLI_assert(item->cache_owner == cache);
 
-    int l_diff = scene->r.cfra - lkey->timeline_frame;
-    int r_diff = rkey->timeline_frame - scene->r.cfra;
+    cache->items_num--;
+    cache->memory_in_use -= int64_t(item->size);
 
-    if (l_diff > r_diff) {
-      finalkey = lkey;
-    }
-    else {
-      finalkey = rkey;
+    if (item->ibuf) {
+      IMB_freeImBuf(item->ibuf);
     }
   }
-  else {
-    if (lkey) {
-      finalkey = lkey;
-    }
-    else {
-      finalkey = rkey;
+
+  BLI_ghash_clear(shard.hash, nullptr, nullptr);
+  BLI_mempool_clear(shard.keys_pool);
+  BLI_mempool_clear(shard.items_pool);
+}
+
+/* Get the keys of all entries for which the given function returns true. The link mutex is
+ * expected to be locked, so the keys stay valid. */
+static Vector<SeqCacheKey *> seq_cache_keys_get(SeqCache *cache,
+                                                const FunctionRef<bool(SeqCacheKey *key)> fn)
+{
+  Vector<SeqCacheKey *> keys;
+  for (SeqCacheShard &shard : cache->shards) {
+    std::scoped_lock lock(shard.mutex);
+    GHashIterator gh_iter;
+    GHASH_ITER (gh_iter, shard.hash) {
+      SeqCacheKey *key = static_cast<SeqCacheKey *>(BLI_ghashIterator_getKey(&gh_iter));
+      BLI_assert(key->cache_owner == cache);
+      if (fn(key)) {
+        keys.append(key);
+      }
     }
   }
-  return finalkey;
+  return keys;
 }
 
 static void seq_cache_recycle_linked(Scene *scene, SeqCacheKey *base)
@@ -345,7 +488,7 @@ static void seq_cache_recycle_linked(Scene *scene, SeqCacheKey *base)
   SeqCacheKey *next = base->link_next;
 
   while (base) {
-    if (!BLI_ghash_haskey(cache->hash, base)) {
+    if (!seq_cache_has_key(cache, base)) {
       break; /* Key has already been removed from cache. */
     }
 
@@ -356,15 +499,15 @@ static void seq_cache_recycle_linked(Scene *scene, SeqCacheKey *base)
       break;
     }
 
-    seq_cache_key_unlink(base);
-    BLI_ghash_remove(cache->hash, base, seq_cache_keyfree, seq_cache_valfree);
     BLI_assert(base != cache->last_key);
+    seq_cache_remove(cache, base);
+    cache->evictions++;
     base = prev;
   }
 
   base = next;
   while (base) {
-    if (!BLI_ghash_haskey(cache->hash, base)) {
+    if (!seq_cache_has_key(cache, base)) {
       break; /* Key has already been removed from cache. */
     }
 
@@ -375,69 +518,65 @@ static void seq_cache_recycle_linked(Scene *scene, SeqCacheKey *base)
       break;
     }
 
-    seq_cache_key_unlink(base);
-    BLI_ghash_remove(cache->hash, base, seq_cache_keyfree, seq_cache_valfree);
     BLI_assert(base != cache->last_key);
+    seq_cache_remove(cache, base);
+    cache->evictions++;
     base = next;
   }
 }
 
+/* Chains that were never completed by a final image, for example because their frame was
+ * invalidated while rendering, are not in the least recently used list. Find their base keys by
+ * scanning all entries, which is only needed once the list is exhausted. */
+static void seq_cache_lru_add_incomplete_chains(SeqCache *cache)
+{
+  const Vector<SeqCacheKey *> keys = seq_cache_keys_get(cache, [&](SeqCacheKey *key) {
+    return !key->is_temp_cache && key->link_next == nullptr && key != cache->last_key;
+  });
+  for (SeqCacheKey *key : keys) {
+    seq_cache_lru_use(cache, key);
+  }
+}
+
+/* Choose the base key of the least recently used frame to recycle. */
 static SeqCacheKey *seq_cache_get_item_for_removal(Scene *scene)
 {
   SeqCache *cache = seq_cache_get_from_scene(scene);
-  SeqCacheKey *finalkey = nullptr;
-  /* Leftmost key. */
-  SeqCacheKey *lkey = nullptr;
-  /* Rightmost key. */
-  SeqCacheKey *rkey = nullptr;
-  SeqCacheKey *key = nullptr;
-
-  GHashIterator gh_iter;
-  BLI_ghashIterator_init(&gh_iter, cache->hash);
-  int total_count = 0;
-
-  while (!BLI_ghashIterator_done(&gh_iter)) {
-    key = static_cast<SeqCacheKey *>(BLI_ghashIterator_getKey(&gh_iter));
-    SeqCacheItem *item = static_cast<SeqCacheItem *>(BLI_ghashIterator_getValue(&gh_iter));
-    BLI_ghashIterator_step(&gh_iter);
-    BLI_assert(key->cache_owner == cache);
-
-    /* This shouldn't happen, but better be safe than sorry. */
-    if (!item->ibuf) {
-      seq_cache_recycle_linked(scene, key);
-      /* Can not continue iterating after linked remove. */
-      BLI_ghashIterator_init(&gh_iter, cache->hash);
-      continue;
-    }
 
-    if (key->is_temp_cache || key->link_next != nullptr) {
-      continue;
-    }
+  bool is_lru_empty;
+  {
+    std::scoped_lock lock(cache->lru_mutex);
+    is_lru_empty = cache->lru_last == nullptr;
+  }
+  if (is_lru_empty) {
+    seq_cache_lru_add_incomplete_chains(cache);
+  }
 
-    total_count++;
+  /* Ideally, cache would not need to check the state of prefetching task
+   * that is tricky to do however, because prefetch would need to know,
+   * if a key, that is about to be created would be removed by itself.
+   *
+   * This can happen because only FINAL_OUT item insertion will trigger recycling
+   * but that is also the point, where prefetch can be suspended.
+   *
+   * We could use temp cache as a shield and later make it a non-temporary entry,
+   * but it is not worth of increasing system complexity.
+   */
+  std::scoped_lock lock(cache->lru_mutex);
+  if (scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE && seq_prefetch_job_is_running(scene)) {
+    int pfjob_start, pfjob_end;
+    seq_prefetch_get_time_range(scene, &pfjob_start, &pfjob_end);
 
-    if (lkey) {
-      if (key->timeline_frame < lkey->timeline_frame) {
-        lkey = key;
+    for (SeqCacheKey *key = cache->lru_last; key; key = key->lru_prev) {
+      if (key->timeline_frame < pfjob_start || key->timeline_frame > pfjob_end) {
+        return key;
       }
     }
-    else {
-      lkey = key;
-    }
-    if (rkey) {
-      if (key->timeline_frame > rkey->timeline_frame) {
-        rkey = key;
-      }
-    }
-    else {
-      rkey = key;
-    }
-  }
-  (void)total_count; /* Quiet set-but-unused warning (may be removed). */
 
-  finalkey = seq_cache_choose_key(scene, lkey, rkey);
+    return nullptr;
+  }
 
-  return finalkey;
+  return cache->lru_last;
 }
 
 bool seq_cache_recycle_item(Scene *scene)
@@ -447,7 +586,11 @@ bool seq_cache_recycle_item(Scene *scene)
     return false;
   }
 
-  seq_cache_lock(scene);
+  if (!seq_cache_is_full()) {
+    return true;
+  }
+
+  std::scoped_lock lock(cache->link_mutex);
 
   while (seq_cache_is_full()) {
     SeqCacheKey *finalkey = seq_cache_get_item_for_removal(scene);
@@ -456,11 +599,9 @@ bool seq_cache_recycle_item(Scene *scene)
       seq_cache_recycle_linked(scene, finalkey);
     }
     else {
-      seq_cache_unlock(scene);
       return false;
     }
   }
-  seq_cache_unlock(scene);
   return true;
 }
 
@@ -477,6 +618,7 @@ static void seq_cache_set_temp_cache_linked(Scene *scene, SeqCacheKey *base)
   while (base) {
     SeqCacheKey *prev = base->link_prev;
     base->is_temp_cache = true;
+    seq_cache_lru_remove(cache, base);
     base = prev;
   }
 
@@ -484,6 +626,7 @@ static void seq_cache_set_temp_cache_linked(Scene *scene, SeqCacheKey *base)
   while (base) {
     next = base->link_next;
     base->is_temp_cache = true;
+    seq_cache_lru_remove(cache, base);
     base = next;
   }
 }
@@ -492,13 +635,13 @@ static void seq_cache_create(Main *bmain, Scene *scene)
 {
   BLI_mutex_lock(&cache_create_lock);
   if (scene->ed->cache == nullptr) {
-    SeqCache *cache = MEM_callocN<SeqCache>("SeqCache");
-    cache->keys_pool = BLI_mempool_create(sizeof(SeqCacheKey), 0, 64, BLI_MEMPOOL_NOP);
-    cache->items_pool = BLI_mempool_create(sizeof(SeqCacheItem), 0, 64, BLI_MEMPOOL_NOP);
-    cache->hash = BLI_ghash_new(seq_cache_hashhash, seq_cache_hashcmp, "SeqCache hash");
-    cache->last_key = nullptr;
+    SeqCache *cache = MEM_new<SeqCache>("SeqCache");
+    for (SeqCacheShard &shard : cache->shards) {
+      shard.keys_pool = BLI_mempool_create(sizeof(SeqCacheKey), 0, 64, BLI_MEMPOOL_NOP);
+      shard.items_pool = BLI_mempool_create(sizeof(SeqCacheItem), 0, 64, BLI_MEMPOOL_NOP);
+      shard.hash = BLI_ghash_new(seq_cache_hashhash, seq_cache_hashcmp, "SeqCache hash");
+    }
     cache->bmain = bmain;
-    BLI_mutex_init(&cache->iterator_mutex);
     scene->ed->cache = cache;
 
     if (scene->ed->disk_cache_timestamp == 0) {
@@ -508,6 +651,15 @@ static void seq_cache_create(Main *bmain, Scene *scene)
   BLI_mutex_unlock(&cache_create_lock);
 }
 
+static SeqDiskCache *seq_cache_disk_cache_ensure(SeqCache *cache, const RenderData *context)
+{
+  std::scoped_lock lock(cache->link_mutex);
+  if (cache->disk_cache == nullptr) {
+    cache->disk_cache = seq_disk_cache_create(context->bmain, context->scene);
+  }
+  return cache->disk_cache;
+}
+
 static void seq_cache_populate_key(SeqCacheKey *key,
                                    const RenderData *context,
                                    Strip *strip,
@@ -523,21 +675,13 @@ static void seq_cache_populate_key(SeqCacheKey *key,
   key->type = type;
   key->link_prev = nullptr;
   key->link_next = nullptr;
+  key->lru_prev = nullptr;
+  key->lru_next = nullptr;
+  key->is_in_lru = false;
   key->is_temp_cache = true;
   key->task_id = context->task_id;
 }
 
-static SeqCacheKey *seq_cache_allocate_key(SeqCache *cache,
-                                           const RenderData *context,
-                                           Strip *strip,
-                                           const float timeline_frame,
-                                           const int type)
-{
-  SeqCacheKey *key = static_cast<SeqCacheKey *>(BLI_mempool_alloc(cache->keys_pool));
-  seq_cache_populate_key(key, context, strip, timeline_frame, type);
-  return key;
-}
-
 /* ***************************** API ****************************** */
 
 void seq_cache_free_temp_cache(Scene *scene, short id, int timeline_frame)
@@ -547,32 +691,22 @@ void seq_cache_free_temp_cache(Scene *scene, short id, int timeline_frame)
     return;
   }
 
-  seq_cache_lock(scene);
+  std::scoped_lock lock(cache->link_mutex);
 
-  GHashIterator gh_iter;
-  BLI_ghashIterator_init(&gh_iter, cache->hash);
-  while (!BLI_ghashIterator_done(&gh_iter)) {
-    SeqCacheKey *key = static_cast<SeqCacheKey *>(BLI_ghashIterator_getKey(&gh_iter));
-    BLI_ghashIterator_step(&gh_iter);
-    BLI_assert(key->cache_owner == cache);
-
-    if (key->is_temp_cache && key->task_id == id) {
-      /* Use frame_index here to avoid freeing raw images if they are used for multiple frames. */
-      float frame_index = seq_cache_timeline_frame_to_frame_index(
-          scene, key->strip, timeline_frame, key->type);
-      if (frame_index != key->frame_index ||
-          timeline_frame > time_right_handle_frame_get(scene, key->strip) ||
-          timeline_frame < time_left_handle_frame_get(scene, key->strip))
-      {
-        seq_cache_key_unlink(key);
-        BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
-        if (key == cache->last_key) {
-          cache->last_key = nullptr;
-        }
-      }
+  const Vector<SeqCacheKey *> keys = seq_cache_keys_get(cache, [&](SeqCacheKey *key) {
+    if (!key->is_temp_cache || key->task_id != id) {
+      return false;
     }
+    /* Use frame_index here to avoid freeing raw images if they are used for multiple frames. */
+    float frame_index = seq_cache_timeline_frame_to_frame_index(
+        scene, key->strip, timeline_frame, key->type);
+    return frame_index != key->frame_index ||
+           timeline_frame > time_right_handle_frame_get(scene, key->strip) ||
+           timeline_frame < time_left_handle_frame_get(scene, key->strip);
+  });
+  for (SeqCacheKey *key : keys) {
+    seq_cache_remove(cache, key);
   }
-  seq_cache_unlock(scene);
 }
 
 void seq_cache_destruct(Scene *scene)
@@ -582,16 +716,18 @@ void seq_cache_destruct(Scene *scene)
     return;
   }
 
-  BLI_ghash_free(cache->hash, seq_cache_keyfree, seq_cache_valfree);
-  BLI_mempool_destroy(cache->keys_pool);
-  BLI_mempool_destroy(cache->items_pool);
-  BLI_mutex_end(&cache->iterator_mutex);
+  for (SeqCacheShard &shard : cache->shards) {
+    seq_cache_shard_clear(cache, shard);
+    BLI_ghash_free(shard.hash, nullptr, nullptr);
+    BLI_mempool_destroy(shard.keys_pool);
+    BLI_mempool_destroy(shard.items_pool);
+  }
 
   if (cache->disk_cache != nullptr) {
     seq_disk_cache_free(cache->disk_cache);
   }
 
-  MEM_freeN(cache);
+  MEM_delete(cache);
   scene->ed->cache = nullptr;
 }
 
@@ -604,21 +740,18 @@ void cache_cleanup(Scene *scene)
     return;
   }
 
-  seq_cache_lock(scene);
+  std::scoped_lock lock(cache->link_mutex);
 
-  GHashIterator gh_iter;
-  BLI_ghashIterator_init(&gh_iter, cache->hash);
-  while (!BLI_ghashIterator_done(&gh_iter)) {
-    SeqCacheKey *key = static_cast<SeqCacheKey *>(BLI_ghashIterator_getKey(&gh_iter));
-    BLI_assert(key->cache_owner == cache);
-
-    BLI_ghashIterator_step(&gh_iter);
-
-    /* NOTE: no need to call #seq_cache_key_unlink as all keys are removed. */
-    BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
+  /* NOTE: no need to call #seq_cache_key_unlink as all keys are removed. */
+  for (SeqCacheShard &shard : cache->shards) {
+    std::scoped_lock shard_lock(shard.mutex);
+    seq_cache_shard_clear(cache, shard);
   }
   cache->last_key = nullptr;
-  seq_cache_unlock(scene);
+
+  std::scoped_lock lru_lock(cache->lru_mutex);
+  cache->lru_first = nullptr;
+  cache->lru_last = nullptr;
 }
 
 void seq_cache_cleanup_sequence(Scene *scene,
@@ -636,7 +769,7 @@ void seq_cache_cleanup_sequence(Scene *scene,
     seq_disk_cache_invalidate(cache->disk_cache, scene, strip, strip_changed, invalidate_types);
   }
 
-  seq_cache_lock(scene);
+  std::scoped_lock lock(cache->link_mutex);
 
   const int range_start_seq_changed = seq_cache_timeline_frame_to_frame_index(
       scene, strip, time_left_handle_frame_get(scene, strip_changed), invalidate_types);
@@ -660,30 +793,21 @@ void seq_cache_cleanup_sequence(Scene *scene,
   int invalidate_source = invalidate_types & (SEQ_CACHE_STORE_RAW | SEQ_CACHE_STORE_PREPROCESSED |
                                               SEQ_CACHE_STORE_COMPOSITE);
 
-  GHashIterator gh_iter;
-  BLI_ghashIterator_init(&gh_iter, cache->hash);
-  while (!BLI_ghashIterator_done(&gh_iter)) {
-    SeqCacheKey *key = static_cast<SeqCacheKey *>(BLI_ghashIterator_getKey(&gh_iter));
-    BLI_ghashIterator_step(&gh_iter);
-    BLI_assert(key->cache_owner == cache);
-
+  const Vector<SeqCacheKey *> keys = seq_cache_keys_get(cache, [&](SeqCacheKey *key) {
     /* Clean all final and composite in intersection of strip and strip_changed. */
     if (key->type & invalidate_composite && key->frame_index >= range_start &&
         key->frame_index <= range_end)
     {
-      seq_cache_key_unlink(key);
-      BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
-    }
-    else if (key->type & invalidate_source && key->strip == strip &&
-             key->frame_index >= range_start_seq_changed &&
-             key->frame_index <= range_end_seq_changed)
-    {
-      seq_cache_key_unlink(key);
-      BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
+      return true;
     }
+    return key->type & invalidate_source && key->strip == strip &&
+           key->frame_index >= range_start_seq_changed &&
+           key->frame_index <= range_end_seq_changed;
+  });
+  for (SeqCacheKey *key : keys) {
+    seq_cache_remove(cache, key);
   }
-  cache->last_key = nullptr;
-  seq_cache_unlock(scene);
+  seq_cache_end_chain(cache);
 }
 
 ImBuf *seq_cache_get(const RenderData *context, Strip *strip, float timeline_frame, int type)
@@ -709,21 +833,19 @@ ImBuf *seq_cache_get(const RenderData *context, Strip *strip, float timeline_fra
     seq_cache_create(context->bmain, scene);
   }
 
-  seq_cache_lock(scene);
   SeqCache *cache = seq_cache_get_from_scene(scene);
   ImBuf *ibuf = nullptr;
   SeqCacheKey key;
+  seq_cache_populate_key(&key, context, strip, timeline_frame, type);
 
-  /* Try RAM cache: */
-  if (cache && strip) {
-    seq_cache_populate_key(&key, context, strip, timeline_frame, type);
-    ibuf = seq_cache_get_ex(cache, &key);
-  }
-  seq_cache_unlock(scene);
+  /* Try RAM cache. Reading the final image of a frame uses the frame. */
+  ibuf = seq_cache_get_ex(cache, &key, type == SEQ_CACHE_STORE_FINAL_OUT);
 
   if (ibuf) {
+    cache->hits++;
     return ibuf;
   }
+  cache->misses++;
 
   if (context->for_render) {
     return nullptr;
@@ -731,11 +853,9 @@ ImBuf *seq_cache_get(const RenderData *context, Strip *strip, float timeline_fra
 
   /* Try disk cache: */
   if (seq_disk_cache_is_enabled(context->bmain)) {
-    if (cache->disk_cache == nullptr) {
-      cache->disk_cache = seq_disk_cache_create(context->bmain, context->scene);
-    }
+    SeqDiskCache *disk_cache = seq_cache_disk_cache_ensure(cache, context);
 
-    ibuf = seq_disk_cache_read_file(cache->disk_cache, &key);
+    ibuf = seq_disk_cache_read_file(disk_cache, &key);
 
     if (ibuf == nullptr) {
       return nullptr;
@@ -743,8 +863,8 @@ ImBuf *seq_cache_get(const RenderData *context, Strip *strip, float timeline_fra
 
     /* Store read image in RAM. Only recycle item for final type. */
     if (key.type != SEQ_CACHE_STORE_FINAL_OUT || seq_cache_recycle_item(scene)) {
-      SeqCacheKey *new_key = seq_cache_allocate_key(cache, context, strip, timeline_frame, type);
-      seq_cache_put_ex(scene, new_key, ibuf);
+      std::scoped_lock lock(cache->link_mutex);
+      seq_cache_put_ex(scene, key, ibuf);
     }
   }
 
@@ -771,9 +891,11 @@ bool seq_cache_put_if_possible(
     return true;
   }
 
-  if (scene->ed->cache) {
-    seq_cache_set_temp_cache_linked(scene, scene->ed->cache->last_key);
-    scene->ed->cache->last_key = nullptr;
+  SeqCache *cache = seq_cache_get_from_scene(scene);
+  if (cache) {
+    std::scoped_lock lock(cache->link_mutex);
+    seq_cache_set_temp_cache_linked(scene, cache->last_key);
+    cache->last_key = nullptr;
   }
 
   return false;
@@ -795,35 +917,31 @@ void seq_cache_put(
     BLI_assert(strip != nullptr);
   }
 
-  /* Prevent reinserting, it breaks cache key linking. */
-  ImBuf *test = seq_cache_get(context, strip, timeline_frame, type);
-  if (test) {
-    IMB_freeImBuf(test);
-    return;
-  }
-
   if (!scene->ed->cache) {
     seq_cache_create(context->bmain, scene);
   }
 
-  seq_cache_lock(scene);
   SeqCache *cache = seq_cache_get_from_scene(scene);
-  SeqCacheKey *key = seq_cache_allocate_key(cache, context, strip, timeline_frame, type);
-  seq_cache_put_ex(scene, key, i);
-  seq_cache_unlock(scene);
+  SeqCacheKey key;
+  seq_cache_populate_key(&key, context, strip, timeline_frame, type);
+  {
+    std::scoped_lock lock(cache->link_mutex);
+    SeqCacheKey *stored_key = seq_cache_put_ex(scene, key, i);
+    if (stored_key == nullptr) {
+      return;
+    }
 
-  if (context->for_render) {
-    key->is_temp_cache = true;
+    if (context->for_render) {
+      stored_key->is_temp_cache = true;
+      seq_cache_lru_remove(cache, stored_key);
+    }
+    key.is_temp_cache = stored_key->is_temp_cache;
   }
 
-  if (!key->is_temp_cache) {
+  if (!key.is_temp_cache) {
     if (seq_disk_cache_is_enabled(context->bmain)) {
-      if (cache->disk_cache == nullptr) {
-        seq_disk_cache_create(context->bmain, context->scene);
-      }
-
-      seq_disk_cache_write_file(cache->disk_cache, key, i);
-      seq_disk_cache_enforce_limits(cache->disk_cache);
+      SeqDiskCache *disk_cache = seq_cache_disk_cache_ensure(cache, context);
+      seq_disk_cache_write_file(disk_cache, &key, i);
     }
   }
 }
@@ -839,38 +957,57 @@ void cache_iterate(
     return;
   }
 
-  seq_cache_lock(scene);
-  bool interrupt = callback_init(userdata, BLI_ghash_len(cache->hash));
+  std::scoped_lock lock(cache->link_mutex);
+  bool interrupt = callback_init(userdata, size_t(cache->items_num));
 
-  GHashIterator gh_iter;
-  BLI_ghashIterator_init(&gh_iter, cache->hash);
-
-  while (!BLI_ghashIterator_done(&gh_iter) && !interrupt) {
-    SeqCacheKey *key = static_cast<SeqCacheKey *>(BLI_ghashIterator_getKey(&gh_iter));
-    BLI_ghashIterator_step(&gh_iter);
-    BLI_assert(key->cache_owner == cache);
-    int timeline_frame;
-    if (key->type & SEQ_CACHE_STORE_FINAL_OUT) {
-      timeline_frame = key->timeline_frame;
-    }
-    else {
-      /* This is not a final cache image. The cached frame is relative to where the strip is
-       * currently and where it was when it was cached. We can't use the timeline_frame, we need to
-       * derive the timeline frame from key->frame_index.
-       *
-       * NOTE This will not work for RAW caches if they have retiming, strobing, or different
-       * playback rate than the scene. Because it would take quite a bit of effort to properly
-       * convert RAW frames like that to a timeline frame, we skip doing this as visualizing these
-       * are a developer option that not many people will see.
-       */
-      timeline_frame = key->frame_index + time_start_frame_get(key->strip);
+  for (SeqCacheShard &shard : cache->shards) {
+    std::scoped_lock shard_lock(shard.mutex);
+
+    GHashIterator gh_iter;
+    BLI_ghashIterator_init(&gh_iter, shard.hash);
+
+    while (!BLI_ghashIterator_done(&gh_iter) && !interrupt) {
+      SeqCacheKey *key = static_cast<SeqCacheKey *>(BLI_ghashIterator_getKey(&gh_iter));
+      BLI_ghashIterator_step(&gh_iter);
+      BLI_assert(key->cache_owner == cache);
+      int timeline_frame;
+      if (key->type & SEQ_CACHE_STORE_FINAL_OUT) {
+        timeline_frame = key->timeline_frame;
+      }
+      else {
+        /* This is not a final cache image. The cached frame is relative to where the strip is
+         * currently and where it was when it was cached. We can't use the timeline_frame, we
+         * need to derive the timeline frame from key->frame_index.
+         *
+         * NOTE This will not work for RAW caches if they have retiming, strobing, or different
+         * playback rate than the scene. Because it would take quite a bit of effort to properly
+         * convert RAW frames like that to a timeline frame, we skip doing this as visualizing
+         * these are a developer option that not many people will see.
+         */
+        timeline_frame = key->frame_index + time_start_frame_get(key->strip);
+      }
+
+      interrupt = callback_iter(userdata, key->strip, timeline_frame, key->type);
     }
+  }
 
-    interrupt = callback_iter(userdata, key->strip, timeline_frame, key->type);
+  seq_cache_end_chain(cache);
+}
+
+CacheStatistics cache_statistics_get(Scene *scene)
+{
+  CacheStatistics statistics;
+  SeqCache *cache = seq_cache_get_from_scene(scene);
+  if (!cache) {
+    return statistics;
   }
 
-  cache->last_key = nullptr;
-  seq_cache_unlock(scene);
+  statistics.hits = cache->hits;
+  statistics.misses = cache->misses;
+  statistics.evictions = cache->evictions;
+  statistics.items_num = cache->items_num;
+  statistics.memory_in_use = cache->memory_in_use;
+  return statistics;
 }
 
 bool seq_cache_is_full()
@@ -24,12 +24,15 @@ struct SeqCacheKey {
   void *userkey;
   SeqCacheKey *link_prev; /* Used for linking intermediate items to final frame. */
   SeqCacheKey *link_next; /* Used for linking intermediate items to final frame. */
+  SeqCacheKey *lru_prev;  /* Used for ordering frames by their last use, for recycling. */
+  SeqCacheKey *lru_next;  /* Used for ordering frames by their last use, for recycling. */
   Strip *strip;
   RenderData context;
   float frame_index;    /* Usually same as timeline_frame. Mapped to media for RAW entries. */
   float timeline_frame; /* Only for reference - used for freeing when cache is full. */
   float cost;           /* In short: render time(s) divided by playback frame duration(s) */
   bool is_temp_cache;   /* this cache entry will be freed before rendering next frame */
+  bool is_in_lru;       /* This is the base key of a frame that can be recycled. */
   /* ID of task for assigning temp cache entries to particular task(thread, etc.) */
   eTaskId task_id;
   int type;
@@ -18,6 +18,7 @@
 #include "DNA_sequence_types.h"
 #include "DNA_space_types.h"
 
+#include "BLI_array.hh"
 #include "BLI_linklist.h"
 #include "BLI_listbase.h"
 #include "BLI_math_geom.h"
@@ -1841,6 +1842,61 @@ static bool is_opaque_alpha_over(const Strip *strip)
   return true;
 }
 
+/**
+ * Image and movie strips only read their own media, so they can be rendered at the same time as
+ * other strips. Strips with modifiers that render a mask are excluded, because the mask can be
+ * another strip.
+ */
+static bool seq_can_render_concurrently(const Strip *strip)
+{
+  if (!ELEM(strip->type, STRIP_TYPE_IMAGE, STRIP_TYPE_MOVIE)) {
+    return false;
+  }
+  LISTBASE_FOREACH (const SequenceModifierData *, smd, &strip->modifiers) {
+    if ((smd->flag & SEQUENCE_MODIFIER_MUTE) == 0 &&
+        (smd->mask_sequence != nullptr || smd->mask_id != nullptr))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Render the strips that are blended on top of the strip at \a start in parallel, storing them in
+ * \a r_inputs. Only strips that can be rendered concurrently are rendered, others are left as
+ * nullptr and rendered when they are blended.
+ */
+static void seq_render_strip_stack_inputs(const RenderData *context,
+                                          const Span<Strip *> strips,
+                                          const int64_t start,
+                                          const OpaqueQuadTracker &opaques,
+                                          float timeline_frame,
+                                          MutableSpan<ImBuf *> r_inputs)
+{
+  Vector<int64_t> indices;
+  for (int64_t i = start; i < strips.size(); i++) {
+    Strip *strip = strips[i];
+    if (seq_can_render_concurrently(strip) && !opaques.is_occluded(context, strip, i) &&
+        strip_get_early_out_for_blend_mode(strip) == StripEarlyOut::DoEffect)
+    {
+      indices.append(i);
+    }
+  }
+
+  /* A single input gains nothing from being rendered ahead of blending. */
+  if (indices.size() < 2) {
+    return;
+  }
+
+  threading::parallel_for(indices.index_range(), 1, [&](const IndexRange range) {
+    for (const int64_t i : indices.as_span().slice(range)) {
+      SeqRenderState state;
+      r_inputs[i] = seq_render_strip(context, &state, strips[i], timeline_frame);
+    }
+  });
+}
+
 static ImBuf *seq_render_strip_stack(const RenderData *context,
                                      SeqRenderState *state,
                                      ListBase *channels,
@@ -1943,6 +1999,11 @@ static ImBuf *seq_render_strip_stack(const RenderData *context,
   }
 
   i++;
+
+  /* Independent inputs are rendered up front on the task scheduler, then blended in order. */
+  Array<ImBuf *> inputs(strips.size(), nullptr);
+  seq_render_strip_stack_inputs(context, strips, i, opaques, timeline_frame, inputs);
+
   for (; i < strips.size(); i++) {
     Strip *strip = strips[i];
 
@@ -1952,7 +2013,8 @@ static ImBuf *seq_render_strip_stack(const RenderData *context,
 
     if (strip_get_early_out_for_blend_mode(strip) == StripEarlyOut::DoEffect) {
       ImBuf *ibuf1 = out;
-      ImBuf *ibuf2 = seq_render_strip(context, state, strip, timeline_frame);
+      ImBuf *ibuf2 = inputs[i] ? inputs[i] :
+                                 seq_render_strip(context, state, strip, timeline_frame);
 
       out = seq_render_strip_stack_apply_effect(context, strip, timeline_frame, ibuf1, ibuf2);
 
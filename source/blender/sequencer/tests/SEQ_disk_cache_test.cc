@@ -0,0 +1,325 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "MEM_guardedalloc.h"
+
+#include "CLG_log.h"
+
+#include "BLI_fileops.h"
+#include "BLI_path_utils.hh"
+#include "BLI_string.h"
+#include "BLI_tempfile.h"
+#include "BLI_time.h"
+
+#include "DNA_scene_types.h"
+#include "DNA_sequence_types.h"
+#include "DNA_space_types.h"
+#include "DNA_userdef_types.h"
+
+#include "BKE_idtype.hh"
+#include "BKE_main.hh"
+#include "BKE_scene.hh"
+
+#include "IMB_imbuf.hh"
+#include "IMB_imbuf_types.hh"
+
+#include "SEQ_render.hh"
+#include "SEQ_sequencer.hh"
+
+#include "disk_cache.hh"
+#include "image_cache.hh"
+
+namespace blender::seq::tests {
+
+static constexpr int IMAGE_WIDTH = 256;
+static constexpr int IMAGE_HEIGHT = 128;
+
+class DiskCacheTest : public testing::Test {
+ protected:
+  Main *bmain_ = nullptr;
+  Scene *scene_ = nullptr;
+  Strip *strip_ = nullptr;
+  RenderData context_;
+  char cache_dir_[FILE_MAX];
+  char previous_dir_[sizeof(U.sequencer_disk_cache_dir)];
+  int previous_compression_ = 0;
+  int previous_size_limit_ = 0;
+  short previous_flag_ = 0;
+
+  static void SetUpTestSuite()
+  {
+    CLG_init();
+    BKE_idtype_init();
+  }
+
+  static void TearDownTestSuite()
+  {
+    CLG_exit();
+  }
+
+  void SetUp() override
+  {
+    char temp_dir[FILE_MAX];
+    BLI_temp_directory_path_get(temp_dir, sizeof(temp_dir));
+    BLI_path_join(cache_dir_, sizeof(cache_dir_), temp_dir, "seq_disk_cache_test");
+    BLI_delete(cache_dir_, true, true);
+    BLI_dir_create_recursive(cache_dir_);
+
+    STRNCPY(previous_dir_, U.sequencer_disk_cache_dir);
+    previous_compression_ = U.sequencer_disk_cache_compression;
+    previous_size_limit_ = U.sequencer_disk_cache_size_limit;
+    previous_flag_ = U.sequencer_disk_cache_flag;
+    STRNCPY(U.sequencer_disk_cache_dir, cache_dir_);
+    U.sequencer_disk_cache_size_limit = 1;
+    U.sequencer_disk_cache_flag |= SEQ_CACHE_DISK_CACHE_ENABLE;
+    U.sequencer_disk_cache_compression = USER_SEQ_DISK_CACHE_COMPRESSION_LOW;
+
+    bmain_ = BKE_main_new();
+    BLI_path_join(bmain_->filepath, sizeof(bmain_->filepath), cache_dir_, "test.blend");
+    scene_ = BKE_scene_add(bmain_, "Scene");
+    Editing *ed = editing_ensure(scene_);
+    ed->disk_cache_timestamp = 1;
+    strip_ = sequence_alloc(ed->seqbasep, 1, 1, STRIP_TYPE_COLOR);
+    render_new_render_data(bmain_,
+                           nullptr,
+                           scene_,
+                           IMAGE_WIDTH,
+                           IMAGE_HEIGHT,
+                           SEQ_RENDER_SIZE_SCENE,
+                           false,
+                           &context_);
+  }
+
+  void TearDown() override
+  {
+    BKE_main_free(bmain_);
+    STRNCPY(U.sequencer_disk_cache_dir, previous_dir_);
+    U.sequencer_disk_cache_compression = previous_compression_;
+    U.sequencer_disk_cache_size_limit = previous_size_limit_;
+    U.sequencer_disk_cache_flag = previous_flag_;
+    BLI_delete(cache_dir_, true, true);
+  }
+
+  SeqCacheKey make_key(const int frame)
+  {
+    SeqCacheKey key = {};
+    key.strip = strip_;
+    key.context = context_;
+    key.frame_index = frame;
+    key.timeline_frame = frame;
+    key.type = SEQ_CACHE_STORE_FINAL_OUT;
+    return key;
+  }
+
+  /* An image whose pixels depend on the frame, with smooth gradients that compress well. */
+  static ImBuf *create_image(const int frame)
+  {
+    ImBuf *ibuf = IMB_allocImBuf(IMAGE_WIDTH, IMAGE_HEIGHT, 32, IB_byte_data);
+    for (int y = 0; y < IMAGE_HEIGHT; y++) {
+      for (int x = 0; x < IMAGE_WIDTH; x++) {
+        uchar *pixel = ibuf->byte_buffer.data + (size_t(y) * IMAGE_WIDTH + x) * 4;
+        pixel[0] = uchar(x + frame);
+        pixel[1] = uchar(y * 2);
+        pixel[2] = uchar(frame * 7);
+        pixel[3] = 255;
+      }
+    }
+    return ibuf;
+  }
+
+  static bool images_equal(const ImBuf *a, const ImBuf *b)
+  {
+    return a->x == b->x && a->y == b->y && a->byte_buffer.data && b->byte_buffer.data &&
+           memcmp(a->byte_buffer.data, b->byte_buffer.data, size_t(a->x) * a->y * 4) == 0;
+  }
+
+  void write_image(SeqDiskCache *disk_cache, const int frame)
+  {
+    SeqCacheKey key = make_key(frame);
+    ImBuf *ibuf = create_image(frame);
+    seq_disk_cache_write_file(disk_cache, &key, ibuf);
+    IMB_freeImBuf(ibuf);
+  }
+
+  /* Returns true if the image of the frame is cached and has the expected pixels. */
+  bool read_image(SeqDiskCache *disk_cache, const int frame)
+  {
+    SeqCacheKey key = make_key(frame);
+    ImBuf *ibuf = seq_disk_cache_read_file(disk_cache, &key);
+    if (ibuf == nullptr) {
+      return false;
+    }
+    ImBuf *expected = create_image(frame);
+    const bool is_equal = images_equal(ibuf, expected);
+    IMB_freeImBuf(expected);
+    IMB_freeImBuf(ibuf);
+    EXPECT_TRUE(is_equal) << "frame " << frame;
+    return is_equal;
+  }
+
+  /* Waits until the background writer wrote all pending images. */
+  static void wait_for_writes(SeqDiskCache *disk_cache)
+  {
+    while (seq_disk_cache_pending_writes_num(disk_cache) > 0) {
+      BLI_time_sleep_ms(1);
+    }
+  }
+
+  void project_dir_get(char *dirpath, const size_t dirpath_maxncpy)
+  {
+    BLI_path_join(dirpath, dirpath_maxncpy, cache_dir_, "test.blend_seq_cache");
+  }
+};
+
+/* Images are readable while they wait to be written, and from disk once they are written. */
+TEST_F(DiskCacheTest, write_and_read)
+{
+  SeqDiskCache *disk_cache = seq_disk_cache_create(bmain_, scene_);
+  for (int frame = 1; frame <= 4; frame++) {
+    write_image(disk_cache, frame);
+    EXPECT_TRUE(read_image(disk_cache, frame));
+  }
+
+  wait_for_writes(disk_cache);
+  for (int frame = 1; frame <= 4; frame++) {
+    EXPECT_TRUE(read_image(disk_cache, frame));
+  }
+  EXPECT_FALSE(read_image(disk_cache, 5));
+  seq_disk_cache_free(disk_cache);
+}
+
+/* Files written by a previous session are found by scanning the cache directory when the cache is
+ * created, and files that are deleted while the cache is in use are dropped from the index. */
+TEST_F(DiskCacheTest, index)
+{
+  SeqDiskCache *disk_cache = seq_disk_cache_create(bmain_, scene_);
+  write_image(disk_cache, 1);
+  write_image(disk_cache, 150);
+  wait_for_writes(disk_cache);
+  seq_disk_cache_free(disk_cache);
+
+  disk_cache = seq_disk_cache_create(bmain_, scene_);
+  EXPECT_TRUE(read_image(disk_cache, 1));
+  EXPECT_TRUE(read_image(disk_cache, 150));
+
+  /* Files deleted while the cache is in use are not found anymore. */
+  char project_dir[FILE_MAX];
+  project_dir_get(project_dir, sizeof(project_dir));
+  BLI_delete(project_dir, true, true);
+  EXPECT_FALSE(read_image(disk_cache, 1));
+  EXPECT_FALSE(read_image(disk_cache, 150));
+
+  /* Writing to a deleted file creates it again. */
+  write_image(disk_cache, 151);
+  wait_for_writes(disk_cache);
+  EXPECT_TRUE(read_image(disk_cache, 151));
+  EXPECT_FALSE(read_image(disk_cache, 150));
+  seq_disk_cache_free(disk_cache);
+}
+
+/* The project directory stores the format version of the cache, and caches of other versions are
+ * deleted when the cache is created. */
+TEST_F(DiskCacheTest, format_version)
+{
+  SeqDiskCache *disk_cache = seq_disk_cache_create(bmain_, scene_);
+  write_image(disk_cache, 1);
+  wait_for_writes(disk_cache);
+  seq_disk_cache_free(disk_cache);
+
+  char project_dir[FILE_MAX];
+  project_dir_get(project_dir, sizeof(project_dir));
+  char version_filepath[FILE_MAX];
+  BLI_path_join(version_filepath, sizeof(version_filepath), project_dir, "cache_version");
+  FILE *file = BLI_fopen(version_filepath, "r");
+  ASSERT_NE(file, nullptr);
+  int version = 0;
+  EXPECT_EQ(fscanf(file, "%d", &version), 1);
+  fclose(file);
+  /* #DCACHE_CURRENT_VERSION */
+  EXPECT_EQ(version, 3);
+
+  /* The cache of the current version is kept. */
+  disk_cache = seq_disk_cache_create(bmain_, scene_);
+  EXPECT_TRUE(read_image(disk_cache, 1));
+  seq_disk_cache_free(disk_cache);
+
+  /* The cache of an older version is deleted. */
+  file = BLI_fopen(version_filepath, "w");
+  ASSERT_NE(file, nullptr);
+  fprintf(file, "%d", version - 1);
+  fclose(file);
+  disk_cache = seq_disk_cache_create(bmain_, scene_);
+  EXPECT_FALSE(read_image(disk_cache, 1));
+  seq_disk_cache_free(disk_cache);
+}
+
+/* Rendering waits once too many images are waiting to be written, and all images are written. */
+TEST_F(DiskCacheTest, pending_writes_limit)
+{
+  SeqDiskCache *disk_cache = seq_disk_cache_create(bmain_, scene_);
+  for (int frame = 1; frame <= 32; frame++) {
+    write_image(disk_cache, frame);
+    /* #DCACHE_MAX_PENDING_WRITES */
+    EXPECT_LE(seq_disk_cache_pending_writes_num(disk_cache), 8);
+  }
+
+  wait_for_writes(disk_cache);
+  for (int frame = 1; frame <= 32; frame++) {
+    EXPECT_TRUE(read_image(disk_cache, frame));
+  }
+  seq_disk_cache_free(disk_cache);
+}
+
+/* Invalidation cancels images that wait to be written, such that they don't bring back the
+ * deleted files. */
+TEST_F(DiskCacheTest, invalidate_cancels_pending_writes)
+{
+  SeqDiskCache *disk_cache = seq_disk_cache_create(bmain_, scene_);
+  for (int frame = 1; frame <= 8; frame++) {
+    write_image(disk_cache, frame);
+  }
+  seq_disk_cache_invalidate(disk_cache, scene_, strip_, strip_, SEQ_CACHE_STORE_FINAL_OUT);
+
+  for (int frame = 1; frame <= 8; frame++) {
+    EXPECT_FALSE(read_image(disk_cache, frame));
+  }
+  wait_for_writes(disk_cache);
+  for (int frame = 1; frame <= 8; frame++) {
+    EXPECT_FALSE(read_image(disk_cache, frame));
+  }
+  seq_disk_cache_free(disk_cache);
+}
+
+/* Freeing the cache, like freeing the scene does, doesn't wait for pending images to be written.
+ * Images are either written completely or not at all. */
+TEST_F(DiskCacheTest, free_cancels_pending_writes)
+{
+  const uint initial_blocks_in_use = MEM_get_memory_blocks_in_use();
+  SeqDiskCache *disk_cache = seq_disk_cache_create(bmain_, scene_);
+  for (int frame = 1; frame <= 8; frame++) {
+    write_image(disk_cache, frame);
+  }
+  seq_disk_cache_free(disk_cache);
+  EXPECT_EQ(MEM_get_memory_blocks_in_use(), initial_blocks_in_use);
+
+  disk_cache = seq_disk_cache_create(bmain_, scene_);
+  for (int frame = 1; frame <= 8; frame++) {
+    SeqCacheKey key = make_key(frame);
+    ImBuf *ibuf = seq_disk_cache_read_file(disk_cache, &key);
+    if (ibuf) {
+      ImBuf *expected = create_image(frame);
+      EXPECT_TRUE(images_equal(ibuf, expected)) << "frame " << frame;
+      IMB_freeImBuf(expected);
+      IMB_freeImBuf(ibuf);
+    }
+  }
+  seq_disk_cache_free(disk_cache);
+}
+
+}  // namespace blender::seq::tests
@@ -0,0 +1,205 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <cstdlib>
+
+#include "MEM_guardedalloc.h"
+
+#include "CLG_log.h"
+
+#include "BLI_assert.h"
+
+#include "DNA_scene_types.h"
+#include "DNA_sequence_types.h"
+
+#include "IMB_imbuf.hh"
+#include "IMB_imbuf_types.hh"
+
+#include "SEQ_effects.hh"
+#include "SEQ_render.hh"
+
+#include "effects.hh"
+
+namespace blender::seq::tests {
+
+/* Widths that are not a multiple of the four pixels processed at once by the byte SIMD code, such
+ * that the scalar tail is used as well. */
+static constexpr int WIDTHS[] = {1, 3, 5, 17, 67};
+static constexpr int HEIGHT = 7;
+
+class EffectsTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite()
+  {
+    CLG_init();
+    IMB_init();
+  }
+
+  static void TearDownTestSuite()
+  {
+    IMB_exit();
+    CLG_exit();
+  }
+};
+
+using EffectRenderFn = ImBuf *(*)(const RenderData *context,
+                                  Strip *strip,
+                                  float fac,
+                                  ImBuf *src1,
+                                  ImBuf *src2,
+                                  bool use_simd);
+
+static EffectRenderFn effect_render_fn_get(const int strip_type)
+{
+  switch (strip_type) {
+    case STRIP_TYPE_ADD:
+      return add_effect_render;
+    case STRIP_TYPE_SUB:
+      return sub_effect_render;
+    case STRIP_TYPE_MUL:
+      return mul_effect_render;
+    case STRIP_TYPE_CROSS:
+      return cross_effect_render;
+    case STRIP_TYPE_GAMCROSS:
+      return gamma_cross_effect_render;
+    case STRIP_TYPE_ALPHAOVER:
+      return alpha_over_effect_render;
+    case STRIP_TYPE_ALPHAUNDER:
+      return alpha_under_effect_render;
+    case STRIP_TYPE_GAUSSIAN_BLUR:
+      return gaussian_blur_effect_render;
+    case STRIP_TYPE_GLOW:
+      return glow_effect_render;
+  }
+  BLI_assert_unreachable();
+  return nullptr;
+}
+
+static ImBuf *create_src_image(const int width, const bool use_float, const int seed)
+{
+  ImBuf *img = IMB_allocImBuf(width, HEIGHT, 32, use_float ? IB_float_data : IB_byte_data);
+  if (use_float) {
+    float *pix = img->float_buffer.data;
+    for (int i = 0; i < img->x * img->y; i++) {
+      /* Premultiplied colors, with transparent, opaque and partially transparent pixels. */
+      const float alpha = ((i + seed) % 5) * 0.25f;
+      pix[0] = ((i * 7 + seed) % 256) / 255.0f * alpha;
+      pix[1] = ((i * 3) % 256) / 255.0f * alpha;
+      pix[2] = ((i * 13 + 123) % 256) / 255.0f * alpha;
+      pix[3] = alpha;
+      pix += 4;
+    }
+  }
+  else {
+    uchar *pix = img->byte_buffer.data;
+    for (int i = 0; i < img->x * img->y; i++) {
+      pix[0] = (i * 7 + seed) & 0xFF;
+      pix[1] = (i * 3) & 0xFF;
+      pix[2] = (i * 13 + 123) & 0xFF;
+      pix[3] = ((i + seed) % 5) * 255 / 4;
+      pix += 4;
+    }
+  }
+  return img;
+}
+
+/* Runs the effect with and without the SIMD code paths, and compares the results. Effects on
+ * bytes that are computed in integers are expected to match exactly, the others within rounding
+ * of the different order of float operations. */
+static void test_effect_simd_matches_scalar(const int strip_type,
+                                            const bool use_float,
+                                            const float fac,
+                                            const int byte_tolerance)
+{
+  for (const int width : WIDTHS) {
+    SCOPED_TRACE(width);
+    Scene *scene = MEM_callocN<Scene>(__func__);
+    scene->r.xsch = width;
+    scene->r.ysch = HEIGHT;
+
+    RenderData context;
+    context.scene = scene;
+    context.rectx = width;
+    context.recty = HEIGHT;
+
+    Strip *strip = MEM_callocN<Strip>(__func__);
+    strip->type = strip_type;
+    EffectHandle handle = get_sequence_effect_impl(strip_type);
+    if (handle.init) {
+      handle.init(strip);
+    }
+    if (strip_type == STRIP_TYPE_GAUSSIAN_BLUR) {
+      GaussianBlurVars *data = static_cast<GaussianBlurVars *>(strip->effectdata);
+      data->size_x = 3.0f;
+      data->size_y = 2.0f;
+    }
+
+    ImBuf *src1 = create_src_image(width, use_float, 0);
+    ImBuf *src2 = create_src_image(width, use_float, 1);
+
+    const EffectRenderFn render_fn = effect_render_fn_get(strip_type);
+    ImBuf *dst_simd = render_fn(&context, strip, fac, src1, src2, true);
+    ImBuf *dst_scalar = render_fn(&context, strip, fac, src1, src2, false);
+
+    const int64_t values_num = int64_t(width) * HEIGHT * 4;
+    if (use_float) {
+      ASSERT_NE(dst_simd->float_buffer.data, nullptr);
+      ASSERT_NE(dst_scalar->float_buffer.data, nullptr);
+      for (int64_t i = 0; i < values_num; i++) {
+        EXPECT_NEAR(dst_simd->float_buffer.data[i], dst_scalar->float_buffer.data[i], 1e-5f)
+            << "value " << i;
+      }
+    }
+    else {
+      ASSERT_NE(dst_simd->byte_buffer.data, nullptr);
+      ASSERT_NE(dst_scalar->byte_buffer.data, nullptr);
+      for (int64_t i = 0; i < values_num; i++) {
+        EXPECT_LE(std::abs(int(dst_simd->byte_buffer.data[i]) -
+                           int(dst_scalar->byte_buffer.data[i])),
+                  byte_tolerance)
+            << "value " << i;
+      }
+    }
+
+    IMB_freeImBuf(dst_simd);
+    IMB_freeImBuf(dst_scalar);
+    IMB_freeImBuf(src1);
+    IMB_freeImBuf(src2);
+    if (handle.free) {
+      handle.free(strip, true);
+    }
+    MEM_freeN(strip);
+    MEM_freeN(scene);
+  }
+}
+
+static void test_effects_simd_matches_scalar(const bool use_float)
+{
+  for (const float fac : {0.3f, 1.0f}) {
+    SCOPED_TRACE(fac);
+    test_effect_simd_matches_scalar(STRIP_TYPE_ADD, use_float, fac, 0);
+    test_effect_simd_matches_scalar(STRIP_TYPE_SUB, use_float, fac, 0);
+    test_effect_simd_matches_scalar(STRIP_TYPE_MUL, use_float, fac, 0);
+    test_effect_simd_matches_scalar(STRIP_TYPE_CROSS, use_float, fac, 0);
+    test_effect_simd_matches_scalar(STRIP_TYPE_GAMCROSS, use_float, fac, 1);
+    test_effect_simd_matches_scalar(STRIP_TYPE_ALPHAOVER, use_float, fac, 1);
+    test_effect_simd_matches_scalar(STRIP_TYPE_ALPHAUNDER, use_float, fac, 1);
+    test_effect_simd_matches_scalar(STRIP_TYPE_GAUSSIAN_BLUR, use_float, fac, 1);
+    test_effect_simd_matches_scalar(STRIP_TYPE_GLOW, use_float, fac, 1);
+  }
+}
+
+TEST_F(EffectsTest, simd_matches_scalar_byte)
+{
+  test_effects_simd_matches_scalar(false);
+}
+
+TEST_F(EffectsTest, simd_matches_scalar_float)
+{
+  test_effects_simd_matches_scalar(true);
+}
+
+}  // namespace blender::seq::tests
@@ -0,0 +1,232 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "CLG_log.h"
+
+#include "BLI_array.hh"
+#include "BLI_task.hh"
+
+#include "DNA_scene_types.h"
+#include "DNA_sequence_types.h"
+#include "DNA_space_types.h"
+#include "DNA_userdef_types.h"
+
+#include "BKE_idtype.hh"
+#include "BKE_main.hh"
+#include "BKE_scene.hh"
+
+#include "IMB_imbuf.hh"
+#include "IMB_imbuf_types.hh"
+
+#include "SEQ_relations.hh"
+#include "SEQ_render.hh"
+#include "SEQ_sequencer.hh"
+
+#include "image_cache.hh"
+
+namespace blender::seq::tests {
+
+/* Images of 2 MiB. */
+static constexpr int IMAGE_WIDTH = 1024;
+static constexpr int IMAGE_HEIGHT = 512;
+static constexpr size_t IMAGE_SIZE = size_t(IMAGE_WIDTH) * IMAGE_HEIGHT * 4;
+
+class ImageCacheTest : public testing::Test {
+ protected:
+  Main *bmain_ = nullptr;
+  Scene *scene_ = nullptr;
+  RenderData context_;
+  int previous_memcachelimit_ = 0;
+
+  static void SetUpTestSuite()
+  {
+    CLG_init();
+    BKE_idtype_init();
+  }
+
+  static void TearDownTestSuite()
+  {
+    CLG_exit();
+  }
+
+  void SetUp() override
+  {
+    previous_memcachelimit_ = U.memcachelimit;
+    U.memcachelimit = 4096;
+
+    bmain_ = BKE_main_new();
+    scene_ = BKE_scene_add(bmain_, "Scene");
+    Editing *ed = editing_ensure(scene_);
+    ed->cache_flag = SEQ_CACHE_STORE_FINAL_OUT | SEQ_CACHE_STORE_PREPROCESSED;
+    render_new_render_data(bmain_,
+                           nullptr,
+                           scene_,
+                           IMAGE_WIDTH,
+                           IMAGE_HEIGHT,
+                           SEQ_RENDER_SIZE_SCENE,
+                           false,
+                           &context_);
+  }
+
+  void TearDown() override
+  {
+    BKE_main_free(bmain_);
+    U.memcachelimit = previous_memcachelimit_;
+  }
+
+  Strip *add_strip(const int channel)
+  {
+    return sequence_alloc(scene_->ed->seqbasep, 1, channel, STRIP_TYPE_COLOR);
+  }
+
+  /* Look up the image in the cache, or create a new image and put it in the cache like rendering
+   * does, recycling frames if the cache is full. If exceed_limit is true, the memory cache limit
+   * is lowered such that the memory in use exceeds it by less than one image before recycling. */
+  void render_image(Strip *strip, const int frame, const int type, const bool exceed_limit = false)
+  {
+    ImBuf *ibuf = seq_cache_get(&context_, strip, frame, type);
+    if (ibuf == nullptr) {
+      ibuf = IMB_allocImBuf(IMAGE_WIDTH, IMAGE_HEIGHT, 32, IB_byte_data);
+      if (exceed_limit) {
+        U.memcachelimit = int(MEM_get_memory_in_use() >> 20) - 1;
+      }
+      seq_cache_put_if_possible(&context_, strip, frame, type, ibuf);
+    }
+    IMB_freeImBuf(ibuf);
+  }
+
+  bool has_image(Strip *strip, const int frame, const int type)
+  {
+    ImBuf *ibuf = seq_cache_get(&context_, strip, frame, type);
+    IMB_freeImBuf(ibuf);
+    return ibuf != nullptr;
+  }
+};
+
+TEST_F(ImageCacheTest, statistics)
+{
+  Strip *strip = add_strip(1);
+  render_image(strip, 1, SEQ_CACHE_STORE_FINAL_OUT);
+  render_image(strip, 2, SEQ_CACHE_STORE_FINAL_OUT);
+  EXPECT_TRUE(has_image(strip, 1, SEQ_CACHE_STORE_FINAL_OUT));
+  EXPECT_TRUE(has_image(strip, 2, SEQ_CACHE_STORE_FINAL_OUT));
+  EXPECT_FALSE(has_image(strip, 3, SEQ_CACHE_STORE_FINAL_OUT));
+
+  const CacheStatistics statistics = cache_statistics_get(scene_);
+  EXPECT_EQ(statistics.hits, 2);
+  EXPECT_EQ(statistics.misses, 3);
+  EXPECT_EQ(statistics.evictions, 0);
+  EXPECT_EQ(statistics.items_num, 2);
+  EXPECT_GE(statistics.memory_in_use, 2 * IMAGE_SIZE);
+
+  cache_cleanup(scene_);
+  EXPECT_EQ(cache_statistics_get(scene_).items_num, 0);
+  EXPECT_EQ(cache_statistics_get(scene_).memory_in_use, 0);
+}
+
+/* Once the memory in use exceeds the limit, the least recently used frames are recycled first,
+ * where reading the final image of a frame counts as using it. */
+TEST_F(ImageCacheTest, recycle_least_recently_used)
+{
+  Strip *strip = add_strip(1);
+  for (int frame = 1; frame <= 4; frame++) {
+    render_image(strip, frame, SEQ_CACHE_STORE_FINAL_OUT);
+  }
+
+  EXPECT_TRUE(has_image(strip, 1, SEQ_CACHE_STORE_FINAL_OUT));
+  render_image(strip, 5, SEQ_CACHE_STORE_FINAL_OUT, true);
+
+  EXPECT_EQ(cache_statistics_get(scene_).evictions, 1);
+  EXPECT_FALSE(has_image(strip, 2, SEQ_CACHE_STORE_FINAL_OUT));
+  for (const int frame : {1, 3, 4, 5}) {
+    EXPECT_TRUE(has_image(strip, frame, SEQ_CACHE_STORE_FINAL_OUT));
+  }
+}
+
+/* Intermediate images are linked to the final image of their frame and recycled along with it. */
+TEST_F(ImageCacheTest, recycle_linked_images)
+{
+  Strip *strip = add_strip(1);
+  for (int frame = 1; frame <= 2; frame++) {
+    render_image(strip, frame, SEQ_CACHE_STORE_PREPROCESSED);
+    render_image(strip, frame, SEQ_CACHE_STORE_FINAL_OUT);
+  }
+  EXPECT_EQ(cache_statistics_get(scene_).items_num, 4);
+
+  render_image(strip, 3, SEQ_CACHE_STORE_PREPROCESSED, true);
+
+  EXPECT_EQ(cache_statistics_get(scene_).evictions, 2);
+  EXPECT_FALSE(has_image(strip, 1, SEQ_CACHE_STORE_PREPROCESSED));
+  EXPECT_FALSE(has_image(strip, 1, SEQ_CACHE_STORE_FINAL_OUT));
+  EXPECT_TRUE(has_image(strip, 2, SEQ_CACHE_STORE_PREPROCESSED));
+  EXPECT_TRUE(has_image(strip, 2, SEQ_CACHE_STORE_FINAL_OUT));
+  EXPECT_TRUE(has_image(strip, 3, SEQ_CACHE_STORE_PREPROCESSED));
+}
+
+/* Images of different strips and frames, which are distributed between shards, can be put in and
+ * read from the cache concurrently. */
+TEST_F(ImageCacheTest, concurrent_access)
+{
+  constexpr int strips_num = 8;
+  constexpr int frames_num = 16;
+  Array<Strip *> strips(strips_num);
+  for (const int i : strips.index_range()) {
+    strips[i] = add_strip(i + 1);
+  }
+
+  threading::parallel_for(IndexRange(strips_num * frames_num), 1, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      Strip *strip = strips[i % strips_num];
+      const int frame = int(i / strips_num) + 1;
+      ImBuf *ibuf = IMB_allocImBuf(4, 4, 32, IB_byte_data);
+      seq_cache_put(&context_, strip, frame, SEQ_CACHE_STORE_PREPROCESSED, ibuf);
+      ImBuf *cached_ibuf = seq_cache_get(&context_, strip, frame, SEQ_CACHE_STORE_PREPROCESSED);
+      EXPECT_EQ(cached_ibuf, ibuf);
+      IMB_freeImBuf(cached_ibuf);
+      IMB_freeImBuf(ibuf);
+    }
+  });
+
+  const CacheStatistics statistics = cache_statistics_get(scene_);
+  EXPECT_EQ(statistics.items_num, strips_num * frames_num);
+  EXPECT_EQ(statistics.hits, strips_num * frames_num);
+  EXPECT_EQ(statistics.misses, 0);
+}
+
+/* Reading final images, which uses their frames, can happen concurrently with rendering other
+ * frames, which puts their images in the cache. */
+TEST_F(ImageCacheTest, concurrent_final_access)
+{
+  constexpr int frames_num = 64;
+  Strip *strip = add_strip(1);
+  for (int frame = 1; frame <= frames_num; frame++) {
+    ImBuf *ibuf = IMB_allocImBuf(4, 4, 32, IB_byte_data);
+    seq_cache_put(&context_, strip, frame, SEQ_CACHE_STORE_FINAL_OUT, ibuf);
+    IMB_freeImBuf(ibuf);
+  }
+
+  threading::parallel_for(IndexRange(2 * frames_num), 1, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      const int frame = int(i / 2) + 1;
+      if (i % 2 == 0) {
+        EXPECT_TRUE(has_image(strip, frame, SEQ_CACHE_STORE_FINAL_OUT));
+      }
+      else {
+        ImBuf *ibuf = IMB_allocImBuf(4, 4, 32, IB_byte_data);
+        seq_cache_put(&context_, strip, frames_num + frame, SEQ_CACHE_STORE_FINAL_OUT, ibuf);
+        IMB_freeImBuf(ibuf);
+      }
+    }
+  });
+
+  const CacheStatistics statistics = cache_statistics_get(scene_);
+  EXPECT_EQ(statistics.items_num, 2 * frames_num);
+  EXPECT_EQ(statistics.hits, frames_num);
+}
+
+}  // namespace blender::seq::tests
@@ -0,0 +1,118 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_timeit.hh"
+
+#include "DNA_scene_types.h"
+#include "DNA_sequence_types.h"
+
+#include "IMB_imbuf.hh"
+#include "IMB_imbuf_types.hh"
+
+#include "SEQ_effects.hh"
+#include "SEQ_render.hh"
+
+#include "effects.hh"
+
+using namespace blender;
+
+static constexpr int SIZE_X = 3840;
+static constexpr int SIZE_Y = 2160;
+
+static ImBuf *create_src_image(bool use_float, int seed)
+{
+  ImBuf *img = IMB_allocImBuf(SIZE_X, SIZE_Y, 32, use_float ? IB_float_data : IB_byte_data);
+  if (use_float) {
+    float *pix = img->float_buffer.data;
+    for (int i = 0; i < img->x * img->y; i++) {
+      /* Premultiplied colors, with transparent, opaque and partially transparent pixels. */
+      const float alpha = ((i + seed) % 5) * 0.25f;
+      pix[0] = ((i * 7 + seed) % 256) / 255.0f * alpha;
+      pix[1] = ((i * 3) % 256) / 255.0f * alpha;
+      pix[2] = ((i + 12345) % 256) / 255.0f * alpha;
+      pix[3] = alpha;
+      pix += 4;
+    }
+  }
+  else {
+    uchar *pix = img->byte_buffer.data;
+    for (int i = 0; i < img->x * img->y; i++) {
+      pix[0] = (i * 7 + seed) & 0xFF;
+      pix[1] = (i * 3) & 0xFF;
+      pix[2] = (i + 12345) & 0xFF;
+      pix[3] = ((i + seed) % 5) * 255 / 4;
+      pix += 4;
+    }
+  }
+  return img;
+}
+
+static void effect_perf(const char *name, int strip_type, bool use_float)
+{
+  Scene *scene = MEM_callocN<Scene>(__func__);
+  scene->r.xsch = SIZE_X;
+  scene->r.ysch = SIZE_Y;
+
+  seq::RenderData context;
+  context.scene = scene;
+  context.rectx = SIZE_X;
+  context.recty = SIZE_Y;
+
+  Strip *strip = MEM_callocN<Strip>(__func__);
+  strip->type = strip_type;
+  seq::EffectHandle handle = seq::get_sequence_effect_impl(strip_type);
+  if (handle.init) {
+    handle.init(strip);
+  }
+  if (strip_type == STRIP_TYPE_GAUSSIAN_BLUR) {
+    GaussianBlurVars *data = static_cast<GaussianBlurVars *>(strip->effectdata);
+    data->size_x = 8.0f;
+    data->size_y = 8.0f;
+  }
+
+  ImBuf *src1 = create_src_image(use_float, 0);
+  ImBuf *src2 = create_src_image(use_float, 1);
+  {
+    SCOPED_TIMER(name);
+    for (int i = 0; i < 4; i++) {
+      ImBuf *dst = handle.execute(&context, strip, 1.0f, 0.7f, src1, src2);
+      IMB_freeImBuf(dst);
+    }
+  }
+  IMB_freeImBuf(src1);
+  IMB_freeImBuf(src2);
+
+  if (handle.free) {
+    handle.free(strip, true);
+  }
+  MEM_freeN(strip);
+  MEM_freeN(scene);
+}
+
+static void test_effects_perf(bool use_float)
+{
+  effect_perf("cross", STRIP_TYPE_CROSS, use_float);
+  effect_perf("gamma_cross", STRIP_TYPE_GAMCROSS, use_float);
+  effect_perf("add", STRIP_TYPE_ADD, use_float);
+  effect_perf("subtract", STRIP_TYPE_SUB, use_float);
+  effect_perf("multiply", STRIP_TYPE_MUL, use_float);
+  effect_perf("alpha_over", STRIP_TYPE_ALPHAOVER, use_float);
+  effect_perf("alpha_under", STRIP_TYPE_ALPHAUNDER, use_float);
+  effect_perf("gaussian_blur", STRIP_TYPE_GAUSSIAN_BLUR, use_float);
+  effect_perf("glow", STRIP_TYPE_GLOW, use_float);
+}
+
+TEST(sequencer_effects, effects_perf_byte)
+{
+  test_effects_perf(false);
+}
+
+TEST(sequencer_effects, effects_perf_float)
+{
+  test_effects_perf(true);
+}
@@ -109,7 +109,10 @@
 
 #include "COM_compositor.hh"
 
+#include "NOD_geometry_nodes_lazy_function.hh"
+
 #include "DEG_depsgraph.hh"
+#include "DEG_depsgraph_debug.hh"
 #include "DEG_depsgraph_query.hh"
 
 #include "ANIM_keyingsets.hh"
@@ -579,6 +582,9 @@ void WM_exit_ex(bContext *C, const bool do_python_exit, const bool do_user_exit_
 
   COM_deinitialize();
 
+  nodes::geometry_nodes_profiler_write_and_free();
+  DEG_debug_eval_trace_write_and_free();
+
   bke::subdiv::exit();
 
   if (gpu_is_init) {
@@ -766,6 +766,7 @@ static void print_help(bArgs *ba, bool all)
   }
   BLI_args_print_arg_doc(ba, "--debug-all");
   BLI_args_print_arg_doc(ba, "--debug-io");
+  BLI_args_print_arg_doc(ba, "--profile-geometry-nodes");
 
   PRINT("\n");
   BLI_args_print_arg_doc(ba, "--debug-fpe");
@@ -1340,7 +1341,9 @@ static const char arg_handle_debug_mode_generic_set_doc_depsgraph_time[] =
     "Enable debug messages from dependency graph related on timing.";
 static const char arg_handle_debug_mode_generic_set_doc_depsgraph_eval[] =
     "\n\t"
-    "Enable debug messages from dependency graph related on evaluation.";
+    "Enable debug messages from dependency graph related on evaluation.\n"
+    "\tIn background mode, also write a timeline of all evaluated operations to\n"
+    "\t'depsgraph_eval_trace.json' in the Chrome Trace Event format on exit.";
 static const char arg_handle_debug_mode_generic_set_doc_depsgraph_no_threads[] =
     "\n\t"
     "Switch dependency graph to a single threaded evaluation.";
@@ -2509,6 +2512,19 @@ static int arg_handle_addons_set(int argc, const char **argv, void *data)
   return 0;
 }
 
+static const char arg_handle_profile_geometry_nodes_set_doc[] =
+    "\n"
+    "\tEnable performance profiling of geometry nodes evaluation\n"
+    "\t(Outputs geometry_nodes_profile.json in the Trace Event Format and\n"
+    "\tgeometry_nodes_profile.speedscope.json to the current directory on exit)";
+static int arg_handle_profile_geometry_nodes_set(int /*argc*/,
+                                                 const char ** /*argv*/,
+                                                 void * /*data*/)
+{
+  G.profile_geometry_nodes = true;
+  return 0;
+}
+
 #  ifdef WITH_OPENGL_BACKEND
 static const char arg_handle_profile_gpu_set_doc[] =
     "\n"
@@ -2690,6 +2706,11 @@ void main_args_setup(bContext *C, bArgs *ba, bool all)
                nullptr);
   BLI_args_add(ba, nullptr, "--profile-gpu", CB(arg_handle_profile_gpu_set), nullptr);
 #  endif
+  BLI_args_add(ba,
+               nullptr,
+               "--profile-geometry-nodes",
+               CB(arg_handle_profile_geometry_nodes_set),
+               nullptr);
 
   /* Pass: Background Mode & Settings
    *
@@ -0,0 +1,72 @@
+# SPDX-FileCopyrightText: 2025 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+import api
+
+
+def _run(args):
+    import bpy
+    import resource
+    import time
+
+    scene = bpy.context.scene
+    scene.render.compositor_device = 'CPU'
+    scene.render.compositor_precision = args['precision']
+
+    def measure(use_compositing):
+        scene.render.use_compositing = use_compositing
+        # Render once first, to load and cache the images used by the node tree.
+        bpy.ops.render.render()
+
+        measured_times = []
+        test_time_start = time.time()
+        while True:
+            start_time = time.time()
+            bpy.ops.render.render()
+            measured_times.append(time.time() - start_time)
+
+            elapsed_time = time.time() - test_time_start
+            if len(measured_times) >= args['min_measurements'] and elapsed_time > args['timeout']:
+                break
+        return sum(measured_times) / len(measured_times)
+
+    # There is no operator that only runs the compositor, so subtract the time of the same render
+    # without compositing to only report the time spent compositing.
+    render_time = measure(False)
+    composite_time = measure(True)
+
+    result = {
+        'time': max(composite_time - render_time, 0.0),
+        # Peak resident memory of the process in bytes, `ru_maxrss` is in kilobytes on Linux.
+        'peak_memory': resource.getrusage(resource.RUSAGE_SELF).ru_maxrss * 1024,
+    }
+    return result
+
+
+class CompositorTest(api.Test):
+    def __init__(self, filepath, precision):
+        self.filepath = filepath
+        self.precision = precision
+
+    def name(self):
+        return f"{self.filepath.stem}_{self.precision.lower()}"
+
+    def category(self):
+        return "compositor"
+
+    def run(self, env, device_id):
+        args = {
+            'precision': self.precision,
+            'min_measurements': 3,
+            'timeout': 10.0,
+        }
+        result, _ = env.run_in_blender(_run, args, [self.filepath])
+        return result
+
+
+def generate(env):
+    filepaths = env.find_blend_files('compositor/*')
+    return [CompositorTest(filepath, precision)
+            for filepath in filepaths
+            for precision in ('FULL', 'HALF')]
@@ -0,0 +1,63 @@
+# SPDX-FileCopyrightText: 2025 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+import api
+
+
+def _run(args):
+    import bpy
+    import time
+
+    scene = bpy.context.scene
+    frame_start = scene.frame_start
+    frame_end = min(scene.frame_end, frame_start + args['max_frames'] - 1)
+
+    # Play the frame range once first, so that the dependency graph has measured the cost of its
+    # operations and evaluation uses the learned scheduling priorities.
+    for frame in range(frame_start, frame_end + 1):
+        scene.frame_set(frame)
+
+    measured_times = []
+    test_time_start = time.time()
+    while True:
+        for frame in range(frame_start, frame_end + 1):
+            start_time = time.time()
+            scene.frame_set(frame)
+            measured_times.append(time.time() - start_time)
+
+        if time.time() - test_time_start > args['timeout']:
+            break
+
+    measured_times.sort()
+    result = {
+        'time': sum(measured_times) / len(measured_times),
+        'time_min': measured_times[0],
+        'time_median': measured_times[len(measured_times) // 2],
+        'time_max': measured_times[-1],
+    }
+    return result
+
+
+class DepsgraphTest(api.Test):
+    def __init__(self, filepath):
+        self.filepath = filepath
+
+    def name(self):
+        return self.filepath.stem
+
+    def category(self):
+        return "depsgraph"
+
+    def run(self, env, device_id):
+        args = {
+            'max_frames': 50,
+            'timeout': 10.0,
+        }
+        result, _ = env.run_in_blender(_run, args, [self.filepath])
+        return result
+
+
+def generate(env):
+    filepaths = env.find_blend_files('depsgraph/*')
+    return [DepsgraphTest(filepath) for filepath in filepaths]
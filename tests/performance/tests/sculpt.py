@@ -148,6 +148,87 @@ def _run(args: dict):
     return result
 
 
+def undo_memory(context):
+    """
+    Memory used by the sculpt undo steps in bytes, parsed from the scene statistics
+    """
+    units = {'B': 1, 'KiB': 1024, 'MiB': 1024 ** 2, 'GiB': 1024 ** 3, 'TiB': 1024 ** 4}
+    statistics = context.scene.statistics(context.view_layer)
+    for item in statistics.split(" | "):
+        if item.startswith("Undo:"):
+            value, unit = item[len("Undo:"):].split(" ")
+            return float(value) * units[unit]
+    return -1.0
+
+
+def _run_undo(args: dict):
+    import bpy
+    import time
+    context = bpy.context
+
+    # Create an undo stack explicitly. This isn't created by default in background mode.
+    bpy.ops.ed.undo_push()
+
+    prepare_sculpt_scene(context, args['mode'])
+
+    context_override = context.copy()
+    set_view3d_context_override(context_override)
+
+    with context.temp_override(**context_override):
+        bpy.ops.sculpt.brush_stroke(stroke=generate_stroke(context_override))
+
+        # Undo steps are compressed in the background, wait until their size is stable.
+        memory = undo_memory(context)
+        for _ in range(50):
+            time.sleep(0.1)
+            new_memory = undo_memory(context)
+            if new_memory == memory:
+                break
+            memory = new_memory
+
+        start = time.time()
+        bpy.ops.ed.undo()
+        undo_time = time.time() - start
+
+        start = time.time()
+        bpy.ops.ed.redo()
+        redo_time = time.time() - start
+
+    result = {
+        'time': undo_time + redo_time,
+        'undo_time': undo_time,
+        'redo_time': redo_time,
+        'undo_memory': memory,
+    }
+    return result
+
+
+def _run_enter(args: dict):
+    import bpy
+    import time
+    context = bpy.context
+
+    prepare_sculpt_scene(context, args['mode'])
+
+    # Measure entering sculpt mode, which builds the BVH of the object from scratch. Leaving sculpt
+    # mode frees the BVH again, so it can be measured several times.
+    measured_times = []
+    for _ in range(args['num_measurements']):
+        bpy.ops.object.mode_set(mode='OBJECT')
+        start = time.time()
+        bpy.ops.object.mode_set(mode='SCULPT')
+        measured_times.append(time.time() - start)
+
+    measured_times.sort()
+    result = {
+        'time': sum(measured_times) / len(measured_times),
+        'time_min': measured_times[0],
+        'time_median': measured_times[len(measured_times) // 2],
+        'time_max': measured_times[-1],
+    }
+    return result
+
+
 class SculptBrushTest(api.Test):
     def __init__(self, filepath: pathlib.Path, mode: SculptMode):
         self.filepath = filepath
@@ -171,6 +252,47 @@ class SculptBrushTest(api.Test):
         return result
 
 
+class SculptUndoTest(api.Test):
+    def __init__(self, filepath: pathlib.Path, mode: SculptMode):
+        self.filepath = filepath
+        self.mode = mode
+
+    def name(self):
+        return "{}_{}_undo".format(self.mode.name.lower(), self.filepath.stem)
+
+    def category(self):
+        return "sculpt"
+
+    def run(self, env, _device_id):
+        args = {"mode": self.mode.value}
+
+        result, _ = env.run_in_blender(_run_undo, args, [self.filepath])
+
+        return result
+
+
+class SculptEnterTest(api.Test):
+    def __init__(self, filepath: pathlib.Path, mode: SculptMode):
+        self.filepath = filepath
+        self.mode = mode
+
+    def name(self):
+        return "{}_{}_enter".format(self.mode.name.lower(), self.filepath.stem)
+
+    def category(self):
+        return "sculpt"
+
+    def run(self, env, _device_id):
+        args = {"mode": self.mode.value, "num_measurements": 10}
+
+        result, _ = env.run_in_blender(_run_enter, args, [self.filepath])
+
+        return result
+
+
 def generate(env):
     filepaths = env.find_blend_files('sculpt/*')
-    return [SculptBrushTest(filepath, mode) for filepath in filepaths for mode in SculptMode]
+    tests = [SculptBrushTest(filepath, mode) for filepath in filepaths for mode in SculptMode]
+    tests += [SculptUndoTest(filepath, mode) for filepath in filepaths for mode in SculptMode]
+    tests += [SculptEnterTest(filepath, mode) for filepath in filepaths for mode in SculptMode]
+    return tests
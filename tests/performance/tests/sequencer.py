@@ -0,0 +1,84 @@
+# SPDX-FileCopyrightText: 2025 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+import api
+
+
+def _run(args):
+    import bpy
+    import os
+    import tempfile
+    import time
+
+    scene = bpy.context.scene
+    scene.render.resolution_x = args['width']
+    scene.render.resolution_y = args['height']
+    scene.render.resolution_percentage = 100
+    scene.render.use_sequencer = True
+    scene.render.use_compositing = False
+    scene.frame_start = 1
+    scene.frame_end = args['frames']
+
+    # Build a synthetic timeline of semi-transparent image strips stacked on top of each other, so
+    # every layer has to be rendered and blended for every frame.
+    directory = tempfile.mkdtemp()
+    editing = scene.sequence_editor_create()
+    for layer in range(args['layers']):
+        image = bpy.data.images.new(f"layer_{layer}", args['width'], args['height'], alpha=True)
+        image.generated_type = 'COLOR_GRID' if layer % 2 else 'UV_GRID'
+        image.filepath_raw = os.path.join(directory, f"layer_{layer}.png")
+        image.file_format = 'PNG'
+        image.save()
+
+        strip = editing.strips.new_image(
+            f"layer_{layer}", image.filepath_raw, layer + 1, scene.frame_start)
+        strip.frame_final_duration = args['frames']
+        strip.blend_type = 'ALPHA_OVER'
+        strip.blend_alpha = 0.8
+
+    # Play back the timeline once first, to open the files.
+    scene.frame_set(scene.frame_start)
+    bpy.ops.render.render()
+
+    measured_times = []
+    test_time_start = time.time()
+    while True:
+        for frame in range(scene.frame_start, scene.frame_end + 1):
+            scene.frame_set(frame)
+            start_time = time.time()
+            bpy.ops.render.render()
+            measured_times.append(time.time() - start_time)
+
+        elapsed_time = time.time() - test_time_start
+        if elapsed_time > args['timeout']:
+            break
+
+    result = {'time': sum(measured_times) / len(measured_times)}
+    return result
+
+
+class SequencerTest(api.Test):
+    def __init__(self, layers):
+        self.layers = layers
+
+    def name(self):
+        return f"synthetic_{self.layers}_layers"
+
+    def category(self):
+        return "sequencer"
+
+    def run(self, env, device_id):
+        args = {
+            'layers': self.layers,
+            'frames': 24,
+            'width': 1920,
+            'height': 1080,
+            'timeout': 10.0,
+        }
+        result, _ = env.run_in_blender(_run, args)
+        return result
+
+
+def generate(env):
+    return [SequencerTest(8)]